@@ -27,6 +27,23 @@ static UINT ModifierKeyToVK(ModifierKey key) {
     }
 }
 
+// Helper to convert PanFilterType to the zoom state machine's filter
+static ZoomPanFilter PanFilterTypeToZoom(PanFilterType filter) {
+    switch (filter) {
+        case PanFilterType::OneEuro: return ZoomPanFilter::OneEuro;
+        default:                     return ZoomPanFilter::Exponential;
+    }
+}
+
+// Helper to convert CursorPredictionType to the zoom state machine's predictor mode
+static CursorPredictionMode CursorPredictionTypeToZoom(CursorPredictionType prediction) {
+    switch (prediction) {
+        case CursorPredictionType::Kalman:       return CursorPredictionMode::Kalman;
+        case CursorPredictionType::LeastSquares: return CursorPredictionMode::LeastSquares;
+        default:                                 return CursorPredictionMode::Off;
+    }
+}
+
 // Helper to parse hotkey string like "Ctrl+Shift+D" into modifiers and virtual key
 static bool ParseHotkeyString(const std::wstring& hotkey, UINT& modifiers, UINT& vk) {
     modifiers = 0;
@@ -76,6 +93,34 @@ static bool ParseHotkeyString(const std::wstring& hotkey, UINT& modifiers, UINT&
     return (modifiers != 0 && vk != 0);
 }
 
+// Helper to convert general config to the desktop poll schedule
+static PollScheduleConfig ToPollSchedule(const GeneralConfig& general) {
+    PollScheduleConfig schedule;
+    schedule.idlePeriodMs = static_cast<uint32_t>(general.desktopPollIdleMs);
+    schedule.activePeriodMs = static_cast<uint32_t>(general.desktopPollActiveMs);
+    schedule.burstPeriodMs = static_cast<uint32_t>(general.desktopPollBurstMs);
+    schedule.burstDurationMs = static_cast<uint32_t>(general.desktopPollBurstDurationMs);
+    schedule.idleAfterMs = static_cast<uint32_t>(general.desktopPollIdleAfterMs);
+    return schedule;
+}
+
+// Helper to build the switch speculation settings from the overlay config
+static SwitchSpeculationConfig ToSwitchSpeculation(const OverlayConfig& overlay) {
+    SwitchSpeculationConfig speculation;
+    speculation.latencyBudgetMs = static_cast<uint32_t>(overlay.speculationBudgetMs);
+    return speculation;
+}
+
+// Helper to recognise virtual desktop shortcuts: Win+Ctrl+Left/Right (switch)
+// and Win+Ctrl+D / Win+Ctrl+F4 (create / close). The key itself is checked
+// first, so any other keystroke is dropped without reading modifier state.
+// Task View (Win+Tab, mouse, touchpad) is caught from foreground changes.
+static bool IsDesktopSwitchChord(USHORT vk) {
+    if (vk != VK_LEFT && vk != VK_RIGHT && vk != 'D' && vk != VK_F4) return false;
+    bool win = (GetAsyncKeyState(VK_LWIN) & 0x8000) || (GetAsyncKeyState(VK_RWIN) & 0x8000);
+    return win && (GetAsyncKeyState(VK_CONTROL) & 0x8000) != 0;
+}
+
 App& App::Instance() {
     static App instance;
     return instance;
@@ -186,10 +231,21 @@ void App::Shutdown() {
         UnregisterHotKey(m_hMainWnd, HOTKEY_OVERLAY_TOGGLE);
     }
 
+    // Stop the keyboard sink used for desktop-switch bursts
+    SetKeyboardSink(false);
+
     // Stop zoom update timer
     if (m_hMainWnd) {
         KillTimer(m_hMainWnd, TIMER_ZOOM_UPDATE);
         KillTimer(m_hMainWnd, TIMER_DESKTOP_POLL);
+        KillTimer(m_hMainWnd, TIMER_SWITCH_SPECULATION);
+    }
+
+    const SwitchSpeculationStats& speculation = m_switchSpeculator.GetStats();
+    if (speculation.predictions > 0) {
+        LOG_INFO("Switch speculation: %llu predictions, %llu hits, %llu misses, %llu early, %llu corrected, %llu expired",
+                 speculation.predictions, speculation.hits, speculation.misses,
+                 speculation.early, speculation.corrections, speculation.expired);
     }
 
     // Shutdown overlay first (depends on VirtualDesktop)
@@ -255,10 +311,17 @@ bool App::InitZoom() {
     zoomSettings.maxZoom = config.zoom.maxZoom;
     zoomSettings.smoothing = config.zoom.smoothing;
     zoomSettings.smoothingFactor = config.zoom.smoothingFactor;
+    zoomSettings.transformThresholdPx = config.zoom.transformThresholdPx;
+    zoomSettings.panFilter = PanFilterTypeToZoom(config.zoom.panFilter);
+    zoomSettings.panMinCutoffHz = config.zoom.panMinCutoffHz;
+    zoomSettings.panBeta = config.zoom.panBeta;
+    zoomSettings.cursorPrediction = CursorPredictionTypeToZoom(config.zoom.cursorPrediction);
+    zoomSettings.predictionLeadMs = config.zoom.predictionLeadMs;
     zoomSettings.animationDurationMs = config.zoom.animationDurationMs;
     zoomSettings.doubleTapToReset = config.zoom.doubleTapToReset;
     zoomSettings.doubleTapWindowMs = config.zoom.doubleTapWindowMs;
     zoomSettings.touchpadPinch = config.zoom.touchpadPinch;
+    zoomSettings.traceFile = config.zoom.traceFile;
 
     // Initialize zoom controller
     if (!ZoomController::Instance().Init(zoomSettings)) {
@@ -317,11 +380,15 @@ bool App::InitOverlay() {
     overlaySettings.watermarkFontSize = config.overlay.watermarkFontSize;
     overlaySettings.watermarkOpacity = config.overlay.watermarkOpacity;
     overlaySettings.watermarkShadow = config.overlay.watermarkShadow;
+    overlaySettings.watermarkOutlineWidth = config.overlay.watermarkOutlineWidth;
+    overlaySettings.watermarkGlowRadius = config.overlay.watermarkGlowRadius;
+    overlaySettings.distanceFieldText = config.overlay.distanceFieldText;
     overlaySettings.watermarkColor = config.overlay.watermarkColor;
     
     // Dodge settings
     overlaySettings.dodgeOnHover = config.overlay.dodgeOnHover;
     overlaySettings.dodgeProximity = config.overlay.dodgeProximity;
+    overlaySettings.labelCacheKB = config.overlay.labelCacheKB;
     
     // Style settings - BlurType maps to backdrop
     overlaySettings.style.backdrop = config.overlay.style.blur;
@@ -352,10 +419,28 @@ bool App::InitOverlay() {
             App::Instance().OnDesktopSwitched(index, name);
         }
     );
+
+    // Desktops added, removed or renamed: their labels need (re-)rasterizing.
+    // One warm-up per batch, however many desktops it touched.
+    VirtualDesktop::Instance().SetDesktopTopologyCallback(
+        [](const std::vector<DesktopTopologyEvent>&) {
+            App::Instance().WarmLabelCache();
+        }
+    );
     
-    // Start desktop polling timer (managed by App for reliable message pump delivery)
+    // Watch the VirtualDesktops registry key; the poll timer (managed by App for
+    // reliable message pump delivery) becomes a slow safety net and is re-armed
+    // with whatever delay the watcher asks for
+    VirtualDesktop::Instance().SetPollSchedule(ToPollSchedule(config.general));
+    VirtualDesktop::Instance().StartChangeWatch(m_hMainWnd, WM_USER_DESKTOP_REGISTRY_CHANGED,
+                                                WM_USER_DESKTOP_POLL_BURST);
     SetTimer(m_hMainWnd, TIMER_DESKTOP_POLL, TIMER_DESKTOP_POLL_MS, nullptr);
-    LOG_INFO("Started desktop polling timer");
+
+    m_switchSpeculator.SetConfig(ToSwitchSpeculation(config.overlay));
+    m_switchSpeculationEnabled = config.overlay.speculativeLabel;
+
+    SetKeyboardSink(config.overlay.enabled);
+    LOG_INFO("Started desktop change detection");
 
     // For watermark mode, show immediately with current desktop info
     if (config.overlay.mode == OverlayMode::Watermark && config.overlay.enabled) {
@@ -373,6 +458,7 @@ bool App::InitOverlay() {
         LOG_INFO("Not showing watermark on startup: mode=%d, enabled=%d",
                  static_cast<int>(config.overlay.mode), config.overlay.enabled ? 1 : 0);
     }
+    WarmLabelCache();
 
     LOG_INFO("Overlay feature initialized (VirtualDesktop available: %s)",
              VirtualDesktop::Instance().IsAvailable() ? "true" : "false");
@@ -385,9 +471,128 @@ void App::OnDesktopSwitched(int desktopIndex, const std::wstring& desktopName) {
     }
 
     LOG_DEBUG("Desktop switch event: %d (%ws)", desktopIndex, desktopName.c_str());
+
+    // Settle any prediction; a label already on screen is kept if it was right
+    SpeculationAction action = m_switchSpeculator.OnSwitchConfirmed(desktopIndex);
+    ScheduleSpeculationTimer();
+    if (action != SpeculationAction::ShowActual) {
+        const SwitchSpeculationStats& stats = m_switchSpeculator.GetStats();
+        LOG_DEBUG("Switch speculation: %s (hits=%llu, misses=%llu)",
+                  SpeculationActionToString(action), stats.hits, stats.misses);
+    }
+    if (action == SpeculationAction::None &&
+        (desktopIndex != m_speculatedIndex || desktopName == m_speculatedName)) {
+        return;  // Prediction (or a later step of a chained one) is already on screen
+    }
+
+    // Reuses the pre-rendered label when the prediction was right
     OverlayWindow::Instance().Show(desktopIndex, desktopName);
 }
 
+void App::SetKeyboardSink(bool enabled) {
+    if (enabled == m_keyboardSinkRegistered) return;
+
+    // Passive keyboard sink (no hook) so desktop-switch hotkeys start a fast
+    // poll burst and stale-registry switches are caught within a frame or
+    // two.
+    //
+    // Privacy: RIDEV_INPUTSINK delivers every keystroke on the system to
+    // this process, including keys typed into other applications (passwords
+    // too), not just Win+Ctrl+arrow. What we do with them is kept minimal:
+    // the sink is only registered while the overlay is shown on switches,
+    // OnRawInput reads the virtual key of key-down events and nothing else
+    // (no scan codes, no text, no timing), everything but the four Win+Ctrl
+    // chords is dropped at once, and nothing is logged or stored. See the
+    // Privacy section of the README.
+    RAWINPUTDEVICE keyboard = { 0x01, 0x06, RIDEV_INPUTSINK, m_hMainWnd };  // Generic desktop / keyboard
+    if (!enabled) {
+        keyboard.dwFlags = RIDEV_REMOVE;
+        keyboard.hwndTarget = nullptr;
+    }
+    if (!RegisterRawInputDevices(&keyboard, 1, sizeof(keyboard))) {
+        LOG_WARN("Failed to %s raw keyboard input: %lu", enabled ? "register" : "remove", GetLastError());
+        return;
+    }
+    m_keyboardSinkRegistered = enabled;
+    LOG_DEBUG("Raw keyboard sink %s", enabled ? "registered" : "removed");
+}
+
+void App::WarmLabelCache() {
+    if (!m_overlayEnabled) return;
+
+    // Catalog and name cache only: no COM round-trips
+    auto& vd = VirtualDesktop::Instance();
+    std::vector<std::pair<int, std::wstring>> desktops;
+    int count = vd.GetKnownDesktopCount();
+    for (int index = 1; index <= count; index++) {
+        DesktopInfo info;
+        if (vd.GetKnownDesktop(index, info)) {
+            desktops.emplace_back(index, info.name);
+        }
+    }
+    OverlayWindow::Instance().WarmLabelCache(desktops);
+}
+
+void App::SpeculateSwitch(SwitchDirection direction) {
+    if (!m_switchSpeculationEnabled) return;
+
+    auto& vd = VirtualDesktop::Instance();
+    int predicted = m_switchSpeculator.OnSwitchKey(direction, vd.GetLastKnownDesktopIndex(),
+                                                   vd.GetKnownDesktopCount(), GetTickCount64());
+    if (predicted == 0) {
+        ScheduleSpeculationTimer();
+        return;
+    }
+
+    DesktopInfo target;
+    if (!vd.GetKnownDesktop(predicted, target)) {
+        m_switchSpeculator.Reset();
+        ScheduleSpeculationTimer();
+        return;
+    }
+
+    m_speculatedIndex = predicted;
+    m_speculatedName = target.name;
+    OverlayWindow::Instance().Prerender(predicted, target.name);
+    LOG_DEBUG("Switch speculation: predicted desktop %d (%ws)", predicted, target.name.c_str());
+
+    // A zero budget presents the prediction straight away
+    ScheduleSpeculationTimer();
+    if (m_switchSpeculator.GetConfig().latencyBudgetMs == 0) {
+        OnSwitchSpeculationTimer();
+    }
+}
+
+void App::ScheduleSpeculationTimer() {
+    uint64_t dueMs = 0;
+    if (!m_switchSpeculator.GetNextDeadline(dueMs)) {
+        KillTimer(m_hMainWnd, TIMER_SWITCH_SPECULATION);
+        return;
+    }
+
+    uint64_t now = GetTickCount64();
+    UINT delay = (dueMs > now) ? static_cast<UINT>(dueMs - now) : USER_TIMER_MINIMUM;
+    SetTimer(m_hMainWnd, TIMER_SWITCH_SPECULATION, std::max<UINT>(delay, USER_TIMER_MINIMUM), nullptr);
+}
+
+void App::OnSwitchSpeculationTimer() {
+    if (!m_overlayEnabled) return;
+
+    SpeculationAction action = m_switchSpeculator.OnTick(GetTickCount64());
+    ScheduleSpeculationTimer();
+
+    if (action == SpeculationAction::ShowPrediction) {
+        // Confirmation is late: present the guess now, correct it if needed
+        OverlayWindow::Instance().Show(m_speculatedIndex, m_speculatedName);
+    } else if (action == SpeculationAction::Retract) {
+        // The switch never happened (blocked, or the key was swallowed)
+        DesktopInfo current;
+        if (VirtualDesktop::Instance().GetCurrentDesktop(current)) {
+            OverlayWindow::Instance().Show(current.index, current.name);
+        }
+    }
+}
+
 void App::OnToggleOverlay() {
     if (!m_overlayEnabled) {
         return;
@@ -411,6 +616,10 @@ void App::OnToggleOverlay() {
 void App::OnDisplayChange() {
     LOG_INFO("Display configuration changed, refreshing monitors");
     Monitor::Instance().Refresh();
+
+    if (m_zoomEnabled) {
+        ZoomController::Instance().OnDisplayChanged();
+    }
     
     // Notify overlay to reposition
     if (m_overlayEnabled) {
@@ -424,6 +633,12 @@ void App::OnDpiChanged(HWND hwnd, UINT dpi, const RECT* suggested) {
     
     LOG_INFO("DPI changed to %u", dpi);
 
+    // Monitor bounds can move with the scale; the zoom works from a snapshot
+    Monitor::Instance().Refresh();
+    if (m_zoomEnabled) {
+        ZoomController::Instance().OnDisplayChanged();
+    }
+
     // Future: Update overlay sizing
     // if (m_overlayWindow) m_overlayWindow->OnDpiChanged(dpi);
 }
@@ -447,6 +662,12 @@ void App::OnSettingsChanged() {
         zoomSettings.maxZoom = config.zoom.maxZoom;
         zoomSettings.smoothing = config.zoom.smoothing;
         zoomSettings.smoothingFactor = config.zoom.smoothingFactor;
+        zoomSettings.transformThresholdPx = config.zoom.transformThresholdPx;
+        zoomSettings.panFilter = PanFilterTypeToZoom(config.zoom.panFilter);
+        zoomSettings.panMinCutoffHz = config.zoom.panMinCutoffHz;
+        zoomSettings.panBeta = config.zoom.panBeta;
+        zoomSettings.cursorPrediction = CursorPredictionTypeToZoom(config.zoom.cursorPrediction);
+        zoomSettings.predictionLeadMs = config.zoom.predictionLeadMs;
         zoomSettings.doubleTapToReset = config.zoom.doubleTapToReset;
         zoomSettings.doubleTapWindowMs = config.zoom.doubleTapWindowMs;
         
@@ -469,11 +690,15 @@ void App::OnSettingsChanged() {
         overlaySettings.watermarkFontSize = config.overlay.watermarkFontSize;
         overlaySettings.watermarkOpacity = config.overlay.watermarkOpacity;
         overlaySettings.watermarkShadow = config.overlay.watermarkShadow;
+        overlaySettings.watermarkOutlineWidth = config.overlay.watermarkOutlineWidth;
+        overlaySettings.watermarkGlowRadius = config.overlay.watermarkGlowRadius;
+        overlaySettings.distanceFieldText = config.overlay.distanceFieldText;
         overlaySettings.watermarkColor = config.overlay.watermarkColor;
         
         // Dodge settings
         overlaySettings.dodgeOnHover = config.overlay.dodgeOnHover;
         overlaySettings.dodgeProximity = config.overlay.dodgeProximity;
+        overlaySettings.labelCacheKB = config.overlay.labelCacheKB;
         
         overlaySettings.style.backdrop = config.overlay.style.blur;
         overlaySettings.style.tintColor = config.overlay.style.tintColor;
@@ -495,6 +720,15 @@ void App::OnSettingsChanged() {
         
         OverlayWindow::Instance().ApplySettings(overlaySettings);
         LOG_INFO("Overlay settings applied");
+
+        VirtualDesktop::Instance().SetPollSchedule(ToPollSchedule(config.general));
+        OnDesktopPollBurst();  // Re-arm the poll timer with the new periods
+
+        m_switchSpeculator.SetConfig(ToSwitchSpeculation(config.overlay));
+        m_switchSpeculator.Reset();
+        m_switchSpeculationEnabled = config.overlay.speculativeLabel;
+        ScheduleSpeculationTimer();
+        SetKeyboardSink(config.overlay.enabled);
         
         // In watermark mode, refresh with real desktop name (not preview text)
         if (config.overlay.mode == OverlayMode::Watermark && config.overlay.enabled) {
@@ -503,6 +737,7 @@ void App::OnSettingsChanged() {
                 OverlayWindow::Instance().Show(desktopInfo.index, desktopInfo.name);
             }
         }
+        WarmLabelCache();
     }
 }
 
@@ -565,8 +800,54 @@ void App::OnZoomTimer() {
 void App::OnDesktopPollTimer() {
     if (!m_overlayEnabled) return;
     
-    // Call VirtualDesktop to check for desktop changes
-    VirtualDesktop::Instance().CheckDesktopChange();
+    // Check for desktop changes if the watcher says one is due, then
+    // reschedule for the watcher's next deadline
+    UINT nextMs = VirtualDesktop::Instance().PollDesktopChange();
+    SetTimer(m_hMainWnd, TIMER_DESKTOP_POLL, nextMs, nullptr);
+}
+
+void App::OnDesktopRegistryChanged() {
+    // Re-arm even while the overlay is off: the notification is one-shot,
+    // and a disarmed watch would stay deaf until the next poll re-armed it
+    VirtualDesktop::Instance().OnRegistryChangeNotify();
+    if (!m_overlayEnabled) return;
+
+    OnDesktopPollTimer();
+}
+
+void App::OnDesktopPollBurst() {
+    if (!m_overlayEnabled) return;
+
+    // The scheduler already switched to burst; pull the pending timer in
+    SetTimer(m_hMainWnd, TIMER_DESKTOP_POLL, VirtualDesktop::Instance().GetNextPollDelayMs(), nullptr);
+}
+
+void App::OnRawInput(HRAWINPUT hRawInput) {
+    if (!m_overlayEnabled) return;
+
+    RAWINPUT input = {};
+    UINT size = sizeof(input);
+    if (GetRawInputData(hRawInput, RID_INPUT, &input, &size, sizeof(RAWINPUTHEADER)) == static_cast<UINT>(-1)
+        || input.header.dwType != RIM_TYPEKEYBOARD) {
+        return;
+    }
+
+    const RAWKEYBOARD& kb = input.data.keyboard;
+    if (kb.Flags & RI_KEY_BREAK) {
+        return;  // Key up
+    }
+
+    // Other keys are not even counted as activity: foreground changes
+    // already keep the poll out of idle
+    if (!IsDesktopSwitchChord(kb.VKey)) {
+        return;
+    }
+
+    VirtualDesktop::Instance().OnSwitchGesture();
+    OnDesktopPollBurst();
+    if (kb.VKey == VK_LEFT || kb.VKey == VK_RIGHT) {
+        SpeculateSwitch(kb.VKey == VK_LEFT ? SwitchDirection::Left : SwitchDirection::Right);
+    }
 }
 
 bool App::InitSettings() {
@@ -3,6 +3,7 @@
 #include <windows.h>
 #include <memory>
 #include <string>
+#include "overlay/SwitchSpeculator.h"
 
 namespace VirtualOverlay {
 
@@ -13,14 +14,17 @@ class OverlayWindow;
 // Timer ID for zoom update
 constexpr UINT_PTR TIMER_ZOOM_UPDATE = 1;
 constexpr UINT_PTR TIMER_DESKTOP_POLL = 2;
+constexpr UINT_PTR TIMER_SWITCH_SPECULATION = 3;  // Latency budget / timeout of a predicted switch
 constexpr UINT TIMER_ZOOM_INTERVAL_MS = 16;  // ~60 FPS
-constexpr UINT TIMER_DESKTOP_POLL_MS = 150;  // Desktop switch detection
+constexpr UINT TIMER_DESKTOP_POLL_MS = 150;  // Initial desktop check; re-armed by the change watcher
 
 // Hotkey IDs
 constexpr int HOTKEY_OVERLAY_TOGGLE = 1;
 
 // Custom window messages
 constexpr UINT WM_USER_OVERLAY_TOGGLE = WM_USER + 120;
+constexpr UINT WM_USER_DESKTOP_REGISTRY_CHANGED = WM_USER + 121;  // Posted by the registry watch
+constexpr UINT WM_USER_DESKTOP_POLL_BURST = WM_USER + 122;        // Switch gesture seen (Task View)
 
 // Application lifecycle controller
 class App {
@@ -56,6 +60,10 @@ public:
     void OnModifierUp();
     void OnZoomTimer();
     void OnDesktopPollTimer();  // Desktop switch detection
+    void OnDesktopRegistryChanged();  // VirtualDesktops registry key changed
+    void OnDesktopPollBurst();  // Reschedule the poll timer for a burst
+    void OnRawInput(HRAWINPUT hRawInput);  // Keyboard sink: desktop-switch hotkeys
+    void OnSwitchSpeculationTimer();  // Present or retract a predicted switch
     
     // Overlay event handler
     void OnDesktopSwitched(int desktopIndex, const std::wstring& desktopName);
@@ -86,15 +94,32 @@ private:
     bool InitTrayIcon();
     // bool InitHotkeys();
 
+    // Raw keyboard input for switch bursts; only held while the overlay is on
+    void SetKeyboardSink(bool enabled);
+
+    // Pre-rasterize every desktop's watermark label
+    void WarmLabelCache();
+
+    // Speculative overlay label for Win+Ctrl+Left/Right
+    void SpeculateSwitch(SwitchDirection direction);
+    void ScheduleSpeculationTimer();
+
     HINSTANCE m_hInstance = nullptr;
     HWND m_hMainWnd = nullptr;
     bool m_running = false;
     bool m_initialized = false;
     bool m_zoomEnabled = false;
     bool m_overlayEnabled = false;
+    bool m_keyboardSinkRegistered = false;
 
     DWORD m_lastUpdateTime = 0;
 
+    // Predicted target of a desktop-switch hotkey
+    SwitchSpeculator m_switchSpeculator;
+    bool m_switchSpeculationEnabled = false;
+    int m_speculatedIndex = 0;
+    std::wstring m_speculatedName;  // Name the predicted label was rendered with
+
     // Future component pointers
     // std::unique_ptr<TrayIcon> m_trayIcon;
     // std::unique_ptr<OverlayWindow> m_overlayWindow;
@@ -1,4 +1,5 @@
 #include "Config.h"
+#include "../desktop/PollScheduler.h"
 #include "../utils/Logger.h"
 #include "../../lib/json.hpp"
 
@@ -108,6 +109,11 @@ bool Config::Load(const std::wstring& filePath) {
                 m_config.general.overlayToggleHotkey = Utf8ToWide(hotkey);
             }
             if (g.contains("forcePollingMode")) m_config.general.forcePollingMode = g["forcePollingMode"].get<bool>();
+            if (g.contains("desktopPollIdleMs")) m_config.general.desktopPollIdleMs = g["desktopPollIdleMs"].get<int>();
+            if (g.contains("desktopPollActiveMs")) m_config.general.desktopPollActiveMs = g["desktopPollActiveMs"].get<int>();
+            if (g.contains("desktopPollBurstMs")) m_config.general.desktopPollBurstMs = g["desktopPollBurstMs"].get<int>();
+            if (g.contains("desktopPollBurstDurationMs")) m_config.general.desktopPollBurstDurationMs = g["desktopPollBurstDurationMs"].get<int>();
+            if (g.contains("desktopPollIdleAfterMs")) m_config.general.desktopPollIdleAfterMs = g["desktopPollIdleAfterMs"].get<int>();
         }
         
         // Parse zoom settings
@@ -121,9 +127,16 @@ bool Config::Load(const std::wstring& filePath) {
             if (z.contains("smoothing")) m_config.zoom.smoothing = z["smoothing"].get<bool>();
             if (z.contains("smoothingFactor")) m_config.zoom.smoothingFactor = z["smoothingFactor"].get<float>();
             if (z.contains("animationDurationMs")) m_config.zoom.animationDurationMs = z["animationDurationMs"].get<int>();
+            if (z.contains("transformThresholdPx")) m_config.zoom.transformThresholdPx = z["transformThresholdPx"].get<float>();
+            if (z.contains("panFilter")) m_config.zoom.panFilter = StringToPanFilter(z["panFilter"].get<std::string>());
+            if (z.contains("panMinCutoffHz")) m_config.zoom.panMinCutoffHz = z["panMinCutoffHz"].get<float>();
+            if (z.contains("panBeta")) m_config.zoom.panBeta = z["panBeta"].get<float>();
+            if (z.contains("cursorPrediction")) m_config.zoom.cursorPrediction = StringToCursorPrediction(z["cursorPrediction"].get<std::string>());
+            if (z.contains("predictionLeadMs")) m_config.zoom.predictionLeadMs = z["predictionLeadMs"].get<float>();
             if (z.contains("doubleTapToReset")) m_config.zoom.doubleTapToReset = z["doubleTapToReset"].get<bool>();
             if (z.contains("doubleTapWindowMs")) m_config.zoom.doubleTapWindowMs = z["doubleTapWindowMs"].get<int>();
             if (z.contains("touchpadPinch")) m_config.zoom.touchpadPinch = z["touchpadPinch"].get<bool>();
+            if (z.contains("traceFile")) m_config.zoom.traceFile = Utf8ToWide(z["traceFile"].get<std::string>());
         }
         
         // Parse overlay settings
@@ -146,11 +159,19 @@ bool Config::Load(const std::wstring& filePath) {
             if (o.contains("watermarkFontSize")) m_config.overlay.watermarkFontSize = o["watermarkFontSize"].get<int>();
             if (o.contains("watermarkOpacity")) m_config.overlay.watermarkOpacity = o["watermarkOpacity"].get<float>();
             if (o.contains("watermarkShadow")) m_config.overlay.watermarkShadow = o["watermarkShadow"].get<bool>();
+            if (o.contains("watermarkOutlineWidth")) m_config.overlay.watermarkOutlineWidth = o["watermarkOutlineWidth"].get<int>();
+            if (o.contains("watermarkGlowRadius")) m_config.overlay.watermarkGlowRadius = o["watermarkGlowRadius"].get<int>();
+            if (o.contains("distanceFieldText")) m_config.overlay.distanceFieldText = o["distanceFieldText"].get<bool>();
             if (o.contains("watermarkColor")) m_config.overlay.watermarkColor = ParseColor(o["watermarkColor"].get<std::string>());
             
             // Dodge settings
             if (o.contains("dodgeOnHover")) m_config.overlay.dodgeOnHover = o["dodgeOnHover"].get<bool>();
             if (o.contains("dodgeProximity")) m_config.overlay.dodgeProximity = o["dodgeProximity"].get<int>();
+
+            // Speculative label settings
+            if (o.contains("speculativeLabel")) m_config.overlay.speculativeLabel = o["speculativeLabel"].get<bool>();
+            if (o.contains("speculationBudgetMs")) m_config.overlay.speculationBudgetMs = o["speculationBudgetMs"].get<int>();
+            if (o.contains("labelCacheKB")) m_config.overlay.labelCacheKB = o["labelCacheKB"].get<int>();
             
             // Parse style
             if (o.contains("style")) {
@@ -229,6 +250,11 @@ bool Config::Save(const std::wstring& filePath) {
         j["general"]["settingsHotkey"] = WideToUtf8(m_config.general.settingsHotkey);
         j["general"]["overlayToggleHotkey"] = WideToUtf8(m_config.general.overlayToggleHotkey);
         j["general"]["forcePollingMode"] = m_config.general.forcePollingMode;
+        j["general"]["desktopPollIdleMs"] = m_config.general.desktopPollIdleMs;
+        j["general"]["desktopPollActiveMs"] = m_config.general.desktopPollActiveMs;
+        j["general"]["desktopPollBurstMs"] = m_config.general.desktopPollBurstMs;
+        j["general"]["desktopPollBurstDurationMs"] = m_config.general.desktopPollBurstDurationMs;
+        j["general"]["desktopPollIdleAfterMs"] = m_config.general.desktopPollIdleAfterMs;
         
         // Zoom
         j["zoom"]["enabled"] = m_config.zoom.enabled;
@@ -239,9 +265,16 @@ bool Config::Save(const std::wstring& filePath) {
         j["zoom"]["smoothing"] = m_config.zoom.smoothing;
         j["zoom"]["smoothingFactor"] = m_config.zoom.smoothingFactor;
         j["zoom"]["animationDurationMs"] = m_config.zoom.animationDurationMs;
+        j["zoom"]["transformThresholdPx"] = m_config.zoom.transformThresholdPx;
+        j["zoom"]["panFilter"] = PanFilterToString(m_config.zoom.panFilter);
+        j["zoom"]["panMinCutoffHz"] = m_config.zoom.panMinCutoffHz;
+        j["zoom"]["panBeta"] = m_config.zoom.panBeta;
+        j["zoom"]["cursorPrediction"] = CursorPredictionToString(m_config.zoom.cursorPrediction);
+        j["zoom"]["predictionLeadMs"] = m_config.zoom.predictionLeadMs;
         j["zoom"]["doubleTapToReset"] = m_config.zoom.doubleTapToReset;
         j["zoom"]["doubleTapWindowMs"] = m_config.zoom.doubleTapWindowMs;
         j["zoom"]["touchpadPinch"] = m_config.zoom.touchpadPinch;
+        j["zoom"]["traceFile"] = WideToUtf8(m_config.zoom.traceFile);
         
         // Overlay
         j["overlay"]["enabled"] = m_config.overlay.enabled;
@@ -258,11 +291,19 @@ bool Config::Save(const std::wstring& filePath) {
         j["overlay"]["watermarkFontSize"] = m_config.overlay.watermarkFontSize;
         j["overlay"]["watermarkOpacity"] = m_config.overlay.watermarkOpacity;
         j["overlay"]["watermarkShadow"] = m_config.overlay.watermarkShadow;
+        j["overlay"]["watermarkOutlineWidth"] = m_config.overlay.watermarkOutlineWidth;
+        j["overlay"]["watermarkGlowRadius"] = m_config.overlay.watermarkGlowRadius;
+        j["overlay"]["distanceFieldText"] = m_config.overlay.distanceFieldText;
         j["overlay"]["watermarkColor"] = ColorToHex(m_config.overlay.watermarkColor);
         
         // Dodge settings
         j["overlay"]["dodgeOnHover"] = m_config.overlay.dodgeOnHover;
         j["overlay"]["dodgeProximity"] = m_config.overlay.dodgeProximity;
+
+        // Speculative label settings
+        j["overlay"]["speculativeLabel"] = m_config.overlay.speculativeLabel;
+        j["overlay"]["speculationBudgetMs"] = m_config.overlay.speculationBudgetMs;
+        j["overlay"]["labelCacheKB"] = m_config.overlay.labelCacheKB;
         
         // Style
         j["overlay"]["style"]["blur"] = BlurToString(m_config.overlay.style.blur);
@@ -343,6 +384,10 @@ bool Config::Validate(const AppConfig& config) const {
     if (config.zoom.maxZoom < 2.0f || config.zoom.maxZoom > 20.0f) return false;
     if (config.zoom.smoothingFactor < 0.05f || config.zoom.smoothingFactor > 0.5f) return false;
     if (config.zoom.animationDurationMs < 0 || config.zoom.animationDurationMs > 500) return false;
+    if (config.zoom.transformThresholdPx < 0.0f || config.zoom.transformThresholdPx > 8.0f) return false;
+    if (config.zoom.panMinCutoffHz < 0.05f || config.zoom.panMinCutoffHz > 10.0f) return false;
+    if (config.zoom.panBeta < 0.0f || config.zoom.panBeta > 1.0f) return false;
+    if (config.zoom.predictionLeadMs < 0.0f || config.zoom.predictionLeadMs > 50.0f) return false;
     if (config.zoom.doubleTapWindowMs < 100 || config.zoom.doubleTapWindowMs > 1000) return false;
     
     // Overlay validation
@@ -357,16 +402,39 @@ bool Config::Validate(const AppConfig& config) const {
 }
 
 void Config::ClampValues(AppConfig& config) {
+    // Clamp desktop poll schedule (burst <= active <= idle) to the ranges the
+    // scheduler itself enforces
+    using PollLimits = PollScheduleConfig;
+    auto& general = config.general;
+    general.desktopPollBurstMs = std::clamp(general.desktopPollBurstMs,
+        static_cast<int>(PollLimits::MIN_BURST_PERIOD_MS), static_cast<int>(PollLimits::MAX_BURST_PERIOD_MS));
+    general.desktopPollActiveMs = std::clamp(general.desktopPollActiveMs,
+        general.desktopPollBurstMs, static_cast<int>(PollLimits::MAX_ACTIVE_PERIOD_MS));
+    general.desktopPollIdleMs = std::clamp(general.desktopPollIdleMs,
+        general.desktopPollActiveMs, static_cast<int>(PollLimits::MAX_IDLE_PERIOD_MS));
+    general.desktopPollBurstDurationMs = std::clamp(general.desktopPollBurstDurationMs,
+        0, static_cast<int>(PollLimits::MAX_BURST_DURATION_MS));
+    general.desktopPollIdleAfterMs = std::clamp(general.desktopPollIdleAfterMs,
+        static_cast<int>(PollLimits::MIN_IDLE_AFTER_MS), static_cast<int>(PollLimits::MAX_IDLE_AFTER_MS));
+
     // Clamp zoom values
     config.zoom.zoomStep = std::clamp(config.zoom.zoomStep, 0.1f, 1.0f);
     config.zoom.minZoom = 1.0f;  // Fixed
     config.zoom.maxZoom = std::clamp(config.zoom.maxZoom, 2.0f, 20.0f);
     config.zoom.smoothingFactor = std::clamp(config.zoom.smoothingFactor, 0.05f, 0.5f);
     config.zoom.animationDurationMs = std::clamp(config.zoom.animationDurationMs, 0, 500);
+    config.zoom.transformThresholdPx = std::clamp(config.zoom.transformThresholdPx, 0.0f, 8.0f);
+    config.zoom.panMinCutoffHz = std::clamp(config.zoom.panMinCutoffHz, 0.05f, 10.0f);
+    config.zoom.panBeta = std::clamp(config.zoom.panBeta, 0.0f, 1.0f);
+    config.zoom.predictionLeadMs = std::clamp(config.zoom.predictionLeadMs, 0.0f, 50.0f);
     config.zoom.doubleTapWindowMs = std::clamp(config.zoom.doubleTapWindowMs, 100, 1000);
     
     // Clamp overlay values
     config.overlay.autoHideDelayMs = std::clamp(config.overlay.autoHideDelayMs, 500, 10000);
+    config.overlay.speculationBudgetMs = std::clamp(config.overlay.speculationBudgetMs, 0, 500);
+    config.overlay.labelCacheKB = std::clamp(config.overlay.labelCacheKB, 0, 65536);
+    config.overlay.watermarkOutlineWidth = std::clamp(config.overlay.watermarkOutlineWidth, 1, 8);
+    config.overlay.watermarkGlowRadius = std::clamp(config.overlay.watermarkGlowRadius, 0, 16);
     config.overlay.style.tintOpacity = std::clamp(config.overlay.style.tintOpacity, 0.0f, 1.0f);
     config.overlay.style.cornerRadius = std::clamp(config.overlay.style.cornerRadius, 0, 32);
     config.overlay.style.borderWidth = std::clamp(config.overlay.style.borderWidth, 0, 4);
@@ -467,6 +535,36 @@ ModifierKey Config::StringToModifier(const std::string& str) {
     return ModifierKey::Ctrl;  // Default
 }
 
+std::string Config::PanFilterToString(PanFilterType filter) {
+    switch (filter) {
+        case PanFilterType::Exponential: return "exponential";
+        case PanFilterType::OneEuro: return "one-euro";
+        default: return "exponential";
+    }
+}
+
+PanFilterType Config::StringToPanFilter(const std::string& str) {
+    if (str == "exponential") return PanFilterType::Exponential;
+    if (str == "one-euro") return PanFilterType::OneEuro;
+    return PanFilterType::Exponential;  // Default
+}
+
+std::string Config::CursorPredictionToString(CursorPredictionType prediction) {
+    switch (prediction) {
+        case CursorPredictionType::Off: return "off";
+        case CursorPredictionType::Kalman: return "kalman";
+        case CursorPredictionType::LeastSquares: return "least-squares";
+        default: return "off";
+    }
+}
+
+CursorPredictionType Config::StringToCursorPrediction(const std::string& str) {
+    if (str == "off") return CursorPredictionType::Off;
+    if (str == "kalman") return CursorPredictionType::Kalman;
+    if (str == "least-squares") return CursorPredictionType::LeastSquares;
+    return CursorPredictionType::Off;  // Default
+}
+
 uint32_t Config::ParseColor(const std::string& hex) {
     if (hex.empty()) return 0;
     
@@ -41,6 +41,17 @@ enum class ModifierKey {
     Win
 };
 
+enum class PanFilterType {
+    Exponential,  // Fixed smoothing (smoothingFactor)
+    OneEuro       // Speed-adaptive smoothing (panMinCutoffHz, panBeta)
+};
+
+enum class CursorPredictionType {
+    Off,
+    Kalman,       // Constant-velocity Kalman filter
+    LeastSquares  // Line through the last few cursor samples
+};
+
 // General settings
 struct GeneralConfig {
     bool startWithWindows = true;
@@ -48,6 +59,13 @@ struct GeneralConfig {
     std::wstring settingsHotkey = L"Ctrl+Shift+O";
     std::wstring overlayToggleHotkey = L"Ctrl+Shift+D";  // Toggle overlay visibility
     bool forcePollingMode = true;  // Always use polling for desktop detection (more reliable)
+
+    // Adaptive desktop poll: slow when idle, fast burst after a switch hotkey
+    int desktopPollIdleMs = 2000;          // Period after desktopPollIdleAfterMs without activity
+    int desktopPollActiveMs = 150;         // Period while the user is active
+    int desktopPollBurstMs = 16;           // Period right after Win+Ctrl+Arrow / Task View
+    int desktopPollBurstDurationMs = 500;  // How long a burst lasts
+    int desktopPollIdleAfterMs = 30000;
 };
 
 // Zoom settings
@@ -60,9 +78,16 @@ struct ZoomConfig {
     bool smoothing = true;
     float smoothingFactor = 0.08f;      // Reduced for snappier response
     int animationDurationMs = 50;       // Reduced for faster animation
+    float transformThresholdPx = 1.0f;  // Smallest visible change worth a Magnifier update
+    PanFilterType panFilter = PanFilterType::Exponential;
+    float panMinCutoffHz = 1.0f;        // One-Euro cutoff at rest, divided by the zoom level
+    float panBeta = 0.005f;             // One-Euro cutoff added per on-screen pixel/s
+    CursorPredictionType cursorPrediction = CursorPredictionType::Off;
+    float predictionLeadMs = 16.0f;     // Cursor prediction horizon, about one frame
     bool doubleTapToReset = true;
     int doubleTapWindowMs = 300;
     bool touchpadPinch = true;
+    std::wstring traceFile;             // Record zoom input to this file (empty = off)
 };
 
 // Overlay style settings
@@ -109,11 +134,21 @@ struct OverlayConfig {
     int watermarkFontSize = 120;
     float watermarkOpacity = 0.25f;
     bool watermarkShadow = false;
+    int watermarkOutlineWidth = 1;  // Outline thickness in px when watermarkShadow is on
+    int watermarkGlowRadius = 0;    // Soft glow around the outline in px (0 = hard edge)
+    bool distanceFieldText = true;  // Render labels from signed distance fields (no reshaping on resize)
     uint32_t watermarkColor = 0xFFFFFF;  // White by default
     
     // Dodge mode - move overlay when mouse approaches
     bool dodgeOnHover = false;
     int dodgeProximity = 100;  // pixels - how close mouse must be to trigger dodge
+
+    // Speculative label: on Win+Ctrl+Left/Right, render the predicted desktop
+    // before the switch is detected
+    bool speculativeLabel = true;
+    int speculationBudgetMs = 50;  // Show the prediction unconfirmed after this long
+
+    int labelCacheKB = 8192;  // Rasterized watermark labels kept for reuse (0 = off)
     
     OverlayStyleConfig style;
     OverlayTextConfig text;
@@ -172,6 +207,10 @@ public:
     static OverlayMode StringToMode(const std::string& str);
     static std::string ModifierToString(ModifierKey key);
     static ModifierKey StringToModifier(const std::string& str);
+    static std::string PanFilterToString(PanFilterType filter);
+    static PanFilterType StringToPanFilter(const std::string& str);
+    static std::string CursorPredictionToString(CursorPredictionType prediction);
+    static CursorPredictionType StringToCursorPrediction(const std::string& str);
 
 private:
     Config();
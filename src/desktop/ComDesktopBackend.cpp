@@ -0,0 +1,211 @@
+#include "ComDesktopBackend.h"
+#include "../utils/Logger.h"
+#include <winstring.h>
+#include <wrl/client.h>
+
+namespace VirtualOverlay {
+
+using Microsoft::WRL::ComPtr;
+
+namespace {
+
+// Per-ABI traits: interface types and calling-convention differences
+struct Win10Abi {
+    using Manager = IVirtualDesktopManagerInternal_Win10;
+    using Desktop = IVirtualDesktop_Win10;
+    static constexpr bool PER_MONITOR = false;   // Calls take no HMONITOR argument
+    static constexpr bool HAS_NAMES = false;
+    static constexpr const char* NAME = "Win10";
+};
+
+struct Win11_21H2Abi {
+    using Manager = IVirtualDesktopManagerInternal_Win11_21H2;
+    using Desktop = IVirtualDesktop_Win11_21H2;
+    static constexpr bool PER_MONITOR = true;
+    static constexpr bool HAS_NAMES = true;
+    static constexpr const char* NAME = "Win11_21H2";
+};
+
+struct Win11_23H2Abi {
+    using Manager = IVirtualDesktopManagerInternal_Win11_23H2;
+    using Desktop = IVirtualDesktop_Win11_23H2;
+    static constexpr bool PER_MONITOR = true;
+    static constexpr bool HAS_NAMES = true;
+    static constexpr const char* NAME = "Win11_23H2";
+};
+
+struct Win11_24H2_PreviewAbi {
+    using Manager = IVirtualDesktopManagerInternal_Win11_24H2_Preview;
+    using Desktop = IVirtualDesktop_Win11_24H2_Preview;
+    static constexpr bool PER_MONITOR = true;
+    static constexpr bool HAS_NAMES = true;
+    static constexpr const char* NAME = "Win11_24H2_Preview";
+};
+
+template <typename Abi>
+class ComDesktopBackend final : public IDesktopBackend {
+public:
+    using Manager = typename Abi::Manager;
+    using Desktop = typename Abi::Desktop;
+
+    ComDesktopBackend(IUnknown* pManager, const GUID& iidDesktop)
+        : m_pManager(pManager), m_iidDesktop(iidDesktop) {
+    }
+
+    const char* GetName() const override { return Abi::NAME; }
+    bool SupportsNames() const override { return Abi::HAS_NAMES; }
+
+    bool GetCount(int& count) override {
+        UINT value = 0;
+        HRESULT hr;
+        if constexpr (Abi::PER_MONITOR) {
+            hr = GetManager()->GetCount(nullptr, &value);
+        } else {
+            hr = GetManager()->GetCount(&value);
+        }
+        if (FAILED(hr)) {
+            LOG_ERROR("GetCount failed: 0x%08X", hr);
+            return false;
+        }
+        count = static_cast<int>(value);
+        return true;
+    }
+
+    bool GetCurrent(DesktopRecord& desktop) override {
+        ComPtr<Desktop> pDesktop;
+        HRESULT hr;
+        if constexpr (Abi::PER_MONITOR) {
+            // nullptr monitor: current desktop on any monitor
+            hr = GetManager()->GetCurrentDesktop(nullptr, pDesktop.GetAddressOf());
+        } else {
+            hr = GetManager()->GetCurrentDesktop(pDesktop.GetAddressOf());
+        }
+        if (FAILED(hr) || !pDesktop) {
+            LOG_ERROR("GetCurrentDesktop failed: 0x%08X", hr);
+            return false;
+        }
+        return ReadDesktop(pDesktop.Get(), desktop, true);
+    }
+
+    bool GetAt(int index, DesktopRecord& desktop) override {
+        ComPtr<IObjectArray> pDesktops;
+        if (index < 1 || !GetDesktopArray(pDesktops)) {
+            return false;
+        }
+        ComPtr<Desktop> pDesktop;
+        if (!GetArrayItem(pDesktops.Get(), static_cast<UINT>(index - 1), pDesktop)) {
+            return false;
+        }
+        return ReadDesktop(pDesktop.Get(), desktop, true);
+    }
+
+    bool Enumerate(std::vector<DesktopRecord>& desktops, bool withNames) override {
+        desktops.clear();
+        ComPtr<IObjectArray> pDesktops;
+        if (!GetDesktopArray(pDesktops)) {
+            return false;
+        }
+
+        UINT count = 0;
+        pDesktops->GetCount(&count);
+        desktops.resize(count);
+        for (UINT i = 0; i < count; i++) {
+            ComPtr<Desktop> pDesktop;
+            if (GetArrayItem(pDesktops.Get(), i, pDesktop)) {
+                ReadDesktop(pDesktop.Get(), desktops[i], withNames);
+            }
+        }
+        return true;
+    }
+
+private:
+    Manager* GetManager() const {
+        return static_cast<Manager*>(m_pManager.Get());
+    }
+
+    bool GetDesktopArray(ComPtr<IObjectArray>& pDesktops) const {
+        HRESULT hr;
+        if constexpr (Abi::PER_MONITOR) {
+            hr = GetManager()->GetDesktops(nullptr, pDesktops.GetAddressOf());
+        } else {
+            hr = GetManager()->GetDesktops(pDesktops.GetAddressOf());
+        }
+        return SUCCEEDED(hr) && pDesktops;
+    }
+
+    // Ask the array for the ABI interface directly: one call per desktop,
+    // no IUnknown round-trip and QueryInterface
+    bool GetArrayItem(IObjectArray* pDesktops, UINT i, ComPtr<Desktop>& pDesktop) const {
+        return SUCCEEDED(pDesktops->GetAt(i, m_iidDesktop,
+                                          reinterpret_cast<void**>(pDesktop.GetAddressOf())))
+               && pDesktop;
+    }
+
+    static bool ReadDesktop(Desktop* pDesktop, DesktopRecord& desktop, bool withName) {
+        GUID id = {};
+        if (FAILED(pDesktop->GetID(&id))) {
+            return false;
+        }
+        desktop.id = DesktopGuid::FromGUID(id);
+        desktop.name.clear();
+
+        if constexpr (Abi::HAS_NAMES) {
+            HSTRING hName = nullptr;
+            if (withName && SUCCEEDED(pDesktop->GetName(&hName)) && hName) {
+                UINT32 len = 0;
+                const wchar_t* raw = WindowsGetStringRawBuffer(hName, &len);
+                if (raw && len > 0) {
+                    desktop.name.assign(raw, len);
+                }
+                WindowsDeleteString(hName);
+            }
+        }
+        return true;
+    }
+
+    ComPtr<IUnknown> m_pManager;
+    GUID m_iidDesktop;
+};
+
+template <typename Abi>
+std::unique_ptr<IDesktopBackend> MakeBackend(IUnknown* pManager, const GUID& iidDesktop) {
+    return std::make_unique<ComDesktopBackend<Abi>>(pManager, iidDesktop);
+}
+
+}  // namespace
+
+std::unique_ptr<IDesktopBackend> CreateComDesktopBackend(WindowsVirtualDesktopVersion version,
+                                                         IUnknown* pManagerInternal) {
+    if (!pManagerInternal) {
+        return nullptr;
+    }
+
+    GUID iidDesktop = VirtualDesktopGUIDs::ForVersion(version).iidVirtualDesktop;
+
+    switch (version) {
+        case WindowsVirtualDesktopVersion::Win10_1803:
+        case WindowsVirtualDesktopVersion::Win10_1809:
+        case WindowsVirtualDesktopVersion::Win10_1903:
+        case WindowsVirtualDesktopVersion::Win10_1909:
+        case WindowsVirtualDesktopVersion::Win10_2004:
+        case WindowsVirtualDesktopVersion::Win10_20H2:
+        case WindowsVirtualDesktopVersion::Win10_21H1:
+        case WindowsVirtualDesktopVersion::Win10_21H2:
+        case WindowsVirtualDesktopVersion::Win10_22H2:
+            return MakeBackend<Win10Abi>(pManagerInternal, iidDesktop);
+
+        case WindowsVirtualDesktopVersion::Win11_21H2:
+        case WindowsVirtualDesktopVersion::Win11_22H2:
+            return MakeBackend<Win11_21H2Abi>(pManagerInternal, iidDesktop);
+
+        case WindowsVirtualDesktopVersion::Win11_23H2:
+        case WindowsVirtualDesktopVersion::Win11_24H2:
+            return MakeBackend<Win11_23H2Abi>(pManagerInternal, iidDesktop);
+
+        case WindowsVirtualDesktopVersion::Win11_24H2_Preview:
+        default:
+            return MakeBackend<Win11_24H2_PreviewAbi>(pManagerInternal, iidDesktop);
+    }
+}
+
+}  // namespace VirtualOverlay
@@ -0,0 +1,19 @@
+#pragma once
+
+// IDesktopBackend over the undocumented IVirtualDesktopManagerInternal.
+//
+// One template instantiation per interop ABI in VirtualDesktopInterop.h; the
+// Windows version is mapped to an ABI once, here, instead of in every query.
+
+#include "DesktopBackend.h"
+#include "VirtualDesktopInterop.h"
+#include <memory>
+
+namespace VirtualOverlay {
+
+// Returns nullptr if pManagerInternal is null. The backend holds a reference
+// to the manager for its lifetime.
+std::unique_ptr<IDesktopBackend> CreateComDesktopBackend(WindowsVirtualDesktopVersion version,
+                                                         IUnknown* pManagerInternal);
+
+}  // namespace VirtualOverlay
@@ -0,0 +1,20 @@
+#include "DesktopBackend.h"
+
+namespace VirtualOverlay {
+
+bool EnumerateDesktopIds(IDesktopBackend& backend, std::vector<DesktopGuid>& ids) {
+    ids.clear();
+
+    std::vector<DesktopRecord> desktops;
+    if (!backend.Enumerate(desktops, false)) {
+        return false;
+    }
+
+    ids.reserve(desktops.size());
+    for (const DesktopRecord& desktop : desktops) {
+        ids.push_back(desktop.id);
+    }
+    return true;
+}
+
+}  // namespace VirtualOverlay
@@ -0,0 +1,47 @@
+#pragma once
+
+// Type-erased access to the shell's virtual desktop list.
+//
+// The undocumented IVirtualDesktopManagerInternal ABI differs per Windows
+// release; ComDesktopBackend wraps one ABI per template instantiation and is
+// picked once in VirtualDesktop::Init, so query paths no longer switch on the
+// Windows version or QueryInterface per desktop. The tests drive the same
+// paths with a scripted backend (tests/support/MockDesktopBackend.h).
+//
+// Indices are 1-based, like everywhere else in VirtualDesktop.
+// Platform-independent (no <windows.h>).
+
+#include "DesktopGuid.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace VirtualOverlay {
+
+struct DesktopRecord {
+    DesktopGuid id;
+    std::wstring name;   // Empty if unnamed or the ABI has no names (Windows 10)
+};
+
+class IDesktopBackend {
+public:
+    virtual ~IDesktopBackend() = default;
+
+    virtual const char* GetName() const = 0;
+    virtual bool SupportsNames() const = 0;
+
+    virtual bool GetCount(int& count) = 0;
+    virtual bool GetCurrent(DesktopRecord& desktop) = 0;
+    virtual bool GetAt(int index, DesktopRecord& desktop) = 0;
+
+    // All desktops in one enumeration (names only if withNames). A desktop
+    // that fails to resolve is reported with a null id so positions still
+    // match desktop indices.
+    virtual bool Enumerate(std::vector<DesktopRecord>& desktops, bool withNames) = 0;
+};
+
+// Ids of all desktops from one Enumerate call, without names, in desktop
+// order. False (and ids empty) if the backend could not enumerate.
+bool EnumerateDesktopIds(IDesktopBackend& backend, std::vector<DesktopGuid>& ids);
+
+}  // namespace VirtualOverlay
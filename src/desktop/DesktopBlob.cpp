@@ -0,0 +1,123 @@
+#include "DesktopBlob.h"
+#include <algorithm>
+#include <cstring>
+
+namespace VirtualOverlay {
+
+const char* BlobStatusToString(BlobStatus status) {
+    switch (status) {
+        case BlobStatus::Ok:       return "ok";
+        case BlobStatus::Empty:    return "empty";
+        case BlobStatus::BadSize:  return "bad size";
+        case BlobStatus::TooLarge: return "too large";
+        default:                   return "unknown";
+    }
+}
+
+BlobStatus DesktopIdListView::Parse(const uint8_t* data, size_t size, DesktopIdListView& out) {
+    out = DesktopIdListView();
+    if (size == 0 || !data) {
+        return BlobStatus::Empty;
+    }
+    if (size % DesktopGuid::SIZE != 0) {
+        return BlobStatus::BadSize;
+    }
+    if (size / DesktopGuid::SIZE > MAX_DESKTOPS) {
+        return BlobStatus::TooLarge;
+    }
+    out.m_data = data;
+    out.m_count = size / DesktopGuid::SIZE;
+    return BlobStatus::Ok;
+}
+
+bool DesktopIdListView::Matches(size_t i, const DesktopGuid& id) const {
+    return std::memcmp(m_data + i * DesktopGuid::SIZE, id.bytes, DesktopGuid::SIZE) == 0;
+}
+
+int DesktopIdListView::Find(const DesktopGuid& id) const {
+    for (size_t i = 0; i < m_count; i++) {
+        if (Matches(i, id)) {
+            return static_cast<int>(i + 1);
+        }
+    }
+    return 0;
+}
+
+DesktopIdListDiff DiffDesktopIdLists(const DesktopIdListView& oldList, const DesktopIdListView& newList) {
+    DesktopIdListDiff diff;
+    diff.oldCount = oldList.GetCount();
+    diff.newCount = newList.GetCount();
+
+    size_t common = std::min(diff.oldCount, diff.newCount);
+    diff.firstDifference = common;
+
+    const uint8_t* a = oldList.GetData();
+    const uint8_t* b = newList.GetData();
+    for (size_t i = 0; i < common; i++) {
+        if (std::memcmp(a + i * DesktopGuid::SIZE, b + i * DesktopGuid::SIZE, DesktopGuid::SIZE) != 0) {
+            if (diff.changedPositions == 0) {
+                diff.firstDifference = i;
+            }
+            diff.changedPositions++;
+        }
+    }
+
+    diff.identical = diff.changedPositions == 0 && diff.oldCount == diff.newCount;
+    return diff;
+}
+
+BlobStatus ParseCurrentDesktopId(const uint8_t* data, size_t size, DesktopGuid& out) {
+    if (size == 0 || !data) {
+        return BlobStatus::Empty;
+    }
+    if (size != DesktopGuid::SIZE) {
+        return BlobStatus::BadSize;
+    }
+    out = DesktopGuid::FromBytes(data);
+    return BlobStatus::Ok;
+}
+
+BlobStatus DesktopNameView::Parse(const uint8_t* data, size_t size, DesktopNameView& out) {
+    out = DesktopNameView();
+    if (size == 0 || !data) {
+        return BlobStatus::Empty;
+    }
+    if (size % 2 != 0) {
+        return BlobStatus::BadSize;
+    }
+
+    // Stop at the first terminator; REG_SZ values aren't guaranteed to have one
+    size_t units = size / 2;
+    size_t length = 0;
+    while (length < units && (data[length * 2] | data[length * 2 + 1]) != 0) {
+        length++;
+    }
+    if (length > MAX_LENGTH) {
+        return BlobStatus::TooLarge;
+    }
+
+    out.m_data = data;
+    out.m_length = length;
+    return BlobStatus::Ok;
+}
+
+void DesktopNameView::AssignTo(std::wstring& out) const {
+    out.resize(m_length);
+    for (size_t i = 0; i < m_length; i++) {
+        out[i] = static_cast<wchar_t>(At(i));
+    }
+}
+
+bool DesktopNameView::Equals(const std::wstring& str) const {
+    if (str.size() != m_length) {
+        return false;
+    }
+    for (size_t i = 0; i < m_length; i++) {
+        if (static_cast<wchar_t>(At(i)) != str[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace VirtualOverlay
@@ -0,0 +1,99 @@
+#pragma once
+
+// Allocation-free parsers for the raw registry values Explorer keeps under
+// HKCU\...\Explorer\VirtualDesktops:
+//   VirtualDesktopIDs        REG_BINARY  N * 16-byte GUIDs, in desktop order
+//   CurrentVirtualDesktop    REG_BINARY  one 16-byte GUID
+//   Desktops\{GUID}\Name     REG_SZ      UTF-16LE, usually NUL-terminated
+//
+// All parsers work over a caller-owned buffer and return views into it; the
+// buffer must outlive the view. Registry buffers carry no alignment
+// guarantee, so GUIDs are only ever memcpy'd/memcmp'd, never cast.
+//
+// Platform-independent (no <windows.h>).
+
+#include "DesktopGuid.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace VirtualOverlay {
+
+enum class BlobStatus {
+    Ok,
+    Empty,       // Zero-length value
+    BadSize,     // Length is not a whole number of elements
+    TooLarge     // Exceeds the sanity limit for the value
+};
+
+const char* BlobStatusToString(BlobStatus status);
+
+// View over a VirtualDesktopIDs value
+class DesktopIdListView {
+public:
+    // More desktops than this is treated as corruption
+    static constexpr size_t MAX_DESKTOPS = 4096;
+
+    DesktopIdListView() = default;
+
+    static BlobStatus Parse(const uint8_t* data, size_t size, DesktopIdListView& out);
+
+    size_t GetCount() const { return m_count; }
+    bool IsEmpty() const { return m_count == 0; }
+    const uint8_t* GetData() const { return m_data; }
+    size_t GetSizeBytes() const { return m_count * DesktopGuid::SIZE; }
+
+    // Copy out the i-th GUID (0-based)
+    DesktopGuid At(size_t i) const { return DesktopGuid::FromBytes(m_data + i * DesktopGuid::SIZE); }
+
+    // Compare in place without copying
+    bool Matches(size_t i, const DesktopGuid& id) const;
+
+    // 1-based position of id, or 0. Linear; use DesktopCatalog for O(1).
+    int Find(const DesktopGuid& id) const;
+
+private:
+    const uint8_t* m_data = nullptr;
+    size_t m_count = 0;
+};
+
+// Result of comparing two VirtualDesktopIDs snapshots in a single pass
+struct DesktopIdListDiff {
+    bool identical = true;
+    size_t oldCount = 0;
+    size_t newCount = 0;
+    size_t firstDifference = 0;   // First position that differs (== min count if prefix-equal)
+    size_t changedPositions = 0;  // Positions within min(oldCount, newCount) that differ
+};
+
+DesktopIdListDiff DiffDesktopIdLists(const DesktopIdListView& oldList, const DesktopIdListView& newList);
+
+// CurrentVirtualDesktop: exactly one GUID
+BlobStatus ParseCurrentDesktopId(const uint8_t* data, size_t size, DesktopGuid& out);
+
+// View over a REG_SZ Name value (UTF-16LE code units, terminator excluded)
+class DesktopNameView {
+public:
+    // Names longer than this (in UTF-16 code units) are treated as corruption
+    static constexpr size_t MAX_LENGTH = 1024;
+
+    DesktopNameView() = default;
+
+    static BlobStatus Parse(const uint8_t* data, size_t size, DesktopNameView& out);
+
+    size_t GetLength() const { return m_length; }
+    bool IsEmpty() const { return m_length == 0; }
+    uint16_t At(size_t i) const {
+        return static_cast<uint16_t>(m_data[i * 2] | (m_data[i * 2 + 1] << 8));
+    }
+
+    // Decode into an existing string (reuses its capacity)
+    void AssignTo(std::wstring& out) const;
+    bool Equals(const std::wstring& str) const;
+
+private:
+    const uint8_t* m_data = nullptr;
+    size_t m_length = 0;
+};
+
+}  // namespace VirtualOverlay
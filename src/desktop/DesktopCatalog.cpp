@@ -0,0 +1,142 @@
+#include "DesktopCatalog.h"
+
+namespace VirtualOverlay {
+
+namespace {
+const std::wstring EMPTY_NAME;
+const DesktopGuid NULL_DESKTOP_GUID;
+}
+
+uint64_t DesktopCatalog::HashBytes(const uint8_t* data, size_t size) {
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= data[i];
+        hash *= 0x100000001B3ull;
+    }
+    return hash;
+}
+
+bool DesktopCatalog::UpdateFromBlob(const uint8_t* data, size_t size, BlobStatus* status) {
+    DesktopIdListView view;
+    BlobStatus parsed = DesktopIdListView::Parse(data, size, view);
+    if (status) {
+        *status = parsed;
+    }
+    if (parsed != BlobStatus::Ok) {
+        return false;
+    }
+
+    uint64_t hash = HashBytes(view.GetData(), view.GetSizeBytes());
+    if (m_hasData && view.GetSizeBytes() == m_blobSize && hash == m_blobHash) {
+        return false;  // Unchanged - the common case on every poll
+    }
+
+    std::vector<DesktopGuid> ids(view.GetCount());
+    for (size_t i = 0; i < ids.size(); i++) {
+        ids[i] = view.At(i);
+    }
+    Rebuild(ids.data(), ids.size(), view.GetSizeBytes(), hash);
+    return true;
+}
+
+bool DesktopCatalog::IsSameBlob(const uint8_t* data, size_t size) const {
+    return m_hasData && size == m_blobSize && HashBytes(data, size) == m_blobHash;
+}
+
+bool DesktopCatalog::UpdateFromIds(const DesktopGuid* ids, size_t count) {
+    size_t size = count * DesktopGuid::SIZE;
+    uint64_t hash = HashBytes(reinterpret_cast<const uint8_t*>(ids), size);
+    if (m_hasData && size == m_blobSize && hash == m_blobHash) {
+        return false;
+    }
+    Rebuild(ids, count, size, hash);
+    return true;
+}
+
+void DesktopCatalog::Rebuild(const DesktopGuid* ids, size_t count, size_t blobSize, uint64_t blobHash) {
+    // Carry names over for desktops that survived (lookup against old table)
+    std::vector<std::wstring> names(count);
+    for (size_t i = 0; i < count; i++) {
+        int oldIndex = IndexOf(ids[i]);
+        if (oldIndex > 0) {
+            names[i] = std::move(m_names[oldIndex - 1]);
+        }
+    }
+
+    m_ids.assign(ids, ids + count);
+    m_names.swap(names);
+    RebuildIndex();
+
+    m_blobSize = blobSize;
+    m_blobHash = blobHash;
+    m_hasData = true;
+    m_generation++;
+}
+
+void DesktopCatalog::RebuildIndex() {
+    size_t capacity = 8;
+    while (capacity < m_ids.size() * 2) {
+        capacity <<= 1;
+    }
+    m_slots.assign(capacity, -1);
+    m_slotMask = capacity - 1;
+
+    for (size_t i = 0; i < m_ids.size(); i++) {
+        size_t slot = SlotFor(m_ids[i]);
+        if (m_slots[slot] < 0) {  // First occurrence wins on duplicates
+            m_slots[slot] = static_cast<int32_t>(i);
+        }
+    }
+}
+
+size_t DesktopCatalog::SlotFor(const DesktopGuid& id) const {
+    size_t slot = static_cast<size_t>(id.Hash()) & m_slotMask;
+    while (m_slots[slot] >= 0 && m_ids[static_cast<size_t>(m_slots[slot])] != id) {
+        slot = (slot + 1) & m_slotMask;
+    }
+    return slot;
+}
+
+int DesktopCatalog::IndexOf(const DesktopGuid& id) const {
+    if (m_slots.empty()) {
+        return 0;
+    }
+    int32_t entry = m_slots[SlotFor(id)];
+    return entry >= 0 ? entry + 1 : 0;
+}
+
+const DesktopGuid& DesktopCatalog::GetId(int index) const {
+    if (index < 1 || static_cast<size_t>(index) > m_ids.size()) {
+        return NULL_DESKTOP_GUID;
+    }
+    return m_ids[static_cast<size_t>(index - 1)];
+}
+
+const std::wstring& DesktopCatalog::GetName(int index) const {
+    if (index < 1 || static_cast<size_t>(index) > m_names.size()) {
+        return EMPTY_NAME;
+    }
+    return m_names[static_cast<size_t>(index - 1)];
+}
+
+bool DesktopCatalog::SetName(const DesktopGuid& id, const std::wstring& name) {
+    int index = IndexOf(id);
+    if (index == 0) {
+        return false;
+    }
+    m_names[static_cast<size_t>(index - 1)] = name;
+    return true;
+}
+
+void DesktopCatalog::Clear() {
+    m_ids.clear();
+    m_names.clear();
+    m_slots.clear();
+    m_slotMask = 0;
+    m_blobSize = 0;
+    m_blobHash = 0;
+    m_hasData = false;
+    m_generation++;
+}
+
+}  // namespace VirtualOverlay
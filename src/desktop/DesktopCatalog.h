@@ -0,0 +1,78 @@
+#pragma once
+
+// Ordered list of virtual desktops with O(1) GUID -> index lookup.
+//
+// Built from the VirtualDesktopIDs registry blob (or an equivalent GUID list
+// from COM). The catalog is only rebuilt when the blob actually changes,
+// detected by size plus a 64-bit FNV-1a hash, and every rebuild bumps a
+// monotonically increasing generation number so dependants can tell whether
+// their cached view is still current. Lookups never allocate.
+//
+// Platform-independent (no <windows.h>).
+
+#include "DesktopBlob.h"
+#include "DesktopGuid.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace VirtualOverlay {
+
+class DesktopCatalog {
+public:
+    // Rebuild from the raw VirtualDesktopIDs value (N * 16 bytes).
+    // Returns true if the desktop list changed. Malformed values are rejected
+    // (reported through status) and leave the catalog untouched.
+    bool UpdateFromBlob(const uint8_t* data, size_t size, BlobStatus* status = nullptr);
+
+    // True if data is byte-identical to the blob the catalog was built from
+    bool IsSameBlob(const uint8_t* data, size_t size) const;
+
+    // Rebuild from an already-decoded ordered list
+    bool UpdateFromIds(const DesktopGuid* ids, size_t count);
+
+    // 1-based index of the desktop, or 0 if unknown
+    int IndexOf(const DesktopGuid& id) const;
+
+    bool Contains(const DesktopGuid& id) const { return IndexOf(id) != 0; }
+    size_t GetCount() const { return m_ids.size(); }
+    bool IsEmpty() const { return m_ids.empty(); }
+
+    // Access by 1-based index (as shown to the user)
+    const DesktopGuid& GetId(int index) const;
+    const std::vector<DesktopGuid>& GetIds() const { return m_ids; }
+
+    // Desktop names, parallel to the id list. Empty means "not known yet".
+    // Names survive rebuilds for desktops that still exist.
+    const std::wstring& GetName(int index) const;
+    bool SetName(const DesktopGuid& id, const std::wstring& name);
+
+    // Bumped on every rebuild that changed the desktop list
+    uint64_t GetGeneration() const { return m_generation; }
+
+    void Clear();
+
+    // FNV-1a over the raw id bytes (exposed for change detection by callers)
+    static uint64_t HashBytes(const uint8_t* data, size_t size);
+
+private:
+    void Rebuild(const DesktopGuid* ids, size_t count, size_t blobSize, uint64_t blobHash);
+    void RebuildIndex();
+    size_t SlotFor(const DesktopGuid& id) const;
+
+    std::vector<DesktopGuid> m_ids;
+    std::vector<std::wstring> m_names;
+
+    // Open-addressing (linear probing) table of indexes into m_ids, -1 = empty.
+    // Capacity is a power of two, at least twice the desktop count.
+    std::vector<int32_t> m_slots;
+    size_t m_slotMask = 0;
+
+    size_t m_blobSize = 0;
+    uint64_t m_blobHash = 0;
+    bool m_hasData = false;
+    uint64_t m_generation = 0;
+};
+
+}  // namespace VirtualOverlay
@@ -0,0 +1,145 @@
+#include "DesktopChangeWatcher.h"
+#include <algorithm>
+
+namespace VirtualOverlay {
+
+DesktopChangeWatcher::DesktopChangeWatcher(IRegistryWatchBackend& backend,
+                                           const DesktopWatchTiming& timing)
+    : m_backend(backend)
+    , m_timing(timing) {
+}
+
+void DesktopChangeWatcher::Start(uint64_t nowMs) {
+    m_running = true;
+    m_notifyPending = false;
+    m_recheckPending = false;
+    m_lastCheckMs = nowMs;
+    m_statsStartMs = nowMs;
+    m_nextArmAttemptMs = nowMs;
+    TryArm(nowMs);
+}
+
+void DesktopChangeWatcher::Stop() {
+    if (!m_running) {
+        return;
+    }
+    m_backend.Disarm();
+    m_running = false;
+    m_notifyPending = false;
+    m_recheckPending = false;
+}
+
+void DesktopChangeWatcher::OnNotify(uint64_t nowMs) {
+    if (!m_running) {
+        return;
+    }
+    m_stats.notifications++;
+    m_notifyPending = true;
+
+    // Notifications are one-shot: re-arm before the detection pass reads the
+    // registry so a write that lands during the read still wakes us up.
+    TryArm(nowMs);
+}
+
+DesktopWakeReason DesktopChangeWatcher::Poll(uint64_t nowMs) {
+    if (!m_running) {
+        return DesktopWakeReason::None;
+    }
+
+    m_stats.wakeups++;
+
+    if (!m_backend.IsArmed() && nowMs >= m_nextArmAttemptMs) {
+        TryArm(nowMs);
+    }
+
+    DesktopWakeReason reason = DesktopWakeReason::None;
+    if (m_notifyPending) {
+        reason = DesktopWakeReason::Notification;
+        m_notifyPending = false;
+        m_recheckPending = true;
+        m_recheckDueMs = nowMs + m_timing.recheckDelayMs;
+    } else if (m_recheckPending && nowMs >= m_recheckDueMs) {
+        reason = DesktopWakeReason::Recheck;
+        m_recheckPending = false;
+        m_stats.recheckChecks++;
+    } else {
+        bool armed = m_backend.IsArmed();
+        if (nowMs - m_lastCheckMs >= PollIntervalMs(nowMs, armed)) {
+            if (m_scheduler && m_scheduler->GetMode(nowMs) == PollMode::Burst) {
+                reason = DesktopWakeReason::Burst;
+                m_stats.burstChecks++;
+            } else if (armed) {
+                reason = DesktopWakeReason::SafetyNet;
+                m_stats.safetyNetChecks++;
+            } else {
+                reason = DesktopWakeReason::Fallback;
+                m_stats.fallbackChecks++;
+            }
+        }
+    }
+
+    if (reason != DesktopWakeReason::None) {
+        m_stats.checks++;
+        m_lastCheckMs = nowMs;
+    }
+    return reason;
+}
+
+uint32_t DesktopChangeWatcher::PollIntervalMs(uint64_t nowMs, bool armed) const {
+    if (!m_scheduler) {
+        return armed ? m_timing.safetyNetMs : m_timing.fallbackPollMs;
+    }
+    uint32_t period = m_scheduler->GetPeriodMs(nowMs);
+    if (m_scheduler->GetMode(nowMs) == PollMode::Burst || !armed) {
+        return period;
+    }
+    // Notifications cover ordinary switches; while armed the poll is only a
+    // safety net and never needs to run faster than that
+    return std::max(period, m_timing.safetyNetMs);
+}
+
+uint64_t DesktopChangeWatcher::NextDueMs(uint64_t nowMs) const {
+    bool armed = m_backend.IsArmed();
+    uint64_t due = m_lastCheckMs + PollIntervalMs(nowMs, armed);
+    if (m_recheckPending) {
+        due = std::min(due, m_recheckDueMs);
+    }
+    if (!armed) {
+        due = std::min(due, m_nextArmAttemptMs);
+    }
+    return due;
+}
+
+uint32_t DesktopChangeWatcher::NextWakeDelayMs(uint64_t nowMs) const {
+    if (m_notifyPending) {
+        return 1;
+    }
+    uint64_t due = NextDueMs(nowMs);
+    if (due <= nowMs) {
+        return 1;
+    }
+    return static_cast<uint32_t>(std::min<uint64_t>(due - nowMs, UINT32_MAX));
+}
+
+void DesktopChangeWatcher::ResetStats(uint64_t nowMs) {
+    m_stats = DesktopWatchStats();
+    m_statsStartMs = nowMs;
+}
+
+double DesktopChangeWatcher::WakeupsPerHour(uint64_t nowMs) const {
+    if (nowMs <= m_statsStartMs) {
+        return 0.0;
+    }
+    double elapsedMs = static_cast<double>(nowMs - m_statsStartMs);
+    return static_cast<double>(m_stats.wakeups) * 3600000.0 / elapsedMs;
+}
+
+void DesktopChangeWatcher::TryArm(uint64_t nowMs) {
+    if (m_backend.Arm()) {
+        return;
+    }
+    m_stats.armFailures++;
+    m_nextArmAttemptMs = nowMs + m_timing.rearmRetryMs;
+}
+
+}  // namespace VirtualOverlay
@@ -0,0 +1,126 @@
+#pragma once
+
+// Event-driven desktop change detection.
+//
+// Explorer writes CurrentVirtualDesktop (and the per-desktop Name values) under
+// HKCU\...\Explorer\VirtualDesktops whenever the user switches or renames a
+// desktop. Instead of re-reading those keys every 150 ms, the watcher arms a
+// one-shot change notification on the subtree and only asks for a detection
+// pass when it fires, plus:
+//   - a short follow-up re-check after each notification, because Explorer
+//     writes the values in a burst and the first read can land mid-burst;
+//   - a slow safety-net poll for the cases where the registry is not updated
+//     at all (switching to a desktop with no windows);
+//   - a fast fallback poll while the notification cannot be armed.
+//
+// An optional PollScheduler stretches those periods while the user is idle and
+// shortens them to a burst right after a desktop-switch gesture.
+//
+// This header is platform-independent (no <windows.h>) so the state machine
+// can be driven with a fake backend and an explicit clock.
+
+#include "PollScheduler.h"
+#include <cstdint>
+
+namespace VirtualOverlay {
+
+// A one-shot "something under this key changed" notification source.
+// Mirrors RegNotifyChangeKeyValue semantics: after a notification is
+// delivered the backend is disarmed and must be armed again.
+class IRegistryWatchBackend {
+public:
+    virtual ~IRegistryWatchBackend() = default;
+
+    // Arm (or re-arm) the notification. Returns false if the key could not
+    // be watched; the watcher then falls back to polling and retries later.
+    virtual bool Arm() = 0;
+
+    // Cancel any pending notification
+    virtual void Disarm() = 0;
+
+    virtual bool IsArmed() const = 0;
+};
+
+// Why the watcher asked for a detection pass
+enum class DesktopWakeReason {
+    None,
+    Notification,  // Registry change notification fired
+    Recheck,       // Follow-up after a notification burst
+    SafetyNet,     // Slow periodic poll (stale-registry cases)
+    Fallback,      // Fast poll while the notification is unavailable
+    Burst          // Scheduler burst after a desktop-switch gesture
+};
+
+struct DesktopWatchTiming {
+    uint32_t recheckDelayMs = 250;    // Follow-up read after a notification
+    uint32_t safetyNetMs = 1000;      // Poll interval while armed
+    uint32_t fallbackPollMs = 150;    // Poll interval while not armed (legacy rate)
+    uint32_t rearmRetryMs = 5000;     // How often to retry a failed Arm()
+};
+
+struct DesktopWatchStats {
+    uint64_t wakeups = 0;             // Calls to Poll() (timer ticks + notifications)
+    uint64_t checks = 0;              // Poll() calls that requested a detection pass
+    uint64_t notifications = 0;       // Notifications received
+    uint64_t recheckChecks = 0;
+    uint64_t safetyNetChecks = 0;
+    uint64_t fallbackChecks = 0;
+    uint64_t burstChecks = 0;
+    uint64_t armFailures = 0;
+};
+
+class DesktopChangeWatcher {
+public:
+    explicit DesktopChangeWatcher(IRegistryWatchBackend& backend,
+                                  const DesktopWatchTiming& timing = DesktopWatchTiming());
+
+    // Start watching. Always succeeds; if the backend cannot be armed the
+    // watcher runs in fallback-poll mode until a retry succeeds.
+    void Start(uint64_t nowMs);
+    void Stop();
+    bool IsRunning() const { return m_running; }
+
+    // Adapt poll periods to user activity (nullptr = fixed timing). The
+    // scheduler must outlive the watcher.
+    void SetScheduler(const PollScheduler* scheduler) { m_scheduler = scheduler; }
+
+    // True while the change notification is armed (event-driven mode)
+    bool IsEventDriven() const { return m_backend.IsArmed(); }
+
+    // Called when the backend's notification fires. Re-arms immediately so a
+    // change made while we're reading is not lost.
+    void OnNotify(uint64_t nowMs);
+
+    // Called on every wakeup (timer tick or after OnNotify). Returns the
+    // reason a detection pass should run now, or None.
+    DesktopWakeReason Poll(uint64_t nowMs);
+
+    // Milliseconds until the next Poll() is due (for re-arming the timer)
+    uint32_t NextWakeDelayMs(uint64_t nowMs) const;
+
+    const DesktopWatchStats& GetStats() const { return m_stats; }
+    void ResetStats(uint64_t nowMs);
+
+    // Headline metric: wakeups extrapolated to one hour of wall time
+    double WakeupsPerHour(uint64_t nowMs) const;
+
+private:
+    void TryArm(uint64_t nowMs);
+    uint64_t NextDueMs(uint64_t nowMs) const;
+    uint32_t PollIntervalMs(uint64_t nowMs, bool armed) const;
+
+    IRegistryWatchBackend& m_backend;
+    DesktopWatchTiming m_timing;
+    const PollScheduler* m_scheduler = nullptr;
+    DesktopWatchStats m_stats;
+
+    bool m_running = false;
+    bool m_notifyPending = false;
+    bool m_recheckPending = false;
+    uint64_t m_recheckDueMs = 0;
+    uint64_t m_lastCheckMs = 0;
+    uint64_t m_nextArmAttemptMs = 0;
+    uint64_t m_statsStartMs = 0;
+};
+
+}  // namespace VirtualOverlay
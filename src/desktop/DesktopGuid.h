@@ -0,0 +1,89 @@
+#pragma once
+
+// Platform-independent 16-byte desktop identifier.
+// Stored as the raw bytes Windows writes to the registry (the in-memory
+// layout of a GUID), so registry blobs can be copied in without conversion.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#ifdef _WIN32
+#include <guiddef.h>
+#endif
+
+namespace VirtualOverlay {
+
+struct DesktopGuid {
+    uint8_t bytes[16] = {};
+
+    static constexpr size_t SIZE = 16;
+
+    // Copy from an arbitrary (possibly unaligned) byte pointer
+    static DesktopGuid FromBytes(const uint8_t* data) {
+        DesktopGuid g;
+        std::memcpy(g.bytes, data, SIZE);
+        return g;
+    }
+
+    bool IsNull() const {
+        for (uint8_t b : bytes) {
+            if (b != 0) return false;
+        }
+        return true;
+    }
+
+    // GUIDs are random, so folding the two halves is a good enough hash
+    uint64_t Hash() const {
+        uint64_t lo = 0, hi = 0;
+        std::memcpy(&lo, bytes, 8);
+        std::memcpy(&hi, bytes + 8, 8);
+        uint64_t h = lo ^ (hi * 0x9E3779B97F4A7C15ull);
+        return h ^ (h >> 29);
+    }
+
+    bool operator==(const DesktopGuid& other) const {
+        return std::memcmp(bytes, other.bytes, SIZE) == 0;
+    }
+    bool operator!=(const DesktopGuid& other) const { return !(*this == other); }
+
+    // "{XXXXXXXX-XXXX-XXXX-XXXX-XXXXXXXXXXXX}", same as StringFromGUID2.
+    // Data1..Data3 are stored little-endian.
+    std::wstring ToRegistryString() const {
+        static const wchar_t HEX[] = L"0123456789ABCDEF";
+        static const int ORDER[20] = { 3, 2, 1, 0, -1, 5, 4, -1, 7, 6, -1, 8, 9, -1,
+                                       10, 11, 12, 13, 14, 15 };
+        std::wstring s;
+        s.reserve(38);
+        s += L'{';
+        for (int pos : ORDER) {
+            if (pos < 0) {
+                s += L'-';
+                continue;
+            }
+            s += HEX[bytes[pos] >> 4];
+            s += HEX[bytes[pos] & 0x0F];
+        }
+        s += L'}';
+        return s;
+    }
+
+#ifdef _WIN32
+    static DesktopGuid FromGUID(const GUID& guid) {
+        DesktopGuid g;
+        std::memcpy(g.bytes, &guid, SIZE);
+        return g;
+    }
+
+    GUID ToGUID() const {
+        GUID guid;
+        std::memcpy(&guid, bytes, SIZE);
+        return guid;
+    }
+#endif
+};
+
+static_assert(sizeof(DesktopGuid) == 16, "DesktopGuid must match the registry GUID layout");
+
+}  // namespace VirtualOverlay
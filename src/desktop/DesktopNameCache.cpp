@@ -0,0 +1,85 @@
+#include "DesktopNameCache.h"
+#include "DesktopBlob.h"
+#include "DesktopCatalog.h"
+
+namespace VirtualOverlay {
+
+DesktopNameEntry& DesktopNameCache::Lookup(const DesktopGuid& id) {
+    auto it = m_entries.find(id);
+    if (it == m_entries.end()) {
+        DesktopNameEntry entry;
+        entry.id = id;
+        entry.keyPath = L"Desktops\\" + id.ToRegistryString();
+        it = m_entries.emplace(id, std::move(entry)).first;
+    }
+
+    DesktopNameEntry& entry = it->second;
+    if (entry.stale) {
+        m_stats.registryReads++;
+    } else {
+        m_stats.cacheHits++;
+    }
+    return entry;
+}
+
+bool DesktopNameCache::Store(DesktopNameEntry& entry, const uint8_t* data, size_t size) {
+    entry.stale = false;
+    entry.loaded = true;
+
+    uint64_t hash = DesktopCatalog::HashBytes(data, size);
+    if (entry.hasRaw && entry.rawSize == size && entry.rawHash == hash) {
+        return false;  // Same bytes as last time - skip decoding
+    }
+    entry.rawSize = size;
+    entry.rawHash = hash;
+    entry.hasRaw = true;
+
+    DesktopNameView view;
+    BlobStatus status = DesktopNameView::Parse(data, size, view);
+    if (status == BlobStatus::Empty) {
+        view = DesktopNameView();
+    } else if (status != BlobStatus::Ok) {
+        return false;  // Malformed - keep the last good name
+    }
+
+    m_stats.decodes++;
+    if (view.Equals(entry.name)) {
+        return false;
+    }
+    view.AssignTo(entry.name);
+    entry.version++;
+    return true;
+}
+
+bool DesktopNameCache::StoreMissing(DesktopNameEntry& entry) {
+    entry.stale = false;
+    entry.loaded = true;
+    entry.hasRaw = false;
+    entry.rawSize = 0;
+    entry.rawHash = 0;
+
+    if (entry.name.empty()) {
+        return false;
+    }
+    entry.name.clear();
+    entry.version++;
+    return true;
+}
+
+void DesktopNameCache::InvalidateAll() {
+    for (auto& pair : m_entries) {
+        pair.second.stale = true;
+    }
+}
+
+void DesktopNameCache::Prune(const DesktopCatalog& catalog) {
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        if (!catalog.Contains(it->first)) {
+            it = m_entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+}  // namespace VirtualOverlay
@@ -0,0 +1,81 @@
+#pragma once
+
+// Per-desktop cache of the registry "Name" value.
+//
+// Each entry owns its prebuilt key path (Desktops\{GUID}, relative to the
+// VirtualDesktops key) and a fingerprint (size + hash) of the last raw value,
+// so an unchanged value is never re-decoded. Every decoded change bumps the
+// entry's version: callers detect renames by comparing a single integer.
+//
+// Entries are served from the cache until invalidated; the owner invalidates
+// when the registry change watch fires. The cache does no I/O itself.
+//
+// Platform-independent (no <windows.h>).
+
+#include "DesktopGuid.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+namespace VirtualOverlay {
+
+class DesktopCatalog;
+
+struct DesktopNameEntry {
+    DesktopGuid id;
+    std::wstring keyPath;       // L"Desktops\\{GUID}"
+    std::wstring name;          // Custom name, empty if the user never set one
+    uint32_t version = 0;       // Bumped whenever name changes
+    bool stale = true;          // Needs a registry read before use
+    bool loaded = false;        // Read at least once (later changes are renames)
+
+    // Fingerprint of the last raw value (UTF-16LE bytes)
+    size_t rawSize = 0;
+    uint64_t rawHash = 0;
+    bool hasRaw = false;
+};
+
+struct DesktopNameCacheStats {
+    uint64_t cacheHits = 0;       // Lookups served without touching the registry
+    uint64_t registryReads = 0;   // Lookups that required a registry read
+    uint64_t decodes = 0;         // Reads whose value actually changed
+};
+
+class DesktopNameCache {
+public:
+    // Find or create the entry for a desktop. Counts a cache hit if the
+    // entry is fresh; otherwise the caller must read the registry and call
+    // Store() or StoreMissing().
+    DesktopNameEntry& Lookup(const DesktopGuid& id);
+
+    // Record a registry read of the Name value (REG_SZ bytes, may include the
+    // terminator). Returns true if the name changed.
+    bool Store(DesktopNameEntry& entry, const uint8_t* data, size_t size);
+
+    // Record that the Name value does not exist. Returns true if a previous
+    // custom name was removed.
+    bool StoreMissing(DesktopNameEntry& entry);
+
+    // Mark every entry stale (registry changed)
+    void InvalidateAll();
+
+    // Drop entries for desktops no longer in the catalog
+    void Prune(const DesktopCatalog& catalog);
+
+    void Clear() { m_entries.clear(); }
+    size_t GetSize() const { return m_entries.size(); }
+
+    const DesktopNameCacheStats& GetStats() const { return m_stats; }
+    void ResetStats() { m_stats = DesktopNameCacheStats(); }
+
+private:
+    struct GuidHasher {
+        size_t operator()(const DesktopGuid& id) const { return static_cast<size_t>(id.Hash()); }
+    };
+
+    std::unordered_map<DesktopGuid, DesktopNameEntry, GuidHasher> m_entries;
+    DesktopNameCacheStats m_stats;
+};
+
+}  // namespace VirtualOverlay
@@ -0,0 +1,85 @@
+#include "DesktopSentinels.h"
+
+namespace VirtualOverlay {
+
+DesktopSentinels::DesktopSentinels(size_t perDesktop)
+    : m_perDesktop(perDesktop < 1 ? 1 : (perDesktop > MAX_PER_DESKTOP ? MAX_PER_DESKTOP : perDesktop)) {
+}
+
+uint64_t DesktopSentinels::RankKey(const WindowDesktopIndex::WindowEntry& entry) {
+    uint64_t key = entry.firstSeenMs;
+    if (entry.traits & WINDOW_TRAIT_TOOL) {
+        key += TOOL_WINDOW_PENALTY_MS;
+    }
+    if (entry.traits & WINDOW_TRAIT_OWNED) {
+        key += OWNED_WINDOW_PENALTY_MS;
+    }
+    return key;
+}
+
+int64_t DesktopSentinels::Score(const WindowDesktopIndex::WindowEntry& entry, uint64_t nowMs) {
+    return static_cast<int64_t>(nowMs) - static_cast<int64_t>(RankKey(entry));
+}
+
+const std::vector<DesktopSentinels::WindowKey>& DesktopSentinels::Get(const DesktopGuid& desktop,
+                                                                     const WindowDesktopIndex& index) {
+    const std::vector<WindowKey>* windows = index.GetWindows(desktop);
+    if (!windows || windows->empty()) {
+        m_sets.erase(desktop);
+        return m_empty;
+    }
+
+    SentinelSet& set = m_sets[desktop];
+    uint64_t revision = index.GetRevision(desktop);
+    if (set.revision != revision) {
+        Rebuild(set, *windows, index);
+        set.revision = revision;
+    }
+    return set.windows;
+}
+
+void DesktopSentinels::Rebuild(SentinelSet& set, const std::vector<WindowKey>& windows,
+                               const WindowDesktopIndex& index) {
+    m_rebuilds++;
+    set.windows.clear();
+
+    // Partial insertion sort into a K-sized buffer: O(n * K) with tiny K
+    uint64_t keys[MAX_PER_DESKTOP];
+    size_t limit = m_perDesktop;
+    for (WindowKey window : windows) {
+        const WindowDesktopIndex::WindowEntry* entry = index.Find(window);
+        if (!entry) {
+            continue;
+        }
+        uint64_t key = RankKey(*entry);
+
+        size_t count = set.windows.size();
+        if (count == limit && key >= keys[count - 1]) {
+            continue;
+        }
+        if (count < limit) {
+            set.windows.push_back(window);
+            count++;
+        }
+        size_t pos = count - 1;
+        while (pos > 0 && keys[pos - 1] > key) {
+            keys[pos] = keys[pos - 1];
+            set.windows[pos] = set.windows[pos - 1];
+            pos--;
+        }
+        keys[pos] = key;
+        set.windows[pos] = window;
+    }
+}
+
+void DesktopSentinels::Prune(const WindowDesktopIndex& index) {
+    for (auto it = m_sets.begin(); it != m_sets.end();) {
+        if (index.GetWindowCount(it->first) == 0) {
+            it = m_sets.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+}  // namespace VirtualOverlay
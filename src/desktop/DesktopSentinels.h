@@ -0,0 +1,72 @@
+#pragma once
+
+// Per-desktop sentinel windows: the few indexed windows most likely to stay
+// put, used to cross-check the registry's "current desktop" claim with one or
+// two IsWindowOnCurrentVirtualDesktop calls instead of an elimination pass.
+//
+// Ranking prefers long-lived windows: a window's rank key is its first-seen
+// time plus a handicap for tool and owned windows, which tend to be transient.
+// Because every window ages at the same rate the ordering never changes on its
+// own, so a desktop's set is only rebuilt when its index revision changes.
+// Pinned and hidden windows never reach the index, so they are never picked.
+//
+// Platform-independent (no <windows.h>).
+
+#include "DesktopGuid.h"
+#include "WindowDesktopIndex.h"
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace VirtualOverlay {
+
+class DesktopSentinels {
+public:
+    using WindowKey = WindowDesktopIndex::WindowKey;
+
+    static constexpr size_t DEFAULT_PER_DESKTOP = 3;
+    static constexpr size_t MAX_PER_DESKTOP = 16;
+
+    // Handicaps, expressed as extra "youth" in milliseconds
+    static constexpr uint64_t TOOL_WINDOW_PENALTY_MS = 10 * 60 * 1000;
+    static constexpr uint64_t OWNED_WINDOW_PENALTY_MS = 5 * 60 * 1000;
+
+    explicit DesktopSentinels(size_t perDesktop = DEFAULT_PER_DESKTOP);
+
+    // Lower is better. Stable over time for a given window.
+    static uint64_t RankKey(const WindowDesktopIndex::WindowEntry& entry);
+
+    // Score for diagnostics: effective age in ms (higher is better)
+    static int64_t Score(const WindowDesktopIndex::WindowEntry& entry, uint64_t nowMs);
+
+    // Best sentinels for a desktop, best first (empty if the desktop has no
+    // indexed windows). Rebuilt from the index only when it changed.
+    const std::vector<WindowKey>& Get(const DesktopGuid& desktop, const WindowDesktopIndex& index);
+
+    // Drop cached sets for desktops the index no longer knows
+    void Prune(const WindowDesktopIndex& index);
+
+    void Clear() { m_sets.clear(); }
+    size_t GetPerDesktop() const { return m_perDesktop; }
+    uint64_t GetRebuildCount() const { return m_rebuilds; }
+
+private:
+    struct GuidHasher {
+        size_t operator()(const DesktopGuid& id) const { return static_cast<size_t>(id.Hash()); }
+    };
+
+    struct SentinelSet {
+        uint64_t revision = 0;
+        std::vector<WindowKey> windows;
+    };
+
+    void Rebuild(SentinelSet& set, const std::vector<WindowKey>& windows, const WindowDesktopIndex& index);
+
+    size_t m_perDesktop;
+    std::unordered_map<DesktopGuid, SentinelSet, GuidHasher> m_sets;
+    std::vector<WindowKey> m_empty;
+    uint64_t m_rebuilds = 0;
+};
+
+}  // namespace VirtualOverlay
@@ -0,0 +1,85 @@
+#include "DesktopTopology.h"
+
+namespace VirtualOverlay {
+
+const char* DesktopTopologyChangeToString(DesktopTopologyChange change) {
+    switch (change) {
+        case DesktopTopologyChange::Created:   return "created";
+        case DesktopTopologyChange::Destroyed: return "destroyed";
+        case DesktopTopologyChange::Moved:     return "moved";
+        case DesktopTopologyChange::Renamed:   return "renamed";
+        default:                               return "unknown";
+    }
+}
+
+size_t DiffDesktopTopology(const DesktopCatalog& before, const DesktopCatalog& after,
+                           std::vector<DesktopTopologyEvent>& events) {
+    size_t startSize = events.size();
+    int oldCount = static_cast<int>(before.GetCount());
+    int newCount = static_cast<int>(after.GetCount());
+
+    // Destroyed: in old, not in new
+    for (int i = 1; i <= oldCount; i++) {
+        const DesktopGuid& id = before.GetId(i);
+        if (after.IndexOf(id) == 0) {
+            DesktopTopologyEvent ev;
+            ev.change = DesktopTopologyChange::Destroyed;
+            ev.id = id;
+            ev.oldIndex = i;
+            ev.name = before.GetName(i);
+            events.push_back(std::move(ev));
+        }
+    }
+
+    // Created, then Moved, then Renamed: one walk of the new list each so
+    // events come out grouped without a sort
+    for (int i = 1; i <= newCount; i++) {
+        const DesktopGuid& id = after.GetId(i);
+        int oldIndex = before.IndexOf(id);
+        if (oldIndex == 0) {
+            DesktopTopologyEvent ev;
+            ev.change = DesktopTopologyChange::Created;
+            ev.id = id;
+            ev.newIndex = i;
+            ev.name = after.GetName(i);
+            events.push_back(std::move(ev));
+        }
+    }
+
+    for (int i = 1; i <= newCount; i++) {
+        const DesktopGuid& id = after.GetId(i);
+        int oldIndex = before.IndexOf(id);
+        if (oldIndex != 0 && oldIndex != i) {
+            DesktopTopologyEvent ev;
+            ev.change = DesktopTopologyChange::Moved;
+            ev.id = id;
+            ev.oldIndex = oldIndex;
+            ev.newIndex = i;
+            ev.name = after.GetName(i);
+            events.push_back(std::move(ev));
+        }
+    }
+
+    for (int i = 1; i <= newCount; i++) {
+        const DesktopGuid& id = after.GetId(i);
+        int oldIndex = before.IndexOf(id);
+        if (oldIndex == 0) {
+            continue;
+        }
+        const std::wstring& oldName = before.GetName(oldIndex);
+        const std::wstring& newName = after.GetName(i);
+        if (!oldName.empty() && !newName.empty() && oldName != newName) {
+            DesktopTopologyEvent ev;
+            ev.change = DesktopTopologyChange::Renamed;
+            ev.id = id;
+            ev.oldIndex = oldIndex;
+            ev.newIndex = i;
+            ev.name = newName;
+            events.push_back(std::move(ev));
+        }
+    }
+
+    return events.size() - startSize;
+}
+
+}  // namespace VirtualOverlay
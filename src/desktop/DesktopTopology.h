@@ -0,0 +1,44 @@
+#pragma once
+
+// Typed desktop topology events derived from consecutive catalog snapshots.
+//
+// DiffDesktopTopology compares two DesktopCatalogs in O(n) using their hash
+// indexes: every desktop in the old list is looked up in the new one and vice
+// versa, so no sorting or nested scans are needed. Subscribers can use the
+// events to patch cached labels and indices instead of re-querying.
+//
+// Platform-independent (no <windows.h>).
+
+#include "DesktopCatalog.h"
+#include "DesktopGuid.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace VirtualOverlay {
+
+enum class DesktopTopologyChange {
+    Created,     // newIndex valid
+    Destroyed,   // oldIndex valid
+    Moved,       // oldIndex -> newIndex (includes shifts caused by create/destroy)
+    Renamed      // name holds the new name (both names known and non-empty)
+};
+
+struct DesktopTopologyEvent {
+    DesktopTopologyChange change = DesktopTopologyChange::Created;
+    DesktopGuid id;
+    int oldIndex = 0;    // 1-based, 0 if not applicable
+    int newIndex = 0;    // 1-based, 0 if not applicable
+    std::wstring name;
+};
+
+const char* DesktopTopologyChangeToString(DesktopTopologyChange change);
+
+// Append the events that turn `before` into `after`. Events are ordered:
+// Destroyed (old order), Created (new order), Moved (new order), Renamed.
+// Renames are only reported when both snapshots know the desktop's name.
+// Returns the number of events appended.
+size_t DiffDesktopTopology(const DesktopCatalog& before, const DesktopCatalog& after,
+                           std::vector<DesktopTopologyEvent>& events);
+
+}  // namespace VirtualOverlay
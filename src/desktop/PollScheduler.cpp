@@ -0,0 +1,68 @@
+#include "PollScheduler.h"
+#include <algorithm>
+
+namespace VirtualOverlay {
+
+const char* PollModeToString(PollMode mode) {
+    switch (mode) {
+        case PollMode::Idle:   return "idle";
+        case PollMode::Active: return "active";
+        case PollMode::Burst:  return "burst";
+        default:               return "unknown";
+    }
+}
+
+PollScheduler::PollScheduler(const PollScheduleConfig& config) {
+    SetConfig(config);
+}
+
+void PollScheduler::SetConfig(const PollScheduleConfig& config) {
+    using Limits = PollScheduleConfig;
+    m_config = config;
+    m_config.burstPeriodMs = std::clamp(m_config.burstPeriodMs, Limits::MIN_BURST_PERIOD_MS, Limits::MAX_BURST_PERIOD_MS);
+    m_config.activePeriodMs = std::clamp(m_config.activePeriodMs, m_config.burstPeriodMs, Limits::MAX_ACTIVE_PERIOD_MS);
+    m_config.idlePeriodMs = std::clamp(m_config.idlePeriodMs, m_config.activePeriodMs, Limits::MAX_IDLE_PERIOD_MS);
+    m_config.burstDurationMs = std::min(m_config.burstDurationMs, Limits::MAX_BURST_DURATION_MS);
+    m_config.idleAfterMs = std::clamp(m_config.idleAfterMs, Limits::MIN_IDLE_AFTER_MS, Limits::MAX_IDLE_AFTER_MS);
+}
+
+void PollScheduler::OnActivity(uint64_t nowMs) {
+    m_stats.activity++;
+    m_hasActivity = true;
+    m_lastActivityMs = nowMs;
+}
+
+void PollScheduler::OnBurstTrigger(uint64_t nowMs) {
+    m_stats.bursts++;
+    OnActivity(nowMs);
+    m_burstEndMs = nowMs + m_config.burstDurationMs;
+}
+
+void PollScheduler::OnSwitchDetected(uint64_t nowMs) {
+    if (nowMs < m_burstEndMs) {
+        m_stats.burstsResolved++;
+        m_burstEndMs = nowMs;
+    }
+    m_hasActivity = true;
+    m_lastActivityMs = nowMs;
+}
+
+PollMode PollScheduler::GetMode(uint64_t nowMs) const {
+    if (nowMs < m_burstEndMs) {
+        return PollMode::Burst;
+    }
+    if (m_hasActivity && nowMs - m_lastActivityMs < m_config.idleAfterMs) {
+        return PollMode::Active;
+    }
+    return PollMode::Idle;
+}
+
+uint32_t PollScheduler::GetPeriodMs(uint64_t nowMs) const {
+    switch (GetMode(nowMs)) {
+        case PollMode::Burst:  return m_config.burstPeriodMs;
+        case PollMode::Active: return m_config.activePeriodMs;
+        default:               return m_config.idlePeriodMs;
+    }
+}
+
+}  // namespace VirtualOverlay
@@ -0,0 +1,84 @@
+#pragma once
+
+// Adaptive period for the desktop detection poll.
+//
+// A fixed 150 ms poll costs ~576k registry reads a day on an idle machine and
+// still adds up to 150 ms before the overlay reacts to Win+Ctrl+Arrow. The
+// scheduler runs in one of three modes:
+//   - Burst:  a desktop-switch gesture was just seen (hotkey, Task View);
+//             poll every few ms until the switch is detected or it times out;
+//   - Active: recent user activity (foreground changes); the legacy rate;
+//   - Idle:   nothing happened for a while; a slow period.
+//
+// Pure policy: every call takes the current time, so wakeup counts and
+// detection latency can be simulated with a scripted clock.
+// Platform-independent (no <windows.h>).
+
+#include <cstdint>
+
+namespace VirtualOverlay {
+
+enum class PollMode {
+    Idle,
+    Active,
+    Burst
+};
+
+const char* PollModeToString(PollMode mode);
+
+struct PollScheduleConfig {
+    // Accepted ranges, shared with the config file clamp so a value the
+    // settings accept is never silently changed again by the scheduler
+    static constexpr uint32_t MIN_BURST_PERIOD_MS = 8;
+    static constexpr uint32_t MAX_BURST_PERIOD_MS = 100;
+    static constexpr uint32_t MAX_ACTIVE_PERIOD_MS = 1000;   // At least burstPeriodMs
+    static constexpr uint32_t MAX_IDLE_PERIOD_MS = 10000;    // At least activePeriodMs
+    static constexpr uint32_t MAX_BURST_DURATION_MS = 3000;
+    static constexpr uint32_t MIN_IDLE_AFTER_MS = 1000;
+    static constexpr uint32_t MAX_IDLE_AFTER_MS = 600000;
+
+    uint32_t idlePeriodMs = 2000;
+    uint32_t activePeriodMs = 150;
+    uint32_t burstPeriodMs = 16;
+    uint32_t burstDurationMs = 500;
+    uint32_t idleAfterMs = 30000;     // Inactivity before dropping to Idle
+};
+
+struct PollSchedulerStats {
+    uint64_t bursts = 0;              // Burst triggers received
+    uint64_t burstsResolved = 0;      // Bursts ended by a detected switch
+    uint64_t activity = 0;            // Activity notifications
+};
+
+class PollScheduler {
+public:
+    explicit PollScheduler(const PollScheduleConfig& config = PollScheduleConfig());
+
+    // Replace the configuration (invalid values are clamped)
+    void SetConfig(const PollScheduleConfig& config);
+    const PollScheduleConfig& GetConfig() const { return m_config; }
+
+    // User activity (input, foreground change): leave Idle
+    void OnActivity(uint64_t nowMs);
+
+    // Desktop-switch gesture seen: poll fast for burstDurationMs
+    void OnBurstTrigger(uint64_t nowMs);
+
+    // The detector saw the switch: the rest of the burst would be wasted
+    void OnSwitchDetected(uint64_t nowMs);
+
+    PollMode GetMode(uint64_t nowMs) const;
+    uint32_t GetPeriodMs(uint64_t nowMs) const;
+
+    const PollSchedulerStats& GetStats() const { return m_stats; }
+    void ResetStats() { m_stats = PollSchedulerStats(); }
+
+private:
+    PollScheduleConfig m_config;
+    PollSchedulerStats m_stats;
+    bool m_hasActivity = false;
+    uint64_t m_lastActivityMs = 0;
+    uint64_t m_burstEndMs = 0;        // Burst active while now < m_burstEndMs
+};
+
+}  // namespace VirtualOverlay
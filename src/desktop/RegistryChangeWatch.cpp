@@ -0,0 +1,104 @@
+#include "RegistryChangeWatch.h"
+#include "../utils/Logger.h"
+
+namespace VirtualOverlay {
+
+RegistryChangeWatch::RegistryChangeWatch(HKEY root, const wchar_t* subKey, HWND notifyWnd, UINT notifyMsg)
+    : m_root(root)
+    , m_subKey(subKey)
+    , m_notifyWnd(notifyWnd)
+    , m_notifyMsg(notifyMsg) {
+}
+
+RegistryChangeWatch::~RegistryChangeWatch() {
+    Close();
+}
+
+bool RegistryChangeWatch::Arm() {
+    if (m_armed) {
+        return true;
+    }
+
+    if (!m_hEvent) {
+        // Auto-reset: each notification wakes the wait callback exactly once
+        m_hEvent = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+        if (!m_hEvent) {
+            LOG_ERROR("RegistryChangeWatch: CreateEvent failed: %lu", GetLastError());
+            return false;
+        }
+    }
+
+    if (!m_hWait) {
+        if (!RegisterWaitForSingleObject(&m_hWait, m_hEvent, OnEventSignaled, this,
+                                         INFINITE, WT_EXECUTEINWAITTHREAD)) {
+            LOG_ERROR("RegistryChangeWatch: RegisterWaitForSingleObject failed: %lu", GetLastError());
+            m_hWait = nullptr;
+            return false;
+        }
+    }
+
+    if (!m_hKey) {
+        LONG result = RegOpenKeyExW(m_root, m_subKey.c_str(), 0, KEY_NOTIFY | KEY_READ, &m_hKey);
+        if (result != ERROR_SUCCESS) {
+            LOG_WARN("RegistryChangeWatch: cannot open %ws: %ld", m_subKey.c_str(), result);
+            m_hKey = nullptr;
+            return false;
+        }
+    }
+
+    // Watch the whole subtree: CurrentVirtualDesktop and VirtualDesktopIDs live
+    // on the key itself, desktop names under Desktops\{guid}.
+    // REG_NOTIFY_THREAD_AGNOSTIC keeps the registration alive independently of
+    // the calling thread, so re-arming from the UI thread is safe.
+    LONG result = RegNotifyChangeKeyValue(
+        m_hKey,
+        TRUE,
+        REG_NOTIFY_CHANGE_NAME | REG_NOTIFY_CHANGE_LAST_SET | REG_NOTIFY_THREAD_AGNOSTIC,
+        m_hEvent,
+        TRUE);
+    if (result != ERROR_SUCCESS) {
+        LOG_WARN("RegistryChangeWatch: RegNotifyChangeKeyValue failed: %ld", result);
+        // The key may have been deleted and recreated; reopen on next attempt
+        RegCloseKey(m_hKey);
+        m_hKey = nullptr;
+        return false;
+    }
+
+    m_armed = true;
+    return true;
+}
+
+void RegistryChangeWatch::Disarm() {
+    // Closing the key cancels the pending notification
+    m_armed = false;
+    if (m_hKey) {
+        RegCloseKey(m_hKey);
+        m_hKey = nullptr;
+    }
+}
+
+void RegistryChangeWatch::Close() {
+    Disarm();
+    if (m_hWait) {
+        // Block until any in-flight callback has returned
+        UnregisterWaitEx(m_hWait, INVALID_HANDLE_VALUE);
+        m_hWait = nullptr;
+    }
+    if (m_hEvent) {
+        CloseHandle(m_hEvent);
+        m_hEvent = nullptr;
+    }
+}
+
+void CALLBACK RegistryChangeWatch::OnEventSignaled(PVOID context, BOOLEAN timedOut) {
+    if (timedOut) {
+        return;
+    }
+    auto* self = static_cast<RegistryChangeWatch*>(context);
+    // Exchange so a burst of writes between re-arms posts a single message
+    if (self->m_armed.exchange(false) && self->m_notifyWnd) {
+        PostMessageW(self->m_notifyWnd, self->m_notifyMsg, 0, 0);
+    }
+}
+
+}  // namespace VirtualOverlay
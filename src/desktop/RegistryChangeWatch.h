@@ -0,0 +1,44 @@
+#pragma once
+
+#include "DesktopChangeWatcher.h"
+#include <windows.h>
+#include <atomic>
+#include <string>
+
+namespace VirtualOverlay {
+
+// Win32 backend for DesktopChangeWatcher.
+// Arms RegNotifyChangeKeyValue on a registry subtree and, when it fires,
+// posts notifyMsg to notifyWnd from a thread-pool wait callback so the
+// detection pass runs on the UI thread.
+class RegistryChangeWatch : public IRegistryWatchBackend {
+public:
+    RegistryChangeWatch(HKEY root, const wchar_t* subKey, HWND notifyWnd, UINT notifyMsg);
+    ~RegistryChangeWatch() override;
+
+    RegistryChangeWatch(const RegistryChangeWatch&) = delete;
+    RegistryChangeWatch& operator=(const RegistryChangeWatch&) = delete;
+
+    // IRegistryWatchBackend
+    bool Arm() override;
+    void Disarm() override;
+    bool IsArmed() const override { return m_armed.load(); }
+
+    // Release the key, event and wait registration
+    void Close();
+
+private:
+    static void CALLBACK OnEventSignaled(PVOID context, BOOLEAN timedOut);
+
+    HKEY m_root = nullptr;
+    std::wstring m_subKey;
+    HWND m_notifyWnd = nullptr;
+    UINT m_notifyMsg = 0;
+
+    HKEY m_hKey = nullptr;
+    HANDLE m_hEvent = nullptr;
+    HANDLE m_hWait = nullptr;
+    std::atomic<bool> m_armed{false};
+};
+
+}  // namespace VirtualOverlay
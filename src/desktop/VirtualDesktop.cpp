@@ -16,6 +16,10 @@ extern const CLSID CLSID_ImmersiveShell;
 // VirtualDesktopManagerInternal CLSID (declared before use, defined at end of file)
 extern const CLSID CLSID_VirtualDesktopManagerInternal;
 
+// Registry subtree Explorer updates on desktop switch / create / rename
+static const wchar_t* const VIRTUAL_DESKTOPS_KEY =
+    L"SOFTWARE\\Microsoft\\Windows\\CurrentVersion\\Explorer\\VirtualDesktops";
+
 VirtualDesktop::VirtualDesktop() = default;
 
 VirtualDesktop::~VirtualDesktop() {
@@ -118,7 +122,7 @@ bool VirtualDesktop::Init() {
         LOG_INFO("Registry desktop detection OK: %ws", guidStr);
         
         int idx = GetDesktopIndexFromPolling(testGuid);
-        std::wstring name = GetDesktopNameFromRegistry(testGuid);
+        std::wstring name = GetDesktopNameFromRegistry(testGuid, idx);
         LOG_INFO("Current desktop from registry: index=%d, name=%ws", idx, name.c_str());
     } else {
         LOG_WARN("Registry desktop detection FAILED - CurrentVirtualDesktop not found");
@@ -139,6 +143,12 @@ void VirtualDesktop::Shutdown() {
         m_desktopSwitchHook = nullptr;
     }
 
+    StopChangeWatch();
+    StopWindowTracking();
+    CloseVirtualDesktopsKey();
+    m_catalog.Clear();
+    m_nameCache.Clear();
+
     // Unregister notifications
     if (m_notificationCookie != 0 && m_pNotificationService) {
         m_pNotificationService->Unregister(m_notificationCookie);
@@ -240,7 +250,8 @@ bool VirtualDesktop::TryReinitialize() {
     // Refresh tracked desktop state
     if (GetCurrentDesktopIdFromRegistry(m_lastKnownDesktopId)) {
         m_lastKnownDesktopIndex = GetDesktopIndexFromPolling(m_lastKnownDesktopId);
-        m_lastKnownDesktopName = GetDesktopNameFromRegistry(m_lastKnownDesktopId);
+        m_lastKnownDesktopName = GetDesktopNameFromRegistry(m_lastKnownDesktopId, m_lastKnownDesktopIndex);
+        m_lastKnownNameVersion = ResolveDesktopName(m_lastKnownDesktopId).version;
         UpdateTrackedForegroundWindow(m_lastKnownDesktopId);
     }
 
@@ -303,6 +314,10 @@ bool VirtualDesktop::AcquireVirtualDesktopInterfaces() {
         }
     }
 
+    // Resolve the ABI once; queries go through the backend from here on
+    m_backend = CreateComDesktopBackend(m_windowsVersion, m_pVirtualDesktopManagerInternal.Get());
+    LOG_INFO("Virtual desktop backend: %s", m_backend->GetName());
+
     // Get notification service
     hr = m_pServiceProvider->QueryService(
         CLSID_VirtualDesktopNotificationService,
@@ -361,6 +376,7 @@ bool VirtualDesktop::AcquireVirtualDesktopInterfaces() {
 }
 
 void VirtualDesktop::ReleaseInterfaces() {
+    m_backend.reset();
     m_pNotificationHandler.Reset();
     m_pNotificationService.Reset();
     m_pVirtualDesktopManagerInternal.Reset();
@@ -368,32 +384,16 @@ void VirtualDesktop::ReleaseInterfaces() {
 }
 
 bool VirtualDesktop::GetCurrentDesktop(DesktopInfo& info) {
-    // If we have internal interfaces, use version-specific methods
-    if (m_available && m_pVirtualDesktopManagerInternal && !m_usingPolling) {
-        switch (m_windowsVersion) {
-            case WindowsVirtualDesktopVersion::Win10_1803:
-            case WindowsVirtualDesktopVersion::Win10_1809:
-            case WindowsVirtualDesktopVersion::Win10_1903:
-            case WindowsVirtualDesktopVersion::Win10_1909:
-            case WindowsVirtualDesktopVersion::Win10_2004:
-            case WindowsVirtualDesktopVersion::Win10_20H2:
-            case WindowsVirtualDesktopVersion::Win10_21H1:
-            case WindowsVirtualDesktopVersion::Win10_21H2:
-            case WindowsVirtualDesktopVersion::Win10_22H2:
-                return GetCurrentDesktopWin10(info);
-                
-            case WindowsVirtualDesktopVersion::Win11_21H2:
-            case WindowsVirtualDesktopVersion::Win11_22H2:
-                return GetCurrentDesktopWin11_21H2(info);
-                
-            case WindowsVirtualDesktopVersion::Win11_23H2:
-            case WindowsVirtualDesktopVersion::Win11_24H2:
-                return GetCurrentDesktopWin11_23H2(info);
-                
-            case WindowsVirtualDesktopVersion::Win11_24H2_Preview:
-            default:
-                return GetCurrentDesktopWin11_24H2_Preview(info);
+    // If we have internal interfaces, ask the version-specific backend
+    if (m_available && m_backend && !m_usingPolling) {
+        DesktopRecord current;
+        if (!m_backend->GetCurrent(current)) {
+            return false;
         }
+        info.id = current.id.ToGUID();
+        info.name = current.name;
+        info.index = GetDesktopIndexByGUID(info.id);
+        return true;
     }
     
     // Fallback: use polling-based desktop index or return default
@@ -403,7 +403,7 @@ bool VirtualDesktop::GetCurrentDesktop(DesktopInfo& info) {
         if (GetCurrentDesktopIdFromRegistry(currentId)) {
             info.id = currentId;
             info.index = GetDesktopIndexFromPolling(currentId);
-            info.name = GetDesktopNameFromRegistry(currentId);
+            info.name = GetDesktopNameFromRegistry(currentId, info.index);
             return true;
         }
         
@@ -416,7 +416,7 @@ bool VirtualDesktop::GetCurrentDesktop(DesktopInfo& info) {
                     && !IsEqualGUID(desktopId, GUID{})) {
                     info.id = desktopId;
                     info.index = GetDesktopIndexFromPolling(desktopId);
-                    info.name = GetDesktopNameFromRegistry(desktopId);
+                    info.name = GetDesktopNameFromRegistry(desktopId, info.index);
                     return true;
                 }
             }
@@ -426,7 +426,7 @@ bool VirtualDesktop::GetCurrentDesktop(DesktopInfo& info) {
         if (!IsEqualGUID(m_lastKnownDesktopId, GUID{})) {
             info.id = m_lastKnownDesktopId;
             info.index = m_lastKnownDesktopIndex;
-            info.name = GetDesktopNameFromRegistry(m_lastKnownDesktopId);
+            info.name = GetDesktopNameFromRegistry(m_lastKnownDesktopId, info.index);
             return true;
         }
     }
@@ -438,577 +438,349 @@ bool VirtualDesktop::GetCurrentDesktop(DesktopInfo& info) {
     return true;
 }
 
-bool VirtualDesktop::GetCurrentDesktopWin10(DesktopInfo& info) {
-    auto pManager = static_cast<IVirtualDesktopManagerInternal_Win10*>(
-        m_pVirtualDesktopManagerInternal.Get());
-    
-    ComPtr<IVirtualDesktop_Win10> pDesktop;
-    HRESULT hr = pManager->GetCurrentDesktop(pDesktop.GetAddressOf());
-    if (FAILED(hr)) {
-        LOG_ERROR("GetCurrentDesktop failed: 0x%08X", hr);
-        return false;
+int VirtualDesktop::GetDesktopCount() {
+    if (!m_available || !m_backend) {
+        return 1;
     }
 
-    return GetDesktopInfoWin10(pDesktop.Get(), info);
+    int count = 0;
+    if (!m_backend->GetCount(count)) {
+        return 1;
+    }
+    return count;
 }
 
-bool VirtualDesktop::GetCurrentDesktopWin11_21H2(DesktopInfo& info) {
-    auto pManager = static_cast<IVirtualDesktopManagerInternal_Win11_21H2*>(
-        m_pVirtualDesktopManagerInternal.Get());
-    
-    ComPtr<IVirtualDesktop_Win11_21H2> pDesktop;
-    // Pass nullptr for monitor to get current desktop on any monitor
-    HRESULT hr = pManager->GetCurrentDesktop(nullptr, pDesktop.GetAddressOf());
-    if (FAILED(hr)) {
-        LOG_ERROR("GetCurrentDesktop failed: 0x%08X", hr);
-        return false;
+int VirtualDesktop::GetDesktopIndexByGUID(const GUID& guid) {
+    // Fast path: O(1) lookup in the registry-backed catalog
+    if (RefreshCatalog()) {
+        int index = m_catalog.IndexOf(DesktopGuid::FromGUID(guid));
+        if (index > 0) {
+            return index;
+        }
     }
 
-    return GetDesktopInfoWin11_21H2(pDesktop.Get(), info);
-}
+    if (!m_available || !m_backend) {
+        return 1;
+    }
 
-bool VirtualDesktop::GetCurrentDesktopWin11_23H2(DesktopInfo& info) {
-    auto pManager = static_cast<IVirtualDesktopManagerInternal_Win11_23H2*>(
-        m_pVirtualDesktopManagerInternal.Get());
-    
-    ComPtr<IVirtualDesktop_Win11_23H2> pDesktop;
-    HRESULT hr = pManager->GetCurrentDesktop(nullptr, pDesktop.GetAddressOf());
-    if (FAILED(hr)) {
-        LOG_ERROR("GetCurrentDesktop failed: 0x%08X", hr);
-        return false;
+    // One batched enumeration; feed the catalog so later lookups hit the fast path
+    std::vector<DesktopGuid> ids;
+    if (!EnumerateDesktopIds(*m_backend, ids)) {
+        return 1;
     }
 
-    return GetDesktopInfoWin11_23H2(pDesktop.Get(), info);
+    DesktopCatalog previous = m_catalog;
+    if (m_catalog.UpdateFromIds(ids.data(), ids.size())) {
+        QueueTopologyDiff(previous);
+    }
+    int index = m_catalog.IndexOf(DesktopGuid::FromGUID(guid));
+    return index > 0 ? index : 1;
 }
 
-bool VirtualDesktop::GetCurrentDesktopWin11_24H2_Preview(DesktopInfo& info) {
-    auto pManager = static_cast<IVirtualDesktopManagerInternal_Win11_24H2_Preview*>(
-        m_pVirtualDesktopManagerInternal.Get());
-    
-    ComPtr<IVirtualDesktop_Win11_24H2_Preview> pDesktop;
-    HRESULT hr = pManager->GetCurrentDesktop(nullptr, pDesktop.GetAddressOf());
-    if (FAILED(hr)) {
-        LOG_ERROR("GetCurrentDesktop failed: 0x%08X", hr);
-        return false;
+bool VirtualDesktop::GetDesktopByIndex(int index, DesktopInfo& info) {
+    if (!m_available || !m_backend) {
+        info.index = index;
+        info.name = L"";
+        info.id = {};
+        return true;
     }
 
-    return GetDesktopInfoWin11_24H2_Preview(pDesktop.Get(), info);
-}
-
-bool VirtualDesktop::GetDesktopInfoWin10(IUnknown* pUnkDesktop, DesktopInfo& info) {
-    auto pDesktop = static_cast<IVirtualDesktop_Win10*>(pUnkDesktop);
-    
-    HRESULT hr = pDesktop->GetID(&info.id);
-    if (FAILED(hr)) {
+    DesktopRecord desktop;
+    if (!m_backend->GetAt(index, desktop)) {
         return false;
     }
 
-    // Windows 10 doesn't support desktop names in the COM interface
-    info.name = L"";
-    info.index = GetDesktopIndexByGUID(info.id);
-    
+    info.index = index;
+    info.id = desktop.id.ToGUID();
+    info.name = desktop.name;
     return true;
 }
 
-bool VirtualDesktop::GetDesktopInfoWin11_21H2(IUnknown* pUnkDesktop, DesktopInfo& info) {
-    auto pDesktop = static_cast<IVirtualDesktop_Win11_21H2*>(pUnkDesktop);
-    
-    HRESULT hr = pDesktop->GetID(&info.id);
-    if (FAILED(hr)) {
+bool VirtualDesktop::GetKnownDesktop(int index, DesktopInfo& info) {
+    if (index < 1 || index > static_cast<int>(m_catalog.GetCount())) {
         return false;
     }
 
-    HSTRING hName = nullptr;
-    hr = pDesktop->GetName(&hName);
-    if (SUCCEEDED(hr) && hName) {
-        info.name = HStringToWString(hName);
-        WindowsDeleteString(hName);
-    } else {
-        info.name = L"";
-    }
-
-    info.index = GetDesktopIndexByGUID(info.id);
-    
+    info.index = index;
+    info.id = m_catalog.GetId(index).ToGUID();
+    info.name = GetDesktopNameFromRegistry(info.id, index);  // Name cache; reads the registry on a miss
     return true;
 }
 
-bool VirtualDesktop::GetDesktopInfoWin11_23H2(IUnknown* pUnkDesktop, DesktopInfo& info) {
-    auto pDesktop = static_cast<IVirtualDesktop_Win11_23H2*>(pUnkDesktop);
-    
-    HRESULT hr = pDesktop->GetID(&info.id);
-    if (FAILED(hr)) {
-        return false;
+int VirtualDesktop::GetDesktopIndexFromPolling(const GUID& desktopId) {
+    // In polling mode, we can't get the actual index without internal COM interfaces
+    // Use the registry's VirtualDesktopIDs order (via the catalog) instead
+    if (RefreshCatalog()) {
+        int index = m_catalog.IndexOf(DesktopGuid::FromGUID(desktopId));
+        if (index > 0) {
+            return index;
+        }
     }
+    return 1;  // Not found, default to 1
+}
 
-    HSTRING hName = nullptr;
-    hr = pDesktop->GetName(&hName);
-    if (SUCCEEDED(hr) && hName) {
-        info.name = HStringToWString(hName);
-        WindowsDeleteString(hName);
-    } else {
-        info.name = L"";
+std::wstring VirtualDesktop::GetDesktopNameFromRegistry(const GUID& desktopId, int index) {
+    const DesktopNameEntry& entry = ResolveDesktopName(desktopId);
+    if (!entry.name.empty()) {
+        return entry.name;
     }
-
-    info.index = GetDesktopIndexByGUID(info.id);
     
-    return true;
+    // No custom name set - return "Desktop N" as fallback. Callers that
+    // already hold the index pass it, so the ids are not read again.
+    if (index < 1) {
+        index = GetDesktopIndexFromPolling(desktopId);
+    }
+    return L"Desktop " + std::to_wstring(index);
 }
 
-bool VirtualDesktop::GetDesktopInfoWin11_24H2_Preview(IUnknown* pUnkDesktop, DesktopInfo& info) {
-    auto pDesktop = static_cast<IVirtualDesktop_Win11_24H2_Preview*>(pUnkDesktop);
-    
-    HRESULT hr = pDesktop->GetID(&info.id);
-    if (FAILED(hr)) {
-        return false;
+const DesktopNameEntry& VirtualDesktop::ResolveDesktopName(const GUID& desktopId) {
+    // Forget desktops that were removed since the last lookup
+    if (m_catalog.GetGeneration() != m_nameCacheGeneration && !m_catalog.IsEmpty()) {
+        m_nameCache.Prune(m_catalog);
+        m_nameCacheGeneration = m_catalog.GetGeneration();
     }
 
-    HSTRING hName = nullptr;
-    hr = pDesktop->GetName(&hName);
-    if (SUCCEEDED(hr) && hName) {
-        info.name = HStringToWString(hName);
-        WindowsDeleteString(hName);
-    } else {
-        info.name = L"";
+    DesktopNameEntry& entry = m_nameCache.Lookup(DesktopGuid::FromGUID(desktopId));
+    if (!entry.stale) {
+        return entry;
     }
 
-    info.index = GetDesktopIndexByGUID(info.id);
-    
-    return true;
-}
+    HKEY hKey = GetVirtualDesktopsKey();
+    if (!hKey) {
+        return entry;  // Keep the last known name; retry on next lookup
+    }
 
-int VirtualDesktop::GetDesktopCount() {
-    if (!m_available || !m_pVirtualDesktopManagerInternal) {
-        return 1;
+    // HKCU\...\VirtualDesktops\Desktops\{GUID} -> Name, read with the key path
+    // prebuilt by the cache into a reused buffer
+    if (m_nameBuffer.empty()) {
+        m_nameBuffer.resize(256 * sizeof(wchar_t));
     }
 
-    UINT count = 0;
-    HRESULT hr = E_FAIL;
-
-    switch (m_windowsVersion) {
-        case WindowsVirtualDesktopVersion::Win10_1803:
-        case WindowsVirtualDesktopVersion::Win10_1809:
-        case WindowsVirtualDesktopVersion::Win10_1903:
-        case WindowsVirtualDesktopVersion::Win10_1909:
-        case WindowsVirtualDesktopVersion::Win10_2004:
-        case WindowsVirtualDesktopVersion::Win10_20H2:
-        case WindowsVirtualDesktopVersion::Win10_21H1:
-        case WindowsVirtualDesktopVersion::Win10_21H2:
-        case WindowsVirtualDesktopVersion::Win10_22H2: {
-            auto pManager = static_cast<IVirtualDesktopManagerInternal_Win10*>(
-                m_pVirtualDesktopManagerInternal.Get());
-            hr = pManager->GetCount(&count);
-            break;
-        }
-            
-        case WindowsVirtualDesktopVersion::Win11_21H2:
-        case WindowsVirtualDesktopVersion::Win11_22H2: {
-            auto pManager = static_cast<IVirtualDesktopManagerInternal_Win11_21H2*>(
-                m_pVirtualDesktopManagerInternal.Get());
-            hr = pManager->GetCount(nullptr, &count);
-            break;
-        }
-            
-        case WindowsVirtualDesktopVersion::Win11_23H2:
-        case WindowsVirtualDesktopVersion::Win11_24H2: {
-            auto pManager = static_cast<IVirtualDesktopManagerInternal_Win11_23H2*>(
-                m_pVirtualDesktopManagerInternal.Get());
-            hr = pManager->GetCount(nullptr, &count);
-            break;
-        }
-            
-        case WindowsVirtualDesktopVersion::Win11_24H2_Preview:
-        default: {
-            auto pManager = static_cast<IVirtualDesktopManagerInternal_Win11_24H2_Preview*>(
-                m_pVirtualDesktopManagerInternal.Get());
-            hr = pManager->GetCount(nullptr, &count);
-            break;
+    DWORD dataSize = 0;
+    LONG result = ERROR_MORE_DATA;
+    for (int attempt = 0; attempt < 2 && result == ERROR_MORE_DATA; attempt++) {
+        dataSize = static_cast<DWORD>(m_nameBuffer.size());
+        result = RegGetValueW(hKey, entry.keyPath.c_str(), L"Name", RRF_RT_REG_SZ,
+                              nullptr, m_nameBuffer.data(), &dataSize);
+        if (result == ERROR_MORE_DATA) {
+            m_nameBuffer.resize(dataSize);
         }
     }
 
-    if (FAILED(hr)) {
-        LOG_ERROR("GetCount failed: 0x%08X", hr);
-        return 1;
+    bool wasLoaded = entry.loaded;
+    bool changed = false;
+    if (result == ERROR_SUCCESS) {
+        changed = m_nameCache.Store(entry, m_nameBuffer.data(), dataSize);
+    } else if (result == ERROR_FILE_NOT_FOUND) {
+        changed = m_nameCache.StoreMissing(entry);
+    } else if (result == ERROR_KEY_DELETED) {
+        CloseVirtualDesktopsKey();
+    }
+
+    if (changed) {
+        m_catalog.SetName(entry.id, entry.name);
+        if (wasLoaded) {
+            DesktopTopologyEvent ev;
+            ev.change = DesktopTopologyChange::Renamed;
+            ev.id = entry.id;
+            ev.oldIndex = ev.newIndex = m_catalog.IndexOf(entry.id);
+            ev.name = entry.name;
+            m_pendingTopologyEvents.push_back(std::move(ev));
+        }
     }
-
-    return static_cast<int>(count);
+    return entry;
 }
 
-int VirtualDesktop::GetDesktopIndexByGUID(const GUID& guid) {
-    if (!m_available || !m_pVirtualDesktopManagerInternal) {
-        return 1;
+bool VirtualDesktop::GetCurrentDesktopIdFromRegistry(GUID& desktopId) {
+    // Read CurrentVirtualDesktop from registry - this is the most reliable method
+    HKEY hKey = GetVirtualDesktopsKey();
+    if (!hKey) {
+        return false;
     }
-
-    ComPtr<IObjectArray> pDesktops;
-    HRESULT hr = E_FAIL;
-
-    switch (m_windowsVersion) {
-        case WindowsVirtualDesktopVersion::Win10_1803:
-        case WindowsVirtualDesktopVersion::Win10_1809:
-        case WindowsVirtualDesktopVersion::Win10_1903:
-        case WindowsVirtualDesktopVersion::Win10_1909:
-        case WindowsVirtualDesktopVersion::Win10_2004:
-        case WindowsVirtualDesktopVersion::Win10_20H2:
-        case WindowsVirtualDesktopVersion::Win10_21H1:
-        case WindowsVirtualDesktopVersion::Win10_21H2:
-        case WindowsVirtualDesktopVersion::Win10_22H2: {
-            auto pManager = static_cast<IVirtualDesktopManagerInternal_Win10*>(
-                m_pVirtualDesktopManagerInternal.Get());
-            hr = pManager->GetDesktops(pDesktops.GetAddressOf());
-            break;
-        }
-            
-        case WindowsVirtualDesktopVersion::Win11_21H2:
-        case WindowsVirtualDesktopVersion::Win11_22H2: {
-            auto pManager = static_cast<IVirtualDesktopManagerInternal_Win11_21H2*>(
-                m_pVirtualDesktopManagerInternal.Get());
-            hr = pManager->GetDesktops(nullptr, pDesktops.GetAddressOf());
-            break;
-        }
-            
-        case WindowsVirtualDesktopVersion::Win11_23H2:
-        case WindowsVirtualDesktopVersion::Win11_24H2: {
-            auto pManager = static_cast<IVirtualDesktopManagerInternal_Win11_23H2*>(
-                m_pVirtualDesktopManagerInternal.Get());
-            hr = pManager->GetDesktops(nullptr, pDesktops.GetAddressOf());
-            break;
-        }
-            
-        case WindowsVirtualDesktopVersion::Win11_24H2_Preview:
-        default: {
-            auto pManager = static_cast<IVirtualDesktopManagerInternal_Win11_24H2_Preview*>(
-                m_pVirtualDesktopManagerInternal.Get());
-            hr = pManager->GetDesktops(nullptr, pDesktops.GetAddressOf());
-            break;
-        }
+    
+    // Oversized buffer so a malformed (too long) value is read and rejected
+    // by the parser rather than silently truncated
+    BYTE data[2 * sizeof(GUID)] = {};
+    DWORD dataSize = sizeof(data);
+    DWORD type = 0;
+    LONG result = RegQueryValueExW(hKey, L"CurrentVirtualDesktop", nullptr, &type, data, &dataSize);
+    if (result == ERROR_KEY_DELETED) {
+        CloseVirtualDesktopsKey();
+        return false;
     }
-
-    if (FAILED(hr) || !pDesktops) {
-        return 1;
+    if (result != ERROR_SUCCESS || type != REG_BINARY) {
+        return false;
     }
+    
+    DesktopGuid id;
+    if (ParseCurrentDesktopId(data, dataSize, id) != BlobStatus::Ok) {
+        return false;
+    }
+    desktopId = id.ToGUID();
+    return true;
+}
 
-    UINT count = 0;
-    pDesktops->GetCount(&count);
-
-    for (UINT i = 0; i < count; i++) {
-        ComPtr<IUnknown> pDesktopUnk;
-        if (FAILED(pDesktops->GetAt(i, IID_PPV_ARGS(&pDesktopUnk)))) {
-            continue;
-        }
+std::vector<GUID> VirtualDesktop::GetAllDesktopIdsFromRegistry() {
+    std::vector<GUID> result;
+    if (!RefreshCatalog()) {
+        return result;
+    }
 
-        GUID desktopId = {};
-        
-        switch (m_windowsVersion) {
-            case WindowsVirtualDesktopVersion::Win10_1803:
-            case WindowsVirtualDesktopVersion::Win10_1809:
-            case WindowsVirtualDesktopVersion::Win10_1903:
-            case WindowsVirtualDesktopVersion::Win10_1909:
-            case WindowsVirtualDesktopVersion::Win10_2004:
-            case WindowsVirtualDesktopVersion::Win10_20H2:
-            case WindowsVirtualDesktopVersion::Win10_21H1:
-            case WindowsVirtualDesktopVersion::Win10_21H2:
-            case WindowsVirtualDesktopVersion::Win10_22H2: {
-                ComPtr<IVirtualDesktop_Win10> pDesktop;
-                VirtualDesktopGUIDs guids = VirtualDesktopGUIDs::ForVersion(m_windowsVersion);
-                if (SUCCEEDED(pDesktopUnk->QueryInterface(guids.iidVirtualDesktop, reinterpret_cast<void**>(pDesktop.ReleaseAndGetAddressOf())))) {
-                    pDesktop->GetID(&desktopId);
-                }
-                break;
-            }
-                
-            case WindowsVirtualDesktopVersion::Win11_21H2:
-            case WindowsVirtualDesktopVersion::Win11_22H2: {
-                ComPtr<IVirtualDesktop_Win11_21H2> pDesktop;
-                VirtualDesktopGUIDs guids = VirtualDesktopGUIDs::ForVersion(m_windowsVersion);
-                if (SUCCEEDED(pDesktopUnk->QueryInterface(guids.iidVirtualDesktop, reinterpret_cast<void**>(pDesktop.ReleaseAndGetAddressOf())))) {
-                    pDesktop->GetID(&desktopId);
-                }
-                break;
-            }
-                
-            case WindowsVirtualDesktopVersion::Win11_23H2:
-            case WindowsVirtualDesktopVersion::Win11_24H2: {
-                ComPtr<IVirtualDesktop_Win11_23H2> pDesktop;
-                VirtualDesktopGUIDs guids = VirtualDesktopGUIDs::ForVersion(m_windowsVersion);
-                if (SUCCEEDED(pDesktopUnk->QueryInterface(guids.iidVirtualDesktop, reinterpret_cast<void**>(pDesktop.ReleaseAndGetAddressOf())))) {
-                    pDesktop->GetID(&desktopId);
-                }
-                break;
-            }
-                
-            case WindowsVirtualDesktopVersion::Win11_24H2_Preview:
-            default: {
-                ComPtr<IVirtualDesktop_Win11_24H2_Preview> pDesktop;
-                VirtualDesktopGUIDs guids = VirtualDesktopGUIDs::ForVersion(m_windowsVersion);
-                if (SUCCEEDED(pDesktopUnk->QueryInterface(guids.iidVirtualDesktop, reinterpret_cast<void**>(pDesktop.ReleaseAndGetAddressOf())))) {
-                    pDesktop->GetID(&desktopId);
-                }
-                break;
-            }
-        }
+    result.reserve(m_catalog.GetCount());
+    for (const auto& id : m_catalog.GetIds()) {
+        result.push_back(id.ToGUID());
+    }
+    return result;
+}
 
-        if (IsEqualGUID(desktopId, guid)) {
-            return static_cast<int>(i + 1);  // 1-based index
+HKEY VirtualDesktop::GetVirtualDesktopsKey() {
+    if (!m_hVirtualDesktopsKey) {
+        LONG result = RegOpenKeyExW(HKEY_CURRENT_USER, VIRTUAL_DESKTOPS_KEY, 0, KEY_READ,
+                                    &m_hVirtualDesktopsKey);
+        if (result != ERROR_SUCCESS) {
+            m_hVirtualDesktopsKey = nullptr;
         }
     }
-
-    return 1;
+    return m_hVirtualDesktopsKey;
 }
 
-bool VirtualDesktop::GetDesktopByIndex(int index, DesktopInfo& info) {
-    if (!m_available || !m_pVirtualDesktopManagerInternal) {
-        info.index = index;
-        info.name = L"";
-        info.id = {};
-        return true;
+void VirtualDesktop::CloseVirtualDesktopsKey() {
+    if (m_hVirtualDesktopsKey) {
+        RegCloseKey(m_hVirtualDesktopsKey);
+        m_hVirtualDesktopsKey = nullptr;
     }
+}
 
-    ComPtr<IObjectArray> pDesktops;
-    HRESULT hr = E_FAIL;
-
-    // Get desktops array based on Windows version
-    switch (m_windowsVersion) {
-        case WindowsVirtualDesktopVersion::Win10_1803:
-        case WindowsVirtualDesktopVersion::Win10_1809:
-        case WindowsVirtualDesktopVersion::Win10_1903:
-        case WindowsVirtualDesktopVersion::Win10_1909:
-        case WindowsVirtualDesktopVersion::Win10_2004:
-        case WindowsVirtualDesktopVersion::Win10_20H2:
-        case WindowsVirtualDesktopVersion::Win10_21H1:
-        case WindowsVirtualDesktopVersion::Win10_21H2:
-        case WindowsVirtualDesktopVersion::Win10_22H2: {
-            auto pManager = static_cast<IVirtualDesktopManagerInternal_Win10*>(
-                m_pVirtualDesktopManagerInternal.Get());
-            hr = pManager->GetDesktops(pDesktops.GetAddressOf());
-            break;
-        }
-            
-        case WindowsVirtualDesktopVersion::Win11_21H2:
-        case WindowsVirtualDesktopVersion::Win11_22H2: {
-            auto pManager = static_cast<IVirtualDesktopManagerInternal_Win11_21H2*>(
-                m_pVirtualDesktopManagerInternal.Get());
-            hr = pManager->GetDesktops(nullptr, pDesktops.GetAddressOf());
-            break;
-        }
-            
-        case WindowsVirtualDesktopVersion::Win11_23H2:
-        case WindowsVirtualDesktopVersion::Win11_24H2: {
-            auto pManager = static_cast<IVirtualDesktopManagerInternal_Win11_23H2*>(
-                m_pVirtualDesktopManagerInternal.Get());
-            hr = pManager->GetDesktops(nullptr, pDesktops.GetAddressOf());
-            break;
-        }
-            
-        case WindowsVirtualDesktopVersion::Win11_24H2_Preview:
-        default: {
-            auto pManager = static_cast<IVirtualDesktopManagerInternal_Win11_24H2_Preview*>(
-                m_pVirtualDesktopManagerInternal.Get());
-            hr = pManager->GetDesktops(nullptr, pDesktops.GetAddressOf());
-            break;
-        }
+bool VirtualDesktop::RefreshCatalog() {
+    HKEY hKey = GetVirtualDesktopsKey();
+    if (!hKey) {
+        return false;
     }
 
-    if (FAILED(hr) || !pDesktops) {
-        return false;
+    // Read into the reused buffer; grow only if Explorer has more desktops
+    // than we've seen before
+    if (m_idsBlob.empty()) {
+        m_idsBlob.resize(32 * sizeof(GUID));
     }
 
-    UINT count = 0;
-    pDesktops->GetCount(&count);
+    DWORD dataSize = 0;
+    DWORD type = 0;
+    LONG result = ERROR_MORE_DATA;
+    for (int attempt = 0; attempt < 2 && result == ERROR_MORE_DATA; attempt++) {
+        dataSize = static_cast<DWORD>(m_idsBlob.size());
+        result = RegQueryValueExW(hKey, L"VirtualDesktopIDs", nullptr, &type,
+                                  m_idsBlob.data(), &dataSize);
+        if (result == ERROR_MORE_DATA) {
+            m_idsBlob.resize(dataSize);
+        }
+    }
 
-    // Convert to 0-based index
-    UINT idx = static_cast<UINT>(index - 1);
-    if (idx >= count) {
+    if (result == ERROR_KEY_DELETED) {
+        // Explorer recreated the key - reopen on the next call
+        CloseVirtualDesktopsKey();
         return false;
     }
 
-    ComPtr<IUnknown> pDesktopUnk;
-    if (FAILED(pDesktops->GetAt(idx, IID_PPV_ARGS(&pDesktopUnk)))) {
+    if (result != ERROR_SUCCESS || type != REG_BINARY) {
         return false;
     }
 
-    info.index = index;
-
-    switch (m_windowsVersion) {
-        case WindowsVirtualDesktopVersion::Win10_1803:
-        case WindowsVirtualDesktopVersion::Win10_1809:
-        case WindowsVirtualDesktopVersion::Win10_1903:
-        case WindowsVirtualDesktopVersion::Win10_1909:
-        case WindowsVirtualDesktopVersion::Win10_2004:
-        case WindowsVirtualDesktopVersion::Win10_20H2:
-        case WindowsVirtualDesktopVersion::Win10_21H1:
-        case WindowsVirtualDesktopVersion::Win10_21H2:
-        case WindowsVirtualDesktopVersion::Win10_22H2:
-            return GetDesktopInfoWin10(pDesktopUnk.Get(), info);
-            
-        case WindowsVirtualDesktopVersion::Win11_21H2:
-        case WindowsVirtualDesktopVersion::Win11_22H2:
-            return GetDesktopInfoWin11_21H2(pDesktopUnk.Get(), info);
-            
-        case WindowsVirtualDesktopVersion::Win11_23H2:
-        case WindowsVirtualDesktopVersion::Win11_24H2:
-            return GetDesktopInfoWin11_23H2(pDesktopUnk.Get(), info);
-            
-        case WindowsVirtualDesktopVersion::Win11_24H2_Preview:
-        default:
-            return GetDesktopInfoWin11_24H2_Preview(pDesktopUnk.Get(), info);
+    if (m_catalog.IsSameBlob(m_idsBlob.data(), dataSize)) {
+        return !m_catalog.IsEmpty();  // Unchanged - the common case on every poll
     }
-}
 
-std::wstring VirtualDesktop::HStringToWString(HSTRING hstr) {
-    if (!hstr) return L"";
-    
-    UINT32 len = 0;
-    const wchar_t* raw = WindowsGetStringRawBuffer(hstr, &len);
-    if (raw && len > 0) {
-        return std::wstring(raw, len);
+    // Keep the previous snapshot to diff against (only on actual changes)
+    DesktopCatalog previous = m_catalog;
+    BlobStatus status = BlobStatus::Ok;
+    if (m_catalog.UpdateFromBlob(m_idsBlob.data(), dataSize, &status)) {
+        LOG_DEBUG("Desktop catalog rebuilt: %zu desktops (generation %llu)",
+                  m_catalog.GetCount(), m_catalog.GetGeneration());
+        QueueTopologyDiff(previous);
+    } else if (status != BlobStatus::Ok) {
+        LOG_DEBUG("VirtualDesktopIDs rejected (%s, %lu bytes)", BlobStatusToString(status), dataSize);
+        return false;
     }
-    return L"";
+    return !m_catalog.IsEmpty();
 }
 
-int VirtualDesktop::GetDesktopIndexFromPolling(const GUID& desktopId) {
-    // In polling mode, we can't get the actual index without internal COM interfaces
-    // Use registry to enumerate virtual desktop GUIDs and find the index
-    
-    HKEY hKey = nullptr;
-    LONG result = RegOpenKeyExW(
-        HKEY_CURRENT_USER,
-        L"SOFTWARE\\Microsoft\\Windows\\CurrentVersion\\Explorer\\VirtualDesktops",
-        0,
-        KEY_READ,
-        &hKey
-    );
-    
-    if (result != ERROR_SUCCESS) {
-        return 1;  // Default to desktop 1
+GUID VirtualDesktop::FindCurrentDesktopByElimination() {
+    if (!m_pPublicVirtualDesktopManager) {
+        return {};
     }
-    
-    // Read VirtualDesktopIDs value (binary blob of GUIDs)
-    DWORD dataSize = 0;
-    result = RegQueryValueExW(hKey, L"VirtualDesktopIDs", nullptr, nullptr, nullptr, &dataSize);
-    
-    if (result != ERROR_SUCCESS || dataSize == 0 || dataSize % sizeof(GUID) != 0) {
-        RegCloseKey(hKey);
-        return 1;
+    if (!m_windowTrackingActive) {
+        return FindCurrentDesktopByWindowScan();
     }
-    
-    std::vector<BYTE> data(dataSize);
-    result = RegQueryValueExW(hKey, L"VirtualDesktopIDs", nullptr, nullptr, data.data(), &dataSize);
-    RegCloseKey(hKey);
-    
-    if (result != ERROR_SUCCESS) {
-        return 1;
+
+    std::vector<DesktopGuid> desktops;
+    if (RefreshCatalog()) {
+        desktops = m_catalog.GetIds();
+    } else {
+        // No desktop list from the registry: only a direct hit can decide
+        m_windowIndex.CollectDesktops(desktops);
     }
-    
-    // Search for matching GUID
-    int numDesktops = static_cast<int>(dataSize / sizeof(GUID));
-    const GUID* guids = reinterpret_cast<const GUID*>(data.data());
-    
-    for (int i = 0; i < numDesktops; i++) {
-        if (IsEqualGUID(guids[i], desktopId)) {
-            return i + 1;  // 1-based index
-        }
+    if (desktops.empty()) {
+        return {};
     }
-    
-    return 1;  // Not found, default to 1
-}
 
-std::wstring VirtualDesktop::GetDesktopNameFromRegistry(const GUID& desktopId) {
-    // Convert GUID to string for registry key path
-    wchar_t guidStr[64] = {};
-    StringFromGUID2(desktopId, guidStr, 64);
-    
-    // Build registry path: HKCU\SOFTWARE\Microsoft\Windows\CurrentVersion\Explorer\VirtualDesktops\Desktops\{GUID}
-    std::wstring keyPath = L"SOFTWARE\\Microsoft\\Windows\\CurrentVersion\\Explorer\\VirtualDesktops\\Desktops\\";
-    keyPath += guidStr;
-    
-    HKEY hKey = nullptr;
-    LONG result = RegOpenKeyExW(HKEY_CURRENT_USER, keyPath.c_str(), 0, KEY_READ, &hKey);
-    
-    if (result == ERROR_SUCCESS) {
-        // Read "Name" value
-        wchar_t nameBuffer[256] = {};
-        DWORD nameSize = sizeof(nameBuffer);
-        DWORD type = 0;
-        
-        result = RegQueryValueExW(hKey, L"Name", nullptr, &type, reinterpret_cast<LPBYTE>(nameBuffer), &nameSize);
-        RegCloseKey(hKey);
-        
-        if (result == ERROR_SUCCESS && type == REG_SZ && nameSize > 2) {
-            return std::wstring(nameBuffer);
+    // Probe a few indexed windows per desktop instead of walking every
+    // top-level window. Fix-ups are applied after the walk because the
+    // index can't change while it's being iterated.
+    std::vector<WindowDesktopIndex::WindowKey> gone;
+    std::vector<std::pair<WindowDesktopIndex::WindowKey, DesktopGuid>> reassigned;
+    IVirtualDesktopManager* pMgr = m_pPublicVirtualDesktopManager.Get();
+
+    auto probe = [&](WindowDesktopIndex::WindowKey key, const DesktopGuid& desktop) {
+        HWND hwnd = reinterpret_cast<HWND>(key);
+        if (!IsWindow(hwnd)) {
+            gone.push_back(key);
+            return WindowProbeResult::Failed;
         }
-    }
-    
-    // No custom name set - return "Desktop N" as fallback
-    int index = GetDesktopIndexFromPolling(desktopId);
-    return L"Desktop " + std::to_wstring(index);
-}
 
-bool VirtualDesktop::GetCurrentDesktopIdFromRegistry(GUID& desktopId) {
-    // Read CurrentVirtualDesktop from registry - this is the most reliable method
-    HKEY hKey = nullptr;
-    LONG result = RegOpenKeyExW(
-        HKEY_CURRENT_USER,
-        L"SOFTWARE\\Microsoft\\Windows\\CurrentVersion\\Explorer\\VirtualDesktops",
-        0,
-        KEY_READ,
-        &hKey
-    );
-    
-    if (result != ERROR_SUCCESS) {
-        return false;
-    }
-    
-    DWORD dataSize = sizeof(GUID);
-    DWORD type = 0;
-    result = RegQueryValueExW(hKey, L"CurrentVirtualDesktop", nullptr, &type, 
-                              reinterpret_cast<LPBYTE>(&desktopId), &dataSize);
-    RegCloseKey(hKey);
-    
-    return (result == ERROR_SUCCESS && type == REG_BINARY && dataSize == sizeof(GUID));
-}
+        const auto* entry = m_windowIndex.Find(key);
+        if (entry && entry->stale) {
+            // Window was cloaked/uncloaked since indexed - confirm its desktop
+            GUID actual = {};
+            if (FAILED(pMgr->GetWindowDesktopId(hwnd, &actual))) {
+                return WindowProbeResult::Failed;
+            }
+            DesktopGuid actualId = DesktopGuid::FromGUID(actual);
+            reassigned.emplace_back(key, actualId);
+            if (actualId != desktop) {
+                return WindowProbeResult::Failed;
+            }
+        }
 
-std::vector<GUID> VirtualDesktop::GetAllDesktopIdsFromRegistry() {
-    std::vector<GUID> result;
-    
-    HKEY hKey = nullptr;
-    LONG status = RegOpenKeyExW(
-        HKEY_CURRENT_USER,
-        L"SOFTWARE\\Microsoft\\Windows\\CurrentVersion\\Explorer\\VirtualDesktops",
-        0,
-        KEY_READ,
-        &hKey
-    );
-    
-    if (status != ERROR_SUCCESS) {
-        return result;
-    }
-    
-    DWORD dataSize = 0;
-    status = RegQueryValueExW(hKey, L"VirtualDesktopIDs", nullptr, nullptr, nullptr, &dataSize);
-    
-    if (status != ERROR_SUCCESS || dataSize == 0 || dataSize % sizeof(GUID) != 0) {
-        RegCloseKey(hKey);
-        return result;
+        BOOL onCurrent = FALSE;
+        if (FAILED(pMgr->IsWindowOnCurrentVirtualDesktop(hwnd, &onCurrent))) {
+            return WindowProbeResult::Failed;
+        }
+        return onCurrent ? WindowProbeResult::OnCurrent : WindowProbeResult::NotOnCurrent;
+    };
+
+    WindowEliminationStats stats;
+    DesktopGuid found = m_windowIndex.FindCurrentDesktop(desktops, probe, 3, &stats);
+
+    ULONGLONG now = GetTickCount64();
+    for (auto key : gone) {
+        m_windowIndex.Remove(key);
     }
-    
-    std::vector<BYTE> data(dataSize);
-    status = RegQueryValueExW(hKey, L"VirtualDesktopIDs", nullptr, nullptr, data.data(), &dataSize);
-    RegCloseKey(hKey);
-    
-    if (status != ERROR_SUCCESS) {
-        return result;
+    for (const auto& fix : reassigned) {
+        if (fix.second.IsNull()) {
+            m_windowIndex.Remove(fix.first);  // Now pinned to all desktops
+        } else {
+            const auto* entry = m_windowIndex.Find(fix.first);
+            m_windowIndex.Assign(fix.first, fix.second, now, entry ? entry->traits : 0);
+        }
     }
-    
-    int count = static_cast<int>(dataSize / sizeof(GUID));
-    const GUID* guids = reinterpret_cast<const GUID*>(data.data());
-    result.assign(guids, guids + count);
-    return result;
+    m_sentinels.Prune(m_windowIndex);
+
+    LOG_DEBUG("FindCurrentDesktopByElimination: %s, %u probes over %zu desktops, %u candidates",
+              stats.directHit ? "direct match" : "elimination", stats.probes, desktops.size(),
+              stats.candidatesLeft);
+    return found.IsNull() ? GUID{} : found.ToGUID();
 }
 
-GUID VirtualDesktop::FindCurrentDesktopByElimination() {
-    if (!m_pPublicVirtualDesktopManager) {
-        return {};
-    }
-    
+GUID VirtualDesktop::FindCurrentDesktopByWindowScan() {
     std::vector<GUID> allDesktops = GetAllDesktopIdsFromRegistry();
     if (allDesktops.empty()) {
         return {};
@@ -1099,6 +871,25 @@ void VirtualDesktop::UpdateTrackedForegroundWindow(const GUID& desktopId) {
     }
     
     // Foreground window not usable — find any window on this desktop
+    if (m_windowTrackingActive) {
+        HWND found = nullptr;
+        if (const auto* windows = m_windowIndex.GetWindows(DesktopGuid::FromGUID(desktopId))) {
+            for (auto key : *windows) {
+                HWND hw = reinterpret_cast<HWND>(key);
+                if (IsWindow(hw) && IsWindowVisible(hw)) {
+                    found = hw;
+                    break;
+                }
+            }
+        }
+        if (!found && m_lastKnownForegroundHwnd && IsWindow(m_lastKnownForegroundHwnd)) {
+            LOG_DEBUG("Empty desktop: keeping previously tracked window %p", m_lastKnownForegroundHwnd);
+        } else {
+            m_lastKnownForegroundHwnd = found;
+        }
+        return;
+    }
+
     struct EnumData {
         IVirtualDesktopManager* pMgr;
         GUID targetId;
@@ -1129,6 +920,9 @@ void VirtualDesktop::UpdateTrackedForegroundWindow(const GUID& desktopId) {
 
 void VirtualDesktop::SetDesktopSwitchCallback(DesktopSwitchCallback callback) {
     m_switchCallback = std::move(callback);
+
+    // Index windows by desktop before picking the tracked window below
+    StartWindowTracking();
     
     // Initialize current desktop ID from registry (most reliable)
     if (!GetCurrentDesktopIdFromRegistry(m_lastKnownDesktopId)) {
@@ -1155,6 +949,9 @@ void VirtualDesktop::SetDesktopSwitchCallback(DesktopSwitchCallback callback) {
 
 void VirtualDesktop::ClearDesktopSwitchCallback() {
     m_switchCallback = nullptr;
+    StopWindowTracking();
+    m_topologyCallback = nullptr;
+    m_pendingTopologyEvents.clear();
     
     if (m_desktopSwitchHook) {
         UnhookWinEvent(m_desktopSwitchHook);
@@ -1162,6 +959,261 @@ void VirtualDesktop::ClearDesktopSwitchCallback() {
     }
 }
 
+void VirtualDesktop::StartWindowTracking() {
+    if (m_windowTrackingActive || !m_pPublicVirtualDesktopManager) {
+        return;
+    }
+
+    // Out-of-context WinEvent hooks are delivered through our message loop;
+    // unlike low-level hooks they add no latency to other applications' input.
+    // Three narrow ranges so high-volume events (location/name changes) in
+    // between are never delivered to us.
+    const DWORD flags = WINEVENT_OUTOFCONTEXT | WINEVENT_SKIPOWNPROCESS;
+    m_windowEventHooks[0] = SetWinEventHook(EVENT_OBJECT_CREATE, EVENT_OBJECT_HIDE,
+                                            nullptr, WindowEventProc, 0, 0, flags);
+    m_windowEventHooks[1] = SetWinEventHook(EVENT_OBJECT_CLOAKED, EVENT_OBJECT_UNCLOAKED,
+                                            nullptr, WindowEventProc, 0, 0, flags);
+    m_windowEventHooks[2] = SetWinEventHook(EVENT_SYSTEM_FOREGROUND, EVENT_SYSTEM_FOREGROUND,
+                                            nullptr, WindowEventProc, 0, 0, flags);
+
+    if (!m_windowEventHooks[0] || !m_windowEventHooks[1] || !m_windowEventHooks[2]) {
+        LOG_WARN("Window tracking hooks unavailable, using EnumWindows scans");
+        StopWindowTracking();
+        return;
+    }
+
+    SeedWindowIndex();
+    m_windowTrackingActive = true;
+    LOG_INFO("Window tracking started: %zu windows indexed", m_windowIndex.GetWindowCount());
+}
+
+void VirtualDesktop::StopWindowTracking() {
+    for (auto& hook : m_windowEventHooks) {
+        if (hook) {
+            UnhookWinEvent(hook);
+            hook = nullptr;
+        }
+    }
+    m_windowTrackingActive = false;
+    m_windowIndex.Clear();
+    m_sentinels.Clear();
+}
+
+void VirtualDesktop::SeedWindowIndex() {
+    // One full walk at startup; events keep the index current afterwards
+    m_windowIndex.Clear();
+    EnumWindows([](HWND hw, LPARAM lp) -> BOOL {
+        auto* self = reinterpret_cast<VirtualDesktop*>(lp);
+        DWORD pid = 0;
+        GetWindowThreadProcessId(hw, &pid);
+        if (pid != GetCurrentProcessId() && IsWindowVisible(hw)) {
+            self->IndexWindowDesktop(hw);
+        }
+        return TRUE;
+    }, reinterpret_cast<LPARAM>(this));
+}
+
+bool VirtualDesktop::IndexWindowDesktop(HWND hwnd) {
+    auto key = reinterpret_cast<WindowDesktopIndex::WindowKey>(hwnd);
+    GUID desktopId = {};
+    if (FAILED(m_pPublicVirtualDesktopManager->GetWindowDesktopId(hwnd, &desktopId))) {
+        return false;
+    }
+    if (IsEqualGUID(desktopId, GUID{})) {
+        m_windowIndex.Remove(key);  // Pinned / shown on all desktops
+        return false;
+    }
+
+    // Traits only affect sentinel ranking: tool windows and owned dialogs
+    // come and go more often than main windows
+    uint32_t traits = 0;
+    if (GetWindowLongPtrW(hwnd, GWL_EXSTYLE) & WS_EX_TOOLWINDOW) {
+        traits |= WINDOW_TRAIT_TOOL;
+    }
+    if (GetWindow(hwnd, GW_OWNER)) {
+        traits |= WINDOW_TRAIT_OWNED;
+    }
+    m_windowIndex.Assign(key, DesktopGuid::FromGUID(desktopId), GetTickCount64(), traits);
+    return true;
+}
+
+WindowProbeResult VirtualDesktop::ProbeSentinels(const GUID& desktopId, HWND* answered) {
+    // Copy: removing dead windows below invalidates the sentinel set
+    std::vector<WindowDesktopIndex::WindowKey> sentinels =
+        m_sentinels.Get(DesktopGuid::FromGUID(desktopId), m_windowIndex);
+
+    WindowProbeResult result = WindowProbeResult::Failed;
+    size_t calls = 0;
+    for (auto key : sentinels) {
+        HWND hwnd = reinterpret_cast<HWND>(key);
+        if (!IsWindow(hwnd)) {
+            m_windowIndex.Remove(key);
+            continue;
+        }
+        if (calls++ == SENTINEL_PROBES) {
+            break;
+        }
+        BOOL onCurrent = FALSE;
+        if (SUCCEEDED(m_pPublicVirtualDesktopManager->IsWindowOnCurrentVirtualDesktop(hwnd, &onCurrent))) {
+            result = onCurrent ? WindowProbeResult::OnCurrent : WindowProbeResult::NotOnCurrent;
+            if (answered) {
+                *answered = hwnd;
+            }
+            break;
+        }
+    }
+    return result;
+}
+
+void VirtualDesktop::VerifyWithSentinels(GUID& currentDesktopId) {
+    // The registry CurrentVirtualDesktop value is not always updated when
+    // switching to a desktop with no windows. Ask the best sentinel of the
+    // last-known desktop whether it is still visible; only if the registry
+    // claims a move that the sentinel can't confirm, ask the candidate's.
+    bool registryMoved = !IsEqualGUID(currentDesktopId, m_lastKnownDesktopId)
+                         && !IsEqualGUID(currentDesktopId, GUID{});
+    bool needsElimination = false;
+
+    HWND sentinel = nullptr;
+    WindowProbeResult lastKnown = ProbeSentinels(m_lastKnownDesktopId, &sentinel);
+    if (lastKnown == WindowProbeResult::OnCurrent) {
+        if (registryMoved) {
+            // Still on the last-known desktop unless the sentinel itself was
+            // moved since it was indexed - confirm before overriding
+            GUID sentinelDesktopId = {};
+            if (SUCCEEDED(m_pPublicVirtualDesktopManager->GetWindowDesktopId(sentinel, &sentinelDesktopId))
+                && !IsEqualGUID(sentinelDesktopId, GUID{})) {
+                currentDesktopId = sentinelDesktopId;
+                if (!IsEqualGUID(sentinelDesktopId, m_lastKnownDesktopId)) {
+                    IndexWindowDesktop(sentinel);
+                }
+            }
+        } else {
+            currentDesktopId = m_lastKnownDesktopId;
+        }
+    } else if (lastKnown == WindowProbeResult::NotOnCurrent) {
+        if (!registryMoved) {
+            // Registry says same desktop (or nothing), but we left it
+            LOG_INFO("Registry stale: sentinel not on current VD, running elimination");
+            needsElimination = true;
+        } else if (ProbeSentinels(currentDesktopId) == WindowProbeResult::NotOnCurrent) {
+            LOG_INFO("Registry says different desktop but its sentinel disagrees, verifying");
+            needsElimination = true;
+        }
+        // Candidate has no sentinels (empty desktop): the move is confirmed
+        // by the last-known sentinel, trust the registry
+    } else {
+        // Last-known desktop has no usable sentinel (e.g. it is empty)
+        if (IsEqualGUID(currentDesktopId, GUID{})) {
+            needsElimination = true;
+        } else if (registryMoved) {
+            if (ProbeSentinels(currentDesktopId) == WindowProbeResult::NotOnCurrent) {
+                LOG_INFO("Registry says different desktop but its sentinel disagrees, verifying");
+                needsElimination = true;
+            }
+        } else {
+            // Registry unchanged, which is exactly what a stale value after
+            // leaving an empty desktop looks like. Ask the tracked window
+            // (kept from an earlier desktop while this one is empty): if it
+            // is visible we are on its desktop, otherwise, or without one,
+            // eliminate rather than trust the registry unchecked.
+            BOOL trackedIsOnCurrent = FALSE;
+            GUID trackedDesktopId = {};
+            if (m_lastKnownForegroundHwnd && IsWindow(m_lastKnownForegroundHwnd)
+                && SUCCEEDED(m_pPublicVirtualDesktopManager->IsWindowOnCurrentVirtualDesktop(
+                       m_lastKnownForegroundHwnd, &trackedIsOnCurrent))
+                && trackedIsOnCurrent
+                && SUCCEEDED(m_pPublicVirtualDesktopManager->GetWindowDesktopId(
+                       m_lastKnownForegroundHwnd, &trackedDesktopId))
+                && !IsEqualGUID(trackedDesktopId, GUID{})) {
+                currentDesktopId = trackedDesktopId;
+            } else {
+                needsElimination = true;
+            }
+        }
+    }
+
+    if (needsElimination) {
+        GUID eliminatedId = FindCurrentDesktopByElimination();
+        if (!IsEqualGUID(eliminatedId, GUID{})) {
+            currentDesktopId = eliminatedId;
+        }
+    }
+}
+
+// Task View / desktop switcher host windows (Windows 10, Windows 11)
+static bool IsTaskViewWindow(HWND hwnd) {
+    wchar_t className[64] = {};
+    if (!GetClassNameW(hwnd, className, ARRAYSIZE(className))) {
+        return false;
+    }
+    return wcscmp(className, L"MultitaskingViewFrame") == 0
+           || wcscmp(className, L"XamlExplorerHostIslandWindow") == 0;
+}
+
+void VirtualDesktop::OnWindowEvent(DWORD event, HWND hwnd) {
+    auto key = reinterpret_cast<WindowDesktopIndex::WindowKey>(hwnd);
+
+    switch (event) {
+        case EVENT_OBJECT_DESTROY:
+        case EVENT_OBJECT_HIDE:
+            m_windowIndex.Remove(key);
+            return;
+
+        case EVENT_OBJECT_CLOAKED:
+            // Cloaking happens on every desktop switch; the window usually
+            // keeps its desktop, so just flag it for re-validation on use
+            m_windowIndex.MarkStale(key);
+            return;
+
+        case EVENT_SYSTEM_FOREGROUND: {
+            // Task View can switch desktops with the mouse or a touchpad
+            // swipe, which the keyboard watch never sees. The switch lands
+            // when Task View hands the foreground back, so burst on both
+            // opening and closing it.
+            bool taskView = IsTaskViewWindow(hwnd);
+            if (taskView || m_taskViewForeground) {
+                OnSwitchGesture();
+                if (m_pollBurstMsg && m_pollNotifyWnd) {
+                    PostMessageW(m_pollNotifyWnd, m_pollBurstMsg, 0, 0);
+                }
+            } else {
+                OnUserActivity();
+            }
+            m_taskViewForeground = taskView;
+            break;
+        }
+
+        default:
+            break;
+    }
+
+    // CREATE / SHOW / UNCLOAKED / FOREGROUND: only visible top-level windows
+    if (!IsWindow(hwnd) || GetAncestor(hwnd, GA_ROOT) != hwnd || !IsWindowVisible(hwnd)) {
+        return;
+    }
+
+    if (event == EVENT_OBJECT_UNCLOAKED && m_windowIndex.Contains(key)) {
+        m_windowIndex.MarkStale(key);
+        return;
+    }
+    if (event == EVENT_OBJECT_CREATE && m_windowIndex.Contains(key)) {
+        return;
+    }
+    IndexWindowDesktop(hwnd);
+}
+
+void CALLBACK VirtualDesktop::WindowEventProc(HWINEVENTHOOK, DWORD event, HWND hwnd,
+                                              LONG idObject, LONG idChild, DWORD, DWORD) {
+    if (!hwnd || idObject != OBJID_WINDOW || idChild != CHILDID_SELF) {
+        return;
+    }
+    VirtualDesktop& vd = VirtualDesktop::Instance();
+    if (vd.m_windowTrackingActive) {
+        vd.OnWindowEvent(event, hwnd);
+    }
+}
+
 void CALLBACK VirtualDesktop::WinEventProc(HWINEVENTHOOK, DWORD event, HWND, LONG, LONG, DWORD, DWORD) {
     if (event == 0x0020) {
         VirtualDesktop& vd = VirtualDesktop::Instance();
@@ -1180,14 +1232,23 @@ void VirtualDesktop::CheckDesktopChange() {
         TryReinitialize();
     }
     
-    // Periodic log to confirm polling is active (every ~30 seconds)
+    // Periodic log to confirm detection is active (every 200 detection passes)
     static int pollCount = 0;
     pollCount++;
-    if (pollCount % 200 == 1) {  // Every 200 * 150ms = 30s
+    if (pollCount % 200 == 1) {
         wchar_t guidStr[64] = {};
         StringFromGUID2(m_lastKnownDesktopId, guidStr, 64);
         LOG_INFO("Desktop poll #%d - last known: index=%d guid=%ws tracked=%p", 
                  pollCount, m_lastKnownDesktopIndex, guidStr, m_lastKnownForegroundHwnd);
+        if (m_changeWatcher) {
+            const auto& stats = m_changeWatcher->GetStats();
+            LOG_INFO("Desktop watch: event-driven=%d wakeups=%llu (%.0f/h) notifications=%llu "
+                     "safety-net=%llu fallback=%llu burst=%llu mode=%s",
+                     m_changeWatcher->IsEventDriven() ? 1 : 0, stats.wakeups,
+                     m_changeWatcher->WakeupsPerHour(GetTickCount64()), stats.notifications,
+                     stats.safetyNetChecks, stats.fallbackChecks, stats.burstChecks,
+                     PollModeToString(m_pollScheduler.GetMode(GetTickCount64())));
+        }
     }
     
     GUID currentDesktopId = {};
@@ -1207,7 +1268,10 @@ void VirtualDesktop::CheckDesktopChange() {
         
         if (hWnd) {
             HRESULT hr = m_pPublicVirtualDesktopManager->GetWindowDesktopId(hWnd, &currentDesktopId);
-            if (FAILED(hr) || IsEqualGUID(currentDesktopId, GUID{})) {
+            if ((FAILED(hr) || IsEqualGUID(currentDesktopId, GUID{})) && m_windowTrackingActive) {
+                // Window might be on all desktops - probe the window index
+                currentDesktopId = FindCurrentDesktopByElimination();
+            } else if (FAILED(hr) || IsEqualGUID(currentDesktopId, GUID{})) {
                 // Window might be on all desktops - enumerate to find one
                 struct EnumData {
                     IVirtualDesktopManager* pMgr;
@@ -1240,10 +1304,15 @@ void VirtualDesktop::CheckDesktopChange() {
     
     // Method 3: Verify registry via IsWindowOnCurrentVirtualDesktop
     // The registry CurrentVirtualDesktop value is not always updated when switching
-    // to a desktop with no windows. Cross-check using a tracked window from a
-    // previous desktop: if that window's visibility status contradicts the registry,
-    // the registry is stale and we must identify the real desktop via elimination.
-    if (m_pPublicVirtualDesktopManager && m_lastKnownForegroundHwnd && IsWindow(m_lastKnownForegroundHwnd)) {
+    // to a desktop with no windows. With window tracking, cross-check against the
+    // per-desktop sentinels (one or two calls). Otherwise fall back to the single
+    // tracked window from a previous desktop: if its visibility status contradicts
+    // the registry, the registry is stale and we identify the real desktop via
+    // elimination.
+    if (m_pPublicVirtualDesktopManager && m_windowTrackingActive
+        && !IsEqualGUID(m_lastKnownDesktopId, GUID{})) {
+        VerifyWithSentinels(currentDesktopId);
+    } else if (m_pPublicVirtualDesktopManager && m_lastKnownForegroundHwnd && IsWindow(m_lastKnownForegroundHwnd)) {
         BOOL trackedIsOnCurrent = TRUE;
         bool trackedCheckOK = SUCCEEDED(m_pPublicVirtualDesktopManager->IsWindowOnCurrentVirtualDesktop(
             m_lastKnownForegroundHwnd, &trackedIsOnCurrent));
@@ -1306,25 +1375,176 @@ void VirtualDesktop::CheckDesktopChange() {
         
         // Calculate actual desktop index by enumerating desktops
         m_lastKnownDesktopIndex = GetDesktopIndexFromPolling(currentDesktopId);
-        m_lastKnownDesktopName = GetDesktopNameFromRegistry(currentDesktopId);
+        m_lastKnownDesktopName = GetDesktopNameFromRegistry(currentDesktopId, m_lastKnownDesktopIndex);
+        m_lastKnownNameVersion = ResolveDesktopName(currentDesktopId).version;
         
         // Update the tracked window for the new desktop
         UpdateTrackedForegroundWindow(currentDesktopId);
         
         LOG_INFO("Desktop change detected! old=%ws new=%ws index=%d tracked=%p", 
                  oldGuid, newGuid, m_lastKnownDesktopIndex, m_lastKnownForegroundHwnd);
+        m_pollScheduler.OnSwitchDetected(GetTickCount64());
         OnDesktopSwitched();
     } else {
         // Same desktop — check if the name was changed (e.g. user renamed it)
-        std::wstring currentName = GetDesktopNameFromRegistry(currentDesktopId);
-        if (currentName != m_lastKnownDesktopName) {
-            m_lastKnownDesktopName = currentName;
-            LOG_INFO("Desktop name change detected: %ws", currentName.c_str());
-            OnDesktopSwitched();
+        // or the desktop moved (which changes the "Desktop N" fallback name).
+        // Both are integer compares; the name is only rebuilt on a change.
+        uint32_t nameVersion = ResolveDesktopName(currentDesktopId).version;
+        int index = GetDesktopIndexFromPolling(currentDesktopId);
+        if (nameVersion != m_lastKnownNameVersion || index != m_lastKnownDesktopIndex) {
+            bool indexChanged = index != m_lastKnownDesktopIndex;
+            m_lastKnownNameVersion = nameVersion;
+            m_lastKnownDesktopIndex = index;
+            std::wstring currentName = GetDesktopNameFromRegistry(currentDesktopId, index);
+            if (currentName != m_lastKnownDesktopName || indexChanged) {
+                m_lastKnownDesktopName = currentName;
+                LOG_INFO("Desktop name change detected: index=%d name=%ws", index, currentName.c_str());
+                OnDesktopSwitched();
+            }
         }
     }
 }
 
+void VirtualDesktop::StartChangeWatch(HWND notifyWnd, UINT notifyMsg, UINT burstMsg) {
+    StopChangeWatch();
+    m_pollNotifyWnd = notifyWnd;
+    m_pollBurstMsg = burstMsg;
+
+    m_registryWatch = std::make_unique<RegistryChangeWatch>(
+        HKEY_CURRENT_USER, VIRTUAL_DESKTOPS_KEY, notifyWnd, notifyMsg);
+    m_changeWatcher = std::make_unique<DesktopChangeWatcher>(*m_registryWatch);
+    m_changeWatcher->SetScheduler(&m_pollScheduler);
+    m_changeWatcher->Start(GetTickCount64());
+
+    if (m_changeWatcher->IsEventDriven()) {
+        LOG_INFO("Desktop change watch armed (registry notifications + safety-net poll)");
+    } else {
+        LOG_WARN("Desktop change watch unavailable, falling back to fixed-rate polling");
+    }
+}
+
+void VirtualDesktop::StopChangeWatch() {
+    if (m_changeWatcher) {
+        const auto& stats = m_changeWatcher->GetStats();
+        LOG_INFO("Desktop change watch stopped: wakeups=%llu (%.0f/h) checks=%llu notifications=%llu",
+                 stats.wakeups, m_changeWatcher->WakeupsPerHour(GetTickCount64()),
+                 stats.checks, stats.notifications);
+        m_changeWatcher->Stop();
+        m_changeWatcher.reset();
+    }
+    if (m_registryWatch) {
+        m_registryWatch->Close();
+        m_registryWatch.reset();
+    }
+}
+
+void VirtualDesktop::OnRegistryChangeNotify() {
+    if (m_changeWatcher) {
+        m_changeWatcher->OnNotify(GetTickCount64());
+    }
+}
+
+UINT VirtualDesktop::PollDesktopChange() {
+    if (!m_changeWatcher) {
+        // No watch started - behave like the legacy fixed-rate poll
+        m_nameCache.InvalidateAll();
+        CheckDesktopChange();
+        DispatchTopologyEvents();
+        return m_pollScheduler.GetPeriodMs(GetTickCount64());
+    }
+
+    ULONGLONG now = GetTickCount64();
+    DesktopWakeReason reason = m_changeWatcher->Poll(now);
+    if (reason != DesktopWakeReason::None) {
+        // Names only change through registry writes: re-read them after a
+        // notification, or on every pass while notifications are unavailable
+        if (reason != DesktopWakeReason::SafetyNet && reason != DesktopWakeReason::Burst) {
+            m_nameCache.InvalidateAll();
+        }
+        CheckDesktopChange();
+
+        // After a registry write, pick up renames of desktops other than the
+        // current one too (one read per desktop; notifications are rare)
+        if (reason == DesktopWakeReason::Notification || reason == DesktopWakeReason::Recheck) {
+            RefreshAllNames();
+        }
+        DispatchTopologyEvents();
+    }
+    return m_changeWatcher->NextWakeDelayMs(GetTickCount64());
+}
+
+UINT VirtualDesktop::GetNextPollDelayMs() const {
+    ULONGLONG now = GetTickCount64();
+    if (!m_changeWatcher) {
+        return m_pollScheduler.GetPeriodMs(now);
+    }
+    return m_changeWatcher->NextWakeDelayMs(now);
+}
+
+void VirtualDesktop::SetPollSchedule(const PollScheduleConfig& config) {
+    m_pollScheduler.SetConfig(config);
+    const auto& applied = m_pollScheduler.GetConfig();
+    LOG_INFO("Desktop poll schedule: idle=%ums active=%ums burst=%ums for %ums, idle after %ums",
+             applied.idlePeriodMs, applied.activePeriodMs, applied.burstPeriodMs,
+             applied.burstDurationMs, applied.idleAfterMs);
+}
+
+void VirtualDesktop::OnUserActivity() {
+    m_pollScheduler.OnActivity(GetTickCount64());
+}
+
+void VirtualDesktop::OnSwitchGesture() {
+    m_pollScheduler.OnBurstTrigger(GetTickCount64());
+}
+
+void VirtualDesktop::SetDesktopTopologyCallback(DesktopTopologyCallback callback) {
+    m_topologyCallback = std::move(callback);
+}
+
+void VirtualDesktop::OnTopologyChanged() {
+    // COM notification (create / destroy / move / rename): re-read the
+    // catalog and names now rather than waiting for the next poll
+    m_nameCache.InvalidateAll();
+    RefreshCatalog();
+    RefreshAllNames();
+    DispatchTopologyEvents();
+}
+
+void VirtualDesktop::QueueTopologyDiff(const DesktopCatalog& previous) {
+    if (previous.IsEmpty()) {
+        return;  // First snapshot - nothing to diff against
+    }
+    DiffDesktopTopology(previous, m_catalog, m_pendingTopologyEvents);
+}
+
+void VirtualDesktop::RefreshAllNames() {
+    if (!RefreshCatalog()) {
+        return;
+    }
+    for (const auto& id : m_catalog.GetIds()) {
+        ResolveDesktopName(id.ToGUID());
+    }
+}
+
+void VirtualDesktop::DispatchTopologyEvents() {
+    if (m_pendingTopologyEvents.empty()) {
+        return;
+    }
+
+    // Swap out first so a callback that queries VirtualDesktop can't
+    // invalidate the list we're iterating
+    std::vector<DesktopTopologyEvent> events;
+    events.swap(m_pendingTopologyEvents);
+
+    for (const auto& ev : events) {
+        LOG_INFO("Desktop %s: index %d -> %d, name=%ws",
+                 DesktopTopologyChangeToString(ev.change), ev.oldIndex, ev.newIndex, ev.name.c_str());
+    }
+    if (m_topologyCallback) {
+        m_topologyCallback(events);
+    }
+}
+
 void VirtualDesktop::OnDesktopSwitched() {
     if (!m_switchCallback) {
         return;
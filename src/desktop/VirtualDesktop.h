@@ -1,7 +1,17 @@
 #pragma once
 
 #include "VirtualDesktopInterop.h"
+#include "ComDesktopBackend.h"
+#include "DesktopCatalog.h"
+#include "DesktopChangeWatcher.h"
+#include "DesktopNameCache.h"
+#include "PollScheduler.h"
+#include "DesktopSentinels.h"
+#include "DesktopTopology.h"
+#include "WindowDesktopIndex.h"
+#include "RegistryChangeWatch.h"
 #include <functional>
+#include <memory>
 #include <string>
 #include <vector>
 #include <wrl/client.h>
@@ -14,6 +24,10 @@ using Microsoft::WRL::ComPtr;
 // Callback for desktop switch events
 using DesktopSwitchCallback = std::function<void(int desktopIndex, const std::wstring& desktopName)>;
 
+// Callback for desktop create / destroy / move / rename events, called once
+// per refresh with every event that refresh produced
+using DesktopTopologyCallback = std::function<void(const std::vector<DesktopTopologyEvent>& events)>;
+
 // Desktop information
 struct DesktopInfo {
     GUID id = {};
@@ -44,16 +58,45 @@ public:
     int GetDesktopCount();
     bool GetDesktopByIndex(int index, DesktopInfo& info);
 
+    // Last detected state, from the catalog and name cache (no COM call);
+    // used to predict hotkey switches
+    int GetLastKnownDesktopIndex() const { return m_lastKnownDesktopIndex; }
+    int GetKnownDesktopCount() const { return static_cast<int>(m_catalog.GetCount()); }
+    bool GetKnownDesktop(int index, DesktopInfo& info);
+
     // Notification registration
     void SetDesktopSwitchCallback(DesktopSwitchCallback callback);
     void ClearDesktopSwitchCallback();
+    void SetDesktopTopologyCallback(DesktopTopologyCallback callback);
     
     // Manual polling (called by App timer)
     void CheckDesktopChange();
 
+    // Event-driven detection: watch the VirtualDesktops registry subtree and
+    // post notifyMsg to notifyWnd when it changes. Falls back to fixed-rate
+    // polling if the key cannot be watched. burstMsg (optional) is posted when
+    // a switch gesture is seen from a window event, so the poll timer can be
+    // rescheduled.
+    void StartChangeWatch(HWND notifyWnd, UINT notifyMsg, UINT burstMsg = 0);
+    void StopChangeWatch();
+    void OnRegistryChangeNotify();  // notifyMsg handler
+
+    // Run a detection pass if one is due; returns ms until the next wakeup
+    UINT PollDesktopChange();
+    UINT GetNextPollDelayMs() const;
+
+    // Adaptive poll period: slow when idle, a short fast burst after a
+    // desktop-switch gesture (reschedule the poll timer after either call)
+    void SetPollSchedule(const PollScheduleConfig& config);
+    void OnUserActivity();
+    void OnSwitchGesture();
+
     // Move a window to the current virtual desktop (so it becomes visible)
     bool MoveWindowToCurrentDesktop(HWND hwnd);
 
+    // Name cache counters (registry reads vs. cache hits)
+    const DesktopNameCacheStats& GetNameCacheStats() const { return m_nameCache.GetStats(); }
+
     // Expose version for debugging
     WindowsVirtualDesktopVersion GetWindowsVersion() const { return m_windowsVersion; }
 
@@ -66,28 +109,39 @@ private:
     bool AcquireVirtualDesktopInterfaces();
     void ReleaseInterfaces();
 
-    // Version-specific helpers
-    bool GetCurrentDesktopWin10(DesktopInfo& info);
-    bool GetCurrentDesktopWin11_21H2(DesktopInfo& info);
-    bool GetCurrentDesktopWin11_23H2(DesktopInfo& info);
-    bool GetCurrentDesktopWin11_24H2_Preview(DesktopInfo& info);
-
-    bool GetDesktopInfoWin10(IUnknown* pDesktop, DesktopInfo& info);
-    bool GetDesktopInfoWin11_21H2(IUnknown* pDesktop, DesktopInfo& info);
-    bool GetDesktopInfoWin11_23H2(IUnknown* pDesktop, DesktopInfo& info);
-    bool GetDesktopInfoWin11_24H2_Preview(IUnknown* pDesktop, DesktopInfo& info);
-
     int GetDesktopIndexByGUID(const GUID& guid);
     int GetDesktopIndexFromPolling(const GUID& desktopId);
-    std::wstring GetDesktopNameFromRegistry(const GUID& desktopId);
+    // Custom name, else "Desktop N"; index < 1 looks N up in the catalog
+    std::wstring GetDesktopNameFromRegistry(const GUID& desktopId, int index = 0);
+    const DesktopNameEntry& ResolveDesktopName(const GUID& desktopId);
     bool GetCurrentDesktopIdFromRegistry(GUID& desktopId);
     std::vector<GUID> GetAllDesktopIdsFromRegistry();
+    bool RefreshCatalog();
+    HKEY GetVirtualDesktopsKey();
+    void CloseVirtualDesktopsKey();
     GUID FindCurrentDesktopByElimination();
+    GUID FindCurrentDesktopByWindowScan();  // Fallback when window tracking is unavailable
     void UpdateTrackedForegroundWindow(const GUID& desktopId);
-    std::wstring HStringToWString(HSTRING hstr);
+
+    // Window -> desktop index, fed by WinEvent hooks
+    void StartWindowTracking();
+    void StopWindowTracking();
+    void SeedWindowIndex();
+    void OnWindowEvent(DWORD event, HWND hwnd);
+    bool IndexWindowDesktop(HWND hwnd);
+    WindowProbeResult ProbeSentinels(const GUID& desktopId, HWND* answered = nullptr);
+    void VerifyWithSentinels(GUID& currentDesktopId);
+    static void CALLBACK WindowEventProc(HWINEVENTHOOK, DWORD, HWND, LONG, LONG, DWORD, DWORD);
 
     // Internal notification handler
     void OnDesktopSwitched();
+
+    // Topology tracking: catalog diffs and name changes queue events, which are
+    // dispatched once the current detection pass has finished
+    void OnTopologyChanged();
+    void QueueTopologyDiff(const DesktopCatalog& previous);
+    void RefreshAllNames();
+    void DispatchTopologyEvents();
     
     // Allow notification classes to trigger switch callback
     friend class VirtualDesktopNotification_Win10;
@@ -107,6 +161,7 @@ private:
     // COM interfaces - using IUnknown because specific type varies by Windows version
     ComPtr<IServiceProvider> m_pServiceProvider;
     ComPtr<IUnknown> m_pVirtualDesktopManagerInternal;
+    std::unique_ptr<IDesktopBackend> m_backend;  // ABI-specific wrapper, chosen once
     ComPtr<IVirtualDesktopNotificationService> m_pNotificationService;
     
     // Public API interface (always available)
@@ -120,14 +175,44 @@ private:
     GUID m_lastKnownDesktopId = {};
     int m_lastKnownDesktopIndex = 0;
     std::wstring m_lastKnownDesktopName;
+    uint32_t m_lastKnownNameVersion = 0;       // DesktopNameEntry::version of the above
     HWND m_lastKnownForegroundHwnd = nullptr;  // Window tracked on last-known desktop
+
+    // Desktop list from VirtualDesktopIDs (rebuilt only when the blob changes)
+    DesktopCatalog m_catalog;
+    std::vector<BYTE> m_idsBlob;             // Reused read buffer
+    HKEY m_hVirtualDesktopsKey = nullptr;    // Kept open across polls
+
+    // Desktop names keyed by GUID (invalidated by the registry change watch)
+    DesktopNameCache m_nameCache;
+    std::vector<BYTE> m_nameBuffer;          // Reused read buffer
+    uint64_t m_nameCacheGeneration = 0;      // Catalog generation last pruned against
+
+    // Top-level windows by desktop (replaces EnumWindows scans)
+    WindowDesktopIndex m_windowIndex;
+    DesktopSentinels m_sentinels;            // Best few windows per desktop for cross-checks
+    static constexpr size_t SENTINEL_PROBES = 2;
+    HWINEVENTHOOK m_windowEventHooks[3] = {};
+    bool m_windowTrackingActive = false;
+
+    // Poll period policy (outlives m_changeWatcher, which points at it)
+    PollScheduler m_pollScheduler;
+    HWND m_pollNotifyWnd = nullptr;
+    UINT m_pollBurstMsg = 0;
+    bool m_taskViewForeground = false;
+
+    // Registry change watch (drives PollDesktopChange)
+    std::unique_ptr<RegistryChangeWatch> m_registryWatch;
+    std::unique_ptr<DesktopChangeWatcher> m_changeWatcher;
     
     // WinEvent hook for desktop switch detection
     HWINEVENTHOOK m_desktopSwitchHook = nullptr;
     static void CALLBACK WinEventProc(HWINEVENTHOOK, DWORD, HWND, LONG, LONG, DWORD, DWORD);
     
-    // User callback
+    // User callbacks
     DesktopSwitchCallback m_switchCallback;
+    DesktopTopologyCallback m_topologyCallback;
+    std::vector<DesktopTopologyEvent> m_pendingTopologyEvents;
 };
 
 // =============================================================================
@@ -144,10 +229,10 @@ public:
     ULONG STDMETHODCALLTYPE Release() override;
 
     // IVirtualDesktopNotification_Win10
-    HRESULT STDMETHODCALLTYPE VirtualDesktopCreated(IVirtualDesktop_Win10*) override { return S_OK; }
+    HRESULT STDMETHODCALLTYPE VirtualDesktopCreated(IVirtualDesktop_Win10*) override { VirtualDesktop::Instance().OnTopologyChanged(); return S_OK; }
     HRESULT STDMETHODCALLTYPE VirtualDesktopDestroyBegin(IVirtualDesktop_Win10*, IVirtualDesktop_Win10*) override { return S_OK; }
     HRESULT STDMETHODCALLTYPE VirtualDesktopDestroyFailed(IVirtualDesktop_Win10*, IVirtualDesktop_Win10*) override { return S_OK; }
-    HRESULT STDMETHODCALLTYPE VirtualDesktopDestroyed(IVirtualDesktop_Win10*, IVirtualDesktop_Win10*) override { return S_OK; }
+    HRESULT STDMETHODCALLTYPE VirtualDesktopDestroyed(IVirtualDesktop_Win10*, IVirtualDesktop_Win10*) override { VirtualDesktop::Instance().OnTopologyChanged(); return S_OK; }
     HRESULT STDMETHODCALLTYPE ViewVirtualDesktopChanged(IApplicationView*) override { return S_OK; }
     HRESULT STDMETHODCALLTYPE CurrentVirtualDesktopChanged(IVirtualDesktop_Win10*, IVirtualDesktop_Win10* pNew) override;
 
@@ -165,13 +250,13 @@ public:
     ULONG STDMETHODCALLTYPE Release() override;
 
     // IVirtualDesktopNotification_Win11_21H2
-    HRESULT STDMETHODCALLTYPE VirtualDesktopCreated(IObjectArray*, IVirtualDesktop_Win11_21H2*) override { return S_OK; }
+    HRESULT STDMETHODCALLTYPE VirtualDesktopCreated(IObjectArray*, IVirtualDesktop_Win11_21H2*) override { VirtualDesktop::Instance().OnTopologyChanged(); return S_OK; }
     HRESULT STDMETHODCALLTYPE VirtualDesktopDestroyBegin(IObjectArray*, IVirtualDesktop_Win11_21H2*, IVirtualDesktop_Win11_21H2*) override { return S_OK; }
     HRESULT STDMETHODCALLTYPE VirtualDesktopDestroyFailed(IObjectArray*, IVirtualDesktop_Win11_21H2*, IVirtualDesktop_Win11_21H2*) override { return S_OK; }
-    HRESULT STDMETHODCALLTYPE VirtualDesktopDestroyed(IObjectArray*, IVirtualDesktop_Win11_21H2*, IVirtualDesktop_Win11_21H2*) override { return S_OK; }
+    HRESULT STDMETHODCALLTYPE VirtualDesktopDestroyed(IObjectArray*, IVirtualDesktop_Win11_21H2*, IVirtualDesktop_Win11_21H2*) override { VirtualDesktop::Instance().OnTopologyChanged(); return S_OK; }
     HRESULT STDMETHODCALLTYPE VirtualDesktopIsPerMonitorChanged(BOOL) override { return S_OK; }
-    HRESULT STDMETHODCALLTYPE VirtualDesktopMoved(IObjectArray*, IVirtualDesktop_Win11_21H2*, int, int) override { return S_OK; }
-    HRESULT STDMETHODCALLTYPE VirtualDesktopNameChanged(IVirtualDesktop_Win11_21H2*, HSTRING) override { return S_OK; }
+    HRESULT STDMETHODCALLTYPE VirtualDesktopMoved(IObjectArray*, IVirtualDesktop_Win11_21H2*, int, int) override { VirtualDesktop::Instance().OnTopologyChanged(); return S_OK; }
+    HRESULT STDMETHODCALLTYPE VirtualDesktopNameChanged(IVirtualDesktop_Win11_21H2*, HSTRING) override { VirtualDesktop::Instance().OnTopologyChanged(); return S_OK; }
     HRESULT STDMETHODCALLTYPE ViewVirtualDesktopChanged(IApplicationView*) override { return S_OK; }
     HRESULT STDMETHODCALLTYPE CurrentVirtualDesktopChanged(IObjectArray*, IVirtualDesktop_Win11_21H2*, IVirtualDesktop_Win11_21H2* pNew) override;
     HRESULT STDMETHODCALLTYPE VirtualDesktopWallpaperChanged(IVirtualDesktop_Win11_21H2*, HSTRING) override { return S_OK; }
@@ -190,13 +275,13 @@ public:
     ULONG STDMETHODCALLTYPE Release() override;
 
     // IVirtualDesktopNotification_Win11_23H2
-    HRESULT STDMETHODCALLTYPE VirtualDesktopCreated(IObjectArray*, IVirtualDesktop_Win11_23H2*) override { return S_OK; }
+    HRESULT STDMETHODCALLTYPE VirtualDesktopCreated(IObjectArray*, IVirtualDesktop_Win11_23H2*) override { VirtualDesktop::Instance().OnTopologyChanged(); return S_OK; }
     HRESULT STDMETHODCALLTYPE VirtualDesktopDestroyBegin(IObjectArray*, IVirtualDesktop_Win11_23H2*, IVirtualDesktop_Win11_23H2*) override { return S_OK; }
     HRESULT STDMETHODCALLTYPE VirtualDesktopDestroyFailed(IObjectArray*, IVirtualDesktop_Win11_23H2*, IVirtualDesktop_Win11_23H2*) override { return S_OK; }
-    HRESULT STDMETHODCALLTYPE VirtualDesktopDestroyed(IObjectArray*, IVirtualDesktop_Win11_23H2*, IVirtualDesktop_Win11_23H2*) override { return S_OK; }
+    HRESULT STDMETHODCALLTYPE VirtualDesktopDestroyed(IObjectArray*, IVirtualDesktop_Win11_23H2*, IVirtualDesktop_Win11_23H2*) override { VirtualDesktop::Instance().OnTopologyChanged(); return S_OK; }
     HRESULT STDMETHODCALLTYPE VirtualDesktopIsPerMonitorChanged(BOOL) override { return S_OK; }
-    HRESULT STDMETHODCALLTYPE VirtualDesktopMoved(IObjectArray*, IVirtualDesktop_Win11_23H2*, int, int) override { return S_OK; }
-    HRESULT STDMETHODCALLTYPE VirtualDesktopNameChanged(IVirtualDesktop_Win11_23H2*, HSTRING) override { return S_OK; }
+    HRESULT STDMETHODCALLTYPE VirtualDesktopMoved(IObjectArray*, IVirtualDesktop_Win11_23H2*, int, int) override { VirtualDesktop::Instance().OnTopologyChanged(); return S_OK; }
+    HRESULT STDMETHODCALLTYPE VirtualDesktopNameChanged(IVirtualDesktop_Win11_23H2*, HSTRING) override { VirtualDesktop::Instance().OnTopologyChanged(); return S_OK; }
     HRESULT STDMETHODCALLTYPE ViewVirtualDesktopChanged(IApplicationView*) override { return S_OK; }
     HRESULT STDMETHODCALLTYPE CurrentVirtualDesktopChanged(IObjectArray*, IVirtualDesktop_Win11_23H2*, IVirtualDesktop_Win11_23H2* pNew) override;
     HRESULT STDMETHODCALLTYPE VirtualDesktopWallpaperChanged(IVirtualDesktop_Win11_23H2*, HSTRING) override { return S_OK; }
@@ -217,13 +302,13 @@ public:
     ULONG STDMETHODCALLTYPE Release() override;
 
     // IVirtualDesktopNotification_Win11_24H2_Preview
-    HRESULT STDMETHODCALLTYPE VirtualDesktopCreated(IObjectArray*, IVirtualDesktop_Win11_24H2_Preview*) override { return S_OK; }
+    HRESULT STDMETHODCALLTYPE VirtualDesktopCreated(IObjectArray*, IVirtualDesktop_Win11_24H2_Preview*) override { VirtualDesktop::Instance().OnTopologyChanged(); return S_OK; }
     HRESULT STDMETHODCALLTYPE VirtualDesktopDestroyBegin(IObjectArray*, IVirtualDesktop_Win11_24H2_Preview*, IVirtualDesktop_Win11_24H2_Preview*) override { return S_OK; }
     HRESULT STDMETHODCALLTYPE VirtualDesktopDestroyFailed(IObjectArray*, IVirtualDesktop_Win11_24H2_Preview*, IVirtualDesktop_Win11_24H2_Preview*) override { return S_OK; }
-    HRESULT STDMETHODCALLTYPE VirtualDesktopDestroyed(IObjectArray*, IVirtualDesktop_Win11_24H2_Preview*, IVirtualDesktop_Win11_24H2_Preview*) override { return S_OK; }
+    HRESULT STDMETHODCALLTYPE VirtualDesktopDestroyed(IObjectArray*, IVirtualDesktop_Win11_24H2_Preview*, IVirtualDesktop_Win11_24H2_Preview*) override { VirtualDesktop::Instance().OnTopologyChanged(); return S_OK; }
     HRESULT STDMETHODCALLTYPE VirtualDesktopIsPerMonitorChanged(BOOL) override { return S_OK; }
-    HRESULT STDMETHODCALLTYPE VirtualDesktopMoved(IObjectArray*, IVirtualDesktop_Win11_24H2_Preview*, int, int) override { return S_OK; }
-    HRESULT STDMETHODCALLTYPE VirtualDesktopNameChanged(IVirtualDesktop_Win11_24H2_Preview*, HSTRING) override { return S_OK; }
+    HRESULT STDMETHODCALLTYPE VirtualDesktopMoved(IObjectArray*, IVirtualDesktop_Win11_24H2_Preview*, int, int) override { VirtualDesktop::Instance().OnTopologyChanged(); return S_OK; }
+    HRESULT STDMETHODCALLTYPE VirtualDesktopNameChanged(IVirtualDesktop_Win11_24H2_Preview*, HSTRING) override { VirtualDesktop::Instance().OnTopologyChanged(); return S_OK; }
     HRESULT STDMETHODCALLTYPE ViewVirtualDesktopChanged(IApplicationView*) override { return S_OK; }
     HRESULT STDMETHODCALLTYPE CurrentVirtualDesktopChanged(IObjectArray*, IVirtualDesktop_Win11_24H2_Preview*, IVirtualDesktop_Win11_24H2_Preview* pNew) override;
     HRESULT STDMETHODCALLTYPE VirtualDesktopWallpaperChanged(IVirtualDesktop_Win11_24H2_Preview*, HSTRING) override { return S_OK; }
@@ -0,0 +1,114 @@
+#include "WindowDesktopIndex.h"
+
+namespace VirtualOverlay {
+
+bool WindowDesktopIndex::Assign(WindowKey window, const DesktopGuid& desktop, uint64_t nowMs, uint32_t traits) {
+    auto it = m_windows.find(window);
+    if (it != m_windows.end()) {
+        WindowEntry& entry = it->second;
+        entry.stale = false;
+        if (entry.desktop == desktop) {
+            if (entry.traits == traits) {
+                return false;
+            }
+            entry.traits = traits;
+            m_byDesktop[desktop].revision = m_nextRevision++;
+            return true;
+        }
+        Unlink(window, entry);
+        auto& group = m_byDesktop[desktop];
+        entry.desktop = desktop;
+        entry.traits = traits;
+        entry.slot = static_cast<uint32_t>(group.windows.size());
+        group.windows.push_back(window);
+        group.revision = m_nextRevision++;
+        return true;
+    }
+
+    auto& group = m_byDesktop[desktop];
+    WindowEntry entry;
+    entry.desktop = desktop;
+    entry.traits = traits;
+    entry.slot = static_cast<uint32_t>(group.windows.size());
+    entry.firstSeenMs = nowMs;
+    group.windows.push_back(window);
+    group.revision = m_nextRevision++;
+    m_windows.emplace(window, entry);
+    return true;
+}
+
+bool WindowDesktopIndex::Remove(WindowKey window) {
+    auto it = m_windows.find(window);
+    if (it == m_windows.end()) {
+        return false;
+    }
+    Unlink(window, it->second);
+    m_windows.erase(it);
+    return true;
+}
+
+void WindowDesktopIndex::Unlink(WindowKey window, const WindowEntry& entry) {
+    auto groupIt = m_byDesktop.find(entry.desktop);
+    if (groupIt == m_byDesktop.end()) {
+        return;
+    }
+
+    // Swap-remove: move the last window into the vacated slot
+    auto& list = groupIt->second.windows;
+    uint32_t slot = entry.slot;
+    if (slot < list.size() && list[slot] == window) {
+        WindowKey moved = list.back();
+        list[slot] = moved;
+        list.pop_back();
+        if (moved != window) {
+            m_windows[moved].slot = slot;
+        }
+    }
+    groupIt->second.revision = m_nextRevision++;
+
+    if (list.empty()) {
+        m_byDesktop.erase(groupIt);
+    }
+}
+
+void WindowDesktopIndex::MarkStale(WindowKey window) {
+    auto it = m_windows.find(window);
+    if (it != m_windows.end()) {
+        it->second.stale = true;
+    }
+}
+
+const WindowDesktopIndex::WindowEntry* WindowDesktopIndex::Find(WindowKey window) const {
+    auto it = m_windows.find(window);
+    return it != m_windows.end() ? &it->second : nullptr;
+}
+
+size_t WindowDesktopIndex::GetWindowCount(const DesktopGuid& desktop) const {
+    const auto* windows = GetWindows(desktop);
+    return windows ? windows->size() : 0;
+}
+
+const std::vector<WindowDesktopIndex::WindowKey>* WindowDesktopIndex::GetWindows(const DesktopGuid& desktop) const {
+    auto it = m_byDesktop.find(desktop);
+    return it != m_byDesktop.end() ? &it->second.windows : nullptr;
+}
+
+uint64_t WindowDesktopIndex::GetRevision(const DesktopGuid& desktop) const {
+    auto it = m_byDesktop.find(desktop);
+    return it != m_byDesktop.end() ? it->second.revision : 0;
+}
+
+void WindowDesktopIndex::CollectDesktops(std::vector<DesktopGuid>& out) const {
+    out.clear();
+    out.reserve(m_byDesktop.size());
+    for (const auto& pair : m_byDesktop) {
+        out.push_back(pair.first);
+    }
+}
+
+void WindowDesktopIndex::Clear() {
+    m_windows.clear();
+    m_byDesktop.clear();
+}
+
+}  // namespace VirtualOverlay
@@ -0,0 +1,150 @@
+#pragma once
+
+// Resident map of top-level windows to the virtual desktop they live on.
+//
+// Kept current incrementally (VirtualDesktop feeds it from WinEvent hooks),
+// so finding "which desktop is current" no longer needs an EnumWindows walk
+// with two COM calls per window: FindCurrentDesktop() probes at most a few
+// windows per desktop. Per-desktop window lists use swap-remove, so every
+// update is O(1).
+//
+// Windows are identified by an opaque integer key (an HWND on Windows).
+// Platform-independent (no <windows.h>).
+
+#include "DesktopGuid.h"
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace VirtualOverlay {
+
+enum class WindowProbeResult {
+    OnCurrent,     // Window is on the current desktop
+    NotOnCurrent,  // Window is on another desktop
+    Failed         // Window gone / desktop assignment outdated - try another
+};
+
+struct WindowEliminationStats {
+    uint32_t probes = 0;          // Probe calls made
+    uint32_t desktopsWithWindows = 0;
+    uint32_t candidatesLeft = 0;  // Desktops not ruled out (0 or 1 means decided)
+    bool directHit = false;
+};
+
+// Window traits (bit flags) used to rank windows, see DesktopSentinels
+constexpr uint32_t WINDOW_TRAIT_TOOL = 0x1;    // Tool window (palettes, tray popups)
+constexpr uint32_t WINDOW_TRAIT_OWNED = 0x2;   // Owned by another window (dialogs)
+
+class WindowDesktopIndex {
+public:
+    using WindowKey = uintptr_t;
+
+    struct WindowEntry {
+        DesktopGuid desktop;
+        uint32_t slot = 0;          // Position in the per-desktop list
+        uint32_t traits = 0;        // WINDOW_TRAIT_* flags
+        uint64_t firstSeenMs = 0;
+        bool stale = false;         // Desktop assignment may be outdated
+    };
+
+    // Insert or move a window. Returns true if the window was new or changed
+    // desktop or traits.
+    bool Assign(WindowKey window, const DesktopGuid& desktop, uint64_t nowMs, uint32_t traits = 0);
+
+    // Forget a window (destroyed, hidden or pinned). Returns true if it was indexed.
+    bool Remove(WindowKey window);
+
+    // Flag a window whose desktop may have changed (e.g. it was cloaked/uncloaked)
+    void MarkStale(WindowKey window);
+
+    const WindowEntry* Find(WindowKey window) const;
+    bool Contains(WindowKey window) const { return Find(window) != nullptr; }
+
+    size_t GetWindowCount() const { return m_windows.size(); }
+    size_t GetWindowCount(const DesktopGuid& desktop) const;
+
+    // Windows on a desktop (unordered), or nullptr if none
+    const std::vector<WindowKey>* GetWindows(const DesktopGuid& desktop) const;
+
+    // Bumped whenever a desktop's window set or a member's traits change
+    uint64_t GetRevision(const DesktopGuid& desktop) const;
+
+    // Desktops that currently have at least one indexed window
+    void CollectDesktops(std::vector<DesktopGuid>& out) const;
+
+    void Clear();
+
+    // Identify the current desktop out of `desktops` by probing windows.
+    // For each desktop, up to maxProbesPerDesktop of its windows are probed:
+    //   OnCurrent    -> that desktop is current (stop)
+    //   NotOnCurrent -> desktop eliminated
+    //   Failed       -> try the desktop's next window
+    // If nothing hits directly and exactly one desktop is left (typically the
+    // empty one we switched to), it is returned. Otherwise returns a null GUID.
+    template <typename Probe>
+    DesktopGuid FindCurrentDesktop(const std::vector<DesktopGuid>& desktops, Probe&& probe,
+                                   size_t maxProbesPerDesktop = 3,
+                                   WindowEliminationStats* stats = nullptr) const;
+
+private:
+    struct GuidHasher {
+        size_t operator()(const DesktopGuid& id) const { return static_cast<size_t>(id.Hash()); }
+    };
+
+    void Unlink(WindowKey window, const WindowEntry& entry);
+
+    struct DesktopWindows {
+        std::vector<WindowKey> windows;
+        uint64_t revision = 0;
+    };
+
+    std::unordered_map<WindowKey, WindowEntry> m_windows;
+    std::unordered_map<DesktopGuid, DesktopWindows, GuidHasher> m_byDesktop;
+    uint64_t m_nextRevision = 1;
+};
+
+template <typename Probe>
+DesktopGuid WindowDesktopIndex::FindCurrentDesktop(const std::vector<DesktopGuid>& desktops, Probe&& probe,
+                                                   size_t maxProbesPerDesktop,
+                                                   WindowEliminationStats* stats) const {
+    WindowEliminationStats local;
+    WindowEliminationStats& s = stats ? *stats : local;
+    s = WindowEliminationStats();
+
+    const DesktopGuid* lastCandidate = nullptr;
+    for (const DesktopGuid& desktop : desktops) {
+        const std::vector<WindowKey>* windows = GetWindows(desktop);
+        bool eliminated = false;
+
+        if (windows && !windows->empty()) {
+            s.desktopsWithWindows++;
+            size_t probesLeft = maxProbesPerDesktop;
+            for (size_t i = 0; i < windows->size() && probesLeft > 0; i++, probesLeft--) {
+                s.probes++;
+                WindowProbeResult result = probe((*windows)[i], desktop);
+                if (result == WindowProbeResult::OnCurrent) {
+                    s.directHit = true;
+                    s.candidatesLeft = 1;
+                    return desktop;
+                }
+                if (result == WindowProbeResult::NotOnCurrent) {
+                    eliminated = true;
+                    break;
+                }
+            }
+        }
+
+        if (!eliminated) {
+            s.candidatesLeft++;
+            lastCandidate = &desktop;
+        }
+    }
+
+    if (s.candidatesLeft == 1 && lastCandidate) {
+        return *lastCandidate;
+    }
+    return DesktopGuid();
+}
+
+}  // namespace VirtualOverlay
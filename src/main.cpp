@@ -180,6 +180,8 @@ LRESULT CALLBACK MainWndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
                 VirtualOverlay::App::Instance().OnZoomTimer();
             } else if (wParam == VirtualOverlay::TIMER_DESKTOP_POLL) {
                 VirtualOverlay::App::Instance().OnDesktopPollTimer();
+            } else if (wParam == VirtualOverlay::TIMER_SWITCH_SPECULATION) {
+                VirtualOverlay::App::Instance().OnSwitchSpeculationTimer();
             }
             return 0;
 
@@ -233,6 +235,18 @@ LRESULT CALLBACK MainWndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
             VirtualOverlay::App::Instance().OnModifierUp();
             return 0;
 
+        case VirtualOverlay::WM_USER_DESKTOP_REGISTRY_CHANGED:
+            VirtualOverlay::App::Instance().OnDesktopRegistryChanged();
+            return 0;
+
+        case VirtualOverlay::WM_USER_DESKTOP_POLL_BURST:
+            VirtualOverlay::App::Instance().OnDesktopPollBurst();
+            return 0;
+
+        case WM_INPUT:
+            VirtualOverlay::App::Instance().OnRawInput(reinterpret_cast<HRAWINPUT>(lParam));
+            break;  // DefWindowProc must see WM_INPUT for cleanup
+
         case WM_HOTKEY:
             if (wParam == VirtualOverlay::HOTKEY_OVERLAY_TOGGLE) {
                 VirtualOverlay::App::Instance().OnToggleOverlay();
@@ -0,0 +1,116 @@
+#include "D2DRenderBackend.h"
+#include "../utils/Logger.h"
+
+namespace VirtualOverlay {
+
+namespace {
+
+D2D1_COLOR_F ToD2D(const RenderColor& color) {
+    return D2D1::ColorF(color.r, color.g, color.b, color.a);
+}
+
+D2D1_RECT_F ToD2D(const RenderRect& rect) {
+    return D2D1::RectF(rect.left, rect.top, rect.right, rect.bottom);
+}
+
+}  // namespace
+
+void D2DRenderBackend::Attach(ID2D1RenderTarget* target, IDWriteTextFormat* textFormat) {
+    if (m_target.Get() != target) {
+        m_brush.Reset();  // Brushes belong to their render target
+    }
+    m_target = target;
+    m_textFormat = textFormat;
+}
+
+void D2DRenderBackend::Reset() {
+    m_brush.Reset();
+    m_textFormat.Reset();
+    m_target.Reset();
+}
+
+bool D2DRenderBackend::BeginFrame(int width, int height) {
+    (void)width;
+    (void)height;  // The render target is already sized to the window
+    if (!m_target) {
+        return false;
+    }
+    m_target->BeginDraw();
+    m_target->SetTextAntialiasMode(D2D1_TEXT_ANTIALIAS_MODE_DEFAULT);
+    return true;
+}
+
+void D2DRenderBackend::Clear(const RenderColor& color) {
+    m_target->Clear(ToD2D(color));
+}
+
+void D2DRenderBackend::FillRoundedRect(const RenderRect& rect, float radius, const RenderColor& color) {
+    if (ID2D1SolidColorBrush* brush = Brush(color)) {
+        m_target->FillRoundedRectangle(D2D1::RoundedRect(ToD2D(rect), radius, radius), brush);
+    }
+}
+
+void D2DRenderBackend::StrokeRoundedRect(const RenderRect& rect, float radius, float strokeWidth,
+                                         const RenderColor& color) {
+    if (ID2D1SolidColorBrush* brush = Brush(color)) {
+        m_target->DrawRoundedRectangle(D2D1::RoundedRect(ToD2D(rect), radius, radius), brush, strokeWidth);
+    }
+}
+
+void D2DRenderBackend::FillText(const std::wstring& text, const RenderRect& layout, const RenderColor& color) {
+    ID2D1SolidColorBrush* brush = Brush(color);
+    if (!brush || !m_textFormat) {
+        return;
+    }
+    m_target->DrawText(
+        text.c_str(),
+        static_cast<UINT32>(text.length()),
+        m_textFormat.Get(),
+        ToD2D(layout),
+        brush
+    );
+}
+
+void D2DRenderBackend::DrawMask(const uint8_t* coverage, int maskWidth, int maskHeight, int x, int y,
+                                const RenderColor& color) {
+    ID2D1SolidColorBrush* brush = Brush(color);
+    if (!brush || maskWidth <= 0 || maskHeight <= 0) {
+        return;
+    }
+
+    ComPtr<ID2D1Bitmap> mask;
+    D2D1_BITMAP_PROPERTIES props = D2D1::BitmapProperties(
+        D2D1::PixelFormat(DXGI_FORMAT_A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED));
+    HRESULT hr = m_target->CreateBitmap(
+        D2D1::SizeU(static_cast<UINT32>(maskWidth), static_cast<UINT32>(maskHeight)),
+        coverage, static_cast<UINT32>(maskWidth), props, mask.GetAddressOf());
+    if (FAILED(hr)) {
+        LOG_WARN("D2DRenderBackend: mask bitmap failed: 0x%08X", hr);
+        return;
+    }
+
+    // FillOpacityMask requires aliased primitives
+    D2D1_ANTIALIAS_MODE previous = m_target->GetAntialiasMode();
+    m_target->SetAntialiasMode(D2D1_ANTIALIAS_MODE_ALIASED);
+    D2D1_RECT_F dest = D2D1::RectF(static_cast<float>(x), static_cast<float>(y),
+                                   static_cast<float>(x + maskWidth), static_cast<float>(y + maskHeight));
+    m_target->FillOpacityMask(mask.Get(), brush, D2D1_OPACITY_MASK_CONTENT_TEXT_NATURAL, &dest, nullptr);
+    m_target->SetAntialiasMode(previous);
+}
+
+bool D2DRenderBackend::EndFrame(float windowOpacity) {
+    (void)windowOpacity;  // Applied with SetLayeredWindowAttributes by the window
+    m_lastResult = m_target->EndDraw();
+    return SUCCEEDED(m_lastResult);
+}
+
+ID2D1SolidColorBrush* D2DRenderBackend::Brush(const RenderColor& color) {
+    if (!m_brush) {
+        m_target->CreateSolidColorBrush(ToD2D(color), m_brush.GetAddressOf());
+    } else {
+        m_brush->SetColor(ToD2D(color));
+    }
+    return m_brush.Get();
+}
+
+}  // namespace VirtualOverlay
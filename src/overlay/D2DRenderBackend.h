@@ -0,0 +1,43 @@
+#pragma once
+
+#include "RenderBackend.h"
+#include <windows.h>
+#include <d2d1.h>
+#include <dwrite.h>
+#include <wrl/client.h>
+
+namespace VirtualOverlay {
+
+using Microsoft::WRL::ComPtr;
+
+// RenderBackend over a Direct2D render target (the notification window's
+// HwndRenderTarget). One solid brush is recolored per primitive.
+class D2DRenderBackend : public RenderBackend {
+public:
+    // Both must outlive the frames drawn through this backend
+    void Attach(ID2D1RenderTarget* target, IDWriteTextFormat* textFormat);
+    void Reset();
+
+    bool BeginFrame(int width, int height) override;
+    void Clear(const RenderColor& color) override;
+    void FillRoundedRect(const RenderRect& rect, float radius, const RenderColor& color) override;
+    void StrokeRoundedRect(const RenderRect& rect, float radius, float strokeWidth,
+                           const RenderColor& color) override;
+    void FillText(const std::wstring& text, const RenderRect& layout, const RenderColor& color) override;
+    void DrawMask(const uint8_t* coverage, int maskWidth, int maskHeight, int x, int y,
+                  const RenderColor& color) override;
+    bool EndFrame(float windowOpacity) override;
+
+    // EndFrame failed with D2DERR_RECREATE_TARGET
+    bool NeedsRecreate() const { return m_lastResult == D2DERR_RECREATE_TARGET; }
+
+private:
+    ID2D1SolidColorBrush* Brush(const RenderColor& color);
+
+    ComPtr<ID2D1RenderTarget> m_target;
+    ComPtr<IDWriteTextFormat> m_textFormat;
+    ComPtr<ID2D1SolidColorBrush> m_brush;
+    HRESULT m_lastResult = S_OK;
+};
+
+}  // namespace VirtualOverlay
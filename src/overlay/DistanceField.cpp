@@ -0,0 +1,235 @@
+#include "DistanceField.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iterator>
+
+namespace VirtualOverlay {
+
+namespace {
+
+constexpr double FAR_AWAY = 1e20;
+
+// Felzenszwalb & Huttenlocher: squared distance from each sample to the
+// nearest feature along one line, as the lower envelope of parabolas rooted
+// at f. v and z are scratch of n and n + 1 entries.
+void Transform1D(const double* f, double* d, int n, int* v, double* z) {
+    int k = 0;
+    v[0] = 0;
+    z[0] = -FAR_AWAY;
+    z[1] = FAR_AWAY;
+    for (int q = 1; q < n; q++) {
+        double s;
+        while (true) {
+            int p = v[k];
+            s = ((f[q] + static_cast<double>(q) * q) - (f[p] + static_cast<double>(p) * p)) / (2.0 * (q - p));
+            if (s > z[k] || k == 0) break;
+            k--;
+        }
+        k++;
+        v[k] = q;
+        z[k] = s;
+        z[k + 1] = FAR_AWAY;
+    }
+
+    k = 0;
+    for (int q = 0; q < n; q++) {
+        while (z[k + 1] < q) k++;
+        double offset = static_cast<double>(q - v[k]);
+        d[q] = offset * offset + f[v[k]];
+    }
+}
+
+// Squared distance from every pixel to the nearest pixel where feature is set
+void DistanceTransform(const std::vector<bool>& feature, int width, int height, std::vector<double>& result) {
+    int longest = std::max(width, height);
+    std::vector<double> f(longest), d(longest), z(longest + 1);
+    std::vector<int> v(longest);
+
+    result.resize(static_cast<size_t>(width) * height);
+    for (size_t i = 0; i < result.size(); i++) {
+        result[i] = feature[i] ? 0.0 : FAR_AWAY;
+    }
+
+    for (int x = 0; x < width; x++) {
+        for (int y = 0; y < height; y++) f[y] = result[static_cast<size_t>(y) * width + x];
+        Transform1D(f.data(), d.data(), height, v.data(), z.data());
+        for (int y = 0; y < height; y++) result[static_cast<size_t>(y) * width + x] = d[y];
+    }
+    for (int y = 0; y < height; y++) {
+        double* row = result.data() + static_cast<size_t>(y) * width;
+        std::copy(row, row + width, f.begin());
+        Transform1D(f.data(), row, width, v.data(), z.data());
+    }
+}
+
+void HashCombine(size_t& seed, size_t value) {
+    seed ^= value + 0x9E3779B97F4A7C15ull + (seed << 6) + (seed >> 2);
+}
+
+inline uint8_t ToByte(float coverage) {
+    return static_cast<uint8_t>(std::clamp(coverage, 0.0f, 1.0f) * 255.0f + 0.5f);
+}
+
+}  // namespace
+
+float DistanceField::At(int x, int y) const {
+    if (x < 0 || y < 0 || x >= width || y >= height) {
+        return static_cast<float>(MAX_DISTANCE);
+    }
+    return static_cast<float>(distance[static_cast<size_t>(y) * width + x]) / UNITS_PER_PIXEL;
+}
+
+float DistanceField::Sample(float x, float y) const {
+    float fx = std::floor(x);
+    float fy = std::floor(y);
+    int x0 = static_cast<int>(fx);
+    int y0 = static_cast<int>(fy);
+    float tx = x - fx;
+    float ty = y - fy;
+    float top = At(x0, y0) + (At(x0 + 1, y0) - At(x0, y0)) * tx;
+    float bottom = At(x0, y0 + 1) + (At(x0 + 1, y0 + 1) - At(x0, y0 + 1)) * tx;
+    return top + (bottom - top) * ty;
+}
+
+DistanceField BuildDistanceField(const uint8_t* coverage, int width, int height, int fontSize) {
+    DistanceField field;
+    field.fontSize = fontSize;
+    if (width <= 0 || height <= 0) {
+        return field;
+    }
+    field.width = width;
+    field.height = height;
+
+    size_t count = static_cast<size_t>(width) * height;
+    std::vector<bool> inside(count), outside(count);
+    for (size_t i = 0; i < count; i++) {
+        inside[i] = coverage[i] >= 128;
+        outside[i] = !inside[i];
+    }
+
+    std::vector<double> toInside, toOutside;
+    DistanceTransform(inside, width, height, toInside);
+    DistanceTransform(outside, width, height, toOutside);
+
+    // The edge runs half a pixel from the centers on either side of it
+    field.distance.resize(count);
+    const double limit = DistanceField::MAX_DISTANCE;
+    for (size_t i = 0; i < count; i++) {
+        double d;
+        if (coverage[i] > 0 && coverage[i] < 255) {
+            d = 0.5 - coverage[i] / 255.0;
+        } else if (inside[i]) {
+            d = -(std::sqrt(toOutside[i]) - 0.5);
+        } else {
+            d = std::sqrt(toInside[i]) - 0.5;
+        }
+        d = std::clamp(d, -limit, limit);
+        field.distance[i] = static_cast<int16_t>(std::lround(d * DistanceField::UNITS_PER_PIXEL));
+    }
+    return field;
+}
+
+void RenderDistanceField(const DistanceField& field, int width, int height, float scale,
+                         float outlineWidth, float glowRadius, uint8_t* fill, uint8_t* halo) {
+    if (width <= 0 || height <= 0 || scale <= 0.0f) {
+        return;
+    }
+    bool hasHalo = outlineWidth > 0.0f || glowRadius > 0.0f;
+
+    // Target pixel center -> field coordinates, label centered in both
+    float inverse = 1.0f / scale;
+    float originX = field.width * 0.5f - 0.5f - (width * 0.5f - 0.5f) * inverse;
+    float originY = field.height * 0.5f - 0.5f - (height * 0.5f - 0.5f) * inverse;
+
+    for (int y = 0; y < height; y++) {
+        float sy = originY + y * inverse;
+        uint8_t* fillRow = fill + static_cast<size_t>(y) * width;
+        uint8_t* haloRow = halo + static_cast<size_t>(y) * width;
+        for (int x = 0; x < width; x++) {
+            // Distance in target pixels; a one-pixel ramp around each threshold
+            float d = field.Sample(originX + x * inverse, sy) * scale;
+            fillRow[x] = ToByte(0.5f - d);
+            if (!hasHalo) {
+                haloRow[x] = 0;
+                continue;
+            }
+            float beyond = d - outlineWidth;
+            float coverage = 0.5f - beyond;
+            if (glowRadius > 0.0f && beyond > 0.0f) {
+                float glow = std::max(0.0f, 1.0f - beyond / glowRadius);
+                coverage = std::max(coverage, glow * glow);
+            }
+            haloRow[x] = ToByte(coverage);
+        }
+    }
+}
+
+bool DistanceFieldKey::operator==(const DistanceFieldKey& other) const {
+    return fontWeight == other.fontWeight && text == other.text && fontFamily == other.fontFamily;
+}
+
+size_t DistanceFieldKeyHash::operator()(const DistanceFieldKey& key) const {
+    size_t seed = std::hash<std::wstring>()(key.text);
+    HashCombine(seed, std::hash<std::wstring>()(key.fontFamily));
+    HashCombine(seed, static_cast<size_t>(key.fontWeight));
+    return seed;
+}
+
+DistanceFieldAtlas::DistanceFieldAtlas(size_t maxEntries)
+    : m_maxEntries(maxEntries) {
+}
+
+const DistanceField* DistanceFieldAtlas::Find(const DistanceFieldKey& key, int fontSize) {
+    auto found = m_index.find(key);
+    if (found == m_index.end()) {
+        m_stats.misses++;
+        return nullptr;
+    }
+
+    const DistanceField& field = found->second->second;
+    float scale = field.fontSize > 0 ? static_cast<float>(fontSize) / field.fontSize : 0.0f;
+    if (scale < MIN_SCALE || scale > MAX_SCALE) {
+        m_stats.misses++;
+        return nullptr;
+    }
+
+    m_stats.hits++;
+    m_entries.splice(m_entries.begin(), m_entries, found->second);
+    return &field;
+}
+
+const DistanceField* DistanceFieldAtlas::Insert(const DistanceFieldKey& key, DistanceField&& field) {
+    auto found = m_index.find(key);
+    if (found != m_index.end()) {
+        Erase(found->second);
+    }
+    if (m_maxEntries == 0) {
+        return nullptr;
+    }
+
+    while (m_entries.size() >= m_maxEntries) {
+        Erase(std::prev(m_entries.end()));
+        m_stats.evictions++;
+    }
+
+    m_stats.bytes += field.GetBytes();
+    m_stats.builds++;
+    m_entries.emplace_front(key, std::move(field));
+    m_index[key] = m_entries.begin();
+    return &m_entries.front().second;
+}
+
+void DistanceFieldAtlas::Clear() {
+    m_entries.clear();
+    m_index.clear();
+    m_stats.bytes = 0;
+}
+
+void DistanceFieldAtlas::Erase(EntryList::iterator it) {
+    m_stats.bytes -= it->second.GetBytes();
+    m_index.erase(it->first);
+    m_entries.erase(it);
+}
+
+}  // namespace VirtualOverlay
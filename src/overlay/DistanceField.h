@@ -0,0 +1,106 @@
+#pragma once
+
+// Signed distance fields for watermark labels.
+//
+// A label is shaped and rasterized by DirectWrite once; its coverage is then
+// turned into a signed distance field (exact Euclidean distance transform,
+// linear time). Any font size near the one it was built at, any outline
+// width and any glow are then a per-pixel threshold of the field, so
+// resizing, per-monitor DPI and animated scale need no reshaping.
+//
+// Distances are in source pixels, positive outside the glyphs and negative
+// inside; partially covered edge pixels take their distance from coverage so
+// a field rendered at scale 1 reproduces the original anti-aliasing.
+// Platform-independent (no <windows.h>).
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace VirtualOverlay {
+
+struct DistanceField {
+    static constexpr int UNITS_PER_PIXEL = 256;  // Fixed-point scale of distance
+    static constexpr int MAX_DISTANCE = 127;     // Pixels; farther is clamped
+
+    int width = 0;
+    int height = 0;
+    int fontSize = 0;               // Font size the label was rasterized at
+    std::vector<int16_t> distance;  // Row-major, 1/UNITS_PER_PIXEL px
+
+    float At(int x, int y) const;   // Pixels; MAX_DISTANCE outside the field
+    float Sample(float x, float y) const;  // Bilinear, pixel centers at integers
+    size_t GetBytes() const { return distance.size() * sizeof(int16_t); }
+};
+
+// Build a field from an 8-bit coverage mask (row-major, stride == width)
+DistanceField BuildDistanceField(const uint8_t* coverage, int width, int height, int fontSize);
+
+// Render the field centered in a width x height target, scaled by scale
+// (target font size / field font size). Writes the text coverage to fill and
+// the outline (outlineWidth px) plus glow (falling off over glowRadius px)
+// coverage to halo; both are width * height bytes.
+void RenderDistanceField(const DistanceField& field, int width, int height, float scale,
+                         float outlineWidth, float glowRadius, uint8_t* fill, uint8_t* halo);
+
+// Fields are shared by every size of the same text and font
+struct DistanceFieldKey {
+    std::wstring text;
+    std::wstring fontFamily;
+    int fontWeight = 0;
+
+    bool operator==(const DistanceFieldKey& other) const;
+    bool operator!=(const DistanceFieldKey& other) const { return !(*this == other); }
+};
+
+struct DistanceFieldKeyHash {
+    size_t operator()(const DistanceFieldKey& key) const;
+};
+
+struct DistanceFieldAtlasStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;       // Absent, or built at a size too far away
+    uint64_t builds = 0;
+    uint64_t evictions = 0;
+    size_t bytes = 0;
+};
+
+// Least-recently-used set of label fields
+class DistanceFieldAtlas {
+public:
+    static constexpr size_t DEFAULT_MAX_ENTRIES = 32;
+    // Scale range a field is reused for before the label is reshaped
+    static constexpr float MIN_SCALE = 0.5f;
+    static constexpr float MAX_SCALE = 2.0f;
+
+    explicit DistanceFieldAtlas(size_t maxEntries = DEFAULT_MAX_ENTRIES);
+
+    // Field usable for fontSize, or nullptr. The pointer is valid until the
+    // next Insert or Clear.
+    const DistanceField* Find(const DistanceFieldKey& key, int fontSize);
+
+    // Store a field (replacing any entry with the same key)
+    const DistanceField* Insert(const DistanceFieldKey& key, DistanceField&& field);
+
+    void Clear();
+
+    size_t GetCount() const { return m_entries.size(); }
+    const DistanceFieldAtlasStats& GetStats() const { return m_stats; }
+
+private:
+    using Entry = std::pair<DistanceFieldKey, DistanceField>;
+    using EntryList = std::list<Entry>;
+
+    void Erase(EntryList::iterator it);
+
+    size_t m_maxEntries;
+    EntryList m_entries;  // Most recently used first
+    std::unordered_map<DistanceFieldKey, EntryList::iterator, DistanceFieldKeyHash> m_index;
+    DistanceFieldAtlasStats m_stats;
+};
+
+}  // namespace VirtualOverlay
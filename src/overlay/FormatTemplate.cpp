@@ -0,0 +1,298 @@
+#include "FormatTemplate.h"
+
+namespace VirtualOverlay {
+
+namespace {
+
+constexpr size_t NO_SECTION = static_cast<size_t>(-1);
+
+}  // namespace
+
+void FormatTemplate::Compile(const std::wstring& format) {
+    m_source = format;
+    m_literals.clear();
+    m_ops.clear();
+    m_mergeFrom = 0;
+
+    size_t pos = 0;
+    ParseSequence(format, pos, 0, NO_SECTION);
+
+    bool hasSections = false;
+    for (const Op& op : m_ops) {
+        hasSections = hasSections || op.type == OpType::Section;
+    }
+    if (!hasSections) {
+        MakeTrailingNameConditional();
+    }
+}
+
+bool FormatTemplate::ParseSequence(const std::wstring& format, size_t& pos, int depth, size_t section) {
+    const size_t n = format.size();
+    while (pos < n) {
+        wchar_t c = format[pos];
+
+        if (c == L'{') {
+            if (pos + 1 < n && format[pos + 1] == L'{') {
+                AppendLiteral(L"{");
+                pos += 2;
+                continue;
+            }
+
+            if (pos + 1 < n && format[pos + 1] == L'?' && depth < MAX_SECTION_DEPTH) {
+                // An unterminated section runs to the end of the format
+                size_t index = m_ops.size();
+                Op op;
+                op.type = OpType::Section;
+                m_ops.push_back(op);
+                pos += 2;
+                ParseSequence(format, pos, depth + 1, index);
+                m_ops[index].end = static_cast<uint32_t>(m_ops.size());
+                m_mergeFrom = m_ops.size();
+                continue;
+            }
+
+            // Field token: runs to the next brace, which must close it
+            size_t close = pos + 1;
+            while (close < n && format[close] != L'{' && format[close] != L'}') {
+                close++;
+            }
+            if (close < n && format[close] == L'}') {
+                std::wstring_view token(format.data() + pos + 1, close - pos - 1);
+                Field field;
+                int width;
+                if (ParseField(token, field, width)) {
+                    Op op;
+                    op.type = OpType::Field;
+                    op.field = field;
+                    op.width = static_cast<uint8_t>(width);
+                    m_ops.push_back(op);
+                    if (section != NO_SECTION) {
+                        m_ops[section].required |= 1u << static_cast<uint32_t>(field);
+                    }
+                } else {
+                    // Unknown token: kept as written
+                    AppendLiteral(std::wstring_view(format.data() + pos, close + 1 - pos));
+                }
+                pos = close + 1;
+                continue;
+            }
+
+            AppendLiteral(L"{");
+            pos++;
+            continue;
+        }
+
+        if (c == L'}') {
+            if (pos + 1 < n && format[pos + 1] == L'}') {
+                AppendLiteral(L"}");
+                pos += 2;
+                continue;
+            }
+            pos++;
+            if (depth > 0) {
+                return true;
+            }
+            AppendLiteral(L"}");
+            continue;
+        }
+
+        size_t end = pos;
+        while (end < n && format[end] != L'{' && format[end] != L'}') {
+            end++;
+        }
+        AppendLiteral(std::wstring_view(format.data() + pos, end - pos));
+        pos = end;
+    }
+    return false;
+}
+
+bool FormatTemplate::ParseField(std::wstring_view token, Field& field, int& width) {
+    width = 0;
+    std::wstring_view name = token;
+    size_t colon = token.find(L':');
+    if (colon != std::wstring_view::npos) {
+        name = token.substr(0, colon);
+        std::wstring_view spec = token.substr(colon + 1);
+
+        // "0" then the width, as in printf's %02d
+        if (spec.size() < 2 || spec.size() > 3 || spec[0] != L'0') {
+            return false;
+        }
+        for (size_t i = 1; i < spec.size(); i++) {
+            if (spec[i] < L'0' || spec[i] > L'9') {
+                return false;
+            }
+            width = width * 10 + (spec[i] - L'0');
+        }
+        if (width < 1 || width > MAX_WIDTH) {
+            return false;
+        }
+    }
+
+    if (name == L"number") {
+        field = Field::Number;
+    } else if (name == L"name") {
+        field = Field::Name;
+    } else if (name == L"count") {
+        field = Field::Count;
+    } else if (name == L"prev") {
+        field = Field::Prev;
+    } else if (name == L"next") {
+        field = Field::Next;
+    } else if (name == L"monitor") {
+        field = Field::Monitor;
+    } else {
+        return false;
+    }
+
+    // Only numbers are padded
+    return width == 0 || field != Field::Name;
+}
+
+void FormatTemplate::AppendLiteral(std::wstring_view text) {
+    if (text.empty()) {
+        return;
+    }
+
+    // Adjacent runs (text around an escape) become one op, but never
+    // across a section boundary
+    if (m_ops.size() > m_mergeFrom && m_ops.back().type == OpType::Literal &&
+        m_ops.back().offset + m_ops.back().length == m_literals.size()) {
+        m_ops.back().length += static_cast<uint32_t>(text.size());
+    } else {
+        Op op;
+        op.type = OpType::Literal;
+        op.offset = static_cast<uint32_t>(m_literals.size());
+        op.length = static_cast<uint32_t>(text.size());
+        m_ops.push_back(op);
+    }
+    m_literals.append(text.data(), text.size());
+}
+
+void FormatTemplate::MakeTrailingNameConditional() {
+    // "... : {name}" -> "...{?: {name}}"
+    size_t count = m_ops.size();
+    if (count < 2) {
+        return;
+    }
+    Op name = m_ops[count - 1];
+    Op& literal = m_ops[count - 2];
+    if (name.type != OpType::Field || name.field != Field::Name ||
+        literal.type != OpType::Literal || literal.length < 2 ||
+        m_literals.compare(literal.offset + literal.length - 2, 2, L": ") != 0) {
+        return;
+    }
+
+    m_ops.pop_back();
+    literal.length -= 2;
+    if (literal.length == 0) {
+        m_ops.pop_back();
+    }
+
+    size_t index = m_ops.size();
+    Op section;
+    section.type = OpType::Section;
+    section.required = 1u << static_cast<uint32_t>(Field::Name);
+    m_ops.push_back(section);
+    AppendLiteral(L": ");
+    m_ops.push_back(name);
+    m_ops[index].end = static_cast<uint32_t>(m_ops.size());
+}
+
+uint32_t FormatTemplate::GetEmptyFields(const FormatValues& values) {
+    uint32_t empty = 0;
+    if (values.name.empty()) {
+        empty |= 1u << static_cast<uint32_t>(Field::Name);
+    }
+    if (values.count <= 0) {
+        empty |= 1u << static_cast<uint32_t>(Field::Count);
+    }
+    if (values.number <= 1) {
+        empty |= 1u << static_cast<uint32_t>(Field::Prev);
+    }
+    if (values.count <= 0 || values.number >= values.count) {
+        empty |= 1u << static_cast<uint32_t>(Field::Next);
+    }
+    if (values.monitor <= 0) {
+        empty |= 1u << static_cast<uint32_t>(Field::Monitor);
+    }
+    return empty;
+}
+
+void FormatTemplate::AppendNumber(std::wstring& out, int value, int width) {
+    wchar_t digits[16];
+    int count = 0;
+    long long magnitude = value;
+    if (magnitude < 0) {
+        out.push_back(L'-');
+        magnitude = -magnitude;
+    }
+    do {
+        digits[count++] = static_cast<wchar_t>(L'0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude > 0);
+
+    for (int i = count; i < width; i++) {
+        out.push_back(L'0');
+    }
+    while (count > 0) {
+        out.push_back(digits[--count]);
+    }
+}
+
+void FormatTemplate::Render(const FormatValues& values, std::wstring& out) const {
+    out.clear();
+    uint32_t empty = GetEmptyFields(values);
+
+    size_t i = 0;
+    while (i < m_ops.size()) {
+        const Op& op = m_ops[i];
+        switch (op.type) {
+            case OpType::Literal:
+                out.append(m_literals, op.offset, op.length);
+                break;
+
+            case OpType::Section:
+                if (op.required & empty) {
+                    i = op.end;
+                    continue;
+                }
+                break;
+
+            case OpType::Field:
+                if (empty & (1u << static_cast<uint32_t>(op.field))) {
+                    break;
+                }
+                switch (op.field) {
+                    case Field::Number:
+                        AppendNumber(out, values.number, op.width);
+                        break;
+                    case Field::Name:
+                        out.append(values.name.data(), values.name.size());
+                        break;
+                    case Field::Count:
+                        AppendNumber(out, values.count, op.width);
+                        break;
+                    case Field::Prev:
+                        AppendNumber(out, values.number - 1, op.width);
+                        break;
+                    case Field::Next:
+                        AppendNumber(out, values.number + 1, op.width);
+                        break;
+                    case Field::Monitor:
+                        AppendNumber(out, values.monitor, op.width);
+                        break;
+                }
+                break;
+        }
+        i++;
+    }
+}
+
+std::wstring FormatTemplate::Render(const FormatValues& values) const {
+    std::wstring out;
+    Render(values, out);
+    return out;
+}
+
+}  // namespace VirtualOverlay
@@ -0,0 +1,81 @@
+#pragma once
+
+// The overlay's format string (overlay.format), compiled once into a list
+// of literal runs and fields so labels are produced in a single pass.
+//
+//   {number} {name} {count} {prev} {next} {monitor}
+//   {number:02}       numeric fields zero-padded to a width (1-16)
+//   {? ...}           section, dropped when any field directly inside it
+//                     is empty: "{number}{?: {name}}"
+//   {{ }}             literal braces
+//
+// Unknown or malformed tokens are kept as literal text. For formats without
+// sections, a ": " right before a trailing {name} is made conditional,
+// matching the old "{number}: {name}" cleanup for unnamed desktops.
+// Platform-independent (no <windows.h>).
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace VirtualOverlay {
+
+struct FormatValues {
+    int number = 0;            // Desktop number
+    std::wstring_view name;    // Empty when the desktop is unnamed
+    int count = 0;             // Desktops in total; 0 = unknown
+    int monitor = 0;           // Monitor number (1-based); 0 = unknown
+};
+
+class FormatTemplate {
+public:
+    static constexpr int MAX_WIDTH = 16;        // Zero-padding width
+    static constexpr int MAX_SECTION_DEPTH = 8; // Deeper "{?" is literal
+
+    FormatTemplate() = default;
+    explicit FormatTemplate(const std::wstring& format) { Compile(format); }
+
+    void Compile(const std::wstring& format);
+
+    // Replaces out's contents (its capacity is reused)
+    void Render(const FormatValues& values, std::wstring& out) const;
+    std::wstring Render(const FormatValues& values) const;
+
+    const std::wstring& GetSource() const { return m_source; }
+
+private:
+    enum class Field : uint8_t { Number, Name, Count, Prev, Next, Monitor };
+
+    enum class OpType : uint8_t {
+        Literal,   // m_literals[offset, offset + length)
+        Field,     // field, zero-padded to width
+        Section    // Skip to op index end when a required field is empty
+    };
+
+    struct Op {
+        OpType type = OpType::Literal;
+        Field field = Field::Number;
+        uint8_t width = 0;
+        uint32_t offset = 0;
+        uint32_t length = 0;
+        uint32_t end = 0;
+        uint32_t required = 0;  // Bit per Field directly inside the section
+    };
+
+    static bool ParseField(std::wstring_view token, Field& field, int& width);
+    static uint32_t GetEmptyFields(const FormatValues& values);
+    static void AppendNumber(std::wstring& out, int value, int width);
+
+    // Parse from pos until the end or, inside a section, its closing brace
+    bool ParseSequence(const std::wstring& format, size_t& pos, int depth, size_t section);
+    void AppendLiteral(std::wstring_view text);
+    void MakeTrailingNameConditional();
+
+    std::wstring m_source;
+    std::wstring m_literals;
+    std::vector<Op> m_ops;
+    size_t m_mergeFrom = 0;  // First op a literal may be merged into
+};
+
+}  // namespace VirtualOverlay
@@ -0,0 +1,117 @@
+#include "LabelCache.h"
+#include <cstring>
+#include <functional>
+#include <iterator>
+
+namespace VirtualOverlay {
+
+namespace {
+
+void HashCombine(size_t& seed, size_t value) {
+    seed ^= value + 0x9E3779B97F4A7C15ull + (seed << 6) + (seed >> 2);
+}
+
+}  // namespace
+
+bool LabelStyle::operator==(const LabelStyle& other) const {
+    return fontFamily == other.fontFamily && fontSize == other.fontSize &&
+           fontWeight == other.fontWeight && color == other.color &&
+           opacity == other.opacity && outlineWidth == other.outlineWidth &&
+           glowRadius == other.glowRadius && distanceField == other.distanceField &&
+           padding == other.padding;
+}
+
+bool LabelKey::operator==(const LabelKey& other) const {
+    return width == other.width && height == other.height && text == other.text &&
+           style == other.style;
+}
+
+size_t LabelKeyHash::operator()(const LabelKey& key) const {
+    uint32_t opacityBits = 0;
+    std::memcpy(&opacityBits, &key.style.opacity, sizeof(opacityBits));
+
+    size_t seed = std::hash<std::wstring>()(key.text);
+    HashCombine(seed, std::hash<std::wstring>()(key.style.fontFamily));
+    HashCombine(seed, static_cast<size_t>(key.style.fontSize));
+    HashCombine(seed, static_cast<size_t>(key.style.fontWeight));
+    HashCombine(seed, key.style.color);
+    HashCombine(seed, opacityBits);
+    HashCombine(seed, static_cast<size_t>(key.style.outlineWidth));
+    HashCombine(seed, static_cast<size_t>(key.style.glowRadius));
+    HashCombine(seed, key.style.distanceField ? 1u : 0u);
+    HashCombine(seed, static_cast<size_t>(key.style.padding));
+    HashCombine(seed, (static_cast<size_t>(key.width) << 16) ^ static_cast<size_t>(key.height));
+    return seed;
+}
+
+LabelCache::LabelCache(size_t budgetBytes)
+    : m_budgetBytes(budgetBytes) {
+}
+
+void LabelCache::SetBudget(size_t budgetBytes) {
+    m_budgetBytes = budgetBytes;
+    EvictToFit(0);
+}
+
+const LabelBitmap* LabelCache::Find(const LabelKey& key) {
+    auto found = m_index.find(key);
+    if (found == m_index.end()) {
+        m_stats.misses++;
+        return nullptr;
+    }
+
+    m_stats.hits++;
+    m_entries.splice(m_entries.begin(), m_entries, found->second);
+    return &found->second->second;
+}
+
+bool LabelCache::Contains(const LabelKey& key) const {
+    return m_index.find(key) != m_index.end();
+}
+
+const LabelBitmap* LabelCache::Insert(const LabelKey& key, LabelBitmap&& bitmap) {
+    auto found = m_index.find(key);
+    if (found != m_index.end()) {
+        Erase(found->second);
+    }
+
+    size_t bytes = bitmap.GetBytes();
+    if (bytes > m_budgetBytes) {
+        m_stats.rejected++;
+        return nullptr;
+    }
+
+    EvictToFit(bytes);
+    m_entries.emplace_front(key, std::move(bitmap));
+    m_index[key] = m_entries.begin();
+    m_stats.bytes += bytes;
+    m_stats.inserts++;
+    return &m_entries.front().second;
+}
+
+void LabelCache::Clear() {
+    m_entries.clear();
+    m_index.clear();
+    m_stats.bytes = 0;
+}
+
+void LabelCache::ResetStats() {
+    size_t bytes = m_stats.bytes;
+    m_stats = LabelCacheStats();
+    m_stats.bytes = bytes;
+}
+
+void LabelCache::Erase(EntryList::iterator it) {
+    m_stats.bytes -= it->second.GetBytes();
+    m_index.erase(it->first);
+    m_entries.erase(it);
+}
+
+void LabelCache::EvictToFit(size_t incomingBytes) {
+    while (!m_entries.empty() && m_stats.bytes + incomingBytes > m_budgetBytes) {
+        Erase(std::prev(m_entries.end()));
+        m_stats.evictions++;
+    }
+}
+
+}  // namespace VirtualOverlay
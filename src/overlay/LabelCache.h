@@ -0,0 +1,111 @@
+#pragma once
+
+// Finished label bitmaps, keyed by text plus every style field that changes
+// the pixels.
+//
+// Flipping between two desktops shows the same couple of labels over and
+// over; each used to be shaped and rasterized by DirectWrite again. A hit
+// hands back premultiplied pixels that only need copying into the layered
+// window's bitmap. Entries are evicted least-recently-used once the byte
+// budget is exceeded; a budget of 0 disables the cache.
+// Platform-independent (no <windows.h>).
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace VirtualOverlay {
+
+// Everything besides the text that affects a label's pixels
+struct LabelStyle {
+    std::wstring fontFamily;
+    int fontSize = 0;
+    int fontWeight = 0;
+    uint32_t color = 0;       // RGB
+    float opacity = 1.0f;
+    int outlineWidth = 0;     // 0 = no outline
+    int glowRadius = 0;
+    bool distanceField = false;  // Rendered from a distance field
+    int padding = 0;
+
+    bool operator==(const LabelStyle& other) const;
+    bool operator!=(const LabelStyle& other) const { return !(*this == other); }
+};
+
+struct LabelKey {
+    std::wstring text;
+    LabelStyle style;
+    int width = 0;            // Bitmap size (the text is laid out inside it)
+    int height = 0;
+
+    bool operator==(const LabelKey& other) const;
+    bool operator!=(const LabelKey& other) const { return !(*this == other); }
+};
+
+struct LabelKeyHash {
+    size_t operator()(const LabelKey& key) const;
+};
+
+// Premultiplied BGRA, top-down rows, no stride padding
+struct LabelBitmap {
+    int width = 0;
+    int height = 0;
+    std::vector<uint32_t> pixels;
+
+    size_t GetBytes() const { return pixels.size() * sizeof(uint32_t); }
+};
+
+struct LabelCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t inserts = 0;
+    uint64_t evictions = 0;
+    uint64_t rejected = 0;    // Larger than the whole budget
+    size_t bytes = 0;
+};
+
+class LabelCache {
+public:
+    static constexpr size_t DEFAULT_BUDGET_BYTES = 8 * 1024 * 1024;
+
+    explicit LabelCache(size_t budgetBytes = DEFAULT_BUDGET_BYTES);
+
+    // Change the budget, evicting as needed
+    void SetBudget(size_t budgetBytes);
+    size_t GetBudget() const { return m_budgetBytes; }
+
+    // Lookup that counts a hit or miss and refreshes the entry's LRU position.
+    // The pointer is valid until the next Insert, SetBudget or Clear.
+    const LabelBitmap* Find(const LabelKey& key);
+
+    // Presence check without touching stats or LRU order (warm-up)
+    bool Contains(const LabelKey& key) const;
+
+    // Store a bitmap (replacing any entry with the same key). Returns the
+    // cached copy, or nullptr if it does not fit in the budget.
+    const LabelBitmap* Insert(const LabelKey& key, LabelBitmap&& bitmap);
+
+    void Clear();
+
+    size_t GetCount() const { return m_entries.size(); }
+    const LabelCacheStats& GetStats() const { return m_stats; }
+    void ResetStats();
+
+private:
+    using Entry = std::pair<LabelKey, LabelBitmap>;
+    using EntryList = std::list<Entry>;
+
+    void Erase(EntryList::iterator it);
+    void EvictToFit(size_t incomingBytes);
+
+    size_t m_budgetBytes;
+    EntryList m_entries;  // Most recently used first
+    std::unordered_map<LabelKey, EntryList::iterator, LabelKeyHash> m_index;
+    LabelCacheStats m_stats;
+};
+
+}  // namespace VirtualOverlay
@@ -0,0 +1,374 @@
+#include "LabelRasterizer.h"
+#include "MaskFilter.h"
+#include "RenderBackend.h"
+#include "../utils/D2DRenderer.h"
+#include "../utils/Logger.h"
+#include <algorithm>
+#include <cstring>
+
+namespace VirtualOverlay {
+
+bool MeasureTextWithDirectWrite(const TextMetricsKey& key, TextMetrics& metrics) {
+    D2DRenderer& renderer = D2DRenderer::Instance();
+    ComPtr<IDWriteTextFormat> format;
+    if (!renderer.CreateTextFormat(key.fontFamily, key.fontSize,
+                                   static_cast<DWRITE_FONT_WEIGHT>(key.fontWeight),
+                                   format.GetAddressOf())) {
+        return false;
+    }
+    format->SetTextAlignment(DWRITE_TEXT_ALIGNMENT_LEADING);
+    format->SetParagraphAlignment(DWRITE_PARAGRAPH_ALIGNMENT_NEAR);
+    format->SetWordWrapping(DWRITE_WORD_WRAPPING_NO_WRAP);
+
+    ComPtr<IDWriteTextLayout> layout;
+    if (!renderer.CreateTextLayout(key.text, format.Get(), 0.0f, 0.0f, layout.GetAddressOf())) {
+        return false;
+    }
+
+    DWRITE_TEXT_METRICS textMetrics = {};
+    HRESULT hr = layout->GetMetrics(&textMetrics);
+    if (FAILED(hr)) {
+        LOG_WARN("GetMetrics failed: 0x%08X", hr);
+        return false;
+    }
+
+    // Overhangs are measured from the layout box: shrink it to the line first
+    layout->SetMaxWidth(textMetrics.widthIncludingTrailingWhitespace);
+    layout->SetMaxHeight(textMetrics.height);
+    DWRITE_OVERHANG_METRICS overhang = {};
+    hr = layout->GetOverhangMetrics(&overhang);
+    if (FAILED(hr)) {
+        LOG_WARN("GetOverhangMetrics failed: 0x%08X", hr);
+        return false;
+    }
+
+    metrics.width = textMetrics.widthIncludingTrailingWhitespace;
+    metrics.height = textMetrics.height;
+    metrics.inkLeft = -overhang.left;
+    metrics.inkTop = -overhang.top;
+    metrics.inkRight = metrics.width + overhang.right;
+    metrics.inkBottom = metrics.height + overhang.bottom;
+    return true;
+}
+
+LabelRasterizer::LabelRasterizer() {
+    m_textMetrics.SetProvider(&MeasureTextWithDirectWrite);
+}
+
+LabelRasterizer::~LabelRasterizer() {
+    ReleaseResources();
+}
+
+bool LabelRasterizer::Rasterize(const RenderRequest& request, LabelBitmap& bitmap) {
+    const LabelKey& key = request.key;
+    if (key.width <= 0 || key.height <= 0) {
+        return false;
+    }
+
+    SetStyle(key.style);
+
+    // Newest label again (a predicted switch landing, a re-show). Labels
+    // seen before that are cached on the UI thread never get here.
+    if (key == m_lastKey) {
+        bitmap = m_lastLabel;
+        return true;
+    }
+
+    if (!EnsureFactory()) {
+        return false;
+    }
+    Surface* surface = AcquireSurface(key.width, key.height);
+    if (!surface) {
+        return false;
+    }
+    if (!DrawLabel(key, *surface)) {
+        m_surfacePool.Discard(surface);
+        return false;
+    }
+
+    CopyPixels(*surface, m_lastLabel);
+    m_surfacePool.Release(surface, GetTickCount64());
+    m_lastKey = key;
+    bitmap = m_lastLabel;
+    return true;
+}
+
+void LabelRasterizer::ReleaseResources() {
+    m_surfacePool.Clear();
+    m_format.Reset();
+    m_factory.Reset();
+}
+
+bool LabelRasterizer::EnsureFactory() {
+    if (m_factory) {
+        return true;
+    }
+
+    // Single-threaded: only the worker thread draws with it, so no locking
+    HRESULT hr = D2D1CreateFactory(D2D1_FACTORY_TYPE_SINGLE_THREADED, m_factory.GetAddressOf());
+    if (FAILED(hr)) {
+        LOG_ERROR("Failed to create label D2D factory: 0x%08X", hr);
+        return false;
+    }
+    return true;
+}
+
+void LabelRasterizer::SetStyle(const LabelStyle& style) {
+    // The last label and text format belong to the style they were made with
+    if (m_hasStyle && style == m_style) {
+        return;
+    }
+    m_lastKey = LabelKey();
+    m_format.Reset();
+    m_style = style;
+    m_hasStyle = true;
+}
+
+LabelRasterizer::Surface* LabelRasterizer::AcquireSurface(int width, int height) {
+    ULONGLONG now = GetTickCount64();
+    Surface* surface = m_surfacePool.Acquire(width, height, now);
+    if (surface) {
+        return surface;
+    }
+
+    Surface created;
+    if (!CreateSurface(width, height, created)) {
+        ReleaseSurface(created);
+        return nullptr;
+    }
+    surface = m_surfacePool.Adopt(width, height, std::move(created), now);
+
+    const SurfacePoolStats& stats = m_surfacePool.GetStats();
+    LOG_DEBUG("Label surface created: %dx%d (pool: %llu reused / %llu acquires, %zu bytes)",
+              width, height, stats.reuses, stats.acquires, stats.bytes);
+    return surface;
+}
+
+bool LabelRasterizer::CreateSurface(int width, int height, Surface& surface) {
+    // Create compatible DC
+    HDC hdcScreen = GetDC(nullptr);
+    surface.hdc = CreateCompatibleDC(hdcScreen);
+
+    // Create 32-bit ARGB bitmap
+    BITMAPINFO bmi = {};
+    bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    bmi.bmiHeader.biWidth = width;
+    bmi.bmiHeader.biHeight = -height;  // Top-down
+    bmi.bmiHeader.biPlanes = 1;
+    bmi.bmiHeader.biBitCount = 32;
+    bmi.bmiHeader.biCompression = BI_RGB;
+
+    void* pvBits = nullptr;
+    surface.bitmap = CreateDIBSection(hdcScreen, &bmi, DIB_RGB_COLORS, &pvBits, nullptr, 0);
+    ReleaseDC(nullptr, hdcScreen);
+    if (!surface.hdc || !surface.bitmap) {
+        return false;
+    }
+    surface.bits = pvBits;
+    surface.oldBitmap = (HBITMAP)SelectObject(surface.hdc, surface.bitmap);
+    surface.width = width;
+    surface.height = height;
+
+    D2D1_RENDER_TARGET_PROPERTIES rtProps = D2D1::RenderTargetProperties(
+        D2D1_RENDER_TARGET_TYPE_DEFAULT,
+        D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED),
+        0, 0,
+        D2D1_RENDER_TARGET_USAGE_NONE,
+        D2D1_FEATURE_LEVEL_DEFAULT
+    );
+
+    HRESULT hr = m_factory->CreateDCRenderTarget(&rtProps, surface.target.GetAddressOf());
+    if (FAILED(hr)) {
+        return false;
+    }
+
+    // The DC and bitmap live as long as the surface: bind once
+    RECT rcBind = { 0, 0, width, height };
+    hr = surface.target->BindDC(surface.hdc, &rcBind);
+    if (FAILED(hr)) {
+        return false;
+    }
+
+    // One brush, recolored per label
+    hr = surface.target->CreateSolidColorBrush(D2D1::ColorF(1.0f, 1.0f, 1.0f, 1.0f),
+                                               surface.brush.GetAddressOf());
+    return SUCCEEDED(hr);
+}
+
+void LabelRasterizer::ReleaseSurface(Surface& surface) {
+    surface.brush.Reset();
+    surface.target.Reset();
+    if (surface.hdc) {
+        if (surface.oldBitmap) {
+            SelectObject(surface.hdc, surface.oldBitmap);
+        }
+        DeleteDC(surface.hdc);
+    }
+    if (surface.bitmap) {
+        DeleteObject(surface.bitmap);
+    }
+    surface = Surface();
+}
+
+bool LabelRasterizer::DrawLabel(const LabelKey& key, Surface& surface) {
+    // Text format is device-independent: one for all surfaces
+    if (!m_format) {
+        IDWriteTextFormat* pFormat = nullptr;
+        DWRITE_FONT_WEIGHT weight = static_cast<DWRITE_FONT_WEIGHT>(m_style.fontWeight);
+        if (D2DRenderer::Instance().CreateTextFormat(
+            m_style.fontFamily,
+            static_cast<float>(m_style.fontSize),
+            weight,
+            &pFormat
+        )) {
+            // The layout box is exactly one measured line: never wrap it
+            pFormat->SetWordWrapping(DWRITE_WORD_WRAPPING_NO_WRAP);
+            m_format.Attach(pFormat);
+        }
+    }
+
+    if (m_style.distanceField) {
+        return DrawLabelFromField(key, surface);
+    }
+
+    // Outlined labels are drawn once as plain coverage and colored afterwards
+    bool outlined = m_style.outlineWidth > 0;
+    D2D1_COLOR_F color = outlined ? D2D1::ColorF(1.0f, 1.0f, 1.0f, 1.0f)
+                                  : D2DRenderer::ColorFromRGB(m_style.color, m_style.opacity);
+    if (!ShapeLabel(key.text, surface, color)) {
+        return false;
+    }
+
+    if (outlined) {
+        ComposeOutline(surface);
+    }
+    return true;
+}
+
+bool LabelRasterizer::DrawLabelFromField(const LabelKey& key, Surface& surface) {
+    // Shape the text only when no field of it was built at a nearby size;
+    // size, outline and glow changes are then just a re-threshold
+    DistanceFieldKey fieldKey;
+    fieldKey.text = key.text;
+    fieldKey.fontFamily = m_style.fontFamily;
+    fieldKey.fontWeight = m_style.fontWeight;
+    int fontSize = m_style.fontSize;
+
+    const DistanceField* field = m_distanceFields.Find(fieldKey, fontSize);
+    if (!field) {
+        if (!ShapeLabel(key.text, surface, D2D1::ColorF(1.0f, 1.0f, 1.0f, 1.0f))) {
+            return false;
+        }
+        ReadCoverage(surface);
+        field = m_distanceFields.Insert(fieldKey,
+            BuildDistanceField(m_coverageMask.data(), surface.width, surface.height, fontSize));
+        if (!field) {
+            return false;
+        }
+    }
+
+    size_t count = static_cast<size_t>(surface.width) * surface.height;
+    m_coverageMask.resize(count);
+    m_haloMask.resize(count);
+    float scale = static_cast<float>(fontSize) / static_cast<float>(field->fontSize);
+    RenderDistanceField(*field, surface.width, surface.height, scale,
+                        static_cast<float>(m_style.outlineWidth),
+                        static_cast<float>(m_style.glowRadius),
+                        m_coverageMask.data(), m_haloMask.data());
+    GdiFlush();
+    WriteLabel(surface);
+    return true;
+}
+
+bool LabelRasterizer::ShapeLabel(const std::wstring& text, Surface& surface, const D2D1_COLOR_F& color) {
+    surface.target->BeginDraw();
+    surface.target->Clear(D2D1::ColorF(0, 0, 0, 0));  // Transparent
+
+    // Lay the measured line out so its ink sits in the middle of the bitmap;
+    // unmeasured text is centered in the padded surface as before
+    D2D1_RECT_F textRect;
+    TextMetricsKey metricsKey;
+    metricsKey.text = text;
+    metricsKey.fontFamily = m_style.fontFamily;
+    metricsKey.fontSize = static_cast<float>(m_style.fontSize);
+    metricsKey.fontWeight = m_style.fontWeight;
+    TextMetrics metrics;
+    if (m_textMetrics.Measure(metricsKey, metrics)) {
+        float left, top;
+        CenterInk(metrics, surface.width, surface.height, left, top);
+        textRect = D2D1::RectF(left, top, left + metrics.width, top + metrics.height);
+    } else {
+        float padding = static_cast<float>(m_style.padding);
+        textRect = D2D1::RectF(padding, padding,
+            static_cast<float>(surface.width) - padding, static_cast<float>(surface.height) - padding);
+    }
+
+    if (m_format && surface.brush) {
+        surface.brush->SetColor(color);
+        surface.target->DrawText(
+            text.c_str(),
+            static_cast<UINT32>(text.length()),
+            m_format.Get(),
+            textRect,
+            surface.brush.Get()
+        );
+    }
+
+    HRESULT hr = surface.target->EndDraw();
+    if (FAILED(hr)) {
+        LOG_WARN("Watermark EndDraw failed: 0x%08X", hr);
+        return false;
+    }
+    return true;
+}
+
+void LabelRasterizer::ReadCoverage(const Surface& surface) {
+    // Text drawn in opaque white: the alpha channel is the glyph coverage
+    GdiFlush();
+    size_t count = static_cast<size_t>(surface.width) * surface.height;
+    const uint32_t* pixels = static_cast<const uint32_t*>(surface.bits);
+    m_coverageMask.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        m_coverageMask[i] = static_cast<uint8_t>(pixels[i] >> 24);
+    }
+}
+
+void LabelRasterizer::ComposeOutline(Surface& surface) {
+    // Dilate the coverage for the outline, soften it for the glow and write
+    // fill-over-halo back in one pass: the text is shaped only once
+    ReadCoverage(surface);
+    m_haloMask.resize(m_coverageMask.size());
+    DilateMask(m_coverageMask.data(), m_haloMask.data(), surface.width, surface.height,
+               m_style.outlineWidth);
+    if (m_style.glowRadius > 0) {
+        BlurMask(m_haloMask.data(), surface.width, surface.height, m_style.glowRadius);
+    }
+    WriteLabel(surface);
+}
+
+void LabelRasterizer::WriteLabel(Surface& surface) {
+    // Color m_coverageMask (text) over m_haloMask (outline) straight into the DIB
+    float opacity = std::clamp(m_style.opacity, 0.0f, 1.0f);
+    WatermarkFrame frame;
+    frame.width = surface.width;
+    frame.height = surface.height;
+    frame.fill = m_coverageMask.data();
+    frame.halo = m_style.outlineWidth > 0 ? m_haloMask.data() : nullptr;
+    frame.textColor = RenderColor::FromRGB(m_style.color, opacity);
+    frame.haloColor = RenderColor::FromRGB(0x000000, opacity * 0.7f);
+
+    m_backend.AttachPixels(static_cast<uint32_t*>(surface.bits), surface.width, surface.height);
+    DrawWatermarkFrame(m_backend, frame);
+    m_backend.DetachPixels();
+}
+
+void LabelRasterizer::CopyPixels(const Surface& surface, LabelBitmap& bitmap) {
+    // The DC render target wrote the DIB in EndDraw; make sure GDI is done
+    GdiFlush();
+    bitmap.width = surface.width;
+    bitmap.height = surface.height;
+    bitmap.pixels.resize(static_cast<size_t>(surface.width) * surface.height);
+    memcpy(bitmap.pixels.data(), surface.bits, bitmap.GetBytes());
+}
+
+}  // namespace VirtualOverlay
@@ -0,0 +1,95 @@
+#pragma once
+
+// Watermark label rasterization, run on the RenderWorker thread.
+//
+// Owns everything a label needs from shaping to finished pixels: its own
+// single-threaded Direct2D factory and DC render targets (created on the
+// worker thread and used only there), the text format, distance-field
+// atlas, coverage masks and software compositor. Finished labels are cached
+// by the UI thread (OverlayWindow), not here. The UI
+// thread never touches any of it while the worker runs; the text format and
+// layouts come from the shared DirectWrite factory, which is thread-safe.
+
+#include "LabelCache.h"
+#include "DistanceField.h"
+#include "RenderWorker.h"
+#include "SoftwareRenderBackend.h"
+#include "SurfacePool.h"
+#include "TextMetricsCache.h"
+#include <windows.h>
+#include <d2d1.h>
+#include <dwrite.h>
+#include <wrl/client.h>
+#include <string>
+#include <vector>
+
+namespace VirtualOverlay {
+
+using Microsoft::WRL::ComPtr;
+
+// Advance, line height and ink bounds of one line of text, from a DirectWrite
+// layout and its overhang metrics (any thread)
+bool MeasureTextWithDirectWrite(const TextMetricsKey& key, TextMetrics& metrics);
+
+class LabelRasterizer {
+public:
+    LabelRasterizer();
+    ~LabelRasterizer();
+
+    LabelRasterizer(const LabelRasterizer&) = delete;
+    LabelRasterizer& operator=(const LabelRasterizer&) = delete;
+
+    // Worker thread: fill bitmap with the requested label (LabelRasterizeFn)
+    bool Rasterize(const RenderRequest& request, LabelBitmap& bitmap);
+
+    // Worker thread: release the D2D objects before the thread ends
+    void ReleaseResources();
+
+    // Only while the worker is stopped
+    const DistanceFieldAtlas& GetDistanceFields() const { return m_distanceFields; }
+
+private:
+    // 32-bit premultiplied DIB selected into a memory DC, with a DC render
+    // target bound to it once; pooled by size
+    struct Surface {
+        HDC hdc = nullptr;
+        HBITMAP bitmap = nullptr;
+        void* bits = nullptr;  // Top-down BGRA, width * 4 bytes per row
+        HBITMAP oldBitmap = nullptr;
+        ComPtr<ID2D1DCRenderTarget> target;
+        ComPtr<ID2D1SolidColorBrush> brush;
+        int width = 0;
+        int height = 0;
+    };
+
+    bool EnsureFactory();
+    void SetStyle(const LabelStyle& style);
+    Surface* AcquireSurface(int width, int height);
+    bool CreateSurface(int width, int height, Surface& surface);
+    static void ReleaseSurface(Surface& surface);
+
+    bool DrawLabel(const LabelKey& key, Surface& surface);
+    bool DrawLabelFromField(const LabelKey& key, Surface& surface);
+    bool ShapeLabel(const std::wstring& text, Surface& surface, const D2D1_COLOR_F& color);
+    void ReadCoverage(const Surface& surface);
+    void ComposeOutline(Surface& surface);
+    void WriteLabel(Surface& surface);
+    static void CopyPixels(const Surface& surface, LabelBitmap& bitmap);
+
+    ComPtr<ID2D1Factory> m_factory;
+    ComPtr<IDWriteTextFormat> m_format;
+    LabelStyle m_style;              // Style m_format and the last label belong to
+    bool m_hasStyle = false;
+
+    static constexpr size_t SURFACE_POOL_IDLE = 2;
+    SurfacePool<Surface> m_surfacePool{ SURFACE_POOL_IDLE, &LabelRasterizer::ReleaseSurface };
+    LabelKey m_lastKey;              // Newest label drawn
+    LabelBitmap m_lastLabel;
+    DistanceFieldAtlas m_distanceFields;  // Shaped labels, reusable at nearby sizes
+    TextMetricsCache m_textMetrics;       // Where the line goes in the bitmap
+    std::vector<uint8_t> m_coverageMask;  // Fill/outline scratch, reused across labels
+    std::vector<uint8_t> m_haloMask;
+    SoftwareRenderBackend m_backend;      // Writes the finished label into the DIB
+};
+
+}  // namespace VirtualOverlay
@@ -0,0 +1,344 @@
+#include "MaskFilter.h"
+#include "../utils/CpuFeatures.h"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#if defined(VO_CPU_X86)
+#include <immintrin.h>
+#endif
+
+namespace VirtualOverlay {
+
+namespace {
+
+// Rounded division by the box size: ((sum + d/2) * ceil(65536/d)) >> 16,
+// saturated to 255. Fits in 16 bits for d <= 255, which the SIMD paths rely on.
+struct BoxDivisor {
+    uint16_t half;
+    uint16_t multiplier;
+
+    explicit BoxDivisor(int size)
+        : half(static_cast<uint16_t>(size / 2)),
+          multiplier(static_cast<uint16_t>((65536 + size - 1) / size)) {
+    }
+
+    uint8_t Apply(uint32_t sum) const {
+        uint32_t value = ((sum + half) * multiplier) >> 16;
+        return static_cast<uint8_t>(std::min<uint32_t>(value, 255));
+    }
+};
+
+// ---------------------------------------------------------------------------
+// Scalar
+
+void DilateRowScalar(const uint8_t* padded, uint8_t* dst, int width, int taps, int start) {
+    for (int x = start; x < width; x++) {
+        uint8_t value = padded[x];
+        for (int k = 1; k < taps; k++) {
+            value = std::max(value, padded[x + k]);
+        }
+        dst[x] = value;
+    }
+}
+
+void MaxRowsScalar(const uint8_t* const* rows, int rowCount, uint8_t* dst, int width, int start) {
+    for (int x = start; x < width; x++) {
+        uint8_t value = rows[0][x];
+        for (int r = 1; r < rowCount; r++) {
+            value = std::max(value, rows[r][x]);
+        }
+        dst[x] = value;
+    }
+}
+
+void ColumnSumStepScalar(uint16_t* sums, const uint8_t* add, const uint8_t* sub, int width, int start) {
+    for (int x = start; x < width; x++) {
+        sums[x] = static_cast<uint16_t>(sums[x] + (add ? add[x] : 0) - (sub ? sub[x] : 0));
+    }
+}
+
+void ColumnDivideScalar(const uint16_t* sums, uint8_t* dst, int width, const BoxDivisor& divisor, int start) {
+    for (int x = start; x < width; x++) {
+        dst[x] = divisor.Apply(sums[x]);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// SSE2 / AVX2: vectorized across x; each returns how many pixels it handled
+
+#if defined(VO_CPU_X86)
+
+VO_TARGET_SSE2 int DilateRowSse2(const uint8_t* padded, uint8_t* dst, int width, int taps) {
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(padded + x));
+        for (int k = 1; k < taps; k++) {
+            value = _mm_max_epu8(value, _mm_loadu_si128(reinterpret_cast<const __m128i*>(padded + x + k)));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x), value);
+    }
+    return x;
+}
+
+VO_TARGET_AVX2 int DilateRowAvx2(const uint8_t* padded, uint8_t* dst, int width, int taps) {
+    int x = 0;
+    for (; x + 32 <= width; x += 32) {
+        __m256i value = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(padded + x));
+        for (int k = 1; k < taps; k++) {
+            value = _mm256_max_epu8(value, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(padded + x + k)));
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + x), value);
+    }
+    return x;
+}
+
+VO_TARGET_SSE2 int MaxRowsSse2(const uint8_t* const* rows, int rowCount, uint8_t* dst, int width) {
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows[0] + x));
+        for (int r = 1; r < rowCount; r++) {
+            value = _mm_max_epu8(value, _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows[r] + x)));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x), value);
+    }
+    return x;
+}
+
+VO_TARGET_AVX2 int MaxRowsAvx2(const uint8_t* const* rows, int rowCount, uint8_t* dst, int width) {
+    int x = 0;
+    for (; x + 32 <= width; x += 32) {
+        __m256i value = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rows[0] + x));
+        for (int r = 1; r < rowCount; r++) {
+            value = _mm256_max_epu8(value, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rows[r] + x)));
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + x), value);
+    }
+    return x;
+}
+
+VO_TARGET_SSE2 int ColumnSumStepSse2(uint16_t* sums, const uint8_t* add, const uint8_t* sub, int width) {
+    const __m128i zero = _mm_setzero_si128();
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sums + x));
+        __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sums + x + 8));
+        if (add) {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(add + x));
+            lo = _mm_add_epi16(lo, _mm_unpacklo_epi8(a, zero));
+            hi = _mm_add_epi16(hi, _mm_unpackhi_epi8(a, zero));
+        }
+        if (sub) {
+            __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sub + x));
+            lo = _mm_sub_epi16(lo, _mm_unpacklo_epi8(s, zero));
+            hi = _mm_sub_epi16(hi, _mm_unpackhi_epi8(s, zero));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(sums + x), lo);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(sums + x + 8), hi);
+    }
+    return x;
+}
+
+VO_TARGET_AVX2 int ColumnSumStepAvx2(uint16_t* sums, const uint8_t* add, const uint8_t* sub, int width) {
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        __m256i value = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sums + x));
+        if (add) {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(add + x));
+            value = _mm256_add_epi16(value, _mm256_cvtepu8_epi16(a));
+        }
+        if (sub) {
+            __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sub + x));
+            value = _mm256_sub_epi16(value, _mm256_cvtepu8_epi16(s));
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(sums + x), value);
+    }
+    return x;
+}
+
+VO_TARGET_SSE2 int ColumnDivideSse2(const uint16_t* sums, uint8_t* dst, int width, const BoxDivisor& divisor) {
+    const __m128i half = _mm_set1_epi16(static_cast<short>(divisor.half));
+    const __m128i multiplier = _mm_set1_epi16(static_cast<short>(divisor.multiplier));
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sums + x));
+        __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sums + x + 8));
+        lo = _mm_mulhi_epu16(_mm_add_epi16(lo, half), multiplier);
+        hi = _mm_mulhi_epu16(_mm_add_epi16(hi, half), multiplier);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x), _mm_packus_epi16(lo, hi));
+    }
+    return x;
+}
+
+VO_TARGET_AVX2 int ColumnDivideAvx2(const uint16_t* sums, uint8_t* dst, int width, const BoxDivisor& divisor) {
+    const __m256i half = _mm256_set1_epi16(static_cast<short>(divisor.half));
+    const __m256i multiplier = _mm256_set1_epi16(static_cast<short>(divisor.multiplier));
+    int x = 0;
+    for (; x + 32 <= width; x += 32) {
+        __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sums + x));
+        __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sums + x + 16));
+        lo = _mm256_mulhi_epu16(_mm256_add_epi16(lo, half), multiplier);
+        hi = _mm256_mulhi_epu16(_mm256_add_epi16(hi, half), multiplier);
+        // packus works per 128-bit lane; restore linear order afterwards
+        __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(lo, hi), 0xD8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + x), packed);
+    }
+    return x;
+}
+
+#endif  // VO_CPU_X86
+
+MaskKernel Resolve(MaskKernel kernel) {
+    MaskKernel best = GetBestMaskKernel();
+    if (kernel == MaskKernel::Auto || static_cast<int>(kernel) > static_cast<int>(best)) {
+        return best;
+    }
+    return kernel;
+}
+
+int DilateRow(MaskKernel kernel, const uint8_t* padded, uint8_t* dst, int width, int taps) {
+    int done = 0;
+#if defined(VO_CPU_X86)
+    if (kernel == MaskKernel::Avx2) done = DilateRowAvx2(padded, dst, width, taps);
+    else if (kernel == MaskKernel::Sse2) done = DilateRowSse2(padded, dst, width, taps);
+#else
+    (void)kernel;
+#endif
+    DilateRowScalar(padded, dst, width, taps, done);
+    return width;
+}
+
+void MaxRows(MaskKernel kernel, const uint8_t* const* rows, int rowCount, uint8_t* dst, int width) {
+    int done = 0;
+#if defined(VO_CPU_X86)
+    if (kernel == MaskKernel::Avx2) done = MaxRowsAvx2(rows, rowCount, dst, width);
+    else if (kernel == MaskKernel::Sse2) done = MaxRowsSse2(rows, rowCount, dst, width);
+#else
+    (void)kernel;
+#endif
+    MaxRowsScalar(rows, rowCount, dst, width, done);
+}
+
+void ColumnSumStep(MaskKernel kernel, uint16_t* sums, const uint8_t* add, const uint8_t* sub, int width) {
+    int done = 0;
+#if defined(VO_CPU_X86)
+    if (kernel == MaskKernel::Avx2) done = ColumnSumStepAvx2(sums, add, sub, width);
+    else if (kernel == MaskKernel::Sse2) done = ColumnSumStepSse2(sums, add, sub, width);
+#else
+    (void)kernel;
+#endif
+    ColumnSumStepScalar(sums, add, sub, width, done);
+}
+
+void ColumnDivide(MaskKernel kernel, const uint16_t* sums, uint8_t* dst, int width, const BoxDivisor& divisor) {
+    int done = 0;
+#if defined(VO_CPU_X86)
+    if (kernel == MaskKernel::Avx2) done = ColumnDivideAvx2(sums, dst, width, divisor);
+    else if (kernel == MaskKernel::Sse2) done = ColumnDivideSse2(sums, dst, width, divisor);
+#else
+    (void)kernel;
+#endif
+    ColumnDivideScalar(sums, dst, width, divisor, done);
+}
+
+}  // namespace
+
+const char* MaskKernelToString(MaskKernel kernel) {
+    switch (kernel) {
+        case MaskKernel::Auto:   return "auto";
+        case MaskKernel::Scalar: return "scalar";
+        case MaskKernel::Sse2:   return "sse2";
+        case MaskKernel::Avx2:   return "avx2";
+        default:                 return "unknown";
+    }
+}
+
+MaskKernel GetBestMaskKernel() {
+#if defined(VO_CPU_X86)
+    static const MaskKernel best = GetCpuFeatures().avx2 ? MaskKernel::Avx2 : MaskKernel::Sse2;
+    return best;
+#else
+    return MaskKernel::Scalar;
+#endif
+}
+
+void DilateMask(const uint8_t* src, uint8_t* dst, int width, int height, int radius, MaskKernel kernel) {
+    if (width <= 0 || height <= 0) {
+        return;
+    }
+    radius = std::clamp(radius, 0, MAX_DILATE_RADIUS);
+    size_t size = static_cast<size_t>(width) * height;
+    if (radius == 0) {
+        std::memcpy(dst, src, size);
+        return;
+    }
+    kernel = Resolve(kernel);
+    int taps = 2 * radius + 1;
+
+    // Horizontal pass into a temporary, through a zero-padded row buffer so
+    // every shifted load stays in bounds
+    std::vector<uint8_t> horizontal(size);
+    std::vector<uint8_t> padded(static_cast<size_t>(width) + 2 * radius, 0);
+    for (int y = 0; y < height; y++) {
+        std::memcpy(padded.data() + radius, src + static_cast<size_t>(y) * width, width);
+        DilateRow(kernel, padded.data(), horizontal.data() + static_cast<size_t>(y) * width, width, taps);
+    }
+
+    // Vertical pass: max of the rows in the window (clipped at the edges)
+    std::vector<const uint8_t*> rows(taps);
+    for (int y = 0; y < height; y++) {
+        int first = std::max(0, y - radius);
+        int last = std::min(height - 1, y + radius);
+        int count = 0;
+        for (int r = first; r <= last; r++) {
+            rows[count++] = horizontal.data() + static_cast<size_t>(r) * width;
+        }
+        MaxRows(kernel, rows.data(), count, dst + static_cast<size_t>(y) * width, width);
+    }
+}
+
+void BlurMask(uint8_t* mask, int width, int height, int radius, MaskKernel kernel) {
+    if (width <= 0 || height <= 0) {
+        return;
+    }
+    radius = std::clamp(radius, 0, MAX_BLUR_RADIUS);
+    if (radius == 0) {
+        return;
+    }
+    kernel = Resolve(kernel);
+    BoxDivisor divisor(2 * radius + 1);
+
+    // Horizontal pass: running sum per row (sequential by nature)
+    std::vector<uint8_t> horizontal(static_cast<size_t>(width) * height);
+    for (int y = 0; y < height; y++) {
+        const uint8_t* row = mask + static_cast<size_t>(y) * width;
+        uint8_t* out = horizontal.data() + static_cast<size_t>(y) * width;
+        uint32_t sum = 0;
+        for (int x = 0; x < std::min(radius, width); x++) {
+            sum += row[x];
+        }
+        for (int x = 0; x < width; x++) {
+            if (x + radius < width) sum += row[x + radius];
+            out[x] = divisor.Apply(sum);
+            if (x - radius >= 0) sum -= row[x - radius];
+        }
+    }
+
+    // Vertical pass: column sums updated one row at a time, vectorized across x
+    std::vector<uint16_t> sums(width, 0);
+    for (int y = 0; y < std::min(radius, height); y++) {
+        ColumnSumStep(kernel, sums.data(), horizontal.data() + static_cast<size_t>(y) * width, nullptr, width);
+    }
+    for (int y = 0; y < height; y++) {
+        const uint8_t* add = (y + radius < height)
+            ? horizontal.data() + static_cast<size_t>(y + radius) * width : nullptr;
+        ColumnSumStep(kernel, sums.data(), add, nullptr, width);
+        ColumnDivide(kernel, sums.data(), mask + static_cast<size_t>(y) * width, width, divisor);
+        if (y - radius >= 0) {
+            ColumnSumStep(kernel, sums.data(), nullptr,
+                          horizontal.data() + static_cast<size_t>(y - radius) * width, width);
+        }
+    }
+}
+
+}  // namespace VirtualOverlay
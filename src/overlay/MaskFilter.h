@@ -0,0 +1,45 @@
+#pragma once
+
+// 8-bit coverage mask filters for text outlines and glows.
+//
+// The label is rasterized once as a coverage mask; the outline is that mask
+// dilated with a separable max-filter (a (2r+1)^2 square, the same shape the
+// old eight offset DrawText calls produced at r = 1), and an optional glow is
+// a separable box blur of the dilated mask.
+//
+// Dilation and the vertical blur pass have SSE2 and AVX2 versions, chosen at
+// runtime; every kernel produces bit-identical output to the scalar one.
+// Masks are row-major with stride == width.
+// Platform-independent (no <windows.h>).
+
+#include <cstddef>
+#include <cstdint>
+
+namespace VirtualOverlay {
+
+enum class MaskKernel {
+    Auto,    // Best available on this CPU
+    Scalar,
+    Sse2,
+    Avx2
+};
+
+const char* MaskKernelToString(MaskKernel kernel);
+
+// Best kernel this CPU supports (detected once)
+MaskKernel GetBestMaskKernel();
+
+constexpr int MAX_DILATE_RADIUS = 16;
+constexpr int MAX_BLUR_RADIUS = 64;
+
+// dst = max of src over a (2r+1) x (2r+1) square; pixels outside are 0.
+// src and dst must not overlap. radius is clamped to [0, MAX_DILATE_RADIUS].
+void DilateMask(const uint8_t* src, uint8_t* dst, int width, int height, int radius,
+                MaskKernel kernel = MaskKernel::Auto);
+
+// In-place separable box blur with a (2r+1) window; pixels outside are 0.
+// radius is clamped to [0, MAX_BLUR_RADIUS].
+void BlurMask(uint8_t* mask, int width, int height, int radius,
+              MaskKernel kernel = MaskKernel::Auto);
+
+}  // namespace VirtualOverlay
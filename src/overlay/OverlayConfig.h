@@ -59,11 +59,17 @@ struct OverlaySettings {
     int watermarkFontSize = 72;
     float watermarkOpacity = 0.25f;
     bool watermarkShadow = true;
+    int watermarkOutlineWidth = 1;
+    int watermarkGlowRadius = 0;
+    bool distanceFieldText = true;  // Reuse shaped labels across sizes
     uint32_t watermarkColor = 0xFFFFFF;  // White by default
     
     // Dodge mode - move overlay when mouse approaches
     bool dodgeOnHover = false;
     int dodgeProximity = 100;  // pixels
+
+    // Rasterized label cache budget (watermark mode), 0 disables
+    int labelCacheKB = 8192;
     
     OverlayStyleSettings style;
     OverlayTextSettings text;
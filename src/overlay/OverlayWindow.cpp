@@ -5,7 +5,7 @@
 #include "../utils/Monitor.h"
 #include "../desktop/VirtualDesktop.h"
 #include <algorithm>
-#include <regex>
+#include <cstring>
 
 namespace VirtualOverlay {
 
@@ -77,6 +77,18 @@ bool OverlayWindow::Init(HINSTANCE hInstance) {
         return false;
     }
 
+    m_textMetrics.SetProvider(&MeasureTextWithDirectWrite);
+
+    // Labels are shaped and rasterized off the UI thread; finished ones come
+    // back as WM_OVERLAY_LABEL_READY
+    HWND hwnd = m_hwnd;
+    m_renderWorker.Start(
+        [this](const RenderRequest& request, LabelBitmap& bitmap) {
+            return m_rasterizer.Rasterize(request, bitmap);
+        },
+        [hwnd]() { PostMessageW(hwnd, WM_OVERLAY_LABEL_READY, 0, 0); },
+        [this]() { m_rasterizer.ReleaseResources(); });
+
     // Create render resources
     if (!CreateRenderResources()) {
         LOG_WARN("Failed to create initial render resources");
@@ -103,8 +115,33 @@ void OverlayWindow::Shutdown() {
     KillTimer(m_hwnd, TIMER_OVERLAY_ANIMATION);
     KillTimer(m_hwnd, TIMER_OVERLAY_AUTOHIDE);
     KillTimer(m_hwnd, TIMER_OVERLAY_DODGE);
+    KillTimer(m_hwnd, TIMER_OVERLAY_UPDATE);
+
+    // Rasterizer state is only read once the worker has stopped
+    m_renderWorker.Stop();
+
+    const UpdateCoalescerStats& updateStats = m_updateCoalescer.GetStats();
+    LOG_INFO("Overlay updates: %llu received, %llu rendered, %llu superseded, %llu ms max wait",
+             updateStats.received, updateStats.rendered, updateStats.superseded, updateStats.maxWaitMs);
+    RenderWorkerStats workerStats = m_renderWorker.GetStats();
+    const LatencyHistogram& latency = m_renderWorker.GetLatency();
+    LOG_INFO("Label worker: %llu requests, %llu presented, %llu superseded, %llu warmed (%llu dropped), %llu failed, %llu rejected; latency p50 < %llu us, p99 < %llu us",
+             workerStats.submitted, workerStats.presented, workerStats.superseded, workerStats.warmed,
+             workerStats.warmDropped, workerStats.failed, workerStats.rejected,
+             latency.GetPercentileBound(0.5), latency.GetPercentileBound(0.99));
+    const LabelCacheStats& labelStats = m_labelCache.GetStats();
+    LOG_INFO("Label cache: %llu hits, %llu misses, %llu evictions, %zu bytes",
+             labelStats.hits, labelStats.misses, labelStats.evictions, labelStats.bytes);
+    const DistanceFieldAtlasStats& fieldStats = m_rasterizer.GetDistanceFields().GetStats();
+    LOG_INFO("Distance fields: %llu hits, %llu misses, %llu builds, %zu bytes",
+             fieldStats.hits, fieldStats.misses, fieldStats.builds, fieldStats.bytes);
+    const TextMetricsCacheStats& metricsStats = m_textMetrics.GetStats();
+    LOG_INFO("Text metrics: %llu hits, %llu misses, %llu failures",
+             metricsStats.hits, metricsStats.misses, metricsStats.failures);
 
     DiscardRenderResources();
+    m_surfacePool.Clear();
+    m_textMetrics.Clear();
 
     if (m_hwnd) {
         DestroyWindow(m_hwnd);
@@ -126,6 +163,30 @@ void OverlayWindow::Show(int desktopIndex, const std::wstring& desktopName) {
         return;
     }
 
+    OverlayUpdate update;
+    update.desktopIndex = desktopIndex;
+    update.desktopName = desktopName;
+    m_updateCoalescer.Submit(update, GetTickCount64());
+    PumpUpdates();
+}
+
+void OverlayWindow::PumpUpdates() {
+    uint64_t now = GetTickCount64();
+    OverlayUpdate update;
+    if (m_updateCoalescer.Take(now, update)) {
+        Present(update.desktopIndex, update.desktopName);
+    }
+
+    uint64_t dueMs;
+    if (!m_updateCoalescer.GetNextDeadline(dueMs)) {
+        KillTimer(m_hwnd, TIMER_OVERLAY_UPDATE);
+        return;
+    }
+    UINT delay = (dueMs > now) ? static_cast<UINT>(dueMs - now) : USER_TIMER_MINIMUM;
+    SetTimer(m_hwnd, TIMER_OVERLAY_UPDATE, std::max<UINT>(delay, USER_TIMER_MINIMUM), nullptr);
+}
+
+void OverlayWindow::Present(int desktopIndex, const std::wstring& desktopName) {
     m_state.currentDesktopIndex = desktopIndex;
     m_state.currentDesktopName = desktopName;
 
@@ -182,6 +243,10 @@ void OverlayWindow::Hide() {
         return;
     }
 
+    // A coalesced Show still waiting would bring the overlay back
+    m_updateCoalescer.Reset();
+    KillTimer(m_hwnd, TIMER_OVERLAY_UPDATE);
+
     if (m_state.state == OverlayState::Hidden || m_state.state == OverlayState::FadeOut) {
         return;
     }
@@ -222,10 +287,24 @@ void OverlayWindow::ApplySettings(const OverlaySettings& settings) {
              static_cast<int>(settings.monitor), settings.enabled ? 1 : 0);
     
     m_settings = settings;
+    if (settings.format != m_displayFormat.GetSource()) {
+        m_displayFormat.Compile(settings.format);
+    }
+
+    // Requests carry the style; labels of an older style are never shown
+    // again, so the cache drops them with it
+    LabelStyle labelStyle = GetLabelStyle();
+    if (labelStyle != m_labelStyle) {
+        m_labelCache.Clear();
+    }
+    m_labelStyle = labelStyle;
+    m_labelCache.SetBudget(static_cast<size_t>(std::max(settings.labelCacheKB, 0)) * 1024);
 
     // Reset resources that depend on settings (font size, opacity)
     m_textFormat.Reset();
-    m_textBrush.Reset();
+
+    // Pooled watermark surfaces keep their bitmaps; labels are redone
+    m_watermarkStyleVersion++;
 
     // Reapply blur effect (not for watermark mode - needs transparent background)
     if (m_hwnd) {
@@ -292,12 +371,20 @@ LRESULT OverlayWindow::HandleMessage(HWND hwnd, UINT msg, WPARAM wParam, LPARAM
                 OnAutoHideTimer();
             } else if (wParam == TIMER_OVERLAY_DODGE) {
                 OnDodgeTimer();
+            } else if (wParam == TIMER_OVERLAY_UPDATE) {
+                PumpUpdates();
             }
             return 0;
 
+        case WM_OVERLAY_LABEL_READY:
+            OnLabelReady();
+            return 0;
+
         case WM_SIZE:
-            DiscardRenderResources();
-            CreateRenderResources();
+            // Same target at the new size: keeps the brush and text format
+            if (m_renderTarget) {
+                m_renderTarget->Resize(D2D1::SizeU(LOWORD(lParam), HIWORD(lParam)));
+            }
             return 0;
 
         case WM_DISPLAYCHANGE:
@@ -334,29 +421,6 @@ bool OverlayWindow::CreateRenderResources() {
         m_renderTarget.Attach(pRT);
     }
 
-    // Create text brush - watermark mode uses specific opacity
-    if (!m_textBrush) {
-        float textOpacity = (m_settings.mode == OverlayMode::Watermark) 
-            ? m_settings.watermarkOpacity : 1.0f;
-        D2D1_COLOR_F textColor = D2DRenderer::ColorFromRGB(m_settings.text.color, textOpacity);
-        m_renderTarget->CreateSolidColorBrush(textColor, m_textBrush.GetAddressOf());
-    }
-
-    // Create background brush (not used in watermark mode but create anyway)
-    if (!m_backgroundBrush) {
-        D2D1_COLOR_F bgColor = D2DRenderer::ColorFromRGB(
-            m_settings.style.tintColor, 
-            m_settings.style.tintOpacity
-        );
-        m_renderTarget->CreateSolidColorBrush(bgColor, m_backgroundBrush.GetAddressOf());
-    }
-
-    // Create border brush
-    if (!m_borderBrush) {
-        D2D1_COLOR_F borderColor = D2DRenderer::ColorFromRGB(m_settings.style.borderColor);
-        m_renderTarget->CreateSolidColorBrush(borderColor, m_borderBrush.GetAddressOf());
-    }
-
     // Create text format - watermark mode uses larger font
     if (!m_textFormat) {
         IDWriteTextFormat* pFormat = nullptr;
@@ -377,126 +441,206 @@ bool OverlayWindow::CreateRenderResources() {
 }
 
 void OverlayWindow::DiscardRenderResources() {
+    m_renderBackend.Reset();
     m_textFormat.Reset();
-    m_borderBrush.Reset();
-    m_backgroundBrush.Reset();
-    m_textBrush.Reset();
     m_renderTarget.Reset();
 }
 
 void OverlayWindow::Render() {
-    if (!m_renderTarget) {
+    // The watermark window is layered and fed by UpdateLayeredWindow; a paint
+    // (display change, redraw) just re-presents the label
+    if (m_settings.mode == OverlayMode::Watermark) {
+        RenderWatermark();
+        return;
+    }
+
+    // Creates whatever ApplySettings or a device loss reset
+    if (!m_renderTarget || !m_textFormat) {
         if (!CreateRenderResources()) {
             return;
         }
     }
 
-    m_renderTarget->BeginDraw();
+    D2D1_SIZE_F size = m_renderTarget->GetSize();
+    OverlayFrame frame = BuildOverlayFrame(static_cast<int>(size.width), static_cast<int>(size.height));
+    m_renderBackend.Attach(m_renderTarget.Get(), m_textFormat.Get());
+    if (!DrawOverlayFrame(m_renderBackend, frame) && m_renderBackend.NeedsRecreate()) {
+        DiscardRenderResources();
+    }
+}
+
+OverlayFrame OverlayWindow::BuildOverlayFrame(int width, int height) {
+    OverlayFrame frame;
+    frame.width = width;
+    frame.height = height;
+    frame.cornerRadius = static_cast<float>(m_settings.style.cornerRadius);
+    frame.padding = static_cast<float>(m_settings.style.padding);
+    frame.background = RenderColor::FromRGB(m_settings.style.tintColor, m_settings.style.tintOpacity);
+    frame.border = RenderColor::FromRGB(m_settings.style.borderColor);
+    frame.borderWidth = static_cast<float>(m_settings.style.borderWidth);
+    frame.text = FormatDisplayText();
+    frame.textColor = RenderColor::FromRGB(m_settings.text.color);
+    frame.slideOffset = m_state.slideOffset;
+    frame.opacity = m_state.opacity;
+    return frame;
+}
+
+void OverlayWindow::RenderWatermark() {
+    // Per-pixel alpha: the worker rasterizes a 32-bit premultiplied label,
+    // which is copied into a DIB and handed to UpdateLayeredWindow
+    int width = m_windowWidth;
+    int height = m_windowHeight;
     
-    // Clear background - use black for watermark mode (will be color-keyed out)
-    if (m_settings.mode == OverlayMode::Watermark) {
-        m_renderTarget->Clear(D2D1::ColorF(0, 0, 0, 1.0f));  // Solid black (color key)
-    } else {
-        m_renderTarget->Clear(D2D1::ColorF(0, 0, 0, 0));  // Transparent
+    LOG_DEBUG("RenderWatermark: width=%d, height=%d", width, height);
+    
+    if (width <= 0 || height <= 0) {
+        LOG_ERROR("RenderWatermark: Invalid dimensions");
+        return;
     }
-    m_renderTarget->SetTextAntialiasMode(D2D1_TEXT_ANTIALIAS_MODE_DEFAULT);
 
-    D2D1_SIZE_F size = m_renderTarget->GetSize();
-    float padding = static_cast<float>(m_settings.style.padding);
-    float radius = static_cast<float>(m_settings.style.cornerRadius);
+    std::wstring displayText = FormatDisplayText();
 
-    // In watermark mode, skip background and border
-    if (m_settings.mode != OverlayMode::Watermark) {
-        // Background rounded rect
-        D2D1_ROUNDED_RECT bgRect = D2D1::RoundedRect(
-            D2D1::RectF(0, 0, size.width, size.height),
-            radius, radius
-        );
-
-        // Draw background (if solid style or as fallback)
-        if (m_backgroundBrush) {
-            m_renderTarget->FillRoundedRectangle(bgRect, m_backgroundBrush.Get());
+    // A pooled surface may still hold this label (dodge moves, re-shows)
+    WatermarkSurface* surface = AcquireWatermarkSurface(width, height);
+    if (!surface) {
+        return;
+    }
+    bool ready = HoldsLabel(*surface, displayText);
+    if (!ready) {
+        // A label shown or warmed before is copied in and shown right here,
+        // without a round-trip through the worker
+        CollectWarmedLabels();
+        if (const LabelBitmap* cached = m_labelCache.Find(MakeLabelKey(displayText, width, height))) {
+            CopyLabel(*cached, displayText, *surface);
+            ready = true;
         }
+    }
+    if (ready) {
+        PresentWatermark(*surface);
+    }
+    m_surfacePool.Release(surface, GetTickCount64());
 
-        // Draw border
-        if (m_borderBrush && m_settings.style.borderWidth > 0) {
-            m_renderTarget->DrawRoundedRectangle(bgRect, m_borderBrush.Get(), 
-                static_cast<float>(m_settings.style.borderWidth));
+    if (!ready) {
+        SubmitLabel(RenderRequestKind::Present, displayText, width, height);
+    }
+}
+
+bool OverlayWindow::SubmitLabel(RenderRequestKind kind, const std::wstring& text, int width, int height) {
+    RenderRequest request;
+    request.kind = kind;
+    request.key = MakeLabelKey(text, width, height);
+    if (kind == RenderRequestKind::Warm) {
+        CollectWarmedLabels();
+        if (m_labelCache.Contains(request.key)) {
+            return true;  // Already warm
         }
     }
+    if (!m_renderWorker.Submit(std::move(request))) {
+        LOG_DEBUG("Label worker warm queue full, request dropped");
+        return false;
+    }
+    return true;
+}
 
-    // Draw text
-    if (m_textBrush && m_textFormat) {
-        std::wstring displayText = FormatDisplayText();
-        
-        D2D1_RECT_F textRect = D2D1::RectF(
-            padding, 
-            padding + m_state.slideOffset,  // Apply slide offset
-            size.width - padding, 
-            size.height - padding + m_state.slideOffset
-        );
-
-        // In watermark mode, optionally draw a thin outline for readability (not a shadow fill)
-        if (m_settings.mode == OverlayMode::Watermark && m_settings.watermarkShadow) {
-            Microsoft::WRL::ComPtr<ID2D1SolidColorBrush> outlineBrush;
-            m_renderTarget->CreateSolidColorBrush(
-                D2D1::ColorF(0, 0, 0, m_settings.watermarkOpacity * 0.7f),
-                outlineBrush.GetAddressOf()
-            );
-            if (outlineBrush) {
-                // Draw thin outline offsets
-                for (float dx = -1.0f; dx <= 1.0f; dx += 1.0f) {
-                    for (float dy = -1.0f; dy <= 1.0f; dy += 1.0f) {
-                        if (dx == 0 && dy == 0) continue;
-                        D2D1_RECT_F outlineRect = textRect;
-                        outlineRect.left += dx;
-                        outlineRect.top += dy;
-                        outlineRect.right += dx;
-                        outlineRect.bottom += dy;
-                        m_renderTarget->DrawText(
-                            displayText.c_str(),
-                            static_cast<UINT32>(displayText.length()),
-                            m_textFormat.Get(),
-                            outlineRect,
-                            outlineBrush.Get()
-                        );
-                    }
-                }
-            }
+void OverlayWindow::CollectWarmedLabels() {
+    RenderResult warmed;
+    while (m_renderWorker.TakeWarmResult(warmed)) {
+        if (warmed.key.style == m_labelStyle) {
+            m_labelCache.Insert(warmed.key, std::move(warmed.bitmap));
         }
+    }
+}
+
+void OverlayWindow::CopyLabel(const LabelBitmap& label, const std::wstring& text, WatermarkSurface& surface) {
+    GdiFlush();
+    memcpy(surface.bits, label.pixels.data(), label.GetBytes());
+    surface.text = text;
+    surface.styleVersion = m_watermarkStyleVersion;
+}
 
-        m_renderTarget->DrawText(
-            displayText.c_str(),
-            static_cast<UINT32>(displayText.length()),
-            m_textFormat.Get(),
-            textRect,
-            m_textBrush.Get()
-        );
+void OverlayWindow::OnLabelReady() {
+    const RenderResult* result = m_renderWorker.TakeResult();
+    if (!result || !result->ok) {
+        return;
     }
 
-    HRESULT hr = m_renderTarget->EndDraw();
-    if (hr == D2DERR_RECREATE_TARGET) {
-        DiscardRenderResources();
+    // Kept for next time even if it is no longer wanted below
+    if (result->key.style == m_labelStyle) {
+        m_labelCache.Insert(result->key, LabelBitmap(result->bitmap));
     }
-}
 
-void OverlayWindow::RenderWatermark() {
-    // Use GDI+ or UpdateLayeredWindow for per-pixel alpha transparency
-    // Create a 32-bit ARGB bitmap and render to it
-    
-    int width = m_windowWidth;
-    int height = m_windowHeight;
-    
-    LOG_DEBUG("RenderWatermark: width=%d, height=%d", width, height);
-    
-    if (width <= 0 || height <= 0) {
-        LOG_ERROR("RenderWatermark: Invalid dimensions");
+    // Only present the label the overlay still wants: newer switches,
+    // settings changes and Hide make older results stale
+    if (m_settings.mode != OverlayMode::Watermark || m_state.state == OverlayState::Hidden) {
         return;
     }
-    
+    const LabelBitmap& label = result->bitmap;
+    LabelKey wanted = MakeLabelKey(FormatDisplayText(), m_windowWidth, m_windowHeight);
+    if (result->key != wanted || label.width != m_windowWidth || label.height != m_windowHeight) {
+        LOG_DEBUG("Discarding stale label (sequence %llu)", result->sequence);
+        return;
+    }
+
+    WatermarkSurface* surface = AcquireWatermarkSurface(label.width, label.height);
+    if (!surface) {
+        return;
+    }
+    CopyLabel(label, result->key.text, *surface);
+    PresentWatermark(*surface);
+    m_surfacePool.Release(surface, GetTickCount64());
+}
+
+OverlayWindow::WatermarkSurface* OverlayWindow::AcquireWatermarkSurface(int width, int height) {
+    ULONGLONG now = GetTickCount64();
+    WatermarkSurface* surface = m_surfacePool.Acquire(width, height, now);
+    if (surface) {
+        return surface;
+    }
+
+    WatermarkSurface created;
+    if (!CreateWatermarkSurface(width, height, created)) {
+        ReleaseSurface(created);
+        return nullptr;
+    }
+    surface = m_surfacePool.Adopt(width, height, std::move(created), now);
+
+    const SurfacePoolStats& stats = m_surfacePool.GetStats();
+    LOG_DEBUG("Watermark surface created: %dx%d (pool: %llu reused / %llu acquires, %zu bytes)",
+              width, height, stats.reuses, stats.acquires, stats.bytes);
+    return surface;
+}
+
+bool OverlayWindow::HoldsLabel(const WatermarkSurface& surface, const std::wstring& text) const {
+    return surface.styleVersion == m_watermarkStyleVersion && surface.text == text;
+}
+
+LabelStyle OverlayWindow::GetLabelStyle() const {
+    LabelStyle style;
+    style.fontFamily = m_settings.text.fontFamily;
+    style.fontSize = m_settings.watermarkFontSize;
+    style.fontWeight = m_settings.text.fontWeight;
+    style.color = m_settings.watermarkColor;
+    style.opacity = m_settings.watermarkOpacity;
+    style.outlineWidth = m_settings.watermarkShadow ? m_settings.watermarkOutlineWidth : 0;
+    style.glowRadius = m_settings.watermarkShadow ? m_settings.watermarkGlowRadius : 0;
+    style.distanceField = m_settings.distanceFieldText;
+    style.padding = m_settings.style.padding;
+    return style;
+}
+
+LabelKey OverlayWindow::MakeLabelKey(const std::wstring& text, int width, int height) const {
+    LabelKey key;
+    key.text = text;
+    key.style = m_labelStyle;
+    key.width = width;
+    key.height = height;
+    return key;
+}
+
+bool OverlayWindow::CreateWatermarkSurface(int width, int height, WatermarkSurface& surface) {
     // Create compatible DC
     HDC hdcScreen = GetDC(nullptr);
-    HDC hdcMem = CreateCompatibleDC(hdcScreen);
+    surface.hdc = CreateCompatibleDC(hdcScreen);
     
     // Create 32-bit ARGB bitmap
     BITMAPINFO bmi = {};
@@ -508,94 +652,26 @@ void OverlayWindow::RenderWatermark() {
     bmi.bmiHeader.biCompression = BI_RGB;
     
     void* pvBits = nullptr;
-    HBITMAP hBitmap = CreateDIBSection(hdcScreen, &bmi, DIB_RGB_COLORS, &pvBits, nullptr, 0);
-    if (!hBitmap) {
-        DeleteDC(hdcMem);
-        ReleaseDC(nullptr, hdcScreen);
-        return;
-    }
-    
-    HBITMAP hOldBitmap = (HBITMAP)SelectObject(hdcMem, hBitmap);
-    
-    // Clear to transparent
-    memset(pvBits, 0, width * height * 4);
-    
-    // Create D2D DC render target
-    auto& renderer = D2DRenderer::Instance();
-    ID2D1Factory* pFactory = renderer.GetD2DFactory();
-    
-    D2D1_RENDER_TARGET_PROPERTIES rtProps = D2D1::RenderTargetProperties(
-        D2D1_RENDER_TARGET_TYPE_DEFAULT,
-        D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED),
-        0, 0,
-        D2D1_RENDER_TARGET_USAGE_NONE,
-        D2D1_FEATURE_LEVEL_DEFAULT
-    );
-    
-    ComPtr<ID2D1DCRenderTarget> dcRT;
-    HRESULT hr = pFactory->CreateDCRenderTarget(&rtProps, dcRT.GetAddressOf());
-    if (FAILED(hr)) {
-        SelectObject(hdcMem, hOldBitmap);
-        DeleteObject(hBitmap);
-        DeleteDC(hdcMem);
-        ReleaseDC(nullptr, hdcScreen);
-        return;
-    }
-    
-    RECT rcBind = { 0, 0, width, height };
-    hr = dcRT->BindDC(hdcMem, &rcBind);
-    if (FAILED(hr)) {
-        SelectObject(hdcMem, hOldBitmap);
-        DeleteObject(hBitmap);
-        DeleteDC(hdcMem);
-        ReleaseDC(nullptr, hdcScreen);
-        return;
-    }
-    
-    // Create text format
-    IDWriteTextFormat* pFormat = nullptr;
-    DWRITE_FONT_WEIGHT weight = static_cast<DWRITE_FONT_WEIGHT>(m_settings.text.fontWeight);
-    renderer.CreateTextFormat(
-        m_settings.text.fontFamily,
-        static_cast<float>(m_settings.watermarkFontSize),
-        weight,
-        &pFormat
-    );
-    ComPtr<IDWriteTextFormat> textFormat;
-    textFormat.Attach(pFormat);
-    
-    // Create text brush with watermark color and opacity
-    ComPtr<ID2D1SolidColorBrush> textBrush;
-    D2D1_COLOR_F textColor = D2DRenderer::ColorFromRGB(m_settings.watermarkColor, m_settings.watermarkOpacity);
-    dcRT->CreateSolidColorBrush(textColor, textBrush.GetAddressOf());
-    
-    // Render text
-    dcRT->BeginDraw();
-    dcRT->Clear(D2D1::ColorF(0, 0, 0, 0));  // Transparent
-    
-    std::wstring displayText = FormatDisplayText();
-    float padding = static_cast<float>(m_settings.style.padding);
-    D2D1_RECT_F textRect = D2D1::RectF(padding, padding, 
-        static_cast<float>(width) - padding, static_cast<float>(height) - padding);
-    
-    if (textFormat && textBrush) {
-        dcRT->DrawText(
-            displayText.c_str(),
-            static_cast<UINT32>(displayText.length()),
-            textFormat.Get(),
-            textRect,
-            textBrush.Get()
-        );
+    surface.bitmap = CreateDIBSection(hdcScreen, &bmi, DIB_RGB_COLORS, &pvBits, nullptr, 0);
+    ReleaseDC(nullptr, hdcScreen);
+    if (!surface.hdc || !surface.bitmap) {
+        return false;
     }
+    surface.bits = pvBits;
     
-    dcRT->EndDraw();
-    
+    surface.oldBitmap = (HBITMAP)SelectObject(surface.hdc, surface.bitmap);
+    surface.width = width;
+    surface.height = height;
+    return true;
+}
+
+void OverlayWindow::PresentWatermark(const WatermarkSurface& surface) {
     // Get window position
     RECT rcWindow;
     GetWindowRect(m_hwnd, &rcWindow);
     POINT ptSrc = { 0, 0 };
     POINT ptDst = { rcWindow.left, rcWindow.top };
-    SIZE sizeWnd = { width, height };
+    SIZE sizeWnd = { surface.width, surface.height };
     
     BLENDFUNCTION blend = {};
     blend.BlendOp = AC_SRC_OVER;
@@ -603,20 +679,62 @@ void OverlayWindow::RenderWatermark() {
     blend.SourceConstantAlpha = 255;
     blend.AlphaFormat = AC_SRC_ALPHA;
     
-    BOOL result = UpdateLayeredWindow(m_hwnd, hdcScreen, &ptDst, &sizeWnd, hdcMem, &ptSrc, 0, &blend, ULW_ALPHA);
+    HDC hdcScreen = GetDC(nullptr);
+    BOOL result = UpdateLayeredWindow(m_hwnd, hdcScreen, &ptDst, &sizeWnd, surface.hdc, &ptSrc, 0, &blend, ULW_ALPHA);
     if (!result) {
         LOG_ERROR("UpdateLayeredWindow failed: %lu", GetLastError());
     } else {
-        LOG_DEBUG("UpdateLayeredWindow success: pos=(%ld,%ld) size=(%d,%d)", ptDst.x, ptDst.y, width, height);
+        LOG_DEBUG("UpdateLayeredWindow success: pos=(%ld,%ld) size=(%d,%d)", ptDst.x, ptDst.y,
+                  surface.width, surface.height);
     }
-    
-    // Cleanup
-    SelectObject(hdcMem, hOldBitmap);
-    DeleteObject(hBitmap);
-    DeleteDC(hdcMem);
     ReleaseDC(nullptr, hdcScreen);
 }
 
+void OverlayWindow::ReleaseSurface(WatermarkSurface& surface) {
+    if (surface.hdc) {
+        if (surface.oldBitmap) {
+            SelectObject(surface.hdc, surface.oldBitmap);
+        }
+        DeleteDC(surface.hdc);
+    }
+    if (surface.bitmap) {
+        DeleteObject(surface.bitmap);
+    }
+    surface = WatermarkSurface();
+}
+
+void OverlayWindow::Prerender(int desktopIndex, const std::wstring& desktopName) {
+    // Notification mode draws through the window's render target on WM_PAINT;
+    // only the watermark label can be prepared off-screen. The worker keeps
+    // it, so the Show that follows is just a copy.
+    if (!m_initialized || !m_settings.enabled || m_settings.mode != OverlayMode::Watermark) {
+        return;
+    }
+
+    const std::wstring& displayText = FormatDisplayText(desktopIndex, desktopName);
+    int width, height;
+    CalculateWindowSize(displayText, width, height);
+    if (!SubmitLabel(RenderRequestKind::Warm, displayText, width, height)) {
+        LOG_DEBUG("Prerender failed for desktop %d", desktopIndex);
+    }
+}
+
+void OverlayWindow::WarmLabelCache(const std::vector<std::pair<int, std::wstring>>& desktops) {
+    if (!m_initialized || m_settings.mode != OverlayMode::Watermark || m_labelCache.GetBudget() == 0) {
+        return;
+    }
+
+    // The worker rasterizes them after any pending Present
+    for (const auto& desktop : desktops) {
+        std::wstring text = FormatDisplayText(desktop.first, desktop.second);
+        int width, height;
+        CalculateWindowSize(text, width, height);
+        if (!SubmitLabel(RenderRequestKind::Warm, text, width, height)) {
+            break;
+        }
+    }
+}
+
 void OverlayWindow::StartFadeIn() {
     m_state.state = OverlayState::FadeIn;
     m_state.stateStartTime = GetTickCount();
@@ -660,10 +778,12 @@ void OverlayWindow::UpdateAnimation() {
             m_state.slideOffset = startOffset * (1.0f - easedProgress);
         }
 
-        // Update window opacity
+        // Update window opacity; the fade itself needs no redraw, only the slide does
         SetLayeredWindowAttributes(m_hwnd, 0, 
             static_cast<BYTE>(m_state.opacity * 255.0f), LWA_ALPHA);
-        InvalidateRect(m_hwnd, nullptr, FALSE);
+        if (m_settings.animation.slideIn) {
+            InvalidateRect(m_hwnd, nullptr, FALSE);
+        }
 
         if (progress >= 1.0f) {
             // Fade-in complete
@@ -823,21 +943,7 @@ void OverlayWindow::CalculateWindowPosition(int& x, int& y, int width, int heigh
     if (m_isDodging && (m_dodgeMonitorRect.right - m_dodgeMonitorRect.left) > 0) {
         monitorRect = m_dodgeMonitorRect;
     } else {
-        const MonitorInfo* targetMonitor = nullptr;
-
-        switch (m_settings.monitor) {
-            case MonitorSelection::Cursor:
-                targetMonitor = Monitor::Instance().GetAtCursor();
-                break;
-            case MonitorSelection::Primary:
-                targetMonitor = Monitor::Instance().GetPrimary();
-                break;
-            case MonitorSelection::All:
-                // For 'all', use primary for position calculation
-                targetMonitor = Monitor::Instance().GetPrimary();
-                break;
-        }
-
+        const MonitorInfo* targetMonitor = GetTargetMonitor();
         if (targetMonitor) {
             monitorRect = targetMonitor->workArea;
         } else {
@@ -854,6 +960,10 @@ void OverlayWindow::CalculateWindowPosition(int& x, int& y, int width, int heigh
 
     // Calculate position based on setting
     int margin = 20;  // Margin from edges
+    if (m_settings.mode == OverlayMode::Watermark) {
+        // The label bitmap is fitted to the ink: keep the padding outside it
+        margin += m_settings.style.padding;
+    }
 
     switch (m_settings.position) {
         case OverlayPosition::TopLeft:
@@ -899,67 +1009,96 @@ void OverlayWindow::CalculateWindowPosition(int& x, int& y, int width, int heigh
 void OverlayWindow::UpdateWindowPosition() {
     if (!m_hwnd) return;
 
-    // Calculate content size based on mode and actual text
-    int contentWidth, contentHeight;
-    
-    if (m_settings.mode == OverlayMode::Watermark) {
-        // Watermark mode: measure actual text width
-        std::wstring displayText = FormatDisplayText();
-        size_t textLen = displayText.length();
-        if (textLen == 0) textLen = 10;  // Default assumption
-        
-        // Approximate character width is about 60% of font size for most fonts
-        float charWidth = m_settings.watermarkFontSize * 0.6f;
-        contentWidth = static_cast<int>(charWidth * textLen) + m_settings.style.padding * 2;
-        contentHeight = m_settings.watermarkFontSize + 20; // Font height + margin
-    } else {
-        // Notification mode: standard size
-        contentWidth = 200;  // Minimum width
-        contentHeight = 60;  // Minimum height
-    }
-
-    m_windowWidth = contentWidth + m_settings.style.padding * 2;
-    m_windowHeight = contentHeight;
+    CalculateWindowSize(FormatDisplayText(), m_windowWidth, m_windowHeight);
 
     int x, y;
     CalculateWindowPosition(x, y, m_windowWidth, m_windowHeight);
 
+    // A size change resizes the render target in WM_SIZE
     SetWindowPos(m_hwnd, HWND_TOPMOST, x, y, m_windowWidth, m_windowHeight, 
         SWP_NOACTIVATE);
+}
 
-    // Recreate render target for new size
-    DiscardRenderResources();
-    CreateRenderResources();
+void OverlayWindow::CalculateWindowSize(const std::wstring& displayText, int& width, int& height) {
+    if (m_settings.mode == OverlayMode::Watermark) {
+        // Watermark mode: fit the bitmap to the measured ink plus the halo
+        TextMetrics metrics;
+        if (MeasureLabel(displayText, metrics)) {
+            FitInkBounds(metrics, GetLabelMargin(), width, height);
+            return;
+        }
+
+        // No DirectWrite: approximate characters as 60% of the font size
+        size_t textLen = displayText.length();
+        if (textLen == 0) textLen = 10;  // Default assumption
+        float charWidth = m_settings.watermarkFontSize * 0.6f;
+        width = static_cast<int>(charWidth * textLen) + GetLabelMargin() * 2;
+        height = m_settings.watermarkFontSize + 20; // Font height + margin
+        return;
+    }
+
+    // Notification mode: standard size
+    int contentWidth = 200;  // Minimum width
+    int contentHeight = 60;  // Minimum height
+    width = contentWidth + m_settings.style.padding * 2;
+    height = contentHeight;
 }
 
-std::wstring OverlayWindow::FormatDisplayText() {
-    std::wstring result = m_settings.format;
+bool OverlayWindow::MeasureLabel(const std::wstring& text, TextMetrics& metrics) {
+    TextMetricsKey key;
+    key.text = text;
+    key.fontFamily = m_settings.text.fontFamily;
+    key.fontSize = static_cast<float>(m_settings.watermarkFontSize);
+    key.fontWeight = m_settings.text.fontWeight;
+    return m_textMetrics.Measure(key, metrics);
+}
 
-    // Replace {number} with desktop index
-    std::wstring numberStr = std::to_wstring(m_state.currentDesktopIndex);
-    size_t pos = result.find(L"{number}");
-    while (pos != std::wstring::npos) {
-        result.replace(pos, 8, numberStr);
-        pos = result.find(L"{number}", pos + numberStr.length());
+int OverlayWindow::GetLabelMargin() const {
+    // Room for the outline and glow around the ink, plus a pixel for
+    // antialiasing that spills past the overhang metrics
+    int halo = 0;
+    if (m_settings.watermarkShadow) {
+        halo = m_settings.watermarkOutlineWidth + m_settings.watermarkGlowRadius;
     }
+    return halo + 1;
+}
 
-    // Replace {name} with desktop name
-    pos = result.find(L"{name}");
-    while (pos != std::wstring::npos) {
-        result.replace(pos, 6, m_state.currentDesktopName);
-        pos = result.find(L"{name}", pos + m_state.currentDesktopName.length());
+const MonitorInfo* OverlayWindow::GetTargetMonitor() const {
+    switch (m_settings.monitor) {
+        case MonitorSelection::Cursor:
+            return Monitor::Instance().GetAtCursor();
+        case MonitorSelection::Primary:
+            return Monitor::Instance().GetPrimary();
+        case MonitorSelection::All:
+            // For 'all', use primary for position calculation
+            return Monitor::Instance().GetPrimary();
     }
+    return nullptr;
+}
 
-    // If name is empty, clean up formatting
-    if (m_state.currentDesktopName.empty()) {
-        // Remove ": " if name was empty
-        pos = result.find(L": ");
-        if (pos != std::wstring::npos && pos + 2 == result.length()) {
-            result = result.substr(0, pos);
+int OverlayWindow::GetTargetMonitorNumber() const {
+    const MonitorInfo* target = GetTargetMonitor();
+    const std::vector<MonitorInfo>& monitors = Monitor::Instance().GetMonitors();
+    for (size_t i = 0; i < monitors.size(); i++) {
+        if (&monitors[i] == target) {
+            return static_cast<int>(i) + 1;
         }
     }
+    return 0;
+}
+
+const std::wstring& OverlayWindow::FormatDisplayText() {
+    return FormatDisplayText(m_state.currentDesktopIndex, m_state.currentDesktopName);
+}
 
-    return result;
+const std::wstring& OverlayWindow::FormatDisplayText(int desktopIndex, const std::wstring& desktopName) {
+    FormatValues values;
+    values.number = desktopIndex;
+    values.name = desktopName;
+    values.count = VirtualDesktop::Instance().GetKnownDesktopCount();
+    values.monitor = GetTargetMonitorNumber();
+    m_displayFormat.Render(values, m_displayText);
+    return m_displayText;
 }
 
 }  // namespace VirtualOverlay
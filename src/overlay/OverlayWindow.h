@@ -1,25 +1,39 @@
 #pragma once
 
 #include "OverlayConfig.h"
+#include "SurfacePool.h"
+#include "LabelCache.h"
+#include "LabelRasterizer.h"
+#include "RenderWorker.h"
+#include "FormatTemplate.h"
+#include "TextMetricsCache.h"
+#include "UpdateCoalescer.h"
+#include "D2DRenderBackend.h"
 #include <windows.h>
 #include <d2d1.h>
 #include <dwrite.h>
 #include <wrl/client.h>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace VirtualOverlay {
 
 using Microsoft::WRL::ComPtr;
 
+struct MonitorInfo;
+
 // Custom messages for overlay
 constexpr UINT WM_OVERLAY_SHOW = WM_USER + 200;
 constexpr UINT WM_OVERLAY_HIDE = WM_USER + 201;
 constexpr UINT WM_OVERLAY_UPDATE = WM_USER + 202;
+constexpr UINT WM_OVERLAY_LABEL_READY = WM_USER + 203;  // Posted by the label worker
 
 // Timer IDs
 constexpr UINT_PTR TIMER_OVERLAY_ANIMATION = 10;
 constexpr UINT_PTR TIMER_OVERLAY_AUTOHIDE = 11;
 constexpr UINT_PTR TIMER_OVERLAY_DODGE = 12;
+constexpr UINT_PTR TIMER_OVERLAY_UPDATE = 14;
 constexpr UINT TIMER_ANIMATION_INTERVAL_MS = 16;  // ~60 FPS
 constexpr UINT TIMER_DODGE_INTERVAL_MS = 50;      // Check mouse position 20 times/sec
 
@@ -33,8 +47,17 @@ public:
     void Shutdown();
     bool IsInitialized() const { return m_initialized; }
 
-    // Show overlay with desktop info
+    // Show overlay with desktop info. Rapid calls are coalesced: the newest
+    // desktop is shown, at most once per frame interval
     void Show(int desktopIndex, const std::wstring& desktopName);
+
+    // Rasterize a label ahead of time (predicted switch target) on the label
+    // worker; the next Show with the same text only copies it
+    void Prerender(int desktopIndex, const std::wstring& desktopName);
+
+    // Rasterize the labels of these desktops (index, name) into the label
+    // cache on the label worker, so later switches are cache hits
+    void WarmLabelCache(const std::vector<std::pair<int, std::wstring>>& desktops);
     
     // Hide overlay immediately
     void Hide();
@@ -67,6 +90,36 @@ private:
     void DiscardRenderResources();
     void Render();
     void RenderWatermark();  // Per-pixel alpha rendering for watermark mode
+    OverlayFrame BuildOverlayFrame(int width, int height);
+
+    // Watermark bitmap: 32-bit premultiplied DIB selected into a memory DC
+    // that UpdateLayeredWindow reads; pooled by size. The label worker draws
+    // the pixels, the UI thread only copies them in.
+    struct WatermarkSurface {
+        HDC hdc = nullptr;
+        HBITMAP bitmap = nullptr;
+        void* bits = nullptr;  // Top-down BGRA, width * 4 bytes per row
+        HBITMAP oldBitmap = nullptr;
+        int width = 0;
+        int height = 0;
+        std::wstring text;  // Label currently in the bitmap
+        uint32_t styleVersion = 0;  // m_watermarkStyleVersion of the label
+    };
+    WatermarkSurface* AcquireWatermarkSurface(int width, int height);
+    bool CreateWatermarkSurface(int width, int height, WatermarkSurface& surface);
+    bool HoldsLabel(const WatermarkSurface& surface, const std::wstring& text) const;
+    bool SubmitLabel(RenderRequestKind kind, const std::wstring& text, int width, int height);
+    void OnLabelReady();  // WM_OVERLAY_LABEL_READY: present the newest finished label
+    void CollectWarmedLabels();  // Move labels the worker warmed into m_labelCache
+    void CopyLabel(const LabelBitmap& label, const std::wstring& text, WatermarkSurface& surface);
+    LabelStyle GetLabelStyle() const;
+    LabelKey MakeLabelKey(const std::wstring& text, int width, int height) const;
+    void PresentWatermark(const WatermarkSurface& surface);
+    static void ReleaseSurface(WatermarkSurface& surface);
+
+    // Show a desktop right away (the coalescer decided it is due)
+    void Present(int desktopIndex, const std::wstring& desktopName);
+    void PumpUpdates();
 
     // Animation
     void StartFadeIn();
@@ -79,10 +132,16 @@ private:
 
     // Positioning
     void CalculateWindowPosition(int& x, int& y, int width, int height);
+    void CalculateWindowSize(const std::wstring& displayText, int& width, int& height);
+    bool MeasureLabel(const std::wstring& text, TextMetrics& metrics);
+    int GetLabelMargin() const;
     void UpdateWindowPosition();
 
-    // Text formatting
-    std::wstring FormatDisplayText();
+    // Text formatting (into a buffer reused across calls)
+    const std::wstring& FormatDisplayText();
+    const std::wstring& FormatDisplayText(int desktopIndex, const std::wstring& desktopName);
+    const MonitorInfo* GetTargetMonitor() const;
+    int GetTargetMonitorNumber() const;
 
     // Window
     HWND m_hwnd = nullptr;
@@ -92,17 +151,32 @@ private:
     // Settings and state
     OverlaySettings m_settings;
     OverlayRuntimeState m_state;
+    UpdateCoalescer m_updateCoalescer;  // Pending Show, latest wins
+    FormatTemplate m_displayFormat{ m_settings.format };  // Compiled by ApplySettings
+    std::wstring m_displayText;
 
     // Render resources
     ComPtr<ID2D1HwndRenderTarget> m_renderTarget;
-    ComPtr<ID2D1SolidColorBrush> m_textBrush;
-    ComPtr<ID2D1SolidColorBrush> m_backgroundBrush;
-    ComPtr<ID2D1SolidColorBrush> m_borderBrush;
     ComPtr<IDWriteTextFormat> m_textFormat;
+    D2DRenderBackend m_renderBackend;       // Notification frames, over m_renderTarget
 
     // Calculated dimensions
     int m_windowWidth = 200;
     int m_windowHeight = 60;
+
+    // Watermark surfaces: the current label size plus a predicted one
+    static constexpr size_t WATERMARK_POOL_IDLE = 2;
+    SurfacePool<WatermarkSurface> m_surfacePool{ WATERMARK_POOL_IDLE, &OverlayWindow::ReleaseSurface };
+    uint32_t m_watermarkStyleVersion = 1;         // Bumped by ApplySettings
+
+    // Watermark labels are rasterized on the worker thread; the rasterizer
+    // (distance fields, D2D targets) belongs to it while it runs. Finished
+    // labels are cached here, so a hit is presented without the worker.
+    LabelRasterizer m_rasterizer;
+    RenderWorker m_renderWorker;
+    LabelStyle m_labelStyle;         // Style of the labels requested now
+    LabelCache m_labelCache{ 0 };    // UI thread only, budget set by ApplySettings
+    TextMetricsCache m_textMetrics;  // Label extents the window is sized from
     
     // Dodge state
     bool m_isDodging = false;
@@ -0,0 +1,307 @@
+#include "PixelKernels.h"
+#include "../utils/CpuFeatures.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(VO_CPU_X86)
+#include <immintrin.h>
+#endif
+
+namespace VirtualOverlay {
+
+namespace {
+
+// ---------------------------------------------------------------------------
+// Scalar reference
+
+inline uint32_t Div255(uint32_t value) {
+    value += 128;
+    return (value + (value >> 8)) >> 8;
+}
+
+// Every channel times factor / 255
+inline uint32_t ScalePixel(uint32_t pixel, uint32_t factor) {
+    return (Div255((pixel >> 24) * factor) << 24) |
+           (Div255(((pixel >> 16) & 0xFF) * factor) << 16) |
+           (Div255(((pixel >> 8) & 0xFF) * factor) << 8) |
+           Div255((pixel & 0xFF) * factor);
+}
+
+// Premultiplied source-over; saturates like the SIMD paths on invalid input
+inline uint32_t OverPixel(uint32_t src, uint32_t dst) {
+    uint32_t scaled = ScalePixel(dst, 255 - (src >> 24));
+    uint32_t result = 0;
+    for (int shift = 0; shift < 32; shift += 8) {
+        uint32_t sum = ((src >> shift) & 0xFF) + ((scaled >> shift) & 0xFF);
+        result |= std::min<uint32_t>(sum, 255) << shift;
+    }
+    return result;
+}
+
+void ColorizeMaskScalar(const uint8_t* coverage, uint32_t* dst, size_t count, uint32_t color, size_t start) {
+    for (size_t i = start; i < count; i++) {
+        dst[i] = ScalePixel(color, coverage[i]);
+    }
+}
+
+void BlendMaskScalar(const uint8_t* coverage, uint32_t* dst, size_t count, uint32_t color, size_t start) {
+    for (size_t i = start; i < count; i++) {
+        if (coverage[i]) {
+            dst[i] = OverPixel(ScalePixel(color, coverage[i]), dst[i]);
+        }
+    }
+}
+
+void ScalePixelsScalar(uint32_t* pixels, size_t count, uint8_t opacity, size_t start) {
+    for (size_t i = start; i < count; i++) {
+        pixels[i] = ScalePixel(pixels[i], opacity);
+    }
+}
+
+void BlendOverScalar(const uint32_t* src, uint32_t* dst, size_t count, size_t start) {
+    for (size_t i = start; i < count; i++) {
+        dst[i] = OverPixel(src[i], dst[i]);
+    }
+}
+
+#if defined(VO_CPU_X86)
+
+// ---------------------------------------------------------------------------
+// SSE4.1: four pixels per step, channels widened to 16 bits
+
+VO_TARGET_SSE41 inline __m128i Div255Sse(__m128i x) {
+    x = _mm_add_epi16(x, _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+}
+
+// Each byte of pixels times the matching byte of factors / 255
+VO_TARGET_SSE41 inline __m128i ScaleSse(__m128i pixels, __m128i factors) {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i lo = _mm_mullo_epi16(_mm_unpacklo_epi8(pixels, zero), _mm_unpacklo_epi8(factors, zero));
+    __m128i hi = _mm_mullo_epi16(_mm_unpackhi_epi8(pixels, zero), _mm_unpackhi_epi8(factors, zero));
+    return _mm_packus_epi16(Div255Sse(lo), Div255Sse(hi));
+}
+
+VO_TARGET_SSE41 inline __m128i OverSse(__m128i src, __m128i dst) {
+    const __m128i alphas = _mm_setr_epi8(3, 3, 3, 3, 7, 7, 7, 7, 11, 11, 11, 11, 15, 15, 15, 15);
+    __m128i inverse = _mm_xor_si128(_mm_shuffle_epi8(src, alphas), _mm_set1_epi8(-1));  // 255 - a
+    return _mm_adds_epu8(src, ScaleSse(dst, inverse));
+}
+
+// Four coverage bytes, each repeated across its pixel's four channels
+VO_TARGET_SSE41 inline __m128i SpreadSse(const uint8_t* coverage, int32_t& packed) {
+    std::memcpy(&packed, coverage, sizeof(packed));
+    __m128i widened = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(packed));
+    return _mm_mullo_epi32(widened, _mm_set1_epi32(0x01010101));
+}
+
+VO_TARGET_SSE41 size_t ColorizeMaskSse41(const uint8_t* coverage, uint32_t* dst, size_t count, uint32_t color) {
+    const __m128i colors = _mm_set1_epi32(static_cast<int>(color));
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        int32_t packed;
+        __m128i result = ScaleSse(colors, SpreadSse(coverage + i, packed));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), result);
+    }
+    return i;
+}
+
+VO_TARGET_SSE41 size_t BlendMaskSse41(const uint8_t* coverage, uint32_t* dst, size_t count, uint32_t color) {
+    const __m128i colors = _mm_set1_epi32(static_cast<int>(color));
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        int32_t packed;
+        __m128i spread = SpreadSse(coverage + i, packed);
+        if (packed == 0) continue;  // Text masks are mostly empty
+        __m128i* target = reinterpret_cast<__m128i*>(dst + i);
+        _mm_storeu_si128(target, OverSse(ScaleSse(colors, spread), _mm_loadu_si128(target)));
+    }
+    return i;
+}
+
+VO_TARGET_SSE41 size_t ScalePixelsSse41(uint32_t* pixels, size_t count, uint8_t opacity) {
+    const __m128i factors = _mm_set1_epi8(static_cast<char>(opacity));
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i* target = reinterpret_cast<__m128i*>(pixels + i);
+        _mm_storeu_si128(target, ScaleSse(_mm_loadu_si128(target), factors));
+    }
+    return i;
+}
+
+VO_TARGET_SSE41 size_t BlendOverSse41(const uint32_t* src, uint32_t* dst, size_t count) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i source = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i* target = reinterpret_cast<__m128i*>(dst + i);
+        _mm_storeu_si128(target, OverSse(source, _mm_loadu_si128(target)));
+    }
+    return i;
+}
+
+// ---------------------------------------------------------------------------
+// AVX2: eight pixels per step. Unpack and pack both work per 128-bit lane,
+// so pixel order survives the round trip.
+
+VO_TARGET_AVX2 inline __m256i Div255Avx(__m256i x) {
+    x = _mm256_add_epi16(x, _mm256_set1_epi16(128));
+    return _mm256_srli_epi16(_mm256_add_epi16(x, _mm256_srli_epi16(x, 8)), 8);
+}
+
+VO_TARGET_AVX2 inline __m256i ScaleAvx(__m256i pixels, __m256i factors) {
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i lo = _mm256_mullo_epi16(_mm256_unpacklo_epi8(pixels, zero), _mm256_unpacklo_epi8(factors, zero));
+    __m256i hi = _mm256_mullo_epi16(_mm256_unpackhi_epi8(pixels, zero), _mm256_unpackhi_epi8(factors, zero));
+    return _mm256_packus_epi16(Div255Avx(lo), Div255Avx(hi));
+}
+
+VO_TARGET_AVX2 inline __m256i OverAvx(__m256i src, __m256i dst) {
+    const __m256i alphas = _mm256_setr_epi8(3, 3, 3, 3, 7, 7, 7, 7, 11, 11, 11, 11, 15, 15, 15, 15,
+                                            3, 3, 3, 3, 7, 7, 7, 7, 11, 11, 11, 11, 15, 15, 15, 15);
+    __m256i inverse = _mm256_xor_si256(_mm256_shuffle_epi8(src, alphas), _mm256_set1_epi8(-1));
+    return _mm256_adds_epu8(src, ScaleAvx(dst, inverse));
+}
+
+VO_TARGET_AVX2 inline __m256i SpreadAvx(const uint8_t* coverage, int64_t& packed) {
+    std::memcpy(&packed, coverage, sizeof(packed));
+    __m256i widened = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(coverage)));
+    return _mm256_mullo_epi32(widened, _mm256_set1_epi32(0x01010101));
+}
+
+VO_TARGET_AVX2 size_t ColorizeMaskAvx2(const uint8_t* coverage, uint32_t* dst, size_t count, uint32_t color) {
+    const __m256i colors = _mm256_set1_epi32(static_cast<int>(color));
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        int64_t packed;
+        __m256i result = ScaleAvx(colors, SpreadAvx(coverage + i, packed));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), result);
+    }
+    return i;
+}
+
+VO_TARGET_AVX2 size_t BlendMaskAvx2(const uint8_t* coverage, uint32_t* dst, size_t count, uint32_t color) {
+    const __m256i colors = _mm256_set1_epi32(static_cast<int>(color));
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        int64_t packed;
+        __m256i spread = SpreadAvx(coverage + i, packed);
+        if (packed == 0) continue;
+        __m256i* target = reinterpret_cast<__m256i*>(dst + i);
+        _mm256_storeu_si256(target, OverAvx(ScaleAvx(colors, spread), _mm256_loadu_si256(target)));
+    }
+    return i;
+}
+
+VO_TARGET_AVX2 size_t ScalePixelsAvx2(uint32_t* pixels, size_t count, uint8_t opacity) {
+    const __m256i factors = _mm256_set1_epi8(static_cast<char>(opacity));
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i* target = reinterpret_cast<__m256i*>(pixels + i);
+        _mm256_storeu_si256(target, ScaleAvx(_mm256_loadu_si256(target), factors));
+    }
+    return i;
+}
+
+VO_TARGET_AVX2 size_t BlendOverAvx2(const uint32_t* src, uint32_t* dst, size_t count) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i source = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        __m256i* target = reinterpret_cast<__m256i*>(dst + i);
+        _mm256_storeu_si256(target, OverAvx(source, _mm256_loadu_si256(target)));
+    }
+    return i;
+}
+
+#endif  // VO_CPU_X86
+
+PixelKernel Resolve(PixelKernel kernel) {
+    PixelKernel best = GetBestPixelKernel();
+    if (kernel == PixelKernel::Auto || static_cast<int>(kernel) > static_cast<int>(best)) {
+        return best;
+    }
+    return kernel;
+}
+
+}  // namespace
+
+const char* PixelKernelToString(PixelKernel kernel) {
+    switch (kernel) {
+        case PixelKernel::Auto:   return "auto";
+        case PixelKernel::Scalar: return "scalar";
+        case PixelKernel::Sse41:  return "sse4.1";
+        case PixelKernel::Avx2:   return "avx2";
+        default:                  return "unknown";
+    }
+}
+
+PixelKernel GetBestPixelKernel() {
+    const CpuFeatures& cpu = GetCpuFeatures();
+    if (cpu.avx2) return PixelKernel::Avx2;
+    if (cpu.sse41) return PixelKernel::Sse41;
+    return PixelKernel::Scalar;
+}
+
+uint32_t PremultiplyColor(uint32_t rgb, uint8_t alpha) {
+    return ScalePixel(0xFF000000u | (rgb & 0xFFFFFF), alpha);
+}
+
+void ColorizeMask(const uint8_t* coverage, uint32_t* dst, size_t count, uint32_t color, PixelKernel kernel) {
+    size_t done = 0;
+#if defined(VO_CPU_X86)
+    switch (Resolve(kernel)) {
+        case PixelKernel::Avx2:  done = ColorizeMaskAvx2(coverage, dst, count, color); break;
+        case PixelKernel::Sse41: done = ColorizeMaskSse41(coverage, dst, count, color); break;
+        default: break;
+    }
+#else
+    (void)kernel;
+#endif
+    ColorizeMaskScalar(coverage, dst, count, color, done);
+}
+
+void BlendMask(const uint8_t* coverage, uint32_t* dst, size_t count, uint32_t color, PixelKernel kernel) {
+    size_t done = 0;
+#if defined(VO_CPU_X86)
+    switch (Resolve(kernel)) {
+        case PixelKernel::Avx2:  done = BlendMaskAvx2(coverage, dst, count, color); break;
+        case PixelKernel::Sse41: done = BlendMaskSse41(coverage, dst, count, color); break;
+        default: break;
+    }
+#else
+    (void)kernel;
+#endif
+    BlendMaskScalar(coverage, dst, count, color, done);
+}
+
+void ScalePixels(uint32_t* pixels, size_t count, uint8_t opacity, PixelKernel kernel) {
+    if (opacity == 255) {
+        return;
+    }
+    size_t done = 0;
+#if defined(VO_CPU_X86)
+    switch (Resolve(kernel)) {
+        case PixelKernel::Avx2:  done = ScalePixelsAvx2(pixels, count, opacity); break;
+        case PixelKernel::Sse41: done = ScalePixelsSse41(pixels, count, opacity); break;
+        default: break;
+    }
+#else
+    (void)kernel;
+#endif
+    ScalePixelsScalar(pixels, count, opacity, done);
+}
+
+void BlendOver(const uint32_t* src, uint32_t* dst, size_t count, PixelKernel kernel) {
+    size_t done = 0;
+#if defined(VO_CPU_X86)
+    switch (Resolve(kernel)) {
+        case PixelKernel::Avx2:  done = BlendOverAvx2(src, dst, count); break;
+        case PixelKernel::Sse41: done = BlendOverSse41(src, dst, count); break;
+        default: break;
+    }
+#else
+    (void)kernel;
+#endif
+    BlendOverScalar(src, dst, count, done);
+}
+
+}  // namespace VirtualOverlay
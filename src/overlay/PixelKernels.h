@@ -0,0 +1,48 @@
+#pragma once
+
+// Per-pixel kernels over 32-bit premultiplied BGRA (the UpdateLayeredWindow
+// format): colorize a coverage mask, blend one over a bitmap, scale a bitmap
+// by an opacity and composite bitmaps source-over.
+//
+// Each kernel has SSE4.1 and AVX2 versions picked at runtime and a scalar
+// reference; all produce bit-identical results (rounded division by 255
+// throughout). Pixels are 0xAARRGGBB values, colors premultiplied.
+// Platform-independent (no <windows.h>).
+
+#include <cstddef>
+#include <cstdint>
+
+namespace VirtualOverlay {
+
+enum class PixelKernel {
+    Auto,    // Best available on this CPU
+    Scalar,
+    Sse41,
+    Avx2
+};
+
+const char* PixelKernelToString(PixelKernel kernel);
+
+// Best kernel this CPU supports (detected once)
+PixelKernel GetBestPixelKernel();
+
+// Straight 0xRRGGBB plus alpha -> premultiplied 0xAARRGGBB
+uint32_t PremultiplyColor(uint32_t rgb, uint8_t alpha);
+
+// dst[i] = color * coverage[i]
+void ColorizeMask(const uint8_t* coverage, uint32_t* dst, size_t count, uint32_t color,
+                  PixelKernel kernel = PixelKernel::Auto);
+
+// dst[i] = color * coverage[i] over dst[i]
+void BlendMask(const uint8_t* coverage, uint32_t* dst, size_t count, uint32_t color,
+               PixelKernel kernel = PixelKernel::Auto);
+
+// pixels[i] *= opacity (all four channels)
+void ScalePixels(uint32_t* pixels, size_t count, uint8_t opacity,
+                 PixelKernel kernel = PixelKernel::Auto);
+
+// dst[i] = src[i] over dst[i]
+void BlendOver(const uint32_t* src, uint32_t* dst, size_t count,
+               PixelKernel kernel = PixelKernel::Auto);
+
+}  // namespace VirtualOverlay
@@ -0,0 +1,59 @@
+#include "RenderBackend.h"
+
+namespace VirtualOverlay {
+
+RenderColor RenderColor::FromRGB(uint32_t rgb, float alpha) {
+    RenderColor color;
+    color.r = static_cast<float>((rgb >> 16) & 0xFF) / 255.0f;
+    color.g = static_cast<float>((rgb >> 8) & 0xFF) / 255.0f;
+    color.b = static_cast<float>(rgb & 0xFF) / 255.0f;
+    color.a = alpha;
+    return color;
+}
+
+bool DrawOverlayFrame(RenderBackend& backend, const OverlayFrame& frame) {
+    if (!backend.BeginFrame(frame.width, frame.height)) {
+        return false;
+    }
+
+    backend.Clear(RenderColor());  // Transparent
+
+    RenderRect bounds;
+    bounds.right = static_cast<float>(frame.width);
+    bounds.bottom = static_cast<float>(frame.height);
+    if (frame.background.a > 0.0f) {
+        backend.FillRoundedRect(bounds, frame.cornerRadius, frame.background);
+    }
+    if (frame.borderWidth > 0.0f && frame.border.a > 0.0f) {
+        backend.StrokeRoundedRect(bounds, frame.cornerRadius, frame.borderWidth, frame.border);
+    }
+
+    if (!frame.text.empty()) {
+        RenderRect textRect;
+        textRect.left = frame.padding;
+        textRect.top = frame.padding + frame.slideOffset;
+        textRect.right = frame.width - frame.padding;
+        textRect.bottom = frame.height - frame.padding + frame.slideOffset;
+        backend.FillText(frame.text, textRect, frame.textColor);
+    }
+
+    return backend.EndFrame(frame.opacity);
+}
+
+bool DrawWatermarkFrame(RenderBackend& backend, const WatermarkFrame& frame) {
+    if (!backend.BeginFrame(frame.width, frame.height)) {
+        return false;
+    }
+
+    backend.Clear(RenderColor());  // Transparent
+    if (frame.halo && frame.haloColor.a > 0.0f) {
+        backend.DrawMask(frame.halo, frame.width, frame.height, 0, 0, frame.haloColor);
+    }
+    if (frame.fill) {
+        backend.DrawMask(frame.fill, frame.width, frame.height, 0, 0, frame.textColor);
+    }
+
+    return backend.EndFrame(1.0f);
+}
+
+}  // namespace VirtualOverlay
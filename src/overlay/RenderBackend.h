@@ -0,0 +1,92 @@
+#pragma once
+
+// Drawing interface behind the overlay's frames.
+//
+// OverlayWindow describes what a frame contains (OverlayFrame for the
+// notification popup, WatermarkFrame for the watermark label) and
+// DrawOverlayFrame / DrawWatermarkFrame turn that into backend calls. The
+// Direct2D backend draws into the window's render target; the software
+// backend rasterizes into premultiplied BGRA memory, so the same frames can
+// be produced, compared and timed without Direct2D or a window.
+// Platform-independent (no <windows.h>).
+
+#include <cstdint>
+#include <string>
+
+namespace VirtualOverlay {
+
+// Straight (non-premultiplied) color, components 0-1
+struct RenderColor {
+    float r = 0.0f;
+    float g = 0.0f;
+    float b = 0.0f;
+    float a = 0.0f;
+
+    // Same convention as D2DRenderer::ColorFromRGB (0xRRGGBB)
+    static RenderColor FromRGB(uint32_t rgb, float alpha = 1.0f);
+};
+
+struct RenderRect {
+    float left = 0.0f;
+    float top = 0.0f;
+    float right = 0.0f;
+    float bottom = 0.0f;
+
+    float Width() const { return right - left; }
+    float Height() const { return bottom - top; }
+};
+
+class RenderBackend {
+public:
+    virtual ~RenderBackend() = default;
+
+    virtual bool BeginFrame(int width, int height) = 0;
+    virtual void Clear(const RenderColor& color) = 0;
+
+    // Anti-aliased; the stroke is centered on the rectangle's edge
+    virtual void FillRoundedRect(const RenderRect& rect, float radius, const RenderColor& color) = 0;
+    virtual void StrokeRoundedRect(const RenderRect& rect, float radius, float strokeWidth,
+                                   const RenderColor& color) = 0;
+
+    // Text centered horizontally and vertically in layout
+    virtual void FillText(const std::wstring& text, const RenderRect& layout, const RenderColor& color) = 0;
+
+    // 8-bit coverage (stride == maskWidth) painted in color at (x, y)
+    virtual void DrawMask(const uint8_t* coverage, int maskWidth, int maskHeight, int x, int y,
+                          const RenderColor& color) = 0;
+
+    // windowOpacity is the whole-frame alpha (the notification fade). Backends
+    // presenting to a layered window leave it to SetLayeredWindowAttributes;
+    // the software backend multiplies it in.
+    virtual bool EndFrame(float windowOpacity) = 0;
+};
+
+// Notification popup: rounded background, border and text
+struct OverlayFrame {
+    int width = 0;
+    int height = 0;
+    float cornerRadius = 0.0f;
+    float padding = 0.0f;
+    RenderColor background;   // a = 0 draws no background
+    RenderColor border;
+    float borderWidth = 0.0f;
+    std::wstring text;
+    RenderColor textColor;
+    float slideOffset = 0.0f; // Slide-in animation, pixels
+    float opacity = 1.0f;     // Fade animation
+};
+
+// Watermark label: text coverage over an optional outline/glow coverage
+struct WatermarkFrame {
+    int width = 0;
+    int height = 0;
+    const uint8_t* fill = nullptr;  // width * height each
+    const uint8_t* halo = nullptr;  // nullptr = no outline
+    RenderColor textColor;
+    RenderColor haloColor;
+};
+
+bool DrawOverlayFrame(RenderBackend& backend, const OverlayFrame& frame);
+bool DrawWatermarkFrame(RenderBackend& backend, const WatermarkFrame& frame);
+
+}  // namespace VirtualOverlay
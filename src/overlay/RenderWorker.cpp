@@ -0,0 +1,195 @@
+#include "RenderWorker.h"
+#include <chrono>
+
+namespace VirtualOverlay {
+
+void LatencyHistogram::Add(uint64_t micros) {
+    size_t index = 0;
+    while (index + 1 < BUCKETS && micros >= GetBucketLimit(index)) {
+        index++;
+    }
+    m_buckets[index].fetch_add(1, std::memory_order_relaxed);
+}
+
+void LatencyHistogram::Reset() {
+    for (auto& bucket : m_buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+uint64_t LatencyHistogram::GetCount() const {
+    uint64_t count = 0;
+    for (const auto& bucket : m_buckets) {
+        count += bucket.load(std::memory_order_relaxed);
+    }
+    return count;
+}
+
+uint64_t LatencyHistogram::GetPercentileBound(double fraction) const {
+    uint64_t count = GetCount();
+    if (count == 0) {
+        return 0;
+    }
+    uint64_t target = static_cast<uint64_t>(fraction * static_cast<double>(count));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKETS; i++) {
+        seen += GetBucket(i);
+        if (seen > target || seen == count) {
+            return GetBucketLimit(i);
+        }
+    }
+    return GetBucketLimit(BUCKETS - 1);
+}
+
+bool RenderWorker::Start(LabelRasterizeFn rasterize, std::function<void()> onPublished,
+                         std::function<void()> onExit) {
+    if (IsRunning() || !rasterize) {
+        return false;
+    }
+
+    m_rasterize = std::move(rasterize);
+    m_onPublished = std::move(onPublished);
+    m_onExit = std::move(onExit);
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_wake = false;
+        m_stop = false;
+    }
+    m_stopping.store(false, std::memory_order_relaxed);
+    m_thread = std::thread(&RenderWorker::Run, this);
+    return true;
+}
+
+void RenderWorker::Stop() {
+    if (!IsRunning()) {
+        return;
+    }
+
+    m_stopping.store(true, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_stop = true;
+    }
+    m_wakeCondition.notify_one();
+    m_thread.join();
+
+    // Nothing consumes them any more
+    m_present.Consume();
+    RenderRequest dropped;
+    while (m_warmRequests.Pop(dropped)) {
+    }
+    RenderResult warmed;
+    while (m_warmResults.Pop(warmed)) {
+    }
+}
+
+bool RenderWorker::Submit(RenderRequest request) {
+    request.sequence = m_nextSequence++;
+    request.submitUs = NowMicros();
+    if (request.kind == RenderRequestKind::Present) {
+        m_present.GetWriteBuffer() = std::move(request);
+        if (m_present.Publish()) {
+            m_superseded.fetch_add(1, std::memory_order_relaxed);
+        }
+    } else if (!m_warmRequests.Push(std::move(request))) {
+        m_rejected.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    m_submitted.fetch_add(1, std::memory_order_relaxed);
+
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_wake = true;
+    }
+    m_wakeCondition.notify_one();
+    return true;
+}
+
+const RenderResult* RenderWorker::TakeResult() {
+    if (!m_results.Consume()) {
+        return nullptr;
+    }
+    return &m_results.GetReadBuffer();
+}
+
+bool RenderWorker::TakeWarmResult(RenderResult& result) {
+    return m_warmResults.Pop(result);
+}
+
+RenderWorkerStats RenderWorker::GetStats() const {
+    RenderWorkerStats stats;
+    stats.submitted = m_submitted.load(std::memory_order_relaxed);
+    stats.rejected = m_rejected.load(std::memory_order_relaxed);
+    stats.presented = m_presented.load(std::memory_order_relaxed);
+    stats.superseded = m_superseded.load(std::memory_order_relaxed);
+    stats.warmed = m_warmed.load(std::memory_order_relaxed);
+    stats.warmDropped = m_warmDropped.load(std::memory_order_relaxed);
+    stats.failed = m_failed.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void RenderWorker::Run() {
+    while (!m_stopping.load(std::memory_order_relaxed)) {
+        // The newest Present goes before any warming; checking it again
+        // after every Warm keeps a long warm-up from delaying a switch
+        if (m_present.Consume()) {
+            Process(m_present.GetReadBuffer());
+            continue;
+        }
+        if (m_warmRequests.Pop(m_warm)) {
+            Process(m_warm);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_wakeMutex);
+        m_wakeCondition.wait(lock, [this] { return m_wake || m_stop; });
+        if (m_stop) {
+            break;
+        }
+        m_wake = false;
+    }
+
+    if (m_onExit) {
+        m_onExit();
+    }
+}
+
+void RenderWorker::Process(const RenderRequest& request) {
+    if (request.kind == RenderRequestKind::Warm) {
+        RenderResult warmed;
+        warmed.sequence = request.sequence;
+        warmed.key = request.key;
+        warmed.ok = m_rasterize(request, warmed.bitmap);
+        if (!warmed.ok) {
+            m_failed.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        m_warmed.fetch_add(1, std::memory_order_relaxed);
+        if (!m_warmResults.Push(std::move(warmed))) {
+            m_warmDropped.fetch_add(1, std::memory_order_relaxed);
+        }
+        return;
+    }
+
+    RenderResult& result = m_results.GetWriteBuffer();
+    result.sequence = request.sequence;
+    result.key = request.key;
+    result.ok = m_rasterize(request, result.bitmap);
+    if (!result.ok) {
+        m_failed.fetch_add(1, std::memory_order_relaxed);
+    }
+    m_results.Publish();
+    m_presented.fetch_add(1, std::memory_order_relaxed);
+    m_latency.Add(static_cast<uint64_t>(NowMicros() - request.submitUs));
+
+    if (m_onPublished) {
+        m_onPublished();
+    }
+}
+
+int64_t RenderWorker::NowMicros() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+}  // namespace VirtualOverlay
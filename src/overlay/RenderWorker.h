@@ -0,0 +1,163 @@
+#pragma once
+
+// Dedicated thread that rasterizes watermark labels.
+//
+// Text shaping used to run on the UI thread, which also pumps the 16 ms zoom
+// timer and the desktop poll, so a slow DirectWrite layout (long name, font
+// fallback) delayed zoom frames. The UI thread now submits immutable
+// requests (the label key: text, style, size); the worker rasterizes them
+// and publishes the label to show through a triple buffer, and the UI thread
+// only copies the newest finished label into its bitmap and presents it.
+// Finished labels are cached on the UI thread, so a label seen before is
+// presented there without a request at all.
+//
+//   - Present: rasterize and publish. Submitted through a latest-wins slot
+//     of its own, so it is never rejected: a newer one replaces one the
+//     worker has not started, and it is picked up before the next queued
+//     Warm;
+//   - Warm:    rasterize ahead of time (predicted switch, warm-up) and hand
+//     the label back through a bounded queue the UI thread drains into its
+//     cache whenever it next looks there; no message is posted. Submitted
+//     through a bounded queue; dropped when either queue is full.
+//
+// Requests and results never take a lock; the worker parks on a condition
+// variable only while it has nothing to do. Rasterization is a callback, so
+// the thread, queue and hand-off run the same with a fake rasterizer.
+// Platform-independent (no <windows.h>).
+
+#include "LabelCache.h"
+#include "SpscQueue.h"
+#include "TripleBuffer.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace VirtualOverlay {
+
+enum class RenderRequestKind {
+    Present,
+    Warm
+};
+
+struct RenderRequest {
+    RenderRequestKind kind = RenderRequestKind::Present;
+    uint64_t sequence = 0;        // Set by Submit
+    LabelKey key;
+    int64_t submitUs = 0;         // Set by Submit
+};
+
+struct RenderResult {
+    uint64_t sequence = 0;
+    LabelKey key;
+    LabelBitmap bitmap;
+    bool ok = false;
+};
+
+// Power-of-two microsecond buckets: bucket i counts values below 2^i us
+class LatencyHistogram {
+public:
+    static constexpr size_t BUCKETS = 24;   // Up to ~8 s
+
+    void Add(uint64_t micros);
+    void Reset();
+
+    uint64_t GetCount() const;
+    uint64_t GetBucket(size_t index) const { return m_buckets[index].load(std::memory_order_relaxed); }
+    static uint64_t GetBucketLimit(size_t index) { return uint64_t{ 1 } << index; }
+
+    // Upper bound of the bucket holding the given fraction (0..1) of samples
+    uint64_t GetPercentileBound(double fraction) const;
+
+private:
+    std::atomic<uint64_t> m_buckets[BUCKETS] = {};
+};
+
+struct RenderWorkerStats {
+    uint64_t submitted = 0;
+    uint64_t rejected = 0;     // Warm requests dropped, queue full
+    uint64_t presented = 0;    // Present requests published
+    uint64_t superseded = 0;   // Present requests replaced before they started
+    uint64_t warmed = 0;
+    uint64_t warmDropped = 0;  // Warmed labels dropped, result queue full
+    uint64_t failed = 0;       // Rasterizer returned false
+};
+
+// Runs on the worker thread; fills bitmap for the request
+using LabelRasterizeFn = std::function<bool(const RenderRequest& request, LabelBitmap& bitmap)>;
+
+class RenderWorker {
+public:
+    static constexpr size_t QUEUE_CAPACITY = 64;   // Warm requests, and warmed labels
+
+    RenderWorker() = default;
+    ~RenderWorker() { Stop(); }
+
+    RenderWorker(const RenderWorker&) = delete;
+    RenderWorker& operator=(const RenderWorker&) = delete;
+
+    // onPublished runs on the worker after each published result (post a
+    // message to the UI thread); onExit runs on the worker before it ends
+    // (release thread-bound resources)
+    bool Start(LabelRasterizeFn rasterize, std::function<void()> onPublished,
+               std::function<void()> onExit = nullptr);
+
+    // Finish the current request and join; pending requests are dropped
+    void Stop();
+    bool IsRunning() const { return m_thread.joinable(); }
+
+    // UI thread (single producer). False if a Warm request found the queue
+    // full; a Present is always accepted.
+    bool Submit(RenderRequest request);
+
+    // UI thread (single consumer): the newest published result, if any was
+    // published since the last call. Valid until the next TakeResult.
+    const RenderResult* TakeResult();
+
+    // UI thread (single consumer): the oldest warmed label not taken yet
+    bool TakeWarmResult(RenderResult& result);
+
+    // Counters are updated by the worker; a snapshot while it runs
+    RenderWorkerStats GetStats() const;
+
+    // Submit-to-publish time of Present requests
+    const LatencyHistogram& GetLatency() const { return m_latency; }
+
+private:
+    void Run();
+    void Process(const RenderRequest& request);
+    static int64_t NowMicros();
+
+    LabelRasterizeFn m_rasterize;
+    std::function<void()> m_onPublished;
+    std::function<void()> m_onExit;
+    std::thread m_thread;
+
+    TripleBuffer<RenderRequest> m_present;  // Newest Present not started yet
+    SpscQueue<RenderRequest, QUEUE_CAPACITY> m_warmRequests;
+    TripleBuffer<RenderResult> m_results;
+    SpscQueue<RenderResult, QUEUE_CAPACITY> m_warmResults;
+    uint64_t m_nextSequence = 1;    // UI thread only
+
+    std::mutex m_wakeMutex;         // Parking only: guards m_wake and m_stop
+    std::condition_variable m_wakeCondition;
+    bool m_wake = false;
+    bool m_stop = false;
+    std::atomic<bool> m_stopping{ false };  // Checked between requests
+
+    RenderRequest m_warm;                   // Worker only: request in progress
+
+    std::atomic<uint64_t> m_submitted{ 0 };
+    std::atomic<uint64_t> m_rejected{ 0 };
+    std::atomic<uint64_t> m_presented{ 0 };
+    std::atomic<uint64_t> m_superseded{ 0 };
+    std::atomic<uint64_t> m_warmed{ 0 };
+    std::atomic<uint64_t> m_warmDropped{ 0 };
+    std::atomic<uint64_t> m_failed{ 0 };
+    LatencyHistogram m_latency;
+};
+
+}  // namespace VirtualOverlay
@@ -0,0 +1,163 @@
+#include "SoftwareRenderBackend.h"
+#include "PixelKernels.h"
+#include <algorithm>
+#include <cmath>
+
+namespace VirtualOverlay {
+
+namespace {
+
+inline uint32_t ToByte(float value) {
+    return static_cast<uint32_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+}
+
+uint32_t Premultiply(const RenderColor& color) {
+    uint32_t rgb = (ToByte(color.r) << 16) | (ToByte(color.g) << 8) | ToByte(color.b);
+    return PremultiplyColor(rgb, static_cast<uint8_t>(ToByte(color.a)));
+}
+
+// Signed distance from p to a rounded rectangle (negative inside)
+float RoundedRectDistance(float px, float py, float cx, float cy, float halfW, float halfH, float radius) {
+    float qx = std::fabs(px - cx) - (halfW - radius);
+    float qy = std::fabs(py - cy) - (halfH - radius);
+    float ox = std::max(qx, 0.0f);
+    float oy = std::max(qy, 0.0f);
+    float outside = std::sqrt(ox * ox + oy * oy);
+    float inside = std::min(std::max(qx, qy), 0.0f);
+    return outside + inside - radius;
+}
+
+}  // namespace
+
+SoftwareRenderBackend::SoftwareRenderBackend(TextMaskProvider textMasks)
+    : m_textMasks(std::move(textMasks)) {
+}
+
+void SoftwareRenderBackend::AttachPixels(uint32_t* pixels, int width, int height) {
+    m_attached = pixels;
+    m_attachedWidth = width;
+    m_attachedHeight = height;
+}
+
+void SoftwareRenderBackend::DetachPixels() {
+    m_attached = nullptr;
+    m_attachedWidth = 0;
+    m_attachedHeight = 0;
+}
+
+bool SoftwareRenderBackend::BeginFrame(int width, int height) {
+    if (width <= 0 || height <= 0) {
+        return false;
+    }
+
+    if (m_attached) {
+        if (width != m_attachedWidth || height != m_attachedHeight) {
+            return false;
+        }
+        m_pixels = m_attached;
+    } else {
+        m_buffer.resize(static_cast<size_t>(width) * height);
+        m_pixels = m_buffer.data();
+    }
+    m_width = width;
+    m_height = height;
+    return true;
+}
+
+void SoftwareRenderBackend::Clear(const RenderColor& color) {
+    std::fill(m_pixels, m_pixels + static_cast<size_t>(m_width) * m_height, Premultiply(color));
+}
+
+void SoftwareRenderBackend::FillRoundedRect(const RenderRect& rect, float radius, const RenderColor& color) {
+    RasterizeRoundedRect(rect, radius, 0.0f, false, color);
+}
+
+void SoftwareRenderBackend::StrokeRoundedRect(const RenderRect& rect, float radius, float strokeWidth,
+                                              const RenderColor& color) {
+    if (strokeWidth > 0.0f) {
+        RasterizeRoundedRect(rect, radius, strokeWidth, true, color);
+    }
+}
+
+void SoftwareRenderBackend::FillText(const std::wstring& text, const RenderRect& layout,
+                                     const RenderColor& color) {
+    int width = static_cast<int>(std::lround(layout.Width()));
+    int height = static_cast<int>(std::lround(layout.Height()));
+    if (!m_textMasks || text.empty() || width <= 0 || height <= 0) {
+        return;
+    }
+
+    // Positions snap to whole pixels (Direct2D would place the slide offset
+    // at subpixel precision)
+    m_textMask.assign(static_cast<size_t>(width) * height, 0);
+    if (m_textMasks(text, width, height, m_textMask) &&
+        m_textMask.size() == static_cast<size_t>(width) * height) {
+        DrawMask(m_textMask.data(), width, height,
+                 static_cast<int>(std::lround(layout.left)), static_cast<int>(std::lround(layout.top)), color);
+    }
+}
+
+void SoftwareRenderBackend::DrawMask(const uint8_t* coverage, int maskWidth, int maskHeight, int x, int y,
+                                     const RenderColor& color) {
+    uint32_t premultiplied = Premultiply(color);
+    int firstX = std::max(0, -x);
+    int lastX = std::min(maskWidth, m_width - x);
+    int firstY = std::max(0, -y);
+    int lastY = std::min(maskHeight, m_height - y);
+
+    if (firstX >= lastX) {
+        return;
+    }
+
+    for (int my = firstY; my < lastY; my++) {
+        const uint8_t* maskRow = coverage + static_cast<size_t>(my) * maskWidth;
+        uint32_t* row = m_pixels + static_cast<size_t>(y + my) * m_width + x;
+        BlendMask(maskRow + firstX, row + firstX, static_cast<size_t>(lastX - firstX), premultiplied);
+    }
+}
+
+bool SoftwareRenderBackend::EndFrame(float windowOpacity) {
+    ScalePixels(m_pixels, static_cast<size_t>(m_width) * m_height,
+                static_cast<uint8_t>(ToByte(windowOpacity)));
+    return true;
+}
+
+void SoftwareRenderBackend::RasterizeRoundedRect(const RenderRect& rect, float radius, float strokeWidth,
+                                                 bool stroke, const RenderColor& color) {
+    float halfW = rect.Width() * 0.5f;
+    float halfH = rect.Height() * 0.5f;
+    if (halfW <= 0.0f || halfH <= 0.0f) {
+        return;
+    }
+    radius = std::clamp(radius, 0.0f, std::min(halfW, halfH));
+    float cx = rect.left + halfW;
+    float cy = rect.top + halfH;
+    float halfStroke = strokeWidth * 0.5f;
+
+    // Only pixels the shape (plus its ramp) can touch
+    float reach = halfStroke + 1.0f;
+    int x0 = std::max(0, static_cast<int>(std::floor(rect.left - reach)));
+    int x1 = std::min(m_width, static_cast<int>(std::ceil(rect.right + reach)));
+    int y0 = std::max(0, static_cast<int>(std::floor(rect.top - reach)));
+    int y1 = std::min(m_height, static_cast<int>(std::ceil(rect.bottom + reach)));
+
+    if (x0 >= x1) {
+        return;
+    }
+
+    // Coverage a row at a time, then one vectorized blend per row
+    uint32_t premultiplied = Premultiply(color);
+    m_rowCoverage.resize(static_cast<size_t>(x1 - x0));
+    for (int y = y0; y < y1; y++) {
+        float py = y + 0.5f;
+        for (int x = x0; x < x1; x++) {
+            float d = RoundedRectDistance(x + 0.5f, py, cx, cy, halfW, halfH, radius);
+            float coverage = stroke ? (0.5f + halfStroke - std::fabs(d)) : (0.5f - d);
+            m_rowCoverage[x - x0] = static_cast<uint8_t>(ToByte(coverage));
+        }
+        BlendMask(m_rowCoverage.data(), m_pixels + static_cast<size_t>(y) * m_width + x0,
+                  m_rowCoverage.size(), premultiplied);
+    }
+}
+
+}  // namespace VirtualOverlay
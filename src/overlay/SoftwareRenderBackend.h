@@ -0,0 +1,72 @@
+#pragma once
+
+// RenderBackend that rasterizes into premultiplied BGRA memory.
+//
+// Rounded rectangles get analytic coverage from their signed distance (a
+// one-pixel ramp, like Direct2D's per-primitive anti-aliasing); masks and
+// text are blended source-over. Text shaping is not done here: a
+// TextMaskProvider supplies the coverage for a string laid out in a box
+// (DirectWrite on Windows, anything deterministic elsewhere). Without one,
+// FillText draws nothing.
+//
+// The backend draws into its own buffer, or into caller memory such as a
+// DIB section after AttachPixels.
+// Platform-independent (no <windows.h>).
+
+#include "RenderBackend.h"
+#include <functional>
+#include <vector>
+
+namespace VirtualOverlay {
+
+// Coverage (width * height bytes) of text centered in a width x height box
+using TextMaskProvider = std::function<bool(const std::wstring& text, int width, int height,
+                                            std::vector<uint8_t>& coverage)>;
+
+class SoftwareRenderBackend : public RenderBackend {
+public:
+    SoftwareRenderBackend() = default;
+    explicit SoftwareRenderBackend(TextMaskProvider textMasks);
+
+    void SetTextMaskProvider(TextMaskProvider textMasks) { m_textMasks = std::move(textMasks); }
+
+    // Draw into caller memory (top-down, stride == width) instead of the
+    // internal buffer; BeginFrame then only accepts this size
+    void AttachPixels(uint32_t* pixels, int width, int height);
+    void DetachPixels();
+
+    bool BeginFrame(int width, int height) override;
+    void Clear(const RenderColor& color) override;
+    void FillRoundedRect(const RenderRect& rect, float radius, const RenderColor& color) override;
+    void StrokeRoundedRect(const RenderRect& rect, float radius, float strokeWidth,
+                           const RenderColor& color) override;
+    void FillText(const std::wstring& text, const RenderRect& layout, const RenderColor& color) override;
+    void DrawMask(const uint8_t* coverage, int maskWidth, int maskHeight, int x, int y,
+                  const RenderColor& color) override;
+    bool EndFrame(float windowOpacity) override;
+
+    // Premultiplied BGRA of the last frame, width * height
+    const uint32_t* GetPixels() const { return m_pixels; }
+    int GetWidth() const { return m_width; }
+    int GetHeight() const { return m_height; }
+
+private:
+    // Coverage of each pixel from the distance to the rounded rectangle's
+    // edge: filled uses the inside, stroked a band of strokeWidth around it
+    void RasterizeRoundedRect(const RenderRect& rect, float radius, float strokeWidth, bool stroke,
+                              const RenderColor& color);
+
+    TextMaskProvider m_textMasks;
+    std::vector<uint32_t> m_buffer;
+    std::vector<uint8_t> m_textMask;
+    std::vector<uint8_t> m_rowCoverage;
+    uint32_t* m_attached = nullptr;
+    int m_attachedWidth = 0;
+    int m_attachedHeight = 0;
+
+    uint32_t* m_pixels = nullptr;
+    int m_width = 0;
+    int m_height = 0;
+};
+
+}  // namespace VirtualOverlay
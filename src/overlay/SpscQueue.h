@@ -0,0 +1,59 @@
+#pragma once
+
+// Bounded lock-free queue for one producer thread and one consumer thread.
+//
+// A ring of Capacity slots indexed by two monotonic counters: the producer
+// only writes the tail and the consumer only writes the head, so a push or
+// pop is one acquire load and one release store. Push fails when the ring
+// is full instead of blocking.
+// Platform-independent (no <windows.h>).
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+namespace VirtualOverlay {
+
+template <typename T, size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    SpscQueue() = default;
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // Producer
+    bool Push(T&& value) {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_head.load(std::memory_order_acquire) == Capacity) {
+            return false;
+        }
+        m_slots[tail & (Capacity - 1)] = std::move(value);
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer
+    bool Pop(T& value) {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        value = std::move(m_slots[head & (Capacity - 1)]);
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Either side; only a snapshot while the other side runs
+    bool IsEmpty() const {
+        return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire);
+    }
+
+private:
+    T m_slots[Capacity] = {};
+    alignas(64) std::atomic<size_t> m_head{ 0 };  // Next slot to pop
+    alignas(64) std::atomic<size_t> m_tail{ 0 };  // Next slot to push
+};
+
+}  // namespace VirtualOverlay
@@ -0,0 +1,172 @@
+#pragma once
+
+// Size-keyed pool of render surfaces (bitmap + DC + render target).
+//
+// Creating a DIB section, memory DC and bound D2D render target costs far more
+// than drawing a short label into one. Surfaces are leased with Acquire and
+// handed back with Release; idle surfaces are kept for reuse, least recently
+// used first out once more than maxIdle are parked. Clear drops everything
+// (settings change, device lost).
+//
+// The pool only does bookkeeping: the surface type is opaque and destroyed
+// through the callback, so reuse, eviction and byte accounting work the same
+// with a fake surface.
+// Platform-independent (no <windows.h>).
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace VirtualOverlay {
+
+struct SurfacePoolStats {
+    uint64_t acquires = 0;   // Acquire calls
+    uint64_t reuses = 0;     // Acquires served from an idle surface
+    uint64_t creates = 0;    // Surfaces adopted after a miss
+    uint64_t evictions = 0;  // Idle surfaces dropped over the limit
+    size_t bytes = 0;        // Pixel bytes held (leased + idle)
+    size_t peakBytes = 0;
+};
+
+template <typename Surface>
+class SurfacePool {
+public:
+    using DestroyFn = std::function<void(Surface&)>;
+
+    static constexpr size_t BYTES_PER_PIXEL = 4;  // 32-bit premultiplied BGRA
+
+    explicit SurfacePool(size_t maxIdle, DestroyFn destroy)
+        : m_maxIdle(maxIdle), m_destroy(std::move(destroy)) {
+    }
+
+    ~SurfacePool() { Clear(); }
+
+    SurfacePool(const SurfacePool&) = delete;
+    SurfacePool& operator=(const SurfacePool&) = delete;
+
+    static size_t BytesFor(int width, int height) {
+        return static_cast<size_t>(width) * static_cast<size_t>(height) * BYTES_PER_PIXEL;
+    }
+
+    // Lease an idle surface of exactly width x height; nullptr on a miss (the
+    // caller creates one and hands it to Adopt)
+    Surface* Acquire(int width, int height, uint64_t nowMs) {
+        m_stats.acquires++;
+        Entry* best = nullptr;
+        for (auto& entry : m_entries) {
+            if (!entry->leased && entry->width == width && entry->height == height &&
+                (!best || entry->lastUseMs > best->lastUseMs)) {
+                best = entry.get();
+            }
+        }
+        if (!best) {
+            return nullptr;
+        }
+        m_stats.reuses++;
+        best->leased = true;
+        best->lastUseMs = nowMs;
+        return &best->surface;
+    }
+
+    // Take ownership of a newly created surface; it is returned leased
+    Surface* Adopt(int width, int height, Surface&& surface, uint64_t nowMs) {
+        auto entry = std::make_unique<Entry>();
+        entry->surface = std::move(surface);
+        entry->width = width;
+        entry->height = height;
+        entry->leased = true;
+        entry->lastUseMs = nowMs;
+        Surface* result = &entry->surface;
+        m_entries.push_back(std::move(entry));
+
+        m_stats.creates++;
+        m_stats.bytes += BytesFor(width, height);
+        if (m_stats.bytes > m_stats.peakBytes) {
+            m_stats.peakBytes = m_stats.bytes;
+        }
+        return result;
+    }
+
+    // Return a leased surface to the pool (trims idle surfaces to maxIdle)
+    void Release(Surface* surface, uint64_t nowMs) {
+        for (auto& entry : m_entries) {
+            if (&entry->surface == surface) {
+                entry->leased = false;
+                entry->lastUseMs = nowMs;
+                break;
+            }
+        }
+        Trim();
+    }
+
+    // Destroy a leased surface that went bad (e.g. its render target was lost)
+    void Discard(Surface* surface) {
+        for (size_t i = 0; i < m_entries.size(); i++) {
+            if (&m_entries[i]->surface == surface) {
+                DestroyAt(i);
+                return;
+            }
+        }
+    }
+
+    // Destroy every surface; outstanding leases become invalid
+    void Clear() {
+        while (!m_entries.empty()) {
+            DestroyAt(m_entries.size() - 1);
+        }
+    }
+
+    size_t GetCount() const { return m_entries.size(); }
+    size_t GetIdleCount() const {
+        size_t idle = 0;
+        for (const auto& entry : m_entries) {
+            if (!entry->leased) idle++;
+        }
+        return idle;
+    }
+    size_t GetMaxIdle() const { return m_maxIdle; }
+
+    const SurfacePoolStats& GetStats() const { return m_stats; }
+
+private:
+    struct Entry {
+        Surface surface;
+        int width = 0;
+        int height = 0;
+        bool leased = false;
+        uint64_t lastUseMs = 0;
+    };
+
+    void Trim() {
+        while (GetIdleCount() > m_maxIdle) {
+            size_t oldest = m_entries.size();
+            for (size_t i = 0; i < m_entries.size(); i++) {
+                if (!m_entries[i]->leased &&
+                    (oldest == m_entries.size() || m_entries[i]->lastUseMs < m_entries[oldest]->lastUseMs)) {
+                    oldest = i;
+                }
+            }
+            DestroyAt(oldest);
+            m_stats.evictions++;
+        }
+    }
+
+    void DestroyAt(size_t i) {
+        Entry& entry = *m_entries[i];
+        if (m_destroy) {
+            m_destroy(entry.surface);
+        }
+        m_stats.bytes -= BytesFor(entry.width, entry.height);
+        m_entries.erase(m_entries.begin() + static_cast<std::ptrdiff_t>(i));
+    }
+
+    size_t m_maxIdle;
+    DestroyFn m_destroy;
+    std::vector<std::unique_ptr<Entry>> m_entries;
+    SurfacePoolStats m_stats;
+};
+
+}  // namespace VirtualOverlay
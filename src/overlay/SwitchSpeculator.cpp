@@ -0,0 +1,124 @@
+#include "SwitchSpeculator.h"
+#include <algorithm>
+
+namespace VirtualOverlay {
+
+const char* SpeculationActionToString(SpeculationAction action) {
+    switch (action) {
+        case SpeculationAction::None:           return "none";
+        case SpeculationAction::ShowPrediction: return "show-prediction";
+        case SpeculationAction::ShowActual:     return "show-actual";
+        case SpeculationAction::Retract:        return "retract";
+        default:                                return "unknown";
+    }
+}
+
+SwitchSpeculator::SwitchSpeculator(const SwitchSpeculationConfig& config) {
+    SetConfig(config);
+}
+
+void SwitchSpeculator::SetConfig(const SwitchSpeculationConfig& config) {
+    m_config = config;
+    m_config.latencyBudgetMs = std::min<uint32_t>(m_config.latencyBudgetMs, 1000);
+    m_config.confirmTimeoutMs = std::clamp<uint32_t>(m_config.confirmTimeoutMs,
+                                                     m_config.latencyBudgetMs + 1, 10000);
+}
+
+int SwitchSpeculator::OnSwitchKey(SwitchDirection direction, int currentIndex, int desktopCount,
+                                  uint64_t nowMs) {
+    // Chain from the previous prediction while it is still unconfirmed
+    int from = m_pending ? m_predictedIndex : currentIndex;
+    if (from < 1 || from > desktopCount) {
+        Reset();
+        return 0;
+    }
+
+    int target = (direction == SwitchDirection::Left) ? from - 1 : from + 1;
+    if (target < 1 || target > desktopCount) {
+        return 0;  // Edge of the list: no switch, keep any pending prediction
+    }
+
+    if (!m_pending) {
+        m_originIndex = currentIndex;
+    }
+    m_pending = true;
+    m_shown = false;
+    m_predictedIndex = target;
+    m_keyMs = nowMs;
+    m_stats.predictions++;
+    return target;
+}
+
+SpeculationAction SwitchSpeculator::OnSwitchConfirmed(int desktopIndex) {
+    if (!m_pending) {
+        return SpeculationAction::ShowActual;
+    }
+
+    // A step of a chained sequence landed; the final prediction still stands
+    if (IsIntermediate(desktopIndex)) {
+        return m_shown ? SpeculationAction::None : SpeculationAction::ShowActual;
+    }
+
+    bool shown = m_shown;
+    m_pending = false;
+    m_shown = false;
+
+    if (desktopIndex == m_predictedIndex) {
+        m_stats.hits++;
+        return shown ? SpeculationAction::None : SpeculationAction::ShowPrediction;
+    }
+
+    m_stats.misses++;
+    if (shown) {
+        m_stats.corrections++;
+    }
+    return SpeculationAction::ShowActual;
+}
+
+SpeculationAction SwitchSpeculator::OnTick(uint64_t nowMs) {
+    if (!m_pending) {
+        return SpeculationAction::None;
+    }
+
+    if (nowMs - m_keyMs >= m_config.confirmTimeoutMs) {
+        bool shown = m_shown;
+        m_pending = false;
+        m_shown = false;
+        m_stats.expired++;
+        if (shown) {
+            m_stats.corrections++;
+            return SpeculationAction::Retract;
+        }
+        return SpeculationAction::None;
+    }
+
+    if (!m_shown && nowMs - m_keyMs >= m_config.latencyBudgetMs) {
+        m_shown = true;
+        m_stats.early++;
+        return SpeculationAction::ShowPrediction;
+    }
+    return SpeculationAction::None;
+}
+
+bool SwitchSpeculator::GetNextDeadline(uint64_t& dueMs) const {
+    if (!m_pending) {
+        return false;
+    }
+    dueMs = m_keyMs + (m_shown ? m_config.confirmTimeoutMs : m_config.latencyBudgetMs);
+    return true;
+}
+
+void SwitchSpeculator::Reset() {
+    m_pending = false;
+    m_shown = false;
+    m_originIndex = 0;
+    m_predictedIndex = 0;
+}
+
+bool SwitchSpeculator::IsIntermediate(int desktopIndex) const {
+    int lo = std::min(m_originIndex, m_predictedIndex);
+    int hi = std::max(m_originIndex, m_predictedIndex);
+    return desktopIndex > lo && desktopIndex < hi;
+}
+
+}  // namespace VirtualOverlay
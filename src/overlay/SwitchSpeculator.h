@@ -0,0 +1,97 @@
+#pragma once
+
+// Predicts the target of Win+Ctrl+Left/Right before the switch is detected.
+//
+// The detector only notices a switch after the shell has written it to the
+// registry, and the overlay then formats and rasterizes the label from
+// scratch. With a prediction the label is rasterized while the shell is still
+// animating, presented the moment the switch is confirmed, or presented
+// unconfirmed once the latency budget runs out and corrected afterwards if the
+// guess was wrong.
+//
+// Windows does not wrap at either end of the desktop list, so a key pressed
+// on the first or last desktop predicts nothing. Repeated presses before a
+// confirmation chain from the previous prediction.
+//
+// Pure state machine: timed calls take the current time, so key / switch
+// traces can be replayed with a scripted clock.
+// Platform-independent (no <windows.h>).
+
+#include <cstdint>
+
+namespace VirtualOverlay {
+
+enum class SwitchDirection {
+    Left,
+    Right
+};
+
+// What the caller should do with the overlay after an event
+enum class SpeculationAction {
+    None,            // Nothing to show (or the prediction is already on screen)
+    ShowPrediction,  // Present the pre-rendered predicted label
+    ShowActual,      // Show the confirmed desktop normally (no or wrong prediction)
+    Retract          // A presented prediction was never confirmed: show the real desktop
+};
+
+const char* SpeculationActionToString(SpeculationAction action);
+
+struct SwitchSpeculationConfig {
+    uint32_t latencyBudgetMs = 50;    // Present the prediction unconfirmed after this long (0 = at once)
+    uint32_t confirmTimeoutMs = 750;  // Drop a prediction the detector never confirmed
+};
+
+struct SwitchSpeculationStats {
+    uint64_t predictions = 0;   // Key presses that produced a prediction
+    uint64_t hits = 0;          // Confirmed switch matched the prediction
+    uint64_t misses = 0;        // Confirmed switch went elsewhere
+    uint64_t early = 0;         // Predictions presented before confirmation
+    uint64_t corrections = 0;   // Early presentations that had to be replaced
+    uint64_t expired = 0;       // Predictions never confirmed
+};
+
+class SwitchSpeculator {
+public:
+    explicit SwitchSpeculator(const SwitchSpeculationConfig& config = SwitchSpeculationConfig());
+
+    // Replace the configuration (invalid values are clamped)
+    void SetConfig(const SwitchSpeculationConfig& config);
+    const SwitchSpeculationConfig& GetConfig() const { return m_config; }
+
+    // Switch hotkey pressed on desktop currentIndex (1-based) of desktopCount.
+    // Returns the predicted 1-based target, or 0 if the key cannot switch.
+    int OnSwitchKey(SwitchDirection direction, int currentIndex, int desktopCount, uint64_t nowMs);
+
+    // The detector reported a switch to desktopIndex
+    SpeculationAction OnSwitchConfirmed(int desktopIndex);
+
+    // Timer callback: presents the prediction once the budget is spent and
+    // retracts it after confirmTimeoutMs
+    SpeculationAction OnTick(uint64_t nowMs);
+
+    // Time of the next OnTick that can do something; false if none is pending
+    bool GetNextDeadline(uint64_t& dueMs) const;
+
+    bool IsPending() const { return m_pending; }
+    bool IsPredictionShown() const { return m_pending && m_shown; }
+    int GetPredictedIndex() const { return m_pending ? m_predictedIndex : 0; }
+
+    // Forget the pending prediction without counting it
+    void Reset();
+
+    const SwitchSpeculationStats& GetStats() const { return m_stats; }
+    void ResetStats() { m_stats = SwitchSpeculationStats(); }
+
+private:
+    bool IsIntermediate(int desktopIndex) const;
+
+    SwitchSpeculationConfig m_config;
+    SwitchSpeculationStats m_stats;
+    bool m_pending = false;
+    bool m_shown = false;         // Prediction presented before confirmation
+    int m_originIndex = 0;        // Desktop the first chained key was pressed on
+    int m_predictedIndex = 0;
+    uint64_t m_keyMs = 0;         // Last chained key press
+};
+
+}  // namespace VirtualOverlay
@@ -0,0 +1,94 @@
+#include "TextMetricsCache.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace VirtualOverlay {
+
+namespace {
+
+void HashCombine(size_t& seed, size_t value) {
+    seed ^= value + 0x9E3779B97F4A7C15ull + (seed << 6) + (seed >> 2);
+}
+
+}  // namespace
+
+bool TextMetricsKey::operator==(const TextMetricsKey& other) const {
+    return fontSize == other.fontSize && fontWeight == other.fontWeight &&
+           text == other.text && fontFamily == other.fontFamily;
+}
+
+size_t TextMetricsKeyHash::operator()(const TextMetricsKey& key) const {
+    uint32_t sizeBits = 0;
+    std::memcpy(&sizeBits, &key.fontSize, sizeof(sizeBits));
+
+    size_t seed = std::hash<std::wstring>()(key.text);
+    HashCombine(seed, std::hash<std::wstring>()(key.fontFamily));
+    HashCombine(seed, sizeBits);
+    HashCombine(seed, static_cast<size_t>(key.fontWeight));
+    return seed;
+}
+
+void FitInkBounds(const TextMetrics& metrics, int margin, int& width, int& height) {
+    // Whole pixels the ink touches; blank text still gets a 1x1 interior
+    int inkWidth = 0;
+    int inkHeight = 0;
+    if (metrics.GetInkWidth() > 0.0f && metrics.GetInkHeight() > 0.0f) {
+        inkWidth = static_cast<int>(std::ceil(metrics.inkRight) - std::floor(metrics.inkLeft));
+        inkHeight = static_cast<int>(std::ceil(metrics.inkBottom) - std::floor(metrics.inkTop));
+    }
+    margin = std::max(margin, 0);
+    width = std::max(inkWidth, 1) + margin * 2;
+    height = std::max(inkHeight, 1) + margin * 2;
+}
+
+void CenterInk(const TextMetrics& metrics, int width, int height, float& left, float& top) {
+    float inkWidth = metrics.GetInkWidth();
+    float inkHeight = metrics.GetInkHeight();
+    if (inkWidth <= 0.0f || inkHeight <= 0.0f) {
+        // Nothing drawn: center the layout box instead
+        left = std::round((width - metrics.width) * 0.5f);
+        top = std::round((height - metrics.height) * 0.5f);
+        return;
+    }
+    left = std::round((width - inkWidth) * 0.5f - metrics.inkLeft);
+    top = std::round((height - inkHeight) * 0.5f - metrics.inkTop);
+}
+
+TextMetricsCache::TextMetricsCache(size_t maxEntries)
+    : m_maxEntries(std::max<size_t>(maxEntries, 1)) {
+}
+
+bool TextMetricsCache::Measure(const TextMetricsKey& key, TextMetrics& metrics) {
+    auto found = m_index.find(key);
+    if (found != m_index.end()) {
+        m_stats.hits++;
+        m_entries.splice(m_entries.begin(), m_entries, found->second);
+        metrics = found->second->second;
+        return true;
+    }
+
+    m_stats.misses++;
+    TextMetrics measured;
+    if (!m_provider || !m_provider(key, measured)) {
+        m_stats.failures++;
+        return false;
+    }
+
+    while (m_entries.size() >= m_maxEntries) {
+        m_index.erase(m_entries.back().first);
+        m_entries.pop_back();
+        m_stats.evictions++;
+    }
+    m_entries.emplace_front(key, measured);
+    m_index[key] = m_entries.begin();
+    metrics = measured;
+    return true;
+}
+
+void TextMetricsCache::Clear() {
+    m_entries.clear();
+    m_index.clear();
+}
+
+}  // namespace VirtualOverlay
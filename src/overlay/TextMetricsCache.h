@@ -0,0 +1,96 @@
+#pragma once
+
+// Measured extents of single-line labels, keyed by text and font.
+//
+// The watermark window used to be sized from 0.6 x fontSize per character,
+// which is far off for wide glyphs, emoji or CJK names: the layered window
+// and its bitmap were either much larger than the text or clipped it. Labels
+// are now measured by a TextMetricsProvider (DirectWrite layout and overhang
+// metrics on Windows) and the bitmap is fitted to the ink. Measuring means
+// shaping, so results are kept least-recently-used; failed measurements are
+// not cached and are retried on the next call.
+// Platform-independent (no <windows.h>).
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace VirtualOverlay {
+
+struct TextMetricsKey {
+    std::wstring text;
+    std::wstring fontFamily;
+    float fontSize = 0.0f;
+    int fontWeight = 0;
+
+    bool operator==(const TextMetricsKey& other) const;
+    bool operator!=(const TextMetricsKey& other) const { return !(*this == other); }
+};
+
+struct TextMetricsKeyHash {
+    size_t operator()(const TextMetricsKey& key) const;
+};
+
+// One line of text laid out from (0, 0), in pixels
+struct TextMetrics {
+    float width = 0.0f;    // Advance width, including trailing whitespace
+    float height = 0.0f;   // Line height
+    // Ink bounds relative to the layout box; glyphs may overhang it
+    float inkLeft = 0.0f;
+    float inkTop = 0.0f;
+    float inkRight = 0.0f;
+    float inkBottom = 0.0f;
+
+    float GetInkWidth() const { return inkRight > inkLeft ? inkRight - inkLeft : 0.0f; }
+    float GetInkHeight() const { return inkBottom > inkTop ? inkBottom - inkTop : 0.0f; }
+};
+
+// Shapes and measures a label; false if it cannot (no font, no factory)
+using TextMetricsProvider = std::function<bool(const TextMetricsKey& key, TextMetrics& metrics)>;
+
+// Smallest bitmap holding the ink with margin pixels on every side
+void FitInkBounds(const TextMetrics& metrics, int margin, int& width, int& height);
+
+// Whole-pixel origin for the layout box that centers the ink in a
+// width x height bitmap
+void CenterInk(const TextMetrics& metrics, int width, int height, float& left, float& top);
+
+struct TextMetricsCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t failures = 0;    // Provider missing or unable to measure
+    uint64_t evictions = 0;
+};
+
+class TextMetricsCache {
+public:
+    static constexpr size_t DEFAULT_MAX_ENTRIES = 128;
+
+    explicit TextMetricsCache(size_t maxEntries = DEFAULT_MAX_ENTRIES);
+
+    void SetProvider(TextMetricsProvider provider) { m_provider = std::move(provider); }
+
+    // Cached metrics, or measure them with the provider
+    bool Measure(const TextMetricsKey& key, TextMetrics& metrics);
+
+    void Clear();
+
+    size_t GetCount() const { return m_entries.size(); }
+    const TextMetricsCacheStats& GetStats() const { return m_stats; }
+
+private:
+    using Entry = std::pair<TextMetricsKey, TextMetrics>;
+    using EntryList = std::list<Entry>;
+
+    TextMetricsProvider m_provider;
+    size_t m_maxEntries;
+    EntryList m_entries;  // Most recently used first
+    std::unordered_map<TextMetricsKey, EntryList::iterator, TextMetricsKeyHash> m_index;
+    TextMetricsCacheStats m_stats;
+};
+
+}  // namespace VirtualOverlay
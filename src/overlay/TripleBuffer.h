@@ -0,0 +1,60 @@
+#pragma once
+
+// Lock-free hand-off of the newest value from one producer thread to one
+// consumer thread.
+//
+// Three slots: the producer fills its back slot and publishes it, swapping
+// it with the middle one; the consumer swaps the middle slot with its front
+// slot when something new was published. Neither side ever waits for the
+// other, values the consumer never picked up are overwritten (latest wins),
+// and slots are reused, so a T holding vectors keeps its capacity.
+// Platform-independent (no <windows.h>).
+
+#include <atomic>
+#include <cstdint>
+
+namespace VirtualOverlay {
+
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() = default;
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    // Producer: the slot to fill, owned by the producer until Publish
+    T& GetWriteBuffer() { return m_slots[m_write]; }
+
+    // Producer: make the written slot the newest value. True if it replaced
+    // a value the consumer never picked up.
+    bool Publish() {
+        uint8_t previous = m_middle.exchange(static_cast<uint8_t>(m_write | FRESH),
+                                             std::memory_order_acq_rel);
+        m_write = previous & INDEX_MASK;
+        return (previous & FRESH) != 0;
+    }
+
+    // Consumer: adopt the newest published value; false if nothing new
+    bool Consume() {
+        if ((m_middle.load(std::memory_order_relaxed) & FRESH) == 0) {
+            return false;
+        }
+        uint8_t previous = m_middle.exchange(m_read, std::memory_order_acq_rel);
+        m_read = previous & INDEX_MASK;
+        return true;
+    }
+
+    // Consumer: the value adopted by the last successful Consume
+    const T& GetReadBuffer() const { return m_slots[m_read]; }
+
+private:
+    static constexpr uint8_t INDEX_MASK = 0x3;
+    static constexpr uint8_t FRESH = 0x4;   // Middle slot not consumed yet
+
+    T m_slots[3];
+    uint8_t m_write = 0;                    // Producer only
+    uint8_t m_read = 1;                     // Consumer only
+    std::atomic<uint8_t> m_middle{ 2 };
+};
+
+}  // namespace VirtualOverlay
@@ -0,0 +1,66 @@
+#include "UpdateCoalescer.h"
+#include <algorithm>
+
+namespace VirtualOverlay {
+
+UpdateCoalescer::UpdateCoalescer(const UpdateCoalescingConfig& config) {
+    SetConfig(config);
+}
+
+void UpdateCoalescer::SetConfig(const UpdateCoalescingConfig& config) {
+    m_config = config;
+    m_config.frameIntervalMs = std::clamp<uint32_t>(m_config.frameIntervalMs, 1, 1000);
+    m_config.settleMs = std::min<uint32_t>(m_config.settleMs, 1000);
+    m_config.maxLatencyMs = std::clamp<uint32_t>(m_config.maxLatencyMs, m_config.frameIntervalMs, 2000);
+}
+
+void UpdateCoalescer::Submit(const OverlayUpdate& update, uint64_t nowMs) {
+    m_stats.received++;
+    if (m_pending) {
+        m_stats.superseded++;
+    } else {
+        m_firstMs = nowMs;
+        m_leading = !m_hasRendered || nowMs >= m_renderMs + m_config.settleMs;
+    }
+    m_update = update;
+    m_pending = true;
+    m_lastMs = nowMs;
+}
+
+bool UpdateCoalescer::GetNextDeadline(uint64_t& dueMs) const {
+    if (!m_pending) {
+        return false;
+    }
+
+    if (m_leading) {
+        dueMs = m_firstMs;
+    } else {
+        dueMs = std::min(m_lastMs + m_config.settleMs, m_firstMs + m_config.maxLatencyMs);
+    }
+    if (m_hasRendered) {
+        dueMs = std::max(dueMs, m_renderMs + m_config.frameIntervalMs);
+    }
+    return true;
+}
+
+bool UpdateCoalescer::Take(uint64_t nowMs, OverlayUpdate& update) {
+    uint64_t dueMs;
+    if (!GetNextDeadline(dueMs) || nowMs < dueMs) {
+        return false;
+    }
+
+    update = m_update;
+    m_pending = false;
+    m_hasRendered = true;
+    m_renderMs = nowMs;
+    m_stats.rendered++;
+    m_stats.maxWaitMs = std::max(m_stats.maxWaitMs, nowMs - m_firstMs);
+    return true;
+}
+
+void UpdateCoalescer::Reset() {
+    m_pending = false;
+    m_leading = false;
+}
+
+}  // namespace VirtualOverlay
@@ -0,0 +1,80 @@
+#pragma once
+
+// Latest-wins pacing for overlay updates during rapid desktop flipping.
+//
+// Holding Win+Ctrl+Right across ten desktops used to show the overlay ten
+// times: each Show moved the window, resized it and rendered a label that
+// was already stale by the time it reached the screen. Updates now
+// overwrite one pending slot and are rendered at most once per frame
+// interval:
+//   - the first update of a burst (nothing rendered for settleMs) is due at
+//     once, so a single switch is never delayed;
+//   - later ones wait until settleMs pass without a newer update, but no
+//     longer than maxLatencyMs after the oldest unrendered one arrived.
+//
+// Pure policy: every timed call takes the current time, so burst traces can
+// be replayed with a scripted clock.
+// Platform-independent (no <windows.h>).
+
+#include <cstdint>
+#include <string>
+
+namespace VirtualOverlay {
+
+// Desktop the overlay should show
+struct OverlayUpdate {
+    int desktopIndex = 0;
+    std::wstring desktopName;
+};
+
+struct UpdateCoalescingConfig {
+    uint32_t frameIntervalMs = 16;   // Minimum time between two renders
+    uint32_t settleMs = 40;          // Quiet time that ends a burst
+    uint32_t maxLatencyMs = 100;     // Longest an update waits inside a burst
+};
+
+struct UpdateCoalescerStats {
+    uint64_t received = 0;      // Updates submitted
+    uint64_t rendered = 0;      // Updates handed out for rendering
+    uint64_t superseded = 0;    // Overwritten before they were rendered
+    uint64_t maxWaitMs = 0;     // Longest submit-to-render delay seen
+};
+
+class UpdateCoalescer {
+public:
+    explicit UpdateCoalescer(const UpdateCoalescingConfig& config = UpdateCoalescingConfig());
+
+    // Replace the configuration (invalid values are clamped)
+    void SetConfig(const UpdateCoalescingConfig& config);
+    const UpdateCoalescingConfig& GetConfig() const { return m_config; }
+
+    // Store the newest state, replacing any pending one
+    void Submit(const OverlayUpdate& update, uint64_t nowMs);
+
+    // When the pending update should be rendered; false if none is pending
+    bool GetNextDeadline(uint64_t& dueMs) const;
+
+    // Hand out the pending update if it is due and count it as rendered
+    bool Take(uint64_t nowMs, OverlayUpdate& update);
+
+    bool IsPending() const { return m_pending; }
+
+    // Drop the pending update (overlay hidden) without counting it
+    void Reset();
+
+    const UpdateCoalescerStats& GetStats() const { return m_stats; }
+    void ResetStats() { m_stats = UpdateCoalescerStats(); }
+
+private:
+    UpdateCoalescingConfig m_config;
+    UpdateCoalescerStats m_stats;
+    OverlayUpdate m_update;
+    bool m_pending = false;
+    bool m_leading = false;         // Pending update opened a burst
+    uint64_t m_firstMs = 0;         // Oldest unrendered submit
+    uint64_t m_lastMs = 0;          // Newest submit
+    bool m_hasRendered = false;
+    uint64_t m_renderMs = 0;        // Last Take
+};
+
+}  // namespace VirtualOverlay
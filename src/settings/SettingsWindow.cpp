@@ -441,11 +441,15 @@ void SettingsWindow::PreviewOverlay() {
     previewSettings.watermarkFontSize = overlayConfig.watermarkFontSize;
     previewSettings.watermarkOpacity = overlayConfig.watermarkOpacity;
     previewSettings.watermarkShadow = overlayConfig.watermarkShadow;
+    previewSettings.watermarkOutlineWidth = overlayConfig.watermarkOutlineWidth;
+    previewSettings.watermarkGlowRadius = overlayConfig.watermarkGlowRadius;
+    previewSettings.distanceFieldText = overlayConfig.distanceFieldText;
     previewSettings.watermarkColor = overlayConfig.watermarkColor;
     
     // Dodge settings
     previewSettings.dodgeOnHover = overlayConfig.dodgeOnHover;
     previewSettings.dodgeProximity = overlayConfig.dodgeProximity;
+    previewSettings.labelCacheKB = overlayConfig.labelCacheKB;
     
     previewSettings.style.backdrop = overlayConfig.style.blur;
     previewSettings.style.tintColor = overlayConfig.style.tintColor;
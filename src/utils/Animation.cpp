@@ -1,11 +1,16 @@
 #include "Animation.h"
 #include <algorithm>
 
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
 namespace VirtualOverlay {
 
 constexpr float PI = 3.14159265358979323846f;
 
 bool ShouldReduceMotion() {
+#ifdef _WIN32
     // Check SPI_GETCLIENTAREAANIMATION - indicates if animations should be shown
     BOOL animationsEnabled = TRUE;
     SystemParametersInfoW(SPI_GETCLIENTAREAANIMATION, 0, &animationsEnabled, 0);
@@ -25,6 +30,7 @@ bool ShouldReduceMotion() {
     if (!menuFade && !menuAnimation) {
         return true;
     }
+#endif
 
     return false;
 }
@@ -1,6 +1,5 @@
 #pragma once
 
-#include <windows.h>
 #include <cmath>
 #include <functional>
 
@@ -116,4 +115,84 @@ private:
     float m_smoothing = 0.15f;
 };
 
+// One Euro filter (Casiez, Roussel, Vogel, CHI 2012): a low-pass filter
+// whose cutoff rises with the speed of the signal. Slow movement and
+// tremor are smoothed hard (minCutoff), fast movement passes with little
+// lag (beta: cutoff added per unit/s of speed). The speed itself is
+// low-pass filtered at derivativeCutoff.
+template <typename T>
+class OneEuroFilter {
+public:
+    OneEuroFilter() = default;
+    OneEuroFilter(T minCutoff, T beta, T derivativeCutoff = T(1))
+        : m_minCutoff(minCutoff), m_beta(beta), m_derivativeCutoff(derivativeCutoff) {
+    }
+
+    // Cutoffs in Hz, beta in Hz per unit/s
+    void SetParameters(T minCutoff, T beta, T derivativeCutoff = T(1)) {
+        m_minCutoff = minCutoff;
+        m_beta = beta;
+        m_derivativeCutoff = derivativeCutoff;
+    }
+
+    // Filter one sample taken deltaTime seconds after the previous one; the
+    // first sample after a reset passes through. scale: how many times the
+    // output is magnified where it is seen (the zoom level). Speed is judged
+    // at that scale and the minimum cutoff drops by it, so tremor magnified
+    // n times is smoothed n times harder while a pan that is fast on screen
+    // stays responsive.
+    T Filter(T value, T deltaTime, T scale = T(1)) {
+        if (!m_initialized || !(deltaTime > T(0))) {
+            if (!m_initialized) {
+                m_value = value;
+                m_speed = T(0);
+                m_initialized = true;
+            }
+            return m_value;
+        }
+        if (!(scale > T(0))) {
+            scale = T(1);
+        }
+
+        T speed = (value - m_value) / deltaTime;
+        m_speed += (speed - m_speed) * Alpha(m_derivativeCutoff, deltaTime);
+
+        T cutoff = m_minCutoff / scale + m_beta * std::abs(m_speed) * scale;
+        m_value += (value - m_value) * Alpha(cutoff, deltaTime);
+        return m_value;
+    }
+
+    // Next sample passes through
+    void Reset() { m_initialized = false; }
+
+    // Continue from value at rest
+    void Reset(T value) {
+        m_value = value;
+        m_speed = T(0);
+        m_initialized = true;
+    }
+
+    T GetValue() const { return m_value; }
+    T GetSpeed() const { return m_speed; }  // Filtered, units/s
+    bool IsInitialized() const { return m_initialized; }
+
+private:
+    // Smoothing factor of a first-order low-pass at this cutoff and rate
+    static T Alpha(T cutoff, T deltaTime) {
+        if (!(cutoff > T(0))) {
+            return T(0);
+        }
+        T tau = T(1) / (T(2) * T(3.14159265358979323846) * cutoff);
+        return T(1) / (T(1) + tau / deltaTime);
+    }
+
+    T m_minCutoff = T(1);
+    T m_beta = T(0);
+    T m_derivativeCutoff = T(1);
+
+    bool m_initialized = false;
+    T m_value = T(0);
+    T m_speed = T(0);
+};
+
 }  // namespace VirtualOverlay
@@ -0,0 +1,35 @@
+#pragma once
+
+// x86 SIMD feature detection for the pixel and mask kernels.
+//
+// Kernels are compiled for each instruction set with VO_TARGET_* (MSVC
+// accepts the intrinsics without /arch; GCC/Clang need a per-function
+// target) and picked at runtime from GetCpuFeatures(), so one binary runs
+// everywhere and uses AVX2 where it exists.
+// Platform-independent (no <windows.h>).
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define VO_CPU_X86 1
+#if defined(_MSC_VER)
+#define VO_TARGET_SSE2
+#define VO_TARGET_SSE41
+#define VO_TARGET_AVX2
+#else
+#define VO_TARGET_SSE2 __attribute__((target("sse2")))
+#define VO_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define VO_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace VirtualOverlay {
+
+struct CpuFeatures {
+    bool sse2 = false;
+    bool sse41 = false;
+    bool avx2 = false;   // Includes OS support for the YMM state
+};
+
+// Detected once
+const CpuFeatures& GetCpuFeatures();
+
+}  // namespace VirtualOverlay
@@ -0,0 +1,199 @@
+#include "CursorPredictor.h"
+#include <algorithm>
+#include <cmath>
+
+namespace VirtualOverlay {
+
+namespace {
+
+// Velocity variance of a fresh Kalman track: the first samples set it
+constexpr float INITIAL_VELOCITY_VARIANCE = 1.0e6f;
+
+}  // namespace
+
+const char* CursorPredictionModeToString(CursorPredictionMode mode) {
+    switch (mode) {
+        case CursorPredictionMode::Off:          return "off";
+        case CursorPredictionMode::Kalman:       return "kalman";
+        case CursorPredictionMode::LeastSquares: return "least-squares";
+        default:                                 return "unknown";
+    }
+}
+
+CursorPredictor::CursorPredictor() {
+    Reset();
+}
+
+void CursorPredictor::SetConfig(const CursorPredictorConfig& config) {
+    m_config = config;
+    m_config.historySamples = std::clamp<uint32_t>(config.historySamples, 2, MAX_HISTORY);
+    Reset();
+}
+
+void CursorPredictor::AddSample(double timeMs, float x, float y) {
+    float dt = 0.0f;
+    if (m_count > 0) {
+        double sinceLast = timeMs - GetSample(0).timeMs;
+        if (!(sinceLast > 0.0)) {
+            return;
+        }
+        if (sinceLast > MAX_SAMPLE_GAP_MS) {
+            Reset();
+        } else {
+            dt = static_cast<float>(sinceLast / 1000.0);
+        }
+    }
+
+    Sample& sample = m_history[m_next];
+    sample.timeMs = timeMs;
+    sample.x = x;
+    sample.y = y;
+    m_next = (m_next + 1) % MAX_HISTORY;
+    m_count = std::min(m_count + 1, MAX_HISTORY);
+
+    if (m_config.mode != CursorPredictionMode::Kalman) {
+        return;
+    }
+    if (m_count == 1) {
+        m_kalmanX = { x, 0.0f, m_config.measurementNoise, 0.0f, INITIAL_VELOCITY_VARIANCE };
+        m_kalmanY = { y, 0.0f, m_config.measurementNoise, 0.0f, INITIAL_VELOCITY_VARIANCE };
+        return;
+    }
+    UpdateKalman(m_kalmanX, x, dt);
+    UpdateKalman(m_kalmanY, y, dt);
+}
+
+bool CursorPredictor::Predict(float& x, float& y) const {
+    if (m_count == 0) {
+        return false;
+    }
+
+    const Sample& newest = GetSample(0);
+    x = newest.x;
+    y = newest.y;
+    if (m_config.mode == CursorPredictionMode::Off || m_count < 2 || !(m_config.leadMs > 0.0f)) {
+        return true;
+    }
+
+    float vx = 0.0f;
+    float vy = 0.0f;
+    GetVelocity(vx, vy);
+    float leadSec = m_config.leadMs / 1000.0f;
+    float offsetX = vx * leadSec;
+    float offsetY = vy * leadSec;
+
+    // Lead only along the last step, and no further than that step's speed
+    // carries the cursor in the lead time. A cursor that has stopped (or
+    // turned back) is predicted where it is.
+    const Sample& previous = GetSample(1);
+    float stepX = newest.x - previous.x;
+    float stepY = newest.y - previous.y;
+    if (offsetX * stepX + offsetY * stepY <= 0.0f) {
+        return true;
+    }
+
+    float stepMs = static_cast<float>(newest.timeMs - previous.timeMs);
+    float maxLength = std::sqrt(stepX * stepX + stepY * stepY) * m_config.leadMs / stepMs;
+    float length = std::sqrt(offsetX * offsetX + offsetY * offsetY);
+    if (length > maxLength) {
+        offsetX *= maxLength / length;
+        offsetY *= maxLength / length;
+    }
+
+    x += offsetX;
+    y += offsetY;
+    return true;
+}
+
+void CursorPredictor::GetVelocity(float& vx, float& vy) const {
+    vx = 0.0f;
+    vy = 0.0f;
+    if (m_count < 2) {
+        return;
+    }
+
+    switch (m_config.mode) {
+        case CursorPredictionMode::Kalman:
+            vx = m_kalmanX.velocity;
+            vy = m_kalmanY.velocity;
+            break;
+        case CursorPredictionMode::LeastSquares:
+            FitLeastSquares(vx, vy);
+            break;
+        default:
+            break;
+    }
+}
+
+void CursorPredictor::Reset() {
+    m_next = 0;
+    m_count = 0;
+    m_kalmanX = KalmanAxis();
+    m_kalmanY = KalmanAxis();
+}
+
+const CursorPredictor::Sample& CursorPredictor::GetSample(size_t age) const {
+    return m_history[(m_next + MAX_HISTORY - 1 - age) % MAX_HISTORY];
+}
+
+void CursorPredictor::UpdateKalman(KalmanAxis& axis, float measurement, float dt) const {
+    // Predict: x' = F x, P' = F P F^T + Q for F = [1 dt; 0 1] and white
+    // acceleration noise
+    float q = m_config.accelerationNoise;
+    float position = axis.position + axis.velocity * dt;
+    float p00 = axis.p00 + 2.0f * dt * axis.p01 + dt * dt * axis.p11 + q * dt * dt * dt / 3.0f;
+    float p01 = axis.p01 + dt * axis.p11 + q * dt * dt / 2.0f;
+    float p11 = axis.p11 + q * dt;
+
+    // Correct with the measured position
+    float innovation = measurement - position;
+    float s = p00 + m_config.measurementNoise;
+    float k0 = p00 / s;
+    float k1 = p01 / s;
+
+    axis.position = position + k0 * innovation;
+    axis.velocity += k1 * innovation;
+    axis.p00 = (1.0f - k0) * p00;
+    axis.p01 = (1.0f - k0) * p01;
+    axis.p11 = p11 - k1 * p01;
+}
+
+void CursorPredictor::FitLeastSquares(float& vx, float& vy) const {
+    // Slope of the best line through the last samples, times relative to
+    // the newest to keep the sums small
+    size_t n = std::min<size_t>(m_count, m_config.historySamples);
+    double origin = GetSample(0).timeMs;
+
+    double meanT = 0.0;
+    double meanX = 0.0;
+    double meanY = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        const Sample& sample = GetSample(i);
+        meanT += sample.timeMs - origin;
+        meanX += sample.x;
+        meanY += sample.y;
+    }
+    meanT /= n;
+    meanX /= n;
+    meanY /= n;
+
+    double stt = 0.0;
+    double stx = 0.0;
+    double sty = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        const Sample& sample = GetSample(i);
+        double t = sample.timeMs - origin - meanT;
+        stt += t * t;
+        stx += t * (sample.x - meanX);
+        sty += t * (sample.y - meanY);
+    }
+    if (stt <= 0.0) {
+        return;
+    }
+
+    // Pixels per ms to pixels per second
+    vx = static_cast<float>(stx / stt * 1000.0);
+    vy = static_cast<float>(sty / stt * 1000.0);
+}
+
+}  // namespace VirtualOverlay
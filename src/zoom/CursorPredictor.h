@@ -0,0 +1,92 @@
+#pragma once
+
+// Cursor position a little ahead of the newest sample, to make up for the
+// time between GetCursorPos on the zoom timer and the magnified frame
+// reaching the screen.
+//
+// The velocity comes from either a constant-velocity Kalman filter or a
+// least-squares line through the last few samples. The prediction is the
+// newest sample plus velocity times the lead, clamped so that it never
+// reaches further than the cursor's last step would carry it, and never
+// against that step: when the cursor stops, the prediction is back on it
+// at the next sample instead of coasting past.
+// Platform-independent (no <windows.h>).
+
+#include <cstddef>
+#include <cstdint>
+
+namespace VirtualOverlay {
+
+enum class CursorPredictionMode : uint8_t {
+    Off,
+    Kalman,
+    LeastSquares
+};
+
+const char* CursorPredictionModeToString(CursorPredictionMode mode);
+
+struct CursorPredictorConfig {
+    CursorPredictionMode mode = CursorPredictionMode::Off;
+    float leadMs = 16.0f;               // How far ahead to predict
+    uint32_t historySamples = 3;        // LeastSquares: samples in the fit (2-16)
+    float accelerationNoise = 2.0e6f;   // Kalman: process noise, (px/s^2)^2 per Hz
+    float measurementNoise = 1.0f;      // Kalman: sample variance, px^2
+};
+
+class CursorPredictor {
+public:
+    CursorPredictor();
+
+    // Also drops the sample history
+    void SetConfig(const CursorPredictorConfig& config);
+    const CursorPredictorConfig& GetConfig() const { return m_config; }
+
+    // Sample taken at timeMs (any monotonic clock). Samples at or before the
+    // previous one are ignored; after a gap of more than MAX_SAMPLE_GAP_MS
+    // the history starts over.
+    void AddSample(double timeMs, float x, float y);
+
+    // Position leadMs after the newest sample: the sample itself while the
+    // mode is Off or there is only one sample. False with no samples.
+    bool Predict(float& x, float& y) const;
+
+    // Estimated velocity in pixels per second
+    void GetVelocity(float& vx, float& vy) const;
+
+    bool HasSample() const { return m_count > 0; }
+    void Reset();
+
+    static constexpr size_t MAX_HISTORY = 16;
+    static constexpr double MAX_SAMPLE_GAP_MS = 100.0;
+
+private:
+    struct Sample {
+        double timeMs = 0.0;
+        float x = 0.0f;
+        float y = 0.0f;
+    };
+
+    // Position and velocity along one axis with their covariance
+    struct KalmanAxis {
+        float position = 0.0f;
+        float velocity = 0.0f;
+        float p00 = 0.0f;
+        float p01 = 0.0f;
+        float p11 = 0.0f;
+    };
+
+    const Sample& GetSample(size_t age) const;  // 0 = newest
+    void UpdateKalman(KalmanAxis& axis, float measurement, float dt) const;
+    void FitLeastSquares(float& vx, float& vy) const;
+
+    CursorPredictorConfig m_config;
+
+    Sample m_history[MAX_HISTORY];
+    size_t m_next = 0;      // Ring position of the next sample
+    size_t m_count = 0;
+
+    KalmanAxis m_kalmanX;
+    KalmanAxis m_kalmanY;
+};
+
+}  // namespace VirtualOverlay
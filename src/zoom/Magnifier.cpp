@@ -29,7 +29,7 @@ bool Magnifier::Init() {
         LOG_WARN("Windows Magnifier is already running, zoom may conflict");
     }
 
-    // Don't call MagInitialize here - defer it to SetFullscreenMagnification.
+    // Don't call MagInitialize here - defer it to SetFullscreenTransform.
     // The DWM magnification pipeline adds mouse input latency even at 1.0x,
     // so we only activate it when actually zooming.
 
@@ -59,7 +59,7 @@ bool Magnifier::IsInitialized() const {
     return m_initialized;
 }
 
-bool Magnifier::SetFullscreenMagnification(float level, int centerX, int centerY) {
+bool Magnifier::SetFullscreenTransform(const MagnifierTransform& transform) {
     // Lazily initialize the Magnification API on first use.
     // We defer initialization so the DWM magnification pipeline
     // is only active while actually zoomed, avoiding mouse latency.
@@ -83,55 +83,21 @@ bool Magnifier::SetFullscreenMagnification(float level, int centerX, int centerY
         LOG_DEBUG("Magnification API activated for zoom session");
     }
 
-    // Clamp level to valid range
-    if (level < 1.0f) level = 1.0f;
-    if (level > 20.0f) level = 20.0f;
-
-    // Calculate the offset for the magnification
-    // The offset determines which part of the screen is visible
-    // When zoomed, the visible area is (screenSize / level)
-    // We want to center on (centerX, centerY)
-    
-    // Get virtual screen dimensions (spans all monitors)
-    int virtualLeft = GetSystemMetrics(SM_XVIRTUALSCREEN);
-    int virtualTop = GetSystemMetrics(SM_YVIRTUALSCREEN);
-    int virtualWidth = GetSystemMetrics(SM_CXVIRTUALSCREEN);
-    int virtualHeight = GetSystemMetrics(SM_CYVIRTUALSCREEN);
-    
-    // Calculate visible dimensions when zoomed
-    float visibleWidth = static_cast<float>(virtualWidth) / level;
-    float visibleHeight = static_cast<float>(virtualHeight) / level;
-    
-    // Calculate offset to center on the given point
-    // The offset is relative to virtual screen origin
-    int offsetX = static_cast<int>(centerX - virtualLeft - visibleWidth / 2.0f);
-    int offsetY = static_cast<int>(centerY - virtualTop - visibleHeight / 2.0f);
-    
-    // Clamp offsets to valid range
-    int maxOffsetX = static_cast<int>(virtualWidth - visibleWidth);
-    int maxOffsetY = static_cast<int>(virtualHeight - visibleHeight);
-    
-    if (offsetX < 0) offsetX = 0;
-    if (offsetY < 0) offsetY = 0;
-    if (maxOffsetX > 0 && offsetX > maxOffsetX) offsetX = maxOffsetX;
-    if (maxOffsetY > 0 && offsetY > maxOffsetY) offsetY = maxOffsetY;
-
     // Skip redundant API calls when values haven't changed
-    if (level == m_lastLevel && offsetX == m_lastOffsetX && offsetY == m_lastOffsetY) {
+    if (m_hasLastTransform && transform == m_lastTransform) {
         return true;
     }
 
     // Apply the magnification transform
-    if (!MagSetFullscreenTransform(level, offsetX, offsetY)) {
+    if (!MagSetFullscreenTransform(transform.level, transform.offsetX, transform.offsetY)) {
         DWORD error = GetLastError();
         LOG_ERROR("MagSetFullscreenTransform failed with error: %lu", error);
         return false;
     }
 
-    m_currentLevel = level;
-    m_lastLevel = level;
-    m_lastOffsetX = offsetX;
-    m_lastOffsetY = offsetY;
+    m_currentLevel = transform.level;
+    m_hasLastTransform = true;
+    m_lastTransform = transform;
     return true;
 }
 
@@ -174,9 +140,7 @@ bool Magnifier::ResetMagnification() {
 
     m_initialized = false;
     m_currentLevel = 1.0f;
-    m_lastLevel = 0.0f;
-    m_lastOffsetX = -1;
-    m_lastOffsetY = -1;
+    m_hasLastTransform = false;
     LOG_DEBUG("Magnification fully deactivated");
     return true;
 }
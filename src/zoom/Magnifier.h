@@ -1,12 +1,13 @@
 #pragma once
 
+#include "MagnifierBackend.h"
 #include <windows.h>
 
 namespace VirtualOverlay {
 
 // Wrapper for Windows Magnification API
 // Provides fullscreen zoom functionality
-class Magnifier {
+class Magnifier : public MagnifierBackend {
 public:
     static Magnifier& Instance();
 
@@ -19,25 +20,25 @@ public:
     void Shutdown();
 
     // Check if magnification is available and initialized
-    bool IsInitialized() const;
+    bool IsInitialized() const override;
 
     // Set fullscreen magnification
-    // level: Magnification factor (1.0 = no zoom, 2.0 = 2x zoom, etc.)
-    // centerX, centerY: Screen coordinates to center zoom on
-    bool SetFullscreenMagnification(float level, int centerX, int centerY);
+    // transform: level and offsets from ComputeMagnifierTransform, which
+    // clamps them to the virtual screen
+    bool SetFullscreenTransform(const MagnifierTransform& transform) override;
 
     // Get current magnification level
     float GetMagnificationLevel() const;
     
     // Reset magnification to 1.0 (no zoom)
-    bool ResetMagnification();
+    bool ResetMagnification() override;
 
     // Check if Windows Magnifier is running (conflict detection)
     static bool IsWindowsMagnifierActive();
 
 private:
     Magnifier();
-    ~Magnifier();
+    ~Magnifier() override;
     Magnifier(const Magnifier&) = delete;
     Magnifier& operator=(const Magnifier&) = delete;
 
@@ -45,9 +46,8 @@ private:
     float m_currentLevel = 1.0f;
 
     // Cached params to skip redundant MagSetFullscreenTransform calls
-    float m_lastLevel = 0.0f;
-    int m_lastOffsetX = -1;
-    int m_lastOffsetY = -1;
+    bool m_hasLastTransform = false;
+    MagnifierTransform m_lastTransform;
 
     // Saved mouse settings to restore after magnification session.
     // MagSetFullscreenTransform without UIAccess can modify the DWM
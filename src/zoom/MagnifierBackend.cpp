@@ -0,0 +1,32 @@
+#include "MagnifierBackend.h"
+
+namespace VirtualOverlay {
+
+bool RecordingMagnifierBackend::SetFullscreenTransform(const MagnifierTransform& transform) {
+    bool changed = !m_active || m_calls.empty() || m_calls.back() != transform;
+    m_calls.push_back(transform);
+
+    m_counts.set++;
+    if (changed) {
+        m_counts.changed++;
+    }
+    m_active = true;
+    return true;
+}
+
+bool RecordingMagnifierBackend::ResetMagnification() {
+    if (!m_active) {
+        return true;
+    }
+    m_counts.reset++;
+    m_active = false;
+    return true;
+}
+
+void RecordingMagnifierBackend::Clear() {
+    m_calls.clear();
+    m_counts = CallCounts();
+    m_active = false;
+}
+
+}  // namespace VirtualOverlay
@@ -0,0 +1,55 @@
+#pragma once
+
+// Fullscreen magnification interface behind the zoom state machine.
+//
+// Magnifier implements it over the Windows Magnification API. The recording
+// backend keeps every transform it is given instead, so a zoom input trace
+// can be replayed and its API traffic counted without a desktop.
+// Platform-independent (no <windows.h>).
+
+#include "ScreenGeometry.h"
+#include <cstdint>
+#include <vector>
+
+namespace VirtualOverlay {
+
+class MagnifierBackend {
+public:
+    virtual ~MagnifierBackend() = default;
+
+    // Apply a transform from ComputeMagnifierTransform, starting the
+    // magnification session if needed
+    virtual bool SetFullscreenTransform(const MagnifierTransform& transform) = 0;
+
+    // Back to 1.0x and release the magnification session
+    virtual bool ResetMagnification() = 0;
+
+    // True while a magnification session is active
+    virtual bool IsInitialized() const = 0;
+};
+
+// Captures transforms instead of applying them
+class RecordingMagnifierBackend : public MagnifierBackend {
+public:
+    struct CallCounts {
+        uint64_t set = 0;        // SetFullscreenTransform calls
+        uint64_t changed = 0;    // ...that differed from the previous transform
+        uint64_t reset = 0;      // ResetMagnification calls on an active session
+    };
+
+    bool SetFullscreenTransform(const MagnifierTransform& transform) override;
+    bool ResetMagnification() override;
+    bool IsInitialized() const override { return m_active; }
+
+    // Every transform passed to SetFullscreenTransform, in order
+    const std::vector<MagnifierTransform>& GetCalls() const { return m_calls; }
+    const CallCounts& GetCallCounts() const { return m_counts; }
+    void Clear();
+
+private:
+    std::vector<MagnifierTransform> m_calls;
+    CallCounts m_counts;
+    bool m_active = false;
+};
+
+}  // namespace VirtualOverlay
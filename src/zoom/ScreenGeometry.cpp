@@ -0,0 +1,69 @@
+#include "ScreenGeometry.h"
+#include <algorithm>
+#include <cmath>
+
+namespace VirtualOverlay {
+
+namespace {
+
+// Offset along one axis. Relative to the virtual screen the visible span is
+// extent / level wide and may start anywhere in [0, extent - extent / level];
+// the magnifier scales about the primary origin, which moves that range by
+// origin * (1 - 1 / level).
+int GetAxisOffset(float level, int center, int origin, int extent) {
+    float visible = static_cast<float>(extent) / level;
+
+    int offset = static_cast<int>(center - origin - visible / 2.0f);
+    int maxOffset = static_cast<int>(extent - visible);
+    offset = std::clamp(offset, 0, std::max(maxOffset, 0));
+
+    return offset + static_cast<int>(std::lround(origin * (1.0f - 1.0f / level)));
+}
+
+}  // namespace
+
+bool ZoomRect::operator==(const ZoomRect& other) const {
+    return left == other.left && top == other.top &&
+           right == other.right && bottom == other.bottom;
+}
+
+bool MagnifierTransform::operator==(const MagnifierTransform& other) const {
+    return level == other.level && offsetX == other.offsetX && offsetY == other.offsetY;
+}
+
+ScreenGeometry MakeScreenGeometry(std::vector<ZoomRect> monitors, uint64_t generation) {
+    ScreenGeometry geometry;
+    geometry.generation = generation;
+    geometry.monitors = std::move(monitors);
+
+    if (!geometry.monitors.empty()) {
+        ZoomRect bounds = geometry.monitors.front();
+        for (const ZoomRect& monitor : geometry.monitors) {
+            bounds.left = std::min(bounds.left, monitor.left);
+            bounds.top = std::min(bounds.top, monitor.top);
+            bounds.right = std::max(bounds.right, monitor.right);
+            bounds.bottom = std::max(bounds.bottom, monitor.bottom);
+        }
+        geometry.virtualScreen = bounds;
+    }
+    return geometry;
+}
+
+MagnifierTransform ComputeMagnifierTransform(float level, int centerX, int centerY,
+                                             const ScreenGeometry& geometry) {
+    MagnifierTransform transform;
+
+    // Written so that NaN ends up at 1.0x
+    transform.level = level > 1.0f ? std::min(level, MAX_MAGNIFIER_LEVEL) : 1.0f;
+
+    const ZoomRect& screen = geometry.virtualScreen;
+    if (screen.GetWidth() <= 0 || screen.GetHeight() <= 0) {
+        return transform;
+    }
+
+    transform.offsetX = GetAxisOffset(transform.level, centerX, screen.left, screen.GetWidth());
+    transform.offsetY = GetAxisOffset(transform.level, centerY, screen.top, screen.GetHeight());
+    return transform;
+}
+
+}  // namespace VirtualOverlay
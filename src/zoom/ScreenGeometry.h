@@ -0,0 +1,63 @@
+#pragma once
+
+// Monitor layout snapshot for the zoom path, and the magnifier transform it
+// implies.
+//
+// ZoomController captures a snapshot at start-up and again on
+// WM_DISPLAYCHANGE and WM_DPICHANGED, each under a new generation number.
+// Per frame, ZoomMotion turns level and center into a transform with
+// ComputeMagnifierTransform, a pure function of the snapshot: no
+// GetSystemMetrics, no monitor enumeration. The zoom replay computes its
+// transforms the same way from the layout stored in the trace.
+// Platform-independent (no <windows.h>).
+
+#include <cstdint>
+#include <vector>
+
+namespace VirtualOverlay {
+
+// Screen rectangle in virtual-screen pixels (right/bottom exclusive)
+struct ZoomRect {
+    int left = 0;
+    int top = 0;
+    int right = 0;
+    int bottom = 0;
+
+    int GetWidth() const { return right - left; }
+    int GetHeight() const { return bottom - top; }
+    bool Contains(int x, int y) const { return x >= left && x < right && y >= top && y < bottom; }
+    bool operator==(const ZoomRect& other) const;
+    bool operator!=(const ZoomRect& other) const { return !(*this == other); }
+};
+
+struct ScreenGeometry {
+    uint64_t generation = 0;         // Bumped on every capture (0 = none yet)
+    std::vector<ZoomRect> monitors;  // Primary first
+    ZoomRect virtualScreen;          // Bounding rectangle of all monitors
+};
+
+// Snapshot of this layout; the virtual screen is its bounding rectangle
+ScreenGeometry MakeScreenGeometry(std::vector<ZoomRect> monitors, uint64_t generation);
+
+constexpr float MAX_MAGNIFIER_LEVEL = 20.0f;
+
+// Arguments of MagSetFullscreenTransform. The offset is the unmagnified
+// screen point shown at the primary monitor's origin, so screen point s
+// shows offset + s / level.
+struct MagnifierTransform {
+    float level = 1.0f;
+    int offsetX = 0;
+    int offsetY = 0;
+
+    bool operator==(const MagnifierTransform& other) const;
+    bool operator!=(const MagnifierTransform& other) const { return !(*this == other); }
+};
+
+// Transform that centers the zoom on (centerX, centerY). The level is
+// clamped to [1, MAX_MAGNIFIER_LEVEL] and the offsets so that the
+// magnified view never shows anything outside the virtual screen; at
+// 1.0x the transform is the identity.
+MagnifierTransform ComputeMagnifierTransform(float level, int centerX, int centerY,
+                                             const ScreenGeometry& geometry);
+
+}  // namespace VirtualOverlay
@@ -0,0 +1,74 @@
+#include "TransformCoalescer.h"
+#include <algorithm>
+#include <cmath>
+
+namespace VirtualOverlay {
+
+namespace {
+
+// Largest movement along one axis. Screen position s shows source point
+// offset + s / level; the new transform puts that point at
+// (offset + s / level - offset') * level'. The difference is linear in s,
+// so the extremes are at the view's edges.
+float GetAxisDisplacement(float fromLevel, int fromOffset, float toLevel, int toOffset,
+                          int viewStart, int viewEnd) {
+    float shift = static_cast<float>(fromOffset - toOffset) * toLevel;
+    float scale = toLevel / fromLevel - 1.0f;
+
+    float atStart = shift + static_cast<float>(viewStart) * scale;
+    float atEnd = shift + static_cast<float>(viewEnd) * scale;
+    return std::max(std::fabs(atStart), std::fabs(atEnd));
+}
+
+}  // namespace
+
+float TransformCoalescer::GetDisplacementPx(const MagnifierTransform& from, const MagnifierTransform& to,
+                                            const ZoomRect& view) {
+    if (from.level <= 0.0f || to.level <= 0.0f) {
+        return static_cast<float>(std::max(view.GetWidth(), view.GetHeight()));
+    }
+    return std::max(GetAxisDisplacement(from.level, from.offsetX, to.level, to.offsetX,
+                                        view.left, view.right),
+                    GetAxisDisplacement(from.level, from.offsetY, to.level, to.offsetY,
+                                        view.top, view.bottom));
+}
+
+bool TransformCoalescer::ShouldIssue(const MagnifierTransform& transform, const ZoomRect& view,
+                                     double nowMs, bool settled) {
+    if (m_hasLast && transform == m_last) {
+        m_stats.unchanged++;
+        return false;
+    }
+
+    // Refresh interval this call falls in: two calls in the same interval
+    // would land on the same composition
+    int64_t frame = -1;
+    if (m_config.refreshHz > 0.0f) {
+        frame = static_cast<int64_t>(std::floor(nowMs * m_config.refreshHz / 1000.0));
+    }
+
+    if (m_hasLast) {
+        if (!settled && m_config.thresholdPx > 0.0f &&
+            GetDisplacementPx(m_last, transform, view) < m_config.thresholdPx) {
+            m_stats.belowThreshold++;
+            return false;
+        }
+        if (frame >= 0 && frame == m_lastFrame) {
+            m_stats.rateLimited++;
+            return false;
+        }
+    }
+
+    m_hasLast = true;
+    m_last = transform;
+    m_lastFrame = frame;
+    m_stats.issued++;
+    return true;
+}
+
+void TransformCoalescer::Reset() {
+    m_hasLast = false;
+    m_lastFrame = -1;
+}
+
+}  // namespace VirtualOverlay
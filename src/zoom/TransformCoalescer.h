@@ -0,0 +1,64 @@
+#pragma once
+
+// Drops magnifier transforms the user cannot see.
+//
+// While the zoom smoothing converges, every 16 ms tick produces a slightly
+// different level and offset, and each MagSetFullscreenTransform makes DWM
+// recompose the whole virtual screen. A transform is only issued when it
+// moves some part of the visible picture by at least thresholdPx physical
+// pixels, and at most once per display refresh. Once the motion has settled
+// its exact final transform is issued even if the step is small, so the view
+// never stops short of the target.
+// Platform-independent (no <windows.h>).
+
+#include "ScreenGeometry.h"
+#include <cstdint>
+
+namespace VirtualOverlay {
+
+struct TransformCoalescingConfig {
+    float thresholdPx = 1.0f;   // Smallest on-screen movement worth a call (0 = any change)
+    float refreshHz = 60.0f;    // At most one call per refresh (0 = no limit)
+};
+
+struct TransformCoalescerStats {
+    uint64_t issued = 0;
+    uint64_t unchanged = 0;       // Same transform as the last one issued
+    uint64_t belowThreshold = 0;
+    uint64_t rateLimited = 0;
+
+    uint64_t GetSuppressed() const { return unchanged + belowThreshold + rateLimited; }
+};
+
+class TransformCoalescer {
+public:
+    void SetConfig(const TransformCoalescingConfig& config) { m_config = config; }
+    const TransformCoalescingConfig& GetConfig() const { return m_config; }
+
+    // True if this transform should go to the magnifier now (and is then
+    // remembered as the last one issued). view: the zoomed monitor; nowMs:
+    // any monotonic clock; settled: the motion has reached its target.
+    bool ShouldIssue(const MagnifierTransform& transform, const ZoomRect& view,
+                     double nowMs, bool settled);
+
+    // The magnification session ended; the next transform is always issued
+    void Reset();
+
+    const TransformCoalescerStats& GetStats() const { return m_stats; }
+    void ResetStats() { m_stats = TransformCoalescerStats(); }
+
+    // Largest distance, in screen pixels, that the picture at any point of
+    // the view moves between the two transforms
+    static float GetDisplacementPx(const MagnifierTransform& from, const MagnifierTransform& to,
+                                   const ZoomRect& view);
+
+private:
+    TransformCoalescingConfig m_config;
+    TransformCoalescerStats m_stats;
+
+    bool m_hasLast = false;
+    MagnifierTransform m_last;
+    int64_t m_lastFrame = -1;   // Refresh interval of the last issued transform
+};
+
+}  // namespace VirtualOverlay
@@ -1,6 +1,8 @@
 #pragma once
 
+#include "ZoomMotion.h"
 #include <windows.h>
+#include <string>
 
 namespace VirtualOverlay {
 
@@ -20,6 +22,12 @@ struct ZoomSettings {
     bool smoothing = true;           // Enable smooth pan/zoom transitions
     float smoothingFactor = 0.08f;   // Lower = smoother but slower (0.05–0.5)
     int animationDurationMs = 50;    // Zoom transition duration
+    float transformThresholdPx = 1.0f;  // Skip transform updates that move the view less (0 = off)
+    ZoomPanFilter panFilter = ZoomPanFilter::Exponential;  // How the pan follows the cursor
+    float panMinCutoffHz = 1.0f;     // One-Euro: smoothing at rest (lower = steadier)
+    float panBeta = 0.005f;          // One-Euro: speed response (higher = less lag on fast pans)
+    CursorPredictionMode cursorPrediction = CursorPredictionMode::Off;  // Pan toward where the cursor is heading
+    float predictionLeadMs = 16.0f;  // How far ahead to predict the cursor
     
     // Double-tap reset
     bool doubleTapToReset = true;    // Double-tap modifier resets zoom
@@ -27,33 +35,9 @@ struct ZoomSettings {
     
     // Touchpad support
     bool touchpadPinch = true;       // Enable pinch gesture support
-};
 
-// Runtime state for zoom feature
-struct ZoomState {
-    float currentLevel = 1.0f;       // Current zoom level (1.0 = no zoom)
-    float targetLevel = 1.0f;        // Target zoom level for animation
-    
-    float offsetX = 0.0f;            // Pan offset X (normalized 0-1)
-    float offsetY = 0.0f;            // Pan offset Y (normalized 0-1)
-    float targetOffsetX = 0.0f;      // Target pan offset X
-    float targetOffsetY = 0.0f;      // Target pan offset Y
-    
-    HMONITOR activeMonitor = nullptr; // Monitor being zoomed
-    
-    bool modifierHeld = false;       // Is modifier key currently pressed
-    DWORD lastModifierTap = 0;       // Timestamp for double-tap detection
-    
-    bool isZoomed() const { return currentLevel > 1.001f; }
-    void reset() {
-        currentLevel = 1.0f;
-        targetLevel = 1.0f;
-        offsetX = 0.0f;
-        offsetY = 0.0f;
-        targetOffsetX = 0.0f;
-        targetOffsetY = 0.0f;
-        activeMonitor = nullptr;
-    }
+    // Zoom input trace for replay (ZoomTrace.h), written on shutdown; read at start-up
+    std::wstring traceFile;
 };
 
 }  // namespace VirtualOverlay
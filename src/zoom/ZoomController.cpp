@@ -2,7 +2,8 @@
 #include "Magnifier.h"
 #include "../utils/Logger.h"
 #include "../utils/Monitor.h"
-#include <cmath>
+#include <algorithm>
+#include <fstream>
 
 namespace VirtualOverlay {
 
@@ -25,18 +26,14 @@ bool ZoomController::Init(const ZoomSettings& config) {
     }
 
     m_config = config;
-    m_state.reset();
     m_controllerState = ZoomControllerState::Normal;
 
-    // Initialize smooth values
-    m_smoothLevel.SetSmoothing(config.smoothing ? config.smoothingFactor : 0.0f);
-    m_smoothLevel.SetImmediate(1.0f);
-
-    m_smoothOffsetX.SetSmoothing(config.smoothing ? config.smoothingFactor : 0.0f);
-    m_smoothOffsetX.SetImmediate(0.0f);
-
-    m_smoothOffsetY.SetSmoothing(config.smoothing ? config.smoothingFactor : 0.0f);
-    m_smoothOffsetY.SetImmediate(0.0f);
+    // Initialize the state machine at 1.0x over the current monitors
+    m_refreshHz = GetDisplayRefreshRate();
+    m_motion.SetConfig(ToMotionConfig(config));
+    RefreshGeometry();
+    m_motion.Reset();
+    m_motion.SetBackend(&Magnifier::Instance());
 
     // Initialize magnifier
     if (!Magnifier::Instance().Init()) {
@@ -45,7 +42,11 @@ bool ZoomController::Init(const ZoomSettings& config) {
     }
 
     m_initialized = true;
-    LOG_INFO("ZoomController initialized");
+    if (!config.traceFile.empty()) {
+        StartTrace();
+    }
+    LOG_INFO("ZoomController initialized (pan filter: %s, cursor prediction: %s)",
+             ZoomPanFilterToString(config.panFilter), CursorPredictionModeToString(config.cursorPrediction));
     return true;
 }
 
@@ -56,7 +57,16 @@ void ZoomController::Shutdown() {
 
     // Reset zoom before shutdown
     ResetZoom();
-    
+
+    if (m_trace.IsRecording()) {
+        SaveTrace(m_config.traceFile);
+    }
+
+    const TransformCoalescerStats& transformStats = m_motion.GetTransformStats();
+    LOG_INFO("Zoom transforms: %llu issued, %llu suppressed (%llu unchanged, %llu below threshold, %llu rate limited)",
+             transformStats.issued, transformStats.GetSuppressed(), transformStats.unchanged,
+             transformStats.belowThreshold, transformStats.rateLimited);
+
     // Shutdown magnifier
     Magnifier::Instance().Shutdown();
 
@@ -67,125 +77,82 @@ void ZoomController::Shutdown() {
 void ZoomController::Update(float deltaTimeMs) {
     if (!m_initialized) return;
 
-    float deltaTimeSec = deltaTimeMs / 1000.0f;
+    Record(ZoomInputKind::Tick, 0, 0, deltaTimeMs);
 
-    // Update smooth values
-    m_smoothLevel.Update(deltaTimeSec);
-    m_smoothOffsetX.Update(deltaTimeSec);
-    m_smoothOffsetY.Update(deltaTimeSec);
-
-    // Update state
-    m_state.currentLevel = m_smoothLevel.GetValue();
-    m_state.offsetX = m_smoothOffsetX.GetValue();
-    m_state.offsetY = m_smoothOffsetY.GetValue();
+    // Advance the smoothing and apply magnification if changed
+    m_motion.Update(deltaTimeMs);
 
     // Update controller state
-    if (m_state.currentLevel > 1.001f) {
+    if (m_motion.IsZoomed()) {
         if (m_controllerState != ZoomControllerState::Zooming) {
             m_controllerState = ZoomControllerState::Zooming;
             LOG_DEBUG("Zoom state: Zooming");
         }
-    } else if (m_smoothLevel.HasReachedTarget()) {
+    } else if (m_motion.HasReachedTargetLevel()) {
         if (m_controllerState != ZoomControllerState::Normal) {
             m_controllerState = ZoomControllerState::Normal;
             LOG_DEBUG("Zoom state: Normal");
         }
     }
-
-    // Apply magnification if changed
-    ApplyMagnification();
 }
 
 void ZoomController::ZoomIn() {
     if (!m_initialized) return;
 
-    float newLevel = m_state.targetLevel + m_config.zoomStep;
-    if (newLevel > m_config.maxZoom) {
-        newLevel = m_config.maxZoom;
-    }
-
-    ZoomToLevel(newLevel);
+    POINT pt = Monitor::GetCursorPosition();
+    Record(ZoomInputKind::Wheel, pt.x, pt.y, 1.0f);
+    m_motion.ZoomIn(pt.x, pt.y);
+    LOG_DEBUG("Zoom target set to %.2f", m_motion.GetTargetLevel());
 }
 
 void ZoomController::ZoomOut() {
     if (!m_initialized) return;
 
-    float newLevel = m_state.targetLevel - m_config.zoomStep;
-    if (newLevel < m_config.minZoom) {
-        newLevel = m_config.minZoom;
-    }
-
-    ZoomToLevel(newLevel);
+    POINT pt = Monitor::GetCursorPosition();
+    Record(ZoomInputKind::Wheel, pt.x, pt.y, -1.0f);
+    m_motion.ZoomOut(pt.x, pt.y);
+    LOG_DEBUG("Zoom target set to %.2f", m_motion.GetTargetLevel());
 }
 
 void ZoomController::ZoomToLevel(float level) {
     if (!m_initialized) return;
 
-    // Clamp level
-    if (level < m_config.minZoom) level = m_config.minZoom;
-    if (level > m_config.maxZoom) level = m_config.maxZoom;
-
-    m_state.targetLevel = level;
-    m_smoothLevel.SetTarget(level);
-
-    LOG_DEBUG("Zoom target set to %.2f", level);
-
-    // If starting zoom, capture the active monitor
-    if (m_state.activeMonitor == nullptr && level > 1.0f) {
-        POINT pt = Monitor::GetCursorPosition();
-        m_state.activeMonitor = MonitorFromPoint(pt, MONITOR_DEFAULTTONEAREST);
-        
-        // Initialize pan to cursor position
-        UpdatePanFromCursor(pt.x, pt.y);
-    }
+    POINT pt = Monitor::GetCursorPosition();
+    Record(ZoomInputKind::Gesture, pt.x, pt.y, level);
+    m_motion.ZoomToLevel(level, pt.x, pt.y);
+    LOG_DEBUG("Zoom target set to %.2f", m_motion.GetTargetLevel());
 }
 
 void ZoomController::ResetZoom() {
     if (!m_initialized) return;
 
-    m_state.targetLevel = 1.0f;
-    m_state.targetOffsetX = 0.0f;
-    m_state.targetOffsetY = 0.0f;
-
-    m_smoothLevel.SetTarget(1.0f);
-    m_smoothOffsetX.SetTarget(0.0f);
-    m_smoothOffsetY.SetTarget(0.0f);
-
-    m_state.activeMonitor = nullptr;
+    Record(ZoomInputKind::Reset);
+    m_motion.ResetZoom();
 
     LOG_DEBUG("Zoom reset");
 }
 
 void ZoomController::OnCursorMove(int x, int y) {
     if (!m_initialized) return;
-    if (!m_state.isZoomed()) return;
 
-    m_lastCursorX = x;
-    m_lastCursorY = y;
-
-    UpdatePanFromCursor(x, y);
+    Record(ZoomInputKind::Cursor, x, y);
+    m_motion.OnCursorMove(x, y);
 }
 
 void ZoomController::OnModifierPressed() {
     if (!m_initialized) return;
 
-    if (!m_state.modifierHeld) {
-        // Check for double-tap
-        if (CheckDoubleTap()) {
-            ResetZoom();
-            m_state.lastModifierTap = 0;
-            return;
-        }
-
-        m_state.lastModifierTap = GetTickCount();
+    Record(ZoomInputKind::ModifierDown);
+    if (m_motion.OnModifierPressed(GetTickCount64())) {
+        LOG_DEBUG("Zoom reset (double tap)");
     }
-
-    m_state.modifierHeld = true;
 }
 
 void ZoomController::OnModifierReleased() {
     if (!m_initialized) return;
-    m_state.modifierHeld = false;
+
+    Record(ZoomInputKind::ModifierUp);
+    m_motion.OnModifierReleased();
 }
 
 ZoomControllerState ZoomController::GetState() const {
@@ -193,101 +160,139 @@ ZoomControllerState ZoomController::GetState() const {
 }
 
 float ZoomController::GetCurrentLevel() const {
-    return m_state.currentLevel;
+    return m_motion.GetCurrentLevel();
 }
 
 float ZoomController::GetTargetLevel() const {
-    return m_state.targetLevel;
+    return m_motion.GetTargetLevel();
 }
 
 bool ZoomController::IsZoomed() const {
-    return m_state.isZoomed();
+    return m_motion.IsZoomed();
 }
 
 void ZoomController::ApplyConfig(const ZoomSettings& config) {
+    // The trace file is only read at start-up
+    std::wstring traceFile = m_config.traceFile;
     m_config = config;
+    m_config.traceFile = traceFile;
 
-    float smoothing = config.smoothing ? config.smoothingFactor : 0.0f;
-    m_smoothLevel.SetSmoothing(smoothing);
-    m_smoothOffsetX.SetSmoothing(smoothing);
-    m_smoothOffsetY.SetSmoothing(smoothing);
+    m_motion.SetConfig(ToMotionConfig(config));
 
     LOG_INFO("ZoomController config updated");
 }
 
-void ZoomController::UpdatePanFromCursor(int cursorX, int cursorY) {
-    if (m_state.activeMonitor == nullptr) return;
-
-    // Get monitor bounds
-    RECT monitorRect = Monitor::Instance().GetMonitorRect(m_state.activeMonitor);
-    int monitorWidth = monitorRect.right - monitorRect.left;
-    int monitorHeight = monitorRect.bottom - monitorRect.top;
+void ZoomController::OnDisplayChanged() {
+    RefreshGeometry();
 
-    if (monitorWidth == 0 || monitorHeight == 0) return;
-
-    // Normalize cursor position within monitor (0.0 to 1.0)
-    float normX = static_cast<float>(cursorX - monitorRect.left) / monitorWidth;
-    float normY = static_cast<float>(cursorY - monitorRect.top) / monitorHeight;
-
-    // Clamp to valid range
-    normX = std::clamp(normX, 0.0f, 1.0f);
-    normY = std::clamp(normY, 0.0f, 1.0f);
+    m_refreshHz = GetDisplayRefreshRate();
+    m_motion.SetConfig(ToMotionConfig(m_config));
+}
 
-    // Set target pan position
-    m_state.targetOffsetX = normX;
-    m_state.targetOffsetY = normY;
-    
-    m_smoothOffsetX.SetTarget(normX);
-    m_smoothOffsetY.SetTarget(normY);
+void ZoomController::StartTrace() {
+    LARGE_INTEGER frequency;
+    QueryPerformanceFrequency(&frequency);
+    m_trace.Start(frequency.QuadPart, m_geometry.monitors);
+    LOG_INFO("Zoom input trace started");
 }
 
-void ZoomController::ApplyMagnification() {
-    // Skip magnification API calls when at or very close to 1.0x zoom
-    // This prevents unnecessary API calls that can affect cursor behavior
-    if (m_state.currentLevel <= 1.001f) {
-        // If magnification is still active, fully deactivate it.
-        // We check IsInitialized() rather than activeMonitor because
-        // ResetZoom() clears activeMonitor immediately while the smooth
-        // animation is still in progress, which would skip cleanup.
-        if (Magnifier::Instance().IsInitialized()) {
-            Magnifier::Instance().ResetMagnification();
-        }
-        m_state.activeMonitor = nullptr;
-        return;
+bool ZoomController::SaveTrace(const std::wstring& filePath) {
+    m_trace.Stop();
+
+    std::vector<uint8_t> bytes;
+    if (!EncodeZoomTrace(m_trace.GetTrace(), bytes)) {
+        LOG_ERROR("Failed to encode zoom input trace");
+        return false;
     }
 
-    // Get monitor bounds for the active monitor or primary
-    RECT monitorRect;
-    if (m_state.activeMonitor) {
-        monitorRect = Monitor::Instance().GetMonitorRect(m_state.activeMonitor);
-    } else {
-        const auto* primary = Monitor::Instance().GetPrimary();
-        if (primary) {
-            monitorRect = primary->bounds;
-        } else {
-            monitorRect = {0, 0, GetSystemMetrics(SM_CXSCREEN), GetSystemMetrics(SM_CYSCREEN)};
-        }
+    std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        LOG_ERROR("Failed to open zoom trace file for writing");
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    if (!file.good()) {
+        LOG_ERROR("Failed to write zoom trace file");
+        return false;
     }
 
-    int monitorWidth = monitorRect.right - monitorRect.left;
-    int monitorHeight = monitorRect.bottom - monitorRect.top;
+    LOG_INFO("Zoom input trace saved: %zu events (%llu dropped), %zu bytes",
+             m_trace.GetTrace().events.size(), m_trace.GetDropped(), bytes.size());
+    return true;
+}
+
+void ZoomController::Record(ZoomInputKind kind, int x, int y, float value) {
+    if (!m_trace.IsRecording()) return;
+
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
 
-    // Calculate center point based on normalized offset
-    int centerX = monitorRect.left + static_cast<int>(m_state.offsetX * monitorWidth);
-    int centerY = monitorRect.top + static_cast<int>(m_state.offsetY * monitorHeight);
+    ZoomInputEvent event;
+    event.time = now.QuadPart;
+    event.kind = kind;
+    event.x = x;
+    event.y = y;
+    event.value = value;
+    m_trace.Record(event);
+}
 
-    // Apply magnification
-    Magnifier::Instance().SetFullscreenMagnification(m_state.currentLevel, centerX, centerY);
+ZoomMotionConfig ZoomController::ToMotionConfig(const ZoomSettings& config) const {
+    ZoomMotionConfig motion;
+    motion.zoomStep = config.zoomStep;
+    motion.minZoom = config.minZoom;
+    motion.maxZoom = config.maxZoom;
+    motion.smoothing = config.smoothing;
+    motion.smoothingFactor = config.smoothingFactor;
+    motion.doubleTapToReset = config.doubleTapToReset;
+    motion.doubleTapWindowMs = static_cast<uint32_t>(std::max(config.doubleTapWindowMs, 0));
+    motion.panFilter = config.panFilter;
+    motion.panMinCutoffHz = config.panMinCutoffHz;
+    motion.panBeta = config.panBeta;
+    motion.prediction.mode = config.cursorPrediction;
+    motion.prediction.leadMs = config.predictionLeadMs;
+    motion.coalescing.thresholdPx = config.transformThresholdPx;
+    motion.coalescing.refreshHz = m_refreshHz;
+    return motion;
 }
 
-bool ZoomController::CheckDoubleTap() {
-    if (!m_config.doubleTapToReset) return false;
-    if (m_state.lastModifierTap == 0) return false;
+void ZoomController::RefreshGeometry() {
+    // The frame path only reads this snapshot; the generation tells
+    // ZoomMotion the layout behind its zoomed monitor may have moved
+    m_geometry = MakeScreenGeometry(GetMonitorLayout(), m_geometry.generation + 1);
+    m_motion.SetGeometry(m_geometry);
+
+    const ZoomRect& screen = m_geometry.virtualScreen;
+    LOG_INFO("Screen geometry %llu: %zu monitors, virtual screen %d,%d %dx%d",
+             m_geometry.generation, m_geometry.monitors.size(),
+             screen.left, screen.top, screen.GetWidth(), screen.GetHeight());
+}
 
-    DWORD now = GetTickCount();
-    DWORD elapsed = now - m_state.lastModifierTap;
+std::vector<ZoomRect> ZoomController::GetMonitorLayout() {
+    // Primary first: the pan falls back to it while zooming out
+    std::vector<ZoomRect> layout;
+    for (const auto& monitor : Monitor::Instance().GetMonitors()) {
+        ZoomRect rect = { monitor.bounds.left, monitor.bounds.top,
+                          monitor.bounds.right, monitor.bounds.bottom };
+        if (monitor.isPrimary) {
+            layout.insert(layout.begin(), rect);
+        } else {
+            layout.push_back(rect);
+        }
+    }
+    if (layout.empty()) {
+        layout.push_back({ 0, 0, GetSystemMetrics(SM_CXSCREEN), GetSystemMetrics(SM_CYSCREEN) });
+    }
+    return layout;
+}
 
-    return elapsed <= static_cast<DWORD>(m_config.doubleTapWindowMs);
+float ZoomController::GetDisplayRefreshRate() {
+    // 0 and 1 mean "hardware default"
+    DEVMODEW mode = {};
+    mode.dmSize = sizeof(mode);
+    if (EnumDisplaySettingsW(nullptr, ENUM_CURRENT_SETTINGS, &mode) && mode.dmDisplayFrequency > 1) {
+        return static_cast<float>(mode.dmDisplayFrequency);
+    }
+    return 60.0f;
 }
 
 }  // namespace VirtualOverlay
@@ -1,8 +1,11 @@
 #pragma once
 
 #include "ZoomConfig.h"
-#include "../utils/Animation.h"
+#include "ZoomMotion.h"
+#include "ZoomTrace.h"
 #include <windows.h>
+#include <string>
+#include <vector>
 
 namespace VirtualOverlay {
 
@@ -12,8 +15,9 @@ enum class ZoomControllerState {
     Zooming     // Actively zoomed (level > 1.0)
 };
 
-// Zoom controller manages the zoom state machine and coordinates
-// with Magnifier, hooks, and cursor tracking
+// Zoom controller feeds input, time and the monitor layout to the zoom state
+// machine (ZoomMotion), which drives the Magnifier, and records the input
+// to a trace when ZoomSettings::traceFile is set
 class ZoomController {
 public:
     static ZoomController& Instance();
@@ -50,28 +54,32 @@ public:
     // Apply new configuration
     void ApplyConfig(const ZoomSettings& config);
 
+    // Called when display configuration or DPI changes
+    void OnDisplayChanged();
+
+    // Zoom input trace (ZoomTrace.h); saving stops the recording
+    void StartTrace();
+    bool SaveTrace(const std::wstring& filePath);
+    bool IsTracing() const { return m_trace.IsRecording(); }
+
 private:
     ZoomController();
     ~ZoomController();
     ZoomController(const ZoomController&) = delete;
     ZoomController& operator=(const ZoomController&) = delete;
 
-    void UpdatePanFromCursor(int cursorX, int cursorY);
-    void ApplyMagnification();
-    bool CheckDoubleTap();
+    void Record(ZoomInputKind kind, int x = 0, int y = 0, float value = 0.0f);
+    ZoomMotionConfig ToMotionConfig(const ZoomSettings& config) const;
+    void RefreshGeometry();
+    static std::vector<ZoomRect> GetMonitorLayout();
+    static float GetDisplayRefreshRate();
 
     ZoomSettings m_config;
-    ZoomState m_state;
+    ZoomMotion m_motion;
+    ScreenGeometry m_geometry;  // Recaptured on display and DPI changes
     ZoomControllerState m_controllerState = ZoomControllerState::Normal;
-
-    // Smooth animation values
-    SmoothValue m_smoothLevel;
-    SmoothValue m_smoothOffsetX;
-    SmoothValue m_smoothOffsetY;
-
-    // Last cursor position
-    int m_lastCursorX = 0;
-    int m_lastCursorY = 0;
+    ZoomTraceRecorder m_trace;
+    float m_refreshHz = 60.0f;  // Transforms are issued at most once per refresh
 
     bool m_initialized = false;
 };
@@ -0,0 +1,329 @@
+#include "ZoomMotion.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace VirtualOverlay {
+
+namespace {
+
+// Below this (monitor pixels) the filtered pan snaps to the cursor, so it
+// settles instead of creeping at the resting cutoff
+constexpr float PAN_FILTER_SNAP_PX = 0.05f;
+
+}  // namespace
+
+const char* ZoomPanFilterToString(ZoomPanFilter filter) {
+    switch (filter) {
+        case ZoomPanFilter::Exponential: return "exponential";
+        case ZoomPanFilter::OneEuro:     return "one-euro";
+        default:                         return "unknown";
+    }
+}
+
+ZoomMotion::ZoomMotion() {
+    SetConfig(m_config);
+    Reset();
+}
+
+void ZoomMotion::SetConfig(const ZoomMotionConfig& config) {
+    m_config = config;
+
+    float smoothing = config.smoothing ? config.smoothingFactor : 0.0f;
+    m_smoothLevel.SetSmoothing(smoothing);
+    m_smoothOffsetX.SetSmoothing(smoothing);
+    m_smoothOffsetY.SetSmoothing(smoothing);
+    m_panFilterX.SetParameters(config.panMinCutoffHz, config.panBeta);
+    m_panFilterY.SetParameters(config.panMinCutoffHz, config.panBeta);
+    m_predictor.SetConfig(config.prediction);
+    m_hasCursorSample = false;
+    m_coalescer.SetConfig(config.coalescing);
+}
+
+void ZoomMotion::SetGeometry(ScreenGeometry geometry) {
+    bool changed = geometry.generation != m_geometry.generation;
+    m_geometry = std::move(geometry);
+
+    // Follow the zoomed monitor to its new bounds; keep the old ones if it
+    // is gone so the pan does not jump mid-zoom
+    if (changed && m_hasActiveMonitor) {
+        int centerX = m_activeMonitor.left + m_activeMonitor.GetWidth() / 2;
+        int centerY = m_activeMonitor.top + m_activeMonitor.GetHeight() / 2;
+        for (const ZoomRect& monitor : m_geometry.monitors) {
+            if (monitor.Contains(centerX, centerY)) {
+                m_activeMonitor = monitor;
+                break;
+            }
+        }
+    }
+}
+
+void ZoomMotion::Reset() {
+    m_currentLevel = 1.0f;
+    m_targetLevel = 1.0f;
+    m_offsetX = 0.0f;
+    m_offsetY = 0.0f;
+    m_targetOffsetX = 0.0f;
+    m_targetOffsetY = 0.0f;
+    m_hasActiveMonitor = false;
+    m_modifierHeld = false;
+    m_hasModifierTap = false;
+    m_lastModifierTapMs = 0;
+
+    m_smoothLevel.SetImmediate(1.0f);
+    m_smoothOffsetX.SetImmediate(0.0f);
+    m_smoothOffsetY.SetImmediate(0.0f);
+    m_predictor.Reset();
+    m_hasCursorSample = false;
+}
+
+void ZoomMotion::ZoomIn(int cursorX, int cursorY) {
+    float newLevel = m_targetLevel + m_config.zoomStep;
+    if (newLevel > m_config.maxZoom) {
+        newLevel = m_config.maxZoom;
+    }
+
+    ZoomToLevel(newLevel, cursorX, cursorY);
+}
+
+void ZoomMotion::ZoomOut(int cursorX, int cursorY) {
+    float newLevel = m_targetLevel - m_config.zoomStep;
+    if (newLevel < m_config.minZoom) {
+        newLevel = m_config.minZoom;
+    }
+
+    ZoomToLevel(newLevel, cursorX, cursorY);
+}
+
+void ZoomMotion::ZoomToLevel(float level, int cursorX, int cursorY) {
+    // Clamp level
+    if (level < m_config.minZoom) level = m_config.minZoom;
+    if (level > m_config.maxZoom) level = m_config.maxZoom;
+
+    m_targetLevel = level;
+    m_smoothLevel.SetTarget(level);
+
+    // If starting zoom, capture the monitor under the cursor
+    if (!m_hasActiveMonitor && level > 1.0f) {
+        int index = FindMonitor(cursorX, cursorY);
+        if (index >= 0) {
+            m_activeMonitor = m_geometry.monitors[index];
+            m_hasActiveMonitor = true;
+
+            // The filtered pan starts on the cursor, with no motion history
+            m_panFilterX.Reset();
+            m_panFilterY.Reset();
+            m_predictor.Reset();
+            m_hasCursorSample = false;
+
+            // Initialize pan to cursor position
+            UpdatePanFromCursor(cursorX, cursorY);
+        }
+    }
+}
+
+void ZoomMotion::ResetZoom() {
+    m_targetLevel = 1.0f;
+    m_targetOffsetX = 0.0f;
+    m_targetOffsetY = 0.0f;
+
+    m_smoothLevel.SetTarget(1.0f);
+    m_smoothOffsetX.SetTarget(0.0f);
+    m_smoothOffsetY.SetTarget(0.0f);
+
+    m_hasActiveMonitor = false;
+}
+
+void ZoomMotion::OnCursorMove(int x, int y) {
+    if (!IsZoomed()) return;
+
+    if (m_config.prediction.mode == CursorPredictionMode::Off) {
+        UpdatePanFromCursor(x, y);
+        return;
+    }
+
+    m_cursorX = x;
+    m_cursorY = y;
+    m_hasCursorSample = true;
+}
+
+bool ZoomMotion::OnModifierPressed(uint64_t nowMs) {
+    if (!m_modifierHeld) {
+        if (CheckDoubleTap(nowMs)) {
+            ResetZoom();
+            m_hasModifierTap = false;
+            return true;
+        }
+
+        m_hasModifierTap = true;
+        m_lastModifierTapMs = nowMs;
+    }
+
+    m_modifierHeld = true;
+    return false;
+}
+
+void ZoomMotion::OnModifierReleased() {
+    m_modifierHeld = false;
+}
+
+void ZoomMotion::Update(float deltaTimeMs) {
+    float deltaTimeSec = deltaTimeMs / 1000.0f;
+    m_timeMs += deltaTimeMs;
+
+    m_smoothLevel.Update(deltaTimeSec);
+    m_currentLevel = m_smoothLevel.GetValue();
+
+    if (m_hasCursorSample) {
+        m_hasCursorSample = false;
+        m_predictor.AddSample(m_timeMs, static_cast<float>(m_cursorX), static_cast<float>(m_cursorY));
+
+        float x = 0.0f;
+        float y = 0.0f;
+        if (m_predictor.Predict(x, y)) {
+            UpdatePanFromCursor(static_cast<int>(std::lround(x)), static_cast<int>(std::lround(y)));
+        }
+    }
+
+    if (m_config.panFilter == ZoomPanFilter::OneEuro && m_config.smoothing && m_hasActiveMonitor) {
+        FilterPan(deltaTimeSec);
+    } else {
+        m_smoothOffsetX.Update(deltaTimeSec);
+        m_smoothOffsetY.Update(deltaTimeSec);
+        m_offsetX = m_smoothOffsetX.GetValue();
+        m_offsetY = m_smoothOffsetY.GetValue();
+    }
+
+    ApplyMagnification();
+}
+
+bool ZoomMotion::GetPanRect(ZoomRect& rect) const {
+    if (m_hasActiveMonitor) {
+        rect = m_activeMonitor;
+        return true;
+    }
+    if (!m_geometry.monitors.empty()) {
+        rect = m_geometry.monitors.front();  // Primary
+        return true;
+    }
+    return false;
+}
+
+void ZoomMotion::UpdatePanFromCursor(int cursorX, int cursorY) {
+    if (!m_hasActiveMonitor) return;
+
+    int monitorWidth = m_activeMonitor.GetWidth();
+    int monitorHeight = m_activeMonitor.GetHeight();
+
+    if (monitorWidth == 0 || monitorHeight == 0) return;
+
+    // Normalize cursor position within monitor (0.0 to 1.0)
+    float normX = static_cast<float>(cursorX - m_activeMonitor.left) / monitorWidth;
+    float normY = static_cast<float>(cursorY - m_activeMonitor.top) / monitorHeight;
+
+    // Clamp to valid range
+    normX = std::clamp(normX, 0.0f, 1.0f);
+    normY = std::clamp(normY, 0.0f, 1.0f);
+
+    // Set target pan position
+    m_targetOffsetX = normX;
+    m_targetOffsetY = normY;
+
+    m_smoothOffsetX.SetTarget(normX);
+    m_smoothOffsetY.SetTarget(normY);
+}
+
+void ZoomMotion::FilterPan(float deltaTimeSec) {
+    // Filter in monitor pixels, so minCutoff and beta do not depend on the
+    // monitor size, and judge the motion at the current magnification
+    float width = static_cast<float>(m_activeMonitor.GetWidth());
+    float height = static_cast<float>(m_activeMonitor.GetHeight());
+    float targetX = m_targetOffsetX * width;
+    float targetY = m_targetOffsetY * height;
+
+    float x = m_panFilterX.Filter(targetX, deltaTimeSec, m_currentLevel);
+    float y = m_panFilterY.Filter(targetY, deltaTimeSec, m_currentLevel);
+    if (std::fabs(targetX - x) < PAN_FILTER_SNAP_PX && std::fabs(targetY - y) < PAN_FILTER_SNAP_PX) {
+        m_panFilterX.Reset(targetX);
+        m_panFilterY.Reset(targetY);
+        x = targetX;
+        y = targetY;
+    }
+
+    m_offsetX = x == targetX ? m_targetOffsetX : x / width;
+    m_offsetY = y == targetY ? m_targetOffsetY : y / height;
+
+    // Hand the position over to the exponential smoothing for zooming out
+    m_smoothOffsetX.SetImmediate(m_offsetX);
+    m_smoothOffsetY.SetImmediate(m_offsetY);
+    m_smoothOffsetX.SetTarget(m_targetOffsetX);
+    m_smoothOffsetY.SetTarget(m_targetOffsetY);
+}
+
+void ZoomMotion::ApplyMagnification() {
+    if (!m_backend) return;
+
+    // Skip magnification API calls when at or very close to 1.0x zoom
+    // This prevents unnecessary API calls that can affect cursor behavior
+    if (m_currentLevel <= 1.001f) {
+        // If magnification is still active, fully deactivate it.
+        // ResetZoom() drops the monitor immediately while the smooth
+        // animation is still in progress, so check the session instead.
+        if (m_backend->IsInitialized()) {
+            m_backend->ResetMagnification();
+        }
+        m_hasActiveMonitor = false;
+        return;
+    }
+
+    // Active monitor, or the primary while zooming back out
+    ZoomRect monitorRect;
+    if (!GetPanRect(monitorRect)) return;
+
+    // Calculate center point based on normalized offset
+    int centerX = monitorRect.left + static_cast<int>(m_offsetX * monitorRect.GetWidth());
+    int centerY = monitorRect.top + static_cast<int>(m_offsetY * monitorRect.GetHeight());
+    MagnifierTransform transform = ComputeMagnifierTransform(m_currentLevel, centerX, centerY, m_geometry);
+
+    // Skip steps too small to see; the settled transform always goes out
+    if (!m_backend->IsInitialized()) {
+        m_coalescer.Reset();
+    }
+    bool settled = m_currentLevel == m_targetLevel &&
+                   m_offsetX == m_targetOffsetX &&
+                   m_offsetY == m_targetOffsetY;
+    if (!m_coalescer.ShouldIssue(transform, monitorRect, m_timeMs, settled)) {
+        return;
+    }
+
+    m_backend->SetFullscreenTransform(transform);
+}
+
+bool ZoomMotion::CheckDoubleTap(uint64_t nowMs) const {
+    if (!m_config.doubleTapToReset) return false;
+    if (!m_hasModifierTap) return false;
+
+    return nowMs - m_lastModifierTapMs <= m_config.doubleTapWindowMs;
+}
+
+int ZoomMotion::FindMonitor(int x, int y) const {
+    // Containing monitor, else the nearest one (MONITOR_DEFAULTTONEAREST)
+    int nearest = -1;
+    int64_t nearestDistance = std::numeric_limits<int64_t>::max();
+    for (size_t i = 0; i < m_geometry.monitors.size(); i++) {
+        const ZoomRect& rect = m_geometry.monitors[i];
+        if (rect.Contains(x, y)) {
+            return static_cast<int>(i);
+        }
+        int64_t dx = x < rect.left ? rect.left - x : (x >= rect.right ? x - (rect.right - 1) : 0);
+        int64_t dy = y < rect.top ? rect.top - y : (y >= rect.bottom ? y - (rect.bottom - 1) : 0);
+        int64_t distance = dx * dx + dy * dy;
+        if (distance < nearestDistance) {
+            nearestDistance = distance;
+            nearest = static_cast<int>(i);
+        }
+    }
+    return nearest;
+}
+
+}  // namespace VirtualOverlay
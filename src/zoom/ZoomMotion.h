@@ -0,0 +1,133 @@
+#pragma once
+
+// Zoom level and pan state machine, driven by input and timer ticks.
+//
+// ZoomController feeds it live input and the screen geometry; the zoom trace
+// replay feeds it recorded input, so both run exactly the same smoothing and
+// produce the same magnifier calls. Time comes in with the calls (tick
+// deltas, modifier timestamps), never from a clock.
+// Platform-independent (no <windows.h>).
+
+#include "CursorPredictor.h"
+#include "MagnifierBackend.h"
+#include "ScreenGeometry.h"
+#include "TransformCoalescer.h"
+#include "../utils/Animation.h"
+#include <cstdint>
+#include <vector>
+
+namespace VirtualOverlay {
+
+// How the pan follows the cursor
+enum class ZoomPanFilter : uint8_t {
+    Exponential,  // SmoothValue at smoothingFactor
+    OneEuro       // OneEuroFilter: speed-adaptive, scaled by the zoom level
+};
+
+const char* ZoomPanFilterToString(ZoomPanFilter filter);
+
+// The ZoomSettings values the state machine uses
+struct ZoomMotionConfig {
+    float zoomStep = 0.5f;
+    float minZoom = 1.0f;
+    float maxZoom = 10.0f;
+    bool smoothing = true;
+    float smoothingFactor = 0.08f;
+    bool doubleTapToReset = true;
+    uint32_t doubleTapWindowMs = 300;
+    ZoomPanFilter panFilter = ZoomPanFilter::Exponential;
+    float panMinCutoffHz = 1.0f;    // OneEuro: cutoff at rest, divided by the level
+    float panBeta = 0.005f;         // OneEuro: Hz added per on-screen pixel/s
+    CursorPredictorConfig prediction;       // Pan towards where the cursor is heading
+    TransformCoalescingConfig coalescing;   // Which transforms reach the backend
+};
+
+class ZoomMotion {
+public:
+    ZoomMotion();
+
+    // Not owned; calls are skipped while null
+    void SetBackend(MagnifierBackend* backend) { m_backend = backend; }
+    void SetConfig(const ZoomMotionConfig& config);
+    const ZoomMotionConfig& GetConfig() const { return m_config; }
+
+    // Snapshot every transform is computed from. On a new generation the
+    // monitor being zoomed is picked again from the new layout.
+    void SetGeometry(ScreenGeometry geometry);
+    const ScreenGeometry& GetGeometry() const { return m_geometry; }
+
+    // Straight back to 1.0x with no animation (controller start-up)
+    void Reset();
+
+    // Input. The cursor position picks the monitor when a zoom starts. With
+    // prediction on, cursor samples are stamped with the next Update's time.
+    void ZoomIn(int cursorX, int cursorY);
+    void ZoomOut(int cursorX, int cursorY);
+    void ZoomToLevel(float level, int cursorX, int cursorY);
+    void ResetZoom();
+    void OnCursorMove(int x, int y);
+
+    // True if the press was a double tap, which resets the zoom
+    bool OnModifierPressed(uint64_t nowMs);
+    void OnModifierReleased();
+
+    // Advance the smoothing and send the resulting transform to the backend
+    void Update(float deltaTimeMs);
+
+    float GetCurrentLevel() const { return m_currentLevel; }
+    float GetTargetLevel() const { return m_targetLevel; }
+    bool IsZoomed() const { return m_currentLevel > 1.001f; }
+    bool HasReachedTargetLevel() const { return m_smoothLevel.HasReachedTarget(); }
+
+    // Pan position (0-1 across the monitor) and the cursor position it follows
+    float GetOffsetX() const { return m_offsetX; }
+    float GetOffsetY() const { return m_offsetY; }
+    float GetTargetOffsetX() const { return m_targetOffsetX; }
+    float GetTargetOffsetY() const { return m_targetOffsetY; }
+
+    // Monitor the pan is relative to; false if there is none
+    bool GetPanRect(ZoomRect& rect) const;
+
+    const TransformCoalescerStats& GetTransformStats() const { return m_coalescer.GetStats(); }
+
+private:
+    void UpdatePanFromCursor(int cursorX, int cursorY);
+    void FilterPan(float deltaTimeSec);
+    void ApplyMagnification();
+    bool CheckDoubleTap(uint64_t nowMs) const;
+    int FindMonitor(int x, int y) const;
+
+    MagnifierBackend* m_backend = nullptr;
+    ZoomMotionConfig m_config;
+    ScreenGeometry m_geometry;
+
+    float m_currentLevel = 1.0f;
+    float m_targetLevel = 1.0f;
+    float m_offsetX = 0.0f;
+    float m_offsetY = 0.0f;
+    float m_targetOffsetX = 0.0f;
+    float m_targetOffsetY = 0.0f;
+
+    bool m_hasActiveMonitor = false;  // Captured when a zoom starts
+    ZoomRect m_activeMonitor;
+
+    bool m_modifierHeld = false;
+    bool m_hasModifierTap = false;
+    uint64_t m_lastModifierTapMs = 0;
+
+    SmoothValue m_smoothLevel;
+    SmoothValue m_smoothOffsetX;
+    SmoothValue m_smoothOffsetY;
+    OneEuroFilter<float> m_panFilterX;  // Monitor pixels; used while a monitor is zoomed
+    OneEuroFilter<float> m_panFilterY;
+
+    CursorPredictor m_predictor;
+    bool m_hasCursorSample = false;   // Arrived since the last Update
+    int m_cursorX = 0;
+    int m_cursorY = 0;
+
+    double m_timeMs = 0.0;  // Sum of Update deltas: the coalescer's clock
+    TransformCoalescer m_coalescer;
+};
+
+}  // namespace VirtualOverlay
@@ -0,0 +1,306 @@
+#include "ZoomReplay.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace VirtualOverlay {
+
+namespace {
+
+constexpr float PAN_SETTLED_PX = 0.5f;
+
+// The cursor counts as held once it has stayed this close (monitor pixels)
+// to one spot for this long
+constexpr double HOLD_RADIUS_PX = 3.0;
+constexpr double HOLD_MS = 250.0;
+
+float Direction(float from, float to) {
+    return to > from ? 1.0f : (to < from ? -1.0f : 0.0f);
+}
+
+// One value converging on a target that inputs keep moving
+struct Convergence {
+    bool pending = false;
+    int64_t start = 0;
+    uint32_t count = 0;
+    double totalMs = 0.0;
+    double maxMs = 0.0;
+
+    void Begin(int64_t time) {
+        pending = true;
+        start = time;
+    }
+
+    void Settle(const ZoomTrace& trace, int64_t time) {
+        double ms = trace.ToMilliseconds(time - start);
+        count++;
+        totalMs += ms;
+        maxMs = std::max(maxMs, ms);
+        pending = false;
+    }
+
+    double GetMeanMs() const { return count > 0 ? totalMs / count : 0.0; }
+};
+
+struct CursorSample {
+    double timeMs = 0.0;
+    float x = 0.0f;
+    float y = 0.0f;
+};
+
+// Cursor position at timeMs, from the samples after index `from`; false
+// past the last sample
+bool GetCursorAt(const std::vector<CursorSample>& samples, size_t from, double timeMs,
+                 double& x, double& y) {
+    for (size_t i = from + 1; i < samples.size(); i++) {
+        const CursorSample& before = samples[i - 1];
+        const CursorSample& after = samples[i];
+        if (after.timeMs < timeMs) {
+            continue;
+        }
+        double span = after.timeMs - before.timeMs;
+        double t = span > 0.0 ? (timeMs - before.timeMs) / span : 1.0;
+        x = before.x + (after.x - before.x) * t;
+        y = before.y + (after.y - before.y) * t;
+        return true;
+    }
+    return false;
+}
+
+void ApplyInput(ZoomMotion& motion, const ZoomInputEvent& event, uint64_t nowMs) {
+    switch (event.kind) {
+        case ZoomInputKind::Tick:
+            motion.Update(event.value);
+            break;
+        case ZoomInputKind::Wheel:
+            if (event.value > 0.0f) {
+                motion.ZoomIn(event.x, event.y);
+            } else {
+                motion.ZoomOut(event.x, event.y);
+            }
+            break;
+        case ZoomInputKind::Gesture:
+            motion.ZoomToLevel(event.value, event.x, event.y);
+            break;
+        case ZoomInputKind::Reset:
+            motion.ResetZoom();
+            break;
+        case ZoomInputKind::ModifierDown:
+            motion.OnModifierPressed(nowMs);
+            break;
+        case ZoomInputKind::ModifierUp:
+            motion.OnModifierReleased();
+            break;
+        case ZoomInputKind::Cursor:
+            motion.OnCursorMove(event.x, event.y);
+            break;
+    }
+}
+
+}  // namespace
+
+ZoomReplayReport ReplayZoomTrace(const ZoomTrace& trace, const ZoomMotionConfig& config,
+                                 RecordingMagnifierBackend& backend) {
+    ZoomReplayReport report;
+    backend.Clear();
+
+    ZoomMotion motion;
+    motion.SetConfig(config);
+    motion.SetGeometry(MakeScreenGeometry(trace.monitors, 1));
+    motion.SetBackend(&backend);
+
+    Convergence level;
+    Convergence pan;
+    double lagTotal = 0.0;
+    uint64_t lagCount = 0;
+    double jitterTotal = 0.0;
+    uint64_t jitterCount = 0;
+    bool hasPan = false;        // Last tick was zoomed at a steady level
+    ZoomRect panRect;
+    double panX = 0.0;          // Last on-screen pan position
+    double panY = 0.0;
+    double holdX = 0.0;         // Where the cursor came to rest, and when
+    double holdY = 0.0;
+    int64_t holdStart = 0;
+    float levelDirection = 0.0f;
+    float panDirectionX = 0.0f;
+    float panDirectionY = 0.0f;
+
+    int64_t origin = trace.events.empty() ? 0 : trace.events.front().time;
+    for (const ZoomInputEvent& event : trace.events) {
+        float targetLevel = motion.GetTargetLevel();
+        float targetX = motion.GetTargetOffsetX();
+        float targetY = motion.GetTargetOffsetY();
+        float offsetX = motion.GetOffsetX();
+        float offsetY = motion.GetOffsetY();
+
+        uint64_t nowMs = static_cast<uint64_t>(trace.ToMilliseconds(event.time - origin));
+        ApplyInput(motion, event, nowMs);
+        report.events++;
+
+        // Inputs move targets; convergence restarts from the newest. With
+        // cursor prediction the pan target moves on the tick that takes
+        // the sample instead.
+        if (motion.GetTargetOffsetX() != targetX || motion.GetTargetOffsetY() != targetY) {
+            pan.Begin(event.time);
+            panDirectionX = Direction(offsetX, motion.GetTargetOffsetX());
+            panDirectionY = Direction(offsetY, motion.GetTargetOffsetY());
+        }
+        if (event.kind != ZoomInputKind::Tick) {
+            if (motion.GetTargetLevel() != targetLevel) {
+                level.Begin(event.time);
+                levelDirection = Direction(motion.GetCurrentLevel(), motion.GetTargetLevel());
+            }
+            continue;
+        }
+        report.ticks++;
+
+        if (level.pending) {
+            float past = (motion.GetCurrentLevel() - motion.GetTargetLevel()) * levelDirection;
+            report.levelOvershoot = std::max(report.levelOvershoot, static_cast<double>(past));
+            if (motion.HasReachedTargetLevel()) {
+                level.Settle(trace, event.time);
+            }
+        }
+
+        ZoomRect rect;
+        if (motion.IsZoomed() && motion.HasReachedTargetLevel() && motion.GetPanRect(rect)) {
+            double scaleX = static_cast<double>(rect.GetWidth()) * motion.GetCurrentLevel();
+            double scaleY = static_cast<double>(rect.GetHeight()) * motion.GetCurrentLevel();
+            double lag = std::hypot((motion.GetOffsetX() - motion.GetTargetOffsetX()) * scaleX,
+                                    (motion.GetOffsetY() - motion.GetTargetOffsetY()) * scaleY);
+            lagTotal += lag;
+            lagCount++;
+            report.panLagMaxPx = std::max(report.panLagMaxPx, lag);
+
+            double targetPxX = motion.GetTargetOffsetX() * rect.GetWidth();
+            double targetPxY = motion.GetTargetOffsetY() * rect.GetHeight();
+            if (!hasPan || rect != panRect ||
+                std::hypot(targetPxX - holdX, targetPxY - holdY) > HOLD_RADIUS_PX) {
+                holdX = targetPxX;
+                holdY = targetPxY;
+                holdStart = event.time;
+            }
+
+            double x = motion.GetOffsetX() * scaleX;
+            double y = motion.GetOffsetY() * scaleY;
+            if (hasPan && rect == panRect && trace.ToMilliseconds(event.time - holdStart) >= HOLD_MS) {
+                jitterTotal += (x - panX) * (x - panX) + (y - panY) * (y - panY);
+                jitterCount++;
+            }
+            hasPan = true;
+            panRect = rect;
+            panX = x;
+            panY = y;
+        } else {
+            hasPan = false;
+        }
+
+        if (pan.pending && motion.IsZoomed() && motion.GetPanRect(rect)) {
+            float errorX = (motion.GetOffsetX() - motion.GetTargetOffsetX()) * rect.GetWidth();
+            float errorY = (motion.GetOffsetY() - motion.GetTargetOffsetY()) * rect.GetHeight();
+            float past = std::max(errorX * panDirectionX, errorY * panDirectionY);
+            report.panOvershootPx = std::max(report.panOvershootPx, static_cast<double>(past));
+            if (std::fabs(errorX) < PAN_SETTLED_PX && std::fabs(errorY) < PAN_SETTLED_PX) {
+                pan.Settle(trace, event.time);
+            }
+        } else if (pan.pending && !motion.IsZoomed()) {
+            pan.pending = false;  // Zoomed out: there is no pan to settle
+        }
+    }
+
+    const RecordingMagnifierBackend::CallCounts& calls = backend.GetCallCounts();
+    report.durationSec = trace.GetDurationSeconds();
+    report.setCalls = calls.set;
+    report.changedCalls = calls.changed;
+    report.resetCalls = calls.reset;
+    report.suppressedCalls = motion.GetTransformStats().GetSuppressed();
+    if (report.durationSec > 0.0) {
+        report.callsPerSecond = static_cast<double>(calls.set) / report.durationSec;
+    }
+    report.levelSettles = level.count;
+    report.levelSettleMeanMs = level.GetMeanMs();
+    report.levelSettleMaxMs = level.maxMs;
+    report.panSettles = pan.count;
+    report.panSettleMeanMs = pan.GetMeanMs();
+    report.panSettleMaxMs = pan.maxMs;
+    if (lagCount > 0) {
+        report.panLagMeanPx = lagTotal / lagCount;
+    }
+    if (jitterCount > 0) {
+        report.panJitterPx = std::sqrt(jitterTotal / jitterCount);
+    }
+    return report;
+}
+
+CursorPredictionReport EvaluateCursorPrediction(const ZoomTrace& trace, const CursorPredictorConfig& config) {
+    CursorPredictionReport report;
+
+    CursorPredictor predictor;
+    predictor.SetConfig(config);
+
+    // Predict at every sample, then score against the samples that followed
+    std::vector<CursorSample> samples;
+    std::vector<CursorSample> predictions;
+    double timeMs = 0.0;
+    bool pending = false;
+    CursorSample cursor;
+    for (const ZoomInputEvent& event : trace.events) {
+        if (event.kind == ZoomInputKind::Cursor) {
+            cursor.x = static_cast<float>(event.x);
+            cursor.y = static_cast<float>(event.y);
+            pending = true;
+        } else if (event.kind == ZoomInputKind::Tick) {
+            timeMs += event.value;
+            if (!pending) {
+                continue;
+            }
+            pending = false;
+
+            cursor.timeMs = timeMs;
+            predictor.AddSample(timeMs, cursor.x, cursor.y);
+
+            CursorSample predicted;
+            predicted.timeMs = timeMs + config.leadMs;
+            predictor.Predict(predicted.x, predicted.y);
+            samples.push_back(cursor);
+            predictions.push_back(predicted);
+        }
+    }
+    report.samples = samples.size();
+
+    double errorTotal = 0.0;
+    double errorSquares = 0.0;
+    double baselineTotal = 0.0;
+    double baselineSquares = 0.0;
+    for (size_t i = 0; i < samples.size(); i++) {
+        double actualX = 0.0;
+        double actualY = 0.0;
+        if (!GetCursorAt(samples, i, predictions[i].timeMs, actualX, actualY)) {
+            break;
+        }
+        report.predictions++;
+
+        double error = std::hypot(predictions[i].x - actualX, predictions[i].y - actualY);
+        double baseline = std::hypot(samples[i].x - actualX, samples[i].y - actualY);
+        errorTotal += error;
+        errorSquares += error * error;
+        baselineTotal += baseline;
+        baselineSquares += baseline * baseline;
+        report.errorMaxPx = std::max(report.errorMaxPx, error);
+        if (baseline == 0.0) {
+            report.stopErrorMaxPx = std::max(report.stopErrorMaxPx, error);
+        }
+    }
+
+    if (report.predictions > 0) {
+        double count = static_cast<double>(report.predictions);
+        report.errorMeanPx = errorTotal / count;
+        report.errorRmsPx = std::sqrt(errorSquares / count);
+        report.baselineMeanPx = baselineTotal / count;
+        report.baselineRmsPx = std::sqrt(baselineSquares / count);
+    }
+    return report;
+}
+
+}  // namespace VirtualOverlay
@@ -0,0 +1,80 @@
+#pragma once
+
+// Deterministic replay of a zoom input trace.
+//
+// Runs the recorded inputs through a fresh ZoomMotion with the given
+// settings against a recording magnifier backend, and measures what the
+// user would have seen: magnifier calls per second, how long the level and
+// the pan take to settle after an input, and how far they overshoot. The
+// same trace replayed with two settings compares them directly. The cursor
+// samples alone can also be run through a CursorPredictor to see how close
+// its predictions come to where the cursor actually went.
+// Platform-independent (no <windows.h>).
+
+#include "CursorPredictor.h"
+#include "MagnifierBackend.h"
+#include "ZoomMotion.h"
+#include "ZoomTrace.h"
+#include <cstdint>
+
+namespace VirtualOverlay {
+
+struct ZoomReplayReport {
+    uint64_t events = 0;
+    uint64_t ticks = 0;
+    double durationSec = 0.0;
+
+    uint64_t setCalls = 0;        // SetFullscreenTransform
+    uint64_t changedCalls = 0;    // ...with a transform different from the last
+    uint64_t resetCalls = 0;
+    uint64_t suppressedCalls = 0; // Transforms dropped by the coalescer
+    double callsPerSecond = 0.0;  // setCalls over the trace duration
+
+    // Convergence: from the last input that moved a target to the first
+    // tick at which the value reached it (level within 0.001, pan within
+    // half a screen pixel)
+    uint32_t levelSettles = 0;
+    double levelSettleMeanMs = 0.0;
+    double levelSettleMaxMs = 0.0;
+    uint32_t panSettles = 0;
+    double panSettleMeanMs = 0.0;
+    double panSettleMaxMs = 0.0;
+
+    // Largest excursion past the target, in the direction of travel
+    double levelOvershoot = 0.0;  // Zoom level units
+    double panOvershootPx = 0.0;  // Monitor pixels
+
+    // Pan as seen on screen (monitor pixels times the zoom level) while
+    // zoomed at a steady level: how far it trails the cursor, and how much
+    // it still moves per tick once the cursor is held still (tremor, drift)
+    double panLagMeanPx = 0.0;
+    double panLagMaxPx = 0.0;
+    double panJitterPx = 0.0;     // RMS
+};
+
+struct CursorPredictionReport {
+    uint64_t samples = 0;
+    uint64_t predictions = 0;     // Samples whose lead time falls inside the trace
+
+    // Distance from each prediction to the cursor position at that time
+    // (interpolated between samples), in monitor pixels
+    double errorMeanPx = 0.0;
+    double errorRmsPx = 0.0;
+    double errorMaxPx = 0.0;
+
+    // The same for the newest sample as the prediction (no prediction)
+    double baselineMeanPx = 0.0;
+    double baselineRmsPx = 0.0;
+
+    // Largest error where the cursor did not move during the lead time:
+    // how far the prediction overshoots a stop
+    double stopErrorMaxPx = 0.0;
+};
+
+ZoomReplayReport ReplayZoomTrace(const ZoomTrace& trace, const ZoomMotionConfig& config,
+                                 RecordingMagnifierBackend& backend);
+
+// Cursor samples are timed the way ZoomMotion times them: at the next tick
+CursorPredictionReport EvaluateCursorPrediction(const ZoomTrace& trace, const CursorPredictorConfig& config);
+
+}  // namespace VirtualOverlay
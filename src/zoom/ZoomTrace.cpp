@@ -0,0 +1,293 @@
+#include "ZoomTrace.h"
+#include <cstring>
+
+namespace VirtualOverlay {
+
+namespace {
+
+constexpr uint8_t TRACE_MAGIC[4] = { 'V', 'O', 'Z', 'T' };
+constexpr uint8_t TRACE_VERSION = 1;
+constexpr uint8_t KIND_COUNT = static_cast<uint8_t>(ZoomInputKind::Cursor) + 1;
+constexpr size_t MAX_MONITORS = 64;
+
+bool HasPosition(ZoomInputKind kind) {
+    return kind == ZoomInputKind::Wheel || kind == ZoomInputKind::Gesture ||
+           kind == ZoomInputKind::Cursor;
+}
+
+bool HasValue(ZoomInputKind kind) {
+    return kind == ZoomInputKind::Tick || kind == ZoomInputKind::Wheel ||
+           kind == ZoomInputKind::Gesture;
+}
+
+// Two int32 coordinates are never further apart than this, which also keeps
+// the decoder's running sum far from int64 overflow
+bool IsPositionDelta(int64_t delta) {
+    return delta >= -static_cast<int64_t>(UINT32_MAX) && delta <= static_cast<int64_t>(UINT32_MAX);
+}
+
+void PutVarint(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+void PutSigned(std::vector<uint8_t>& out, int64_t value) {
+    PutVarint(out, (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+}
+
+void PutFloat(std::vector<uint8_t>& out, float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    for (int i = 0; i < 4; i++) {
+        out.push_back(static_cast<uint8_t>(bits >> (8 * i)));
+    }
+}
+
+// Bounds-checked cursor over the encoded bytes
+class TraceReader {
+public:
+    TraceReader(const uint8_t* data, size_t size) : m_data(data), m_size(size) {}
+
+    size_t GetRemaining() const { return m_size - m_pos; }
+
+    bool GetByte(uint8_t& value) {
+        if (m_pos >= m_size) return false;
+        value = m_data[m_pos++];
+        return true;
+    }
+
+    bool GetVarint(uint64_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            uint8_t byte;
+            if (!GetByte(byte)) return false;
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) return true;
+        }
+        return false;  // Longer than 10 bytes
+    }
+
+    bool GetSigned(int64_t& value) {
+        uint64_t raw;
+        if (!GetVarint(raw)) return false;
+        value = static_cast<int64_t>(raw >> 1) ^ -static_cast<int64_t>(raw & 1);
+        return true;
+    }
+
+    bool GetInt32(int32_t& value) {
+        int64_t wide;
+        if (!GetSigned(wide) || wide < INT32_MIN || wide > INT32_MAX) return false;
+        value = static_cast<int32_t>(wide);
+        return true;
+    }
+
+    bool GetFloat(float& value) {
+        if (GetRemaining() < 4) return false;
+        uint32_t bits = 0;
+        for (int i = 0; i < 4; i++) {
+            bits |= static_cast<uint32_t>(m_data[m_pos++]) << (8 * i);
+        }
+        std::memcpy(&value, &bits, sizeof(value));
+        return true;
+    }
+
+private:
+    const uint8_t* m_data;
+    size_t m_size;
+    size_t m_pos = 0;
+};
+
+}  // namespace
+
+const char* ZoomInputKindToString(ZoomInputKind kind) {
+    switch (kind) {
+        case ZoomInputKind::Tick:         return "tick";
+        case ZoomInputKind::Wheel:        return "wheel";
+        case ZoomInputKind::Gesture:      return "gesture";
+        case ZoomInputKind::Reset:        return "reset";
+        case ZoomInputKind::ModifierDown: return "modifier down";
+        case ZoomInputKind::ModifierUp:   return "modifier up";
+        case ZoomInputKind::Cursor:       return "cursor";
+        default:                          return "unknown";
+    }
+}
+
+double ZoomTrace::ToMilliseconds(int64_t ticks) const {
+    if (frequency <= 0) {
+        return 0.0;
+    }
+    return static_cast<double>(ticks) * 1000.0 / static_cast<double>(frequency);
+}
+
+double ZoomTrace::GetDurationSeconds() const {
+    if (events.empty()) {
+        return 0.0;
+    }
+    return ToMilliseconds(events.back().time - events.front().time) / 1000.0;
+}
+
+bool EncodeZoomTrace(const ZoomTrace& trace, std::vector<uint8_t>& out) {
+    out.clear();
+    if (trace.frequency <= 0 || trace.monitors.size() > MAX_MONITORS) {
+        return false;
+    }
+
+    out.insert(out.end(), TRACE_MAGIC, TRACE_MAGIC + sizeof(TRACE_MAGIC));
+    out.push_back(TRACE_VERSION);
+    PutVarint(out, static_cast<uint64_t>(trace.frequency));
+
+    PutVarint(out, trace.monitors.size());
+    for (const ZoomRect& rect : trace.monitors) {
+        PutSigned(out, rect.left);
+        PutSigned(out, rect.top);
+        PutSigned(out, rect.right);
+        PutSigned(out, rect.bottom);
+    }
+
+    // Times and positions as deltas: ticks and cursor samples mostly
+    // encode in a few bytes
+    PutVarint(out, trace.events.size());
+    int64_t lastTime = trace.events.empty() ? 0 : trace.events.front().time;
+    if (lastTime < 0) {
+        out.clear();
+        return false;
+    }
+    PutVarint(out, static_cast<uint64_t>(lastTime));
+    int32_t lastX = 0;
+    int32_t lastY = 0;
+    for (const ZoomInputEvent& event : trace.events) {
+        if (event.time < lastTime || static_cast<uint8_t>(event.kind) >= KIND_COUNT) {
+            out.clear();
+            return false;
+        }
+        out.push_back(static_cast<uint8_t>(event.kind));
+        PutVarint(out, static_cast<uint64_t>(event.time - lastTime));
+        lastTime = event.time;
+
+        if (HasPosition(event.kind)) {
+            PutSigned(out, static_cast<int64_t>(event.x) - lastX);
+            PutSigned(out, static_cast<int64_t>(event.y) - lastY);
+            lastX = event.x;
+            lastY = event.y;
+        }
+        if (HasValue(event.kind)) {
+            PutFloat(out, event.value);
+        }
+    }
+    return true;
+}
+
+bool DecodeZoomTrace(const uint8_t* data, size_t size, ZoomTrace& trace) {
+    trace = ZoomTrace();
+    if (!data || size < sizeof(TRACE_MAGIC) + 1 ||
+        std::memcmp(data, TRACE_MAGIC, sizeof(TRACE_MAGIC)) != 0) {
+        return false;
+    }
+    TraceReader reader(data + sizeof(TRACE_MAGIC), size - sizeof(TRACE_MAGIC));
+
+    uint8_t version;
+    uint64_t frequency;
+    if (!reader.GetByte(version) || version != TRACE_VERSION ||
+        !reader.GetVarint(frequency) || frequency == 0 || frequency > INT64_MAX) {
+        return false;
+    }
+    trace.frequency = static_cast<int64_t>(frequency);
+
+    uint64_t monitorCount;
+    if (!reader.GetVarint(monitorCount) || monitorCount > MAX_MONITORS) {
+        trace = ZoomTrace();
+        return false;
+    }
+    trace.monitors.resize(static_cast<size_t>(monitorCount));
+    for (ZoomRect& rect : trace.monitors) {
+        int32_t left, top, right, bottom;
+        if (!reader.GetInt32(left) || !reader.GetInt32(top) ||
+            !reader.GetInt32(right) || !reader.GetInt32(bottom)) {
+            trace = ZoomTrace();
+            return false;
+        }
+        rect.left = left;
+        rect.top = top;
+        rect.right = right;
+        rect.bottom = bottom;
+    }
+
+    // Every event takes at least two bytes, which bounds the reservation
+    uint64_t eventCount;
+    uint64_t startTime;
+    if (!reader.GetVarint(eventCount) || eventCount > reader.GetRemaining() / 2 ||
+        !reader.GetVarint(startTime) || startTime > INT64_MAX) {
+        trace = ZoomTrace();
+        return false;
+    }
+    int64_t lastTime = static_cast<int64_t>(startTime);
+    trace.events.reserve(static_cast<size_t>(eventCount));
+
+    int32_t lastX = 0;
+    int32_t lastY = 0;
+    for (uint64_t i = 0; i < eventCount; i++) {
+        ZoomInputEvent event;
+        uint8_t kind;
+        uint64_t delta;
+        if (!reader.GetByte(kind) || kind >= KIND_COUNT ||
+            !reader.GetVarint(delta) || delta > static_cast<uint64_t>(INT64_MAX - lastTime)) {
+            trace = ZoomTrace();
+            return false;
+        }
+        event.kind = static_cast<ZoomInputKind>(kind);
+        event.time = lastTime + static_cast<int64_t>(delta);
+        lastTime = event.time;
+
+        if (HasPosition(event.kind)) {
+            int64_t dx, dy;
+            if (!reader.GetSigned(dx) || !reader.GetSigned(dy) ||
+                !IsPositionDelta(dx) || !IsPositionDelta(dy)) {
+                trace = ZoomTrace();
+                return false;
+            }
+            int64_t x = lastX + dx;
+            int64_t y = lastY + dy;
+            if (x < INT32_MIN || x > INT32_MAX || y < INT32_MIN || y > INT32_MAX) {
+                trace = ZoomTrace();
+                return false;
+            }
+            event.x = lastX = static_cast<int32_t>(x);
+            event.y = lastY = static_cast<int32_t>(y);
+        }
+        if (HasValue(event.kind) && !reader.GetFloat(event.value)) {
+            trace = ZoomTrace();
+            return false;
+        }
+        trace.events.push_back(event);
+    }
+
+    if (reader.GetRemaining() != 0) {
+        trace = ZoomTrace();
+        return false;
+    }
+    return true;
+}
+
+void ZoomTraceRecorder::Start(int64_t frequency, std::vector<ZoomRect> monitors) {
+    m_trace = ZoomTrace();
+    m_trace.frequency = frequency;
+    m_trace.monitors = std::move(monitors);
+    m_dropped = 0;
+    m_recording = true;
+}
+
+void ZoomTraceRecorder::Record(const ZoomInputEvent& event) {
+    if (!m_recording) {
+        return;
+    }
+    if (m_trace.events.size() >= MAX_EVENTS) {
+        m_dropped++;
+        return;
+    }
+    m_trace.events.push_back(event);
+}
+
+}  // namespace VirtualOverlay
@@ -0,0 +1,77 @@
+#pragma once
+
+// Zoom input trace: every input the zoom state machine receives, with its
+// QueryPerformanceCounter timestamp, in a compact binary form.
+//
+// ZoomController records wheel notches, pinch gesture levels, resets,
+// modifier presses, cursor samples and timer ticks (with the delta the tick
+// used). ReplayZoomTrace feeds a trace back through ZoomMotion, so a
+// recorded session can be re-run deterministically against any smoothing
+// settings.
+//
+// Format (little-endian, v1): "VOZT", version byte, varint QPC frequency,
+// varint monitor count and zigzag-varint rects, varint event count and start
+// time, then per event a kind byte, varint time delta, zigzag-varint
+// position deltas (positional kinds) and a 32-bit float value (valued kinds).
+// Platform-independent (no <windows.h>).
+
+#include "ScreenGeometry.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace VirtualOverlay {
+
+enum class ZoomInputKind : uint8_t {
+    Tick,          // value: delta passed to Update, ms
+    Wheel,         // x, y: cursor; value: +1 zoom in, -1 zoom out
+    Gesture,       // x, y: cursor; value: level requested by the pinch
+    Reset,
+    ModifierDown,
+    ModifierUp,
+    Cursor         // x, y: cursor sample
+};
+
+const char* ZoomInputKindToString(ZoomInputKind kind);
+
+struct ZoomInputEvent {
+    int64_t time = 0;    // QPC ticks
+    ZoomInputKind kind = ZoomInputKind::Tick;
+    int32_t x = 0;
+    int32_t y = 0;
+    float value = 0.0f;
+};
+
+struct ZoomTrace {
+    int64_t frequency = 0;              // QPC ticks per second
+    std::vector<ZoomRect> monitors;     // Layout when recording started, primary first
+    std::vector<ZoomInputEvent> events; // Non-decreasing time
+
+    double ToMilliseconds(int64_t ticks) const;
+    double GetDurationSeconds() const;
+};
+
+bool EncodeZoomTrace(const ZoomTrace& trace, std::vector<uint8_t>& out);
+bool DecodeZoomTrace(const uint8_t* data, size_t size, ZoomTrace& trace);
+
+// Bounded in-memory recording; events past the limit are counted and dropped
+class ZoomTraceRecorder {
+public:
+    static constexpr size_t MAX_EVENTS = 1 << 20;  // ~2 h of 60 Hz ticks and cursor samples
+
+    void Start(int64_t frequency, std::vector<ZoomRect> monitors);
+    void Stop() { m_recording = false; }
+    bool IsRecording() const { return m_recording; }
+
+    void Record(const ZoomInputEvent& event);
+
+    const ZoomTrace& GetTrace() const { return m_trace; }
+    uint64_t GetDropped() const { return m_dropped; }
+
+private:
+    ZoomTrace m_trace;
+    bool m_recording = false;
+    uint64_t m_dropped = 0;
+};
+
+}  // namespace VirtualOverlay
@@ -0,0 +1,118 @@
+#pragma once
+
+// Minimal benchmark runner. Each benchmark is a callable run in batches
+// until minSeconds have passed; the report is time per call and, given
+// the work per call, throughput.
+//
+//   Bench::Options options = Bench::ParseOptions(argc, argv);
+//   Bench::Run(options, "parse 16 ids", 256.0, "B", [&] { ... });
+//   Bench::RunWithSetup(options, "blend", pixels, "px", [&] { restore }, [&] { ... });
+//
+// --quick runs each benchmark a few times only (ctest uses it to keep the
+// benchmarks building and running).
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+namespace VirtualOverlay {
+namespace Bench {
+
+struct Options {
+    double minSeconds = 0.5;
+    bool quick = false;
+};
+
+inline Options ParseOptions(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--quick") == 0) {
+            options.quick = true;
+            options.minSeconds = 0.0;
+        }
+    }
+    return options;
+}
+
+// Stops the compiler from discarding a result
+template <typename T>
+inline void KeepAlive(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Prints one result line; see Run for unitsPerCall and unit
+inline void Report(const std::string& name, double nsPerCall, double unitsPerCall, const char* unit) {
+    if (unitsPerCall > 0.0) {
+        double perSecond = unitsPerCall * 1e9 / nsPerCall;
+        const char* scale = "";
+        if (perSecond >= 1e9) {
+            perSecond /= 1e9;
+            scale = "G";
+        } else if (perSecond >= 1e6) {
+            perSecond /= 1e6;
+            scale = "M";
+        }
+        std::printf("%-44s %12.1f ns/call %10.2f %s%s/s\n", name.c_str(), nsPerCall, perSecond, scale, unit);
+    } else {
+        std::printf("%-44s %12.1f ns/call\n", name.c_str(), nsPerCall);
+    }
+}
+
+// unitsPerCall/unit describe the work done by one call, e.g. 1920 * 1080
+// and "px"; pass 0 to report time only
+template <typename Function>
+double Run(const Options& options, const std::string& name, double unitsPerCall, const char* unit,
+           Function&& function) {
+    using Clock = std::chrono::steady_clock;
+
+    function();  // Warm-up
+
+    uint64_t calls = 0;
+    uint64_t batch = 1;
+    double seconds = 0.0;
+    Clock::time_point start = Clock::now();
+    do {
+        for (uint64_t i = 0; i < batch; i++) {
+            function();
+        }
+        calls += batch;
+        seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        batch *= 2;
+    } while (seconds < options.minSeconds && !options.quick);
+
+    double nsPerCall = seconds * 1e9 / static_cast<double>(calls);
+    Report(name, nsPerCall, unitsPerCall, unit);
+    return nsPerCall;
+}
+
+// Like Run, but setup runs before every call outside the timed region (an
+// in-place kernel's input restored). Each call is timed on its own, so this
+// is only for calls far longer than a clock read.
+template <typename Setup, typename Function>
+double RunWithSetup(const Options& options, const std::string& name, double unitsPerCall, const char* unit,
+                    Setup&& setup, Function&& function) {
+    using Clock = std::chrono::steady_clock;
+
+    setup();
+    function();  // Warm-up
+
+    uint64_t calls = 0;
+    double timed = 0.0;
+    Clock::time_point start = Clock::now();
+    do {
+        setup();
+        Clock::time_point callStart = Clock::now();
+        function();
+        timed += std::chrono::duration<double>(Clock::now() - callStart).count();
+        calls++;
+    } while (std::chrono::duration<double>(Clock::now() - start).count() < options.minSeconds && !options.quick);
+
+    double nsPerCall = timed * 1e9 / static_cast<double>(calls);
+    Report(name, nsPerCall, unitsPerCall, unit);
+    return nsPerCall;
+}
+
+}  // namespace Bench
+}  // namespace VirtualOverlay
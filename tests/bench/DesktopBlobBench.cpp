@@ -0,0 +1,62 @@
+// Throughput of the VirtualDesktops registry value parsers: what a poll
+// pays to view, search and diff the id list and decode a name.
+
+#include "Bench.h"
+#include "desktop/DesktopBlob.h"
+#include <random>
+#include <vector>
+
+using namespace VirtualOverlay;
+
+int main(int argc, char** argv) {
+    Bench::Options options = Bench::ParseOptions(argc, argv);
+    std::mt19937 rng(7);
+
+    for (size_t count : { 4u, 16u, 100u, 1000u }) {
+        std::vector<uint8_t> blob(count * DesktopGuid::SIZE + 1);
+        for (uint8_t& byte : blob) {
+            byte = static_cast<uint8_t>(rng());
+        }
+        const uint8_t* data = blob.data() + 1;  // Unaligned, like a registry buffer
+        size_t size = count * DesktopGuid::SIZE;
+        DesktopGuid last = DesktopGuid::FromBytes(data + size - DesktopGuid::SIZE);
+
+        std::vector<uint8_t> changed(data, data + size);
+        changed[size / 2] ^= 1;
+
+        std::string suffix = " (" + std::to_string(count) + " desktops)";
+        Bench::Run(options, "parse + find last" + suffix, static_cast<double>(size), "B", [&] {
+            DesktopIdListView view;
+            DesktopIdListView::Parse(data, size, view);
+            Bench::KeepAlive(view.Find(last));
+        });
+        Bench::Run(options, "parse both + diff" + suffix, static_cast<double>(size), "B", [&] {
+            DesktopIdListView oldList;
+            DesktopIdListView newList;
+            DesktopIdListView::Parse(data, size, oldList);
+            DesktopIdListView::Parse(changed.data(), size, newList);
+            Bench::KeepAlive(DiffDesktopIdLists(oldList, newList).changedPositions);
+        });
+    }
+
+    std::vector<uint8_t> name;
+    for (wchar_t c : std::wstring(L"Desktop 12: Project notes")) {
+        name.push_back(static_cast<uint8_t>(c));
+        name.push_back(0);
+    }
+    name.push_back(0);
+    name.push_back(0);
+    std::wstring decoded;
+    Bench::Run(options, "parse + decode name", static_cast<double>(name.size()), "B", [&] {
+        DesktopNameView view;
+        DesktopNameView::Parse(name.data(), name.size(), view);
+        view.AssignTo(decoded);
+        Bench::KeepAlive(decoded.size());
+    });
+    Bench::Run(options, "parse + compare name", static_cast<double>(name.size()), "B", [&] {
+        DesktopNameView view;
+        DesktopNameView::Parse(name.data(), name.size(), view);
+        Bench::KeepAlive(view.Equals(decoded));
+    });
+    return 0;
+}
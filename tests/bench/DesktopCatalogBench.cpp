@@ -0,0 +1,60 @@
+// DesktopCatalog against the linear scan it replaced: what a poll pays to
+// turn the current desktop's GUID into its number, and to notice that the
+// VirtualDesktopIDs value has not changed.
+
+#include "Bench.h"
+#include "desktop/DesktopCatalog.h"
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace VirtualOverlay;
+
+int main(int argc, char** argv) {
+    Bench::Options options = Bench::ParseOptions(argc, argv);
+    std::mt19937 rng(11);
+
+    for (size_t count : { 4u, 16u, 100u, 1000u }) {
+        std::vector<uint8_t> blob(count * DesktopGuid::SIZE);
+        for (uint8_t& byte : blob) {
+            byte = static_cast<uint8_t>(rng());
+        }
+        std::vector<DesktopGuid> ids(count);
+        for (size_t i = 0; i < count; i++) {
+            ids[i] = DesktopGuid::FromBytes(blob.data() + i * DesktopGuid::SIZE);
+        }
+        DesktopCatalog catalog;
+        catalog.UpdateFromBlob(blob.data(), blob.size());
+
+        // Look up every desktop in turn, so the average is over positions
+        std::string suffix = " (" + std::to_string(count) + " desktops)";
+        size_t next = 0;
+        Bench::Run(options, "catalog lookup" + suffix, 1, "lookup", [&] {
+            Bench::KeepAlive(catalog.IndexOf(ids[next]));
+            next = next + 1 == count ? 0 : next + 1;
+        });
+        next = 0;
+        Bench::Run(options, "linear scan" + suffix, 1, "lookup", [&] {
+            const DesktopGuid& id = ids[next];
+            int index = 0;
+            for (size_t i = 0; i < count; i++) {
+                if (DesktopGuid::FromBytes(blob.data() + i * DesktopGuid::SIZE) == id) {
+                    index = static_cast<int>(i + 1);
+                    break;
+                }
+            }
+            Bench::KeepAlive(index);
+            next = next + 1 == count ? 0 : next + 1;
+        });
+
+        Bench::Run(options, "unchanged value" + suffix, static_cast<double>(blob.size()), "B", [&] {
+            Bench::KeepAlive(catalog.UpdateFromBlob(blob.data(), blob.size()));
+        });
+        std::vector<uint8_t> changed = blob;
+        Bench::Run(options, "rebuild" + suffix, static_cast<double>(count), "desktop", [&] {
+            changed[0] ^= 1;
+            Bench::KeepAlive(catalog.UpdateFromBlob(changed.data(), changed.size()));
+        });
+    }
+    return 0;
+}
@@ -0,0 +1,97 @@
+// DiffDesktopTopology over large desktop lists: what a refresh pays to turn
+// two catalog snapshots into topology events, for one random edit (create,
+// remove, move or rename) and for a batch of ten.
+
+#include "Bench.h"
+#include "desktop/DesktopTopology.h"
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace VirtualOverlay;
+
+namespace {
+
+DesktopCatalog MakeCatalog(const std::vector<DesktopGuid>& ids, const std::vector<std::wstring>& names) {
+    DesktopCatalog catalog;
+    catalog.UpdateFromIds(ids.data(), ids.size());
+    for (size_t i = 0; i < ids.size(); i++) {
+        catalog.SetName(ids[i], names[i]);
+    }
+    return catalog;
+}
+
+DesktopGuid MakeId(std::mt19937& rng) {
+    DesktopGuid id;
+    for (uint8_t& byte : id.bytes) {
+        byte = static_cast<uint8_t>(rng());
+    }
+    return id;
+}
+
+// Snapshot pairs, each `edits` random edits apart
+std::vector<std::pair<DesktopCatalog, DesktopCatalog>> MakeEdits(std::mt19937& rng, size_t count, int edits,
+                                                                 size_t pairs) {
+    std::vector<std::pair<DesktopCatalog, DesktopCatalog>> result;
+    for (size_t p = 0; p < pairs; p++) {
+        std::vector<DesktopGuid> ids;
+        std::vector<std::wstring> names;
+        for (size_t i = 0; i < count; i++) {
+            ids.push_back(MakeId(rng));
+            names.push_back(L"Desktop name " + std::to_wstring(i));
+        }
+        DesktopCatalog before = MakeCatalog(ids, names);
+        for (int e = 0; e < edits; e++) {
+            size_t at = rng() % ids.size();
+            switch (rng() % 4) {
+                case 0:
+                    ids.insert(ids.begin() + at, MakeId(rng));
+                    names.insert(names.begin() + at, L"New");
+                    break;
+                case 1:
+                    ids.erase(ids.begin() + at);
+                    names.erase(names.begin() + at);
+                    break;
+                case 2: {
+                    DesktopGuid id = ids[at];
+                    std::wstring name = names[at];
+                    ids.erase(ids.begin() + at);
+                    names.erase(names.begin() + at);
+                    size_t to = rng() % (ids.size() + 1);
+                    ids.insert(ids.begin() + to, id);
+                    names.insert(names.begin() + to, name);
+                    break;
+                }
+                default:
+                    names[at] += L" (renamed)";
+                    break;
+            }
+        }
+        result.emplace_back(std::move(before), MakeCatalog(ids, names));
+    }
+    return result;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Bench::Options options = Bench::ParseOptions(argc, argv);
+    std::mt19937 rng(17);
+
+    std::vector<DesktopTopologyEvent> events;
+    for (size_t count : { 10u, 100u, 1000u }) {
+        for (int edits : { 1, 10 }) {
+            auto pairs = MakeEdits(rng, count, edits, 16);
+            size_t next = 0;
+            std::string name = "diff " + std::to_string(count) + " desktops, " + std::to_string(edits) +
+                               (edits == 1 ? " edit" : " edits");
+            Bench::Run(options, name, static_cast<double>(count), "desktop", [&] {
+                events.clear();
+                const auto& pair = pairs[next];
+                Bench::KeepAlive(DiffDesktopTopology(pair.first, pair.second, events));
+                next = (next + 1) % pairs.size();
+            });
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,55 @@
+// Building a label's distance field and rendering it at a few sizes with
+// outline and glow, for a 120 px label (420 x 168 coverage).
+
+#include "Bench.h"
+#include "overlay/DistanceField.h"
+#include <cmath>
+#include <string>
+#include <vector>
+
+using namespace VirtualOverlay;
+
+int main(int argc, char** argv) {
+    Bench::Options options = Bench::ParseOptions(argc, argv);
+
+    const int width = 420;
+    const int height = 168;
+
+    // Text-like coverage: rings and bars with anti-aliased edges
+    std::vector<uint8_t> label(static_cast<size_t>(width) * height, 0);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            int glyph = x / 70;
+            float gx = static_cast<float>(x % 70) - 35.0f;
+            float gy = static_cast<float>(y) - 84.0f;
+            float d = (glyph % 2 == 0)
+                ? std::fabs(std::sqrt(gx * gx + gy * gy) - 26.0f) - 7.0f  // Ring
+                : std::max(std::fabs(gx) - 8.0f, std::fabs(gy) - 50.0f);  // Bar
+            float coverage = std::fmin(std::fmax(0.5f - d, 0.0f), 1.0f);
+            label[static_cast<size_t>(y) * width + x] = static_cast<uint8_t>(coverage * 255.0f + 0.5f);
+        }
+    }
+
+    Bench::Run(options, "build 420x168", static_cast<double>(label.size()), "px", [&] {
+        DistanceField field = BuildDistanceField(label.data(), width, height, 120);
+        Bench::KeepAlive(field.distance[0]);
+    });
+
+    DistanceField field = BuildDistanceField(label.data(), width, height, 120);
+    for (float scale : { 0.5f, 1.0f, 1.5f }) {
+        int targetWidth = static_cast<int>(width * scale);
+        int targetHeight = static_cast<int>(height * scale);
+        std::vector<uint8_t> fill(static_cast<size_t>(targetWidth) * targetHeight);
+        std::vector<uint8_t> halo(fill.size());
+        std::string size = std::to_string(targetWidth) + "x" + std::to_string(targetHeight);
+        Bench::Run(options, "render " + size + " fill only", static_cast<double>(fill.size()), "px", [&] {
+            RenderDistanceField(field, targetWidth, targetHeight, scale, 0.0f, 0.0f, fill.data(), halo.data());
+            Bench::KeepAlive(fill[0]);
+        });
+        Bench::Run(options, "render " + size + " outline 3 + glow 8", static_cast<double>(fill.size()), "px", [&] {
+            RenderDistanceField(field, targetWidth, targetHeight, scale, 3.0f, 8.0f, fill.data(), halo.data());
+            Bench::KeepAlive(halo[0]);
+        });
+    }
+    return 0;
+}
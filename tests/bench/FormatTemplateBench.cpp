@@ -0,0 +1,50 @@
+// Label formatting: compiling overlay.format (once per settings change) and
+// rendering a label from it (every switch and warm-up), for the default
+// format and a busier one with padding and sections.
+
+#include "Bench.h"
+#include "overlay/FormatTemplate.h"
+#include <string>
+
+using namespace VirtualOverlay;
+
+int main(int argc, char** argv) {
+    Bench::Options options = Bench::ParseOptions(argc, argv);
+
+    FormatValues values;
+    values.number = 3;
+    values.name = L"Project notes";
+    values.count = 6;
+    values.monitor = 2;
+
+    const struct {
+        const char* label;
+        const wchar_t* format;
+    } formats[] = {
+        { "default", L"Desktop {number}: {name}" },
+        { "sections", L"{number:02}/{count:02}{? · {name}}{? (monitor {monitor})}{? → {next}}" },
+    };
+
+    for (const auto& entry : formats) {
+        std::wstring source = entry.format;
+        std::string label = entry.label;
+        Bench::Run(options, "compile " + label, 0.0, "", [&] {
+            FormatTemplate compiled(source);
+            Bench::KeepAlive(compiled.GetSource().size());
+        });
+
+        FormatTemplate compiled(source);
+        std::wstring out;
+        Bench::Run(options, "render " + label + " (reused string)", 0.0, "", [&] {
+            compiled.Render(values, out);
+            Bench::KeepAlive(out.size());
+        });
+        values.name = {};
+        Bench::Run(options, "render " + label + " (unnamed desktop)", 0.0, "", [&] {
+            compiled.Render(values, out);
+            Bench::KeepAlive(out.size());
+        });
+        values.name = L"Project notes";
+    }
+    return 0;
+}
@@ -0,0 +1,84 @@
+// What a desktop switch pays for its label: a cache hit (lookup + copy into
+// the window bitmap) against drawing the frame again, plus the miss path.
+
+#include "Bench.h"
+#include "BoxTextMasks.h"
+#include "overlay/LabelCache.h"
+#include "overlay/SoftwareRenderBackend.h"
+#include <cstring>
+#include <vector>
+
+using namespace VirtualOverlay;
+
+namespace {
+
+const int WIDTH = 360;
+const int HEIGHT = 96;
+
+LabelKey MakeKey(int desktop) {
+    LabelKey key;
+    key.text = L"Desktop " + std::to_wstring(desktop) + L": Project notes";
+    key.style.fontFamily = L"Segoe UI";
+    key.style.fontSize = 28;
+    key.style.fontWeight = 600;
+    key.style.color = 0xFFFFFF;
+    key.style.padding = 16;
+    key.width = WIDTH;
+    key.height = HEIGHT;
+    return key;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Bench::Options options = Bench::ParseOptions(argc, argv);
+    double pixels = static_cast<double>(WIDTH) * HEIGHT;
+    std::vector<uint32_t> window(static_cast<size_t>(WIDTH) * HEIGHT);
+
+    SoftwareRenderBackend backend(BoxTextMask);
+    OverlayFrame frame;
+    frame.width = WIDTH;
+    frame.height = HEIGHT;
+    frame.cornerRadius = 8.0f;
+    frame.padding = 16.0f;
+    frame.background = RenderColor::FromRGB(0x202020, 0.8f);
+    frame.border = RenderColor::FromRGB(0x404040);
+    frame.borderWidth = 1.0f;
+    frame.text = MakeKey(1).text;
+    frame.textColor = RenderColor::FromRGB(0xFFFFFF);
+
+    LabelCache cache;
+    for (int desktop = 1; desktop <= 8; desktop++) {
+        LabelBitmap bitmap;
+        bitmap.width = WIDTH;
+        bitmap.height = HEIGHT;
+        bitmap.pixels.assign(window.size(), 0xFF202020);
+        cache.Insert(MakeKey(desktop), std::move(bitmap));
+    }
+    LabelKey hitKey = MakeKey(3);
+
+    Bench::Run(options, "redraw frame (software backend)", pixels, "px", [&] {
+        DrawOverlayFrame(backend, frame);
+        Bench::KeepAlive(backend.GetPixels()[0]);
+    });
+    Bench::Run(options, "cache hit: find + copy", pixels, "px", [&] {
+        const LabelBitmap* bitmap = cache.Find(hitKey);
+        std::memcpy(window.data(), bitmap->pixels.data(), bitmap->GetBytes());
+        Bench::KeepAlive(window[0]);
+    });
+    Bench::Run(options, "cache find only", 0.0, "", [&] {
+        Bench::KeepAlive(cache.Find(hitKey));
+    });
+
+    // Miss path with a full cache: evict the oldest and store the new label
+    LabelCache small(4 * window.size() * sizeof(uint32_t));
+    int next = 0;
+    Bench::Run(options, "miss: insert with eviction", pixels, "px", [&] {
+        LabelBitmap bitmap;
+        bitmap.width = WIDTH;
+        bitmap.height = HEIGHT;
+        bitmap.pixels.assign(window.size(), 0xFF202020);
+        Bench::KeepAlive(small.Insert(MakeKey(next++ % 64), std::move(bitmap)));
+    });
+    return 0;
+}
@@ -0,0 +1,62 @@
+// Outline and glow cost for a watermark label at 120 px text (a 420 x 168
+// coverage mask), per kernel.
+
+#include "Bench.h"
+#include "overlay/MaskFilter.h"
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace VirtualOverlay;
+
+int main(int argc, char** argv) {
+    Bench::Options options = Bench::ParseOptions(argc, argv);
+
+    const int width = 420;
+    const int height = 168;
+    double pixels = static_cast<double>(width) * height;
+
+    // Text-like coverage: glyph-sized blocks of strokes with soft edges
+    std::mt19937 rng(13);
+    std::vector<uint8_t> label(static_cast<size_t>(width) * height, 0);
+    for (int glyph = 0; glyph < 6; glyph++) {
+        int x0 = 20 + glyph * 64;
+        for (int stroke = 0; stroke < 4; stroke++) {
+            int sx = x0 + static_cast<int>(rng() % 40);
+            int sy = 24 + static_cast<int>(rng() % 100);
+            int sw = 8 + static_cast<int>(rng() % 30);
+            int sh = 8 + static_cast<int>(rng() % 30);
+            for (int y = sy; y < sy + sh && y < height; y++) {
+                for (int x = sx; x < sx + sw && x < width; x++) {
+                    bool edge = y == sy || x == sx || y == sy + sh - 1 || x == sx + sw - 1;
+                    label[static_cast<size_t>(y) * width + x] = edge ? 128 : 255;
+                }
+            }
+        }
+    }
+
+    std::vector<MaskKernel> kernels = { MaskKernel::Scalar };
+    MaskKernel best = GetBestMaskKernel();
+    if (best == MaskKernel::Sse2 || best == MaskKernel::Avx2) kernels.push_back(MaskKernel::Sse2);
+    if (best == MaskKernel::Avx2) kernels.push_back(MaskKernel::Avx2);
+
+    std::vector<uint8_t> dilated(label.size());
+    std::vector<uint8_t> blurred(label.size());
+    for (MaskKernel kernel : kernels) {
+        std::string name = MaskKernelToString(kernel);
+        for (int radius : { 1, 2, 4 }) {
+            Bench::Run(options, name + " dilate r=" + std::to_string(radius), pixels, "px", [&] {
+                DilateMask(label.data(), dilated.data(), width, height, radius, kernel);
+                Bench::KeepAlive(dilated[0]);
+            });
+        }
+        for (int radius : { 4, 12 }) {
+            Bench::Run(options, name + " blur r=" + std::to_string(radius), pixels, "px", [&] {
+                blurred = dilated;
+                BlurMask(blurred.data(), width, height, radius, kernel);
+                Bench::KeepAlive(blurred[0]);
+            });
+        }
+    }
+    return 0;
+}
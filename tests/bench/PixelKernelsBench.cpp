@@ -0,0 +1,59 @@
+// Pixel kernel throughput per kernel, on one megapixel (so ns/call is the
+// cost per megapixel): colorizing and blending coverage, the fade opacity
+// and bitmap compositing. The in-place kernels include restoring their
+// destination first (a 4 MB copy), as a frame redraw would.
+
+#include "Bench.h"
+#include "overlay/PixelKernels.h"
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace VirtualOverlay;
+
+int main(int argc, char** argv) {
+    Bench::Options options = Bench::ParseOptions(argc, argv);
+
+    const size_t count = 1000 * 1000;
+    std::mt19937 rng(16);
+    std::vector<uint8_t> coverage(count);
+    std::vector<uint32_t> src(count);
+    std::vector<uint32_t> dst(count);
+    for (size_t i = 0; i < count; i++) {
+        // Text-like: mostly empty or solid, anti-aliased in between
+        uint32_t r = rng() % 8;
+        coverage[i] = r < 4 ? 0 : r < 7 ? 255 : static_cast<uint8_t>(rng());
+        uint32_t a = rng() % 256;
+        src[i] = (a << 24) | ((a / 2) << 16) | ((a / 3) << 8) | (a / 4);
+        dst[i] = 0xFF202020;
+    }
+    uint32_t color = PremultiplyColor(0xF5E0DC, 230);
+
+    std::vector<PixelKernel> kernels = { PixelKernel::Scalar };
+    PixelKernel best = GetBestPixelKernel();
+    if (best == PixelKernel::Sse41 || best == PixelKernel::Avx2) kernels.push_back(PixelKernel::Sse41);
+    if (best == PixelKernel::Avx2) kernels.push_back(PixelKernel::Avx2);
+
+    double pixels = static_cast<double>(count);
+    std::vector<uint32_t> work(count);
+    for (PixelKernel kernel : kernels) {
+        std::string name = std::string(PixelKernelToString(kernel)) + " ";
+        Bench::Run(options, name + "colorize mask (1 Mpx)", pixels, "px", [&] {
+            ColorizeMask(coverage.data(), work.data(), count, color, kernel);
+            Bench::KeepAlive(work[0]);
+        });
+        Bench::RunWithSetup(options, name + "blend mask (1 Mpx)", pixels, "px", [&] { work = dst; }, [&] {
+            BlendMask(coverage.data(), work.data(), count, color, kernel);
+            Bench::KeepAlive(work[0]);
+        });
+        Bench::RunWithSetup(options, name + "scale pixels (1 Mpx)", pixels, "px", [&] { work = src; }, [&] {
+            ScalePixels(work.data(), count, 128, kernel);
+            Bench::KeepAlive(work[0]);
+        });
+        Bench::RunWithSetup(options, name + "blend over (1 Mpx)", pixels, "px", [&] { work = dst; }, [&] {
+            BlendOver(src.data(), work.data(), count, kernel);
+            Bench::KeepAlive(work[0]);
+        });
+    }
+    return 0;
+}
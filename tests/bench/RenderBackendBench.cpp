@@ -0,0 +1,73 @@
+// Frame time of the software backend for the overlay's frames: the
+// notification popup at 100% and 200% scale (opaque and mid-fade) and the
+// watermark label with a halo.
+
+#include "Bench.h"
+#include "BoxTextMasks.h"
+#include "overlay/MaskFilter.h"
+#include "overlay/RenderBackend.h"
+#include "overlay/SoftwareRenderBackend.h"
+#include <string>
+#include <vector>
+
+using namespace VirtualOverlay;
+
+int main(int argc, char** argv) {
+    Bench::Options options = Bench::ParseOptions(argc, argv);
+    SoftwareRenderBackend backend(BoxTextMask);
+
+    for (int scale : { 1, 2 }) {
+        OverlayFrame frame;
+        frame.width = 300 * scale;
+        frame.height = 80 * scale;
+        frame.cornerRadius = 12.0f * scale;
+        frame.padding = 16.0f * scale;
+        frame.background = RenderColor::FromRGB(0x1E1E2E, 0.85f);
+        frame.border = RenderColor::FromRGB(0x89B4FA);
+        frame.borderWidth = 1.0f * scale;
+        frame.text = L"Desktop 2: Mail";
+        frame.textColor = RenderColor::FromRGB(0xFFFFFF);
+        double pixels = static_cast<double>(frame.width) * frame.height;
+        std::string size = std::to_string(frame.width) + "x" + std::to_string(frame.height);
+
+        Bench::Run(options, "notification " + size, pixels, "px", [&] {
+            DrawOverlayFrame(backend, frame);
+            Bench::KeepAlive(backend.GetPixels()[0]);
+        });
+        frame.opacity = 0.5f;
+        frame.slideOffset = 10.0f;
+        Bench::Run(options, "notification " + size + " mid-fade", pixels, "px", [&] {
+            DrawOverlayFrame(backend, frame);
+            Bench::KeepAlive(backend.GetPixels()[0]);
+        });
+    }
+
+    // Watermark at 120 px text: coverage and halo are ready, the frame is
+    // two mask blends
+    const int width = 420;
+    const int height = 168;
+    std::vector<uint8_t> fill;
+    BoxTextMask(L"Desktop 3: Code", width, height, fill);
+    std::vector<uint8_t> halo(fill.size());
+    DilateMask(fill.data(), halo.data(), width, height, 3);
+    BlurMask(halo.data(), width, height, 4);
+
+    WatermarkFrame watermark;
+    watermark.width = width;
+    watermark.height = height;
+    watermark.fill = fill.data();
+    watermark.textColor = RenderColor::FromRGB(0xFFFFFF, 0.3f);
+    watermark.haloColor = RenderColor::FromRGB(0x000000, 0.3f);
+    double pixels = static_cast<double>(width) * height;
+
+    Bench::Run(options, "watermark 420x168", pixels, "px", [&] {
+        DrawWatermarkFrame(backend, watermark);
+        Bench::KeepAlive(backend.GetPixels()[0]);
+    });
+    watermark.halo = halo.data();
+    Bench::Run(options, "watermark 420x168 with halo", pixels, "px", [&] {
+        DrawWatermarkFrame(backend, watermark);
+        Bench::KeepAlive(backend.GetPixels()[0]);
+    });
+    return 0;
+}
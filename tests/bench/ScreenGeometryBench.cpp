@@ -0,0 +1,63 @@
+// Per-frame cost of the zoom transform: ComputeMagnifierTransform on one
+// and three monitors (one left of and above the primary), and a whole
+// ZoomMotion::Update with the cursor moving, against a backend that drops it.
+
+#include "Bench.h"
+#include "zoom/MagnifierBackend.h"
+#include "zoom/ScreenGeometry.h"
+#include "zoom/ZoomMotion.h"
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace VirtualOverlay;
+
+namespace {
+
+class NullMagnifierBackend : public MagnifierBackend {
+public:
+    bool SetFullscreenTransform(const MagnifierTransform& transform) override {
+        Bench::KeepAlive(transform.offsetX);
+        return true;
+    }
+    bool ResetMagnification() override { return true; }
+    bool IsInitialized() const override { return true; }
+};
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Bench::Options options = Bench::ParseOptions(argc, argv);
+
+    const std::vector<std::pair<std::string, std::vector<ZoomRect>>> layouts = {
+        { "1 monitor", { { 0, 0, 1920, 1080 } } },
+        { "3 monitors", { { 0, 0, 2560, 1440 }, { -1920, -200, 0, 880 }, { 2560, 0, 4480, 1080 } } },
+    };
+
+    const int calls = 1024;
+    for (const auto& layout : layouts) {
+        ScreenGeometry geometry = MakeScreenGeometry(layout.second, 1);
+        const ZoomRect& screen = geometry.virtualScreen;
+        Bench::Run(options, "transform " + layout.first, calls, "transform", [&] {
+            for (int i = 0; i < calls; i++) {
+                float level = 1.0f + static_cast<float>(i % 77) * 0.25f;
+                int x = screen.left + (i * 37) % screen.GetWidth();
+                int y = screen.top + (i * 53) % screen.GetHeight();
+                Bench::KeepAlive(ComputeMagnifierTransform(level, x, y, geometry).offsetX);
+            }
+        });
+    }
+
+    ZoomMotion motion;
+    NullMagnifierBackend backend;
+    motion.SetBackend(&backend);
+    motion.SetGeometry(MakeScreenGeometry(layouts[1].second, 1));
+    motion.ZoomToLevel(4.0f, -960, 340);
+    int frame = 0;
+    Bench::Run(options, "ZoomMotion frame, 3 monitors", 1, "frame", [&] {
+        frame++;
+        motion.OnCursorMove(-1800 + (frame * 7) % 4000, -100 + (frame * 3) % 1400);
+        motion.Update(16.0f);
+    });
+    return 0;
+}
@@ -0,0 +1,131 @@
+// Fuzz target for the VirtualDesktops registry value parsers.
+//
+// The whole input is parsed as each value type; it is also split in two
+// and the halves diffed as old/new VirtualDesktopIDs snapshots. Every
+// result is checked against a straightforward reimplementation.
+
+#include "Fuzz.h"
+#include "desktop/DesktopBlob.h"
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+using namespace VirtualOverlay;
+
+namespace {
+
+void CheckIdList(const uint8_t* data, size_t size, DesktopIdListView& view) {
+    BlobStatus status = DesktopIdListView::Parse(data, size, view);
+    if (size == 0) {
+        FUZZ_CHECK(status == BlobStatus::Empty);
+    } else if (size % DesktopGuid::SIZE != 0) {
+        FUZZ_CHECK(status == BlobStatus::BadSize);
+    } else if (size / DesktopGuid::SIZE > DesktopIdListView::MAX_DESKTOPS) {
+        FUZZ_CHECK(status == BlobStatus::TooLarge);
+    } else {
+        FUZZ_CHECK(status == BlobStatus::Ok);
+    }
+    if (status != BlobStatus::Ok) {
+        FUZZ_CHECK(view.IsEmpty());
+        return;
+    }
+
+    FUZZ_CHECK(view.GetCount() == size / DesktopGuid::SIZE);
+    FUZZ_CHECK(view.GetSizeBytes() == size);
+    for (size_t i = 0; i < view.GetCount(); i++) {
+        DesktopGuid id = view.At(i);
+        FUZZ_CHECK(std::memcmp(id.bytes, data + i * DesktopGuid::SIZE, DesktopGuid::SIZE) == 0);
+        FUZZ_CHECK(view.Matches(i, id));
+
+        // Find returns the first occurrence
+        int found = view.Find(id);
+        FUZZ_CHECK(found >= 1 && static_cast<size_t>(found) <= i + 1);
+        FUZZ_CHECK(view.At(static_cast<size_t>(found - 1)) == id);
+    }
+}
+
+void CheckName(const uint8_t* data, size_t size) {
+    DesktopNameView name;
+    BlobStatus status = DesktopNameView::Parse(data, size, name);
+    if (size == 0) {
+        FUZZ_CHECK(status == BlobStatus::Empty);
+        return;
+    }
+    if (size % 2 != 0) {
+        FUZZ_CHECK(status == BlobStatus::BadSize);
+        return;
+    }
+
+    size_t length = 0;
+    while (length < size / 2 && (data[length * 2] != 0 || data[length * 2 + 1] != 0)) {
+        length++;
+    }
+    if (length > DesktopNameView::MAX_LENGTH) {
+        FUZZ_CHECK(status == BlobStatus::TooLarge);
+        return;
+    }
+    FUZZ_CHECK(status == BlobStatus::Ok);
+    FUZZ_CHECK(name.GetLength() == length);
+
+    std::wstring decoded;
+    name.AssignTo(decoded);
+    FUZZ_CHECK(decoded.size() == length);
+    for (size_t i = 0; i < length; i++) {
+        FUZZ_CHECK(static_cast<uint16_t>(decoded[i]) == (data[i * 2] | (data[i * 2 + 1] << 8)));
+    }
+    FUZZ_CHECK(name.Equals(decoded));
+    if (!decoded.empty()) {
+        decoded.back() = static_cast<wchar_t>(decoded.back() ^ 1);
+        FUZZ_CHECK(!name.Equals(decoded));
+    }
+}
+
+void CheckDiff(const DesktopIdListView& a, const DesktopIdListView& b) {
+    DesktopIdListDiff diff = DiffDesktopIdLists(a, b);
+    FUZZ_CHECK(diff.oldCount == a.GetCount());
+    FUZZ_CHECK(diff.newCount == b.GetCount());
+
+    size_t common = std::min(a.GetCount(), b.GetCount());
+    size_t changed = 0;
+    size_t first = common;
+    for (size_t i = 0; i < common; i++) {
+        if (a.At(i) != b.At(i)) {
+            first = std::min(first, i);
+            changed++;
+        }
+    }
+    FUZZ_CHECK(diff.changedPositions == changed);
+    FUZZ_CHECK(diff.firstDifference == first);
+    bool identical = a.GetCount() == b.GetCount() &&
+                     (common == 0 || std::memcmp(a.GetData(), b.GetData(), a.GetSizeBytes()) == 0);
+    FUZZ_CHECK(diff.identical == identical);
+}
+
+}  // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    DesktopIdListView whole;
+    CheckIdList(data, size, whole);
+
+    DesktopGuid current;
+    BlobStatus status = ParseCurrentDesktopId(data, size, current);
+    FUZZ_CHECK((status == BlobStatus::Ok) == (size == DesktopGuid::SIZE));
+    if (status == BlobStatus::Ok) {
+        FUZZ_CHECK(std::memcmp(current.bytes, data, DesktopGuid::SIZE) == 0);
+    }
+
+    CheckName(data, size);
+
+    // Split on a GUID boundary chosen by the first byte, so the halves are
+    // often valid lists that share a prefix
+    size_t split = size > 0 ? (data[0] % (size / DesktopGuid::SIZE + 1)) * DesktopGuid::SIZE : 0;
+    split = std::min(split, size);
+    DesktopIdListView oldList;
+    DesktopIdListView newList;
+    CheckIdList(data, split, oldList);
+    CheckIdList(data + split, size - split, newList);
+    CheckDiff(oldList, newList);
+    CheckDiff(newList, newList);
+    CheckDiff(whole, oldList);
+    return 0;
+}
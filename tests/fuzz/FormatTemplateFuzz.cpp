@@ -0,0 +1,81 @@
+// Fuzz target for the overlay format string compiler.
+//
+// The first bytes pick the field values; the rest is decoded into a format,
+// with high bytes standing for whole tokens ("{number:02}", "{?", "}}")
+// so inputs reach the parser's interesting paths quickly. Checked:
+//   - the same format renders the same through a reused output string;
+//   - output is bounded by the format length plus the longest field per
+//     brace;
+//   - any text with its braces doubled renders back to itself.
+
+#include "Fuzz.h"
+#include "overlay/FormatTemplate.h"
+#include <algorithm>
+#include <string>
+
+using namespace VirtualOverlay;
+
+namespace {
+
+const wchar_t* const TOKENS[] = {
+    L"{number}", L"{name}", L"{count}", L"{prev}", L"{next}", L"{monitor}",
+    L"{number:02}", L"{count:016}", L"{number:017}", L"{name:02}", L"{?", L"}",
+    L"{{", L"}}", L": ", L"{", L"{unknown}", L": {name}",
+};
+const size_t TOKEN_COUNT = sizeof(TOKENS) / sizeof(TOKENS[0]);
+
+std::wstring Decode(const uint8_t* data, size_t size) {
+    std::wstring format;
+    for (size_t i = 0; i < size; i++) {
+        if (data[i] < 0x80) {
+            format.push_back(static_cast<wchar_t>(data[i]));
+        } else if (data[i] < 0x80 + TOKEN_COUNT) {
+            format += TOKENS[data[i] - 0x80];
+        } else {
+            format.push_back(static_cast<wchar_t>(0x4E00 + data[i]));  // CJK
+        }
+    }
+    return format;
+}
+
+std::wstring Escape(const std::wstring& text) {
+    std::wstring escaped;
+    for (wchar_t c : text) {
+        escaped.push_back(c);
+        if (c == L'{' || c == L'}') {
+            escaped.push_back(c);
+        }
+    }
+    return escaped;
+}
+
+}  // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    if (size < 4) {
+        return 0;
+    }
+    static const wchar_t* const NAMES[] = { L"", L"Mail", L"{number}", L"桌面" };
+    FormatValues values;
+    values.number = static_cast<int8_t>(data[0]);
+    values.count = data[1] % 8;
+    values.monitor = data[2] % 4;
+    values.name = NAMES[data[3] % 4];
+    std::wstring format = Decode(data + 4, size - 4);
+
+    FormatTemplate compiled(format);
+    FUZZ_CHECK(compiled.GetSource() == format);
+    std::wstring fresh = compiled.Render(values);
+    std::wstring reused = L"stale contents";
+    compiled.Render(values, reused);
+    FUZZ_CHECK(fresh == reused);
+
+    // Every field expands one brace-delimited token
+    size_t braces = static_cast<size_t>(std::count(format.begin(), format.end(), L'{'));
+    size_t longestField = std::max<size_t>(values.name.size(), FormatTemplate::MAX_WIDTH + 1);
+    FUZZ_CHECK(fresh.size() <= format.size() + braces * longestField);
+
+    // Escaped text is literal, including anything that looks like a field
+    FUZZ_CHECK(FormatTemplate(Escape(format)).Render(values) == format);
+    return 0;
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+// Shared by the fuzz targets: a failed invariant aborts, which both
+// libFuzzer and FuzzMain.cpp report as a crash.
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+#define FUZZ_CHECK(condition)                                                   \
+    do {                                                                        \
+        if (!(condition)) {                                                     \
+            std::fprintf(stderr, "%s:%d: invariant failed: %s\n", __FILE__, __LINE__, #condition); \
+            std::abort();                                                       \
+        }                                                                       \
+    } while (0)
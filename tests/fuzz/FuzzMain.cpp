@@ -0,0 +1,120 @@
+// Stand-in for libFuzzer's main, so the fuzz targets build and run with any
+// compiler (configure with -DVO_LIBFUZZER=ON under Clang for the real thing).
+//
+//   Target [-runs=N] [-seed=S] [-max_len=L] [file...]
+//
+// Runs each file given, then N inputs made by mutating those files (or
+// random bytes if none). Deterministic for a given seed.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+namespace {
+
+bool ParseFlag(const char* arg, const char* name, unsigned long long& value) {
+    size_t length = std::strlen(name);
+    if (std::strncmp(arg, name, length) != 0) {
+        return false;
+    }
+    value = std::strtoull(arg + length, nullptr, 10);
+    return true;
+}
+
+void Mutate(std::vector<uint8_t>& input, size_t maxLength, std::mt19937_64& rng) {
+    int edits = 1 + static_cast<int>(rng() % 8);
+    for (int e = 0; e < edits; e++) {
+        size_t position = input.empty() ? 0 : rng() % input.size();
+        switch (rng() % 6) {
+            case 0:  // Flip a bit
+                if (!input.empty()) input[position] ^= static_cast<uint8_t>(1u << (rng() % 8));
+                break;
+            case 1:  // Random byte
+                if (!input.empty()) input[position] = static_cast<uint8_t>(rng());
+                break;
+            case 2:  // Insert bytes
+                if (input.size() < maxLength) {
+                    size_t count = std::min<size_t>(1 + rng() % 16, maxLength - input.size());
+                    for (size_t i = 0; i < count; i++) {
+                        input.insert(input.begin() + position, static_cast<uint8_t>(rng()));
+                    }
+                }
+                break;
+            case 3:  // Erase bytes
+                if (!input.empty()) {
+                    size_t count = std::min<size_t>(1 + rng() % 16, input.size() - position);
+                    input.erase(input.begin() + position, input.begin() + position + count);
+                }
+                break;
+            case 4:  // Interesting value
+                if (!input.empty()) {
+                    static const uint8_t VALUES[] = { 0x00, 0x01, 0x7F, 0x80, 0xFF, '{', '}', '?', ':' };
+                    input[position] = VALUES[rng() % sizeof(VALUES)];
+                }
+                break;
+            default:  // Duplicate a chunk
+                if (!input.empty() && input.size() < maxLength) {
+                    size_t count = std::min<size_t>({ 1 + rng() % 32, input.size() - position,
+                                                      maxLength - input.size() });
+                    std::vector<uint8_t> chunk(input.begin() + position, input.begin() + position + count);
+                    input.insert(input.begin() + rng() % (input.size() + 1), chunk.begin(), chunk.end());
+                }
+                break;
+        }
+    }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    unsigned long long runs = 10000;
+    unsigned long long seed = 1;
+    unsigned long long maxLength = 4096;
+    std::vector<std::vector<uint8_t>> corpus;
+
+    for (int i = 1; i < argc; i++) {
+        if (ParseFlag(argv[i], "-runs=", runs) || ParseFlag(argv[i], "-seed=", seed) ||
+            ParseFlag(argv[i], "-max_len=", maxLength)) {
+            continue;
+        }
+        std::ifstream file(argv[i], std::ios::binary);
+        if (!file) {
+            std::fprintf(stderr, "cannot read %s\n", argv[i]);
+            return 1;
+        }
+        corpus.emplace_back(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        LLVMFuzzerTestOneInput(corpus.back().data(), corpus.back().size());
+    }
+
+    std::mt19937_64 rng(seed);
+    std::vector<uint8_t> input;
+    for (unsigned long long run = 0; run < runs; run++) {
+        if (!corpus.empty() && rng() % 4 != 0) {
+            input = corpus[rng() % corpus.size()];
+        } else {
+            input.resize(rng() % (maxLength + 1));
+            for (uint8_t& byte : input) {
+                byte = static_cast<uint8_t>(rng());
+            }
+        }
+        Mutate(input, maxLength, rng);
+        LLVMFuzzerTestOneInput(input.data(), input.size());
+
+        // Keep interesting-looking inputs around as seeds
+        if (corpus.size() < 256 && rng() % 64 == 0) {
+            corpus.push_back(input);
+        }
+    }
+
+    std::printf("%llu runs, seed %llu: no failures\n", runs, seed);
+    return 0;
+}
@@ -0,0 +1,54 @@
+// Fuzz target for the zoom input trace decoder.
+//
+// The input is decoded as is and behind a valid magic and version, so
+// mutations reach the monitor and event parsers. Checked:
+//   - a rejected input leaves an empty trace;
+//   - an accepted one re-encodes, and decodes back to the same trace;
+//   - decoded positions and times stay in range (no overflow on the way).
+
+#include "Fuzz.h"
+#include "zoom/ZoomTrace.h"
+#include <cstring>
+#include <vector>
+
+using namespace VirtualOverlay;
+
+namespace {
+
+void Check(const uint8_t* data, size_t size) {
+    ZoomTrace trace;
+    if (!DecodeZoomTrace(data, size, trace)) {
+        FUZZ_CHECK(trace.events.empty() && trace.monitors.empty() && trace.frequency == 0);
+        return;
+    }
+    FUZZ_CHECK(trace.frequency > 0);
+    for (size_t i = 1; i < trace.events.size(); i++) {
+        FUZZ_CHECK(trace.events[i].time >= trace.events[i - 1].time);
+    }
+
+    std::vector<uint8_t> bytes;
+    FUZZ_CHECK(EncodeZoomTrace(trace, bytes));
+    FUZZ_CHECK(bytes.size() <= size);   // Canonical varints are never longer
+    ZoomTrace again;
+    FUZZ_CHECK(DecodeZoomTrace(bytes.data(), bytes.size(), again));
+    FUZZ_CHECK(again.frequency == trace.frequency);
+    FUZZ_CHECK(again.monitors == trace.monitors);
+    FUZZ_CHECK(again.events.size() == trace.events.size());
+    for (size_t i = 0; i < trace.events.size(); i++) {
+        const ZoomInputEvent& a = trace.events[i];
+        const ZoomInputEvent& b = again.events[i];
+        FUZZ_CHECK(a.time == b.time && a.kind == b.kind && a.x == b.x && a.y == b.y);
+        FUZZ_CHECK(std::memcmp(&a.value, &b.value, sizeof(float)) == 0);
+    }
+}
+
+}  // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    Check(data, size);
+
+    std::vector<uint8_t> framed = { 'V', 'O', 'Z', 'T', 1 };
+    framed.insert(framed.end(), data, data + size);
+    Check(framed.data(), framed.size());
+    return 0;
+}
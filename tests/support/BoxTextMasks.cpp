@@ -0,0 +1,35 @@
+#include "BoxTextMasks.h"
+#include <algorithm>
+
+namespace VirtualOverlay {
+
+bool BoxTextMask(const std::wstring& text, int width, int height, std::vector<uint8_t>& coverage) {
+    coverage.assign(static_cast<size_t>(width) * height, 0);
+    if (text.empty()) {
+        return true;
+    }
+    // Narrower than a third of the line when the text would not fit
+    int advance = std::max(3, std::min(height / 3, width / static_cast<int>(text.size())));
+    int lineTop = height / 4;
+    int lineBottom = height - height / 4;
+    int x0 = (width - static_cast<int>(text.size()) * advance) / 2;
+
+    for (size_t i = 0; i < text.size(); i++) {
+        if (text[i] == L' ') {
+            continue;
+        }
+        // Ascenders for every other character code
+        int top = lineTop - ((text[i] % 2) ? height / 8 : 0);
+        int left = x0 + static_cast<int>(i) * advance + 1;
+        int right = left + advance - 2;
+        for (int y = std::max(0, top); y < std::min(height, lineBottom); y++) {
+            for (int x = std::max(0, left); x < std::min(width, right); x++) {
+                bool rim = y == top || y == lineBottom - 1 || x == left || x == right - 1;
+                coverage[static_cast<size_t>(y) * width + x] = rim ? 128 : 255;
+            }
+        }
+    }
+    return true;
+}
+
+}  // namespace VirtualOverlay
@@ -0,0 +1,16 @@
+#pragma once
+
+// Deterministic stand-in for DirectWrite text coverage: every character is
+// a box (spaces are gaps) whose height depends on the character, with a
+// half-covered rim so blending of partial coverage is exercised. Matches
+// TextMaskProvider, so it plugs into SoftwareRenderBackend.
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace VirtualOverlay {
+
+bool BoxTextMask(const std::wstring& text, int width, int height, std::vector<uint8_t>& coverage);
+
+}  // namespace VirtualOverlay
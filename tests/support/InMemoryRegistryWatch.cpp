@@ -0,0 +1,36 @@
+#include "InMemoryRegistryWatch.h"
+
+namespace VirtualOverlay {
+
+bool InMemoryRegistryWatch::Arm() {
+    m_armCount++;
+    m_armed = !m_armFails;
+    return m_armed;
+}
+
+bool InMemoryRegistryWatch::SetValue(const std::wstring& name, const std::vector<uint8_t>& data) {
+    m_values[name] = data;
+    if (!m_armed) {
+        return false;
+    }
+    m_armed = false;
+    m_pendingNotifications++;
+    return true;
+}
+
+bool InMemoryRegistryWatch::GetValue(const std::wstring& name, std::vector<uint8_t>& data) const {
+    auto it = m_values.find(name);
+    if (it == m_values.end()) {
+        return false;
+    }
+    data = it->second;
+    return true;
+}
+
+uint32_t InMemoryRegistryWatch::TakePendingNotifications() {
+    uint32_t pending = m_pendingNotifications;
+    m_pendingNotifications = 0;
+    return pending;
+}
+
+}  // namespace VirtualOverlay
@@ -0,0 +1,42 @@
+#pragma once
+
+// In-memory IRegistryWatchBackend for driving DesktopChangeWatcher without a
+// registry. SetValue() behaves like Explorer writing a value: it updates the
+// store and, if armed, delivers a single notification (then disarms).
+
+#include "desktop/DesktopChangeWatcher.h"
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace VirtualOverlay {
+
+class InMemoryRegistryWatch : public IRegistryWatchBackend {
+public:
+    bool Arm() override;
+    void Disarm() override { m_armed = false; }
+    bool IsArmed() const override { return m_armed; }
+
+    // Make subsequent Arm() calls fail (simulates a missing key)
+    void SetArmFails(bool fails) { m_armFails = fails; }
+
+    // Write a value; returns true if a notification was delivered
+    bool SetValue(const std::wstring& name, const std::vector<uint8_t>& data);
+    bool GetValue(const std::wstring& name, std::vector<uint8_t>& data) const;
+
+    // Count of notifications delivered since construction; the owner drains
+    // this and forwards each one to DesktopChangeWatcher::OnNotify
+    uint32_t TakePendingNotifications();
+
+    uint32_t GetArmCount() const { return m_armCount; }
+
+private:
+    bool m_armed = false;
+    bool m_armFails = false;
+    uint32_t m_armCount = 0;
+    uint32_t m_pendingNotifications = 0;
+    std::map<std::wstring, std::vector<uint8_t>> m_values;
+};
+
+}  // namespace VirtualOverlay
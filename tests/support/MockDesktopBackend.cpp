@@ -0,0 +1,56 @@
+#include "MockDesktopBackend.h"
+
+namespace VirtualOverlay {
+
+bool MockDesktopBackend::GetCount(int& count) {
+    m_calls.getCount++;
+    if (m_failing) {
+        return false;
+    }
+    count = static_cast<int>(m_desktops.size());
+    return true;
+}
+
+bool MockDesktopBackend::GetCurrent(DesktopRecord& desktop) {
+    m_calls.getCurrent++;
+    if (m_failing || m_current < 1 || m_current > static_cast<int>(m_desktops.size())) {
+        return false;
+    }
+    desktop = m_desktops[m_current - 1];
+    if (!m_supportsNames) {
+        desktop.name.clear();
+    }
+    return true;
+}
+
+bool MockDesktopBackend::GetAt(int index, DesktopRecord& desktop) {
+    m_calls.getAt++;
+    if (m_failing || index < 1 || index > static_cast<int>(m_desktops.size())) {
+        return false;
+    }
+    desktop = m_desktops[index - 1];
+    if (!m_supportsNames) {
+        desktop.name.clear();
+    }
+    return true;
+}
+
+bool MockDesktopBackend::Enumerate(std::vector<DesktopRecord>& desktops, bool withNames) {
+    m_calls.enumerate++;
+    desktops.clear();
+    if (m_failing) {
+        return false;
+    }
+    desktops.reserve(m_desktops.size());
+    for (const DesktopRecord& record : m_desktops) {
+        DesktopRecord copy;
+        copy.id = record.id;
+        if (withNames && m_supportsNames) {
+            copy.name = record.name;
+        }
+        desktops.push_back(std::move(copy));
+    }
+    return true;
+}
+
+}  // namespace VirtualOverlay
@@ -0,0 +1,45 @@
+#pragma once
+
+// Scripted IDesktopBackend. Serves a fixed desktop list and counts calls,
+// so tests can check how much shell traffic a code path generates.
+
+#include "desktop/DesktopBackend.h"
+#include <cstdint>
+#include <vector>
+
+namespace VirtualOverlay {
+
+class MockDesktopBackend : public IDesktopBackend {
+public:
+    struct CallCounts {
+        uint32_t getCount = 0;
+        uint32_t getCurrent = 0;
+        uint32_t getAt = 0;
+        uint32_t enumerate = 0;
+    };
+
+    void SetDesktops(std::vector<DesktopRecord> desktops) { m_desktops = std::move(desktops); }
+    void SetCurrent(int index) { m_current = index; }
+    void SetFailing(bool failing) { m_failing = failing; }
+    void SetSupportsNames(bool supports) { m_supportsNames = supports; }
+
+    const CallCounts& GetCallCounts() const { return m_calls; }
+    void ResetCallCounts() { m_calls = CallCounts(); }
+
+    const char* GetName() const override { return "mock"; }
+    bool SupportsNames() const override { return m_supportsNames; }
+
+    bool GetCount(int& count) override;
+    bool GetCurrent(DesktopRecord& desktop) override;
+    bool GetAt(int index, DesktopRecord& desktop) override;
+    bool Enumerate(std::vector<DesktopRecord>& desktops, bool withNames) override;
+
+private:
+    std::vector<DesktopRecord> m_desktops;
+    int m_current = 1;
+    bool m_failing = false;
+    bool m_supportsNames = true;
+    CallCounts m_calls;
+};
+
+}  // namespace VirtualOverlay
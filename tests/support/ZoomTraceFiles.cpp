@@ -0,0 +1,17 @@
+#include "ZoomTraceFiles.h"
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+namespace VirtualOverlay {
+
+bool LoadZoomTrace(const std::string& path, ZoomTrace& trace) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    return DecodeZoomTrace(bytes.data(), bytes.size(), trace);
+}
+
+}  // namespace VirtualOverlay
@@ -0,0 +1,14 @@
+#pragma once
+
+// Loads the synthetic zoom input traces committed in tests/data/zoom
+// (written by tools/MakeZoomTraces.cpp).
+
+#include "zoom/ZoomTrace.h"
+#include <string>
+
+namespace VirtualOverlay {
+
+// False if the file is missing or does not decode
+bool LoadZoomTrace(const std::string& path, ZoomTrace& trace);
+
+}  // namespace VirtualOverlay
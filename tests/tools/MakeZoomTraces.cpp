@@ -0,0 +1,227 @@
+// Writes the synthetic zoom input traces in tests/data/zoom.
+//
+//   make-zoom-traces OUTPUT_DIR
+//
+// They stand in for recorded sessions: the figures quoted for the zoom
+// smoothing, the transform coalescer, the pan filter and cursor prediction
+// were measured on them, and ZoomReplayTest replays the committed files.
+// Tremor comes from std::normal_distribution, whose output differs between
+// standard libraries, so the committed files (not this program) are the
+// reference; rerun it only to change a trace on purpose.
+
+#include "zoom/ZoomTrace.h"
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace VirtualOverlay;
+
+namespace {
+
+// Appends events at a running QPC time
+class TraceBuilder {
+public:
+    TraceBuilder(int64_t frequency, std::vector<ZoomRect> monitors, int64_t startTime) : m_now(startTime) {
+        m_trace.frequency = frequency;
+        m_trace.monitors = std::move(monitors);
+    }
+
+    void Advance(double ms) {
+        m_now += static_cast<int64_t>(ms * static_cast<double>(m_trace.frequency) / 1000.0);
+    }
+
+    void Add(ZoomInputKind kind, int x = 0, int y = 0, float value = 0.0f) {
+        ZoomInputEvent event;
+        event.time = m_now;
+        event.kind = kind;
+        event.x = x;
+        event.y = y;
+        event.value = value;
+        m_trace.events.push_back(event);
+    }
+
+    const ZoomTrace& GetTrace() const { return m_trace; }
+
+private:
+    ZoomTrace m_trace;
+    int64_t m_now;
+};
+
+// Three monitors, one left of and above the primary. Modifier held, four
+// wheel notches in, 5 s of sweeping pans then 5 s held with 0.7 px tremor,
+// one notch out, then a double tap that resets.
+ZoomTrace MakeSessionTrace() {
+    TraceBuilder trace(10000000, { { 0, 0, 2560, 1440 }, { -1920, -200, 0, 880 }, { 2560, 0, 4480, 1080 } },
+                       123456789);
+    std::mt19937 rng(7);
+    std::normal_distribution<float> tremor(0.0f, 0.7f);
+
+    const int centerX = 1200;
+    const int centerY = 700;
+    trace.Add(ZoomInputKind::ModifierDown);
+    for (int i = 0; i < 4; i++) {
+        trace.Add(ZoomInputKind::Wheel, centerX, centerY, 1.0f);
+        trace.Advance(40);
+    }
+    for (int frame = 0; frame < 600; frame++) {
+        double dt = 16.0 + (frame % 7 == 0 ? 1.5 : 0.0);
+        trace.Advance(dt);
+        double seconds = frame / 60.0;
+        int sweep = frame < 300 ? 1 : 0;
+        int x = centerX + static_cast<int>(800 * std::sin(seconds * 1.3) * sweep) +
+                static_cast<int>(std::lround(tremor(rng)));
+        int y = centerY + static_cast<int>(300 * std::sin(seconds * 0.7) * sweep) +
+                static_cast<int>(std::lround(tremor(rng)));
+        trace.Add(ZoomInputKind::Cursor, x, y);
+        trace.Add(ZoomInputKind::Tick, 0, 0, static_cast<float>(dt));
+        if (frame == 450) {
+            trace.Add(ZoomInputKind::Wheel, x, y, -1.0f);
+        }
+    }
+    trace.Add(ZoomInputKind::ModifierUp);
+    trace.Advance(100);
+    trace.Add(ZoomInputKind::ModifierDown);
+    trace.Advance(50);
+    trace.Add(ZoomInputKind::ModifierUp);
+    trace.Advance(100);
+    trace.Add(ZoomInputKind::ModifierDown);
+    for (int frame = 0; frame < 120; frame++) {
+        trace.Advance(16);
+        trace.Add(ZoomInputKind::Tick, 0, 0, 16.0f);
+    }
+    return trace.GetTrace();
+}
+
+// Pinch to 3.7x on the negative-origin monitor, a one-second diagonal pan,
+// then 5 s held still: the view must settle on one exact transform however
+// the steps on the way were coalesced. Millisecond clock, no tremor.
+ZoomTrace MakePanHoldTrace() {
+    TraceBuilder trace(1000, { { 0, 0, 2560, 1440 }, { -1920, -200, 0, 880 }, { 2560, 0, 4480, 1080 } }, 0);
+    trace.Add(ZoomInputKind::Gesture, -700, 100, 3.7f);
+    for (int frame = 0; frame < 400; frame++) {
+        trace.Advance(16);
+        if (frame < 60) {
+            trace.Add(ZoomInputKind::Cursor, -700 + frame * 3, 100 + frame);
+        }
+        trace.Add(ZoomInputKind::Tick, 0, 0, 16.0f);
+    }
+    return trace.GetTrace();
+}
+
+// Pinch to `level` on the negative-origin monitor, then 15 s at 60 Hz with
+// 0.7 px tremor: held, a 900 px/s pan right at 5 s, held, a slower
+// diagonal pan at 8 s, held. The pan filter comparison replays these.
+ZoomTrace MakePanTrace(float level) {
+    TraceBuilder trace(10000000, { { 0, 0, 2560, 1440 }, { -1920, -200, 0, 880 } }, 0);
+    std::mt19937 rng(11);
+    std::normal_distribution<float> tremor(0.0f, 0.7f);
+
+    double x = -960.0;
+    double y = 340.0;
+    trace.Add(ZoomInputKind::Gesture, static_cast<int>(x), static_cast<int>(y), level);
+    for (int frame = 0; frame < 900; frame++) {
+        double dt = 16.0 + (frame % 7 == 0 ? 1.5 : 0.0);
+        trace.Advance(dt);
+        double seconds = frame / 60.0;
+        if (seconds >= 5.0 && seconds < 6.0) {
+            x += 900.0 * dt / 1000.0;
+        } else if (seconds >= 8.0 && seconds < 10.0) {
+            x -= 400.0 * dt / 1000.0;
+            y += 150.0 * dt / 1000.0;
+        }
+        trace.Add(ZoomInputKind::Cursor, static_cast<int>(std::lround(x + tremor(rng))),
+                  static_cast<int>(std::lround(y + tremor(rng))));
+        trace.Add(ZoomInputKind::Tick, 0, 0, static_cast<float>(dt));
+    }
+    return trace.GetTrace();
+}
+
+// A minute of pointing at 4x on a microsecond clock: minimum-jerk moves
+// of 250-950 ms between random points on both monitors, each followed by a
+// 100-700 ms pause, sampled on ticks of about 16 ms. No tremor, so a
+// pause is an exact stop. Cursor prediction is scored on it.
+ZoomTrace MakePointingTrace() {
+    TraceBuilder trace(1000000, { { 0, 0, 2560, 1440 }, { -1920, -200, 0, 880 } }, 0);
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    double x = 1280.0;
+    double y = 720.0;
+    double startX = x;
+    double startY = y;
+    double endX = x;
+    double endY = y;
+    double moveStart = 0.0;
+    double moveMs = 0.0;
+    double pauseEnd = 0.0;
+    double clock = 0.0;
+    trace.Add(ZoomInputKind::Gesture, static_cast<int>(x), static_cast<int>(y), 4.0f);
+    for (int frame = 0; frame < 3600; frame++) {
+        double dt = 16.0 + (frame % 3 == 0 ? 0.6 : -0.3) + unit(rng) * 0.4;
+        clock += dt;
+        trace.Advance(dt);
+        if (clock >= moveStart + moveMs && clock >= pauseEnd) {
+            if (moveMs > 0.0 && pauseEnd < moveStart + moveMs) {
+                pauseEnd = clock + 100.0 + unit(rng) * 600.0;
+            } else {
+                startX = x;
+                startY = y;
+                endX = -1800.0 + unit(rng) * 4300.0;
+                endY = -150.0 + unit(rng) * 1500.0;
+                moveStart = clock;
+                moveMs = 250.0 + unit(rng) * 700.0;
+            }
+        }
+        if (clock < moveStart + moveMs) {
+            double s = (clock - moveStart) / moveMs;
+            double m = s * s * s * (10.0 - 15.0 * s + 6.0 * s * s);
+            x = startX + (endX - startX) * m;
+            y = startY + (endY - startY) * m;
+        } else {
+            x = endX;
+            y = endY;
+        }
+        trace.Add(ZoomInputKind::Cursor, static_cast<int>(std::lround(x)), static_cast<int>(std::lround(y)));
+        trace.Add(ZoomInputKind::Tick, 0, 0, static_cast<float>(dt));
+    }
+    return trace.GetTrace();
+}
+
+bool WriteTrace(const std::string& path, const ZoomTrace& trace) {
+    std::vector<uint8_t> bytes;
+    if (!EncodeZoomTrace(trace, bytes)) {
+        std::fprintf(stderr, "%s: encoding failed\n", path.c_str());
+        return false;
+    }
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    if (!file.good()) {
+        std::fprintf(stderr, "%s: write failed\n", path.c_str());
+        return false;
+    }
+    std::printf("%s: %zu events, %.1f s, %zu bytes\n", path.c_str(), trace.events.size(),
+                trace.GetDurationSeconds(), bytes.size());
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        std::fprintf(stderr, "usage: %s OUTPUT_DIR\n", argv[0]);
+        return 2;
+    }
+    std::string dir = argv[1];
+
+    bool ok = WriteTrace(dir + "/session-3mon.vozt", MakeSessionTrace());
+    ok = WriteTrace(dir + "/zoom-pan-hold.vozt", MakePanHoldTrace()) && ok;
+    for (int level : { 2, 5, 10 }) {
+        std::string name = "/pan-" + std::to_string(level) + "x.vozt";
+        ok = WriteTrace(dir + name, MakePanTrace(static_cast<float>(level))) && ok;
+    }
+    ok = WriteTrace(dir + "/pointing-4x.vozt", MakePointingTrace()) && ok;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,191 @@
+// Replays a zoom input trace (zoom.traceFile) and prints what the user saw.
+//
+//   zoom-replay TRACE [options]
+//
+// Runs ReplayZoomTrace with the default zoom settings, or those given, and
+// with --prediction also scores the predictor with EvaluateCursorPrediction.
+// The same trace replayed with two settings compares them directly.
+
+#include "zoom/ZoomReplay.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace VirtualOverlay;
+
+namespace {
+
+const char USAGE[] =
+    "usage: zoom-replay TRACE [options]\n"
+    "  --smoothing F          level and pan smoothing factor, 0 = off (0.08)\n"
+    "  --pan-filter NAME      exponential | one-euro (exponential)\n"
+    "  --pan-min-cutoff HZ    one-euro cutoff at rest (1)\n"
+    "  --pan-beta B           one-euro Hz per on-screen px/s (0.005)\n"
+    "  --prediction NAME      off | kalman | least-squares (off)\n"
+    "  --lead-ms MS           prediction lead (16)\n"
+    "  --threshold-px PX      coalescer threshold, 0 = any change (1)\n"
+    "  --refresh-hz HZ        coalescer rate limit, 0 = none (60)\n"
+    "  --events               list the trace's events\n";
+
+bool ReadFile(const char* path, std::vector<uint8_t>& bytes) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return !file.bad();
+}
+
+bool ParseFloat(const char* text, float& value) {
+    char* end = nullptr;
+    value = std::strtof(text, &end);
+    return end != text && *end == '\0';
+}
+
+bool ParsePanFilter(const char* text, ZoomPanFilter& filter) {
+    for (ZoomPanFilter candidate : { ZoomPanFilter::Exponential, ZoomPanFilter::OneEuro }) {
+        if (std::strcmp(text, ZoomPanFilterToString(candidate)) == 0) {
+            filter = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ParsePredictionMode(const char* text, CursorPredictionMode& mode) {
+    for (CursorPredictionMode candidate :
+         { CursorPredictionMode::Off, CursorPredictionMode::Kalman, CursorPredictionMode::LeastSquares }) {
+        if (std::strcmp(text, CursorPredictionModeToString(candidate)) == 0) {
+            mode = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+void PrintEvents(const ZoomTrace& trace) {
+    int64_t start = trace.events.empty() ? 0 : trace.events.front().time;
+    for (const ZoomInputEvent& event : trace.events) {
+        std::printf("%10.3f ms  %-13s", trace.ToMilliseconds(event.time - start), ZoomInputKindToString(event.kind));
+        if (event.kind == ZoomInputKind::Wheel || event.kind == ZoomInputKind::Gesture ||
+            event.kind == ZoomInputKind::Cursor) {
+            std::printf("  %6d,%6d", event.x, event.y);
+        }
+        if (event.kind == ZoomInputKind::Tick || event.kind == ZoomInputKind::Wheel ||
+            event.kind == ZoomInputKind::Gesture) {
+            std::printf("  %g", event.value);
+        }
+        std::printf("\n");
+    }
+}
+
+void PrintReplay(const ZoomReplayReport& report) {
+    std::printf("replay: %llu events, %llu ticks, %.2f s\n",
+                static_cast<unsigned long long>(report.events),
+                static_cast<unsigned long long>(report.ticks), report.durationSec);
+    std::printf("  magnifier calls   %llu set (%llu changed), %llu reset, %llu suppressed, %.1f/s\n",
+                static_cast<unsigned long long>(report.setCalls),
+                static_cast<unsigned long long>(report.changedCalls),
+                static_cast<unsigned long long>(report.resetCalls),
+                static_cast<unsigned long long>(report.suppressedCalls), report.callsPerSecond);
+    std::printf("  level settle      %u, mean %.0f ms, max %.0f ms, overshoot %.4f\n",
+                report.levelSettles, report.levelSettleMeanMs, report.levelSettleMaxMs, report.levelOvershoot);
+    std::printf("  pan settle        %u, mean %.0f ms, max %.0f ms, overshoot %.2f px\n",
+                report.panSettles, report.panSettleMeanMs, report.panSettleMaxMs, report.panOvershootPx);
+    std::printf("  pan on screen     lag mean %.1f px, max %.1f px, jitter %.2f px RMS\n",
+                report.panLagMeanPx, report.panLagMaxPx, report.panJitterPx);
+}
+
+void PrintPrediction(const CursorPredictionReport& report) {
+    std::printf("prediction: %llu of %llu samples\n",
+                static_cast<unsigned long long>(report.predictions),
+                static_cast<unsigned long long>(report.samples));
+    std::printf("  error             mean %.2f px, RMS %.2f px, max %.1f px\n",
+                report.errorMeanPx, report.errorRmsPx, report.errorMaxPx);
+    std::printf("  no prediction     mean %.2f px, RMS %.2f px\n", report.baselineMeanPx, report.baselineRmsPx);
+    std::printf("  at stops          max %.2f px\n", report.stopErrorMaxPx);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const char* path = nullptr;
+    ZoomMotionConfig config;
+    bool listEvents = false;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        bool ok = true;
+        if (std::strcmp(arg, "--events") == 0) {
+            listEvents = true;
+            continue;
+        } else if (arg[0] != '-' && !path) {
+            path = arg;
+            continue;
+        } else if (!value) {
+            ok = false;
+        } else if (std::strcmp(arg, "--smoothing") == 0) {
+            ok = ParseFloat(value, config.smoothingFactor);
+            config.smoothing = config.smoothingFactor > 0.0f;
+        } else if (std::strcmp(arg, "--pan-filter") == 0) {
+            ok = ParsePanFilter(value, config.panFilter);
+        } else if (std::strcmp(arg, "--pan-min-cutoff") == 0) {
+            ok = ParseFloat(value, config.panMinCutoffHz);
+        } else if (std::strcmp(arg, "--pan-beta") == 0) {
+            ok = ParseFloat(value, config.panBeta);
+        } else if (std::strcmp(arg, "--prediction") == 0) {
+            ok = ParsePredictionMode(value, config.prediction.mode);
+        } else if (std::strcmp(arg, "--lead-ms") == 0) {
+            ok = ParseFloat(value, config.prediction.leadMs);
+        } else if (std::strcmp(arg, "--threshold-px") == 0) {
+            ok = ParseFloat(value, config.coalescing.thresholdPx);
+        } else if (std::strcmp(arg, "--refresh-hz") == 0) {
+            ok = ParseFloat(value, config.coalescing.refreshHz);
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            std::fprintf(stderr, "bad argument: %s\n%s", arg, USAGE);
+            return 2;
+        }
+        i++;
+    }
+    if (!path) {
+        std::fprintf(stderr, "%s", USAGE);
+        return 2;
+    }
+
+    std::vector<uint8_t> bytes;
+    if (!ReadFile(path, bytes)) {
+        std::fprintf(stderr, "%s: cannot read\n", path);
+        return 1;
+    }
+    ZoomTrace trace;
+    if (!DecodeZoomTrace(bytes.data(), bytes.size(), trace)) {
+        std::fprintf(stderr, "%s: not a valid zoom trace\n", path);
+        return 1;
+    }
+
+    std::printf("%s: %zu events, %.2f s, %zu bytes, %lld ticks/s\n", path, trace.events.size(),
+                trace.GetDurationSeconds(), bytes.size(), static_cast<long long>(trace.frequency));
+    for (size_t i = 0; i < trace.monitors.size(); i++) {
+        const ZoomRect& rect = trace.monitors[i];
+        std::printf("  monitor %zu: %d,%d %dx%d%s\n", i, rect.left, rect.top, rect.GetWidth(), rect.GetHeight(),
+                    i == 0 ? " (primary)" : "");
+    }
+    if (listEvents) {
+        PrintEvents(trace);
+    }
+
+    RecordingMagnifierBackend backend;
+    PrintReplay(ReplayZoomTrace(trace, config, backend));
+    if (config.prediction.mode != CursorPredictionMode::Off) {
+        PrintPrediction(EvaluateCursorPrediction(trace, config.prediction));
+    }
+    return 0;
+}
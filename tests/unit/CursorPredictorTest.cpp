@@ -0,0 +1,298 @@
+#include "Test.h"
+#include "ZoomTraceFiles.h"
+#include "zoom/CursorPredictor.h"
+#include "zoom/ZoomReplay.h"
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace VirtualOverlay;
+
+namespace {
+
+const std::string POINTING_TRACE = std::string(VO_TEST_DATA_DIR) + "/zoom/pointing-4x.vozt";
+
+CursorPredictorConfig MakeConfig(CursorPredictionMode mode, float leadMs = 16.0f, uint32_t historySamples = 3) {
+    CursorPredictorConfig config;
+    config.mode = mode;
+    config.leadMs = leadMs;
+    config.historySamples = historySamples;
+    return config;
+}
+
+// Cursor moving right at 10 px per 16 ms tick, starting at 100,200
+void MoveRight(CursorPredictor& predictor, int samples) {
+    for (int i = 0; i < samples; i++) {
+        predictor.AddSample(16.0 * i, 100.0f + 10.0f * i, 200.0f);
+    }
+}
+
+struct TraceSample {
+    double timeMs = 0.0;
+    float x = 0.0f;
+    float y = 0.0f;
+};
+
+// Cursor samples timed the way EvaluateCursorPrediction times them: each
+// takes the time of the tick that follows it
+std::vector<TraceSample> GetCursorSamples(const ZoomTrace& trace) {
+    std::vector<TraceSample> samples;
+    TraceSample cursor;
+    bool pending = false;
+    double timeMs = 0.0;
+    for (const ZoomInputEvent& event : trace.events) {
+        if (event.kind == ZoomInputKind::Cursor) {
+            cursor.x = static_cast<float>(event.x);
+            cursor.y = static_cast<float>(event.y);
+            pending = true;
+        } else if (event.kind == ZoomInputKind::Tick) {
+            timeMs += event.value;
+            if (pending) {
+                cursor.timeMs = timeMs;
+                samples.push_back(cursor);
+                pending = false;
+            }
+        }
+    }
+    return samples;
+}
+
+void Print(const char* name, const CursorPredictionReport& report) {
+    std::printf("  %-24s RMS %6.2f px (no prediction %6.2f px), at stops max %5.2f px\n", name,
+                report.errorRmsPx, report.baselineRmsPx, report.stopErrorMaxPx);
+}
+
+}  // namespace
+
+TEST(NoSamplesNoPrediction) {
+    CursorPredictor predictor;
+    predictor.SetConfig(MakeConfig(CursorPredictionMode::Kalman));
+    float x = 0.0f;
+    float y = 0.0f;
+    CHECK(!predictor.HasSample());
+    CHECK(!predictor.Predict(x, y));
+
+    predictor.AddSample(0.0, 5.0f, 6.0f);
+    REQUIRE(predictor.Predict(x, y));
+    CHECK_EQ(x, 5.0f);
+    CHECK_EQ(y, 6.0f);
+}
+
+TEST(OffPredictsTheNewestSample) {
+    CursorPredictor predictor;
+    MoveRight(predictor, 10);
+    float x = 0.0f;
+    float y = 0.0f;
+    REQUIRE(predictor.Predict(x, y));
+    CHECK_EQ(x, 190.0f);
+    CHECK_EQ(y, 200.0f);
+}
+
+TEST(ConstantVelocityIsExtrapolated) {
+    // One lead of 16 ms at 10 px per 16 ms: one step ahead
+    CursorPredictor leastSquares;
+    leastSquares.SetConfig(MakeConfig(CursorPredictionMode::LeastSquares));
+    MoveRight(leastSquares, 10);
+    float x = 0.0f;
+    float y = 0.0f;
+    REQUIRE(leastSquares.Predict(x, y));
+    CHECK_NEAR(x, 200.0f, 0.01f);
+    CHECK_EQ(y, 200.0f);
+
+    float vx = 0.0f;
+    float vy = 0.0f;
+    leastSquares.GetVelocity(vx, vy);
+    CHECK_NEAR(vx, 625.0f, 0.1f);
+    CHECK_EQ(vy, 0.0f);
+
+    // The Kalman velocity converges on it within a few samples
+    CursorPredictor kalman;
+    kalman.SetConfig(MakeConfig(CursorPredictionMode::Kalman));
+    MoveRight(kalman, 10);
+    REQUIRE(kalman.Predict(x, y));
+    CHECK_NEAR(x, 200.0f, 0.5f);
+    CHECK_NEAR(y, 200.0f, 0.01f);
+}
+
+TEST(StopPutsThePredictionBackOnTheCursor) {
+    for (CursorPredictionMode mode : { CursorPredictionMode::Kalman, CursorPredictionMode::LeastSquares }) {
+        CursorPredictor predictor;
+        predictor.SetConfig(MakeConfig(mode, 33.0f));
+        MoveRight(predictor, 10);
+
+        // Still moving: the prediction leads the cursor
+        float x = 0.0f;
+        float y = 0.0f;
+        REQUIRE(predictor.Predict(x, y));
+        CHECK(x > 190.0f);
+
+        // Stopped for one sample: the velocity still points right, but the
+        // last step is zero, so the prediction is the cursor itself
+        predictor.AddSample(160.0, 190.0f, 200.0f);
+        REQUIRE(predictor.Predict(x, y));
+        CHECK_EQ(x, 190.0f);
+        CHECK_EQ(y, 200.0f);
+
+        for (int i = 1; i < 10; i++) {
+            predictor.AddSample(160.0 + 16.0 * i, 190.0f, 200.0f);
+            REQUIRE(predictor.Predict(x, y));
+            CHECK_EQ(x, 190.0f);
+            CHECK_EQ(y, 200.0f);
+        }
+    }
+}
+
+TEST(TurningBackIsNotPredictedPastTheCursor) {
+    for (CursorPredictionMode mode : { CursorPredictionMode::Kalman, CursorPredictionMode::LeastSquares }) {
+        CursorPredictor predictor;
+        predictor.SetConfig(MakeConfig(mode, 16.0f, 8));
+        MoveRight(predictor, 10);
+
+        // One step back: the prediction may follow it, never the old motion
+        predictor.AddSample(160.0, 185.0f, 200.0f);
+        float x = 0.0f;
+        float y = 0.0f;
+        REQUIRE(predictor.Predict(x, y));
+        CHECK(x <= 185.0f);
+        CHECK_EQ(y, 200.0f);
+
+        // A fit over eight samples still points right: no lead at all
+        if (mode == CursorPredictionMode::LeastSquares) {
+            float vx = 0.0f;
+            float vy = 0.0f;
+            predictor.GetVelocity(vx, vy);
+            CHECK(vx > 0.0f);
+            CHECK_EQ(x, 185.0f);
+        }
+    }
+}
+
+TEST(LeadIsClampedToTheLastStep) {
+    // Fast, then a 1 px step: the lead is at most that step's speed times
+    // the lead time, however fast the filter still thinks the cursor is
+    for (CursorPredictionMode mode : { CursorPredictionMode::Kalman, CursorPredictionMode::LeastSquares }) {
+        CursorPredictor predictor;
+        predictor.SetConfig(MakeConfig(mode, 32.0f, 8));
+        for (int i = 0; i < 10; i++) {
+            predictor.AddSample(16.0 * i, 40.0f * i, 0.0f);
+        }
+        predictor.AddSample(160.0, 361.0f, 0.0f);
+
+        float x = 0.0f;
+        float y = 0.0f;
+        REQUIRE(predictor.Predict(x, y));
+        CHECK(x > 361.0f);
+        CHECK(x <= 361.0f + 2.0f + 0.001f);
+        CHECK_EQ(y, 0.0f);
+    }
+}
+
+TEST(GapStartsOver) {
+    CursorPredictor predictor;
+    predictor.SetConfig(MakeConfig(CursorPredictionMode::LeastSquares));
+    MoveRight(predictor, 10);
+
+    // Out of order samples are ignored
+    predictor.AddSample(100.0, 0.0f, 0.0f);
+    float x = 0.0f;
+    float y = 0.0f;
+    REQUIRE(predictor.Predict(x, y));
+    CHECK_NEAR(x, 200.0f, 0.01f);
+
+    predictor.AddSample(144.0 + CursorPredictor::MAX_SAMPLE_GAP_MS + 1.0, 500.0f, 500.0f);
+    REQUIRE(predictor.Predict(x, y));
+    CHECK_EQ(x, 500.0f);
+    CHECK_EQ(y, 500.0f);
+    float vx = 1.0f;
+    float vy = 1.0f;
+    predictor.GetVelocity(vx, vy);
+    CHECK_EQ(vx, 0.0f);
+    CHECK_EQ(vy, 0.0f);
+}
+
+TEST(PointingTraceError) {
+    // RMS distance from each prediction to where the cursor was one lead
+    // later, on a minute of pointing at 4x: prediction cuts it to about a
+    // seventh at 16 ms and a fifth at 33 ms
+    ZoomTrace trace;
+    REQUIRE(LoadZoomTrace(POINTING_TRACE, trace));
+
+    CursorPredictionReport off = EvaluateCursorPrediction(trace, MakeConfig(CursorPredictionMode::Off));
+    CursorPredictionReport kalman = EvaluateCursorPrediction(trace, MakeConfig(CursorPredictionMode::Kalman));
+    CursorPredictionReport twoSamples =
+        EvaluateCursorPrediction(trace, MakeConfig(CursorPredictionMode::LeastSquares, 16.0f, 2));
+    CursorPredictionReport threeSamples =
+        EvaluateCursorPrediction(trace, MakeConfig(CursorPredictionMode::LeastSquares));
+    Print("off", off);
+    Print("kalman", kalman);
+    Print("least squares, 2", twoSamples);
+    Print("least squares, 3", threeSamples);
+
+    CHECK_EQ(off.samples, 3600u);
+    CHECK_EQ(off.predictions, 3598u);
+    CHECK_EQ(off.errorRmsPx, off.baselineRmsPx);
+    CHECK_EQ(off.stopErrorMaxPx, 0.0);
+    CHECK_NEAR(off.errorRmsPx, 53.11, 0.005);
+    CHECK_NEAR(kalman.errorRmsPx, 6.95, 0.005);
+    CHECK_NEAR(twoSamples.errorRmsPx, 6.80, 0.005);
+    CHECK_NEAR(threeSamples.errorRmsPx, 8.57, 0.005);
+
+    // Twice the lead, twice the lag to make up for
+    CursorPredictionReport offLong = EvaluateCursorPrediction(trace, MakeConfig(CursorPredictionMode::Off, 33.0f));
+    CursorPredictionReport kalmanLong =
+        EvaluateCursorPrediction(trace, MakeConfig(CursorPredictionMode::Kalman, 33.0f));
+    Print("off, 33 ms", offLong);
+    Print("kalman, 33 ms", kalmanLong);
+    CHECK_NEAR(offLong.errorRmsPx, 109.31, 0.005);
+    CHECK_NEAR(kalmanLong.errorRmsPx, 21.33, 0.005);
+}
+
+TEST(NoOvershootAtStops) {
+    // Every pause in the pointing trace is an exact stop. Whichever mode,
+    // the first stopped sample is predicted no further ahead than the last
+    // step carries the cursor in the lead time, and every later one is the
+    // cursor itself.
+    ZoomTrace trace;
+    REQUIRE(LoadZoomTrace(POINTING_TRACE, trace));
+    std::vector<TraceSample> samples = GetCursorSamples(trace);
+    REQUIRE(samples.size() == 3600u);
+
+    for (CursorPredictionMode mode : { CursorPredictionMode::Kalman, CursorPredictionMode::LeastSquares }) {
+        for (float leadMs : { 16.0f, 33.0f }) {
+            CursorPredictor predictor;
+            predictor.SetConfig(MakeConfig(mode, leadMs));
+            uint32_t stops = 0;
+            for (size_t i = 0; i < samples.size(); i++) {
+                const TraceSample& sample = samples[i];
+                predictor.AddSample(sample.timeMs, sample.x, sample.y);
+                float x = 0.0f;
+                float y = 0.0f;
+                REQUIRE(predictor.Predict(x, y));
+                if (i < 2) {
+                    continue;
+                }
+
+                const TraceSample& previous = samples[i - 1];
+                const TraceSample& before = samples[i - 2];
+                bool stopped = sample.x == previous.x && sample.y == previous.y;
+                if (stopped && (previous.x != before.x || previous.y != before.y)) {
+                    stops++;
+                }
+                if (stopped) {
+                    CHECK_EQ(x, sample.x);
+                    CHECK_EQ(y, sample.y);
+                } else {
+                    double step = std::hypot(sample.x - previous.x, sample.y - previous.y);
+                    double reach = step * leadMs / (sample.timeMs - previous.timeMs);
+                    CHECK(std::hypot(x - sample.x, y - sample.y) <= reach + 0.01);
+                }
+            }
+            CHECK(stops >= 30u);
+        }
+
+        // Error where the cursor stays put for the whole lead
+        CursorPredictionReport report = EvaluateCursorPrediction(trace, MakeConfig(mode));
+        CHECK(report.stopErrorMaxPx < 12.0);
+    }
+}
@@ -0,0 +1,125 @@
+#include "Test.h"
+#include "MockDesktopBackend.h"
+#include "desktop/DesktopCatalog.h"
+#include "desktop/DesktopTopology.h"
+
+using namespace VirtualOverlay;
+
+namespace {
+
+DesktopRecord MakeDesktop(uint8_t seed, const wchar_t* name) {
+    DesktopRecord record;
+    for (size_t i = 0; i < DesktopGuid::SIZE; i++) {
+        record.id.bytes[i] = static_cast<uint8_t>(seed + i * 7);
+    }
+    record.name = name;
+    return record;
+}
+
+// What VirtualDesktop::GetDesktopIndexByGUID does on a catalog miss
+bool RefreshFromBackend(IDesktopBackend& backend, DesktopCatalog& catalog,
+                        std::vector<DesktopTopologyEvent>& events) {
+    std::vector<DesktopGuid> ids;
+    if (!EnumerateDesktopIds(backend, ids)) {
+        return false;
+    }
+    DesktopCatalog previous = catalog;
+    if (catalog.UpdateFromIds(ids.data(), ids.size())) {
+        DiffDesktopTopology(previous, catalog, events);
+    }
+    return true;
+}
+
+}  // namespace
+
+TEST(EnumerateIdsIsOneCallWithoutNames) {
+    MockDesktopBackend backend;
+    backend.SetDesktops({ MakeDesktop(1, L"Mail"), MakeDesktop(2, L"Code"), MakeDesktop(3, L"") });
+
+    std::vector<DesktopGuid> ids;
+    REQUIRE(EnumerateDesktopIds(backend, ids));
+    CHECK_EQ(ids.size(), 3u);
+    CHECK(ids[1] == MakeDesktop(2, L"").id);
+
+    const MockDesktopBackend::CallCounts& calls = backend.GetCallCounts();
+    CHECK_EQ(calls.enumerate, 1u);
+    CHECK_EQ(calls.getAt + calls.getCount + calls.getCurrent, 0u);
+}
+
+TEST(EnumerateIdsFailureLeavesNoIds) {
+    MockDesktopBackend backend;
+    backend.SetDesktops({ MakeDesktop(1, L"") });
+    backend.SetFailing(true);
+
+    std::vector<DesktopGuid> ids = { MakeDesktop(9, L"").id };
+    CHECK(!EnumerateDesktopIds(backend, ids));
+    CHECK(ids.empty());
+}
+
+TEST(UnresolvedDesktopKeepsItsPosition) {
+    MockDesktopBackend backend;
+    backend.SetDesktops({ MakeDesktop(1, L""), DesktopRecord(), MakeDesktop(3, L"") });
+
+    std::vector<DesktopGuid> ids;
+    REQUIRE(EnumerateDesktopIds(backend, ids));
+    REQUIRE(ids.size() == 3u);
+    CHECK(ids[1].IsNull());
+    CHECK(ids[2] == MakeDesktop(3, L"").id);
+}
+
+TEST(BackendFeedsCatalogAndTopology) {
+    MockDesktopBackend backend;
+    backend.SetDesktops({ MakeDesktop(1, L""), MakeDesktop(2, L""), MakeDesktop(3, L"") });
+
+    DesktopCatalog catalog;
+    std::vector<DesktopTopologyEvent> events;
+    REQUIRE(RefreshFromBackend(backend, catalog, events));
+    CHECK_EQ(catalog.GetCount(), 3u);
+    CHECK_EQ(events.size(), 3u);  // All created
+
+    // Unchanged list: one enumeration, no rebuild, no events
+    events.clear();
+    uint64_t generation = catalog.GetGeneration();
+    REQUIRE(RefreshFromBackend(backend, catalog, events));
+    CHECK_EQ(catalog.GetGeneration(), generation);
+    CHECK(events.empty());
+
+    // Desktop 3 dragged to the front, desktop 2 removed
+    backend.SetDesktops({ MakeDesktop(3, L""), MakeDesktop(1, L"") });
+    events.clear();
+    REQUIRE(RefreshFromBackend(backend, catalog, events));
+    CHECK_EQ(catalog.IndexOf(MakeDesktop(3, L"").id), 1);
+    REQUIRE(events.size() == 3u);
+    CHECK(events[0].change == DesktopTopologyChange::Destroyed);
+    CHECK_EQ(events[0].oldIndex, 2);
+    CHECK(events[1].change == DesktopTopologyChange::Moved);
+    CHECK_EQ(events[1].oldIndex, 3);
+    CHECK_EQ(events[1].newIndex, 1);
+    CHECK(events[2].change == DesktopTopologyChange::Moved);
+    CHECK_EQ(events[2].newIndex, 2);
+
+    CHECK_EQ(backend.GetCallCounts().enumerate, 3u);
+}
+
+TEST(MockHonoursNameSupport) {
+    MockDesktopBackend backend;
+    backend.SetDesktops({ MakeDesktop(1, L"Mail"), MakeDesktop(2, L"Code") });
+    backend.SetCurrent(2);
+
+    DesktopRecord current;
+    REQUIRE(backend.GetCurrent(current));
+    CHECK_EQ(current.name, std::wstring(L"Code"));
+
+    backend.SetSupportsNames(false);
+    REQUIRE(backend.GetAt(1, current));
+    CHECK(current.name.empty());
+
+    std::vector<DesktopRecord> desktops;
+    backend.SetSupportsNames(true);
+    REQUIRE(backend.Enumerate(desktops, false));
+    CHECK(desktops[0].name.empty());
+    REQUIRE(backend.Enumerate(desktops, true));
+    CHECK_EQ(desktops[0].name, std::wstring(L"Mail"));
+
+    CHECK(!backend.GetAt(3, current));
+}
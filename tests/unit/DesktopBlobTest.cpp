@@ -0,0 +1,129 @@
+#include "Test.h"
+#include "desktop/DesktopBlob.h"
+#include <vector>
+
+using namespace VirtualOverlay;
+
+namespace {
+
+DesktopGuid MakeId(uint8_t seed) {
+    DesktopGuid id;
+    for (size_t i = 0; i < DesktopGuid::SIZE; i++) {
+        id.bytes[i] = static_cast<uint8_t>(seed * 31 + i);
+    }
+    return id;
+}
+
+std::vector<uint8_t> MakeBlob(std::initializer_list<uint8_t> seeds) {
+    std::vector<uint8_t> blob;
+    for (uint8_t seed : seeds) {
+        DesktopGuid id = MakeId(seed);
+        blob.insert(blob.end(), id.bytes, id.bytes + DesktopGuid::SIZE);
+    }
+    return blob;
+}
+
+std::vector<uint8_t> MakeName(const std::wstring& name, bool terminated) {
+    std::vector<uint8_t> value;
+    for (wchar_t c : name) {
+        value.push_back(static_cast<uint8_t>(c & 0xFF));
+        value.push_back(static_cast<uint8_t>((c >> 8) & 0xFF));
+    }
+    if (terminated) {
+        value.push_back(0);
+        value.push_back(0);
+    }
+    return value;
+}
+
+}  // namespace
+
+TEST(IdListRejectsMalformedSizes) {
+    DesktopIdListView view;
+    CHECK(DesktopIdListView::Parse(nullptr, 0, view) == BlobStatus::Empty);
+
+    std::vector<uint8_t> blob = MakeBlob({ 1, 2 });
+    CHECK(DesktopIdListView::Parse(blob.data(), blob.size() - 1, view) == BlobStatus::BadSize);
+    CHECK(view.IsEmpty());
+
+    std::vector<uint8_t> huge((DesktopIdListView::MAX_DESKTOPS + 1) * DesktopGuid::SIZE);
+    CHECK(DesktopIdListView::Parse(huge.data(), huge.size(), view) == BlobStatus::TooLarge);
+    CHECK(DesktopIdListView::Parse(huge.data(), huge.size() - DesktopGuid::SIZE, view) == BlobStatus::Ok);
+}
+
+TEST(IdListViewsUnalignedBuffers) {
+    std::vector<uint8_t> blob = MakeBlob({ 1, 2, 3 });
+    blob.insert(blob.begin(), 0xAA);  // Shift every GUID off alignment
+
+    DesktopIdListView view;
+    REQUIRE(DesktopIdListView::Parse(blob.data() + 1, blob.size() - 1, view) == BlobStatus::Ok);
+    CHECK_EQ(view.GetCount(), 3u);
+    CHECK(view.At(1) == MakeId(2));
+    CHECK(view.Matches(2, MakeId(3)));
+    CHECK_EQ(view.Find(MakeId(3)), 3);
+    CHECK_EQ(view.Find(MakeId(9)), 0);
+}
+
+TEST(CurrentDesktopIsExactlyOneGuid) {
+    std::vector<uint8_t> blob = MakeBlob({ 4, 5 });
+    DesktopGuid id;
+    CHECK(ParseCurrentDesktopId(blob.data(), 16, id) == BlobStatus::Ok);
+    CHECK(id == MakeId(4));
+    CHECK(ParseCurrentDesktopId(blob.data(), 32, id) == BlobStatus::BadSize);
+    CHECK(ParseCurrentDesktopId(blob.data(), 15, id) == BlobStatus::BadSize);
+    CHECK(ParseCurrentDesktopId(blob.data(), 0, id) == BlobStatus::Empty);
+}
+
+TEST(NameStopsAtTerminator) {
+    std::vector<uint8_t> value = MakeName(L"Work", true);
+    std::vector<uint8_t> junk = MakeName(L"xyz", false);
+    value.insert(value.end(), junk.begin(), junk.end());
+
+    DesktopNameView name;
+    REQUIRE(DesktopNameView::Parse(value.data(), value.size(), name) == BlobStatus::Ok);
+    std::wstring decoded;
+    name.AssignTo(decoded);
+    CHECK_EQ(decoded, std::wstring(L"Work"));
+    CHECK(name.Equals(L"Work"));
+    CHECK(!name.Equals(L"Wor"));
+}
+
+TEST(NameWithoutTerminatorOrTooLong) {
+    std::vector<uint8_t> value = MakeName(L"Mail é中", false);
+    DesktopNameView name;
+    REQUIRE(DesktopNameView::Parse(value.data(), value.size(), name) == BlobStatus::Ok);
+    CHECK(name.Equals(L"Mail é中"));
+
+    CHECK(DesktopNameView::Parse(value.data(), value.size() - 1, name) == BlobStatus::BadSize);
+
+    std::vector<uint8_t> longName = MakeName(std::wstring(DesktopNameView::MAX_LENGTH + 1, L'a'), true);
+    CHECK(DesktopNameView::Parse(longName.data(), longName.size(), name) == BlobStatus::TooLarge);
+}
+
+TEST(DiffFindsChangedPositions) {
+    std::vector<uint8_t> before = MakeBlob({ 1, 2, 3, 4 });
+    std::vector<uint8_t> after = MakeBlob({ 1, 3, 2, 4, 5 });
+    DesktopIdListView oldList;
+    DesktopIdListView newList;
+    REQUIRE(DesktopIdListView::Parse(before.data(), before.size(), oldList) == BlobStatus::Ok);
+    REQUIRE(DesktopIdListView::Parse(after.data(), after.size(), newList) == BlobStatus::Ok);
+
+    DesktopIdListDiff diff = DiffDesktopIdLists(oldList, newList);
+    CHECK(!diff.identical);
+    CHECK_EQ(diff.oldCount, 4u);
+    CHECK_EQ(diff.newCount, 5u);
+    CHECK_EQ(diff.firstDifference, 1u);
+    CHECK_EQ(diff.changedPositions, 2u);
+
+    diff = DiffDesktopIdLists(oldList, oldList);
+    CHECK(diff.identical);
+    CHECK_EQ(diff.firstDifference, 4u);
+
+    // Prefix-equal lists differ only in length
+    DesktopIdListView prefix;
+    REQUIRE(DesktopIdListView::Parse(before.data(), 32, prefix) == BlobStatus::Ok);
+    diff = DiffDesktopIdLists(prefix, oldList);
+    CHECK(!diff.identical);
+    CHECK_EQ(diff.changedPositions, 0u);
+    CHECK_EQ(diff.firstDifference, 2u);
+}
@@ -0,0 +1,200 @@
+#include "Test.h"
+#include "desktop/DesktopCatalog.h"
+#include <cstring>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace VirtualOverlay;
+
+namespace {
+
+DesktopGuid MakeId(uint32_t seed) {
+    DesktopGuid id;
+    for (size_t i = 0; i < DesktopGuid::SIZE; i++) {
+        id.bytes[i] = static_cast<uint8_t>((seed >> (8 * (i % 4))) * 31 + i);
+    }
+    return id;
+}
+
+// An id whose DesktopGuid::Hash is exactly `hash`: the high half is free,
+// the low half cancels it out
+DesktopGuid MakeIdWithHash(uint64_t hash, uint64_t high) {
+    // Undo h ^ (h >> 29)
+    uint64_t h = hash;
+    for (int i = 0; i < 3; i++) {
+        h = hash ^ (h >> 29);
+    }
+    uint64_t low = h ^ (high * 0x9E3779B97F4A7C15ull);
+    DesktopGuid id;
+    std::memcpy(id.bytes, &low, 8);
+    std::memcpy(id.bytes + 8, &high, 8);
+    return id;
+}
+
+std::vector<uint8_t> MakeBlob(const std::vector<DesktopGuid>& ids) {
+    std::vector<uint8_t> blob;
+    for (const DesktopGuid& id : ids) {
+        blob.insert(blob.end(), id.bytes, id.bytes + DesktopGuid::SIZE);
+    }
+    return blob;
+}
+
+// Every id is found at its position, as a linear scan would find it
+void CheckLookups(const DesktopCatalog& catalog, const std::vector<DesktopGuid>& ids) {
+    REQUIRE(catalog.GetCount() == ids.size());
+    for (size_t i = 0; i < ids.size(); i++) {
+        size_t first = i;
+        for (size_t j = 0; j < i; j++) {
+            if (ids[j] == ids[i]) {
+                first = j;
+                break;
+            }
+        }
+        CHECK_EQ(catalog.IndexOf(ids[i]), static_cast<int>(first + 1));
+        CHECK(catalog.GetId(static_cast<int>(i + 1)) == ids[i]);
+    }
+}
+
+}  // namespace
+
+TEST(EmptyCatalogKnowsNothing) {
+    DesktopCatalog catalog;
+    CHECK(catalog.IsEmpty());
+    CHECK_EQ(catalog.IndexOf(MakeId(1)), 0);
+    CHECK(catalog.GetId(1).IsNull());
+    CHECK(catalog.GetName(1).empty());
+    CHECK(!catalog.SetName(MakeId(1), L"Mail"));
+    CHECK_EQ(catalog.GetGeneration(), 0u);
+}
+
+TEST(LookupsMatchTheList) {
+    std::vector<DesktopGuid> ids;
+    for (uint32_t i = 0; i < 1000; i++) {
+        ids.push_back(MakeId(i * 2654435761u));
+    }
+    std::vector<uint8_t> blob = MakeBlob(ids);
+
+    DesktopCatalog catalog;
+    BlobStatus status = BlobStatus::Empty;
+    REQUIRE(catalog.UpdateFromBlob(blob.data(), blob.size(), &status));
+    CHECK(status == BlobStatus::Ok);
+    CheckLookups(catalog, ids);
+    CHECK_EQ(catalog.IndexOf(MakeId(12345)), 0);
+    CHECK(catalog.GetId(0).IsNull());
+    CHECK(catalog.GetId(1001).IsNull());
+}
+
+TEST(FullHashCollisionsAreProbed) {
+    // Every id has the same hash, so they all probe one run of slots; the
+    // run starts in the last slot so it wraps around the table
+    const uint64_t hash = ~0ull;
+    std::vector<DesktopGuid> ids;
+    for (uint64_t i = 1; i <= 12; i++) {
+        ids.push_back(MakeIdWithHash(hash, i));
+        CHECK_EQ(ids.back().Hash(), hash);
+    }
+
+    DesktopCatalog catalog;
+    REQUIRE(catalog.UpdateFromIds(ids.data(), ids.size()));
+    CheckLookups(catalog, ids);
+
+    // Colliding ids that are not in the list are not found
+    CHECK_EQ(catalog.IndexOf(MakeIdWithHash(hash, 99)), 0);
+    CHECK_EQ(catalog.IndexOf(MakeIdWithHash(hash - 1, 1)), 0);
+}
+
+TEST(LowBitCollisionsAreProbed) {
+    // Hashes that differ only above the table size
+    std::vector<DesktopGuid> ids;
+    for (uint64_t i = 0; i < 64; i++) {
+        ids.push_back(MakeIdWithHash((i << 40) | 5, i + 1));
+    }
+    DesktopCatalog catalog;
+    REQUIRE(catalog.UpdateFromIds(ids.data(), ids.size()));
+    CheckLookups(catalog, ids);
+    CHECK_EQ(catalog.IndexOf(MakeIdWithHash((99ull << 40) | 5, 1)), 0);
+}
+
+TEST(DuplicatesResolveToTheFirst) {
+    std::vector<DesktopGuid> ids = { MakeId(1), MakeId(2), MakeId(1), MakeId(3) };
+    DesktopCatalog catalog;
+    REQUIRE(catalog.UpdateFromIds(ids.data(), ids.size()));
+    CheckLookups(catalog, ids);
+    CHECK_EQ(catalog.IndexOf(MakeId(1)), 1);
+}
+
+TEST(GenerationCountsRealChanges) {
+    std::vector<DesktopGuid> ids = { MakeId(1), MakeId(2), MakeId(3) };
+    std::vector<uint8_t> blob = MakeBlob(ids);
+
+    DesktopCatalog catalog;
+    REQUIRE(catalog.UpdateFromBlob(blob.data(), blob.size()));
+    CHECK_EQ(catalog.GetGeneration(), 1u);
+    CHECK(catalog.IsSameBlob(blob.data(), blob.size()));
+
+    // The same list, as a blob or as ids: no rebuild
+    CHECK(!catalog.UpdateFromBlob(blob.data(), blob.size()));
+    CHECK(!catalog.UpdateFromIds(ids.data(), ids.size()));
+    CHECK_EQ(catalog.GetGeneration(), 1u);
+
+    // Malformed values are rejected and change nothing
+    BlobStatus status = BlobStatus::Ok;
+    CHECK(!catalog.UpdateFromBlob(blob.data(), blob.size() - 1, &status));
+    CHECK(status == BlobStatus::BadSize);
+    CHECK(!catalog.UpdateFromBlob(nullptr, 0, &status));
+    CHECK(status == BlobStatus::Empty);
+    CHECK_EQ(catalog.GetGeneration(), 1u);
+    CheckLookups(catalog, ids);
+
+    // A reorder has the same bytes in another order
+    std::swap(ids[0], ids[2]);
+    blob = MakeBlob(ids);
+    CHECK(!catalog.IsSameBlob(blob.data(), blob.size()));
+    REQUIRE(catalog.UpdateFromBlob(blob.data(), blob.size()));
+    CHECK_EQ(catalog.GetGeneration(), 2u);
+    CheckLookups(catalog, ids);
+
+    // Clearing is a change too, and the next identical list rebuilds
+    catalog.Clear();
+    CHECK_EQ(catalog.GetGeneration(), 3u);
+    CHECK(catalog.IsEmpty());
+    CHECK(!catalog.IsSameBlob(blob.data(), blob.size()));
+    CHECK(catalog.UpdateFromBlob(blob.data(), blob.size()));
+    CHECK_EQ(catalog.GetGeneration(), 4u);
+}
+
+TEST(OneFlippedBitRebuilds) {
+    std::mt19937 rng(3);
+    std::vector<DesktopGuid> ids;
+    for (uint32_t i = 0; i < 16; i++) {
+        ids.push_back(MakeId(rng()));
+    }
+    std::vector<uint8_t> blob = MakeBlob(ids);
+    DesktopCatalog catalog;
+    REQUIRE(catalog.UpdateFromBlob(blob.data(), blob.size()));
+
+    for (size_t bit = 0; bit < blob.size() * 8; bit += 7) {
+        uint64_t generation = catalog.GetGeneration();
+        blob[bit / 8] ^= static_cast<uint8_t>(1u << (bit % 8));
+        CHECK(catalog.UpdateFromBlob(blob.data(), blob.size()));
+        CHECK_EQ(catalog.GetGeneration(), generation + 1);
+    }
+}
+
+TEST(NamesFollowTheirDesktops) {
+    std::vector<DesktopGuid> ids = { MakeId(1), MakeId(2), MakeId(3) };
+    DesktopCatalog catalog;
+    REQUIRE(catalog.UpdateFromIds(ids.data(), ids.size()));
+    CHECK(catalog.SetName(ids[0], L"Mail"));
+    CHECK(catalog.SetName(ids[2], L"Code"));
+    CHECK(!catalog.SetName(MakeId(9), L"Nope"));
+
+    // Desktop 2 removed, 1 and 3 swapped, a new one appended
+    std::vector<DesktopGuid> next = { ids[2], ids[0], MakeId(4) };
+    REQUIRE(catalog.UpdateFromIds(next.data(), next.size()));
+    CHECK(catalog.GetName(1) == L"Code");
+    CHECK(catalog.GetName(2) == L"Mail");
+    CHECK(catalog.GetName(3).empty());
+    CHECK(catalog.GetName(4).empty());
+}
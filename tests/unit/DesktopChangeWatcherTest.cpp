@@ -0,0 +1,156 @@
+#include "Test.h"
+#include "InMemoryRegistryWatch.h"
+#include "desktop/DesktopChangeWatcher.h"
+#include "desktop/PollScheduler.h"
+
+using namespace VirtualOverlay;
+
+namespace {
+
+const std::wstring CURRENT = L"CurrentVirtualDesktop";
+
+// Sleeps until the next wakeup the watcher asks for, the way App's timer
+// does, forwarding notifications first. Returns the reasons seen.
+std::vector<DesktopWakeReason> RunUntil(DesktopChangeWatcher& watcher, InMemoryRegistryWatch& registry,
+                                        uint64_t& nowMs, uint64_t untilMs) {
+    std::vector<DesktopWakeReason> reasons;
+    while (true) {
+        uint64_t next = nowMs + watcher.NextWakeDelayMs(nowMs);
+        if (next > untilMs) {
+            nowMs = untilMs;
+            return reasons;
+        }
+        nowMs = next;
+        for (uint32_t n = registry.TakePendingNotifications(); n > 0; n--) {
+            watcher.OnNotify(nowMs);
+        }
+        DesktopWakeReason reason = watcher.Poll(nowMs);
+        if (reason != DesktopWakeReason::None) {
+            reasons.push_back(reason);
+        }
+    }
+}
+
+}  // namespace
+
+TEST(StartArmsTheNotification) {
+    InMemoryRegistryWatch registry;
+    DesktopChangeWatcher watcher(registry);
+    watcher.Start(0);
+
+    CHECK(watcher.IsRunning());
+    CHECK(watcher.IsEventDriven());
+    CHECK_EQ(registry.GetArmCount(), 1u);
+
+    watcher.Stop();
+    CHECK(!registry.IsArmed());
+    CHECK(watcher.Poll(10) == DesktopWakeReason::None);
+}
+
+TEST(NotificationThenRecheck) {
+    InMemoryRegistryWatch registry;
+    DesktopChangeWatcher watcher(registry);
+    watcher.Start(0);
+
+    CHECK(registry.SetValue(CURRENT, { 1 }));
+    CHECK_EQ(registry.TakePendingNotifications(), 1u);
+    watcher.OnNotify(100);
+    CHECK(registry.IsArmed());  // Re-armed before the detection pass reads
+    CHECK_EQ(watcher.NextWakeDelayMs(100), 1u);
+
+    CHECK(watcher.Poll(100) == DesktopWakeReason::Notification);
+    CHECK(watcher.Poll(200) == DesktopWakeReason::None);
+    CHECK_EQ(watcher.NextWakeDelayMs(200), 150u);
+    CHECK(watcher.Poll(350) == DesktopWakeReason::Recheck);
+    CHECK_EQ(watcher.GetStats().notifications, 1u);
+    CHECK_EQ(watcher.GetStats().recheckChecks, 1u);
+}
+
+TEST(WriteBurstBetweenRearmsNotifiesOnce) {
+    InMemoryRegistryWatch registry;
+    DesktopChangeWatcher watcher(registry);
+    watcher.Start(0);
+
+    CHECK(registry.SetValue(CURRENT, { 1 }));
+    CHECK(!registry.SetValue(CURRENT, { 2 }));
+    CHECK(!registry.SetValue(L"VirtualDesktopIDs", { 3 }));
+    CHECK_EQ(registry.TakePendingNotifications(), 1u);
+
+    std::vector<uint8_t> value;
+    CHECK(registry.GetValue(CURRENT, value));
+    CHECK(value == std::vector<uint8_t>{ 2 });
+}
+
+TEST(IdleIsOnlyTheSafetyNet) {
+    InMemoryRegistryWatch registry;
+    DesktopChangeWatcher watcher(registry);
+    uint64_t now = 0;
+    watcher.Start(now);
+
+    std::vector<DesktopWakeReason> reasons = RunUntil(watcher, registry, now, 60000);
+    CHECK_EQ(reasons.size(), 60u);
+    for (DesktopWakeReason reason : reasons) {
+        CHECK(reason == DesktopWakeReason::SafetyNet);
+    }
+    // One wakeup a second, against 24,000 an hour for the old 150 ms poll
+    CHECK_NEAR(watcher.WakeupsPerHour(now), 3600.0, 1.0);
+}
+
+TEST(SwitchIsDetectedWithinOneWakeup) {
+    InMemoryRegistryWatch registry;
+    DesktopChangeWatcher watcher(registry);
+    uint64_t now = 0;
+    watcher.Start(now);
+
+    RunUntil(watcher, registry, now, 1500);
+    registry.SetValue(CURRENT, { 7 });
+    std::vector<DesktopWakeReason> reasons = RunUntil(watcher, registry, now, 1502);
+    REQUIRE(!reasons.empty());
+    CHECK(reasons.front() == DesktopWakeReason::Notification);
+}
+
+TEST(FallsBackToPollingAndRetriesArm) {
+    InMemoryRegistryWatch registry;
+    registry.SetArmFails(true);
+    DesktopChangeWatcher watcher(registry);
+    uint64_t now = 0;
+    watcher.Start(now);
+    CHECK(!watcher.IsEventDriven());
+
+    std::vector<DesktopWakeReason> reasons = RunUntil(watcher, registry, now, 1500);
+    CHECK_EQ(reasons.size(), 10u);
+    for (DesktopWakeReason reason : reasons) {
+        CHECK(reason == DesktopWakeReason::Fallback);
+    }
+
+    // The next retry (5 s after the failure) succeeds
+    registry.SetArmFails(false);
+    RunUntil(watcher, registry, now, 5100);
+    CHECK(watcher.IsEventDriven());
+    CHECK_EQ(watcher.GetStats().armFailures, 1u);
+
+    reasons = RunUntil(watcher, registry, now, 8100);
+    CHECK_EQ(reasons.size(), 3u);
+    CHECK(reasons.back() == DesktopWakeReason::SafetyNet);
+}
+
+TEST(SchedulerBurstPollsFast) {
+    InMemoryRegistryWatch registry;
+    PollScheduler scheduler;
+    DesktopChangeWatcher watcher(registry);
+    watcher.SetScheduler(&scheduler);
+    uint64_t now = 0;
+    watcher.Start(now);
+
+    scheduler.OnBurstTrigger(1000);
+    RunUntil(watcher, registry, now, 1000);
+    std::vector<DesktopWakeReason> reasons = RunUntil(watcher, registry, now, 1500);
+    CHECK(reasons.size() >= 30u);
+    CHECK(reasons.front() == DesktopWakeReason::Burst);
+
+    // The detected switch ends the burst; back to the safety net
+    scheduler.OnSwitchDetected(now);
+    reasons = RunUntil(watcher, registry, now, now + 1100);
+    CHECK_EQ(reasons.size(), 1u);
+    CHECK(reasons.back() == DesktopWakeReason::SafetyNet);
+}
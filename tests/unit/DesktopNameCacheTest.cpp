@@ -0,0 +1,237 @@
+#include "Test.h"
+#include "InMemoryRegistryWatch.h"
+#include "desktop/DesktopCatalog.h"
+#include "desktop/DesktopNameCache.h"
+#include <string>
+#include <vector>
+
+using namespace VirtualOverlay;
+
+namespace {
+
+DesktopGuid MakeId(uint8_t seed) {
+    DesktopGuid id;
+    for (size_t i = 0; i < DesktopGuid::SIZE; i++) {
+        id.bytes[i] = static_cast<uint8_t>(seed * 31 + i);
+    }
+    return id;
+}
+
+// REG_SZ bytes: UTF-16LE with the terminator
+std::vector<uint8_t> MakeName(const std::wstring& name) {
+    std::vector<uint8_t> value;
+    for (wchar_t c : name) {
+        value.push_back(static_cast<uint8_t>(c & 0xFF));
+        value.push_back(static_cast<uint8_t>((c >> 8) & 0xFF));
+    }
+    value.push_back(0);
+    value.push_back(0);
+    return value;
+}
+
+// VirtualDesktop's side of the cache against the in-memory registry: values
+// are stored under "<keyPath>\Name", and each delivered notification
+// invalidates the cache the way the registry change watch does
+class NameReader {
+public:
+    NameReader() { m_registry.Arm(); }
+
+    void SetName(const DesktopGuid& id, const std::wstring& name) {
+        SetRaw(id, MakeName(name));
+    }
+
+    void SetRaw(const DesktopGuid& id, const std::vector<uint8_t>& value) {
+        m_registry.SetValue(GetValueName(id), value);
+    }
+
+    // Pumps pending notifications, then resolves like ResolveDesktopName
+    const DesktopNameEntry& Resolve(const DesktopGuid& id) {
+        if (m_registry.TakePendingNotifications() > 0) {
+            m_cache.InvalidateAll();
+            m_registry.Arm();
+        }
+        DesktopNameEntry& entry = m_cache.Lookup(id);
+        if (!entry.stale) {
+            return entry;
+        }
+        std::vector<uint8_t> value;
+        if (m_registry.GetValue(entry.keyPath + L"\\Name", value)) {
+            m_cache.Store(entry, value.data(), value.size());
+        } else {
+            m_cache.StoreMissing(entry);
+        }
+        return entry;
+    }
+
+    void Remove(const DesktopGuid& id) {
+        // The in-memory registry has no delete: an empty value stands in,
+        // and StoreMissing is tested directly below
+        SetRaw(id, {});
+    }
+
+    DesktopNameCache& GetCache() { return m_cache; }
+
+private:
+    static std::wstring GetValueName(const DesktopGuid& id) {
+        return L"Desktops\\" + id.ToRegistryString() + L"\\Name";
+    }
+
+    InMemoryRegistryWatch m_registry;
+    DesktopNameCache m_cache;
+};
+
+}  // namespace
+
+TEST(KeyPathIsPrebuilt) {
+    DesktopNameCache cache;
+    DesktopGuid id = MakeId(1);
+    DesktopNameEntry& entry = cache.Lookup(id);
+    CHECK(entry.keyPath == L"Desktops\\" + id.ToRegistryString());
+    CHECK(entry.id == id);
+    CHECK(entry.stale);
+    CHECK(!entry.loaded);
+    CHECK_EQ(cache.GetSize(), 1u);
+}
+
+TEST(HitsAndMissesAreCounted) {
+    NameReader reader;
+    DesktopGuid mail = MakeId(1);
+    DesktopGuid code = MakeId(2);
+    reader.SetName(mail, L"Mail");
+
+    CHECK(reader.Resolve(mail).name == L"Mail");
+    CHECK(reader.Resolve(code).name.empty());
+    const DesktopNameCacheStats& stats = reader.GetCache().GetStats();
+    CHECK_EQ(stats.registryReads, 2u);
+    CHECK_EQ(stats.cacheHits, 0u);
+    CHECK_EQ(stats.decodes, 1u);    // The missing name is not decoded
+
+    // No notification: every later lookup is a hit
+    for (int i = 0; i < 10; i++) {
+        CHECK(reader.Resolve(mail).name == L"Mail");
+        CHECK(reader.Resolve(code).name.empty());
+    }
+    CHECK_EQ(stats.registryReads, 2u);
+    CHECK_EQ(stats.cacheHits, 20u);
+    CHECK_EQ(stats.decodes, 1u);
+
+    reader.GetCache().ResetStats();
+    CHECK_EQ(reader.GetCache().GetStats().cacheHits, 0u);
+}
+
+TEST(UnchangedValueIsNotDecodedAgain) {
+    NameReader reader;
+    DesktopGuid id = MakeId(1);
+    reader.SetName(id, L"Mail");
+    uint32_t version = reader.Resolve(id).version;
+    CHECK_EQ(version, 1u);
+
+    // The same bytes written again: the notification forces a read, the
+    // fingerprint matches and nothing is decoded
+    reader.SetName(id, L"Mail");
+    const DesktopNameEntry& entry = reader.Resolve(id);
+    const DesktopNameCacheStats& stats = reader.GetCache().GetStats();
+    CHECK_EQ(stats.registryReads, 2u);
+    CHECK_EQ(stats.decodes, 1u);
+    CHECK_EQ(entry.version, version);
+    CHECK(entry.name == L"Mail");
+    CHECK(!entry.stale);
+
+    // A notification for another value: the read finds the same bytes
+    reader.SetName(MakeId(9), L"Other");
+    reader.Resolve(id);
+    CHECK_EQ(stats.registryReads, 3u);
+    CHECK_EQ(stats.decodes, 1u);
+    CHECK_EQ(reader.Resolve(id).version, version);
+}
+
+TEST(RenamesBumpTheVersion) {
+    NameReader reader;
+    DesktopGuid id = MakeId(1);
+    reader.SetName(id, L"Mail");
+    CHECK_EQ(reader.Resolve(id).version, 1u);
+
+    reader.SetName(id, L"Code");
+    const DesktopNameEntry& entry = reader.Resolve(id);
+    CHECK(entry.name == L"Code");
+    CHECK_EQ(entry.version, 2u);
+    CHECK_EQ(reader.GetCache().GetStats().decodes, 2u);
+
+    // Cleared by the user: an empty value is no name
+    reader.Remove(id);
+    CHECK(reader.Resolve(id).name.empty());
+    CHECK_EQ(reader.Resolve(id).version, 3u);
+}
+
+TEST(SameNameInOtherBytesKeepsTheVersion) {
+    // Without the terminator the bytes differ, so the value is decoded, but
+    // the name is the same and the version stays
+    NameReader reader;
+    DesktopGuid id = MakeId(1);
+    reader.SetName(id, L"Mail");
+    reader.Resolve(id);
+
+    std::vector<uint8_t> unterminated = MakeName(L"Mail");
+    unterminated.resize(unterminated.size() - 2);
+    reader.SetRaw(id, unterminated);
+    const DesktopNameEntry& entry = reader.Resolve(id);
+    CHECK_EQ(reader.GetCache().GetStats().decodes, 2u);
+    CHECK(entry.name == L"Mail");
+    CHECK_EQ(entry.version, 1u);
+}
+
+TEST(MalformedValueKeepsTheLastName) {
+    NameReader reader;
+    DesktopGuid id = MakeId(1);
+    reader.SetName(id, L"Mail");
+    reader.Resolve(id);
+
+    std::vector<uint8_t> odd = MakeName(L"Code");
+    odd.push_back(0x41);
+    reader.SetRaw(id, odd);
+    const DesktopNameEntry& entry = reader.Resolve(id);
+    CHECK(entry.name == L"Mail");
+    CHECK_EQ(entry.version, 1u);
+    CHECK(!entry.stale);
+}
+
+TEST(MissingValueRemovesTheName) {
+    DesktopNameCache cache;
+    DesktopNameEntry& entry = cache.Lookup(MakeId(1));
+    std::vector<uint8_t> value = MakeName(L"Mail");
+    CHECK(cache.Store(entry, value.data(), value.size()));
+    CHECK(!cache.Store(entry, value.data(), value.size()));
+
+    CHECK(cache.StoreMissing(entry));
+    CHECK(entry.name.empty());
+    CHECK_EQ(entry.version, 2u);
+    CHECK(!entry.hasRaw);
+    CHECK(!cache.StoreMissing(entry));
+    CHECK_EQ(entry.version, 2u);
+
+    // The fingerprint was dropped, so the same value is decoded again
+    CHECK(cache.Store(entry, value.data(), value.size()));
+    CHECK(entry.name == L"Mail");
+    CHECK_EQ(entry.version, 3u);
+}
+
+TEST(PruneDropsRemovedDesktops) {
+    NameReader reader;
+    std::vector<DesktopGuid> ids = { MakeId(1), MakeId(2), MakeId(3) };
+    for (const DesktopGuid& id : ids) {
+        reader.Resolve(id);
+    }
+    CHECK_EQ(reader.GetCache().GetSize(), 3u);
+
+    DesktopCatalog catalog;
+    std::vector<DesktopGuid> remaining = { ids[0], ids[2] };
+    REQUIRE(catalog.UpdateFromIds(remaining.data(), remaining.size()));
+    reader.GetCache().Prune(catalog);
+    CHECK_EQ(reader.GetCache().GetSize(), 2u);
+
+    // Still cached, still hits
+    uint64_t hits = reader.GetCache().GetStats().cacheHits;
+    reader.Resolve(ids[0]);
+    reader.Resolve(ids[2]);
+    CHECK_EQ(reader.GetCache().GetStats().cacheHits, hits + 2);
+}
@@ -0,0 +1,137 @@
+#include "Test.h"
+#include "desktop/DesktopSentinels.h"
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace VirtualOverlay;
+
+namespace {
+
+using WindowKey = WindowDesktopIndex::WindowKey;
+
+DesktopGuid MakeId(uint8_t seed) {
+    DesktopGuid id;
+    for (size_t i = 0; i < DesktopGuid::SIZE; i++) {
+        id.bytes[i] = static_cast<uint8_t>(seed * 37 + i + 1);
+    }
+    return id;
+}
+
+// Sort every window on the desktop by rank key, ties in list order
+std::vector<WindowKey> BruteForceSentinels(const WindowDesktopIndex& index, const DesktopGuid& desktop,
+                                           size_t perDesktop) {
+    std::vector<WindowKey> windows;
+    if (const std::vector<WindowKey>* list = index.GetWindows(desktop)) {
+        windows = *list;
+    }
+    std::stable_sort(windows.begin(), windows.end(), [&](WindowKey a, WindowKey b) {
+        return DesktopSentinels::RankKey(*index.Find(a)) < DesktopSentinels::RankKey(*index.Find(b));
+    });
+    if (windows.size() > perDesktop) {
+        windows.resize(perDesktop);
+    }
+    return windows;
+}
+
+}  // namespace
+
+TEST(PerDesktopIsClamped) {
+    CHECK_EQ(DesktopSentinels(0).GetPerDesktop(), 1u);
+    CHECK_EQ(DesktopSentinels().GetPerDesktop(), DesktopSentinels::DEFAULT_PER_DESKTOP);
+    CHECK_EQ(DesktopSentinels(1000).GetPerDesktop(), DesktopSentinels::MAX_PER_DESKTOP);
+}
+
+TEST(OldestMainWindowsWin) {
+    WindowDesktopIndex index;
+    DesktopGuid desktop = MakeId(1);
+    const uint64_t minute = 60 * 1000;
+    index.Assign(1, desktop, 8 * minute);                          // Young
+    index.Assign(2, desktop, 0, WINDOW_TRAIT_TOOL);                // Old, but a tool window: 10 min
+    index.Assign(3, desktop, 1 * minute);                          // Oldest main window
+    index.Assign(4, desktop, 0, WINDOW_TRAIT_OWNED);               // Old dialog: 5 min
+    index.Assign(5, desktop, 0, WINDOW_TRAIT_TOOL | WINDOW_TRAIT_OWNED);
+
+    DesktopSentinels sentinels(3);
+    std::vector<WindowKey> expected = { 3, 4, 1 };
+    CHECK(sentinels.Get(desktop, index) == expected);
+    CHECK(DesktopSentinels::Score(*index.Find(3), 20 * minute) >
+          DesktopSentinels::Score(*index.Find(4), 20 * minute));
+    CHECK(sentinels.Get(MakeId(2), index).empty());
+}
+
+TEST(RebuiltOnlyWhenTheDesktopChanges) {
+    WindowDesktopIndex index;
+    DesktopGuid a = MakeId(1);
+    DesktopGuid b = MakeId(2);
+    index.Assign(1, a, 0);
+    index.Assign(2, b, 0);
+
+    DesktopSentinels sentinels;
+    sentinels.Get(a, index);
+    sentinels.Get(b, index);
+    CHECK_EQ(sentinels.GetRebuildCount(), 2u);
+    sentinels.Get(a, index);
+    index.MarkStale(1);
+    sentinels.Get(a, index);
+    CHECK_EQ(sentinels.GetRebuildCount(), 2u);
+
+    index.Assign(3, b, 0);
+    sentinels.Get(a, index);
+    sentinels.Get(b, index);
+    CHECK_EQ(sentinels.GetRebuildCount(), 3u);
+
+    // The desktop emptied: its set goes, and Prune drops the rest
+    index.Remove(1);
+    CHECK(sentinels.Get(a, index).empty());
+    index.Clear();
+    sentinels.Prune(index);
+    CHECK(sentinels.Get(b, index).empty());
+    CHECK_EQ(sentinels.GetRebuildCount(), 3u);
+}
+
+TEST(RandomChurnMatchesBruteForce) {
+    // Windows created, moved between desktops, re-flagged and destroyed at
+    // random; after every step each desktop's sentinels, in order, are the
+    // best-ranked windows a full sort picks
+    const size_t desktopCount = 6;
+    std::vector<DesktopGuid> desktops;
+    for (size_t i = 0; i < desktopCount; i++) {
+        desktops.push_back(MakeId(static_cast<uint8_t>(i)));
+    }
+
+    std::mt19937 rng(31);
+    for (size_t perDesktop : { 1u, 3u, 16u }) {
+        WindowDesktopIndex index;
+        DesktopSentinels sentinels(perDesktop);
+        uint64_t nowMs = 0;
+        for (int step = 0; step < 6000; step++) {
+            // Time jumps by whole penalties now and then, so tool and owned
+            // windows tie with older main windows
+            nowMs += rng() % 4 == 0 ? DesktopSentinels::OWNED_WINDOW_PENALTY_MS : rng() % 1000;
+            WindowKey window = 1 + rng() % 300;
+            const DesktopGuid& desktop = desktops[rng() % desktopCount];
+            uint32_t op = rng() % 10;
+            if (op < 4) {
+                index.Assign(window, desktop, nowMs, index.Contains(window) ? index.Find(window)->traits : 0);
+            } else if (op < 6) {
+                uint32_t traits = rng() % 4;   // WINDOW_TRAIT_TOOL | WINDOW_TRAIT_OWNED combinations
+                const WindowDesktopIndex::WindowEntry* entry = index.Find(window);
+                index.Assign(window, entry ? entry->desktop : desktop, nowMs, traits);
+            } else if (op < 9) {
+                index.Remove(window);
+            } else {
+                index.MarkStale(window);
+            }
+
+            for (const DesktopGuid& d : desktops) {
+                CHECK(sentinels.Get(d, index) == BruteForceSentinels(index, d, perDesktop));
+            }
+            if (step % 100 == 0) {
+                sentinels.Prune(index);
+            }
+        }
+        CHECK(index.GetWindowCount() > 50u);
+    }
+}
@@ -0,0 +1,300 @@
+#include "Test.h"
+#include "desktop/DesktopTopology.h"
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace VirtualOverlay;
+
+namespace {
+
+DesktopGuid MakeId(uint32_t seed) {
+    DesktopGuid id;
+    for (size_t i = 0; i < DesktopGuid::SIZE; i++) {
+        id.bytes[i] = static_cast<uint8_t>((seed >> (8 * (i % 4))) + i * 17);
+    }
+    return id;
+}
+
+// A desktop list as the user edits it: ids in order, names alongside
+struct DesktopList {
+    std::vector<DesktopGuid> ids;
+    std::vector<std::wstring> names;
+
+    void Add(uint32_t seed, const std::wstring& name = L"") {
+        ids.push_back(MakeId(seed));
+        names.push_back(name);
+    }
+
+    DesktopCatalog ToCatalog() const {
+        DesktopCatalog catalog;
+        catalog.UpdateFromIds(ids.data(), ids.size());
+        for (size_t i = 0; i < ids.size(); i++) {
+            if (!names[i].empty()) {
+                catalog.SetName(ids[i], names[i]);
+            }
+        }
+        return catalog;
+    }
+};
+
+std::vector<DesktopTopologyEvent> Diff(const DesktopList& before, const DesktopList& after) {
+    std::vector<DesktopTopologyEvent> events;
+    size_t count = DiffDesktopTopology(before.ToCatalog(), after.ToCatalog(), events);
+    CHECK_EQ(count, events.size());
+    return events;
+}
+
+int Find(const std::vector<DesktopGuid>& ids, const DesktopGuid& id) {
+    for (size_t i = 0; i < ids.size(); i++) {
+        if (ids[i] == id) {
+            return static_cast<int>(i + 1);
+        }
+    }
+    return 0;
+}
+
+// The same diff by nested scans, in the documented event order
+std::vector<DesktopTopologyEvent> BruteForceDiff(const DesktopList& before, const DesktopList& after) {
+    std::vector<DesktopTopologyEvent> events;
+    for (size_t i = 0; i < before.ids.size(); i++) {
+        if (Find(after.ids, before.ids[i]) == 0) {
+            DesktopTopologyEvent ev;
+            ev.change = DesktopTopologyChange::Destroyed;
+            ev.id = before.ids[i];
+            ev.oldIndex = static_cast<int>(i + 1);
+            ev.name = before.names[i];
+            events.push_back(ev);
+        }
+    }
+    for (size_t i = 0; i < after.ids.size(); i++) {
+        if (Find(before.ids, after.ids[i]) == 0) {
+            DesktopTopologyEvent ev;
+            ev.change = DesktopTopologyChange::Created;
+            ev.id = after.ids[i];
+            ev.newIndex = static_cast<int>(i + 1);
+            ev.name = after.names[i];
+            events.push_back(ev);
+        }
+    }
+    for (size_t i = 0; i < after.ids.size(); i++) {
+        int oldIndex = Find(before.ids, after.ids[i]);
+        if (oldIndex != 0 && oldIndex != static_cast<int>(i + 1)) {
+            DesktopTopologyEvent ev;
+            ev.change = DesktopTopologyChange::Moved;
+            ev.id = after.ids[i];
+            ev.oldIndex = oldIndex;
+            ev.newIndex = static_cast<int>(i + 1);
+            ev.name = after.names[i];
+            events.push_back(ev);
+        }
+    }
+    for (size_t i = 0; i < after.ids.size(); i++) {
+        int oldIndex = Find(before.ids, after.ids[i]);
+        if (oldIndex == 0) {
+            continue;
+        }
+        const std::wstring& oldName = before.names[static_cast<size_t>(oldIndex - 1)];
+        if (!oldName.empty() && !after.names[i].empty() && oldName != after.names[i]) {
+            DesktopTopologyEvent ev;
+            ev.change = DesktopTopologyChange::Renamed;
+            ev.id = after.ids[i];
+            ev.oldIndex = oldIndex;
+            ev.newIndex = static_cast<int>(i + 1);
+            ev.name = after.names[i];
+            events.push_back(ev);
+        }
+    }
+    return events;
+}
+
+bool SameEvents(const std::vector<DesktopTopologyEvent>& a, const std::vector<DesktopTopologyEvent>& b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); i++) {
+        if (a[i].change != b[i].change || a[i].id != b[i].id || a[i].oldIndex != b[i].oldIndex ||
+            a[i].newIndex != b[i].newIndex || a[i].name != b[i].name) {
+            return false;
+        }
+    }
+    return true;
+}
+
+DesktopList MakeList(uint32_t count) {
+    DesktopList list;
+    for (uint32_t i = 1; i <= count; i++) {
+        list.Add(i);
+    }
+    return list;
+}
+
+}  // namespace
+
+TEST(SameListHasNoEvents) {
+    DesktopList list = MakeList(5);
+    list.names[1] = L"Mail";
+    CHECK(Diff(list, list).empty());
+    CHECK(Diff(DesktopList(), DesktopList()).empty());
+}
+
+TEST(AddAtTheEnd) {
+    DesktopList before = MakeList(3);
+    DesktopList after = before;
+    after.Add(4, L"New");
+    std::vector<DesktopTopologyEvent> events = Diff(before, after);
+    REQUIRE(events.size() == 1u);
+    CHECK(events[0].change == DesktopTopologyChange::Created);
+    CHECK(events[0].id == MakeId(4));
+    CHECK_EQ(events[0].oldIndex, 0);
+    CHECK_EQ(events[0].newIndex, 4);
+    CHECK(events[0].name == L"New");
+}
+
+TEST(RemoveShiftsTheRest) {
+    DesktopList before = MakeList(4);
+    before.names[1] = L"Mail";
+    DesktopList after = before;
+    after.ids.erase(after.ids.begin() + 1);
+    after.names.erase(after.names.begin() + 1);
+
+    std::vector<DesktopTopologyEvent> events = Diff(before, after);
+    REQUIRE(events.size() == 3u);
+    CHECK(events[0].change == DesktopTopologyChange::Destroyed);
+    CHECK_EQ(events[0].oldIndex, 2);
+    CHECK(events[0].name == L"Mail");
+    CHECK(events[1].change == DesktopTopologyChange::Moved);
+    CHECK_EQ(events[1].oldIndex, 3);
+    CHECK_EQ(events[1].newIndex, 2);
+    CHECK(events[2].change == DesktopTopologyChange::Moved);
+    CHECK_EQ(events[2].oldIndex, 4);
+    CHECK_EQ(events[2].newIndex, 3);
+}
+
+TEST(ReorderMovesBoth) {
+    DesktopList before = MakeList(4);
+    DesktopList after = before;
+    std::swap(after.ids[0], after.ids[3]);
+    std::vector<DesktopTopologyEvent> events = Diff(before, after);
+    REQUIRE(events.size() == 2u);
+    CHECK(events[0].change == DesktopTopologyChange::Moved);
+    CHECK(events[0].id == MakeId(4));
+    CHECK_EQ(events[0].oldIndex, 4);
+    CHECK_EQ(events[0].newIndex, 1);
+    CHECK(events[1].id == MakeId(1));
+    CHECK_EQ(events[1].oldIndex, 1);
+    CHECK_EQ(events[1].newIndex, 4);
+}
+
+TEST(RenameNeedsBothNames) {
+    DesktopList before = MakeList(3);
+    before.names[0] = L"Mail";
+    before.names[1] = L"Code";
+    DesktopList after = before;
+    after.names[0] = L"Inbox";   // Renamed
+    after.names[1] = L"";        // Not known in the new snapshot: no event
+    after.names[2] = L"Music";   // Not known in the old one: no event
+
+    std::vector<DesktopTopologyEvent> events = Diff(before, after);
+    REQUIRE(events.size() == 1u);
+    CHECK(events[0].change == DesktopTopologyChange::Renamed);
+    CHECK(events[0].id == MakeId(1));
+    CHECK_EQ(events[0].oldIndex, 1);
+    CHECK_EQ(events[0].newIndex, 1);
+    CHECK(events[0].name == L"Inbox");
+}
+
+TEST(MixedEditsComeOutGrouped) {
+    DesktopList before = MakeList(5);
+    before.names[2] = L"Mail";
+    before.names[4] = L"Code";
+
+    // Remove 2, move 5 to the front, rename 3, add 6 in the middle
+    DesktopList after;
+    after.Add(5, L"Code");
+    after.Add(1);
+    after.Add(6, L"Notes");
+    after.Add(3, L"Inbox");
+    after.Add(4);
+
+    std::vector<DesktopTopologyEvent> events = Diff(before, after);
+    CHECK(SameEvents(events, BruteForceDiff(before, after)));
+    std::vector<DesktopTopologyChange> changes;
+    for (const DesktopTopologyEvent& ev : events) {
+        changes.push_back(ev.change);
+    }
+    std::vector<DesktopTopologyChange> expected = {
+        DesktopTopologyChange::Destroyed,   // 2
+        DesktopTopologyChange::Created,     // 6 at 3
+        DesktopTopologyChange::Moved,       // 5: 5 -> 1
+        DesktopTopologyChange::Moved,       // 1: 1 -> 2
+        DesktopTopologyChange::Moved,       // 3: 3 -> 4
+        DesktopTopologyChange::Moved,       // 4: 4 -> 5
+        DesktopTopologyChange::Renamed,     // 3: Mail -> Inbox
+    };
+    CHECK(changes == expected);
+    CHECK(events[1].name == L"Notes");
+    CHECK_EQ(events[1].newIndex, 3);
+    CHECK(events.back().name == L"Inbox");
+}
+
+TEST(EventsAppendToTheList) {
+    DesktopList before = MakeList(2);
+    DesktopList after = MakeList(3);
+    std::vector<DesktopTopologyEvent> events(2);
+    CHECK_EQ(DiffDesktopTopology(before.ToCatalog(), after.ToCatalog(), events), 1u);
+    CHECK_EQ(events.size(), 3u);
+    CHECK(events[2].change == DesktopTopologyChange::Created);
+}
+
+TEST(RandomEditsMatchBruteForce) {
+    // Replay random create / remove / move / rename edits, diffing each
+    // snapshot against the one before
+    std::mt19937 rng(5);
+    DesktopList list = MakeList(12);
+    uint32_t nextSeed = 100;
+    for (int step = 0; step < 2000; step++) {
+        DesktopList next = list;
+        int edits = 1 + static_cast<int>(rng() % 4);
+        for (int e = 0; e < edits; e++) {
+            size_t count = next.ids.size();
+            switch (rng() % 4) {
+                case 0: {
+                    size_t at = rng() % (count + 1);
+                    next.ids.insert(next.ids.begin() + at, MakeId(nextSeed++));
+                    next.names.insert(next.names.begin() + at, rng() % 2 ? L"" : L"New");
+                    break;
+                }
+                case 1:
+                    if (count > 1) {
+                        size_t at = rng() % count;
+                        next.ids.erase(next.ids.begin() + at);
+                        next.names.erase(next.names.begin() + at);
+                    }
+                    break;
+                case 2:
+                    if (count > 1) {
+                        size_t from = rng() % count;
+                        size_t to = rng() % count;
+                        DesktopGuid id = next.ids[from];
+                        std::wstring name = next.names[from];
+                        next.ids.erase(next.ids.begin() + from);
+                        next.names.erase(next.names.begin() + from);
+                        next.ids.insert(next.ids.begin() + to, id);
+                        next.names.insert(next.names.begin() + to, name);
+                    }
+                    break;
+                default:
+                    if (count > 0) {
+                        next.names[rng() % count] = L"Name " + std::to_wstring(rng() % 5);
+                    }
+                    break;
+            }
+        }
+
+        std::vector<DesktopTopologyEvent> events = Diff(list, next);
+        CHECK(SameEvents(events, BruteForceDiff(list, next)));
+        list = next;
+    }
+}
@@ -0,0 +1,231 @@
+#include "Test.h"
+#include "overlay/DistanceField.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+using namespace VirtualOverlay;
+
+namespace {
+
+const float QUANTUM = 1.0f / DistanceField::UNITS_PER_PIXEL;
+
+// Coverage of a disc, 16 x 16 samples per pixel; pixel centers at integers
+std::vector<uint8_t> DiscCoverage(int width, int height, float cx, float cy, float radius) {
+    std::vector<uint8_t> coverage(static_cast<size_t>(width) * height);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            int hits = 0;
+            for (int sy = 0; sy < 16; sy++) {
+                for (int sx = 0; sx < 16; sx++) {
+                    float px = x - 0.5f + (sx + 0.5f) / 16.0f - cx;
+                    float py = y - 0.5f + (sy + 0.5f) / 16.0f - cy;
+                    hits += px * px + py * py <= radius * radius;
+                }
+            }
+            coverage[static_cast<size_t>(y) * width + x] = static_cast<uint8_t>((hits * 255 + 128) / 256);
+        }
+    }
+    return coverage;
+}
+
+// Distance from each pixel center to the nearest set pixel center, the slow way
+double BruteForceDistance(const std::vector<bool>& feature, int width, int height, int x, int y) {
+    double best = 1e20;
+    for (int fy = 0; fy < height; fy++) {
+        for (int fx = 0; fx < width; fx++) {
+            if (feature[static_cast<size_t>(fy) * width + fx]) {
+                double dx = fx - x;
+                double dy = fy - y;
+                best = std::min(best, dx * dx + dy * dy);
+            }
+        }
+    }
+    return std::sqrt(best);
+}
+
+}  // namespace
+
+TEST(TransformMatchesBruteForce) {
+    std::mt19937 rng(14);
+    for (int round = 0; round < 30; round++) {
+        int width = 1 + static_cast<int>(rng() % 40);
+        int height = 1 + static_cast<int>(rng() % 40);
+        int density = 2 + static_cast<int>(rng() % 30);
+        std::vector<uint8_t> mask(static_cast<size_t>(width) * height);
+        std::vector<bool> inside(mask.size());
+        std::vector<bool> outside(mask.size());
+        bool anyInside = false;
+        bool anyOutside = false;
+        for (size_t i = 0; i < mask.size(); i++) {
+            mask[i] = (rng() % density == 0) ? 255 : 0;
+            inside[i] = mask[i] != 0;
+            outside[i] = !inside[i];
+            anyInside |= inside[i];
+            anyOutside |= outside[i];
+        }
+
+        DistanceField field = BuildDistanceField(mask.data(), width, height, 100);
+        REQUIRE(field.width == width && field.height == height);
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                size_t i = static_cast<size_t>(y) * width + x;
+                // Edges sit half a pixel from the centers on either side
+                double expected;
+                if (inside[i]) {
+                    expected = anyOutside ? -(BruteForceDistance(outside, width, height, x, y) - 0.5)
+                                          : -DistanceField::MAX_DISTANCE;
+                } else {
+                    expected = anyInside ? BruteForceDistance(inside, width, height, x, y) - 0.5
+                                         : DistanceField::MAX_DISTANCE;
+                }
+                expected = std::clamp<double>(expected, -DistanceField::MAX_DISTANCE, DistanceField::MAX_DISTANCE);
+                CHECK_NEAR(field.At(x, y), expected, QUANTUM);
+            }
+        }
+    }
+}
+
+TEST(DistanceIsClampedFarAway) {
+    const int width = 300;
+    const int height = 3;
+    std::vector<uint8_t> mask(width * height, 0);
+    mask[width + 0] = 255;
+    DistanceField field = BuildDistanceField(mask.data(), width, height, 20);
+    CHECK_NEAR(field.At(100, 1), 99.5, QUANTUM);
+    CHECK_NEAR(field.At(299, 1), DistanceField::MAX_DISTANCE, QUANTUM);
+    CHECK_NEAR(field.At(-1, 0), DistanceField::MAX_DISTANCE, 0.0);
+    CHECK_NEAR(field.At(0, 1), -0.5, QUANTUM);
+}
+
+TEST(EdgePixelsKeepTheirCoverage) {
+    std::vector<uint8_t> disc = DiscCoverage(40, 40, 19.3f, 20.1f, 11.7f);
+    DistanceField field = BuildDistanceField(disc.data(), 40, 40, 48);
+
+    // At scale 1 the field renders back to the coverage it was built from
+    std::vector<uint8_t> fill(disc.size());
+    std::vector<uint8_t> halo(disc.size());
+    RenderDistanceField(field, 40, 40, 1.0f, 0.0f, 0.0f, fill.data(), halo.data());
+    int worst = 0;
+    for (size_t i = 0; i < disc.size(); i++) {
+        worst = std::max(worst, std::abs(fill[i] - disc[i]));
+        CHECK_EQ(halo[i], 0);
+    }
+    CHECK(worst <= 1);
+}
+
+TEST(RenderedDiscMatchesAnalyticAtScales) {
+    // Golden: the same disc rasterized directly at the target size
+    const float radius = 9.0f;
+    std::vector<uint8_t> source = DiscCoverage(32, 32, 15.5f, 15.5f, radius);
+    DistanceField field = BuildDistanceField(source.data(), 32, 32, 40);
+
+    struct Case { float scale; double maxMeanError; };
+    for (const Case& c : { Case{ 0.5f, 2.0 }, Case{ 0.75f, 1.0 }, Case{ 1.0f, 0.5 },
+                           Case{ 1.5f, 1.0 }, Case{ 2.0f, 1.0 } }) {
+        int size = static_cast<int>(std::lround(32 * c.scale));
+        float center = size * 0.5f - 0.5f;
+        std::vector<uint8_t> expected = DiscCoverage(size, size, center, center, radius * c.scale);
+        std::vector<uint8_t> fill(expected.size());
+        std::vector<uint8_t> halo(expected.size());
+        RenderDistanceField(field, size, size, c.scale, 0.0f, 0.0f, fill.data(), halo.data());
+
+        double totalError = 0.0;
+        int worst = 0;
+        for (size_t i = 0; i < expected.size(); i++) {
+            int error = std::abs(fill[i] - expected[i]);
+            totalError += error;
+            worst = std::max(worst, error);
+        }
+        // Errors are confined to the one-pixel edge ramp
+        CHECK(totalError / expected.size() <= c.maxMeanError);
+        CHECK(worst <= 64);
+        CHECK_EQ(fill[(size / 2) * size + size / 2], 255);
+        CHECK_EQ(fill[0], 0);
+    }
+}
+
+TEST(OutlineAndGlowFollowTheDistance) {
+    const int size = 41;
+    std::vector<uint8_t> square(size * size, 0);
+    for (int y = 15; y <= 25; y++) {
+        for (int x = 15; x <= 25; x++) {
+            square[y * size + x] = 255;
+        }
+    }
+    DistanceField field = BuildDistanceField(square.data(), size, size, 20);
+    std::vector<uint8_t> fill(square.size());
+    std::vector<uint8_t> halo(square.size());
+    RenderDistanceField(field, size, size, 1.0f, 3.0f, 6.0f, fill.data(), halo.data());
+
+    // Row through the middle: text edge at x = 25.5, outline to 28.5, glow
+    // fading out to 34.5
+    const uint8_t* row = halo.data() + 20 * size;
+    CHECK_EQ(fill[20 * size + 25], 255);
+    CHECK_EQ(fill[20 * size + 26], 0);
+    CHECK_EQ(row[20], 255);
+    CHECK_EQ(row[28], 255);
+    CHECK(row[30] > 0 && row[30] < 255);
+    CHECK(row[30] > row[32]);
+    CHECK_EQ(row[35], 0);
+    CHECK_EQ(row[40], 0);
+
+    // Without a glow the outline ends with a one-pixel ramp
+    RenderDistanceField(field, size, size, 1.0f, 3.0f, 0.0f, fill.data(), halo.data());
+    CHECK_EQ(row[28], 255);
+    CHECK_EQ(row[29], 0);
+}
+
+TEST(EmptyInputs) {
+    DistanceField empty = BuildDistanceField(nullptr, 0, 10, 12);
+    CHECK_EQ(empty.width, 0);
+    CHECK_EQ(empty.fontSize, 12);
+    CHECK(empty.distance.empty());
+
+    uint8_t fill = 7;
+    uint8_t halo = 7;
+    RenderDistanceField(empty, 1, 1, 0.0f, 0.0f, 0.0f, &fill, &halo);
+    CHECK_EQ(fill, 7);  // Invalid scale draws nothing
+}
+
+TEST(AtlasReusesWithinScaleRange) {
+    DistanceFieldAtlas atlas;
+    DistanceFieldKey key{ L"3: Build", L"Segoe UI", 600 };
+    DistanceField field;
+    field.fontSize = 40;
+    field.width = 4;
+    field.height = 2;
+    field.distance.assign(8, 0);
+    CHECK(atlas.Insert(key, std::move(field)) != nullptr);
+    CHECK_EQ(atlas.GetStats().bytes, 16u);
+
+    CHECK(atlas.Find(key, 40) != nullptr);
+    CHECK(atlas.Find(key, 20) != nullptr);   // 0.5x
+    CHECK(atlas.Find(key, 80) != nullptr);   // 2x
+    CHECK(atlas.Find(key, 19) == nullptr);
+    CHECK(atlas.Find(key, 81) == nullptr);
+    CHECK(atlas.Find(DistanceFieldKey{ L"3: Build", L"Segoe UI", 700 }, 40) == nullptr);
+    CHECK_EQ(atlas.GetStats().hits, 3u);
+    CHECK_EQ(atlas.GetStats().misses, 3u);
+}
+
+TEST(AtlasEvictsLeastRecentlyUsed) {
+    DistanceFieldAtlas atlas(2);
+    auto add = [&](const wchar_t* text) {
+        DistanceField field;
+        field.fontSize = 20;
+        atlas.Insert(DistanceFieldKey{ text, L"Segoe UI", 400 }, std::move(field));
+    };
+    add(L"a");
+    add(L"b");
+    CHECK(atlas.Find(DistanceFieldKey{ L"a", L"Segoe UI", 400 }, 20) != nullptr);
+    add(L"c");
+    CHECK_EQ(atlas.GetCount(), 2u);
+    CHECK_EQ(atlas.GetStats().evictions, 1u);
+    CHECK(atlas.Find(DistanceFieldKey{ L"b", L"Segoe UI", 400 }, 20) == nullptr);
+    CHECK(atlas.Find(DistanceFieldKey{ L"a", L"Segoe UI", 400 }, 20) != nullptr);
+
+    atlas.Clear();
+    CHECK_EQ(atlas.GetCount(), 0u);
+    CHECK_EQ(atlas.GetStats().bytes, 0u);
+}
@@ -0,0 +1,142 @@
+#include "Test.h"
+#include "overlay/FormatTemplate.h"
+
+using namespace VirtualOverlay;
+
+namespace {
+
+std::wstring Format(const std::wstring& format, int number, std::wstring_view name = {},
+                    int count = 0, int monitor = 0) {
+    FormatValues values;
+    values.number = number;
+    values.name = name;
+    values.count = count;
+    values.monitor = monitor;
+    return FormatTemplate(format).Render(values);
+}
+
+}  // namespace
+
+TEST(Fields) {
+    CHECK_EQ(Format(L"Desktop {number}", 3), L"Desktop 3");
+    CHECK_EQ(Format(L"{number}/{count} {name}", 2, L"Mail", 5), L"2/5 Mail");
+    CHECK_EQ(Format(L"{prev} < {number} > {next}", 2, {}, 5), L"1 < 2 > 3");
+    CHECK_EQ(Format(L"Monitor {monitor}", 1, {}, 0, 2), L"Monitor 2");
+    CHECK_EQ(Format(L"", 1), L"");
+}
+
+TEST(EmptyFieldsRenderNothing) {
+    CHECK_EQ(Format(L"[{prev}]", 1, {}, 4), L"[]");                   // First desktop
+    CHECK_EQ(Format(L"[{next}]", 4, {}, 4), L"[]");                   // Last desktop
+    CHECK_EQ(Format(L"[{next}|{count}]", 2), L"[|]");                 // Count unknown
+    CHECK_EQ(Format(L"[{monitor}]", 2), L"[]");
+}
+
+TEST(EscapedBraces) {
+    CHECK_EQ(Format(L"{{number}}", 3), L"{number}");
+    CHECK_EQ(Format(L"{{{number}}}", 3), L"{3}");
+    CHECK_EQ(Format(L"{{", 3), L"{");
+    CHECK_EQ(Format(L"}}", 3), L"}");
+    CHECK_EQ(Format(L"a{{b}}c", 3), L"a{b}c");
+    CHECK_EQ(Format(L"{{?{name}}}", 3, L"x"), L"{?x}");
+}
+
+TEST(MalformedTokensStayLiteral) {
+    CHECK_EQ(Format(L"{desktop}", 3), L"{desktop}");
+    CHECK_EQ(Format(L"{number", 3), L"{number");
+    CHECK_EQ(Format(L"{number:", 3), L"{number:");
+    CHECK_EQ(Format(L"a{b{number}", 3), L"a{b3");
+    CHECK_EQ(Format(L"{number}}", 3), L"3}");
+    CHECK_EQ(Format(L"}{", 3), L"}{");
+    CHECK_EQ(Format(L"{}", 3), L"{}");
+}
+
+TEST(ZeroPadding) {
+    CHECK_EQ(Format(L"{number:02}", 3), L"03");
+    CHECK_EQ(Format(L"{number:02}", 12), L"12");
+    CHECK_EQ(Format(L"{number:02}", 123), L"123");     // Width is a minimum
+    CHECK_EQ(Format(L"{count:03}", 1, {}, 7), L"007");
+    CHECK_EQ(Format(L"{number:016}", 5), L"0000000000000005");
+    CHECK_EQ(Format(L"{number:02}", -3), L"-03");
+}
+
+TEST(BadPaddingIsLiteral) {
+    CHECK_EQ(Format(L"{number:2}", 3), L"{number:2}");      // printf style needs the 0
+    CHECK_EQ(Format(L"{number:00}", 3), L"{number:00}");
+    CHECK_EQ(Format(L"{number:017}", 3), L"{number:017}");  // Over MAX_WIDTH
+    CHECK_EQ(Format(L"{number:0x}", 3), L"{number:0x}");
+    CHECK_EQ(Format(L"{number:0002}", 3), L"{number:0002}");
+    CHECK_EQ(Format(L"{name:02}", 3, L"Mail"), L"{name:02}");  // Only numbers pad
+}
+
+TEST(Sections) {
+    const std::wstring format = L"{number}{? ({name})}";
+    CHECK_EQ(Format(format, 2, L"Mail"), L"2 (Mail)");
+    CHECK_EQ(Format(format, 2), L"2");
+
+    // A section only looks at the fields directly inside it
+    const std::wstring nested = L"{number}{? ({?{name} on }{monitor})}";
+    CHECK_EQ(Format(nested, 3, L"M", 0, 2), L"3 (M on 2)");
+    CHECK_EQ(Format(nested, 3, {}, 0, 2), L"3 (2)");
+    CHECK_EQ(Format(nested, 3, L"M", 0, 0), L"3");
+
+    CHECK_EQ(Format(L"{?}", 3), L"");
+    CHECK_EQ(Format(L"{?text only}", 3), L"text only");
+}
+
+TEST(UnterminatedSectionRunsToTheEnd) {
+    CHECK_EQ(Format(L"{number}{?: {name}", 1, L"Mail"), L"1: Mail");
+    CHECK_EQ(Format(L"{number}{?: {name}", 1), L"1");
+    CHECK_EQ(Format(L"{?", 1), L"");
+    CHECK_EQ(Format(L"{number}{? of {count}{? on {monitor}", 1, {}, 4, 0), L"1 of 4");
+}
+
+TEST(SectionDepthLimit) {
+    // MAX_SECTION_DEPTH sections nest; one more "{?" is plain text
+    std::wstring format;
+    for (int i = 0; i < FormatTemplate::MAX_SECTION_DEPTH; i++) format += L"{?";
+    format += L"{name}";
+    for (int i = 0; i < FormatTemplate::MAX_SECTION_DEPTH; i++) format += L"} ";
+    CHECK_EQ(Format(format, 1, L"n"), L"n" + std::wstring(FormatTemplate::MAX_SECTION_DEPTH, L' '));
+    // Only the innermost section holds {name} directly
+    CHECK_EQ(Format(format, 1), std::wstring(FormatTemplate::MAX_SECTION_DEPTH, L' '));
+
+    CHECK_EQ(Format(L"{?{?{?{?{?{?{?{?{?x", 1), L"{?x");
+}
+
+TEST(ImplicitNameSection) {
+    // Without sections, ": " before a trailing {name} is dropped with the name
+    CHECK_EQ(Format(L"{number}: {name}", 1, L"Mail"), L"1: Mail");
+    CHECK_EQ(Format(L"{number}: {name}", 1), L"1");
+    CHECK_EQ(Format(L"Desktop {number:02}: {name}", 4), L"Desktop 04");
+    CHECK_EQ(Format(L": {name}", 1), L"");
+    CHECK_EQ(Format(L": {name}", 1, L"x"), L": x");
+
+    // Only for a trailing name after exactly ": "
+    CHECK_EQ(Format(L"{number}: {name}!", 1), L"1: !");
+    CHECK_EQ(Format(L"{number} - {name}", 1), L"1 - ");
+    CHECK_EQ(Format(L"{name}: {number}", 1), L": 1");
+
+    // An explicit section anywhere turns it off
+    CHECK_EQ(Format(L"{?[{monitor}] }{number}: {name}", 2, {}, 0, 1), L"[1] 2: ");
+}
+
+TEST(RenderReusesOutput) {
+    FormatTemplate format(L"{number}: {name}");
+    CHECK_EQ(format.GetSource(), L"{number}: {name}");
+
+    FormatValues values;
+    values.number = 7;
+    values.name = L"Build";
+    std::wstring out = L"previous contents that are longer";
+    format.Render(values, out);
+    CHECK_EQ(out, L"7: Build");
+
+    format.Compile(L"#{number}");
+    format.Render(values, out);
+    CHECK_EQ(out, L"#7");
+}
+
+TEST(NameIsNotReinterpreted) {
+    CHECK_EQ(Format(L"{number}: {name}", 1, L"{number} {{x}}"), L"1: {number} {{x}}");
+}
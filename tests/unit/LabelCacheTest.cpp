@@ -0,0 +1,185 @@
+#include "Test.h"
+#include "overlay/LabelCache.h"
+
+using namespace VirtualOverlay;
+
+namespace {
+
+LabelKey MakeKey(const std::wstring& text, int width = 10, int height = 10) {
+    LabelKey key;
+    key.text = text;
+    key.style.fontFamily = L"Segoe UI";
+    key.style.fontSize = 24;
+    key.style.fontWeight = 600;
+    key.style.color = 0xFFFFFF;
+    key.width = width;
+    key.height = height;
+    return key;
+}
+
+LabelBitmap MakeBitmap(int width, int height, uint32_t fill = 0xFF000000) {
+    LabelBitmap bitmap;
+    bitmap.width = width;
+    bitmap.height = height;
+    bitmap.pixels.assign(static_cast<size_t>(width) * height, fill);
+    return bitmap;
+}
+
+// 10 x 10 BGRA = 400 bytes per entry
+const size_t ENTRY_BYTES = 400;
+
+}  // namespace
+
+TEST(MissInsertHit) {
+    LabelCache cache;
+    LabelKey key = MakeKey(L"1: Main");
+    CHECK(cache.Find(key) == nullptr);
+
+    const LabelBitmap* stored = cache.Insert(key, MakeBitmap(10, 10, 0x80402010));
+    REQUIRE(stored != nullptr);
+    const LabelBitmap* found = cache.Find(key);
+    REQUIRE(found == stored);
+    CHECK_EQ(found->pixels[99], 0x80402010u);
+
+    CHECK_EQ(cache.GetStats().hits, 1u);
+    CHECK_EQ(cache.GetStats().misses, 1u);
+    CHECK_EQ(cache.GetStats().inserts, 1u);
+    CHECK_EQ(cache.GetStats().bytes, ENTRY_BYTES);
+}
+
+TEST(EveryStyleFieldIsPartOfTheKey) {
+    LabelCache cache;
+    LabelKey base = MakeKey(L"2: Mail");
+    cache.Insert(base, MakeBitmap(10, 10));
+
+    std::vector<LabelKey> variants(12, base);
+    variants[0].text = L"2: mail";
+    variants[1].style.fontFamily = L"Consolas";
+    variants[2].style.fontSize = 25;
+    variants[3].style.fontWeight = 700;
+    variants[4].style.color = 0xFFFFFE;
+    variants[5].style.opacity = 0.5f;
+    variants[6].style.outlineWidth = 1;
+    variants[7].style.glowRadius = 4;
+    variants[8].style.distanceField = true;
+    variants[9].style.padding = 2;
+    variants[10].width = 11;
+    variants[11].height = 11;
+    for (const LabelKey& variant : variants) {
+        CHECK(variant != base);
+        CHECK(!cache.Contains(variant));
+    }
+
+    LabelKey same = MakeKey(L"2: Mail");
+    CHECK(same == base);
+    CHECK_EQ(LabelKeyHash()(same), LabelKeyHash()(base));
+    CHECK(cache.Contains(same));
+}
+
+TEST(EvictsLeastRecentlyUsed) {
+    LabelCache cache(3 * ENTRY_BYTES);
+    cache.Insert(MakeKey(L"a"), MakeBitmap(10, 10));
+    cache.Insert(MakeKey(L"b"), MakeBitmap(10, 10));
+    cache.Insert(MakeKey(L"c"), MakeBitmap(10, 10));
+
+    // Touch a: b becomes the oldest
+    CHECK(cache.Find(MakeKey(L"a")) != nullptr);
+    cache.Insert(MakeKey(L"d"), MakeBitmap(10, 10));
+
+    CHECK(cache.Contains(MakeKey(L"a")));
+    CHECK(!cache.Contains(MakeKey(L"b")));
+    CHECK(cache.Contains(MakeKey(L"c")));
+    CHECK(cache.Contains(MakeKey(L"d")));
+    CHECK_EQ(cache.GetStats().evictions, 1u);
+    CHECK_EQ(cache.GetStats().bytes, 3 * ENTRY_BYTES);
+}
+
+TEST(ContainsDoesNotRefreshOrCount) {
+    LabelCache cache(2 * ENTRY_BYTES);
+    cache.Insert(MakeKey(L"a"), MakeBitmap(10, 10));
+    cache.Insert(MakeKey(L"b"), MakeBitmap(10, 10));
+
+    CHECK(cache.Contains(MakeKey(L"a")));
+    CHECK_EQ(cache.GetStats().hits, 0u);
+    CHECK_EQ(cache.GetStats().misses, 0u);
+
+    // a is still the oldest
+    cache.Insert(MakeKey(L"c"), MakeBitmap(10, 10));
+    CHECK(!cache.Contains(MakeKey(L"a")));
+    CHECK(cache.Contains(MakeKey(L"b")));
+}
+
+TEST(LargeInsertEvictsSeveral) {
+    LabelCache cache(4 * ENTRY_BYTES);
+    for (const wchar_t* text : { L"a", L"b", L"c", L"d" }) {
+        cache.Insert(MakeKey(text), MakeBitmap(10, 10));
+    }
+    // 30 x 10 needs three entries' worth
+    CHECK(cache.Insert(MakeKey(L"wide", 30, 10), MakeBitmap(30, 10)) != nullptr);
+    CHECK_EQ(cache.GetCount(), 2u);
+    CHECK(cache.Contains(MakeKey(L"d")));
+    CHECK_EQ(cache.GetStats().evictions, 3u);
+    CHECK_EQ(cache.GetStats().bytes, 4 * ENTRY_BYTES);
+}
+
+TEST(OversizedBitmapIsRejected) {
+    LabelCache cache(ENTRY_BYTES);
+    cache.Insert(MakeKey(L"a"), MakeBitmap(10, 10));
+    CHECK(cache.Insert(MakeKey(L"big", 11, 10), MakeBitmap(11, 10)) == nullptr);
+    CHECK_EQ(cache.GetStats().rejected, 1u);
+    CHECK(cache.Contains(MakeKey(L"a")));  // Nothing evicted for it
+    CHECK_EQ(cache.GetStats().evictions, 0u);
+}
+
+TEST(ReinsertReplacesEntry) {
+    LabelCache cache(2 * ENTRY_BYTES);
+    LabelKey key = MakeKey(L"a");
+    cache.Insert(key, MakeBitmap(10, 10, 1));
+    cache.Insert(MakeKey(L"b"), MakeBitmap(10, 10));
+    const LabelBitmap* replaced = cache.Insert(key, MakeBitmap(10, 10, 2));
+    REQUIRE(replaced != nullptr);
+    CHECK_EQ(replaced->pixels[0], 2u);
+    CHECK_EQ(cache.GetCount(), 2u);
+    CHECK_EQ(cache.GetStats().bytes, 2 * ENTRY_BYTES);
+    CHECK_EQ(cache.GetStats().evictions, 0u);
+}
+
+TEST(ShrinkingTheBudgetEvicts) {
+    LabelCache cache(4 * ENTRY_BYTES);
+    for (const wchar_t* text : { L"a", L"b", L"c", L"d" }) {
+        cache.Insert(MakeKey(text), MakeBitmap(10, 10));
+    }
+    cache.SetBudget(ENTRY_BYTES + ENTRY_BYTES / 2);
+    CHECK_EQ(cache.GetCount(), 1u);
+    CHECK(cache.Contains(MakeKey(L"d")));
+    CHECK_EQ(cache.GetStats().bytes, ENTRY_BYTES);
+}
+
+TEST(ZeroBudgetDisablesTheCache) {
+    LabelCache cache(0);
+    CHECK(cache.Insert(MakeKey(L"a"), MakeBitmap(10, 10)) == nullptr);
+    CHECK(cache.Find(MakeKey(L"a")) == nullptr);
+    CHECK_EQ(cache.GetCount(), 0u);
+    CHECK_EQ(cache.GetStats().bytes, 0u);
+
+    // Turning the cache off drops what it held
+    LabelCache enabled(ENTRY_BYTES);
+    enabled.Insert(MakeKey(L"a"), MakeBitmap(10, 10));
+    enabled.SetBudget(0);
+    CHECK_EQ(enabled.GetCount(), 0u);
+}
+
+TEST(ClearAndResetStats) {
+    LabelCache cache;
+    cache.Insert(MakeKey(L"a"), MakeBitmap(10, 10));
+    cache.Find(MakeKey(L"a"));
+    cache.ResetStats();
+    CHECK_EQ(cache.GetStats().hits, 0u);
+    CHECK_EQ(cache.GetStats().inserts, 0u);
+    CHECK_EQ(cache.GetStats().bytes, ENTRY_BYTES);  // Bytes describe the contents
+
+    cache.Clear();
+    CHECK_EQ(cache.GetCount(), 0u);
+    CHECK_EQ(cache.GetStats().bytes, 0u);
+    CHECK(!cache.Contains(MakeKey(L"a")));
+}
@@ -0,0 +1,212 @@
+#include "Test.h"
+#include "overlay/MaskFilter.h"
+#include <algorithm>
+#include <random>
+
+using namespace VirtualOverlay;
+
+namespace {
+
+// Kernels this CPU can run besides the scalar reference
+std::vector<MaskKernel> SimdKernels() {
+    std::vector<MaskKernel> kernels;
+    MaskKernel best = GetBestMaskKernel();
+    if (best == MaskKernel::Sse2 || best == MaskKernel::Avx2) kernels.push_back(MaskKernel::Sse2);
+    if (best == MaskKernel::Avx2) kernels.push_back(MaskKernel::Avx2);
+    return kernels;
+}
+
+std::vector<uint8_t> RandomMask(std::mt19937& rng, int width, int height) {
+    std::vector<uint8_t> mask(static_cast<size_t>(width) * height);
+    // Mostly empty with saturated and anti-aliased runs, like text coverage
+    for (uint8_t& value : mask) {
+        uint32_t r = rng() % 8;
+        value = r < 5 ? 0 : r == 5 ? 255 : static_cast<uint8_t>(rng());
+    }
+    return mask;
+}
+
+// Max over the (2r+1)^2 square, straight from the definition
+std::vector<uint8_t> BruteForceDilate(const std::vector<uint8_t>& src, int width, int height, int radius) {
+    std::vector<uint8_t> dst(src.size());
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            uint8_t value = 0;
+            for (int dy = -radius; dy <= radius; dy++) {
+                for (int dx = -radius; dx <= radius; dx++) {
+                    int sx = x + dx;
+                    int sy = y + dy;
+                    if (sx >= 0 && sx < width && sy >= 0 && sy < height) {
+                        value = std::max(value, src[static_cast<size_t>(sy) * width + sx]);
+                    }
+                }
+            }
+            dst[static_cast<size_t>(y) * width + x] = value;
+        }
+    }
+    return dst;
+}
+
+// Horizontal then vertical window mean, rounded after each pass
+std::vector<uint8_t> BruteForceBlur(const std::vector<uint8_t>& src, int width, int height, int radius) {
+    int size = 2 * radius + 1;
+    auto mean = [&](uint32_t sum) { return static_cast<uint8_t>((sum + size / 2) / size); };
+    std::vector<uint8_t> horizontal(src.size());
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            uint32_t sum = 0;
+            for (int dx = -radius; dx <= radius; dx++) {
+                int sx = x + dx;
+                if (sx >= 0 && sx < width) sum += src[static_cast<size_t>(y) * width + sx];
+            }
+            horizontal[static_cast<size_t>(y) * width + x] = mean(sum);
+        }
+    }
+    std::vector<uint8_t> dst(src.size());
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            uint32_t sum = 0;
+            for (int dy = -radius; dy <= radius; dy++) {
+                int sy = y + dy;
+                if (sy >= 0 && sy < height) sum += horizontal[static_cast<size_t>(sy) * width + x];
+            }
+            dst[static_cast<size_t>(y) * width + x] = mean(sum);
+        }
+    }
+    return dst;
+}
+
+int MaxDifference(const std::vector<uint8_t>& a, const std::vector<uint8_t>& b) {
+    int worst = 0;
+    for (size_t i = 0; i < a.size(); i++) {
+        worst = std::max(worst, std::abs(a[i] - b[i]));
+    }
+    return worst;
+}
+
+// Widths around the 16 and 32 byte vector sizes so every tail length runs
+const int WIDTHS[] = { 1, 2, 7, 15, 16, 17, 31, 32, 33, 47, 64, 65, 100 };
+
+}  // namespace
+
+TEST(DilateScalarMatchesBruteForce) {
+    std::mt19937 rng(1);
+    for (int width : WIDTHS) {
+        for (int radius : { 1, 2, 3, 5, MAX_DILATE_RADIUS }) {
+            int height = 1 + static_cast<int>(rng() % 24);
+            std::vector<uint8_t> src = RandomMask(rng, width, height);
+            std::vector<uint8_t> dst(src.size());
+            DilateMask(src.data(), dst.data(), width, height, radius, MaskKernel::Scalar);
+            CHECK(dst == BruteForceDilate(src, width, height, radius));
+        }
+    }
+}
+
+TEST(DilateSimdMatchesScalar) {
+    std::mt19937 rng(2);
+    for (MaskKernel kernel : SimdKernels()) {
+        for (int width : WIDTHS) {
+            for (int radius = 1; radius <= MAX_DILATE_RADIUS; radius++) {
+                int height = 1 + static_cast<int>(rng() % 40);
+                std::vector<uint8_t> src = RandomMask(rng, width, height);
+                std::vector<uint8_t> expected(src.size());
+                std::vector<uint8_t> actual(src.size());
+                DilateMask(src.data(), expected.data(), width, height, radius, MaskKernel::Scalar);
+                DilateMask(src.data(), actual.data(), width, height, radius, kernel);
+                if (expected != actual) {
+                    CHECK_EQ(std::string(MaskKernelToString(kernel)) + " w=" + std::to_string(width) +
+                             " r=" + std::to_string(radius), std::string("identical"));
+                }
+            }
+        }
+    }
+}
+
+TEST(DilateRadiusZeroAndClamp) {
+    std::mt19937 rng(3);
+    std::vector<uint8_t> src = RandomMask(rng, 40, 40);
+    std::vector<uint8_t> dst(src.size());
+    DilateMask(src.data(), dst.data(), 40, 40, 0);
+    CHECK(dst == src);
+    DilateMask(src.data(), dst.data(), 40, 40, -3);
+    CHECK(dst == src);
+
+    std::vector<uint8_t> clamped(src.size());
+    DilateMask(src.data(), dst.data(), 40, 40, 100);
+    DilateMask(src.data(), clamped.data(), 40, 40, MAX_DILATE_RADIUS);
+    CHECK(dst == clamped);
+}
+
+TEST(DilateSinglePixelGrowsToSquare) {
+    const int size = 9;
+    std::vector<uint8_t> src(size * size, 0);
+    src[4 * size + 4] = 200;
+    std::vector<uint8_t> dst(src.size());
+    DilateMask(src.data(), dst.data(), size, size, 2);
+    int lit = 0;
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+            bool inside = std::abs(x - 4) <= 2 && std::abs(y - 4) <= 2;
+            CHECK_EQ(dst[y * size + x], inside ? 200 : 0);
+            lit += dst[y * size + x] != 0;
+        }
+    }
+    CHECK_EQ(lit, 25);
+}
+
+TEST(BlurScalarMatchesBruteForce) {
+    // The kernels divide by a fixed-point reciprocal, which may round up by
+    // one against the exact mean in each pass
+    std::mt19937 rng(4);
+    for (int width : WIDTHS) {
+        for (int radius : { 1, 2, 4, 9, MAX_BLUR_RADIUS }) {
+            int height = 1 + static_cast<int>(rng() % 24);
+            std::vector<uint8_t> src = RandomMask(rng, width, height);
+            std::vector<uint8_t> blurred = src;
+            BlurMask(blurred.data(), width, height, radius, MaskKernel::Scalar);
+            CHECK(MaxDifference(blurred, BruteForceBlur(src, width, height, radius)) <= 2);
+        }
+    }
+}
+
+TEST(BlurSimdMatchesScalar) {
+    std::mt19937 rng(5);
+    for (MaskKernel kernel : SimdKernels()) {
+        for (int width : WIDTHS) {
+            for (int radius : { 1, 2, 3, 4, 7, 8, 16, 33, MAX_BLUR_RADIUS }) {
+                int height = 1 + static_cast<int>(rng() % 80);
+                std::vector<uint8_t> expected = RandomMask(rng, width, height);
+                std::vector<uint8_t> actual = expected;
+                BlurMask(expected.data(), width, height, radius, MaskKernel::Scalar);
+                BlurMask(actual.data(), width, height, radius, kernel);
+                if (expected != actual) {
+                    CHECK_EQ(std::string(MaskKernelToString(kernel)) + " w=" + std::to_string(width) +
+                             " r=" + std::to_string(radius), std::string("identical"));
+                }
+            }
+        }
+    }
+}
+
+TEST(BlurOfSolidMaskKeepsInterior) {
+    const int width = 48;
+    const int height = 20;
+    std::vector<uint8_t> mask(width * height, 255);
+    BlurMask(mask.data(), width, height, 3);
+    // Away from the edges the window is all 255; at a corner it is a quarter
+    // of the window or more
+    CHECK_EQ(mask[10 * width + 24], 255);
+    CHECK(mask[0] >= 64 && mask[0] < 255);
+}
+
+TEST(AutoResolvesToBestKernel) {
+    MaskKernel best = GetBestMaskKernel();
+    CHECK(best != MaskKernel::Auto);
+    std::mt19937 rng(6);
+    std::vector<uint8_t> src = RandomMask(rng, 70, 30);
+    std::vector<uint8_t> automatic(src.size());
+    std::vector<uint8_t> explicitBest(src.size());
+    DilateMask(src.data(), automatic.data(), 70, 30, 2);
+    DilateMask(src.data(), explicitBest.data(), 70, 30, 2, best);
+    CHECK(automatic == explicitBest);
+}
@@ -0,0 +1,178 @@
+#include "Test.h"
+#include "overlay/PixelKernels.h"
+#include <cmath>
+#include <random>
+
+using namespace VirtualOverlay;
+
+namespace {
+
+// Kernels this CPU can run besides the scalar reference
+std::vector<PixelKernel> SimdKernels() {
+    std::vector<PixelKernel> kernels;
+    PixelKernel best = GetBestPixelKernel();
+    if (best == PixelKernel::Sse41 || best == PixelKernel::Avx2) kernels.push_back(PixelKernel::Sse41);
+    if (best == PixelKernel::Avx2) kernels.push_back(PixelKernel::Avx2);
+    return kernels;
+}
+
+uint32_t Channel(uint32_t pixel, int shift) { return (pixel >> shift) & 0xFF; }
+
+// Exact rounded c * f / 255 (no ties: 255 is odd)
+uint32_t Scale(uint32_t c, uint32_t f) {
+    return static_cast<uint32_t>(std::lround(c * f / 255.0));
+}
+
+uint32_t RandomPremultiplied(std::mt19937& rng) {
+    uint32_t a = rng() % 4 == 0 ? 255 : rng() % 256;
+    uint32_t pixel = a << 24;
+    for (int shift = 0; shift < 24; shift += 8) {
+        pixel |= (a ? rng() % (a + 1) : 0) << shift;
+    }
+    return pixel;
+}
+
+std::vector<uint8_t> RandomCoverage(std::mt19937& rng, size_t count) {
+    std::vector<uint8_t> coverage(count);
+    for (uint8_t& c : coverage) {
+        uint32_t r = rng() % 4;
+        c = r == 0 ? 0 : r == 1 ? 255 : static_cast<uint8_t>(rng());
+    }
+    return coverage;
+}
+
+std::string Where(PixelKernel kernel, size_t count) {
+    return std::string(PixelKernelToString(kernel)) + " n=" + std::to_string(count);
+}
+
+}  // namespace
+
+TEST(ScalarScaleIsExactlyRounded) {
+    // Every channel value against every coverage
+    std::vector<uint8_t> coverage(256);
+    for (int f = 0; f < 256; f++) coverage[f] = static_cast<uint8_t>(f);
+    std::vector<uint32_t> dst(256);
+    for (uint32_t c = 0; c < 256; c++) {
+        uint32_t color = (c << 24) | (c << 16) | (c << 8) | c;
+        ColorizeMask(coverage.data(), dst.data(), dst.size(), color, PixelKernel::Scalar);
+        for (uint32_t f = 0; f < 256; f++) {
+            if (Channel(dst[f], 0) != Scale(c, f) || Channel(dst[f], 24) != Scale(c, f)) {
+                CHECK_EQ(Channel(dst[f], 0), Scale(c, f));
+                return;
+            }
+        }
+    }
+}
+
+TEST(ScalarOverMatchesDefinition) {
+    std::mt19937 rng(16);
+    for (int i = 0; i < 20000; i++) {
+        uint32_t src = RandomPremultiplied(rng);
+        uint32_t dst = RandomPremultiplied(rng);
+        uint32_t result = dst;
+        BlendOver(&src, &result, 1, PixelKernel::Scalar);
+        for (int shift = 0; shift < 32; shift += 8) {
+            uint32_t expected = Channel(src, shift) + Scale(Channel(dst, shift), 255 - (src >> 24));
+            CHECK_EQ(Channel(result, shift), expected);
+        }
+        // Premultiplied in, premultiplied out
+        CHECK(Channel(result, 16) <= (result >> 24) && Channel(result, 0) <= (result >> 24));
+    }
+}
+
+TEST(PremultiplyColor) {
+    CHECK_EQ(PremultiplyColor(0x336699, 255), 0xFF336699u);
+    CHECK_EQ(PremultiplyColor(0xFFFFFF, 0), 0u);
+    CHECK_EQ(PremultiplyColor(0xFF8000, 128), 0x80804000u);
+    CHECK_EQ(PremultiplyColor(0xFF123456, 255), 0xFF123456u);  // Input alpha is ignored
+}
+
+TEST(SimdMatchesScalar) {
+    std::mt19937 rng(17);
+    for (PixelKernel kernel : SimdKernels()) {
+        // Every tail length around the 4 and 8 pixel steps, at an unaligned start
+        for (size_t count = 0; count <= 70; count++) {
+            std::vector<uint8_t> coverage = RandomCoverage(rng, count + 1);
+            std::vector<uint32_t> src(count + 1);
+            std::vector<uint32_t> base(count + 1);
+            for (size_t i = 0; i <= count; i++) {
+                src[i] = RandomPremultiplied(rng);
+                base[i] = RandomPremultiplied(rng);
+            }
+            uint32_t color = RandomPremultiplied(rng);
+            uint8_t opacity = static_cast<uint8_t>(rng() % 255);
+
+            std::vector<uint32_t> expected = base;
+            std::vector<uint32_t> actual = base;
+            ColorizeMask(coverage.data() + 1, expected.data() + 1, count, color, PixelKernel::Scalar);
+            ColorizeMask(coverage.data() + 1, actual.data() + 1, count, color, kernel);
+            if (expected != actual) CHECK_EQ("colorize " + Where(kernel, count), std::string("identical"));
+
+            expected = actual = base;
+            BlendMask(coverage.data() + 1, expected.data() + 1, count, color, PixelKernel::Scalar);
+            BlendMask(coverage.data() + 1, actual.data() + 1, count, color, kernel);
+            if (expected != actual) CHECK_EQ("blend mask " + Where(kernel, count), std::string("identical"));
+
+            expected = actual = base;
+            ScalePixels(expected.data() + 1, count, opacity, PixelKernel::Scalar);
+            ScalePixels(actual.data() + 1, count, opacity, kernel);
+            if (expected != actual) CHECK_EQ("scale " + Where(kernel, count), std::string("identical"));
+
+            expected = actual = base;
+            BlendOver(src.data() + 1, expected.data() + 1, count, PixelKernel::Scalar);
+            BlendOver(src.data() + 1, actual.data() + 1, count, kernel);
+            if (expected != actual) CHECK_EQ("over " + Where(kernel, count), std::string("identical"));
+        }
+    }
+}
+
+TEST(SimdSaturatesLikeScalar) {
+    // Not premultiplied (color > alpha): the sums overflow a byte, and every
+    // path must clamp the same way
+    std::mt19937 rng(18);
+    std::vector<uint32_t> src(64);
+    std::vector<uint32_t> base(64);
+    for (size_t i = 0; i < src.size(); i++) {
+        src[i] = rng();
+        base[i] = rng();
+    }
+    for (PixelKernel kernel : SimdKernels()) {
+        std::vector<uint32_t> expected = base;
+        std::vector<uint32_t> actual = base;
+        BlendOver(src.data(), expected.data(), src.size(), PixelKernel::Scalar);
+        BlendOver(src.data(), actual.data(), src.size(), kernel);
+        CHECK(expected == actual);
+    }
+}
+
+TEST(BlendMaskSkipsZeroCoverage) {
+    std::vector<uint8_t> coverage(40, 0);
+    coverage[5] = 255;
+    std::vector<uint32_t> dst(40, 0x80FF0000);  // Invalid on purpose: must stay untouched
+    for (PixelKernel kernel : { PixelKernel::Scalar, PixelKernel::Auto }) {
+        std::vector<uint32_t> pixels = dst;
+        BlendMask(coverage.data(), pixels.data(), pixels.size(), 0xFF00FF00, kernel);
+        CHECK_EQ(pixels[5], 0xFF00FF00u);
+        CHECK_EQ(pixels[4], 0x80FF0000u);
+        CHECK_EQ(pixels[39], 0x80FF0000u);
+    }
+}
+
+TEST(ScaleEndpoints) {
+    std::vector<uint32_t> pixels(33, 0xFF804020);
+    ScalePixels(pixels.data(), pixels.size(), 255);
+    CHECK_EQ(pixels[32], 0xFF804020u);
+    ScalePixels(pixels.data(), pixels.size(), 0);
+    CHECK_EQ(pixels[0], 0u);
+    CHECK_EQ(pixels[32], 0u);
+}
+
+TEST(OverEndpoints) {
+    std::vector<uint32_t> opaque(17, 0xFF112233);
+    std::vector<uint32_t> clear(17, 0);
+    std::vector<uint32_t> dst(17, 0x80402010);
+    BlendOver(clear.data(), dst.data(), dst.size());
+    CHECK_EQ(dst[16], 0x80402010u);
+    BlendOver(opaque.data(), dst.data(), dst.size());
+    CHECK_EQ(dst[16], 0xFF112233u);
+}
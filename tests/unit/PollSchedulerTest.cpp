@@ -0,0 +1,246 @@
+#include "Test.h"
+#include "desktop/PollScheduler.h"
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace VirtualOverlay;
+
+namespace {
+
+// Explorer updates the registry this long after the keystroke
+constexpr uint64_t SWITCH_LANDS_AFTER_MS = 40;
+
+// The legacy fixed poll
+constexpr uint32_t FIXED_PERIOD_MS = 150;
+
+enum class TimelineKind {
+    Activity,       // Foreground change
+    Gesture,        // Win+Ctrl chord or Task View opening / closing
+    Switch          // The registry now names another desktop
+};
+
+struct TimelineEvent {
+    uint64_t atMs;
+    TimelineKind kind;
+    uint64_t causeMs;   // Switch: when the user asked for it
+    bool hotkey;        // Switch: by Win+Ctrl+Left/Right
+};
+
+struct ReplayResult {
+    uint64_t wakeups = 0;
+    uint64_t hotkeySwitches = 0;
+    uint64_t hotkeyLatencySumMs = 0;
+    uint64_t hotkeyLatencyMaxMs = 0;
+    uint64_t otherSwitches = 0;
+    uint64_t otherLatencySumMs = 0;
+    uint64_t otherLatencyMaxMs = 0;
+
+    double HotkeyMeanMs() const { return hotkeySwitches ? double(hotkeyLatencySumMs) / hotkeySwitches : 0.0; }
+    double OtherMeanMs() const { return otherSwitches ? double(otherLatencySumMs) / otherSwitches : 0.0; }
+};
+
+// Drives the poll the way App does: each poll reschedules itself after
+// GetPeriodMs, a gesture pulls the pending timer in, and a poll that finds
+// the registry changed reports the switch. Without a scheduler the period
+// is the legacy fixed one and gestures change nothing.
+ReplayResult Replay(const char* name, const std::vector<TimelineEvent>& timeline, uint64_t endMs,
+                    PollScheduler* scheduler) {
+    ReplayResult result;
+    std::vector<const TimelineEvent*> landed;
+    auto period = [&](uint64_t nowMs) { return scheduler ? scheduler->GetPeriodMs(nowMs) : FIXED_PERIOD_MS; };
+
+    uint64_t nextPollMs = period(0);
+    size_t next = 0;
+    while (nextPollMs <= endMs) {
+        if (next < timeline.size() && timeline[next].atMs <= nextPollMs) {
+            const TimelineEvent& ev = timeline[next++];
+            if (ev.kind == TimelineKind::Switch) {
+                landed.push_back(&ev);
+            } else if (scheduler && ev.kind == TimelineKind::Activity) {
+                scheduler->OnActivity(ev.atMs);
+            } else if (scheduler) {
+                scheduler->OnBurstTrigger(ev.atMs);
+                nextPollMs = ev.atMs + scheduler->GetPeriodMs(ev.atMs);
+            }
+            continue;
+        }
+
+        uint64_t nowMs = nextPollMs;
+        result.wakeups++;
+        for (const TimelineEvent* ev : landed) {
+            uint64_t latencyMs = nowMs - ev->causeMs;
+            if (ev->hotkey) {
+                result.hotkeySwitches++;
+                result.hotkeyLatencySumMs += latencyMs;
+                result.hotkeyLatencyMaxMs = std::max(result.hotkeyLatencyMaxMs, latencyMs);
+            } else {
+                result.otherSwitches++;
+                result.otherLatencySumMs += latencyMs;
+                result.otherLatencyMaxMs = std::max(result.otherLatencyMaxMs, latencyMs);
+            }
+        }
+        if (!landed.empty() && scheduler) {
+            scheduler->OnSwitchDetected(nowMs);
+        }
+        landed.clear();
+        nextPollMs = nowMs + period(nowMs);
+    }
+
+    std::printf("  %-9s %6llu wakeups; hotkey switch mean %5.1f ms, max %4llu ms; "
+                "other mean %5.1f ms, max %4llu ms\n", name,
+                static_cast<unsigned long long>(result.wakeups), result.HotkeyMeanMs(),
+                static_cast<unsigned long long>(result.hotkeyLatencyMaxMs), result.OtherMeanMs(),
+                static_cast<unsigned long long>(result.otherLatencyMaxMs));
+    return result;
+}
+
+// An hour at the desk: ten minutes of work with a foreground change every
+// few seconds and a Win+Ctrl+Arrow switch now and then, twenty minutes
+// away, and so on. Every fourth switch goes through Task View: a gesture
+// when it opens, another when it closes a second or two later, and the
+// switch lands after the second.
+std::vector<TimelineEvent> MakeWorkHour(uint64_t& endMs) {
+    std::mt19937 rng(9);
+    std::vector<TimelineEvent> timeline;
+    const uint64_t minute = 60 * 1000;
+    uint64_t t = 0;
+    for (int block = 0; block < 2; block++) {
+        uint64_t workEnd = t + 10 * minute;
+        int switches = 0;
+        while (t < workEnd) {
+            t += 2000 + rng() % 8000;
+            timeline.push_back({ t, TimelineKind::Activity, 0, false });
+            if (rng() % 3 == 0) {
+                uint64_t cause = t + 500 + rng() % 1000;
+                if (switches++ % 4 == 3) {
+                    timeline.push_back({ cause, TimelineKind::Gesture, 0, false });
+                    uint64_t close = cause + 1000 + rng() % 2000;
+                    timeline.push_back({ close, TimelineKind::Gesture, 0, false });
+                    timeline.push_back({ close + SWITCH_LANDS_AFTER_MS, TimelineKind::Switch, close, false });
+                } else {
+                    timeline.push_back({ cause, TimelineKind::Gesture, 0, false });
+                    timeline.push_back({ cause + SWITCH_LANDS_AFTER_MS, TimelineKind::Switch, cause, true });
+                }
+                t = cause + 5000;
+            }
+        }
+        t += 20 * minute;
+    }
+    endMs = t;
+    std::sort(timeline.begin(), timeline.end(),
+              [](const TimelineEvent& a, const TimelineEvent& b) { return a.atMs < b.atMs; });
+    return timeline;
+}
+
+}  // namespace
+
+TEST(StartsIdle) {
+    PollScheduler scheduler;
+    CHECK(scheduler.GetMode(0) == PollMode::Idle);
+    CHECK_EQ(scheduler.GetPeriodMs(0), 2000u);
+}
+
+TEST(ActivityThenIdle) {
+    PollScheduler scheduler;
+    scheduler.OnActivity(1000);
+    CHECK(scheduler.GetMode(1000) == PollMode::Active);
+    CHECK_EQ(scheduler.GetPeriodMs(30999), 150u);
+    CHECK(scheduler.GetMode(31000) == PollMode::Idle);
+}
+
+TEST(BurstEndsOnDetectedSwitch) {
+    PollScheduler scheduler;
+    scheduler.OnBurstTrigger(0);
+    CHECK(scheduler.GetMode(499) == PollMode::Burst);
+    CHECK_EQ(scheduler.GetPeriodMs(100), 16u);
+
+    scheduler.OnSwitchDetected(120);
+    CHECK(scheduler.GetMode(120) == PollMode::Active);
+    CHECK_EQ(scheduler.GetStats().bursts, 1u);
+    CHECK_EQ(scheduler.GetStats().burstsResolved, 1u);
+
+    // A switch after the burst ran out does not count as resolving it
+    scheduler.OnBurstTrigger(1000);
+    scheduler.OnSwitchDetected(1600);
+    CHECK_EQ(scheduler.GetStats().burstsResolved, 1u);
+}
+
+TEST(ClampsToTheConfigRanges) {
+    using Limits = PollScheduleConfig;
+
+    PollScheduleConfig low;
+    low.burstPeriodMs = 1;
+    low.activePeriodMs = 0;
+    low.idlePeriodMs = 0;
+    low.idleAfterMs = 0;
+    PollScheduler scheduler(low);
+    CHECK_EQ(scheduler.GetConfig().burstPeriodMs, Limits::MIN_BURST_PERIOD_MS);
+    CHECK_EQ(scheduler.GetConfig().activePeriodMs, Limits::MIN_BURST_PERIOD_MS);
+    CHECK_EQ(scheduler.GetConfig().idlePeriodMs, Limits::MIN_BURST_PERIOD_MS);
+    CHECK_EQ(scheduler.GetConfig().idleAfterMs, Limits::MIN_IDLE_AFTER_MS);
+
+    PollScheduleConfig high;
+    high.burstPeriodMs = 1000;
+    high.activePeriodMs = 60000;
+    high.idlePeriodMs = 60000;
+    high.burstDurationMs = 10000;
+    high.idleAfterMs = 0xFFFFFFFFu;
+    scheduler.SetConfig(high);
+    CHECK_EQ(scheduler.GetConfig().burstPeriodMs, Limits::MAX_BURST_PERIOD_MS);
+    CHECK_EQ(scheduler.GetConfig().activePeriodMs, Limits::MAX_ACTIVE_PERIOD_MS);
+    CHECK_EQ(scheduler.GetConfig().idlePeriodMs, Limits::MAX_IDLE_PERIOD_MS);
+    CHECK_EQ(scheduler.GetConfig().burstDurationMs, Limits::MAX_BURST_DURATION_MS);
+    CHECK_EQ(scheduler.GetConfig().idleAfterMs, Limits::MAX_IDLE_AFTER_MS);
+}
+
+TEST(DefaultsAreInRange) {
+    PollScheduleConfig defaults;
+    PollScheduler scheduler(defaults);
+    CHECK_EQ(scheduler.GetConfig().burstPeriodMs, defaults.burstPeriodMs);
+    CHECK_EQ(scheduler.GetConfig().activePeriodMs, defaults.activePeriodMs);
+    CHECK_EQ(scheduler.GetConfig().idlePeriodMs, defaults.idlePeriodMs);
+    CHECK_EQ(scheduler.GetConfig().burstDurationMs, defaults.burstDurationMs);
+    CHECK_EQ(scheduler.GetConfig().idleAfterMs, defaults.idleAfterMs);
+}
+
+TEST(ReplayedHourDetectsSoonerWithFewerWakeups) {
+    uint64_t endMs = 0;
+    std::vector<TimelineEvent> timeline = MakeWorkHour(endMs);
+
+    PollScheduler scheduler;
+    ReplayResult fixed = Replay("fixed", timeline, endMs, nullptr);
+    ReplayResult adaptive = Replay("adaptive", timeline, endMs, &scheduler);
+    REQUIRE(adaptive.hotkeySwitches == fixed.hotkeySwitches);
+    REQUIRE(adaptive.otherSwitches == fixed.otherSwitches);
+    CHECK(adaptive.hotkeySwitches > 20u);
+    CHECK(adaptive.otherSwitches > 5u);
+
+    // A hotkey switch is caught by the first burst poll after it lands
+    const PollScheduleConfig& config = scheduler.GetConfig();
+    CHECK(adaptive.hotkeyLatencyMaxMs <= SWITCH_LANDS_AFTER_MS + config.burstPeriodMs);
+    CHECK(adaptive.hotkeyLatencyMaxMs < fixed.HotkeyMeanMs());
+    CHECK(adaptive.OtherMeanMs() < fixed.OtherMeanMs());
+
+    // Every burst ended early. Work time polls at the legacy rate, the
+    // time away every 2 s once the 30 s idle delay has passed
+    CHECK_EQ(scheduler.GetStats().burstsResolved, adaptive.hotkeySwitches + adaptive.otherSwitches);
+    CHECK(adaptive.wakeups * 2 < fixed.wakeups);
+}
+
+TEST(ReplayedSwitchWithoutGestureWaitsForThePeriod) {
+    // A switch nobody announced (another tool, a script) is only found by
+    // the regular poll: within the active period while the user is around,
+    // within the idle period otherwise
+    PollScheduler scheduler;
+    std::vector<TimelineEvent> timeline = {
+        { 1000, TimelineKind::Activity, 0, false },
+        { 5070, TimelineKind::Switch, 5070, false },
+        { 100000, TimelineKind::Switch, 100000, false },
+    };
+    ReplayResult adaptive = Replay("adaptive", timeline, 110000, &scheduler);
+    REQUIRE(adaptive.otherSwitches == 2u);
+    CHECK(adaptive.otherLatencyMaxMs <= scheduler.GetConfig().idlePeriodMs);
+    CHECK_EQ(scheduler.GetStats().burstsResolved, 0u);
+}
@@ -0,0 +1,247 @@
+#include "Test.h"
+#include "BoxTextMasks.h"
+#include "overlay/MaskFilter.h"
+#include "overlay/RenderBackend.h"
+#include "overlay/SoftwareRenderBackend.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+using namespace VirtualOverlay;
+
+namespace {
+
+// Golden frames are binary PAM (RGB_ALPHA, premultiplied) under
+// tests/data/golden. Run with VO_UPDATE_GOLDEN=1 to rewrite them after an
+// intended rendering change, and look at the diff before committing.
+std::string GoldenPath(const std::string& name) {
+    return std::string(VO_TEST_DATA_DIR) + "/golden/" + name + ".pam";
+}
+
+void WritePam(const std::string& path, const uint32_t* pixels, int width, int height) {
+    std::ofstream file(path, std::ios::binary);
+    file << "P7\nWIDTH " << width << "\nHEIGHT " << height
+         << "\nDEPTH 4\nMAXVAL 255\nTUPLTYPE RGB_ALPHA\nENDHDR\n";
+    for (size_t i = 0; i < static_cast<size_t>(width) * height; i++) {
+        uint32_t p = pixels[i];
+        char rgba[4] = { static_cast<char>((p >> 16) & 0xFF), static_cast<char>((p >> 8) & 0xFF),
+                         static_cast<char>(p & 0xFF), static_cast<char>(p >> 24) };
+        file.write(rgba, 4);
+    }
+}
+
+bool ReadPam(const std::string& path, std::vector<uint32_t>& pixels, int& width, int& height) {
+    std::ifstream file(path, std::ios::binary);
+    std::string line;
+    width = height = 0;
+    while (std::getline(file, line) && line != "ENDHDR") {
+        std::istringstream fields(line);
+        std::string key;
+        fields >> key;
+        if (key == "WIDTH") fields >> width;
+        if (key == "HEIGHT") fields >> height;
+    }
+    if (!file || width <= 0 || height <= 0) {
+        return false;
+    }
+    pixels.resize(static_cast<size_t>(width) * height);
+    for (uint32_t& p : pixels) {
+        unsigned char rgba[4];
+        if (!file.read(reinterpret_cast<char*>(rgba), 4)) {
+            return false;
+        }
+        p = (static_cast<uint32_t>(rgba[3]) << 24) | (rgba[0] << 16) | (rgba[1] << 8) | rgba[2];
+    }
+    return true;
+}
+
+// Compares with the golden frame, allowing one step per channel for float
+// rounding differences between compilers
+void CheckGolden(const std::string& name, const SoftwareRenderBackend& backend) {
+    const char* update = std::getenv("VO_UPDATE_GOLDEN");
+    if (update && *update && *update != '0') {
+        WritePam(GoldenPath(name), backend.GetPixels(), backend.GetWidth(), backend.GetHeight());
+        return;
+    }
+
+    std::vector<uint32_t> golden;
+    int width = 0;
+    int height = 0;
+    if (!ReadPam(GoldenPath(name), golden, width, height)) {
+        CHECK_EQ(GoldenPath(name), std::string("a readable golden frame"));
+        return;
+    }
+    REQUIRE(width == backend.GetWidth() && height == backend.GetHeight());
+
+    int worst = 0;
+    size_t differing = 0;
+    for (size_t i = 0; i < golden.size(); i++) {
+        int pixelWorst = 0;
+        for (int shift = 0; shift < 32; shift += 8) {
+            int a = (golden[i] >> shift) & 0xFF;
+            int b = (backend.GetPixels()[i] >> shift) & 0xFF;
+            pixelWorst = std::max(pixelWorst, std::abs(a - b));
+        }
+        worst = std::max(worst, pixelWorst);
+        differing += pixelWorst > 0;
+    }
+    if (worst > 1) {
+        CHECK_EQ(name + ": " + std::to_string(differing) + " pixels differ, by up to " + std::to_string(worst),
+                 name + ": matches");
+    }
+}
+
+uint8_t Alpha(uint32_t pixel) { return static_cast<uint8_t>(pixel >> 24); }
+
+OverlayFrame NotificationFrame() {
+    OverlayFrame frame;
+    frame.width = 220;
+    frame.height = 64;
+    frame.cornerRadius = 12.0f;
+    frame.padding = 12.0f;
+    frame.background = RenderColor::FromRGB(0x1E1E2E, 0.85f);
+    frame.border = RenderColor::FromRGB(0x89B4FA);
+    frame.borderWidth = 2.0f;
+    frame.text = L"Desktop 2: Mail";
+    frame.textColor = RenderColor::FromRGB(0xFFFFFF);
+    return frame;
+}
+
+}  // namespace
+
+TEST(GoldenNotificationFrame) {
+    SoftwareRenderBackend backend(BoxTextMask);
+    REQUIRE(DrawOverlayFrame(backend, NotificationFrame()));
+    CheckGolden("notification", backend);
+}
+
+TEST(GoldenNotificationFadingIn) {
+    SoftwareRenderBackend backend(BoxTextMask);
+    OverlayFrame frame = NotificationFrame();
+    frame.slideOffset = 7.5f;
+    frame.opacity = 0.4f;
+    REQUIRE(DrawOverlayFrame(backend, frame));
+    CheckGolden("notification-fade", backend);
+}
+
+TEST(GoldenWatermarkFrame) {
+    const int width = 160;
+    const int height = 48;
+    std::vector<uint8_t> fill;
+    BoxTextMask(L"3: Code", width, height, fill);
+    std::vector<uint8_t> halo(fill.size());
+    DilateMask(fill.data(), halo.data(), width, height, 2, MaskKernel::Scalar);
+    BlurMask(halo.data(), width, height, 2, MaskKernel::Scalar);
+
+    WatermarkFrame frame;
+    frame.width = width;
+    frame.height = height;
+    frame.fill = fill.data();
+    frame.halo = halo.data();
+    frame.textColor = RenderColor::FromRGB(0xF5E0DC, 0.9f);
+    frame.haloColor = RenderColor::FromRGB(0x000000, 0.6f);
+
+    SoftwareRenderBackend backend;
+    REQUIRE(DrawWatermarkFrame(backend, frame));
+    CheckGolden("watermark", backend);
+}
+
+TEST(GoldenPrimitives) {
+    // Sub-pixel rectangles, a radius larger than fits, a hairline stroke and
+    // a mask clipped on two sides
+    SoftwareRenderBackend backend;
+    REQUIRE(backend.BeginFrame(96, 64));
+    backend.Clear(RenderColor::FromRGB(0x102030, 0.25f));
+    backend.FillRoundedRect({ 4.25f, 3.5f, 40.75f, 30.0f }, 6.0f, RenderColor::FromRGB(0xE64553));
+    backend.FillRoundedRect({ 50.0f, 4.0f, 90.0f, 20.0f }, 40.0f, RenderColor::FromRGB(0x40A02B, 0.5f));
+    backend.StrokeRoundedRect({ 8.5f, 36.5f, 60.5f, 60.5f }, 4.0f, 1.0f, RenderColor::FromRGB(0xFFFFFF));
+    backend.StrokeRoundedRect({ 30.0f, 10.0f, 70.0f, 50.0f }, 0.0f, 3.0f, RenderColor::FromRGB(0x1E66F5, 0.7f));
+
+    std::vector<uint8_t> ramp(24 * 24);
+    for (int y = 0; y < 24; y++) {
+        for (int x = 0; x < 24; x++) {
+            ramp[y * 24 + x] = static_cast<uint8_t>((x + y) * 255 / 46);
+        }
+    }
+    backend.DrawMask(ramp.data(), 24, 24, 80, -8, RenderColor::FromRGB(0xDF8E1D));
+    backend.DrawMask(ramp.data(), 24, 24, -10, 50, RenderColor::FromRGB(0xDF8E1D));
+    REQUIRE(backend.EndFrame(1.0f));
+    CheckGolden("primitives", backend);
+}
+
+TEST(OpaqueInteriorIsExact) {
+    SoftwareRenderBackend backend;
+    REQUIRE(backend.BeginFrame(40, 40));
+    backend.Clear(RenderColor());
+    backend.FillRoundedRect({ 0.0f, 0.0f, 40.0f, 40.0f }, 8.0f, RenderColor::FromRGB(0x336699));
+    REQUIRE(backend.EndFrame(1.0f));
+    CHECK_EQ(backend.GetPixels()[20 * 40 + 20], 0xFF336699u);
+    CHECK_EQ(backend.GetPixels()[0], 0u);                         // Outside the corner
+    CHECK(Alpha(backend.GetPixels()[20 * 40 + 0]) >= 127);        // Edge pixel, half covered
+}
+
+TEST(PixelsStayPremultiplied) {
+    SoftwareRenderBackend backend(BoxTextMask);
+    OverlayFrame frame = NotificationFrame();
+    frame.opacity = 0.7f;
+    REQUIRE(DrawOverlayFrame(backend, frame));
+    for (int i = 0; i < frame.width * frame.height; i++) {
+        uint32_t p = backend.GetPixels()[i];
+        uint8_t a = Alpha(p);
+        CHECK(((p >> 16) & 0xFF) <= a && ((p >> 8) & 0xFF) <= a && (p & 0xFF) <= a);
+    }
+}
+
+TEST(WindowOpacityScalesEverything) {
+    SoftwareRenderBackend opaque(BoxTextMask);
+    SoftwareRenderBackend faded(BoxTextMask);
+    OverlayFrame frame = NotificationFrame();
+    REQUIRE(DrawOverlayFrame(opaque, frame));
+    frame.opacity = 0.5f;
+    REQUIRE(DrawOverlayFrame(faded, frame));
+    for (int i = 0; i < frame.width * frame.height; i++) {
+        int expected = (Alpha(opaque.GetPixels()[i]) * 128 + 127) / 255;
+        CHECK(std::abs(Alpha(faded.GetPixels()[i]) - expected) <= 1);
+    }
+}
+
+TEST(TextNeedsAProvider) {
+    SoftwareRenderBackend withText(BoxTextMask);
+    SoftwareRenderBackend withoutText;
+    OverlayFrame frame = NotificationFrame();
+    size_t count = static_cast<size_t>(frame.width) * frame.height;
+    REQUIRE(DrawOverlayFrame(withText, frame));
+    REQUIRE(DrawOverlayFrame(withoutText, frame));
+    CHECK(!std::equal(withText.GetPixels(), withText.GetPixels() + count, withoutText.GetPixels()));
+
+    frame.text.clear();
+    REQUIRE(DrawOverlayFrame(withText, frame));
+    CHECK(std::equal(withText.GetPixels(), withText.GetPixels() + count, withoutText.GetPixels()));
+}
+
+TEST(AttachedPixels) {
+    std::vector<uint32_t> dib(30 * 20, 0xDEADBEEF);
+    SoftwareRenderBackend backend;
+    backend.AttachPixels(dib.data(), 30, 20);
+    CHECK(!backend.BeginFrame(31, 20));
+    REQUIRE(backend.BeginFrame(30, 20));
+    backend.Clear(RenderColor::FromRGB(0xFFFFFF));
+    REQUIRE(backend.EndFrame(1.0f));
+    CHECK(backend.GetPixels() == dib.data());
+    CHECK_EQ(dib[599], 0xFFFFFFFFu);
+
+    backend.DetachPixels();
+    REQUIRE(backend.BeginFrame(31, 20));
+    CHECK(backend.GetPixels() != dib.data());
+}
+
+TEST(EmptyFramesAreRejected) {
+    SoftwareRenderBackend backend;
+    CHECK(!backend.BeginFrame(0, 10));
+    CHECK(!backend.BeginFrame(10, -1));
+    OverlayFrame frame;
+    CHECK(!DrawOverlayFrame(backend, frame));
+}
@@ -0,0 +1,460 @@
+#include "Test.h"
+#include "overlay/RenderWorker.h"
+#include "overlay/SpscQueue.h"
+#include "overlay/TripleBuffer.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace VirtualOverlay;
+
+namespace {
+
+// Holds the worker inside the rasterizer until Open, so tests can queue
+// requests behind a request in progress
+class Gate {
+public:
+    void Open() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_open = true;
+        m_condition.notify_all();
+    }
+
+    void Wait() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_entered = true;
+        m_condition.notify_all();
+        m_condition.wait(lock, [this] { return m_open; });
+    }
+
+    // Until the worker sits in Wait
+    bool WaitEntered() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        return m_condition.wait_for(lock, std::chrono::seconds(10), [this] { return m_entered; });
+    }
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_open = false;
+    bool m_entered = false;
+};
+
+// Counts published results for the test thread to wait on
+class PublishCounter {
+public:
+    void OnPublished() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_count++;
+        m_condition.notify_all();
+    }
+
+    bool WaitFor(uint64_t count) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        return m_condition.wait_for(lock, std::chrono::seconds(10), [&] { return m_count >= count; });
+    }
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    uint64_t m_count = 0;
+};
+
+RenderRequest MakeRequest(RenderRequestKind kind, const std::wstring& text) {
+    RenderRequest request;
+    request.kind = kind;
+    request.key.text = text;
+    request.key.width = 64;
+    request.key.height = 32;
+    return request;
+}
+
+// A 1 x 1 label whose pixel is the text's length
+bool FakeRasterize(const RenderRequest& request, LabelBitmap& bitmap) {
+    bitmap.width = 1;
+    bitmap.height = 1;
+    bitmap.pixels.assign(1, static_cast<uint32_t>(request.key.text.size()));
+    return true;
+}
+
+}  // namespace
+
+TEST(PresentIsPublished) {
+    PublishCounter published;
+    RenderWorker worker;
+    REQUIRE(worker.Start(FakeRasterize, [&] { published.OnPublished(); }));
+
+    CHECK(worker.Submit(MakeRequest(RenderRequestKind::Present, L"Desktop 2")));
+    REQUIRE(published.WaitFor(1));
+    const RenderResult* result = worker.TakeResult();
+    REQUIRE(result != nullptr);
+    CHECK(result->ok);
+    CHECK_EQ(result->key.text, L"Desktop 2");
+    CHECK_EQ(result->bitmap.pixels.front(), 9u);
+    CHECK(worker.TakeResult() == nullptr);
+
+    worker.Stop();
+    CHECK_EQ(worker.GetStats().presented, 1u);
+    CHECK_EQ(worker.GetLatency().GetCount(), 1u);
+}
+
+TEST(PresentIsNeverRejectedByAFullWarmQueue) {
+    // A warm-up of every desktop fills the queue while the worker is busy;
+    // the switch that follows must still be drawn
+    Gate gate;
+    PublishCounter published;
+    RenderWorker worker;
+    REQUIRE(worker.Start(
+        [&](const RenderRequest& request, LabelBitmap& bitmap) {
+            if (request.key.text == L"first") {
+                gate.Wait();
+            }
+            return FakeRasterize(request, bitmap);
+        },
+        [&] { published.OnPublished(); }));
+
+    worker.Submit(MakeRequest(RenderRequestKind::Warm, L"first"));
+    REQUIRE(gate.WaitEntered());
+    size_t accepted = 0;
+    while (worker.Submit(MakeRequest(RenderRequestKind::Warm, L"warm " + std::to_wstring(accepted)))) {
+        accepted++;
+    }
+    CHECK_EQ(accepted, RenderWorker::QUEUE_CAPACITY);
+    CHECK(worker.Submit(MakeRequest(RenderRequestKind::Present, L"switch")));
+
+    gate.Open();
+    REQUIRE(published.WaitFor(1));
+    const RenderResult* result = worker.TakeResult();
+    REQUIRE(result != nullptr);
+    CHECK_EQ(result->key.text, L"switch");
+
+    worker.Stop();
+    RenderWorkerStats stats = worker.GetStats();
+    CHECK_EQ(stats.rejected, 1u);
+    CHECK_EQ(stats.presented, 1u);
+}
+
+TEST(PresentGoesBeforeQueuedWarms) {
+    Gate gate;
+    PublishCounter published;
+    std::vector<std::wstring> order;    // Worker only until Stop
+    RenderWorker worker;
+    REQUIRE(worker.Start(
+        [&](const RenderRequest& request, LabelBitmap& bitmap) {
+            if (request.key.text == L"first") {
+                gate.Wait();
+            }
+            order.push_back(request.key.text);
+            return FakeRasterize(request, bitmap);
+        },
+        [&] { published.OnPublished(); }));
+
+    worker.Submit(MakeRequest(RenderRequestKind::Warm, L"first"));
+    REQUIRE(gate.WaitEntered());
+    worker.Submit(MakeRequest(RenderRequestKind::Warm, L"a"));
+    worker.Submit(MakeRequest(RenderRequestKind::Warm, L"b"));
+    worker.Submit(MakeRequest(RenderRequestKind::Present, L"switch"));
+    gate.Open();
+    REQUIRE(published.WaitFor(1));
+
+    // Let the warms finish before reading the order
+    while (worker.GetStats().warmed < 3) {
+        std::this_thread::yield();
+    }
+    worker.Stop();
+    REQUIRE(order.size() == 4u);
+    CHECK_EQ(order[1], L"switch");
+}
+
+TEST(WarmedLabelsAreHandedBack) {
+    // Warmed labels come back in order for the UI thread's cache, without a
+    // published notification; once that queue is full the rest are dropped
+    Gate gate;
+    PublishCounter published;
+    RenderWorker worker;
+    REQUIRE(worker.Start(
+        [&](const RenderRequest& request, LabelBitmap& bitmap) {
+            if (request.key.text == L"first") {
+                gate.Wait();
+            }
+            return FakeRasterize(request, bitmap);
+        },
+        [&] { published.OnPublished(); }));
+
+    worker.Submit(MakeRequest(RenderRequestKind::Warm, L"first"));
+    REQUIRE(gate.WaitEntered());
+    size_t extra = 8;
+    for (size_t i = 1; i < RenderWorker::QUEUE_CAPACITY + extra; i++) {
+        if (i == RenderWorker::QUEUE_CAPACITY) {
+            // The request queue drained into the first QUEUE_CAPACITY results
+            gate.Open();
+            while (worker.GetStats().warmed < RenderWorker::QUEUE_CAPACITY) {
+                std::this_thread::yield();
+            }
+        }
+        CHECK(worker.Submit(MakeRequest(RenderRequestKind::Warm, std::wstring(i, L'w'))));
+    }
+    gate.Open();
+    while (worker.GetStats().warmed < RenderWorker::QUEUE_CAPACITY + extra) {
+        std::this_thread::yield();
+    }
+
+    RenderResult result;
+    REQUIRE(worker.TakeWarmResult(result));
+    CHECK(result.ok);
+    CHECK_EQ(result.key.text, L"first");
+    for (size_t i = 1; i < RenderWorker::QUEUE_CAPACITY; i++) {
+        REQUIRE(worker.TakeWarmResult(result));
+        CHECK_EQ(result.key.text.size(), i);
+        CHECK_EQ(result.bitmap.pixels.front(), static_cast<uint32_t>(i));
+    }
+    CHECK(!worker.TakeWarmResult(result));
+    CHECK(worker.TakeResult() == nullptr);
+
+    worker.Stop();
+    RenderWorkerStats stats = worker.GetStats();
+    CHECK_EQ(stats.warmDropped, extra);
+    CHECK_EQ(stats.presented, 0u);
+}
+
+TEST(NewerPresentSupersedesAWaitingOne) {
+    Gate gate;
+    PublishCounter published;
+    RenderWorker worker;
+    REQUIRE(worker.Start(
+        [&](const RenderRequest& request, LabelBitmap& bitmap) {
+            if (request.key.text == L"0") {
+                gate.Wait();
+            }
+            return FakeRasterize(request, bitmap);
+        },
+        [&] { published.OnPublished(); }));
+
+    worker.Submit(MakeRequest(RenderRequestKind::Present, L"0"));
+    REQUIRE(gate.WaitEntered());
+    for (int i = 1; i <= 9; i++) {
+        CHECK(worker.Submit(MakeRequest(RenderRequestKind::Present, std::to_wstring(i))));
+    }
+    gate.Open();
+    REQUIRE(published.WaitFor(2));
+    const RenderResult* result = worker.TakeResult();
+    REQUIRE(result != nullptr);
+    CHECK_EQ(result->key.text, L"9");
+
+    worker.Stop();
+    RenderWorkerStats stats = worker.GetStats();
+    CHECK_EQ(stats.presented, 2u);
+    CHECK_EQ(stats.superseded, 8u);
+    CHECK_EQ(stats.rejected, 0u);
+}
+
+TEST(StopDropsPendingRequests) {
+    Gate gate;
+    std::vector<std::wstring> drawn;    // Worker only until Stop
+    auto rasterize = [&](const RenderRequest& request, LabelBitmap& bitmap) {
+        if (request.key.text == L"first") {
+            gate.Wait();
+        }
+        drawn.push_back(request.key.text);
+        return FakeRasterize(request, bitmap);
+    };
+    RenderWorker worker;
+    REQUIRE(worker.Start(rasterize, nullptr));
+
+    worker.Submit(MakeRequest(RenderRequestKind::Warm, L"first"));
+    REQUIRE(gate.WaitEntered());
+    worker.Submit(MakeRequest(RenderRequestKind::Warm, L"a"));
+    worker.Submit(MakeRequest(RenderRequestKind::Present, L"b"));
+
+    // Stop is already waiting when the request in progress finishes
+    std::thread opener([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        gate.Open();
+    });
+    worker.Stop();
+    opener.join();
+    CHECK(!worker.IsRunning());
+    CHECK(drawn == std::vector<std::wstring>{ L"first" });
+
+    // Restarted, the worker sees none of them
+    PublishCounter published;
+    REQUIRE(worker.Start(rasterize, [&] { published.OnPublished(); }));
+    worker.Submit(MakeRequest(RenderRequestKind::Present, L"after"));
+    REQUIRE(published.WaitFor(1));
+    worker.Stop();
+    CHECK(drawn == (std::vector<std::wstring>{ L"first", L"after" }));
+}
+
+TEST(StressPresentsAndWarms) {
+    // The UI thread flips through desktops and warms between switches while
+    // consuming results: results only move forward and the last switch is
+    // the one left to show
+    constexpr int SWITCHES = 20000;
+    RenderWorker worker;
+    REQUIRE(worker.Start(FakeRasterize, nullptr));
+
+    uint64_t lastSequence = 0;
+    uint64_t consumed = 0;
+    uint64_t lastWarmSequence = 0;
+    auto consume = [&] {
+        if (const RenderResult* result = worker.TakeResult()) {
+            CHECK(result->sequence > lastSequence);
+            CHECK_EQ(result->bitmap.pixels.front(), static_cast<uint32_t>(result->key.text.size()));
+            lastSequence = result->sequence;
+            consumed++;
+        }
+        RenderResult warmed;
+        while (worker.TakeWarmResult(warmed)) {
+            CHECK(warmed.sequence > lastWarmSequence);
+            CHECK_EQ(warmed.bitmap.pixels.front(), 4u);
+            lastWarmSequence = warmed.sequence;
+        }
+    };
+
+    uint64_t rejectedPresents = 0;
+    std::wstring last;
+    for (int i = 0; i < SWITCHES; i++) {
+        last = std::wstring(static_cast<size_t>(1 + i % 40), L'x') + std::to_wstring(i);
+        if (!worker.Submit(MakeRequest(RenderRequestKind::Present, last))) {
+            rejectedPresents++;
+        }
+        for (int w = 0; w < i % 5; w++) {
+            worker.Submit(MakeRequest(RenderRequestKind::Warm, L"warm"));
+        }
+        consume();
+    }
+    CHECK_EQ(rejectedPresents, 0u);
+
+    // Everything submitted is either published, superseded or rejected
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    RenderWorkerStats stats = worker.GetStats();
+    while (stats.presented + stats.superseded < static_cast<uint64_t>(SWITCHES) &&
+           std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::yield();
+        stats = worker.GetStats();
+    }
+    consume();
+    worker.Stop();
+
+    stats = worker.GetStats();
+    CHECK_EQ(stats.presented + stats.superseded, static_cast<uint64_t>(SWITCHES));
+    CHECK(consumed > 0);
+    std::printf("  %d switches -> %llu presented, %llu superseded; %llu warmed, %llu rejected\n", SWITCHES,
+                static_cast<unsigned long long>(stats.presented),
+                static_cast<unsigned long long>(stats.superseded),
+                static_cast<unsigned long long>(stats.warmed),
+                static_cast<unsigned long long>(stats.rejected));
+}
+
+TEST(SpscQueueStressKeepsOrder) {
+    constexpr uint64_t COUNT = 1000000;
+    SpscQueue<uint64_t, 64> queue;
+    std::thread producer([&] {
+        for (uint64_t i = 0; i < COUNT; i++) {
+            uint64_t value = i;
+            while (!queue.Push(std::move(value))) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    uint64_t expected = 0;
+    uint64_t outOfOrder = 0;
+    while (expected < COUNT) {
+        uint64_t value;
+        if (!queue.Pop(value)) {
+            std::this_thread::yield();
+            continue;
+        }
+        if (value != expected) {
+            outOfOrder++;
+        }
+        expected++;
+    }
+    producer.join();
+    CHECK_EQ(outOfOrder, 0u);
+    CHECK(queue.IsEmpty());
+}
+
+TEST(SpscQueueFullAndEmpty) {
+    SpscQueue<int, 4> queue;
+    int value = 0;
+    CHECK(!queue.Pop(value));
+    for (int i = 0; i < 4; i++) {
+        CHECK(queue.Push(int(i)));
+    }
+    CHECK(!queue.Push(4));
+    CHECK(queue.Pop(value));
+    CHECK_EQ(value, 0);
+    CHECK(queue.Push(4));
+    for (int i = 1; i <= 4; i++) {
+        CHECK(queue.Pop(value));
+        CHECK_EQ(value, i);
+    }
+    CHECK(queue.IsEmpty());
+}
+
+TEST(TripleBufferStressNeverTears) {
+    // Every published value is a vector filled with one number; the consumer
+    // must never see a mix, and numbers only grow
+    constexpr uint32_t COUNT = 200000;
+    TripleBuffer<std::vector<uint32_t>> buffer;
+    std::atomic<bool> done{ false };
+    std::thread producer([&] {
+        for (uint32_t i = 1; i <= COUNT; i++) {
+            std::vector<uint32_t>& slot = buffer.GetWriteBuffer();
+            slot.assign(16 + i % 48, i);
+            buffer.Publish();
+        }
+        done.store(true, std::memory_order_release);
+    });
+
+    uint32_t last = 0;
+    uint64_t torn = 0;
+    uint64_t backwards = 0;
+    uint64_t consumed = 0;
+    while (true) {
+        bool finished = done.load(std::memory_order_acquire);
+        if (buffer.Consume()) {
+            const std::vector<uint32_t>& value = buffer.GetReadBuffer();
+            for (uint32_t element : value) {
+                if (element != value.front()) {
+                    torn++;
+                }
+            }
+            if (value.size() != 16 + value.front() % 48) {
+                torn++;
+            }
+            if (value.front() <= last) {
+                backwards++;
+            }
+            last = value.front();
+            consumed++;
+        } else if (finished) {
+            break;
+        }
+    }
+    producer.join();
+    CHECK_EQ(torn, 0u);
+    CHECK_EQ(backwards, 0u);
+    CHECK_EQ(last, COUNT);
+    CHECK(consumed > 0);
+}
+
+TEST(TripleBufferReportsOverwrites) {
+    TripleBuffer<int> buffer;
+    buffer.GetWriteBuffer() = 1;
+    CHECK(!buffer.Publish());
+    buffer.GetWriteBuffer() = 2;
+    CHECK(buffer.Publish());        // 1 was never consumed
+    CHECK(buffer.Consume());
+    CHECK_EQ(buffer.GetReadBuffer(), 2);
+    CHECK(!buffer.Consume());
+    buffer.GetWriteBuffer() = 3;
+    CHECK(!buffer.Publish());
+}
@@ -0,0 +1,164 @@
+#include "Test.h"
+#include "zoom/ScreenGeometry.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace VirtualOverlay;
+
+namespace {
+
+// Primary first, at 0,0 as Windows always puts it
+const std::vector<std::vector<ZoomRect>> LAYOUTS = {
+    { { 0, 0, 1920, 1080 } },
+    { { 0, 0, 2560, 1440 }, { 2560, 0, 4480, 1080 } },
+    { { 0, 0, 2560, 1440 }, { -1920, -200, 0, 880 } },                           // Left and above
+    { { 0, 0, 2560, 1440 }, { -1920, -200, 0, 880 }, { 2560, 0, 4480, 1080 } },
+    { { 0, 0, 1920, 1080 }, { 0, -1440, 2560, 0 } },                             // Stacked above
+    { { 0, 0, 1920, 1080 }, { -3840, 300, -1920, 1380 } },                       // Gap to the left
+    { { 0, 0, 1366, 768 }, { -1280, -1024, 0, 0 }, { 1366, 768, 3286, 1848 } },  // Diagonal, odd sizes
+};
+
+struct AxisCheck {
+    int start;          // Virtual screen, this axis
+    int end;
+    int center;
+    int offset;
+};
+
+// Properties of one axis: the view stays on the virtual screen, and shows
+// the center in its middle unless it had to be clamped to an edge
+void CheckAxis(const AxisCheck& axis, float level) {
+    double first = axis.offset + axis.start / static_cast<double>(level);
+    double last = axis.offset + axis.end / static_cast<double>(level);
+    double visible = (axis.end - axis.start) / static_cast<double>(level);
+
+    // Truncation and rounding of the integer offset: at most a pixel each
+    const double slack = 1.5;
+    CHECK(first >= axis.start - slack);
+    CHECK(last <= axis.end + slack);
+
+    double wantedFirst = axis.center - visible / 2.0;
+    if (wantedFirst >= axis.start && wantedFirst + visible <= axis.end) {
+        CHECK(std::fabs((first + last) / 2.0 - axis.center) <= slack);
+    } else if (wantedFirst < axis.start) {
+        CHECK(std::fabs(first - axis.start) <= slack);
+    } else {
+        CHECK(std::fabs(last - axis.end) <= slack);
+    }
+}
+
+void CheckTransform(const ScreenGeometry& geometry, float level, int x, int y) {
+    MagnifierTransform transform = ComputeMagnifierTransform(level, x, y, geometry);
+    CHECK_EQ(transform.level, level);
+    const ZoomRect& screen = geometry.virtualScreen;
+    CheckAxis({ screen.left, screen.right, x, transform.offsetX }, level);
+    CheckAxis({ screen.top, screen.bottom, y, transform.offsetY }, level);
+}
+
+}  // namespace
+
+TEST(VirtualScreenIsTheBoundingBox) {
+    ScreenGeometry geometry = MakeScreenGeometry(LAYOUTS[3], 7);
+    CHECK_EQ(geometry.generation, 7u);
+    CHECK(geometry.virtualScreen == (ZoomRect{ -1920, -200, 4480, 1440 }));
+    CHECK(geometry.monitors.front() == (ZoomRect{ 0, 0, 2560, 1440 }));
+
+    CHECK(MakeScreenGeometry({}, 1).virtualScreen == ZoomRect());
+}
+
+TEST(LevelIsClamped) {
+    ScreenGeometry geometry = MakeScreenGeometry(LAYOUTS[2], 1);
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    const float inf = std::numeric_limits<float>::infinity();
+    CHECK_EQ(ComputeMagnifierTransform(nan, 100, 100, geometry).level, 1.0f);
+    CHECK_EQ(ComputeMagnifierTransform(-inf, 100, 100, geometry).level, 1.0f);
+    CHECK_EQ(ComputeMagnifierTransform(0.5f, 100, 100, geometry).level, 1.0f);
+    CHECK_EQ(ComputeMagnifierTransform(inf, 100, 100, geometry).level, MAX_MAGNIFIER_LEVEL);
+    CHECK_EQ(ComputeMagnifierTransform(50.0f, 100, 100, geometry).level, MAX_MAGNIFIER_LEVEL);
+}
+
+TEST(OneIsTheIdentity) {
+    for (const auto& layout : LAYOUTS) {
+        ScreenGeometry geometry = MakeScreenGeometry(layout, 1);
+        for (int x : { -5000, -1920, -1, 0, 777, 4479, 9000 }) {
+            MagnifierTransform transform = ComputeMagnifierTransform(1.0f, x, x / 2, geometry);
+            CHECK(transform == MagnifierTransform());
+        }
+    }
+}
+
+TEST(OffsetsAreRelativeToThePrimaryOrigin) {
+    // 2x centered on the left monitor of a 2560 + 1920 layout: the view is
+    // 2240 px wide, clamped to the virtual screen's left edge (-1920), so
+    // screen point -1920 must show source -1920: offset -1920 + 1920 / 2.
+    // Relative to the virtual origin it would have been 0.
+    ScreenGeometry geometry = MakeScreenGeometry(LAYOUTS[2], 1);
+    MagnifierTransform transform = ComputeMagnifierTransform(2.0f, -960, 340, geometry);
+    CHECK_EQ(transform.offsetX, -960);
+    // Vertically: 820 px visible, centered on 340 -> source -70 at the top
+    // edge (-200): -70 - (-200) / 2
+    CHECK_EQ(transform.offsetY, 30);
+
+    // Without monitors left of or above the primary the offset is simply
+    // the first source pixel shown
+    ScreenGeometry plain = MakeScreenGeometry(LAYOUTS[1], 1);
+    transform = ComputeMagnifierTransform(4.0f, 1280, 720, plain);
+    CHECK_EQ(transform.offsetX, 1280 - 4480 / 8);
+    CHECK_EQ(transform.offsetY, 720 - 1440 / 8);
+}
+
+TEST(ViewStaysOnScreenAndShowsTheCenter) {
+    for (const auto& layout : LAYOUTS) {
+        ScreenGeometry geometry = MakeScreenGeometry(layout, 1);
+        const ZoomRect& screen = geometry.virtualScreen;
+        for (float level = 1.0f; level <= MAX_MAGNIFIER_LEVEL; level += 1.0f / 16.0f) {
+            for (int x = screen.left - 50; x <= screen.right + 50; x += 97) {
+                for (int y = screen.top - 50; y <= screen.bottom + 50; y += 89) {
+                    CheckTransform(geometry, level, x, y);
+                }
+            }
+        }
+    }
+}
+
+TEST(RandomLevelsAndCenters) {
+    std::mt19937 rng(23);
+    std::uniform_real_distribution<float> levels(1.0f, MAX_MAGNIFIER_LEVEL);
+    for (const auto& layout : LAYOUTS) {
+        ScreenGeometry geometry = MakeScreenGeometry(layout, 1);
+        const ZoomRect& screen = geometry.virtualScreen;
+        std::uniform_int_distribution<int> xs(screen.left - 500, screen.right + 500);
+        std::uniform_int_distribution<int> ys(screen.top - 500, screen.bottom + 500);
+        for (int i = 0; i < 20000; i++) {
+            CheckTransform(geometry, levels(rng), xs(rng), ys(rng));
+        }
+    }
+}
+
+TEST(OffsetsFollowTheCenter) {
+    for (const auto& layout : LAYOUTS) {
+        ScreenGeometry geometry = MakeScreenGeometry(layout, 1);
+        const ZoomRect& screen = geometry.virtualScreen;
+        for (float level : { 1.25f, 2.0f, 3.7f, 10.0f, 20.0f }) {
+            MagnifierTransform previous = ComputeMagnifierTransform(level, screen.left - 10, screen.top - 10, geometry);
+            for (int i = screen.left - 9; i <= screen.right + 10; i++) {
+                int y = screen.top + (i - screen.left) * screen.GetHeight() / std::max(screen.GetWidth(), 1);
+                MagnifierTransform transform = ComputeMagnifierTransform(level, i, y, geometry);
+                CHECK(transform.offsetX >= previous.offsetX);
+                CHECK(transform.offsetX - previous.offsetX <= 1);
+                previous = transform;
+            }
+        }
+    }
+}
+
+TEST(EmptyGeometryIsTheIdentityOffset) {
+    ScreenGeometry empty;
+    MagnifierTransform transform = ComputeMagnifierTransform(3.0f, 500, 500, empty);
+    CHECK_EQ(transform.level, 3.0f);
+    CHECK_EQ(transform.offsetX, 0);
+    CHECK_EQ(transform.offsetY, 0);
+}
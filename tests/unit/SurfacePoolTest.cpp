@@ -0,0 +1,157 @@
+#include "Test.h"
+#include "overlay/SurfacePool.h"
+
+using namespace VirtualOverlay;
+
+namespace {
+
+struct FakeSurface {
+    int id = 0;
+};
+
+// Pool of fake surfaces that records every destroyed id
+struct FakePool {
+    std::vector<int> destroyed;
+    int nextId = 1;
+    SurfacePool<FakeSurface> pool;
+
+    explicit FakePool(size_t maxIdle)
+        : pool(maxIdle, [this](FakeSurface& surface) { destroyed.push_back(surface.id); }) {
+    }
+
+    // Acquire, creating a surface on a miss the way the renderer does
+    FakeSurface* Lease(int width, int height, uint64_t nowMs) {
+        FakeSurface* surface = pool.Acquire(width, height, nowMs);
+        if (!surface) {
+            surface = pool.Adopt(width, height, FakeSurface{ nextId++ }, nowMs);
+        }
+        return surface;
+    }
+};
+
+}  // namespace
+
+TEST(MissThenReuse) {
+    FakePool fake(4);
+    CHECK(fake.pool.Acquire(100, 40, 0) == nullptr);
+    FakeSurface* first = fake.pool.Adopt(100, 40, FakeSurface{ 7 }, 0);
+    REQUIRE(first != nullptr);
+    fake.pool.Release(first, 10);
+    CHECK_EQ(fake.pool.GetIdleCount(), 1u);
+
+    FakeSurface* again = fake.pool.Acquire(100, 40, 20);
+    CHECK(again == first);
+    CHECK_EQ(again->id, 7);
+    CHECK_EQ(fake.pool.GetIdleCount(), 0u);
+
+    const SurfacePoolStats& stats = fake.pool.GetStats();
+    CHECK_EQ(stats.acquires, 2u);
+    CHECK_EQ(stats.reuses, 1u);
+    CHECK_EQ(stats.creates, 1u);
+}
+
+TEST(SizeMustMatchExactly) {
+    FakePool fake(4);
+    FakeSurface* surface = fake.Lease(100, 40, 0);
+    fake.pool.Release(surface, 0);
+
+    CHECK(fake.pool.Acquire(100, 41, 1) == nullptr);
+    CHECK(fake.pool.Acquire(99, 40, 1) == nullptr);
+    CHECK(fake.pool.Acquire(40, 100, 1) == nullptr);
+    CHECK(fake.pool.Acquire(100, 40, 1) == surface);
+}
+
+TEST(LeasedSurfacesAreNotShared) {
+    FakePool fake(4);
+    FakeSurface* a = fake.Lease(64, 64, 0);
+    FakeSurface* b = fake.Lease(64, 64, 0);
+    CHECK(a != b);
+    CHECK_EQ(fake.pool.GetCount(), 2u);
+    CHECK_EQ(fake.pool.GetStats().creates, 2u);
+}
+
+TEST(ReusesMostRecentlyReleased) {
+    FakePool fake(4);
+    FakeSurface* a = fake.Lease(64, 64, 0);
+    FakeSurface* b = fake.Lease(64, 64, 0);
+    fake.pool.Release(a, 10);
+    fake.pool.Release(b, 20);
+    CHECK(fake.pool.Acquire(64, 64, 30) == b);
+}
+
+TEST(EvictsLeastRecentlyUsedIdle) {
+    FakePool fake(2);
+    FakeSurface* a = fake.Lease(10, 10, 0);
+    FakeSurface* b = fake.Lease(20, 20, 0);
+    FakeSurface* c = fake.Lease(30, 30, 0);
+    fake.pool.Release(b, 5);
+    fake.pool.Release(a, 10);
+    CHECK(fake.destroyed.empty());
+
+    fake.pool.Release(c, 15);  // Third idle surface: b is the oldest
+    REQUIRE(fake.destroyed.size() == 1u);
+    CHECK_EQ(fake.destroyed[0], 2);
+    CHECK_EQ(fake.pool.GetIdleCount(), 2u);
+    CHECK_EQ(fake.pool.GetStats().evictions, 1u);
+    CHECK(fake.pool.Acquire(20, 20, 20) == nullptr);
+}
+
+TEST(LeasedSurfacesAreNeverEvicted) {
+    FakePool fake(0);
+    FakeSurface* a = fake.Lease(10, 10, 0);
+    FakeSurface* b = fake.Lease(10, 10, 0);
+    fake.pool.Release(a, 1);  // maxIdle 0: destroyed at once
+    CHECK_EQ(fake.destroyed.size(), 1u);
+    CHECK_EQ(fake.pool.GetCount(), 1u);
+    CHECK_EQ(b->id, 2);
+}
+
+TEST(ByteAccounting) {
+    FakePool fake(1);
+    CHECK_EQ(SurfacePool<FakeSurface>::BytesFor(100, 40), 16000u);
+
+    FakeSurface* a = fake.Lease(100, 40, 0);
+    FakeSurface* b = fake.Lease(200, 50, 0);
+    CHECK_EQ(fake.pool.GetStats().bytes, 16000u + 40000u);
+    CHECK_EQ(fake.pool.GetStats().peakBytes, 56000u);
+
+    // Reuse does not count twice
+    fake.pool.Release(a, 1);
+    FakeSurface* again = fake.Lease(100, 40, 2);
+    CHECK(again == a);
+    CHECK_EQ(fake.pool.GetStats().bytes, 56000u);
+
+    // Eviction, Discard and Clear give the bytes back; the peak stays
+    fake.pool.Release(a, 3);
+    fake.pool.Release(b, 4);  // Evicts a
+    CHECK_EQ(fake.pool.GetStats().bytes, 40000u);
+    FakeSurface* c = fake.Lease(8, 8, 5);
+    CHECK_EQ(fake.pool.GetStats().bytes, 40000u + 256u);
+    fake.pool.Discard(c);
+    CHECK_EQ(fake.pool.GetStats().bytes, 40000u);
+    fake.pool.Clear();
+    CHECK_EQ(fake.pool.GetStats().bytes, 0u);
+    CHECK_EQ(fake.pool.GetStats().peakBytes, 56000u);
+    CHECK_EQ(fake.pool.GetCount(), 0u);
+}
+
+TEST(DiscardDestroysLeasedSurface) {
+    FakePool fake(4);
+    FakeSurface* a = fake.Lease(10, 10, 0);
+    fake.pool.Discard(a);
+    REQUIRE(fake.destroyed.size() == 1u);
+    CHECK_EQ(fake.destroyed[0], 1);
+    CHECK_EQ(fake.pool.GetCount(), 0u);
+    CHECK_EQ(fake.pool.GetStats().evictions, 0u);
+}
+
+TEST(DestructorDestroysEverything) {
+    std::vector<int> destroyed;
+    {
+        SurfacePool<FakeSurface> pool(4, [&](FakeSurface& surface) { destroyed.push_back(surface.id); });
+        pool.Adopt(10, 10, FakeSurface{ 1 }, 0);
+        FakeSurface* idle = pool.Adopt(10, 10, FakeSurface{ 2 }, 0);
+        pool.Release(idle, 0);
+    }
+    CHECK_EQ(destroyed.size(), 2u);
+}
@@ -0,0 +1,236 @@
+#include "Test.h"
+#include "overlay/SwitchSpeculator.h"
+
+using namespace VirtualOverlay;
+
+namespace {
+
+// One line of a scripted key / switch trace
+struct TraceEvent {
+    enum Kind { Key, Confirm } kind;
+    uint64_t ms;
+    SwitchDirection direction;   // Key
+    int desktop;                 // Key: desktop the key was pressed on; Confirm: detected desktop
+};
+
+TraceEvent Key(uint64_t ms, SwitchDirection direction, int onDesktop) {
+    return { TraceEvent::Key, ms, direction, onDesktop };
+}
+
+TraceEvent Confirm(uint64_t ms, int desktop) {
+    return { TraceEvent::Confirm, ms, SwitchDirection::Left, desktop };
+}
+
+struct TraceAction {
+    uint64_t ms;
+    SpeculationAction action;
+};
+
+// Replays the trace the way App drives the speculator: a timer fires at every
+// deadline the speculator asks for, key presses and confirmations arrive in
+// between. Returns every action that is not None.
+std::vector<TraceAction> Replay(SwitchSpeculator& speculator, const std::vector<TraceEvent>& trace,
+                                int desktopCount, uint64_t endMs) {
+    std::vector<TraceAction> actions;
+    auto runTimersUntil = [&](uint64_t untilMs) {
+        uint64_t due = 0;
+        while (speculator.GetNextDeadline(due) && due <= untilMs) {
+            SpeculationAction action = speculator.OnTick(due);
+            if (action != SpeculationAction::None) {
+                actions.push_back({ due, action });
+            }
+        }
+    };
+
+    for (const TraceEvent& event : trace) {
+        runTimersUntil(event.ms);
+        if (event.kind == TraceEvent::Key) {
+            speculator.OnSwitchKey(event.direction, event.desktop, desktopCount, event.ms);
+        } else {
+            SpeculationAction action = speculator.OnSwitchConfirmed(event.desktop);
+            if (action != SpeculationAction::None) {
+                actions.push_back({ event.ms, action });
+            }
+        }
+    }
+    runTimersUntil(endMs);
+    return actions;
+}
+
+}  // namespace
+
+TEST(ConfirmedWithinBudgetShowsPrediction) {
+    SwitchSpeculator speculator;
+    CHECK_EQ(speculator.OnSwitchKey(SwitchDirection::Right, 2, 4, 0), 3);
+
+    std::vector<TraceAction> actions = Replay(speculator, { Confirm(30, 3) }, 4, 1000);
+    REQUIRE(actions.size() == 1u);
+    CHECK(actions[0].action == SpeculationAction::ShowPrediction);
+    CHECK_EQ(actions[0].ms, 30u);
+    CHECK_EQ(speculator.GetStats().hits, 1u);
+    CHECK_EQ(speculator.GetStats().early, 0u);
+}
+
+TEST(SlowConfirmationPresentsEarly) {
+    SwitchSpeculator speculator;
+    std::vector<TraceAction> actions = Replay(speculator, {
+        Key(0, SwitchDirection::Left, 3),
+        Confirm(120, 2),
+    }, 4, 1000);
+
+    // Presented when the 50 ms budget ran out; the confirmation is a no-op
+    REQUIRE(actions.size() == 1u);
+    CHECK(actions[0].action == SpeculationAction::ShowPrediction);
+    CHECK_EQ(actions[0].ms, 50u);
+    CHECK_EQ(speculator.GetStats().early, 1u);
+    CHECK_EQ(speculator.GetStats().hits, 1u);
+    CHECK_EQ(speculator.GetStats().corrections, 0u);
+}
+
+TEST(ChainedPredictions) {
+    SwitchSpeculator speculator;
+    // Three quick presses from desktop 1: the detector still reports 1
+    // for the later ones, the chain follows the predictions
+    CHECK_EQ(speculator.OnSwitchKey(SwitchDirection::Right, 1, 5, 0), 2);
+    CHECK_EQ(speculator.OnSwitchKey(SwitchDirection::Right, 1, 5, 20), 3);
+    CHECK_EQ(speculator.OnSwitchKey(SwitchDirection::Right, 1, 5, 40), 4);
+    CHECK_EQ(speculator.GetPredictedIndex(), 4);
+
+    // The budget restarts with every press
+    uint64_t due = 0;
+    REQUIRE(speculator.GetNextDeadline(due));
+    CHECK_EQ(due, 90u);
+
+    // A reversal chains too
+    CHECK_EQ(speculator.OnSwitchKey(SwitchDirection::Left, 1, 5, 60), 3);
+    CHECK(speculator.OnSwitchConfirmed(3) == SpeculationAction::ShowPrediction);
+    CHECK_EQ(speculator.GetStats().predictions, 4u);
+    CHECK_EQ(speculator.GetStats().hits, 1u);
+}
+
+TEST(IntermediateDesktopConfirmation) {
+    SwitchSpeculator speculator;
+    std::vector<TraceAction> actions = Replay(speculator, {
+        Key(0, SwitchDirection::Right, 1),
+        Key(15, SwitchDirection::Right, 1),
+        Key(30, SwitchDirection::Right, 1),
+        Confirm(40, 2),   // Steps of the chain landing
+        Confirm(55, 3),
+        Confirm(70, 4),
+    }, 5, 1000);
+
+    // Each step shows the real desktop until the prediction is up, and the
+    // final step matches the prediction
+    REQUIRE(actions.size() == 3u);
+    CHECK(actions[0].action == SpeculationAction::ShowActual);
+    CHECK(actions[1].action == SpeculationAction::ShowActual);
+    CHECK(actions[2].action == SpeculationAction::ShowPrediction);
+    CHECK_EQ(speculator.GetStats().hits, 1u);
+    CHECK_EQ(speculator.GetStats().misses, 0u);
+    CHECK(!speculator.IsPending());
+}
+
+TEST(IntermediateAfterEarlyPresentationKeepsPrediction) {
+    SwitchSpeculator speculator;
+    std::vector<TraceAction> actions = Replay(speculator, {
+        Key(0, SwitchDirection::Left, 4),
+        Key(10, SwitchDirection::Left, 4),
+        Confirm(100, 3),  // The prediction (2) is already up; 3 is a step on the way
+        Confirm(140, 2),
+    }, 4, 1000);
+
+    REQUIRE(actions.size() == 1u);
+    CHECK(actions[0].action == SpeculationAction::ShowPrediction);
+    CHECK_EQ(actions[0].ms, 60u);
+    CHECK_EQ(speculator.GetStats().hits, 1u);
+    CHECK_EQ(speculator.GetStats().corrections, 0u);
+}
+
+TEST(EdgePressPredictsNothing) {
+    SwitchSpeculator speculator;
+    CHECK_EQ(speculator.OnSwitchKey(SwitchDirection::Left, 1, 4, 0), 0);
+    CHECK_EQ(speculator.OnSwitchKey(SwitchDirection::Right, 4, 4, 0), 0);
+    CHECK(!speculator.IsPending());
+    CHECK_EQ(speculator.GetStats().predictions, 0u);
+
+    // Windows does not wrap, so the real switch is shown as is
+    CHECK(speculator.OnSwitchConfirmed(1) == SpeculationAction::ShowActual);
+}
+
+TEST(EdgePressKeepsPendingChain) {
+    SwitchSpeculator speculator;
+    CHECK_EQ(speculator.OnSwitchKey(SwitchDirection::Right, 3, 4, 0), 4);
+    CHECK_EQ(speculator.OnSwitchKey(SwitchDirection::Right, 3, 4, 20), 0);  // Past the end
+    CHECK_EQ(speculator.GetPredictedIndex(), 4);
+
+    uint64_t due = 0;
+    REQUIRE(speculator.GetNextDeadline(due));
+    CHECK_EQ(due, 50u);  // The ignored press did not restart the budget
+    CHECK(speculator.OnSwitchConfirmed(4) == SpeculationAction::ShowPrediction);
+}
+
+TEST(UnknownCurrentDesktopPredictsNothing) {
+    SwitchSpeculator speculator;
+    CHECK_EQ(speculator.OnSwitchKey(SwitchDirection::Right, 0, 4, 0), 0);
+    CHECK_EQ(speculator.OnSwitchKey(SwitchDirection::Right, 6, 4, 0), 0);
+    CHECK(!speculator.IsPending());
+}
+
+TEST(TimeoutRetractsPresentedPrediction) {
+    SwitchSpeculator speculator;
+    std::vector<TraceAction> actions = Replay(speculator, {
+        Key(0, SwitchDirection::Right, 2),  // e.g. swallowed by a full-screen app
+    }, 4, 2000);
+
+    REQUIRE(actions.size() == 2u);
+    CHECK(actions[0].action == SpeculationAction::ShowPrediction);
+    CHECK_EQ(actions[0].ms, 50u);
+    CHECK(actions[1].action == SpeculationAction::Retract);
+    CHECK_EQ(actions[1].ms, 750u);
+    CHECK_EQ(speculator.GetStats().expired, 1u);
+    CHECK_EQ(speculator.GetStats().corrections, 1u);
+    CHECK(!speculator.IsPending());
+
+    // A confirmation that shows up after all is displayed normally
+    CHECK(speculator.OnSwitchConfirmed(3) == SpeculationAction::ShowActual);
+}
+
+TEST(TimeoutWithoutPresentationIsSilent) {
+    SwitchSpeculationConfig config;
+    config.latencyBudgetMs = 1000;
+    config.confirmTimeoutMs = 300;  // Clamped above the budget
+    SwitchSpeculator speculator(config);
+    CHECK_EQ(speculator.GetConfig().confirmTimeoutMs, 1001u);
+
+    CHECK_EQ(speculator.OnSwitchKey(SwitchDirection::Right, 1, 2, 0), 2);
+    CHECK(speculator.OnTick(999) == SpeculationAction::None);
+    CHECK(speculator.OnTick(1000) == SpeculationAction::ShowPrediction);
+    CHECK(speculator.OnTick(1001) == SpeculationAction::Retract);
+}
+
+TEST(WrongPredictionIsCorrected) {
+    SwitchSpeculator speculator;
+    std::vector<TraceAction> actions = Replay(speculator, {
+        Key(0, SwitchDirection::Right, 2),
+        Confirm(200, 1),  // Something else moved the user (Task View click)
+    }, 4, 1000);
+
+    REQUIRE(actions.size() == 2u);
+    CHECK(actions[0].action == SpeculationAction::ShowPrediction);
+    CHECK(actions[1].action == SpeculationAction::ShowActual);
+    CHECK_EQ(speculator.GetStats().misses, 1u);
+    CHECK_EQ(speculator.GetStats().corrections, 1u);
+}
+
+TEST(ZeroBudgetPresentsOnFirstTick) {
+    SwitchSpeculationConfig config;
+    config.latencyBudgetMs = 0;
+    SwitchSpeculator speculator(config);
+    speculator.OnSwitchKey(SwitchDirection::Left, 2, 3, 100);
+
+    uint64_t due = 0;
+    REQUIRE(speculator.GetNextDeadline(due));
+    CHECK_EQ(due, 100u);
+    CHECK(speculator.OnTick(100) == SpeculationAction::ShowPrediction);
+    CHECK(speculator.IsPredictionShown());
+}
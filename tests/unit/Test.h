@@ -0,0 +1,114 @@
+#pragma once
+
+// Minimal test harness for the platform-independent code.
+//
+//   TEST(FormatTemplate_EscapedBraces) {
+//       CHECK_EQ(Format(...), L"{x}");
+//   }
+//
+// CHECK_* records a failure and carries on; REQUIRE stops the test. Every
+// test executable links TestMain.cpp, which runs all tests in the file (or
+// those whose name contains argv[1]) and exits non-zero on any failure.
+
+#include <cmath>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace VirtualOverlay {
+namespace Test {
+
+using TestFunction = void (*)();
+
+struct TestCase {
+    const char* name;
+    TestFunction function;
+};
+
+std::vector<TestCase>& GetRegistry();
+void ReportFailure(const char* file, int line, const std::string& message);
+
+struct Registrar {
+    Registrar(const char* name, TestFunction function) {
+        GetRegistry().push_back({ name, function });
+    }
+};
+
+// Thrown by REQUIRE to leave the current test
+struct RequireFailed {};
+
+template <typename T>
+std::string Describe(const T& value) {
+    std::ostringstream stream;
+    stream << value;
+    return stream.str();
+}
+
+inline std::string Describe(const std::wstring& value) {
+    std::string narrow;
+    for (wchar_t c : value) {
+        narrow += (c >= 0x20 && c < 0x7F) ? static_cast<char>(c) : '?';
+    }
+    return "L\"" + narrow + "\"";
+}
+
+inline std::string Describe(const wchar_t* value) {
+    return Describe(std::wstring(value));
+}
+
+inline std::string Describe(uint8_t value) {
+    return std::to_string(value);
+}
+
+inline std::string Describe(bool value) {
+    return value ? "true" : "false";
+}
+
+template <typename A, typename B>
+void CheckEqual(const A& actual, const B& expected, const char* text, const char* file, int line) {
+    if (!(actual == expected)) {
+        ReportFailure(file, line, std::string(text) + ": got " + Describe(actual) +
+                                  ", expected " + Describe(expected));
+    }
+}
+
+inline void CheckNear(double actual, double expected, double tolerance, const char* text,
+                      const char* file, int line) {
+    if (!(std::fabs(actual - expected) <= tolerance)) {
+        ReportFailure(file, line, std::string(text) + ": got " + Describe(actual) +
+                                  ", expected " + Describe(expected) + " +/- " + Describe(tolerance));
+    }
+}
+
+}  // namespace Test
+}  // namespace VirtualOverlay
+
+#define VO_TEST_CONCAT_(a, b) a##b
+#define VO_TEST_CONCAT(a, b) VO_TEST_CONCAT_(a, b)
+
+#define TEST(name)                                                               \
+    static void name();                                                          \
+    static ::VirtualOverlay::Test::Registrar VO_TEST_CONCAT(name, _registrar)(#name, name); \
+    static void name()
+
+#define CHECK(condition)                                                         \
+    do {                                                                         \
+        if (!(condition)) {                                                      \
+            ::VirtualOverlay::Test::ReportFailure(__FILE__, __LINE__, #condition); \
+        }                                                                        \
+    } while (0)
+
+#define REQUIRE(condition)                                                       \
+    do {                                                                         \
+        if (!(condition)) {                                                      \
+            ::VirtualOverlay::Test::ReportFailure(__FILE__, __LINE__, #condition); \
+            throw ::VirtualOverlay::Test::RequireFailed();                       \
+        }                                                                        \
+    } while (0)
+
+#define CHECK_EQ(actual, expected) \
+    ::VirtualOverlay::Test::CheckEqual((actual), (expected), #actual " == " #expected, __FILE__, __LINE__)
+
+#define CHECK_NEAR(actual, expected, tolerance) \
+    ::VirtualOverlay::Test::CheckNear((actual), (expected), (tolerance), #actual, __FILE__, __LINE__)
@@ -0,0 +1,58 @@
+#include "Test.h"
+#include <cstdio>
+#include <cstring>
+#include <exception>
+
+namespace VirtualOverlay {
+namespace Test {
+
+namespace {
+
+int g_failures = 0;
+
+}  // namespace
+
+std::vector<TestCase>& GetRegistry() {
+    static std::vector<TestCase> registry;
+    return registry;
+}
+
+void ReportFailure(const char* file, int line, const std::string& message) {
+    std::fprintf(stderr, "%s:%d: FAILED %s\n", file, line, message.c_str());
+    g_failures++;
+}
+
+}  // namespace Test
+}  // namespace VirtualOverlay
+
+int main(int argc, char** argv) {
+    using namespace VirtualOverlay::Test;
+
+    const char* filter = argc > 1 ? argv[1] : nullptr;
+    int run = 0;
+    int failedTests = 0;
+    for (const TestCase& test : GetRegistry()) {
+        if (filter && !std::strstr(test.name, filter)) {
+            continue;
+        }
+
+        int before = g_failures;
+        try {
+            test.function();
+        } catch (const RequireFailed&) {
+            // Already reported
+        } catch (const std::exception& e) {
+            ReportFailure(__FILE__, __LINE__, std::string(test.name) + " threw " + e.what());
+        }
+        run++;
+
+        bool passed = g_failures == before;
+        if (!passed) {
+            failedTests++;
+        }
+        std::printf("[%s] %s\n", passed ? "  OK  " : " FAIL ", test.name);
+    }
+
+    std::printf("%d test(s), %d failed\n", run, failedTests);
+    return failedTests == 0 && run > 0 ? 0 : 1;
+}
@@ -0,0 +1,198 @@
+#include "Test.h"
+#include "overlay/TextMetricsCache.h"
+
+using namespace VirtualOverlay;
+
+namespace {
+
+// Scripted provider: wide glyphs for anything outside ASCII, an overhang on
+// italic-looking 'f', and a failure for the font "Missing"
+struct FakeShaper {
+    int calls = 0;
+
+    bool operator()(const TextMetricsKey& key, TextMetrics& metrics) {
+        calls++;
+        if (key.fontFamily == L"Missing") {
+            return false;
+        }
+        float advance = 0.0f;
+        for (wchar_t c : key.text) {
+            advance += key.fontSize * (c < 0x80 ? 0.5f : 1.0f);
+        }
+        metrics.width = advance;
+        metrics.height = key.fontSize * 1.25f;
+        bool blank = key.text.find_first_not_of(L' ') == std::wstring::npos;
+        if (!blank) {
+            metrics.inkLeft = key.text.front() == L'f' ? -0.3f * key.fontSize : 0.05f * key.fontSize;
+            metrics.inkRight = advance - 0.05f * key.fontSize;
+            metrics.inkTop = 0.2f * key.fontSize;
+            metrics.inkBottom = 1.05f * key.fontSize;
+        }
+        return true;
+    }
+};
+
+TextMetricsKey Key(const std::wstring& text, float fontSize = 20.0f, const std::wstring& font = L"Segoe UI") {
+    return TextMetricsKey{ text, font, fontSize, 400 };
+}
+
+}  // namespace
+
+TEST(MeasuresOnceThenHits) {
+    FakeShaper shaper;
+    TextMetricsCache cache;
+    cache.SetProvider([&](const TextMetricsKey& key, TextMetrics& metrics) { return shaper(key, metrics); });
+
+    TextMetrics metrics;
+    REQUIRE(cache.Measure(Key(L"Desktop 1"), metrics));
+    CHECK_NEAR(metrics.width, 90.0, 1e-4);
+    REQUIRE(cache.Measure(Key(L"Desktop 1"), metrics));
+    CHECK_NEAR(metrics.width, 90.0, 1e-4);
+
+    CHECK_EQ(shaper.calls, 1);
+    CHECK_EQ(cache.GetStats().hits, 1u);
+    CHECK_EQ(cache.GetStats().misses, 1u);
+}
+
+TEST(EveryKeyFieldCounts) {
+    FakeShaper shaper;
+    TextMetricsCache cache;
+    cache.SetProvider([&](const TextMetricsKey& key, TextMetrics& metrics) { return shaper(key, metrics); });
+
+    TextMetrics metrics;
+    TextMetricsKey base = Key(L"Mail");
+    cache.Measure(base, metrics);
+    TextMetricsKey bolder = base;
+    bolder.fontWeight = 700;
+    cache.Measure(Key(L"mail"), metrics);
+    cache.Measure(Key(L"Mail", 20.5f), metrics);
+    cache.Measure(Key(L"Mail", 20.0f, L"Consolas"), metrics);
+    cache.Measure(bolder, metrics);
+    CHECK_EQ(shaper.calls, 5);
+    CHECK_EQ(cache.GetCount(), 5u);
+}
+
+TEST(WideGlyphsAreMeasuredNotEstimated) {
+    FakeShaper shaper;
+    TextMetricsCache cache;
+    cache.SetProvider([&](const TextMetricsKey& key, TextMetrics& metrics) { return shaper(key, metrics); });
+
+    // Four CJK characters are as wide as eight Latin ones; the old
+    // 0.6 x fontSize per character guessed 48 px for both
+    TextMetrics cjk;
+    TextMetrics latin;
+    REQUIRE(cache.Measure(Key(L"桌面一号"), cjk));
+    REQUIRE(cache.Measure(Key(L"Desktops"), latin));
+    CHECK_NEAR(cjk.width, 80.0, 1e-4);
+    CHECK_NEAR(cjk.width, latin.width, 1e-4);
+}
+
+TEST(FailuresAreRetried) {
+    FakeShaper shaper;
+    TextMetricsCache cache;
+    TextMetrics metrics;
+    CHECK(!cache.Measure(Key(L"No provider"), metrics));
+    CHECK_EQ(cache.GetStats().failures, 1u);
+
+    cache.SetProvider([&](const TextMetricsKey& key, TextMetrics& m) { return shaper(key, m); });
+    CHECK(!cache.Measure(Key(L"1", 20.0f, L"Missing"), metrics));
+    CHECK(!cache.Measure(Key(L"1", 20.0f, L"Missing"), metrics));
+    CHECK_EQ(shaper.calls, 2);  // Not cached
+    CHECK_EQ(cache.GetCount(), 0u);
+    CHECK_EQ(cache.GetStats().failures, 3u);
+
+    CHECK(cache.Measure(Key(L"No provider"), metrics));
+}
+
+TEST(EvictsLeastRecentlyUsed) {
+    FakeShaper shaper;
+    TextMetricsCache cache(2);
+    cache.SetProvider([&](const TextMetricsKey& key, TextMetrics& metrics) { return shaper(key, metrics); });
+
+    TextMetrics metrics;
+    cache.Measure(Key(L"a"), metrics);
+    cache.Measure(Key(L"b"), metrics);
+    cache.Measure(Key(L"a"), metrics);  // b is now the oldest
+    cache.Measure(Key(L"c"), metrics);
+    CHECK_EQ(cache.GetStats().evictions, 1u);
+    CHECK_EQ(shaper.calls, 3);
+
+    cache.Measure(Key(L"a"), metrics);
+    CHECK_EQ(shaper.calls, 3);
+    cache.Measure(Key(L"b"), metrics);
+    CHECK_EQ(shaper.calls, 4);
+
+    cache.Clear();
+    CHECK_EQ(cache.GetCount(), 0u);
+    cache.Measure(Key(L"a"), metrics);
+    CHECK_EQ(shaper.calls, 5);
+}
+
+TEST(ZeroCapacityStillCachesOne) {
+    FakeShaper shaper;
+    TextMetricsCache cache(0);
+    cache.SetProvider([&](const TextMetricsKey& key, TextMetrics& metrics) { return shaper(key, metrics); });
+    TextMetrics metrics;
+    cache.Measure(Key(L"a"), metrics);
+    cache.Measure(Key(L"a"), metrics);
+    CHECK_EQ(shaper.calls, 1);
+}
+
+TEST(FitInkBoundsCoversOverhang) {
+    FakeShaper shaper;
+    TextMetrics metrics;
+    REQUIRE(shaper(Key(L"fox"), metrics));
+    // Ink from -6 to 29, 4 to 21
+    int width = 0;
+    int height = 0;
+    FitInkBounds(metrics, 2, width, height);
+    CHECK_EQ(width, 35 + 4);
+    CHECK_EQ(height, 17 + 4);
+
+    TextMetrics fractional;
+    fractional.inkLeft = 0.5f;
+    fractional.inkRight = 10.25f;
+    fractional.inkTop = -0.5f;
+    fractional.inkBottom = 3.0f;
+    FitInkBounds(fractional, -1, width, height);  // Negative margin acts as 0
+    CHECK_EQ(width, 11);
+    CHECK_EQ(height, 4);
+}
+
+TEST(BlankTextGetsMinimalBitmap) {
+    FakeShaper shaper;
+    TextMetrics metrics;
+    REQUIRE(shaper(Key(L"   "), metrics));
+    int width = 0;
+    int height = 0;
+    FitInkBounds(metrics, 3, width, height);
+    CHECK_EQ(width, 7);
+    CHECK_EQ(height, 7);
+
+    // The layout box is centered instead of the (absent) ink
+    float left = 0.0f;
+    float top = 0.0f;
+    CenterInk(metrics, 100, 50, left, top);
+    CHECK_NEAR(left, 35.0, 0.0);   // (100 - 30) / 2
+    CHECK_NEAR(top, 13.0, 0.0);    // round((50 - 25) / 2)
+}
+
+TEST(CenterInkPlacesInkInTheMiddle) {
+    FakeShaper shaper;
+    TextMetrics metrics;
+    REQUIRE(shaper(Key(L"fox"), metrics));
+    int width = 0;
+    int height = 0;
+    FitInkBounds(metrics, 4, width, height);
+
+    float left = 0.0f;
+    float top = 0.0f;
+    CenterInk(metrics, width, height, left, top);
+    // Whole pixels, and the ink lands inside the bitmap with the margin
+    CHECK_EQ(left, std::round(left));
+    CHECK_EQ(top, std::round(top));
+    CHECK(left + metrics.inkLeft >= 3.5f);
+    CHECK(left + metrics.inkRight <= width - 3.5f);
+    CHECK(top + metrics.inkTop >= 3.5f);
+    CHECK(top + metrics.inkBottom <= height - 3.5f);
+}
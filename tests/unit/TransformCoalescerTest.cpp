@@ -0,0 +1,339 @@
+#include "Test.h"
+#include "ZoomTraceFiles.h"
+#include "zoom/TransformCoalescer.h"
+#include "zoom/ZoomMotion.h"
+#include "zoom/ZoomReplay.h"
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace VirtualOverlay;
+
+namespace {
+
+const std::string SESSION_TRACE = std::string(VO_TEST_DATA_DIR) + "/zoom/session-3mon.vozt";
+const std::string PAN_HOLD_TRACE = std::string(VO_TEST_DATA_DIR) + "/zoom/zoom-pan-hold.vozt";
+
+const ZoomRect VIEW = { 0, 0, 1920, 1080 };
+
+MagnifierTransform MakeTransform(float level, int offsetX, int offsetY) {
+    MagnifierTransform transform;
+    transform.level = level;
+    transform.offsetX = offsetX;
+    transform.offsetY = offsetY;
+    return transform;
+}
+
+// A transform ZoomMotion offered to the coalescer, with what it knew then
+struct Offer {
+    double timeMs = 0.0;
+    MagnifierTransform transform;
+    ZoomRect view;
+    bool settled = false;
+    bool newSession = false;    // The magnifier was off: the coalescer resets
+};
+
+// With coalescing off, every transform ZoomMotion computes that differs
+// from the last one reaches the backend; this one notes the motion's state
+// alongside
+class OfferRecorder : public MagnifierBackend {
+public:
+    OfferRecorder(const ZoomMotion& motion, const double& timeMs) : m_motion(motion), m_timeMs(timeMs) {}
+
+    bool SetFullscreenTransform(const MagnifierTransform& transform) override {
+        Offer offer;
+        offer.timeMs = m_timeMs;
+        offer.transform = transform;
+        m_motion.GetPanRect(offer.view);
+        offer.settled = m_motion.GetCurrentLevel() == m_motion.GetTargetLevel() &&
+                        m_motion.GetOffsetX() == m_motion.GetTargetOffsetX() &&
+                        m_motion.GetOffsetY() == m_motion.GetTargetOffsetY();
+        offer.newSession = !m_active;
+        m_offers.push_back(offer);
+        m_active = true;
+        return true;
+    }
+
+    bool ResetMagnification() override {
+        m_active = false;
+        return true;
+    }
+
+    bool IsInitialized() const override { return m_active; }
+
+    const std::vector<Offer>& GetOffers() const { return m_offers; }
+
+private:
+    const ZoomMotion& m_motion;
+    const double& m_timeMs;
+    std::vector<Offer> m_offers;
+    bool m_active = false;
+};
+
+// Runs a trace through ZoomMotion the way ReplayZoomTrace does, with
+// coalescing off, and returns every distinct transform it produced
+std::vector<Offer> RecordOffers(const ZoomTrace& trace, float smoothingFactor) {
+    ZoomMotionConfig config;
+    config.smoothingFactor = smoothingFactor;
+    config.coalescing.thresholdPx = 0.0f;
+    config.coalescing.refreshHz = 0.0f;
+
+    ZoomMotion motion;
+    double timeMs = 0.0;
+    OfferRecorder recorder(motion, timeMs);
+    motion.SetConfig(config);
+    motion.SetGeometry(MakeScreenGeometry(trace.monitors, 1));
+    motion.SetBackend(&recorder);
+
+    int64_t origin = trace.events.empty() ? 0 : trace.events.front().time;
+    for (const ZoomInputEvent& event : trace.events) {
+        switch (event.kind) {
+            case ZoomInputKind::Tick:
+                timeMs += event.value;
+                motion.Update(event.value);
+                break;
+            case ZoomInputKind::Wheel:
+                if (event.value > 0.0f) {
+                    motion.ZoomIn(event.x, event.y);
+                } else {
+                    motion.ZoomOut(event.x, event.y);
+                }
+                break;
+            case ZoomInputKind::Gesture:
+                motion.ZoomToLevel(event.value, event.x, event.y);
+                break;
+            case ZoomInputKind::Reset:
+                motion.ResetZoom();
+                break;
+            case ZoomInputKind::ModifierDown:
+                motion.OnModifierPressed(static_cast<uint64_t>(trace.ToMilliseconds(event.time - origin)));
+                break;
+            case ZoomInputKind::ModifierUp:
+                motion.OnModifierReleased();
+                break;
+            case ZoomInputKind::Cursor:
+                motion.OnCursorMove(event.x, event.y);
+                break;
+        }
+    }
+    return recorder.GetOffers();
+}
+
+struct SequenceResult {
+    size_t offered = 0;
+    size_t issued = 0;
+};
+
+// Feeds a recorded sequence to a coalescer and checks every decision
+// against the rules: no repeat, at most one per refresh interval, moving
+// steps at least thresholdPx, and the settled transform of each session
+// issued (a settled transform that was rate limited is offered again on the
+// next tick, as ZoomMotion does every tick)
+SequenceResult CheckSequence(const std::vector<Offer>& offers, const TransformCoalescingConfig& config) {
+    TransformCoalescer coalescer;
+    coalescer.SetConfig(config);
+    SequenceResult result;
+    bool hasLast = false;
+    MagnifierTransform last;
+    double lastMs = 0.0;
+
+    for (size_t i = 0; i < offers.size(); i++) {
+        const Offer& offer = offers[i];
+        if (offer.newSession) {
+            coalescer.Reset();
+            hasLast = false;
+        }
+
+        bool issued = coalescer.ShouldIssue(offer.transform, offer.view, offer.timeMs, offer.settled);
+        bool sessionEnds = i + 1 == offers.size() || offers[i + 1].newSession;
+        double retryMs = offer.timeMs;
+        while (!issued && offer.settled && sessionEnds && retryMs < offer.timeMs + 100.0) {
+            retryMs += 16.0;
+            issued = coalescer.ShouldIssue(offer.transform, offer.view, retryMs, true);
+        }
+
+        result.offered++;
+        if (!hasLast) {
+            CHECK(issued);
+        } else if (issued) {
+            CHECK(offer.transform != last);
+            if (config.refreshHz > 0.0f) {
+                CHECK(std::floor(retryMs * config.refreshHz / 1000.0) > std::floor(lastMs * config.refreshHz / 1000.0));
+            }
+            if (!offer.settled && config.thresholdPx > 0.0f) {
+                CHECK(TransformCoalescer::GetDisplacementPx(last, offer.transform, offer.view) >= config.thresholdPx);
+            }
+        } else if (config.thresholdPx > 0.0f && !offer.settled &&
+                   TransformCoalescer::GetDisplacementPx(last, offer.transform, offer.view) >= config.thresholdPx) {
+            // Big enough: only the rate limit may have held it back
+            CHECK(config.refreshHz > 0.0f);
+            CHECK(std::floor(offer.timeMs * config.refreshHz / 1000.0) == std::floor(lastMs * config.refreshHz / 1000.0));
+        }
+        if (sessionEnds && offer.settled) {
+            CHECK(issued);
+        }
+
+        if (issued) {
+            hasLast = true;
+            last = offer.transform;
+            lastMs = retryMs;
+            result.issued++;
+        }
+    }
+    CHECK_EQ(static_cast<uint64_t>(result.issued), coalescer.GetStats().issued);
+    return result;
+}
+
+uint64_t CountCalls(const ZoomTrace& trace, float smoothingFactor, float thresholdPx, float refreshHz,
+                    MagnifierTransform* lastCall = nullptr) {
+    ZoomMotionConfig config;
+    config.smoothingFactor = smoothingFactor;
+    config.coalescing.thresholdPx = thresholdPx;
+    config.coalescing.refreshHz = refreshHz;
+    RecordingMagnifierBackend backend;
+    ZoomReplayReport report = ReplayZoomTrace(trace, config, backend);
+    if (lastCall && !backend.GetCalls().empty()) {
+        *lastCall = backend.GetCalls().back();
+    }
+    return report.setCalls;
+}
+
+}  // namespace
+
+TEST(FirstTransformIssuesAndRepeatsAreDropped) {
+    TransformCoalescer coalescer;
+    MagnifierTransform transform = MakeTransform(2.0f, 100, 100);
+    CHECK(coalescer.ShouldIssue(transform, VIEW, 0.0, false));
+    CHECK(!coalescer.ShouldIssue(transform, VIEW, 100.0, true));
+    CHECK_EQ(coalescer.GetStats().issued, 1u);
+    CHECK_EQ(coalescer.GetStats().unchanged, 1u);
+}
+
+TEST(SmallStepsWaitUntilSettled) {
+    TransformCoalescer coalescer;
+    CHECK(coalescer.ShouldIssue(MakeTransform(2.0f, 480, 270), VIEW, 0.0, false));
+
+    // 2.000 -> 2.0004 about the same offset moves the far edge by 0.38 px
+    MagnifierTransform step = MakeTransform(2.0004f, 480, 270);
+    CHECK(TransformCoalescer::GetDisplacementPx(MakeTransform(2.0f, 480, 270), step, VIEW) < 1.0f);
+    CHECK(!coalescer.ShouldIssue(step, VIEW, 100.0, false));
+    CHECK_EQ(coalescer.GetStats().belowThreshold, 1u);
+    CHECK(coalescer.ShouldIssue(step, VIEW, 200.0, true));
+}
+
+TEST(OneTransformPerRefresh) {
+    TransformCoalescingConfig config;
+    config.refreshHz = 60.0f;
+    TransformCoalescer coalescer;
+    coalescer.SetConfig(config);
+    CHECK(coalescer.ShouldIssue(MakeTransform(2.0f, 0, 0), VIEW, 0.0, false));
+    CHECK(!coalescer.ShouldIssue(MakeTransform(2.0f, 10, 0), VIEW, 16.0, false));
+    CHECK(coalescer.ShouldIssue(MakeTransform(2.0f, 20, 0), VIEW, 16.7, false));
+    CHECK(!coalescer.ShouldIssue(MakeTransform(2.0f, 30, 0), VIEW, 33.0, true));   // Settled or not
+    CHECK_EQ(coalescer.GetStats().rateLimited, 2u);
+}
+
+TEST(ZeroDisablesThresholdAndRate) {
+    TransformCoalescingConfig config;
+    config.thresholdPx = 0.0f;
+    config.refreshHz = 0.0f;
+    TransformCoalescer coalescer;
+    coalescer.SetConfig(config);
+    for (int i = 0; i < 10; i++) {
+        CHECK(coalescer.ShouldIssue(MakeTransform(2.0f + i * 0.0001f, 480, 270), VIEW, 0.0, false));
+    }
+    CHECK_EQ(coalescer.GetStats().GetSuppressed(), 0u);
+}
+
+TEST(ResetIssuesTheNextTransform) {
+    TransformCoalescer coalescer;
+    MagnifierTransform transform = MakeTransform(3.0f, 10, 10);
+    CHECK(coalescer.ShouldIssue(transform, VIEW, 0.0, false));
+    coalescer.Reset();
+    CHECK(coalescer.ShouldIssue(transform, VIEW, 1.0, false));
+}
+
+TEST(DisplacementIsMeasuredOnScreen) {
+    MagnifierTransform from = MakeTransform(2.0f, 100, 100);
+    CHECK_EQ(TransformCoalescer::GetDisplacementPx(from, from, VIEW), 0.0f);
+    // One source pixel of pan at 2x is two screen pixels
+    CHECK_NEAR(TransformCoalescer::GetDisplacementPx(from, MakeTransform(2.0f, 101, 100), VIEW), 2.0, 1e-4);
+    CHECK_NEAR(TransformCoalescer::GetDisplacementPx(from, MakeTransform(2.0f, 100, 97), VIEW), 6.0, 1e-4);
+    // A level step grows towards the view edge: 1920 * (2.001 / 2 - 1)
+    CHECK_NEAR(TransformCoalescer::GetDisplacementPx(MakeTransform(2.0f, 0, 0), MakeTransform(2.001f, 0, 0), VIEW),
+               0.96, 1e-3);
+    // Invalid levels count as a jump across the whole view
+    CHECK_EQ(TransformCoalescer::GetDisplacementPx(MakeTransform(0.0f, 0, 0), from, VIEW), 1920.0f);
+}
+
+TEST(RecordedSessionDecisions) {
+    ZoomTrace trace;
+    REQUIRE(LoadZoomTrace(SESSION_TRACE, trace));
+    for (float smoothing : { 0.08f, 0.20f }) {
+        std::vector<Offer> offers = RecordOffers(trace, smoothing);
+        REQUIRE(!offers.empty());
+        for (float threshold : { 0.0f, 1.0f, 2.0f }) {
+            for (float rate : { 0.0f, 60.0f, 144.0f }) {
+                TransformCoalescingConfig config;
+                config.thresholdPx = threshold;
+                config.refreshHz = rate;
+                SequenceResult result = CheckSequence(offers, config);
+                CHECK(result.issued <= result.offered);
+            }
+        }
+    }
+}
+
+TEST(RecordedPanHoldDecisions) {
+    ZoomTrace trace;
+    REQUIRE(LoadZoomTrace(PAN_HOLD_TRACE, trace));
+    std::vector<Offer> offers = RecordOffers(trace, 0.08f);
+    REQUIRE(!offers.empty());
+    CHECK(offers.back().settled);
+    for (float threshold : { 0.5f, 1.0f, 4.0f, 8.0f }) {
+        for (float rate : { 0.0f, 30.0f, 60.0f, 240.0f }) {
+            TransformCoalescingConfig config;
+            config.thresholdPx = threshold;
+            config.refreshHz = rate;
+            CheckSequence(offers, config);
+        }
+    }
+}
+
+TEST(PanHoldSettlesOnTheUncoalescedTransform) {
+    // However the steps were thinned out, the view ends where it would
+    // have without coalescing
+    ZoomTrace trace;
+    REQUIRE(LoadZoomTrace(PAN_HOLD_TRACE, trace));
+    MagnifierTransform reference;
+    uint64_t uncoalesced = CountCalls(trace, 0.08f, 0.0f, 0.0f, &reference);
+    for (float threshold : { 0.5f, 1.0f, 4.0f, 8.0f }) {
+        for (float rate : { 0.0f, 30.0f, 60.0f, 240.0f }) {
+            MagnifierTransform last;
+            uint64_t calls = CountCalls(trace, 0.08f, threshold, rate, &last);
+            CHECK(last == reference);
+            CHECK(calls <= uncoalesced);
+        }
+    }
+}
+
+TEST(SessionCallCounts) {
+    // The figures quoted for the coalescer: the default 1 px / 60 Hz takes
+    // 484 calls down to 442 at smoothing 0.08, and 583 down to 481 at 0.20
+    ZoomTrace trace;
+    REQUIRE(LoadZoomTrace(SESSION_TRACE, trace));
+    struct {
+        float smoothing;
+        uint64_t uncoalesced;
+        uint64_t coalesced;
+    } cases[] = { { 0.08f, 484, 442 }, { 0.20f, 583, 481 } };
+    for (const auto& c : cases) {
+        uint64_t off = CountCalls(trace, c.smoothing, 0.0f, 0.0f);
+        uint64_t on = CountCalls(trace, c.smoothing, 1.0f, 60.0f);
+        std::printf("  smoothing %.2f: %llu calls uncoalesced, %llu coalesced\n", c.smoothing,
+                    static_cast<unsigned long long>(off), static_cast<unsigned long long>(on));
+        CHECK_EQ(off, c.uncoalesced);
+        CHECK_EQ(on, c.coalesced);
+    }
+}
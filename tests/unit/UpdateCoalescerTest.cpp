@@ -0,0 +1,200 @@
+#include "Test.h"
+#include "overlay/UpdateCoalescer.h"
+#include <algorithm>
+#include <cstdio>
+
+using namespace VirtualOverlay;
+
+namespace {
+
+// SetTimer never fires sooner than this (USER_TIMER_MINIMUM)
+constexpr uint64_t TIMER_MINIMUM_MS = 10;
+
+struct ReplayResult {
+    uint64_t received = 0;
+    uint64_t rendered = 0;
+    std::vector<int> shown;         // Desktop index of every rendered frame
+    std::vector<uint64_t> frameMs;  // When each frame was rendered
+    uint64_t maxWaitMs = 0;
+};
+
+// Replays switch times on a virtual clock the way OverlayWindow does: every
+// Show submits and pumps, and the pump re-arms a timer for the next deadline.
+// Switch n shows desktop n.
+ReplayResult Replay(const char* name, const std::vector<uint64_t>& switchMs,
+                    const UpdateCoalescingConfig& config = UpdateCoalescingConfig()) {
+    UpdateCoalescer coalescer(config);
+    ReplayResult result;
+    bool timerArmed = false;
+    uint64_t timerMs = 0;
+
+    auto pump = [&](uint64_t now) {
+        OverlayUpdate update;
+        if (coalescer.Take(now, update)) {
+            result.shown.push_back(update.desktopIndex);
+            result.frameMs.push_back(now);
+        }
+        uint64_t dueMs;
+        timerArmed = coalescer.GetNextDeadline(dueMs);
+        if (timerArmed) {
+            timerMs = now + std::max(dueMs > now ? dueMs - now : 0, TIMER_MINIMUM_MS);
+        }
+    };
+
+    size_t next = 0;
+    while (next < switchMs.size() || timerArmed) {
+        if (next < switchMs.size() && (!timerArmed || switchMs[next] <= timerMs)) {
+            OverlayUpdate update;
+            update.desktopIndex = static_cast<int>(next);
+            coalescer.Submit(update, switchMs[next]);
+            pump(switchMs[next]);
+            next++;
+        } else {
+            pump(timerMs);
+        }
+    }
+
+    const UpdateCoalescerStats& stats = coalescer.GetStats();
+    result.received = stats.received;
+    result.rendered = stats.rendered;
+    result.maxWaitMs = stats.maxWaitMs;
+    std::printf("  %-22s %3llu switches -> %3llu frames, max wait %llu ms\n", name,
+                static_cast<unsigned long long>(result.received),
+                static_cast<unsigned long long>(result.rendered),
+                static_cast<unsigned long long>(result.maxWaitMs));
+    return result;
+}
+
+// count switches, one every periodMs starting at startMs
+std::vector<uint64_t> Burst(uint64_t startMs, uint64_t periodMs, int count) {
+    std::vector<uint64_t> times;
+    for (int i = 0; i < count; i++) {
+        times.push_back(startMs + periodMs * i);
+    }
+    return times;
+}
+
+// Holds for every trace: the last switch is what stays on screen, frames
+// respect the frame interval, and nothing waits past maxLatencyMs (plus one
+// timer tick of slack)
+void CheckInvariants(const ReplayResult& result, const UpdateCoalescingConfig& config) {
+    REQUIRE(!result.shown.empty());
+    CHECK_EQ(result.shown.back(), static_cast<int>(result.received) - 1);
+    CHECK(std::is_sorted(result.shown.begin(), result.shown.end()));
+    for (size_t i = 1; i < result.frameMs.size(); i++) {
+        CHECK(result.frameMs[i] - result.frameMs[i - 1] >= config.frameIntervalMs);
+    }
+    CHECK(result.maxWaitMs <= config.maxLatencyMs + TIMER_MINIMUM_MS);
+}
+
+}  // namespace
+
+TEST(SingleSwitchIsImmediate) {
+    ReplayResult result = Replay("single switch", { 1000 });
+    CHECK_EQ(result.rendered, 1u);
+    CHECK_EQ(result.frameMs.front(), 1000u);
+    CHECK_EQ(result.maxWaitMs, 0u);
+}
+
+TEST(SpacedSwitchesEachRender) {
+    // Deliberate switches a quarter of a second apart are never merged
+    ReplayResult result = Replay("spaced 250 ms", Burst(0, 250, 8));
+    CHECK_EQ(result.rendered, 8u);
+    CHECK_EQ(result.maxWaitMs, 0u);
+    CheckInvariants(result, UpdateCoalescingConfig());
+}
+
+TEST(HeldKeyAcrossTenDesktops) {
+    // Keyboard auto-repeat at ~30 Hz: the first desktop shows at once, the
+    // rest are thinned out and the last one lands after settleMs
+    UpdateCoalescingConfig config;
+    ReplayResult result = Replay("held key 33 ms", Burst(0, 33, 10), config);
+    CheckInvariants(result, config);
+    CHECK_EQ(result.frameMs.front(), 0u);
+    CHECK(result.rendered <= 4u);
+    CHECK_EQ(result.frameMs.back(), 297u + config.settleMs);
+}
+
+TEST(MashedHotkeysCollapse) {
+    // 40 switches 8 ms apart (a macro or a held key with fast repeat)
+    UpdateCoalescingConfig config;
+    ReplayResult result = Replay("mashed 8 ms", Burst(0, 8, 40), config);
+    CheckInvariants(result, config);
+    // One leading frame, then at most one per maxLatencyMs while it lasts
+    uint64_t burstMs = 8 * 39;
+    CHECK(result.rendered <= 2 + burstMs / config.maxLatencyMs);
+    CHECK(result.rendered >= burstMs / (config.maxLatencyMs + TIMER_MINIMUM_MS));
+}
+
+TEST(SwitchesFasterThanTheTimer) {
+    // Several switches inside one timer tick
+    UpdateCoalescingConfig config;
+    ReplayResult result = Replay("sub-tick 2 ms", Burst(500, 2, 25), config);
+    CheckInvariants(result, config);
+    CHECK_EQ(result.rendered, 2u);
+    CHECK_EQ(result.shown.front(), 0);
+}
+
+TEST(BurstsSeparatedBySettle) {
+    // Two bursts with a pause longer than settleMs: both lead immediately
+    UpdateCoalescingConfig config;
+    std::vector<uint64_t> trace = Burst(0, 20, 6);
+    std::vector<uint64_t> second = Burst(600, 20, 6);
+    trace.insert(trace.end(), second.begin(), second.end());
+    ReplayResult result = Replay("two bursts", trace, config);
+    CheckInvariants(result, config);
+    REQUIRE(result.rendered >= 4u);
+    CHECK(std::find(result.frameMs.begin(), result.frameMs.end(), 600u) != result.frameMs.end());
+    CHECK(std::find(result.shown.begin(), result.shown.end(), 5) != result.shown.end());
+}
+
+TEST(TightLatencyRendersMore) {
+    UpdateCoalescingConfig tight;
+    tight.settleMs = 20;
+    tight.maxLatencyMs = 40;
+    ReplayResult fast = Replay("mashed 8 ms, tight", Burst(0, 8, 40), tight);
+    ReplayResult normal = Replay("mashed 8 ms, default", Burst(0, 8, 40));
+    CheckInvariants(fast, tight);
+    CHECK(fast.rendered > normal.rendered);
+}
+
+TEST(TakeBeforeTheDeadlineFails) {
+    UpdateCoalescer coalescer;
+    OverlayUpdate update;
+    update.desktopIndex = 1;
+    coalescer.Submit(update, 0);
+    CHECK(coalescer.Take(0, update));
+
+    update.desktopIndex = 2;
+    coalescer.Submit(update, 10);
+    uint64_t dueMs = 0;
+    REQUIRE(coalescer.GetNextDeadline(dueMs));
+    CHECK_EQ(dueMs, 50u);
+    CHECK(!coalescer.Take(49, update));
+    CHECK(coalescer.Take(50, update));
+    CHECK_EQ(update.desktopIndex, 2);
+    CHECK(!coalescer.GetNextDeadline(dueMs));
+}
+
+TEST(ResetDropsThePendingUpdate) {
+    UpdateCoalescer coalescer;
+    OverlayUpdate update;
+    coalescer.Submit(update, 0);
+    coalescer.Take(0, update);
+    coalescer.Submit(update, 5);
+    coalescer.Reset();
+    CHECK(!coalescer.IsPending());
+    CHECK_EQ(coalescer.GetStats().rendered, 1u);
+    CHECK_EQ(coalescer.GetStats().received, 2u);
+}
+
+TEST(ClampsTheConfig) {
+    UpdateCoalescingConfig config;
+    config.frameIntervalMs = 0;
+    config.settleMs = 5000;
+    config.maxLatencyMs = 0;
+    UpdateCoalescer coalescer(config);
+    CHECK_EQ(coalescer.GetConfig().frameIntervalMs, 1u);
+    CHECK_EQ(coalescer.GetConfig().settleMs, 1000u);
+    CHECK_EQ(coalescer.GetConfig().maxLatencyMs, 1u);
+}
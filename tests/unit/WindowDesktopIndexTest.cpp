@@ -0,0 +1,361 @@
+#include "Test.h"
+#include "desktop/WindowDesktopIndex.h"
+#include <cstdint>
+#include <map>
+#include <random>
+#include <set>
+#include <vector>
+
+using namespace VirtualOverlay;
+
+namespace {
+
+using WindowKey = WindowDesktopIndex::WindowKey;
+
+DesktopGuid MakeId(uint8_t seed) {
+    DesktopGuid id;
+    for (size_t i = 0; i < DesktopGuid::SIZE; i++) {
+        id.bytes[i] = static_cast<uint8_t>(seed * 29 + i + 1);
+    }
+    return id;
+}
+
+std::vector<DesktopGuid> MakeDesktops(uint8_t count) {
+    std::vector<DesktopGuid> desktops;
+    for (uint8_t i = 0; i < count; i++) {
+        desktops.push_back(MakeId(i));
+    }
+    return desktops;
+}
+
+// What the index should hold for a window
+struct ModelEntry {
+    DesktopGuid desktop;
+    uint32_t traits = 0;
+    uint64_t firstSeenMs = 0;
+    bool stale = false;
+};
+
+// Every indexed window sits in its desktop's list at its slot, and every
+// list member is indexed on that desktop
+void CheckMatchesModel(const WindowDesktopIndex& index, const std::map<WindowKey, ModelEntry>& model,
+                       const std::vector<DesktopGuid>& desktops) {
+    REQUIRE(index.GetWindowCount() == model.size());
+    for (const auto& pair : model) {
+        const WindowDesktopIndex::WindowEntry* entry = index.Find(pair.first);
+        REQUIRE(entry != nullptr);
+        CHECK(entry->desktop == pair.second.desktop);
+        CHECK_EQ(entry->traits, pair.second.traits);
+        CHECK_EQ(entry->firstSeenMs, pair.second.firstSeenMs);
+        CHECK_EQ(entry->stale, pair.second.stale);
+        const std::vector<WindowKey>* windows = index.GetWindows(entry->desktop);
+        REQUIRE(windows != nullptr);
+        REQUIRE(entry->slot < windows->size());
+        CHECK_EQ((*windows)[entry->slot], pair.first);
+    }
+
+    size_t listed = 0;
+    for (const DesktopGuid& desktop : desktops) {
+        const std::vector<WindowKey>* windows = index.GetWindows(desktop);
+        if (!windows) {
+            CHECK_EQ(index.GetWindowCount(desktop), 0u);
+            CHECK_EQ(index.GetRevision(desktop), 0u);
+            continue;
+        }
+        CHECK(!windows->empty());
+        CHECK_EQ(index.GetWindowCount(desktop), windows->size());
+        std::set<WindowKey> unique(windows->begin(), windows->end());
+        CHECK_EQ(unique.size(), windows->size());
+        for (WindowKey window : *windows) {
+            auto it = model.find(window);
+            REQUIRE(it != model.end());
+            CHECK(it->second.desktop == desktop);
+        }
+        listed += windows->size();
+    }
+    CHECK_EQ(listed, model.size());
+}
+
+// The probe's view of the world: where each window really is, which ones
+// were destroyed behind the index's back, and the current desktop
+struct World {
+    std::map<WindowKey, DesktopGuid> actual;
+    std::set<WindowKey> gone;
+    DesktopGuid current;
+
+    // Like VirtualDesktop's probe: a destroyed window or one that is no
+    // longer where the index says fails, the rest answer truthfully
+    WindowProbeResult Probe(WindowKey window, const DesktopGuid& indexed) const {
+        auto it = actual.find(window);
+        if (gone.count(window) || it == actual.end() || it->second != indexed) {
+            return WindowProbeResult::Failed;
+        }
+        return it->second == current ? WindowProbeResult::OnCurrent : WindowProbeResult::NotOnCurrent;
+    }
+};
+
+// Every indexed window probed: a window answering OnCurrent names the
+// desktop, otherwise the only desktop without a truthful window does
+DesktopGuid BruteForceCurrent(const WindowDesktopIndex& index, const World& world,
+                              const std::vector<DesktopGuid>& desktops) {
+    std::vector<DesktopGuid> candidates;
+    for (const DesktopGuid& desktop : desktops) {
+        bool eliminated = false;
+        const std::vector<WindowKey>* windows = index.GetWindows(desktop);
+        for (size_t i = 0; windows && i < windows->size(); i++) {
+            WindowProbeResult result = world.Probe((*windows)[i], desktop);
+            if (result == WindowProbeResult::OnCurrent) {
+                return desktop;
+            }
+            if (result == WindowProbeResult::NotOnCurrent) {
+                eliminated = true;
+            }
+        }
+        if (!eliminated) {
+            candidates.push_back(desktop);
+        }
+    }
+    return candidates.size() == 1 ? candidates[0] : DesktopGuid();
+}
+
+}  // namespace
+
+TEST(AssignAndRemove) {
+    WindowDesktopIndex index;
+    DesktopGuid a = MakeId(1);
+    DesktopGuid b = MakeId(2);
+
+    CHECK(index.Assign(10, a, 100));
+    CHECK(index.Assign(11, a, 200, WINDOW_TRAIT_TOOL));
+    CHECK(!index.Assign(10, a, 300));             // Unchanged
+    CHECK_EQ(index.Find(10)->firstSeenMs, 100u);
+    CHECK(index.Assign(11, a, 300));              // Traits cleared
+    CHECK_EQ(index.Find(11)->traits, 0u);
+    CHECK(index.Assign(10, b, 400));              // Moved, first seen kept
+    CHECK_EQ(index.Find(10)->firstSeenMs, 100u);
+    CHECK_EQ(index.GetWindowCount(a), 1u);
+    CHECK_EQ(index.GetWindowCount(b), 1u);
+
+    CHECK(index.Remove(11));
+    CHECK(!index.Remove(11));
+    CHECK(index.GetWindows(a) == nullptr);
+    CHECK_EQ(index.GetRevision(a), 0u);
+    CHECK(!index.Contains(11));
+
+    std::vector<DesktopGuid> collected;
+    index.CollectDesktops(collected);
+    REQUIRE(collected.size() == 1u);
+    CHECK(collected[0] == b);
+
+    index.Clear();
+    CHECK_EQ(index.GetWindowCount(), 0u);
+    CHECK(index.GetWindows(b) == nullptr);
+}
+
+TEST(SwapRemoveFixesTheMovedSlot) {
+    WindowDesktopIndex index;
+    DesktopGuid a = MakeId(1);
+    for (WindowKey window = 1; window <= 4; window++) {
+        index.Assign(window, a, 0);
+    }
+
+    // Removing the first moves the last into its slot
+    CHECK(index.Remove(1));
+    const std::vector<WindowKey>* windows = index.GetWindows(a);
+    REQUIRE(windows != nullptr);
+    REQUIRE(windows->size() == 3u);
+    CHECK_EQ((*windows)[0], 4u);
+    CHECK_EQ(index.Find(4)->slot, 0u);
+
+    // Removing the last moves nothing
+    CHECK(index.Remove(3));
+    CHECK_EQ(windows->size(), 2u);
+    CHECK_EQ(index.Find(4)->slot, 0u);
+    CHECK_EQ(index.Find(2)->slot, 1u);
+
+    // Moving away is a remove too
+    CHECK(index.Assign(4, MakeId(2), 0));
+    CHECK_EQ((*windows)[0], 2u);
+    CHECK_EQ(index.Find(2)->slot, 0u);
+}
+
+TEST(RevisionsArePerDesktop) {
+    WindowDesktopIndex index;
+    DesktopGuid a = MakeId(1);
+    DesktopGuid b = MakeId(2);
+    index.Assign(1, a, 0);
+    index.Assign(2, b, 0);
+    uint64_t revA = index.GetRevision(a);
+    uint64_t revB = index.GetRevision(b);
+    CHECK(revA != 0 && revB != 0);
+
+    index.Assign(3, a, 0);
+    CHECK(index.GetRevision(a) > revA);
+    CHECK_EQ(index.GetRevision(b), revB);
+    revA = index.GetRevision(a);
+
+    index.Assign(3, a, 0, WINDOW_TRAIT_OWNED);    // Traits are part of the set
+    CHECK(index.GetRevision(a) > revA);
+    revA = index.GetRevision(a);
+
+    index.Assign(3, a, 0, WINDOW_TRAIT_OWNED);    // No change, no bump
+    index.MarkStale(1);                           // Nor for a stale mark
+    CHECK_EQ(index.GetRevision(a), revA);
+
+    index.Assign(1, b, 0);                        // Both ends of a move
+    CHECK(index.GetRevision(a) > revA);
+    CHECK(index.GetRevision(b) > revB);
+}
+
+TEST(StaleIsClearedByAssign) {
+    WindowDesktopIndex index;
+    DesktopGuid a = MakeId(1);
+    index.Assign(1, a, 0);
+    index.MarkStale(1);
+    index.MarkStale(99);                          // Unknown: ignored
+    CHECK(index.Find(1)->stale);
+    CHECK(!index.Contains(99));
+
+    // Confirmed where it was: no change reported, but no longer stale
+    CHECK(!index.Assign(1, a, 0));
+    CHECK(!index.Find(1)->stale);
+
+    index.MarkStale(1);
+    CHECK(index.Assign(1, MakeId(2), 0));
+    CHECK(!index.Find(1)->stale);
+}
+
+TEST(RandomChurnMatchesModel) {
+    // About 2,000 windows created, moved, re-flagged, marked stale and
+    // destroyed over 12 desktops; after every step the index matches a plain
+    // map and only the desktops the step touched have new revisions
+    const std::vector<DesktopGuid> desktops = MakeDesktops(12);
+    WindowDesktopIndex index;
+    std::map<WindowKey, ModelEntry> model;
+    std::mt19937 rng(11);
+    uint64_t lastRevision = 0;
+
+    for (uint64_t step = 0; step < 30000; step++) {
+        std::vector<uint64_t> before;
+        for (const DesktopGuid& desktop : desktops) {
+            before.push_back(index.GetRevision(desktop));
+        }
+
+        WindowKey window = 1 + rng() % 2400;
+        std::set<size_t> touched;
+        uint32_t op = rng() % 10;
+        auto it = model.find(window);
+        if (op < 6) {
+            size_t target = rng() % desktops.size();
+            uint32_t traits = rng() % 8 == 0 ? WINDOW_TRAIT_TOOL : 0;
+            bool changed = true;
+            if (it == model.end()) {
+                ModelEntry entry;
+                entry.desktop = desktops[target];
+                entry.traits = traits;
+                entry.firstSeenMs = step;
+                model[window] = entry;
+            } else {
+                ModelEntry& entry = it->second;
+                changed = entry.desktop != desktops[target] || entry.traits != traits;
+                for (size_t d = 0; d < desktops.size() && entry.desktop != desktops[target]; d++) {
+                    if (desktops[d] == entry.desktop) {
+                        touched.insert(d);
+                    }
+                }
+                entry.desktop = desktops[target];
+                entry.traits = traits;
+                entry.stale = false;
+            }
+            if (changed) {
+                touched.insert(target);
+            }
+            CHECK_EQ(index.Assign(window, desktops[target], step, traits), changed);
+        } else if (op < 9) {
+            if (it != model.end()) {
+                for (size_t d = 0; d < desktops.size(); d++) {
+                    if (desktops[d] == it->second.desktop) {
+                        touched.insert(d);
+                    }
+                }
+                model.erase(it);
+            }
+            CHECK_EQ(index.Remove(window), !touched.empty());
+        } else {
+            if (it != model.end()) {
+                it->second.stale = true;
+            }
+            index.MarkStale(window);
+        }
+
+        for (size_t d = 0; d < desktops.size(); d++) {
+            uint64_t revision = index.GetRevision(desktops[d]);
+            if (!touched.count(d)) {
+                CHECK_EQ(revision, before[d]);
+            } else if (revision != 0) {
+                CHECK(revision > lastRevision);
+            }
+        }
+        for (size_t d : touched) {
+            uint64_t revision = index.GetRevision(desktops[d]);
+            lastRevision = revision > lastRevision ? revision : lastRevision;
+        }
+
+        if (step % 64 == 0) {
+            CheckMatchesModel(index, model, desktops);
+        }
+    }
+    CheckMatchesModel(index, model, desktops);
+    CHECK(model.size() > 1000u);
+}
+
+TEST(EliminationMatchesBruteForce) {
+    // Random worlds over one index: some windows destroyed or moved without
+    // the index knowing, some desktops empty. Probing every window decides
+    // exactly like the brute-force scan; with a probe budget the answer is
+    // the same or undecided, never a different desktop
+    std::mt19937 rng(23);
+    int decided = 0;
+    int direct = 0;
+    for (int round = 0; round < 300; round++) {
+        const std::vector<DesktopGuid> desktops = MakeDesktops(static_cast<uint8_t>(2 + rng() % 10));
+        WindowDesktopIndex index;
+        World world;
+        size_t windowCount = rng() % 2 ? 2000 : rng() % 12;
+        for (WindowKey window = 1; window <= windowCount; window++) {
+            // Leave the last desktop empty half the time
+            size_t limit = desktops.size() - (round % 2);
+            const DesktopGuid& desktop = desktops[rng() % limit];
+            index.Assign(window, desktop, 0);
+            world.actual[window] = desktop;
+            uint32_t fate = rng() % 100;
+            if (fate < 10) {
+                world.gone.insert(window);
+            } else if (fate < 15) {
+                world.actual[window] = desktops[rng() % desktops.size()];
+            }
+        }
+        world.current = desktops[rng() % desktops.size()];
+
+        DesktopGuid expected = BruteForceCurrent(index, world, desktops);
+        auto probe = [&](WindowKey window, const DesktopGuid& desktop) { return world.Probe(window, desktop); };
+
+        WindowEliminationStats stats;
+        DesktopGuid exhaustive = index.FindCurrentDesktop(desktops, probe, SIZE_MAX, &stats);
+        CHECK(exhaustive == expected);
+        CHECK(expected.IsNull() || expected == world.current);
+        CHECK(stats.probes <= index.GetWindowCount());
+        decided += expected.IsNull() ? 0 : 1;
+        direct += stats.directHit ? 1 : 0;
+
+        for (size_t budget : { 1u, 3u }) {
+            DesktopGuid found = index.FindCurrentDesktop(desktops, probe, budget, &stats);
+            CHECK(found.IsNull() || found == expected);
+            CHECK(stats.probes <= budget * desktops.size());
+        }
+    }
+    // Both ways of deciding were exercised
+    CHECK(decided > 100);
+    CHECK(direct > 50);
+    CHECK(direct < decided);
+}
@@ -0,0 +1,97 @@
+#include "Test.h"
+#include "ZoomTraceFiles.h"
+#include "zoom/ZoomReplay.h"
+#include <string>
+
+using namespace VirtualOverlay;
+
+namespace {
+
+const std::string TRACE_DIR = std::string(VO_TEST_DATA_DIR) + "/zoom/";
+const std::string SESSION_TRACE = TRACE_DIR + "session-3mon.vozt";
+
+ZoomReplayReport Replay(const ZoomTrace& trace, const ZoomMotionConfig& config) {
+    RecordingMagnifierBackend backend;
+    return ReplayZoomTrace(trace, config, backend);
+}
+
+}  // namespace
+
+TEST(ReplayIsDeterministic) {
+    ZoomTrace trace;
+    REQUIRE(LoadZoomTrace(SESSION_TRACE, trace));
+    ZoomMotionConfig config;
+    RecordingMagnifierBackend first;
+    RecordingMagnifierBackend second;
+    ZoomReplayReport a = ReplayZoomTrace(trace, config, first);
+    ZoomReplayReport b = ReplayZoomTrace(trace, config, second);
+    CHECK(first.GetCalls() == second.GetCalls());
+    CHECK_EQ(a.setCalls, b.setCalls);
+    CHECK_EQ(a.levelSettleMeanMs, b.levelSettleMeanMs);
+}
+
+TEST(SessionTraceCounts) {
+    ZoomTrace trace;
+    REQUIRE(LoadZoomTrace(SESSION_TRACE, trace));
+    ZoomReplayReport report = Replay(trace, ZoomMotionConfig());
+    CHECK_EQ(report.events, 1330u);
+    CHECK_EQ(report.ticks, 720u);
+    CHECK_NEAR(report.durationSec, 12.06, 0.01);
+    CHECK_EQ(report.resetCalls, 1u);    // The double tap ends the session
+    CHECK_EQ(report.levelSettles, 3u);  // Four notches in, one out, reset
+    CHECK_EQ(report.levelOvershoot, 0.0);
+    CHECK_EQ(report.panOvershootPx, 0.0);
+}
+
+TEST(SmoothingSettleTimes) {
+    // The figures quoted for the zoom smoothing: the level settles in about
+    // 584 ms at the default 0.08 and 1428 ms at 0.20, and within a few ticks
+    // with smoothing off
+    ZoomTrace trace;
+    REQUIRE(LoadZoomTrace(SESSION_TRACE, trace));
+
+    ZoomMotionConfig config;
+    ZoomReplayReport standard = Replay(trace, config);
+    CHECK_NEAR(standard.levelSettleMeanMs, 584.0, 1.0);
+
+    config.smoothingFactor = 0.20f;
+    ZoomReplayReport slow = Replay(trace, config);
+    CHECK_NEAR(slow.levelSettleMeanMs, 1428.0, 1.0);
+
+    config.smoothing = false;
+    ZoomReplayReport off = Replay(trace, config);
+    CHECK(off.levelSettleMeanMs < 60.0);
+    CHECK(off.levelSettleMeanMs < standard.levelSettleMeanMs);
+}
+
+TEST(PanFilterJitterAndLag) {
+    // The figures quoted for the One-Euro pan filter against the default
+    // exponential smoothing (0.08), on the pan traces at 2x, 5x and 10x
+    struct Expected {
+        const char* trace;
+        double exponentialJitter;
+        double exponentialLag;
+        double oneEuroJitter;
+        double oneEuroLag;
+    };
+    const Expected expected[] = {
+        { "pan-2x.vozt", 0.42, 18.8, 0.14, 5.5 },
+        { "pan-5x.vozt", 1.06, 47.2, 0.33, 9.3 },
+        { "pan-10x.vozt", 2.07, 94.8, 0.74, 14.2 },
+    };
+    for (const Expected& row : expected) {
+        ZoomTrace trace;
+        REQUIRE(LoadZoomTrace(TRACE_DIR + row.trace, trace));
+
+        ZoomMotionConfig config;
+        ZoomReplayReport exponential = Replay(trace, config);
+        config.panFilter = ZoomPanFilter::OneEuro;
+        ZoomReplayReport oneEuro = Replay(trace, config);
+
+        CHECK_NEAR(exponential.panJitterPx, row.exponentialJitter, 0.005);
+        CHECK_NEAR(exponential.panLagMeanPx, row.exponentialLag, 0.05);
+        CHECK_NEAR(oneEuro.panJitterPx, row.oneEuroJitter, 0.005);
+        CHECK_NEAR(oneEuro.panLagMeanPx, row.oneEuroLag, 0.05);
+        CHECK(oneEuro.setCalls < exponential.setCalls);
+    }
+}
@@ -0,0 +1,198 @@
+#include "Test.h"
+#include "ZoomTraceFiles.h"
+#include "zoom/ZoomTrace.h"
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+using namespace VirtualOverlay;
+
+namespace {
+
+const std::string SESSION_TRACE = std::string(VO_TEST_DATA_DIR) + "/zoom/session-3mon.vozt";
+
+ZoomInputEvent MakeEvent(int64_t time, ZoomInputKind kind, int32_t x = 0, int32_t y = 0, float value = 0.0f) {
+    ZoomInputEvent event;
+    event.time = time;
+    event.kind = kind;
+    event.x = x;
+    event.y = y;
+    event.value = value;
+    return event;
+}
+
+ZoomTrace MakeTrace() {
+    ZoomTrace trace;
+    trace.frequency = 10000000;
+    trace.monitors = { { 0, 0, 2560, 1440 }, { -1920, -200, 0, 880 } };
+    trace.events = {
+        MakeEvent(5000, ZoomInputKind::ModifierDown),
+        MakeEvent(5000, ZoomInputKind::Wheel, 1200, 700, 1.0f),
+        MakeEvent(165000, ZoomInputKind::Tick, 0, 0, 16.0f),
+        MakeEvent(170000, ZoomInputKind::Cursor, -1500, -150),
+        MakeEvent(170001, ZoomInputKind::Gesture, -1499, 879, 2.5f),
+        MakeEvent(400000, ZoomInputKind::Reset),
+        MakeEvent(400000, ZoomInputKind::ModifierUp),
+    };
+    return trace;
+}
+
+bool SameEvents(const ZoomTrace& a, const ZoomTrace& b) {
+    if (a.events.size() != b.events.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.events.size(); i++) {
+        const ZoomInputEvent& x = a.events[i];
+        const ZoomInputEvent& y = b.events[i];
+        if (x.time != y.time || x.kind != y.kind || x.x != y.x || x.y != y.y ||
+            std::memcmp(&x.value, &y.value, sizeof(float)) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void PutVarint(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+// Header with no monitors, then two cursor events: the first moves to x = 1,
+// the second by dx
+std::vector<uint8_t> CursorTrace(uint64_t zigzagDx) {
+    std::vector<uint8_t> bytes = { 'V', 'O', 'Z', 'T', 1 };
+    PutVarint(bytes, 1);    // Frequency
+    PutVarint(bytes, 0);    // Monitors
+    PutVarint(bytes, 2);    // Events
+    PutVarint(bytes, 0);    // Start time
+    uint8_t cursor = static_cast<uint8_t>(ZoomInputKind::Cursor);
+    bytes.insert(bytes.end(), { cursor, 0, 2, 0 });
+    bytes.insert(bytes.end(), { cursor, 0 });
+    PutVarint(bytes, zigzagDx);
+    PutVarint(bytes, 0);
+    return bytes;
+}
+
+}  // namespace
+
+TEST(RoundTrip) {
+    ZoomTrace trace = MakeTrace();
+    std::vector<uint8_t> bytes;
+    REQUIRE(EncodeZoomTrace(trace, bytes));
+
+    ZoomTrace decoded;
+    REQUIRE(DecodeZoomTrace(bytes.data(), bytes.size(), decoded));
+    CHECK_EQ(decoded.frequency, trace.frequency);
+    CHECK(decoded.monitors == trace.monitors);
+    CHECK(SameEvents(decoded, trace));
+    CHECK_NEAR(decoded.GetDurationSeconds(), 0.0395, 1e-9);
+}
+
+TEST(ExtremePositionsRoundTrip) {
+    // The widest legitimate step, INT32_MIN to INT32_MAX and back
+    ZoomTrace trace = MakeTrace();
+    trace.events = {
+        MakeEvent(0, ZoomInputKind::Cursor, INT32_MIN, INT32_MAX),
+        MakeEvent(1, ZoomInputKind::Cursor, INT32_MAX, INT32_MIN),
+        MakeEvent(2, ZoomInputKind::Cursor, INT32_MIN, INT32_MIN),
+    };
+    std::vector<uint8_t> bytes;
+    REQUIRE(EncodeZoomTrace(trace, bytes));
+    ZoomTrace decoded;
+    REQUIRE(DecodeZoomTrace(bytes.data(), bytes.size(), decoded));
+    CHECK(SameEvents(decoded, trace));
+}
+
+TEST(EncodeRejectsBadTraces) {
+    std::vector<uint8_t> bytes;
+    ZoomTrace trace = MakeTrace();
+    trace.frequency = 0;
+    CHECK(!EncodeZoomTrace(trace, bytes));
+
+    trace = MakeTrace();
+    trace.events[3].time = 0;   // Goes back in time
+    CHECK(!EncodeZoomTrace(trace, bytes));
+    CHECK(bytes.empty());
+
+    trace = MakeTrace();
+    trace.events.front().time = -1;
+    CHECK(!EncodeZoomTrace(trace, bytes));
+
+    trace = MakeTrace();
+    trace.monitors.resize(65);
+    CHECK(!EncodeZoomTrace(trace, bytes));
+}
+
+TEST(DecodeRejectsOverflowingPositionDelta) {
+    // 26 bytes whose second cursor step is INT64_MAX: the running sum used
+    // to overflow (signed, undefined) before the int32 range check
+    std::vector<uint8_t> bytes = CursorTrace(UINT64_MAX - 1);
+    CHECK_EQ(bytes.size(), 26u);
+    ZoomTrace trace;
+    CHECK(!DecodeZoomTrace(bytes.data(), bytes.size(), trace));
+    CHECK(trace.events.empty());
+
+    bytes = CursorTrace(UINT64_MAX);    // INT64_MIN
+    CHECK(!DecodeZoomTrace(bytes.data(), bytes.size(), trace));
+
+    // Just past the widest step two int32 values can be apart
+    bytes = CursorTrace((uint64_t{ UINT32_MAX } + 1) << 1);
+    CHECK(!DecodeZoomTrace(bytes.data(), bytes.size(), trace));
+
+    // In range for the delta but not for the position
+    bytes = CursorTrace(uint64_t{ INT32_MAX } << 1);
+    CHECK(!DecodeZoomTrace(bytes.data(), bytes.size(), trace));
+    bytes = CursorTrace((uint64_t{ INT32_MAX } - 1) << 1);
+    REQUIRE(DecodeZoomTrace(bytes.data(), bytes.size(), trace));
+    CHECK_EQ(trace.events.back().x, INT32_MAX);
+}
+
+TEST(DecodeRejectsTruncationAndTrailingBytes) {
+    std::vector<uint8_t> bytes;
+    REQUIRE(EncodeZoomTrace(MakeTrace(), bytes));
+    ZoomTrace trace;
+    for (size_t size = 0; size < bytes.size(); size++) {
+        CHECK(!DecodeZoomTrace(bytes.data(), size, trace));
+    }
+    bytes.push_back(0);
+    CHECK(!DecodeZoomTrace(bytes.data(), bytes.size(), trace));
+    CHECK(!DecodeZoomTrace(nullptr, 0, trace));
+
+    REQUIRE(EncodeZoomTrace(MakeTrace(), bytes));
+    bytes[4] = 2;   // Version
+    CHECK(!DecodeZoomTrace(bytes.data(), bytes.size(), trace));
+}
+
+TEST(RecorderOnlyWhileRecording) {
+    ZoomTraceRecorder recorder;
+    recorder.Record(MakeEvent(1, ZoomInputKind::Tick));
+    CHECK(recorder.GetTrace().events.empty());
+
+    recorder.Start(1000, { { 0, 0, 1920, 1080 } });
+    recorder.Record(MakeEvent(2, ZoomInputKind::Tick, 0, 0, 16.0f));
+    recorder.Stop();
+    recorder.Record(MakeEvent(3, ZoomInputKind::Tick));
+    CHECK_EQ(recorder.GetTrace().events.size(), 1u);
+    CHECK_EQ(recorder.GetTrace().frequency, 1000);
+    CHECK_EQ(recorder.GetDropped(), 0u);
+}
+
+TEST(CommittedSessionTraceDecodes) {
+    ZoomTrace trace;
+    REQUIRE(LoadZoomTrace(SESSION_TRACE, trace));
+    CHECK_EQ(trace.frequency, 10000000);
+    REQUIRE(trace.monitors.size() == 3u);
+    CHECK(trace.monitors[1] == (ZoomRect{ -1920, -200, 0, 880 }));
+    CHECK_EQ(trace.events.size(), 1330u);
+    CHECK_NEAR(trace.GetDurationSeconds(), 12.06, 0.01);
+
+    // Survives a re-encode unchanged
+    std::vector<uint8_t> bytes;
+    REQUIRE(EncodeZoomTrace(trace, bytes));
+    ZoomTrace again;
+    REQUIRE(DecodeZoomTrace(bytes.data(), bytes.size(), again));
+    CHECK(SameEvents(again, trace));
+}